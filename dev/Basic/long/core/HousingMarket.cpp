@@ -10,6 +10,7 @@
  */
 
 #include "HousingMarket.hpp"
+#include <algorithm>
 #include "workers/Worker.hpp"
 #include "event/LT_EventArgs.hpp"
 #include "message/MessageBus.hpp"
@@ -186,6 +187,34 @@ void HousingMarket::Entry::setOwner(Agent_LT* owner)
     this->owner = owner;
 }
 
+HousingMarket::Snapshot::Snapshot() : day(0) {}
+
+const HousingMarket::ConstEntryList& HousingMarket::Snapshot::getAvailableEntries() const
+{
+    return availableEntries;
+}
+
+const HousingMarket::ConstEntryList& HousingMarket::Snapshot::getEntriesByZoneHousingType(int zoneHousingType) const
+{
+    static const ConstEntryList EMPTY_LIST;
+
+    if (zoneHousingType < 0 || zoneHousingType >= (int)entriesByZoneHousingType.size())
+    {
+        return EMPTY_LIST;
+    }
+    return entriesByZoneHousingType[zoneHousingType];
+}
+
+const std::vector<BigSerial>& HousingMarket::Snapshot::getBTOEntries() const
+{
+    return btoEntries;
+}
+
+unsigned int HousingMarket::Snapshot::getDay() const
+{
+    return day;
+}
+
 HousingMarket::HousingMarket() : Entity(-1)
 {
 }
@@ -247,6 +276,58 @@ void HousingMarket::getAvailableEntries(ConstEntryList& outList)
     }
 }
 
+HousingMarket::SnapshotPtr HousingMarket::getSnapshot(unsigned int day)
+{
+    boost::mutex::scoped_lock lock(snapshotMtx);
+
+    if (snapshot && snapshot->getDay() == day)
+    {
+        return snapshot;
+    }
+
+    Snapshot* newSnapshot = new Snapshot();
+    newSnapshot->day = day;
+    newSnapshot->availableEntries.reserve(entriesById.size());
+
+    for (EntryMap::const_iterator itr = entriesById.begin(); itr != entriesById.end(); itr++)
+    {
+        const Entry* entry = itr->second;
+        if (entry->isBuySellIntervalCompleted())
+        {
+            newSnapshot->availableEntries.push_back(entry);
+
+            int zoneHousingType = entry->getZoneHousingType();
+            if (zoneHousingType >= 0)
+            {
+                if (zoneHousingType >= (int)newSnapshot->entriesByZoneHousingType.size())
+                {
+                    newSnapshot->entriesByZoneHousingType.resize(zoneHousingType + 1);
+                }
+                newSnapshot->entriesByZoneHousingType[zoneHousingType].push_back(entry);
+            }
+        }
+    }
+
+    //hash map order is not reproducible; sort so that the same draws pick the same units.
+    struct ByUnitId
+    {
+        bool operator()(const Entry* lhs, const Entry* rhs) const
+        {
+            return lhs->getUnitId() < rhs->getUnitId();
+        }
+    };
+    std::sort(newSnapshot->availableEntries.begin(), newSnapshot->availableEntries.end(), ByUnitId());
+    for (std::vector<ConstEntryList>::iterator itr = newSnapshot->entriesByZoneHousingType.begin(); itr != newSnapshot->entriesByZoneHousingType.end(); itr++)
+    {
+        std::sort(itr->begin(), itr->end(), ByUnitId());
+    }
+
+    newSnapshot->btoEntries.assign(btoEntries.begin(), btoEntries.end());
+
+    snapshot.reset(newSnapshot);
+    return snapshot;
+}
+
 size_t HousingMarket::getEntrySize(unsigned int currTick)
 {
     size_t size = 0;
@@ -11,6 +11,8 @@
 #pragma once
 
 #include <boost/unordered_map.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
 #include <unordered_map>
 #include "entities/Entity.hpp"
 #include "database/entity/Unit.hpp"
@@ -106,6 +108,48 @@ namespace sim_mob
             typedef boost::unordered_map<BigSerial, Entry*> EntryMap;
             typedef boost::unordered_map<BigSerial, EntryMap> EntryMapById;
 
+            /**
+             * Read-only view of the market shared by all bidders of one day.
+             *
+             * Only entries whose buy/sell interval is completed are included.
+             * Entries of each zone housing type are stored contiguously and
+             * sorted by unit id, so a random entry of a zone housing type can
+             * be picked in constant time.
+             *
+             * The entries are owned by the market. A snapshot must not be
+             * used after the day it was taken for.
+             */
+            class Snapshot
+            {
+            public:
+                Snapshot();
+
+                const ConstEntryList& getAvailableEntries() const;
+
+                /**
+                 * @param zoneHousingType (one-based) zone housing type id.
+                 * @return available entries of the given zone housing type; empty for unknown ids.
+                 */
+                const ConstEntryList& getEntriesByZoneHousingType(int zoneHousingType) const;
+
+                /**
+                 * @return ids of the BTO units on the market, in ascending order.
+                 */
+                const std::vector<BigSerial>& getBTOEntries() const;
+
+                unsigned int getDay() const;
+
+            private:
+                friend class HousingMarket;
+
+                unsigned int day;
+                ConstEntryList availableEntries;
+                std::vector<ConstEntryList> entriesByZoneHousingType;
+                std::vector<BigSerial> btoEntries;
+            };
+
+            typedef boost::shared_ptr<const Snapshot> SnapshotPtr;
+
         public:
             HousingMarket();
             virtual ~HousingMarket();
@@ -150,6 +194,14 @@ namespace sim_mob
              */
             void getAvailableEntries(ConstEntryList& outList);
 
+            /**
+             * Gets the market snapshot of the given day. The snapshot is built
+             * by the first caller of the day and shared by all the others.
+             * @param day current simulation day.
+             * @return snapshot of the market.
+             */
+            SnapshotPtr getSnapshot(unsigned int day);
+
             /**
              * Get a pointer of the entry by given unit identifier.
              * You should not change the returned values.
@@ -193,6 +245,9 @@ namespace sim_mob
             std::set<BigSerial> btoEntries;
             std::unordered_multimap<int, BigSerial>unitsByZoneHousingType;
 
+            SnapshotPtr snapshot;
+            boost::mutex snapshotMtx;
+
         };
     }
 }
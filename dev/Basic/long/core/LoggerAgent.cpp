@@ -11,6 +11,7 @@
 #include "message/MessageBus.hpp"
 #include "Common.hpp"
 #include "util/HelperFunctions.hpp"
+#include "workers/Worker.hpp"
 #include "conf/ConfigParams.hpp"
 #include "conf/ConfigManager.hpp"
 
@@ -20,23 +21,9 @@ using namespace sim_mob::long_term;
 using namespace sim_mob::event;
 using namespace sim_mob::messaging;
 
-namespace
-{
-    class LogMsg : public Message
-    {
-    public:
-
-        LogMsg(const std::string& logMsg, LoggerAgent::LogFile fileType) : logMsg(logMsg), fileType(fileType)
-        {
-            priority = INTERNAL_MESSAGE_PRIORITY;
-        }
-
-        std::string logMsg;
-        LoggerAgent::LogFile fileType;
-    };
-}
+LoggerAgent::LogBuffers::LogBuffers() : files(NUM_LOG_FILES) {}
 
-LoggerAgent::LoggerAgent() : Entity(-1)
+LoggerAgent::LoggerAgent() : Entity(-1), localBuffers(&LoggerAgent::releaseThreadBuffers), nonWorkerThreads(0), stopWriter(false)
 {
 
     ConfigParams& config = ConfigManager::GetInstanceRW().FullConfig();
@@ -413,10 +400,20 @@ LoggerAgent::LoggerAgent() : Entity(-1)
      std::ofstream* eLinkStopsWithNearestPolyFile = new std::ofstream("ezLinkStopsWithNearestPoly.csv");
      streams.insert(std::make_pair(LOG_NEARSET_POLYTECH_EZ_LINK, eLinkStopsWithNearestPolyFile));
      *eLinkStopsWithNearestPolyFile << "ezLinkStopId, polyId" << std::endl;
+
+     writer = boost::thread(&LoggerAgent::writeBatches, this);
 }
 
 LoggerAgent::~LoggerAgent()
 {
+    flush();
+    {
+        boost::mutex::scoped_lock lock(writerMtx);
+        stopWriter = true;
+    }
+    writerCondition.notify_one();
+    writer.join();
+
     typename Files::iterator it;
     for (it = streams.begin(); it != streams.end(); it++)
     {
@@ -445,35 +442,129 @@ void LoggerAgent::onWorkerExit() {}
 
 Entity::UpdateStatus LoggerAgent::update(timeslice now)
 {
+    //flushed by the main thread once all workers have finished the day; other agents are still logging at this point
     return Entity::UpdateStatus(Entity::UpdateStatus::RS_CONTINUE);
 }
 
+void LoggerAgent::releaseThreadBuffers(ThreadBuffers* buffers)
+{
+    //buffers are owned by threadBuffers; nothing to release on thread exit.
+}
+
+LoggerAgent::ThreadBuffers& LoggerAgent::getThreadBuffers()
+{
+    ThreadBuffers* buffers = localBuffers.get();
+    if (!buffers)
+    {
+        boost::shared_ptr<ThreadBuffers> newBuffers(new ThreadBuffers());
+        unsigned int workGroupNum = 0;
+        unsigned int workerIndex = 0;
+        bool isWorker = Worker::GetCurrentWorkerId(workGroupNum, workerIndex);
+        {
+            boost::mutex::scoped_lock lock(registrationMtx);
+            newBuffers->order = isWorker ? std::make_pair(workGroupNum + 1, workerIndex) : std::make_pair(0u, nonWorkerThreads++);
+
+            std::vector<boost::shared_ptr<ThreadBuffers> >::iterator pos = threadBuffers.begin();
+            while (pos != threadBuffers.end() && (*pos)->order < newBuffers->order)
+            {
+                pos++;
+            }
+            threadBuffers.insert(pos, newBuffers);
+        }
+        buffers = newBuffers.get();
+        localBuffers.reset(buffers);
+    }
+    return *buffers;
+}
+
 void LoggerAgent::log(LogFile outputType, const std::string& logMsg)
 {
-    boost::mutex::scoped_lock lock( mtx );
+    ThreadBuffers& buffers = getThreadBuffers();
+    boost::mutex::scoped_lock lock(buffers.mtx);
+
+    std::string& buffer = buffers.buffers.files[outputType];
+    buffer.append(logMsg);
+    buffer.push_back('\n');
+}
+
+void LoggerAgent::flush()
+{
+    LogBuffers* batch = new LogBuffers();
+    bool empty = true;
+    {
+        boost::mutex::scoped_lock lock(registrationMtx);
+        for (std::vector<boost::shared_ptr<ThreadBuffers> >::iterator it = threadBuffers.begin(); it != threadBuffers.end(); it++)
+        {
+            boost::mutex::scoped_lock bufferLock((*it)->mtx);
+            for (size_t file = 0; file < NUM_LOG_FILES; file++)
+            {
+                std::string& buffer = (*it)->buffers.files[file];
+                if (!buffer.empty())
+                {
+                    //clear() keeps the capacity of the thread buffer for the next tick
+                    batch->files[file].append(buffer);
+                    buffer.clear();
+                    empty = false;
+                }
+            }
+        }
+    }
+
+    if (empty)
+    {
+        delete batch;
+        return;
+    }
 
-    // entry will be available only on the next tick
-    MessageBus::PostMessage(this, LTMID_LOG, MessageBus::MessagePtr(new LogMsg(logMsg, outputType)));
+    {
+        boost::mutex::scoped_lock lock(writerMtx);
+        pendingBatches.push_back(batch);
+    }
+    writerCondition.notify_one();
 }
 
-void LoggerAgent::HandleMessage(messaging::Message::MessageType type, const messaging::Message& message)
+void LoggerAgent::writeBatches()
 {
-    switch (type)
+    while (true)
     {
-        case LTMID_LOG:
+        LogBuffers* batch = nullptr;
         {
-            const LogMsg& msg = MSG_CAST(LogMsg, message);
+            boost::mutex::scoped_lock lock(writerMtx);
+            while (pendingBatches.empty() && !stopWriter)
+            {
+                writerCondition.wait(lock);
+            }
 
-            if (msg.fileType == STDOUT)
+            if (pendingBatches.empty())
             {
-                PrintOut(msg.logMsg << std::endl);
+                return;
             }
-            else
+            batch = pendingBatches.front();
+            pendingBatches.pop_front();
+        }
+
+        for (size_t file = 0; file < NUM_LOG_FILES; file++)
+        {
+            const std::string& text = batch->files[file];
+            if (text.empty())
             {
-                (*streams[msg.fileType]) << msg.logMsg << std::endl;
+                continue;
+            }
+
+            if (file == STDOUT)
+            {
+                PrintOut(text);
+                continue;
+            }
+
+            Files::iterator stream = streams.find(static_cast<LogFile>(file));
+            if (stream != streams.end() && stream->second)
+            {
+                stream->second->write(text.data(), text.size());
+                stream->second->flush();
             }
-            break;
         }
-        default:break;
-    };
+        delete batch;
+    }
 }
+
@@ -11,8 +11,13 @@
 #include "entities/Entity.hpp"
 #include <iostream>
 #include <fstream>
+#include <deque>
 #include <boost/unordered_map.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/tss.hpp>
 
 namespace sim_mob
 {
@@ -21,12 +26,19 @@ namespace sim_mob
         /**
          * Entity responsible log messages in a thread-safe way without logs.
          * 
-         * This special agent uses the MessageBus to receive messages to log. 
+         * Each thread appends its messages to its own buffers (one per LogFile).
+         * Once per day, after all workers have finished the day's tick, the main thread
+         * collects the buffers of all threads and hands them to a background writer
+         * thread, which writes each file in one block and flushes it. Each batch holds
+         * exactly the messages logged up to the end of its day. Messages of one thread
+         * keep their order within a file, and the buffers of a batch are written by
+         * worker id (work group number, then worker index). Buffers of threads that are
+         * not workers (e.g. the main thread) come first, in the order they first logged.
+         * The order of lines across threads is therefore fixed, given what each worker logged.
          * 
          * The output is depending on the given configuration.
          * 
-         * Attention: This agent is designed to work with SimMobility Workers and 
-         * MessageBus system. Do not use it within external threads.
+         * Messages logged after the last tick are written when the agent is destroyed.
          * 
          */
         class LoggerAgent : public Entity
@@ -80,7 +92,8 @@ namespace sim_mob
                 LOG_UNIT_HEDONIC_PRICE,
                 LOG_NEW_BIDS,
                 LOG_NEARSET_UNI_EZ_LINK,
-                LOG_NEARSET_POLYTECH_EZ_LINK
+                LOG_NEARSET_POLYTECH_EZ_LINK,
+                NUM_LOG_FILES
             };
 
             LoggerAgent();
@@ -96,6 +109,12 @@ namespace sim_mob
              * @param logMsg to print.
              */
             void log(LogFile outputType, const std::string& logMsg);
+
+            /**
+             * Hands all messages logged so far to the writer thread.
+             * Called by the main thread at the end of each day, while no worker is running.
+             */
+            void flush();
             
         protected:
             /**
@@ -103,7 +122,6 @@ namespace sim_mob
              */
             virtual bool isNonspatial();
             virtual std::vector<sim_mob::BufferedBase*> buildSubscriptionList();
-            virtual void HandleMessage(messaging::Message::MessageType type, const messaging::Message& message);
 
         private:
             /**
@@ -112,11 +130,57 @@ namespace sim_mob
             void onWorkerEnter();
             void onWorkerExit();
 
+            /**
+             * Writer thread loop.
+             */
+            void writeBatches();
+
         private:
             typedef boost::unordered_map<LogFile, std::ofstream*> Files;
             boost::unordered_map<LogFile, std::ofstream*> streams; 
 
-            boost::mutex mtx;
+            /**
+             * Pending text of each log file.
+             */
+            struct LogBuffers
+            {
+                LogBuffers();
+
+                std::vector<std::string> files;
+            };
+
+            /**
+             * Buffers of one logging thread. The mutex is only contended while the
+             * buffers are being collected by flush().
+             */
+            struct ThreadBuffers
+            {
+                /**
+                 * position of these buffers in a flushed batch:
+                 * (0, registration number) for threads which are not workers,
+                 * (work group number + 1, worker index) for worker threads.
+                 */
+                std::pair<unsigned int, unsigned int> order;
+                boost::mutex mtx;
+                LogBuffers buffers;
+            };
+
+            ThreadBuffers& getThreadBuffers();
+            static void releaseThreadBuffers(ThreadBuffers* buffers);
+
+            // buffers are owned by the agent, not the thread, so that messages from
+            // short-lived threads are not lost when they exit.
+            boost::thread_specific_ptr<ThreadBuffers> localBuffers;
+            // sorted by ThreadBuffers::order
+            std::vector<boost::shared_ptr<ThreadBuffers> > threadBuffers;
+            unsigned int nonWorkerThreads;
+            boost::mutex registrationMtx;
+
+            std::deque<LogBuffers*> pendingBatches;
+            boost::mutex writerMtx;
+            boost::condition_variable writerCondition;
+            bool stopWriter;
+            boost::thread writer;
 
         };
     }
@@ -8,6 +8,11 @@
 
 #include "IndvidualVehicleOwnershipLogsum.hpp"
 
+#include <fstream>
+#include <boost/serialization/vector.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+
 using namespace sim_mob::long_term;
 
 IndvidualVehicleOwnershipLogsum::IndvidualVehicleOwnershipLogsum(BigSerial householdId, BigSerial individualId, double logsum0, double logsum1, double logsum2, double logsum3, double logsum4, double logsum5):
@@ -108,6 +113,75 @@ void IndvidualVehicleOwnershipLogsum::setLogsum5(double logsum5)
     this->logsum5 = logsum5;
 }
 
+template<class Archive>
+void IndvidualVehicleOwnershipLogsum::serialize(Archive & ar,const unsigned int version)
+{
+    ar & householdId;
+    ar & individualId;
+    ar & logsum0;
+    ar & logsum1;
+    ar & logsum2;
+    ar & logsum3;
+    ar & logsum4;
+    ar & logsum5;
+}
+
+namespace
+{
+    //bumped whenever the layout of the file changes
+    const unsigned int FILE_VERSION = 1;
+}
+
+void IndvidualVehicleOwnershipLogsum::saveData(const std::vector<IndvidualVehicleOwnershipLogsum*> &logsums, std::size_t signature, const std::string &file)
+{
+    // make an archive
+    std::ofstream ofs(file.c_str(), std::ios::binary);
+    boost::archive::binary_oarchive oa(ofs);
+    unsigned int version = FILE_VERSION;
+    unsigned long long fileSignature = signature;
+    oa & version;
+    oa & fileSignature;
+    oa & logsums;
+}
+
+bool IndvidualVehicleOwnershipLogsum::loadSerializedData(std::size_t signature, std::vector<IndvidualVehicleOwnershipLogsum*> &logsums, const std::string &file)
+{
+    std::ifstream ifs(file.c_str(), std::ios::binary);
+    if (!ifs.good())
+    {
+        return false;
+    }
+
+    std::vector<IndvidualVehicleOwnershipLogsum*> restored_info;
+    try
+    {
+        boost::archive::binary_iarchive ar( ifs );
+        unsigned int version = 0;
+        unsigned long long fileSignature = 0;
+        ar & version;
+        ar & fileSignature;
+        if (version != FILE_VERSION || fileSignature != signature)
+        {
+            return false;
+        }
+
+        // Load the data
+        ar & restored_info;
+    }
+    catch (const std::exception &ex)
+    {
+        //a file written by an older version, or truncated
+        for (std::vector<IndvidualVehicleOwnershipLogsum*>::iterator it = restored_info.begin(); it != restored_info.end(); it++)
+        {
+            delete *it;
+        }
+        return false;
+    }
+
+    logsums.insert(logsums.end(), restored_info.begin(), restored_info.end());
+    return true;
+}
+
 namespace sim_mob
 {
     namespace long_term
@@ -34,6 +34,28 @@ namespace sim_mob
             */
             friend std::ostream& operator<<(std::ostream& strm, const IndvidualVehicleOwnershipLogsum& data);
 
+            template<class Archive>
+            void serialize(Archive & ar,const unsigned int version);
+
+            /**
+             * Saves logsums to disk, tagged with the signature of the inputs they were computed from.
+             * @param logsums logsums to save
+             * @param signature signature of the inputs and configuration of the computation
+             * @param file file to write
+             */
+            static void saveData(const std::vector<IndvidualVehicleOwnershipLogsum*> &logsums, std::size_t signature, const std::string &file = filename);
+
+            /**
+             * Loads logsums saved by saveData.
+             * @param signature signature of the current inputs and configuration
+             * @param logsums output (owned by the caller); only filled if the file was saved with the same signature
+             * @param file file to read
+             * @return false if the file is missing, unreadable, or was computed from other inputs
+             */
+            static bool loadSerializedData(std::size_t signature, std::vector<IndvidualVehicleOwnershipLogsum*> &logsums, const std::string &file = filename);
+
+            static constexpr auto filename = "individualVehicleOwnershipLogsums";
+
             /*
              * setters and getters
              */
@@ -11,6 +11,7 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <set>
 #include <ctime>
 #include <unistd.h>
 
@@ -525,7 +526,25 @@ void performMain(int simulationNumber, std::list<std::string>& resLogFiles)
                (*it)->update(currTick);
             }
 
-            wgMgr.waitAllGroups();
+            {
+                std::set<Entity*> removedEntities;
+
+                wgMgr.waitAllGroups_FrameTick();
+                //All workers have finished the day and wait for the main thread at the flip barrier, so the logs of
+                //the day are complete and nothing is being logged.
+                agentsLookup.getLogger().flush();
+                wgMgr.waitAllGroups_FlipBuffers(&removedEntities);
+                wgMgr.waitAllGroups_DistributeMessages(removedEntities);
+                wgMgr.waitAllGroups_MacroTimeTick();
+
+                //Delete all collected entities:
+                while (!removedEntities.empty())
+                {
+                    Entity* ag = *removedEntities.begin();
+                    removedEntities.erase(removedEntities.begin());
+                    delete ag;
+                }
+            }
 
             DeveloperModel::ParcelList parcels;
             DeveloperModel::DeveloperList developerAgents;
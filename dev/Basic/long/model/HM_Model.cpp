@@ -10,6 +10,7 @@
  */
 
 #include "HM_Model.hpp"
+#include <fstream>
 #include <boost/unordered_map.hpp>
 #include <boost/make_shared.hpp>
 #include "util/LangHelpers.hpp"
@@ -68,6 +69,7 @@
 #include "message/LT_Message.hpp"
 #include "message/MessageBus.hpp"
 #include "behavioral/PredayLT_Logsum.hpp"
+#include "model/HouseholdLogsumPrecomputation.hpp"
 #include "util/PrintLog.hpp"
 #include "util/SharedFunctions.hpp"
 #include <random>
@@ -2206,6 +2208,11 @@ void HM_Model::startImpl()
     addMetadata("Initial Vacancies", vacancies);
     addMetadata("Freelance housing agents", numWorkers);
 
+    if( config.ltParams.logsumPrecomputation.enabled )
+    {
+        precomputeHouseholdLogsums();
+    }
+
 
     for (size_t n = 0; n < households.size(); n++)
     {
@@ -2906,259 +2913,240 @@ void HM_Model::getLogsumOfHouseholdVOForVO_Model(BigSerial householdId, std::uno
     }
 
     Household *currentHousehold = getHouseholdById( householdId );
+    Individual *thisIndividual = getMaxIncomeIndividual( currentHousehold );
 
-    std::vector<BigSerial> householdIndividualIds = currentHousehold->getIndividuals();
-    float income = this->getIndividualById(householdIndividualIds[0])->getIncome();
-    BigSerial maxIncomeInd =  householdIndividualIds[0];
-    for( int n = 1; n < householdIndividualIds.size(); n++ )
+    int paxId  = -1;
+    for(int p = 0; p < hitsIndividualLogsum.size(); p++ )
     {
-        if(this->getIndividualById(householdIndividualIds[n])->getIncome() > income)
+        if (  hitsIndividualLogsum[p]->getHitsId().compare( hitsSample->getHouseholdHitsId() ) == 0 )
         {
-            maxIncomeInd = householdIndividualIds[n];
-            income = this->getIndividualById(householdIndividualIds[n])->getIncome();
+            paxId  = hitsIndividualLogsum[p]->getPaxId();
+            break;
         }
-
     }
 
-    for( int n = 0; n < householdIndividualIds.size(); n++ )
+    BigSerial tazW = 0;
+    BigSerial tazH = 0;
+    computeVehicleOwnershipLogsums( currentHousehold, thisIndividual, logsum, tazH, tazW );
+
+    printHouseholdHitsLogsumFVO( hitsSample->getHouseholdHitsId(), paxId,
+                                 currentHousehold->getId(), thisIndividual->getId(),
+                                 thisIndividual->getEmploymentStatusId(),
+                                 thisIndividual->getAgeCategoryId(),
+                                 thisIndividual->getIncome(),
+                                 thisIndividual->getFixed_workplace(),
+                                 thisIndividual->getMemberId(), tazH, tazW, logsum );
+}
+
+Individual* HM_Model::getMaxIncomeIndividual(const Household *household) const
+{
+    std::vector<BigSerial> householdIndividualIds = household->getIndividuals();
+    Individual *maxIncomeInd = this->getIndividualById(householdIndividualIds[0]);
+    for( int n = 1; n < householdIndividualIds.size(); n++ )
     {
         Individual *thisIndividual = this->getIndividualById(householdIndividualIds[n]);
-
-        if(thisIndividual->getId() == maxIncomeInd)
+        if(thisIndividual->getIncome() > maxIncomeInd->getIncome())
         {
-            std::unordered_map<int,double> logsum;
-            std::unordered_map<int,double> travelProbability;
-            std::unordered_map<int,double> tripsExpected;
-            std::unordered_map<int, double> activityLogsums0;
-            std::unordered_map<int, double> activityLogsums1;
-            std::unordered_map<int, double> activityLogsums2;
-            std::unordered_map<int, double> activityLogsums3;
-            std::unordered_map<int, double> activityLogsums4;
-            std::unordered_map<int, double> activityLogsums5;
-
-            int tazIdW = -1;
-            int tazIdH = -1;
-            int paxId  = -1;
-            BigSerial tazW = 0;
-            BigSerial tazH = 0;
-
-            int p = 0;
-            for(p = 0; p < hitsIndividualLogsum.size(); p++ )
-            {
-                if (  hitsIndividualLogsum[p]->getHitsId().compare( hitsSample->getHouseholdHitsId() ) == 0 )
-                {
-                    paxId  = hitsIndividualLogsum[p]->getPaxId();
-                    break;
-                }
-            }
+            maxIncomeInd = thisIndividual;
+        }
+    }
 
+    return maxIncomeInd;
+}
 
+void HM_Model::computeVehicleOwnershipLogsums(const Household *currentHousehold, const Individual *thisIndividual, std::unordered_map<int,double> &logsum, BigSerial &tazH, BigSerial &tazW) const
+{
+    PersonParams personParams;
 
-            {
-                PersonParams personParams;
+    Job *job = this->getJobById(thisIndividual->getJobId());
+    Establishment *establishment = this->getEstablishmentById(  job->getEstablishmentId());
+    const Unit *unit = this->getUnitById(currentHousehold->getUnitId());
 
-                Job *job = this->getJobById(thisIndividual->getJobId());
-                Establishment *establishment = this->getEstablishmentById(  job->getEstablishmentId());
-                const Unit *unit = this->getUnitById(currentHousehold->getUnitId());
 
+    int work_taz_id = this->getEstablishmentTazId( establishment->getId() );
+    Taz *tazObjW = getTazById( work_taz_id );
+    std::string tazStrW;
+    if( tazObjW != NULL )
+        tazStrW = tazObjW->getName();
+    tazW = std::atoi( tazStrW.c_str() );
 
-                int work_taz_id = this->getEstablishmentTazId( establishment->getId() );
-                Taz *tazObjW = getTazById( work_taz_id );
-                std::string tazStrW;
-                if( tazObjW != NULL )
-                    tazStrW = tazObjW->getName();
-                tazW = std::atoi( tazStrW.c_str() );
+    Postcode *postcode = this->getPostcodeById( this->getUnitSlaAddressId(unit->getId()));
+    Taz *tazObjH = getTazById( postcode->getTazId() );
+    std::string tazStrH;
+    if( tazObjH != NULL )
+        tazStrH = tazObjH->getName();
+    tazH = std::atoi( tazStrH.c_str() );
 
-                Postcode *postcode = this->getPostcodeById( this->getUnitSlaAddressId(unit->getId()));
-                Taz *tazObjH = getTazById( postcode->getTazId() );
-                std::string tazStrH;
-                if( tazObjH != NULL )
-                    tazStrH = tazObjH->getName();
-                tazH = std::atoi( tazStrH.c_str() );
 
+    BigSerial establishmentSlaAddressId = getEstablishmentSlaAddressId(establishment->getId());
 
-                BigSerial establishmentSlaAddressId = getEstablishmentSlaAddressId(establishment->getId());
+    personParams.setPersonId(boost::lexical_cast<std::string>(thisIndividual->getId()));
+    personParams.setPersonTypeId(thisIndividual->getEmploymentStatusId());
+    personParams.setGenderId(thisIndividual->getGenderId());
+    personParams.setStudentTypeId(thisIndividual->getEducationId());
+    personParams.setVehicleOwnershipCategory(currentHousehold->getVehicleOwnershipOptionId());
+    personParams.setAgeId(thisIndividual->getAgeCategoryId());
+    personParams.setIncomeIdFromIncome(thisIndividual->getIncome());
+    personParams.setWorksAtHome(thisIndividual->getWorkAtHome());
+    personParams.setCarLicense(thisIndividual->getCarLicense());
+    personParams.setMotorLicense(thisIndividual->getMotorLicense());
+    personParams.setVanbusLicense(thisIndividual->getVanBusLicense());
 
-                personParams.setPersonId(boost::lexical_cast<std::string>(thisIndividual->getId()));
-                personParams.setPersonTypeId(thisIndividual->getEmploymentStatusId());
-                personParams.setGenderId(thisIndividual->getGenderId());
-                personParams.setStudentTypeId(thisIndividual->getEducationId());
-                personParams.setVehicleOwnershipCategory(currentHousehold->getVehicleOwnershipOptionId());
-                personParams.setAgeId(thisIndividual->getAgeCategoryId());
-                personParams.setIncomeIdFromIncome(thisIndividual->getIncome());
-                personParams.setWorksAtHome(thisIndividual->getWorkAtHome());
-                personParams.setCarLicense(thisIndividual->getCarLicense());
-                personParams.setMotorLicense(thisIndividual->getMotorLicense());
-                personParams.setVanbusLicense(thisIndividual->getVanBusLicense());
+    bool fixedHours = false;
+    if( thisIndividual->getFixed_hours() == 1)
+        fixedHours = true;
 
-                bool fixedHours = false;
-                if( thisIndividual->getFixed_hours() == 1)
-                    fixedHours = true;
+    personParams.setHasFixedWorkTiming(fixedHours);
 
-                personParams.setHasFixedWorkTiming(fixedHours);
+    bool fixedWorkplace = true;
 
-                bool fixedWorkplace = true;
+    //if( thisIndividual->getFixed_workplace() == 1 )
+    //  fixedWorkplace = true;
 
-                //if( thisIndividual->getFixed_workplace() == 1 )
-                //  fixedWorkplace = true;
+    personParams.setHasWorkplace( fixedWorkplace );
 
-                personParams.setHasWorkplace( fixedWorkplace );
+    bool isStudent = false;
 
-                bool isStudent = false;
+    if( thisIndividual->getStudentId() > 0)
+        isStudent = true;
 
-                if( thisIndividual->getStudentId() > 0)
-                    isStudent = true;
+    personParams.setIsStudent(isStudent);
 
-                personParams.setIsStudent(isStudent);
+    personParams.setActivityAddressId( tazW );
 
-                personParams.setActivityAddressId( tazW );
+    //household related
+    personParams.setHhId(boost::lexical_cast<std::string>( currentHousehold->getId() ));
+    personParams.setHomeAddressId( tazH );
+    personParams.setHH_Size( currentHousehold->getSize() );
+    personParams.setHH_NumUnder4( currentHousehold->getChildUnder4());
+    personParams.setHH_NumUnder15( currentHousehold->getChildUnder15());
+    personParams.setHH_NumAdults( currentHousehold->getAdult());
+    personParams.setHH_NumWorkers( currentHousehold->getWorkers());
 
-                //household related
-                personParams.setHhId(boost::lexical_cast<std::string>( currentHousehold->getId() ));
-                personParams.setHomeAddressId( tazH );
-                personParams.setHH_Size( currentHousehold->getSize() );
-                personParams.setHH_NumUnder4( currentHousehold->getChildUnder4());
-                personParams.setHH_NumUnder15( currentHousehold->getChildUnder15());
-                personParams.setHH_NumAdults( currentHousehold->getAdult());
-                personParams.setHH_NumWorkers( currentHousehold->getWorkers());
+    //infer params
+    personParams.fixUpParamsForLtPerson();
 
-                //infer params
-                personParams.fixUpParamsForLtPerson();
+    ConfigParams& config = ConfigManager::GetInstanceRW().FullConfig();
+    const std::string luaDirTC = "TC";
+    PersonParams personParams0 = PredayLT_LogsumManager::getInstance().computeLogsum( thisIndividual->getId(),tazH, tazW, 0 , &personParams,luaDirTC );
+    PersonParams personParams1 = PredayLT_LogsumManager::getInstance().computeLogsum( thisIndividual->getId(),tazH, tazW, 1 , &personParams ,luaDirTC);
+    PersonParams personParams2 = PredayLT_LogsumManager::getInstance().computeLogsum( thisIndividual->getId(),tazH, tazW, 2 , &personParams ,luaDirTC);
+    PersonParams personParams3 = PredayLT_LogsumManager::getInstance().computeLogsum( thisIndividual->getId(),tazH, tazW, 3 , &personParams,luaDirTC );
+    PersonParams personParams4 = PredayLT_LogsumManager::getInstance().computeLogsum( thisIndividual->getId(),tazH, tazW, 4 , &personParams,luaDirTC );
+    PersonParams personParams5 = PredayLT_LogsumManager::getInstance().computeLogsum( thisIndividual->getId(),tazH, tazW, 5 , &personParams ,luaDirTC);
+
+    double logsumTC0 = personParams0.getDpbLogsum();
+    double logsumTC1 = personParams1.getDpbLogsum();
+    double logsumTC2 = personParams2.getDpbLogsum();
+    double logsumTC3 = personParams3.getDpbLogsum();
+    double logsumTC4 = personParams4.getDpbLogsum();;
+    double logsumTC5 = personParams5.getDpbLogsum();
+
+    const std::string luaDirTCZero = "TCZero";
+    personParams0 = PredayLT_LogsumManager::getInstance().computeLogsum( thisIndividual->getId(),tazH, tazW, 0 , &personParams,luaDirTCZero );
+    personParams1 = PredayLT_LogsumManager::getInstance().computeLogsum( thisIndividual->getId(),tazH, tazW, 1 , &personParams ,luaDirTCZero);
+    personParams2 = PredayLT_LogsumManager::getInstance().computeLogsum( thisIndividual->getId(),tazH, tazW, 2 , &personParams ,luaDirTCZero);
+    personParams3 = PredayLT_LogsumManager::getInstance().computeLogsum( thisIndividual->getId(),tazH, tazW, 3 , &personParams,luaDirTCZero );
+    personParams4 = PredayLT_LogsumManager::getInstance().computeLogsum( thisIndividual->getId(),tazH, tazW, 4 , &personParams,luaDirTCZero );
+    personParams5 = PredayLT_LogsumManager::getInstance().computeLogsum( thisIndividual->getId(),tazH, tazW, 5 , &personParams ,luaDirTCZero);
 
-                ConfigParams& config = ConfigManager::GetInstanceRW().FullConfig();
-                const std::string luaDirTC = "TC";
-                PersonParams personParams0 = PredayLT_LogsumManager::getInstance().computeLogsum( householdIndividualIds[n],tazH, tazW, 0 , &personParams,luaDirTC );
-                PersonParams personParams1 = PredayLT_LogsumManager::getInstance().computeLogsum( householdIndividualIds[n],tazH, tazW, 1 , &personParams ,luaDirTC);
-                PersonParams personParams2 = PredayLT_LogsumManager::getInstance().computeLogsum( householdIndividualIds[n],tazH, tazW, 2 , &personParams ,luaDirTC);
-                PersonParams personParams3 = PredayLT_LogsumManager::getInstance().computeLogsum( householdIndividualIds[n],tazH, tazW, 3 , &personParams,luaDirTC );
-                PersonParams personParams4 = PredayLT_LogsumManager::getInstance().computeLogsum( householdIndividualIds[n],tazH, tazW, 4 , &personParams,luaDirTC );
-                PersonParams personParams5 = PredayLT_LogsumManager::getInstance().computeLogsum( householdIndividualIds[n],tazH, tazW, 5 , &personParams ,luaDirTC);
-
-                double logsumTC0 = personParams0.getDpbLogsum();
-                double logsumTC1 = personParams1.getDpbLogsum();
-                double logsumTC2 = personParams2.getDpbLogsum();
-                double logsumTC3 = personParams3.getDpbLogsum();
-                double logsumTC4 = personParams4.getDpbLogsum();;
-                double logsumTC5 = personParams5.getDpbLogsum();
+    double logsumTCZero0 = personParams0.getDpbLogsum();
+    double logsumTCZero1 = personParams1.getDpbLogsum();
+    double logsumTCZero2 = personParams2.getDpbLogsum();
+    double logsumTCZero3 = personParams3.getDpbLogsum();
+    double logsumTCZero4 = personParams4.getDpbLogsum();
+    double logsumTCZero5 = personParams5.getDpbLogsum();
 
-                const std::string luaDirTCZero = "TCZero";
-                personParams0 = PredayLT_LogsumManager::getInstance().computeLogsum( householdIndividualIds[n],tazH, tazW, 0 , &personParams,luaDirTCZero );
-                personParams1 = PredayLT_LogsumManager::getInstance().computeLogsum( householdIndividualIds[n],tazH, tazW, 1 , &personParams ,luaDirTCZero);
-                personParams2 = PredayLT_LogsumManager::getInstance().computeLogsum( householdIndividualIds[n],tazH, tazW, 2 , &personParams ,luaDirTCZero);
-                personParams3 = PredayLT_LogsumManager::getInstance().computeLogsum( householdIndividualIds[n],tazH, tazW, 3 , &personParams,luaDirTCZero );
-                personParams4 = PredayLT_LogsumManager::getInstance().computeLogsum( householdIndividualIds[n],tazH, tazW, 4 , &personParams,luaDirTCZero );
-                personParams5 = PredayLT_LogsumManager::getInstance().computeLogsum( householdIndividualIds[n],tazH, tazW, 5 , &personParams ,luaDirTCZero);
-
-                double logsumTCZero0 = personParams0.getDpbLogsum();
-                double logsumTCZero1 = personParams1.getDpbLogsum();
-                double logsumTCZero2 = personParams2.getDpbLogsum();
-                double logsumTCZero3 = personParams3.getDpbLogsum();
-                double logsumTCZero4 = personParams4.getDpbLogsum();
-                double logsumTCZero5 = personParams5.getDpbLogsum();
+    if(config.ltParams.outputHouseholdLogsums.maxcCost)
+    {
+        const std::string luaDirTCPlusOne = "TCPlusOne";
+        personParams0 = PredayLT_LogsumManager::getInstance().computeLogsum( thisIndividual->getId(),tazH, tazW, 0 , &personParams,luaDirTCPlusOne );
+        personParams1 = PredayLT_LogsumManager::getInstance().computeLogsum( thisIndividual->getId(),tazH, tazW, 1 , &personParams ,luaDirTCPlusOne);
+        personParams2 = PredayLT_LogsumManager::getInstance().computeLogsum( thisIndividual->getId(),tazH, tazW, 2 , &personParams ,luaDirTCPlusOne);
+        personParams3 = PredayLT_LogsumManager::getInstance().computeLogsum( thisIndividual->getId(),tazH, tazW, 3 , &personParams,luaDirTCPlusOne );
+        personParams4 = PredayLT_LogsumManager::getInstance().computeLogsum( thisIndividual->getId(),tazH, tazW, 4 , &personParams,luaDirTCPlusOne );
+        personParams5 = PredayLT_LogsumManager::getInstance().computeLogsum( thisIndividual->getId(),tazH, tazW, 5 , &personParams ,luaDirTCPlusOne);
 
-                if(config.ltParams.outputHouseholdLogsums.maxcCost)
-                {
-                    const std::string luaDirTCPlusOne = "TCPlusOne";
-                    personParams0 = PredayLT_LogsumManager::getInstance().computeLogsum( householdIndividualIds[n],tazH, tazW, 0 , &personParams,luaDirTCPlusOne );
-                    personParams1 = PredayLT_LogsumManager::getInstance().computeLogsum( householdIndividualIds[n],tazH, tazW, 1 , &personParams ,luaDirTCPlusOne);
-                    personParams2 = PredayLT_LogsumManager::getInstance().computeLogsum( householdIndividualIds[n],tazH, tazW, 2 , &personParams ,luaDirTCPlusOne);
-                    personParams3 = PredayLT_LogsumManager::getInstance().computeLogsum( householdIndividualIds[n],tazH, tazW, 3 , &personParams,luaDirTCPlusOne );
-                    personParams4 = PredayLT_LogsumManager::getInstance().computeLogsum( householdIndividualIds[n],tazH, tazW, 4 , &personParams,luaDirTCPlusOne );
-                    personParams5 = PredayLT_LogsumManager::getInstance().computeLogsum( householdIndividualIds[n],tazH, tazW, 5 , &personParams ,luaDirTCPlusOne);
-
-                    double logsumTCPlusOne0 = personParams0.getDpbLogsum();
-                    double logsumTCPlusOne1 = personParams1.getDpbLogsum();
-                    double logsumTCPlusOne2 = personParams2.getDpbLogsum();
-                    double logsumTCPlusOne3 = personParams3.getDpbLogsum();
-                    double logsumTCPlusOne4 = personParams4.getDpbLogsum();
-                    double logsumTCPlusOne5 = personParams5.getDpbLogsum();
-
-                    double denominator0 = (logsumTC0 -logsumTCPlusOne0 );
-                    double denominator1 = (logsumTC1 -logsumTCPlusOne1 );
-                    double denominator2 = (logsumTC2 -logsumTCPlusOne2 );
-                    double denominator3 = (logsumTC3 -logsumTCPlusOne3 );
-                    double denominator4 = (logsumTC4 -logsumTCPlusOne4 );
-                    double denominator5 = (logsumTC5 -logsumTCPlusOne5 ); 
-
-                    double avgDenomenator = (denominator0 + denominator1 + denominator2 + denominator3 + denominator4  + denominator5) / 6.0;
-
-                    double logsumScaledMaxCost0 = (logsumTC0 - logsumTCZero0) / avgDenomenator;
-                    logsum.insert(std::make_pair(0,logsumScaledMaxCost0));
-
-                    double logsumScaledMaxCost1 = (logsumTC1 - logsumTCZero1) / avgDenomenator;
-                    logsum.insert(std::make_pair(1,logsumScaledMaxCost1));
-
-                    double logsumScaledMaxCost2 = (logsumTC2 - logsumTCZero2) / avgDenomenator;
-                    logsum.insert(std::make_pair(2,logsumScaledMaxCost2));
-
-                    double logsumScaledMaxCost3 = (logsumTC3 - logsumTCZero3) / avgDenomenator;
-                    logsum.insert(std::make_pair(3,logsumScaledMaxCost3));
-
-                    double logsumScaledMaxCost4 = (logsumTC4 - logsumTCZero4) / avgDenomenator;
-                    logsum.insert(std::make_pair(4,logsumScaledMaxCost4));
-
-                    double logsumScaledMaxCost5 = (logsumTC5 - logsumTCZero5) / avgDenomenator;
-                    logsum.insert(std::make_pair(5,logsumScaledMaxCost5));
-                }
+        double logsumTCPlusOne0 = personParams0.getDpbLogsum();
+        double logsumTCPlusOne1 = personParams1.getDpbLogsum();
+        double logsumTCPlusOne2 = personParams2.getDpbLogsum();
+        double logsumTCPlusOne3 = personParams3.getDpbLogsum();
+        double logsumTCPlusOne4 = personParams4.getDpbLogsum();
+        double logsumTCPlusOne5 = personParams5.getDpbLogsum();
 
-                if(config.ltParams.outputHouseholdLogsums.maxTime)
-                {
-                    const std::string luaDirCTlusOne = "CTPlusOne";
-                    personParams0 = PredayLT_LogsumManager::getInstance().computeLogsum( householdIndividualIds[n],tazH, tazW, 0 , &personParams,luaDirCTlusOne );
-                    personParams1 = PredayLT_LogsumManager::getInstance().computeLogsum( householdIndividualIds[n],tazH, tazW, 1 , &personParams ,luaDirCTlusOne);
-                    personParams2 = PredayLT_LogsumManager::getInstance().computeLogsum( householdIndividualIds[n],tazH, tazW, 2 , &personParams ,luaDirCTlusOne);
-                    personParams3 = PredayLT_LogsumManager::getInstance().computeLogsum( householdIndividualIds[n],tazH, tazW, 3 , &personParams,luaDirCTlusOne );
-                    personParams4 = PredayLT_LogsumManager::getInstance().computeLogsum( householdIndividualIds[n],tazH, tazW, 4 , &personParams,luaDirCTlusOne );
-                    personParams5 = PredayLT_LogsumManager::getInstance().computeLogsum( householdIndividualIds[n],tazH, tazW, 5 , &personParams ,luaDirCTlusOne);
+        double denominator0 = (logsumTC0 -logsumTCPlusOne0 );
+        double denominator1 = (logsumTC1 -logsumTCPlusOne1 );
+        double denominator2 = (logsumTC2 -logsumTCPlusOne2 );
+        double denominator3 = (logsumTC3 -logsumTCPlusOne3 );
+        double denominator4 = (logsumTC4 -logsumTCPlusOne4 );
+        double denominator5 = (logsumTC5 -logsumTCPlusOne5 ); 
 
-                    double logsumCTPlusOne0 = personParams0.getDpbLogsum();
-                    double logsumCTPlusOne1 = personParams1.getDpbLogsum();
-                    double logsumCTPlusOne2 = personParams2.getDpbLogsum();
-                    double logsumCTPlusOne3 = personParams3.getDpbLogsum();
-                    double logsumCTPlusOne4 = personParams4.getDpbLogsum();
-                    double logsumCTPlusOne5 = personParams5.getDpbLogsum();
+        double avgDenomenator = (denominator0 + denominator1 + denominator2 + denominator3 + denominator4  + denominator5) / 6.0;
 
-                    double denominator0 = (logsumTC0 -logsumCTPlusOne0 );
-                    double denominator1 = (logsumTC1 -logsumCTPlusOne1 );
-                    double denominator2 = (logsumTC2 -logsumCTPlusOne2 );
-                    double denominator3 = (logsumTC3 -logsumCTPlusOne3 );
-                    double denominator4 = (logsumTC4 -logsumCTPlusOne4 );
-                    double denominator5 = (logsumTC5 -logsumCTPlusOne5 ); 
+        double logsumScaledMaxCost0 = (logsumTC0 - logsumTCZero0) / avgDenomenator;
+        logsum.insert(std::make_pair(0,logsumScaledMaxCost0));
 
-                    double avgDenomenator = (denominator0 + denominator1 + denominator2 + denominator3 + denominator4  + denominator5) / 6.0;
+        double logsumScaledMaxCost1 = (logsumTC1 - logsumTCZero1) / avgDenomenator;
+        logsum.insert(std::make_pair(1,logsumScaledMaxCost1));
 
+        double logsumScaledMaxCost2 = (logsumTC2 - logsumTCZero2) / avgDenomenator;
+        logsum.insert(std::make_pair(2,logsumScaledMaxCost2));
 
-                    double logsumScaledMaxTime0 =  (logsumTC0 - logsumTCZero0) / avgDenomenator;
-                    logsum.insert(std::make_pair(0,logsumScaledMaxTime0));
+        double logsumScaledMaxCost3 = (logsumTC3 - logsumTCZero3) / avgDenomenator;
+        logsum.insert(std::make_pair(3,logsumScaledMaxCost3));
 
-                    double logsumScaledMaxTime1 =  (logsumTC1 - logsumTCZero1) / avgDenomenator;
-                    logsum.insert(std::make_pair(1,logsumScaledMaxTime1));
+        double logsumScaledMaxCost4 = (logsumTC4 - logsumTCZero4) / avgDenomenator;
+        logsum.insert(std::make_pair(4,logsumScaledMaxCost4));
 
-                    double logsumScaledMaxTime2 =  (logsumTC2 - logsumTCZero2) / avgDenomenator;
-                    logsum.insert(std::make_pair(2,logsumScaledMaxTime2));
+        double logsumScaledMaxCost5 = (logsumTC5 - logsumTCZero5) / avgDenomenator;
+        logsum.insert(std::make_pair(5,logsumScaledMaxCost5));
+    }
 
-                    double logsumScaledMaxTime3 =  (logsumTC3 - logsumTCZero3) / avgDenomenator;
-                    logsum.insert(std::make_pair(3,logsumScaledMaxTime3));
+    if(config.ltParams.outputHouseholdLogsums.maxTime)
+    {
+        const std::string luaDirCTlusOne = "CTPlusOne";
+        personParams0 = PredayLT_LogsumManager::getInstance().computeLogsum( thisIndividual->getId(),tazH, tazW, 0 , &personParams,luaDirCTlusOne );
+        personParams1 = PredayLT_LogsumManager::getInstance().computeLogsum( thisIndividual->getId(),tazH, tazW, 1 , &personParams ,luaDirCTlusOne);
+        personParams2 = PredayLT_LogsumManager::getInstance().computeLogsum( thisIndividual->getId(),tazH, tazW, 2 , &personParams ,luaDirCTlusOne);
+        personParams3 = PredayLT_LogsumManager::getInstance().computeLogsum( thisIndividual->getId(),tazH, tazW, 3 , &personParams,luaDirCTlusOne );
+        personParams4 = PredayLT_LogsumManager::getInstance().computeLogsum( thisIndividual->getId(),tazH, tazW, 4 , &personParams,luaDirCTlusOne );
+        personParams5 = PredayLT_LogsumManager::getInstance().computeLogsum( thisIndividual->getId(),tazH, tazW, 5 , &personParams ,luaDirCTlusOne);
 
-                    double logsumScaledMaxTime4 =  (logsumTC4 - logsumTCZero4) / avgDenomenator;
-                    logsum.insert(std::make_pair(4,logsumScaledMaxTime4));
+        double logsumCTPlusOne0 = personParams0.getDpbLogsum();
+        double logsumCTPlusOne1 = personParams1.getDpbLogsum();
+        double logsumCTPlusOne2 = personParams2.getDpbLogsum();
+        double logsumCTPlusOne3 = personParams3.getDpbLogsum();
+        double logsumCTPlusOne4 = personParams4.getDpbLogsum();
+        double logsumCTPlusOne5 = personParams5.getDpbLogsum();
 
-                    double logsumScaledMaxTime5 =  (logsumTC5 - logsumTCZero5) / avgDenomenator;
-                    logsum.insert(std::make_pair(5,logsumScaledMaxTime5));
-                }
+        double denominator0 = (logsumTC0 -logsumCTPlusOne0 );
+        double denominator1 = (logsumTC1 -logsumCTPlusOne1 );
+        double denominator2 = (logsumTC2 -logsumCTPlusOne2 );
+        double denominator3 = (logsumTC3 -logsumCTPlusOne3 );
+        double denominator4 = (logsumTC4 -logsumCTPlusOne4 );
+        double denominator5 = (logsumTC5 -logsumCTPlusOne5 ); 
 
-            }
+        double avgDenomenator = (denominator0 + denominator1 + denominator2 + denominator3 + denominator4  + denominator5) / 6.0;
 
-            printHouseholdHitsLogsumFVO( hitsSample->getHouseholdHitsId(), paxId, 
-                                         currentHousehold->getId(), householdIndividualIds[n],
-                                         thisIndividual->getEmploymentStatusId(),
-                                         thisIndividual->getAgeCategoryId(),
-                                         thisIndividual->getIncome(),
-                                         thisIndividual->getFixed_workplace(), 
-                                         thisIndividual->getMemberId(), tazH, tazW, logsum );
-        }
-}
 
+        double logsumScaledMaxTime0 =  (logsumTC0 - logsumTCZero0) / avgDenomenator;
+        logsum.insert(std::make_pair(0,logsumScaledMaxTime0));
+
+        double logsumScaledMaxTime1 =  (logsumTC1 - logsumTCZero1) / avgDenomenator;
+        logsum.insert(std::make_pair(1,logsumScaledMaxTime1));
+
+        double logsumScaledMaxTime2 =  (logsumTC2 - logsumTCZero2) / avgDenomenator;
+        logsum.insert(std::make_pair(2,logsumScaledMaxTime2));
+
+        double logsumScaledMaxTime3 =  (logsumTC3 - logsumTCZero3) / avgDenomenator;
+        logsum.insert(std::make_pair(3,logsumScaledMaxTime3));
+
+        double logsumScaledMaxTime4 =  (logsumTC4 - logsumTCZero4) / avgDenomenator;
+        logsum.insert(std::make_pair(4,logsumScaledMaxTime4));
+
+        double logsumScaledMaxTime5 =  (logsumTC5 - logsumTCZero5) / avgDenomenator;
+        logsum.insert(std::make_pair(5,logsumScaledMaxTime5));
+    }
 }
 
 void HM_Model::getLogsumOfHitsHouseholdVO(BigSerial householdId)
@@ -4030,6 +4018,61 @@ std::vector<boost::shared_ptr<VehicleOwnershipChanges> > HM_Model::getVehicleOwn
 }
 
 
+void HM_Model::precomputeHouseholdLogsums()
+{
+    const ConfigParams& config = ConfigManager::GetInstance().FullConfig();
+    const LongTermParams::LogsumPrecomputation& precomputation = config.ltParams.logsumPrecomputation;
+
+    std::vector<BigSerial> householdIds;
+    householdIds.reserve(households.size());
+    for( HouseholdList::const_iterator it = households.begin(); it != households.end(); it++ )
+    {
+        householdIds.push_back((*it)->getId());
+    }
+
+    unsigned int numThreads = (precomputation.threads > 0) ? precomputation.threads : config.ltParams.workers;
+    HouseholdLogsumPrecomputation logsumPrecomputation(this, numThreads);
+
+    //persisted logsums are only reused if they were computed from the same households, scripts and databases
+    std::size_t signature = logsumPrecomputation.getInputSignature(householdIds);
+
+    HouseholdLogsumPrecomputation::LogsumList logsums;
+    if( precomputation.persistResults && IndvidualVehicleOwnershipLogsum::loadSerializedData(signature, logsums) )
+    {
+        PrintOutV("Household vehicle ownership logsums loaded from disk: " << logsums.size() << std::endl);
+    }
+    else
+    {
+        if( precomputation.persistResults && std::ifstream(IndvidualVehicleOwnershipLogsum::filename).good() )
+        {
+            PrintOutV("Household vehicle ownership logsums on disk are stale; recomputing" << std::endl);
+        }
+
+        logsumPrecomputation.run(householdIds, logsums);
+
+        if( precomputation.persistResults )
+        {
+            IndvidualVehicleOwnershipLogsum::saveData(logsums, signature);
+        }
+    }
+
+    //computed logsums take precedence over the ones loaded from the database
+    for( HouseholdLogsumPrecomputation::LogsumList::iterator it = logsums.begin(); it != logsums.end(); it++ )
+    {
+        IndvidualVehicleOwnershipLogsumMap::iterator existing = IndvidualVehicleOwnershipLogsumById.find((*it)->getHouseholdId());
+        if( existing != IndvidualVehicleOwnershipLogsumById.end() )
+        {
+            *(existing->second) = **it;
+            delete *it;
+        }
+        else
+        {
+            IndvidualVehicleOwnershipLogsums.push_back(*it);
+            IndvidualVehicleOwnershipLogsumById.insert(std::make_pair((*it)->getHouseholdId(), *it));
+        }
+    }
+}
+
 IndvidualVehicleOwnershipLogsum* HM_Model::getIndvidualVehicleOwnershipLogsumsByHHId(BigSerial householdId) const
 {
     IndvidualVehicleOwnershipLogsumMap::const_iterator itr = IndvidualVehicleOwnershipLogsumById.find(householdId);
@@ -4856,6 +4899,14 @@ School* HM_Model::getSchoolById(BigSerial schoolId) const
 
 void HM_Model::stopImpl()
 {
+    const PredayLT_LogsumCache& logsumCache = PredayLT_LogsumManager::getLogsumCache();
+    if( logsumCache.getHits() + logsumCache.getMisses() > 0 )
+    {
+        PrintOutV("Logsum cache hits: " << logsumCache.getHits() << " misses: " << logsumCache.getMisses()
+                  << " hit rate: " << std::fixed << std::setprecision(2) << logsumCache.getHitRate() * 100 << "%"
+                  << " evictions: " << logsumCache.getEvictions() << std::endl);
+    }
+
     deleteAll(stats);
     clear_delete_vector(households);
     clear_delete_vector(units);
@@ -359,6 +359,22 @@ namespace sim_mob
             void getLogsumOfVaryingHomeOrWork(BigSerial id);
             void getLogsumOfHouseholdVO(BigSerial householdId);
             void getLogsumOfHouseholdVOForVO_Model(BigSerial householdId, std::unordered_map<int,double>&logsum);
+
+            /**
+             * @return the household member with the highest income (the first one on ties)
+             */
+            Individual* getMaxIncomeIndividual(const Household *household) const;
+
+            /**
+             * computes the vehicle ownership logsums (one per vehicle ownership option) of an individual.
+             * Safe to call from several threads.
+             * @param household household of the individual
+             * @param individual individual
+             * @param logsum output. vehicle ownership option id -> scaled logsum
+             * @param tazH output. home taz of the individual
+             * @param tazW output. work taz of the individual
+             */
+            void computeVehicleOwnershipLogsums(const Household *household, const Individual *individual, std::unordered_map<int,double> &logsum, BigSerial &tazH, BigSerial &tazW) const;
             void getLogsumOfHitsHouseholdVO(BigSerial householdId);
 
             HousingMarket* getMarket();
@@ -585,6 +601,11 @@ namespace sim_mob
             void update(int day);
 
         private:
+            /**
+             * computes the vehicle ownership logsums of all households in parallel and replaces the
+             * ones loaded from the database. Results are optionally persisted and reused on the next start.
+             */
+            void precomputeHouseholdLogsums();
 
             std::vector<HouseholdAgent*> freelanceAgents;
 
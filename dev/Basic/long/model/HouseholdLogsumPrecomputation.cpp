@@ -0,0 +1,225 @@
+//Copyright (c) 2017 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//license.txt   (http://opensource.org/licenses/MIT)
+
+/*
+ * HouseholdLogsumPrecomputation.cpp
+ */
+
+#include "model/HouseholdLogsumPrecomputation.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <unordered_map>
+#include <boost/bind.hpp>
+#include <boost/chrono.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/thread/thread.hpp>
+#include "conf/ConfigManager.hpp"
+#include "conf/ConfigParams.hpp"
+#include "model/HM_Model.hpp"
+#include "util/PrintLog.hpp"
+
+using namespace sim_mob;
+using namespace sim_mob::long_term;
+
+namespace
+{
+    //interval between two progress reports
+    const boost::chrono::seconds PROGRESS_INTERVAL(30);
+
+    //hashes the location and the contents of the lua scripts of one directory variant
+    void hashScripts(std::size_t &seed, const ModelScriptsMap &scripts)
+    {
+        boost::hash_combine(seed, scripts.getPath());
+        const std::map<std::string, std::string> &files = scripts.getScriptsFileNameMap();
+        for (std::map<std::string, std::string>::const_iterator it = files.begin(); it != files.end(); it++)
+        {
+            boost::hash_combine(seed, it->first);
+            boost::hash_combine(seed, it->second);
+            std::ifstream script((scripts.getPath() + it->second).c_str(), std::ios::binary);
+            boost::hash_combine(seed, std::string(std::istreambuf_iterator<char>(script), std::istreambuf_iterator<char>()));
+        }
+    }
+}
+
+HouseholdLogsumPrecomputation::HouseholdLogsumPrecomputation(const HM_Model *model, unsigned int numThreads) :
+        model(model), numThreads(std::max(1u, numThreads)), processed(0), failures(0), skipped(0) {}
+
+HouseholdLogsumPrecomputation::~HouseholdLogsumPrecomputation() {}
+
+unsigned int HouseholdLogsumPrecomputation::getFailures() const
+{
+    return failures;
+}
+
+unsigned int HouseholdLogsumPrecomputation::getSkipped() const
+{
+    return skipped;
+}
+
+void HouseholdLogsumPrecomputation::run(const std::vector<BigSerial> &householdIds, LogsumList &results)
+{
+    processed = 0;
+    failures = 0;
+    skipped = 0;
+
+    const size_t total = householdIds.size();
+    const unsigned int threadsUsed = std::min<size_t>(numThreads, std::max<size_t>(1, total));
+    const size_t partitionSize = (total + threadsUsed - 1) / threadsUsed;
+
+    std::vector<LogsumList> partitionResults(threadsUsed);
+    std::vector<boost::thread*> threads;
+    for (unsigned int t = 0; t < threadsUsed; t++)
+    {
+        size_t begin = std::min(total, t * partitionSize);
+        size_t end = std::min(total, begin + partitionSize);
+        threads.push_back(new boost::thread(boost::bind(&HouseholdLogsumPrecomputation::computePartition, this,
+                                                        boost::cref(householdIds), begin, end, boost::ref(partitionResults[t]))));
+    }
+
+    PrintOutV("Logsum precomputation: " << total << " households on " << threadsUsed << " threads" << std::endl);
+
+    boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
+    for (std::vector<boost::thread*>::iterator it = threads.begin(); it != threads.end(); it++)
+    {
+        while (!(*it)->try_join_for(PROGRESS_INTERVAL))
+        {
+            double elapsed = boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+            unsigned int done = processed;
+            PrintOutV("Logsum precomputation: " << done << "/" << total << " households, "
+                      << (elapsed > 0 ? done / elapsed : 0) << " households/s" << std::endl);
+        }
+        delete *it;
+    }
+
+    //merge in partition order; the output is in the order of the input ids whatever the number of threads
+    for (std::vector<LogsumList>::iterator it = partitionResults.begin(); it != partitionResults.end(); it++)
+    {
+        results.insert(results.end(), it->begin(), it->end());
+    }
+
+    double elapsed = boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+    PrintOutV("Logsum precomputation done: " << results.size() << " households in " << elapsed << "s ("
+              << (elapsed > 0 ? total / elapsed : 0) << " households/s), " << skipped << " without a logsum, "
+              << failures << " failed" << std::endl);
+}
+
+std::size_t HouseholdLogsumPrecomputation::getInputSignature(const std::vector<BigSerial> &householdIds) const
+{
+    const ConfigParams& config = ConfigManager::GetInstance().FullConfig();
+    std::size_t seed = 0;
+
+    //configuration: lua models and the databases the population and zone costs are read from
+    hashScripts(seed, config.luaScriptsMapTC);
+    hashScripts(seed, config.luaScriptsMapTCZeroCostConstants);
+    hashScripts(seed, config.luaScriptsMapTimeCostPlusOne);
+    hashScripts(seed, config.luaScriptsMapCostTimePlusOne);
+    boost::hash_combine(seed, config.ltParams.outputHouseholdLogsums.maxcCost);
+    boost::hash_combine(seed, config.ltParams.outputHouseholdLogsums.maxTime);
+    boost::hash_combine(seed, config.schemas.main_schema);
+    boost::hash_combine(seed, config.schemas.calibration_schema);
+    std::map<std::string, Database>::const_iterator mtDb = config.constructs.databases.find("fm_remote_mt");
+    if (mtDb != config.constructs.databases.end())
+    {
+        boost::hash_combine(seed, mtDb->second.host);
+        boost::hash_combine(seed, mtDb->second.port);
+        boost::hash_combine(seed, mtDb->second.dbName);
+    }
+
+    //inputs: the attributes computeVehicleOwnershipLogsums passes to the lua models
+    for (std::vector<BigSerial>::const_iterator it = householdIds.begin(); it != householdIds.end(); it++)
+    {
+        boost::hash_combine(seed, *it);
+        const Household *household = model->getHouseholdById(*it);
+        if (!household || household->getIndividuals().empty())
+        {
+            continue;
+        }
+        boost::hash_combine(seed, household->getUnitId());
+        boost::hash_combine(seed, household->getVehicleOwnershipOptionId());
+        boost::hash_combine(seed, household->getSize());
+        boost::hash_combine(seed, household->getChildUnder4());
+        boost::hash_combine(seed, household->getChildUnder15());
+        boost::hash_combine(seed, household->getAdult());
+        boost::hash_combine(seed, household->getWorkers());
+
+        const Individual *individual = model->getMaxIncomeIndividual(household);
+        if (!individual)
+        {
+            continue;
+        }
+        boost::hash_combine(seed, individual->getId());
+        boost::hash_combine(seed, individual->getJobId());
+        boost::hash_combine(seed, individual->getEmploymentStatusId());
+        boost::hash_combine(seed, individual->getGenderId());
+        boost::hash_combine(seed, individual->getEducationId());
+        boost::hash_combine(seed, individual->getAgeCategoryId());
+        boost::hash_combine(seed, individual->getIncome());
+        boost::hash_combine(seed, individual->getWorkAtHome());
+        boost::hash_combine(seed, individual->getCarLicense());
+        boost::hash_combine(seed, individual->getMotorLicense());
+        boost::hash_combine(seed, individual->getVanBusLicense());
+        boost::hash_combine(seed, individual->getFixed_hours());
+        boost::hash_combine(seed, individual->getStudentId());
+    }
+    return seed;
+}
+
+void HouseholdLogsumPrecomputation::computePartition(const std::vector<BigSerial> &householdIds, size_t begin, size_t end, LogsumList &results)
+{
+    for (size_t n = begin; n < end; n++)
+    {
+        try
+        {
+            IndvidualVehicleOwnershipLogsum *logsum = computeHousehold(householdIds[n]);
+            if (logsum)
+            {
+                results.push_back(logsum);
+            }
+            else
+            {
+                skipped++;
+            }
+        }
+        catch (const std::exception &ex)
+        {
+            PrintOutV("Logsum precomputation failed for household " << householdIds[n] << ": " << ex.what() << std::endl);
+            failures++;
+        }
+        processed++;
+    }
+}
+
+IndvidualVehicleOwnershipLogsum* HouseholdLogsumPrecomputation::computeHousehold(BigSerial householdId) const
+{
+    const Household *household = model->getHouseholdById(householdId);
+    if (!household)
+    {
+        throw std::runtime_error("unknown household");
+    }
+
+    //households whose highest earner has no job have no work location, and no vehicle ownership logsum
+    if (household->getIndividuals().empty())
+    {
+        return nullptr;
+    }
+
+    const Individual *individual = model->getMaxIncomeIndividual(household);
+    if (!individual)
+    {
+        throw std::runtime_error("unknown household member");
+    }
+    if (!model->getJobById(individual->getJobId()))
+    {
+        return nullptr;
+    }
+
+    std::unordered_map<int, double> logsum;
+    BigSerial tazH = 0;
+    BigSerial tazW = 0;
+    model->computeVehicleOwnershipLogsums(household, individual, logsum, tazH, tazW);
+
+    return new IndvidualVehicleOwnershipLogsum(householdId, individual->getId(), logsum[0], logsum[1], logsum[2], logsum[3], logsum[4], logsum[5]);
+}
@@ -0,0 +1,86 @@
+//Copyright (c) 2017 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//license.txt   (http://opensource.org/licenses/MIT)
+
+/*
+ * HouseholdLogsumPrecomputation.hpp
+ */
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include "Types.hpp"
+#include "database/entity/IndvidualVehicleOwnershipLogsum.hpp"
+
+namespace sim_mob
+{
+    namespace long_term
+    {
+        class HM_Model;
+
+        /**
+         * Startup stage computing the vehicle ownership logsums of all households in parallel.
+         *
+         * Households are split into contiguous partitions, one per thread. Each thread computes through
+         * PredayLT_LogsumManager, which gives it its own lua models and LT database connection.
+         * The partitions are concatenated in order, so the result does not depend on the number of threads.
+         */
+        class HouseholdLogsumPrecomputation
+        {
+        public:
+            typedef std::vector<IndvidualVehicleOwnershipLogsum*> LogsumList;
+
+            /**
+             * @param model housing market model owning the households
+             * @param numThreads number of computing threads; at least one is used
+             */
+            HouseholdLogsumPrecomputation(const HM_Model *model, unsigned int numThreads);
+            virtual ~HouseholdLogsumPrecomputation();
+
+            /**
+             * Computes the logsums of the given households.
+             * @param householdIds households to process
+             * @param results output. One entry (owned by the caller) per household with a computable logsum,
+             *        in the order of householdIds.
+             */
+            void run(const std::vector<BigSerial> &householdIds, LogsumList &results);
+
+            /**
+             * Signature of everything the logsums of the given households are computed from: the household and
+             * individual attributes passed to the lua models, the lua scripts, and the database the zone costs come from.
+             * Logsums persisted with another signature are stale.
+             * @param householdIds households to process
+             */
+            virtual std::size_t getInputSignature(const std::vector<BigSerial> &householdIds) const;
+
+            /**
+             * @return number of households which could not be processed in the last run
+             */
+            unsigned int getFailures() const;
+
+            /**
+             * @return number of households skipped in the last run because they have no logsum (no members, or no job)
+             */
+            unsigned int getSkipped() const;
+
+        protected:
+            /**
+             * Computes the logsums of one household, exactly as the on-demand path of the vehicle ownership model does.
+             * @return the logsums (owned by the caller), or null if the household has no logsum
+             * @throws std::runtime_error if the household could not be processed
+             */
+            virtual IndvidualVehicleOwnershipLogsum* computeHousehold(BigSerial householdId) const;
+
+        private:
+            void computePartition(const std::vector<BigSerial> &householdIds, size_t begin, size_t end, LogsumList &results);
+
+            const HM_Model *model;
+            unsigned int numThreads;
+
+            std::atomic<unsigned int> processed;
+            std::atomic<unsigned int> failures;
+            std::atomic<unsigned int> skipped;
+        };
+    }
+}
@@ -11,14 +11,19 @@
  */
 
 #include <cmath>
+#include <numeric>
 #include <boost/format.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+#include <boost/unordered_set.hpp>
 #include "HouseholdBidderRole.hpp"
 #include "message/LT_Message.hpp"
 #include "event/EventPublisher.hpp"
 #include "event/EventManager.hpp"
 #include "agent/impl/HouseholdAgent.hpp"
 #include "util/Statistics.hpp"
+#include "util/AliasTable.hpp"
+#include "util/RandomStream.hpp"
 #include "util/SharedFunctions.hpp"
 #include "message/MessageBus.hpp"
 #include "model/lua/LuaProvider.hpp"
@@ -630,10 +635,12 @@ bool HouseholdBidderRole::pickEntryToBid()
 
     const double minUnitsInZoneHousingType = 2;
 
-    //get available entries (for preferable zones if exists)
-    HousingMarket::ConstEntryList entries;
+    //the snapshot is built once per day and shared by all bidders
+    HousingMarket::SnapshotPtr snapshot = market->getSnapshot(day);
+    const HousingMarket::ConstEntryList& entries = snapshot->getAvailableEntries();
 
-    market->getAvailableEntries(entries);
+    //one random stream per household and day, so the draws do not depend on how households are spread over workers
+    RandomStream randomGenerator = RandomStream::forEntity(household->getId(), day, RandomStream::HOUSING_CHOICESET);
 
     BigSerial maxEntryUnitId = INVALID_ID;
     double maxSurplus = INT_MIN; // holds the wp of the entry with maximum surplus.
@@ -645,6 +652,7 @@ bool HouseholdBidderRole::pickEntryToBid()
 
     ConfigParams& config = ConfigManager::GetInstanceRW().FullConfig();
     float housingMarketSearchPercentage = config.ltParams.housingModel.housingMarketSearchPercentage;
+    const size_t choicesetSize = config.ltParams.housingModel.bidderUnitChoiceset.bidderChoicesetSize;
 
     HouseHoldHitsSample *householdHits = model->getHouseHoldHitsById( household->getId() );
 
@@ -660,58 +668,53 @@ bool HouseholdBidderRole::pickEntryToBid()
     if(householdScreeningProbabilities.size() > 0 )
         printProbabilityList(household->getId(), householdScreeningProbabilities);
 
-    std::set<const HousingMarket::Entry*> screenedEntries;
-    std::vector<const HousingMarket::Entry*> screenedEntriesVec; //This vector's only purpose is to print the choiceset
+    //screened entries in the order they were picked. The set is only used to skip duplicates.
+    std::vector<const HousingMarket::Entry*> screenedEntries;
+    boost::unordered_set<const HousingMarket::Entry*> screenedEntrySet;
+    screenedEntries.reserve(choicesetSize + config.ltParams.housingModel.bidderUnitChoiceset.bidderBTOChoicesetSize);
 
 
     if(config.ltParams.housingModel.bidderUnitChoiceset.randomChoiceset == true)
     {
-        while (screenedEntries.size() < config.ltParams.housingModel.bidderUnitChoiceset.bidderChoicesetSize)
+        //the market may have fewer entries than the choiceset size
+        while (screenedEntries.size() < std::min(choicesetSize, entries.size()))
         {
-            double randomDraw = (double) rand() / RAND_MAX * entries.size();
-            screenedEntries.insert(entries[randomDraw]);
+            boost::random::uniform_int_distribution<size_t> entryDraw(0, entries.size() - 1);
+            const HousingMarket::Entry* entry = entries[entryDraw(randomGenerator)];
+
+            if (screenedEntrySet.insert(entry).second)
+                screenedEntries.push_back(entry);
         }
     }
     else
     if(config.ltParams.housingModel.bidderUnitChoiceset.shanRobertoChoiceset == true)
     {
-        for (int n = 0; n < entries.size() && screenedEntries.size() < config.ltParams.housingModel.bidderUnitChoiceset.bidderChoicesetSize; n++)
-        {
-            double randomDraw = (double) rand() / RAND_MAX;
-            int zoneHousingType = -1;
-            double cummulativeProbability = 0.0;
-            for (int m = 0; m < householdScreeningProbabilities.size(); m++)
-            {
-                cummulativeProbability += householdScreeningProbabilities[m];
-                if (cummulativeProbability > randomDraw)
-                {
-                    zoneHousingType = m + 1; //housing type is a one-based index
-                    break;
-                }
-            }
-
-
-            auto range = market->getunitsByZoneHousingType().equal_range(zoneHousingType);
-            int numUnits = distance(range.first, range.second); //find the number of units in the above zoneHousingType
+        //The screening probabilities do not always sum up to one. Draws falling beyond their sum select no zone housing type;
+        //the residual is kept as an extra outcome of the alias table.
+        std::vector<double> screeningWeights(householdScreeningProbabilities);
+        double totalProbability = std::accumulate(householdScreeningProbabilities.begin(), householdScreeningProbabilities.end(), 0.0);
+        if (totalProbability < 1.0)
+            screeningWeights.push_back(1.0 - totalProbability);
 
-            if (numUnits < minUnitsInZoneHousingType)
-                continue;
+        AliasTable screeningTable(screeningWeights);
 
+        for (int n = 0; n < entries.size() && screenedEntries.size() < choicesetSize && !screeningTable.empty(); n++)
+        {
+            size_t drawnType = screeningTable.sample(randomGenerator);
 
-            if (numUnits == 0)
+            if (drawnType >= householdScreeningProbabilities.size())
                 continue;
 
-            int offset = (float) rand() / RAND_MAX * (numUnits - 1);
-            advance(range.first, offset); // change a random unit in that zoneHousingType
+            int zoneHousingType = drawnType + 1; //housing type is a one-based index
 
-            const BigSerial unitId = (range.first)->second;
+            const HousingMarket::ConstEntryList& zoneEntries = snapshot->getEntriesByZoneHousingType(zoneHousingType);
+            int numUnits = zoneEntries.size(); //find the number of units in the above zoneHousingType
 
-
-            const HousingMarket::Entry *entry = market->getEntryById(unitId);
-
-            if (entry == nullptr || entry->isBuySellIntervalCompleted() == false)
+            if (numUnits < minUnitsInZoneHousingType)
                 continue;
 
+            boost::random::uniform_int_distribution<int> unitDraw(0, numUnits - 1);
+            const HousingMarket::Entry *entry = zoneEntries[unitDraw(randomGenerator)]; // a random unit in that zoneHousingType
 
             const Unit *thisUnit = model->getUnitById(entry->getUnitId());
 
@@ -721,54 +724,43 @@ bool HouseholdBidderRole::pickEntryToBid()
 
                 if (thisUnit->getTenureStatus() == 2 && getParent()->getFutureTransitionOwn() == false) //rented
                 {
-                    std::set<const HousingMarket::Entry *>::iterator screenedEntriesItr;
-                    screenedEntriesItr = std::find(screenedEntries.begin(), screenedEntries.end(), entry);
-
-                    if (screenedEntriesItr == screenedEntries.end())
-                        screenedEntries.insert(entry);
+                    if (screenedEntrySet.insert(entry).second)
+                        screenedEntries.push_back(entry);
                 }
                 else if (thisUnit->getTenureStatus() == 1) //owner-occupied
                 {
-                    std::set<const HousingMarket::Entry *>::iterator screenedEntriesItr;
-                    screenedEntriesItr = std::find(screenedEntries.begin(), screenedEntries.end(), entry);
-
-                    if (screenedEntriesItr == screenedEntries.end())
-                        screenedEntries.insert(entry);
+                    if (screenedEntrySet.insert(entry).second)
+                        screenedEntries.push_back(entry);
                 }
             }
         }
     }
 
     {
-
-        for(auto itr = screenedEntries.begin(); itr != screenedEntries.end(); itr++)
-            screenedEntriesVec.push_back(*itr);
-
-
-        //btoEntries will contain pointers all the units in our 'units' vector that are marked as BTOs.
-        set<BigSerial> btoEntries = market->getBTOEntries();
+        const std::vector<BigSerial>& btoEntries = snapshot->getBTOEntries();
 
         //Add x number of BTO units to the screenedUnit vector if the household is eligible for it
-        for(int n = 0; n < config.ltParams.housingModel.bidderUnitChoiceset.bidderBTOChoicesetSize && btoEntries.size() != 0; n++)
+        size_t btoChoicesetSize = std::min<size_t>(config.ltParams.housingModel.bidderUnitChoiceset.bidderBTOChoicesetSize, btoEntries.size());
+        boost::unordered_set<size_t> pickedBTOs;
+        while (pickedBTOs.size() < btoChoicesetSize)
         {
-            int offset = (float)rand() / RAND_MAX * ( btoEntries.size() - 1 );
-
-            auto itr =  btoEntries.begin();
-            std::advance( itr, offset);
+            boost::random::uniform_int_distribution<size_t> btoDraw(0, btoEntries.size() - 1);
+            size_t offset = btoDraw(randomGenerator);
 
-            const HousingMarket::Entry* entry = market->getEntryById(*itr);
+            if (!pickedBTOs.insert(offset).second)
+                continue;
 
-            screenedEntries.insert(entry);
-            screenedEntriesVec.push_back(entry);
+            const HousingMarket::Entry* entry = market->getEntryById(btoEntries[offset]);
 
-            btoEntries.erase(*itr);
+            if (entry != nullptr && screenedEntrySet.insert(entry).second)
+                screenedEntries.push_back(entry);
         }
 
         std::string choiceset(" ");
-        for(int n = 0; n < screenedEntriesVec.size(); n++)
+        for(int n = 0; n < screenedEntries.size(); n++)
         {
-            printChoiceset2(day-1, household->getId(),screenedEntriesVec[n]->getUnitId());
-            choiceset += std::to_string( screenedEntriesVec[n]->getUnitId() )  + ", ";
+            printChoiceset2(day-1, household->getId(),screenedEntries[n]->getUnitId());
+            choiceset += std::to_string( screenedEntries[n]->getUnitId() )  + ", ";
         }
 
         printChoiceset(day-1, household->getId(), choiceset);
@@ -781,10 +773,7 @@ bool HouseholdBidderRole::pickEntryToBid()
     // This is done to replicate the real life scenario where a household will only visit a certain percentage of vacant units before settling on one.
     for(int n = 0; n < screenedEntries.size(); n++)
     {
-        auto itr = screenedEntries.begin();
-        advance(itr, n);
-
-        const HousingMarket::Entry* entry = *itr;
+        const HousingMarket::Entry* entry = screenedEntries[n];
 
         if( entry->getAskingPrice() < 0.01 )
         {
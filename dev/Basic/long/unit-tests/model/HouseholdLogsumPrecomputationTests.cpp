@@ -0,0 +1,163 @@
+//Copyright (c) 2017 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+/*
+ * HouseholdLogsumPrecomputationTests.cpp
+ */
+
+#include "HouseholdLogsumPrecomputationTests.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+#include "model/HouseholdLogsumPrecomputation.hpp"
+
+using namespace sim_mob::long_term;
+using namespace unit_tests;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::HouseholdLogsumPrecomputationTests);
+
+namespace
+{
+    /**
+     * Precomputation whose per-household computation does not need the model's database.
+     * Households divisible by 5 have no job, households divisible by 7 cannot be processed.
+     */
+    class TestPrecomputation : public HouseholdLogsumPrecomputation
+    {
+    public:
+        explicit TestPrecomputation(unsigned int numThreads) : HouseholdLogsumPrecomputation(nullptr, numThreads) {}
+
+        IndvidualVehicleOwnershipLogsum* computeOnDemand(BigSerial householdId) const
+        {
+            return computeHousehold(householdId);
+        }
+
+    protected:
+        virtual IndvidualVehicleOwnershipLogsum* computeHousehold(BigSerial householdId) const
+        {
+            if (householdId % 7 == 0)
+            {
+                throw std::runtime_error("no unit");
+            }
+            if (householdId % 5 == 0)
+            {
+                return nullptr;
+            }
+            double base = std::sin((double) householdId);
+            return new IndvidualVehicleOwnershipLogsum(householdId, householdId * 10, base, base + 1, base + 2, base + 3, base + 4, base + 5);
+        }
+    };
+
+    std::vector<BigSerial> makeHouseholdIds(BigSerial count)
+    {
+        std::vector<BigSerial> ids;
+        for (BigSerial id = 1; id <= count; id++)
+        {
+            ids.push_back(id);
+        }
+        return ids;
+    }
+
+    void deleteAll(HouseholdLogsumPrecomputation::LogsumList &logsums)
+    {
+        for (HouseholdLogsumPrecomputation::LogsumList::iterator it = logsums.begin(); it != logsums.end(); it++)
+        {
+            delete *it;
+        }
+        logsums.clear();
+    }
+
+    void assertSameLogsum(const IndvidualVehicleOwnershipLogsum &expected, const IndvidualVehicleOwnershipLogsum &actual)
+    {
+        CPPUNIT_ASSERT_EQUAL(expected.getHouseholdId(), actual.getHouseholdId());
+        CPPUNIT_ASSERT_EQUAL(expected.getIndividualId(), actual.getIndividualId());
+        CPPUNIT_ASSERT_EQUAL(expected.getLogsum0(), actual.getLogsum0());
+        CPPUNIT_ASSERT_EQUAL(expected.getLogsum1(), actual.getLogsum1());
+        CPPUNIT_ASSERT_EQUAL(expected.getLogsum2(), actual.getLogsum2());
+        CPPUNIT_ASSERT_EQUAL(expected.getLogsum3(), actual.getLogsum3());
+        CPPUNIT_ASSERT_EQUAL(expected.getLogsum4(), actual.getLogsum4());
+        CPPUNIT_ASSERT_EQUAL(expected.getLogsum5(), actual.getLogsum5());
+    }
+}
+
+void HouseholdLogsumPrecomputationTests::testMatchesOnDemand()
+{
+    const std::vector<BigSerial> householdIds = makeHouseholdIds(103);
+
+    const unsigned int threadCounts[] = { 1, 3, 8, 200 };
+    for (unsigned int t = 0; t < sizeof(threadCounts) / sizeof(threadCounts[0]); t++)
+    {
+        TestPrecomputation precomputation(threadCounts[t]);
+        HouseholdLogsumPrecomputation::LogsumList logsums;
+        precomputation.run(householdIds, logsums);
+
+        //every household with a logsum is present, in input order, with the value the on-demand path gives
+        HouseholdLogsumPrecomputation::LogsumList::const_iterator precomputed = logsums.begin();
+        for (std::vector<BigSerial>::const_iterator id = householdIds.begin(); id != householdIds.end(); id++)
+        {
+            IndvidualVehicleOwnershipLogsum *onDemand = nullptr;
+            try
+            {
+                onDemand = precomputation.computeOnDemand(*id);
+            }
+            catch (const std::runtime_error&)
+            {
+                continue;
+            }
+            if (!onDemand)
+            {
+                continue;
+            }
+
+            CPPUNIT_ASSERT(precomputed != logsums.end());
+            assertSameLogsum(*onDemand, **precomputed);
+            delete onDemand;
+            precomputed++;
+        }
+        CPPUNIT_ASSERT(precomputed == logsums.end());
+        deleteAll(logsums);
+    }
+}
+
+void HouseholdLogsumPrecomputationTests::testSkippedAndFailed()
+{
+    TestPrecomputation precomputation(4);
+    HouseholdLogsumPrecomputation::LogsumList logsums;
+    precomputation.run(makeHouseholdIds(70), logsums);
+
+    //multiples of 7 fail, other multiples of 5 have no job and are skipped without counting as failures
+    CPPUNIT_ASSERT_EQUAL(10u, precomputation.getFailures());
+    CPPUNIT_ASSERT_EQUAL(12u, precomputation.getSkipped());
+    CPPUNIT_ASSERT_EQUAL((size_t) 48, logsums.size());
+    deleteAll(logsums);
+}
+
+void HouseholdLogsumPrecomputationTests::testPersistedSignature()
+{
+    const std::string file = "householdLogsumPrecomputationTests.bin";
+
+    TestPrecomputation precomputation(2);
+    HouseholdLogsumPrecomputation::LogsumList logsums;
+    precomputation.run(makeHouseholdIds(20), logsums);
+    IndvidualVehicleOwnershipLogsum::saveData(logsums, 42, file);
+
+    HouseholdLogsumPrecomputation::LogsumList loaded;
+    CPPUNIT_ASSERT(IndvidualVehicleOwnershipLogsum::loadSerializedData(42, loaded, file));
+    CPPUNIT_ASSERT_EQUAL(logsums.size(), loaded.size());
+    for (size_t n = 0; n < logsums.size(); n++)
+    {
+        assertSameLogsum(*logsums[n], *loaded[n]);
+    }
+    deleteAll(loaded);
+
+    //logsums computed from other inputs are rejected
+    CPPUNIT_ASSERT(!IndvidualVehicleOwnershipLogsum::loadSerializedData(43, loaded, file));
+    CPPUNIT_ASSERT(loaded.empty());
+
+    std::remove(file.c_str());
+    CPPUNIT_ASSERT(!IndvidualVehicleOwnershipLogsum::loadSerializedData(42, loaded, file));
+    deleteAll(logsums);
+}
@@ -0,0 +1,31 @@
+//Copyright (c) 2017 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+/*
+ * HouseholdLogsumPrecomputationTests.hpp
+ */
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests {
+
+class HouseholdLogsumPrecomputationTests : public CppUnit::TestFixture
+{
+public:
+    void testMatchesOnDemand();
+    void testSkippedAndFailed();
+    void testPersistedSignature();
+
+private:
+    CPPUNIT_TEST_SUITE(HouseholdLogsumPrecomputationTests);
+        CPPUNIT_TEST(testMatchesOnDemand);
+        CPPUNIT_TEST(testSkippedAndFailed);
+        CPPUNIT_TEST(testPersistedSignature);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
@@ -0,0 +1,76 @@
+//Copyright (c) 2017 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+/*
+ * AliasTableTests.cpp
+ */
+
+#include "AliasTableTests.hpp"
+
+#include <vector>
+#include <boost/random/mersenne_twister.hpp>
+#include "util/AliasTable.hpp"
+
+using namespace sim_mob::long_term;
+using namespace unit_tests;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::AliasTableTests);
+
+void AliasTableTests::testEmptyTable()
+{
+    AliasTable table;
+    CPPUNIT_ASSERT(table.empty());
+
+    std::vector<double> weights(3, 0.0);
+    table.build(weights);
+    CPPUNIT_ASSERT(table.empty());
+}
+
+void AliasTableTests::testSingleOutcome()
+{
+    AliasTable table(std::vector<double>(1, 0.3));
+    CPPUNIT_ASSERT_EQUAL((size_t)1, table.size());
+    CPPUNIT_ASSERT_EQUAL((size_t)0, table.sample(0.0, 0.0));
+    CPPUNIT_ASSERT_EQUAL((size_t)0, table.sample(0.999, 0.999));
+}
+
+void AliasTableTests::testZeroWeightsNeverDrawn()
+{
+    std::vector<double> weights;
+    weights.push_back(0.0);
+    weights.push_back(2.0);
+    weights.push_back(0.0);
+    weights.push_back(1.0);
+    AliasTable table(weights);
+
+    boost::mt19937 generator(42);
+    for (int n = 0; n < 10000; n++)
+    {
+        size_t outcome = table.sample(generator);
+        CPPUNIT_ASSERT(outcome == 1 || outcome == 3);
+    }
+}
+
+void AliasTableTests::testFrequencies()
+{
+    std::vector<double> weights;
+    weights.push_back(0.1);
+    weights.push_back(0.2);
+    weights.push_back(0.3);
+    weights.push_back(0.4);
+    AliasTable table(weights);
+
+    const int draws = 200000;
+    std::vector<int> counts(weights.size(), 0);
+    boost::mt19937 generator(7);
+    for (int n = 0; n < draws; n++)
+    {
+        counts[table.sample(generator)]++;
+    }
+
+    for (size_t i = 0; i < weights.size(); i++)
+    {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(weights[i], (double) counts[i] / draws, 0.01);
+    }
+}
@@ -0,0 +1,33 @@
+//Copyright (c) 2017 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+/*
+ * AliasTableTests.hpp
+ */
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests {
+
+class AliasTableTests : public CppUnit::TestFixture
+{
+public:
+    void testEmptyTable();
+    void testSingleOutcome();
+    void testZeroWeightsNeverDrawn();
+    void testFrequencies();
+
+private:
+    CPPUNIT_TEST_SUITE(AliasTableTests);
+        CPPUNIT_TEST(testEmptyTable);
+        CPPUNIT_TEST(testSingleOutcome);
+        CPPUNIT_TEST(testZeroWeightsNeverDrawn);
+        CPPUNIT_TEST(testFrequencies);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
@@ -0,0 +1,108 @@
+//Copyright (c) 2017 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+/*
+ * File:   AliasTable.cpp
+ */
+
+#include "AliasTable.hpp"
+
+using namespace sim_mob::long_term;
+
+AliasTable::AliasTable() {}
+
+AliasTable::AliasTable(const std::vector<double>& weights)
+{
+    build(weights);
+}
+
+void AliasTable::build(const std::vector<double>& weights)
+{
+    probability.clear();
+    alias.clear();
+
+    double total = 0;
+    for (std::vector<double>::const_iterator itr = weights.begin(); itr != weights.end(); itr++)
+    {
+        if (*itr > 0)
+        {
+            total += *itr;
+        }
+    }
+
+    if (total <= 0)
+    {
+        return;
+    }
+
+    const size_t n = weights.size();
+    probability.resize(n);
+    alias.resize(n);
+
+    std::vector<size_t> small;
+    std::vector<size_t> large;
+    std::vector<double> scaled(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        scaled[i] = (weights[i] > 0 ? weights[i] : 0) * n / total;
+        if (scaled[i] < 1.0)
+        {
+            small.push_back(i);
+        }
+        else
+        {
+            large.push_back(i);
+        }
+    }
+
+    while (!small.empty() && !large.empty())
+    {
+        size_t less = small.back();
+        small.pop_back();
+        size_t more = large.back();
+
+        probability[less] = scaled[less];
+        alias[less] = more;
+
+        scaled[more] = (scaled[more] + scaled[less]) - 1.0;
+        if (scaled[more] < 1.0)
+        {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+
+    //whatever is left is (up to rounding errors) exactly 1
+    for (size_t i = 0; i < large.size(); i++)
+    {
+        probability[large[i]] = 1.0;
+        alias[large[i]] = large[i];
+    }
+    for (size_t i = 0; i < small.size(); i++)
+    {
+        probability[small[i]] = 1.0;
+        alias[small[i]] = small[i];
+    }
+}
+
+size_t AliasTable::sample(double u1, double u2) const
+{
+    const size_t n = probability.size();
+    size_t column = static_cast<size_t>(u1 * n);
+    if (column >= n)
+    {
+        column = n - 1;
+    }
+    return (u2 < probability[column]) ? column : alias[column];
+}
+
+size_t AliasTable::size() const
+{
+    return probability.size();
+}
+
+bool AliasTable::empty() const
+{
+    return probability.empty();
+}
@@ -0,0 +1,71 @@
+//Copyright (c) 2017 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+/*
+ * File:   AliasTable.hpp
+ */
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <boost/random/uniform_01.hpp>
+
+namespace sim_mob
+{
+    namespace long_term
+    {
+        /**
+         * Walker/Vose alias table for sampling a discrete distribution.
+         *
+         * Building the table is O(n); each draw is O(1) and needs two
+         * uniform numbers, whatever the number of outcomes.
+         */
+        class AliasTable
+        {
+        public:
+            AliasTable();
+
+            /**
+             * @param weights non-negative weights of the outcomes. They do not need to sum up to 1.
+             */
+            explicit AliasTable(const std::vector<double>& weights);
+
+            /**
+             * (Re)builds the table for the given weights.
+             * The table is empty if the weights sum up to zero.
+             * @param weights non-negative weights of the outcomes.
+             */
+            void build(const std::vector<double>& weights);
+
+            /**
+             * Draws an outcome.
+             * @param u1 uniform number in [0,1) selecting the column.
+             * @param u2 uniform number in [0,1) selecting between the column and its alias.
+             * @return index of the outcome in the weights vector.
+             */
+            size_t sample(double u1, double u2) const;
+
+            /**
+             * Draws an outcome with the given random number generator.
+             * @param generator uniform random number generator.
+             * @return index of the outcome in the weights vector.
+             */
+            template <typename Generator>
+            size_t sample(Generator& generator) const
+            {
+                boost::uniform_01<> uniform;
+                double u1 = uniform(generator);
+                double u2 = uniform(generator);
+                return sample(u1, u2);
+            }
+
+            size_t size() const;
+            bool empty() const;
+
+        private:
+            std::vector<double> probability;
+            std::vector<size_t> alias;
+        };
+    }
+}
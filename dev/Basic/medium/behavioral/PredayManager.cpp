@@ -1044,7 +1044,7 @@ void PredayManager::updateLogsumTable()
 	query = (sql_.prepare << "ALTER TABLE " << tableName << " OWNER TO postgres");
 	query.execute();
 
-	PG_BulkInserter bulkInserter(NUM_INSERTS_PER_QUERY);
+	PG_BulkInserter bulkInserter(NUM_INSERTS_PER_QUERY, mtCfg.getNumPredayThreads());
 	bulkInserter.setInputFile("logsum");
 
 	std::vector<std::string> columnNames = {"person_id", "work", "education", "shop", "other", "dp_tour",
@@ -1128,7 +1128,7 @@ void PredayManager::updateDayActivityScheduleTable()
 	query = (sql_.prepare << "ALTER TABLE " << tableName << " OWNER TO postgres");
 	query.execute();
 
-	PG_BulkInserter bulkInserter(NUM_INSERTS_PER_QUERY);
+	PG_BulkInserter bulkInserter(NUM_INSERTS_PER_QUERY, mtCfg.getNumPredayThreads());
 	bulkInserter.setInputFile(mtCfg.dasConfig.fileName);
     std::vector<std::string> columnNames;
     if(!(MT_Config::getInstance().isEnergyModelEnabled()))
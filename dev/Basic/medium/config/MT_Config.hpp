@@ -187,6 +187,23 @@ struct ScreenLineParams
 	std::string fileName;
 };
 
+/**
+ * Represents the supply_stats element of the output_statistics section of the configuration file
+ */
+struct SupplyStatsParams
+{
+	SupplyStatsParams() : binaryOutput(false), fileName(""), compress(true) {}
+
+	///Indicates whether the segment and link statistics are written to a columnar binary file instead of the log
+	bool binaryOutput;
+
+	///Name of the binary output file
+	std::string fileName;
+
+	///Indicates whether the blocks of the binary file are compressed
+	bool compress;
+};
+
 /**
  * represent the incident data section of the config file
  */
@@ -814,6 +831,9 @@ public:
 	/// screen line counts parameter
 	ScreenLineParams screenLineParams;
 
+	/// segment and link statistics output parameters
+	SupplyStatsParams supplyStatsParams;
+
 	/// Number of ticks to wait before updating all Person agents.
 	unsigned int granPersonTicks;
 
@@ -325,6 +325,9 @@ void ParseMidTermConfigFile::processStatisticsOutputNode(xercesc::DOMElement* no
 	child = GetSingleElementByName(node, "screen_line_count");
 	processScreenLineNode(child);
 
+	child = GetSingleElementByName(node, "supply_stats");
+	processSupplyStatsNode(child);
+
 	child = GetSingleElementByName(node, "pt_reroute");
 	value = ParseString(GetNamedAttributeValue(child, "file"), "");
 	cfg.setPT_PersonRerouteFilename(value);
@@ -661,6 +664,34 @@ void ParseMidTermConfigFile::processScreenLineNode(DOMElement *node)
 	}
 }
 
+void ParseMidTermConfigFile::processSupplyStatsNode(DOMElement *node)
+{
+	if(node)
+	{
+		std::string format = ParseString(GetNamedAttributeValue(node, "format"), "text");
+
+		if(format == "binary")
+		{
+			mtCfg.supplyStatsParams.binaryOutput = true;
+			mtCfg.supplyStatsParams.fileName = ParseString(GetNamedAttributeValue(node, "file"), "supply_stats.bin");
+			mtCfg.supplyStatsParams.compress = ParseBoolean(GetNamedAttributeValue(node, "compress"), true);
+
+			if(mtCfg.supplyStatsParams.fileName.empty())
+			{
+				std::stringstream msg;
+				msg << "Empty value for <supply_stats file=\"\">. Expected: \"file name\"";
+				throw std::runtime_error(msg.str());
+			}
+		}
+		else if(format != "text")
+		{
+			std::stringstream msg;
+			msg << "Invalid value for <supply_stats format=\"" << format << "\">. Expected: \"text\" or \"binary\"";
+			throw std::runtime_error(msg.str());
+		}
+	}
+}
+
 void ParseMidTermConfigFile::processGenerateBusRoutesNode(xercesc::DOMElement* node)
 {
 	if (!node)
@@ -190,6 +190,13 @@ private:
 	 */
 	void processScreenLineNode(xercesc::DOMElement* node);
 
+	/**
+	 * processes the supply_stats element in config xml
+	 *
+	 * @param node node corresponding to supply_stats element inside xml file
+	 */
+	void processSupplyStatsNode(xercesc::DOMElement* node);
+
 	/**
 	 * processes the region_restriction element in config xml
 	 *
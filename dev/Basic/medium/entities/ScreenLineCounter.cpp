@@ -32,7 +32,8 @@ namespace medium
 
 ScreenLineCounter* ScreenLineCounter::instance = nullptr;
 
-ScreenLineCounter::ScreenLineCounter() : simStartTime( ConfigManager::GetInstance().FullConfig().simStartTime())
+ScreenLineCounter::ScreenLineCounter() : numIntervals(0), localShard(&releaseShard), numModes(0),
+        simStartTime( ConfigManager::GetInstance().FullConfig().simStartTime())
 {
     const MT_Config& mtCfg = MT_Config::getInstance();
     if(mtCfg.screenLineParams.outputEnabled)
@@ -55,17 +56,21 @@ ScreenLineCounter::ScreenLineCounter() : simStartTime( ConfigManager::GetInstanc
         }
         timeIntervalMap[i] = interval;
     }
+    numIntervals = timeIntervalMap[86399] + 1;
 }
 
 ScreenLineCounter::~ScreenLineCounter()
 {
-    screenLineSegments.clear();
-    screenlineMap.clear();
+    for (std::vector<CountShard*>::iterator it = shards.begin(); it != shards.end(); it++)
+    {
+        delete *it;
+    }
 }
 
 void ScreenLineCounter::loadScreenLines()
 {
     screenLineSegments.clear();
+    screenLineSlots.clear();
 
     const ConfigParams& config = ConfigManager::GetInstance().FullConfig();
     const std::map<std::string, std::string>& storedProcMap = config.getDatabaseProcMappings().procedureMappings;
@@ -81,7 +86,15 @@ void ScreenLineCounter::loadScreenLines()
     soci::rowset<unsigned long>::const_iterator iter = rs.begin();
     for(; iter != rs.end(); iter++)
     {
-        screenLineSegments.insert(*iter);
+        screenLineSegments.push_back(*iter);
+    }
+
+    //slots in segment id order, so that the export is sorted by segment
+    std::sort(screenLineSegments.begin(), screenLineSegments.end());
+    screenLineSegments.erase(std::unique(screenLineSegments.begin(), screenLineSegments.end()), screenLineSegments.end());
+    for(unsigned int slot = 0; slot < screenLineSegments.size(); slot++)
+    {
+        screenLineSlots[screenLineSegments[slot]] = slot;
     }
 }
 
@@ -94,16 +107,72 @@ ScreenLineCounter* ScreenLineCounter::getInstance()
     return instance;
 }
 
-void ScreenLineCounter::updateScreenLineCount(unsigned int segId, double entryTimeSec, const std::string& travelMode)
+unsigned int ScreenLineCounter::getModeId(const std::string& travelMode)
+{
+    //modes are only ever appended, so the published ones can be searched without locking
+    unsigned int count = numModes.load(std::memory_order_acquire);
+    for(unsigned int id = 0; id < count; id++)
+    {
+        if(modeNames[id] == travelMode)
+        {
+            return id;
+        }
+    }
+
+    boost::unique_lock<boost::mutex> lock(modesMutex);
+    count = numModes.load(std::memory_order_relaxed);
+    for(unsigned int id = 0; id < count; id++)
+    {
+        if(modeNames[id] == travelMode)
+        {
+            return id;
+        }
+    }
+    if(count == MAX_MODES)
+    {
+        throw std::runtime_error("ScreenLineCounter: too many travel modes");
+    }
+    modeNames[count] = travelMode;
+    numModes.store(count + 1, std::memory_order_release);
+    return count;
+}
+
+ScreenLineCounter::CountShard& ScreenLineCounter::getShard()
+{
+    CountShard* shard = localShard.get();
+    if(!shard)
+    {
+        shard = new CountShard(numIntervals);
+        localShard.reset(shard);
+
+        boost::unique_lock<boost::mutex> lock(shardsMutex);
+        shards.push_back(shard);
+    }
+    return *shard;
+}
+
+void ScreenLineCounter::updateScreenLineCount(unsigned int segId, double entryTimeSec, unsigned int modeId)
 {
-    if(screenLineSegments.find(segId) == screenLineSegments.end())
+    boost::unordered_map<unsigned int, unsigned int>::const_iterator slotIt = screenLineSlots.find(segId);
+    if(slotIt == screenLineSlots.end())
     {
         return;
     }
     TimeInterval timeInterval = ScreenLineCounter::getTimeInterval(entryTimeSec);
+
+    std::vector<unsigned int>& counts = getShard()[timeInterval];
+    if(counts.empty())
+    {
+        counts.resize(screenLineSegments.size() * MAX_MODES, 0);
+    }
+    counts[slotIt->second * MAX_MODES + modeId]++; //increment count for the relevant time interval, segment and mode
+}
+
+void ScreenLineCounter::updateScreenLineCount(unsigned int segId, double entryTimeSec, const std::string& travelMode)
+{
+    if(screenLineSlots.find(segId) != screenLineSlots.end())
     {
-        boost::unique_lock<boost::mutex> lock(instanceMutex);
-        screenlineMap[timeInterval][segId][travelMode].count++; //increment count for the relevant time interval, segment and mode
+        updateScreenLineCount(segId, entryTimeSec, getModeId(travelMode));
     }
 }
 
@@ -124,24 +193,59 @@ void ScreenLineCounter::exportScreenLineCount() const
 
     sim_mob::BasicLogger& screenLineLogger  = sim_mob::Logger::log(fileName);
 
-    for(ScreenLineCountCollector::const_iterator travelTimeIter = screenlineMap.begin(); travelTimeIter != screenlineMap.end(); travelTimeIter++)
+    //modes are listed in name order within a segment
+    std::vector<std::pair<std::string, unsigned int> > modes;
+    for(unsigned int id = 0; id < numModes; id++)
+    {
+        modes.push_back(std::make_pair(modeNames[id], id));
+    }
+    std::sort(modes.begin(), modes.end());
+
+    std::vector<unsigned int> totals;
+    for(TimeInterval timeInterval = 0; timeInterval < numIntervals; timeInterval++)
     {
-        div_t divresult;
-        const TimeInterval& timeInterval = travelTimeIter->first;
+        //add up the counts of all threads
+        totals.clear();
+        for(std::vector<CountShard*>::const_iterator shardIt = shards.begin(); shardIt != shards.end(); shardIt++)
+        {
+            const std::vector<unsigned int>& counts = (**shardIt)[timeInterval];
+            if(counts.empty())
+            {
+                continue;
+            }
+            if(totals.empty())
+            {
+                totals = counts;
+            }
+            else
+            {
+                for(std::size_t i = 0; i < counts.size(); i++)
+                {
+                    totals[i] += counts[i];
+                }
+            }
+        }
+        if(totals.empty())
+        {
+            continue;
+        }
+
         const std::string& startTime = minTimes[timeInterval-1];
         const std::string& endTime = minTimes[timeInterval];
         std::string actualClockStartTime = (DailyTime(startTime) + simStartTime).getStrRepr();
         std::string actualClockEndTime = (DailyTime(endTime) + simStartTime).getStrRepr();
-        for(RoadSegmentCountMap::const_iterator segCountIt = travelTimeIter->second.begin();
-                segCountIt != travelTimeIter->second.end(); segCountIt++)
+        for(unsigned int slot = 0; slot < screenLineSegments.size(); slot++)
         {
-            for(CountMap::const_iterator countIter = segCountIt->second.begin();
-                    countIter != segCountIt->second.end(); countIter++)
+            for(std::vector<std::pair<std::string, unsigned int> >::const_iterator modeIt = modes.begin(); modeIt != modes.end(); modeIt++)
             {
-                screenLineLogger << segCountIt->first << "\t" <<
-                        actualClockStartTime<< "\t" << actualClockEndTime <<
-                    "\t" << countIter->first <<
-                    "\t" << countIter->second.count << "\n";
+                unsigned int count = totals[slot * MAX_MODES + modeIt->second];
+                if(count > 0)
+                {
+                    screenLineLogger << screenLineSegments[slot] << "\t" <<
+                            actualClockStartTime<< "\t" << actualClockEndTime <<
+                        "\t" << modeIt->first <<
+                        "\t" << count << "\n";
+                }
             }
         }
     }
@@ -7,8 +7,10 @@
 
 #pragma once
 
+#include <atomic>
 #include <boost/thread/mutex.hpp>
-#include <set>
+#include <boost/thread/tss.hpp>
+#include <boost/unordered_map.hpp>
 #include <string>
 #include <vector>
 #include "util/DailyTime.hpp"
@@ -18,10 +20,35 @@ namespace sim_mob
 namespace medium
 {
 
+/**
+ * Counts the vehicles entering screen line segments, per time interval and travel mode.
+ *
+ * Counts are kept in dense arrays indexed by (interval, screen line slot, mode id). Each worker thread increments its
+ * own shard without locking; the shards are added up when the counts are exported.
+ */
 class ScreenLineCounter {
 public:
     static ScreenLineCounter* getInstance();
 
+    /**
+     * Gets the id of a travel mode, registering the mode if it is new.
+     * Callers should keep the id rather than look it up at every segment entry.
+     *
+     * @param travelMode vehicle mode
+     *
+     * @return the mode id
+     */
+    unsigned int getModeId(const std::string& travelMode);
+
+    /**
+     * Update the count of vehicles passing through a screen line segment
+     *
+     * @param segId Road Segment id
+     * @param entryTimeSec time of entry (in seconds) into road segment
+     * @param modeId vehicle mode id, as returned by getModeId
+     */
+    void updateScreenLineCount(unsigned int segId, double entryTimeSec, unsigned int modeId);
+
     /**
      * Update the count of vehicles passing through a screen line segment
      *
@@ -33,32 +60,22 @@ public:
 
     /**
      * Export the screen line count to a file.
+     * Must not be called while the workers are updating the counts.
      */
     void exportScreenLineCount() const;
 
-private:
-    struct VehicleCount
-    {
-        unsigned int count;
-        VehicleCount() : count(0)
-        {
-        }
-    };
+    /** maximum number of distinct travel modes */
+    static const unsigned int MAX_MODES = 32;
 
+private:
     /** time interval */
     typedef unsigned int TimeInterval;
 
-    /** the heart of the final container holding accumulated mode-wise vehicle counts */
-    typedef std::map<std::string, VehicleCount> CountMap;
-
-    /** map of road segment id --> CountMap */
-    typedef std::map<unsigned int, CountMap> RoadSegmentCountMap;
-
     /**
-     * final container for collecting in simulation data:
-     * map[time interval][road segment id][travel mode]-->[number-of-vehicles]
+     * counts of one worker thread: [time interval][slot * MAX_MODES + mode id] --> number of vehicles.
+     * The counts of an interval are allocated when the first vehicle is counted in it.
      */
-    typedef std::map<TimeInterval, RoadSegmentCountMap> ScreenLineCountCollector;
+    typedef std::vector< std::vector<unsigned int> > CountShard;
 
     ScreenLineCounter();
     virtual ~ScreenLineCounter();
@@ -74,17 +91,39 @@ private:
     unsigned int getTimeInterval(const double time) const;
 
     /**
-     * container to store road segment travel times at different time intervals
+     * @return the counts of the calling thread
+     */
+    CountShard& getShard();
+
+    /** shards are owned by the counter, not by their thread */
+    static void releaseShard(CountShard*)
+    {
+    }
+
+    /**
+     * screen line segment id --> slot. Slots are numbered in increasing segment id order
      */
-    ScreenLineCountCollector screenlineMap;
+    boost::unordered_map<unsigned int, unsigned int> screenLineSlots;
 
     /**
-     * List of Screen Lines segment ids
+     * slot --> screen line segment id
      */
-    std::set<unsigned int> screenLineSegments;
+    std::vector<unsigned int> screenLineSegments;
+
+    /** number of time intervals in a day */
+    unsigned int numIntervals;
+
+    /** per-thread counts */
+    boost::thread_specific_ptr<CountShard> localShard;
+    std::vector<CountShard*> shards;
+    boost::mutex shardsMutex;
+
+    /** mode id --> travel mode */
+    std::string modeNames[MAX_MODES];
+    std::atomic<unsigned int> numModes;
+    boost::mutex modesMutex;
 
     static ScreenLineCounter* instance;
-    boost::mutex instanceMutex;
 
     unsigned int timeIntervalMap[86400] = {0};
     std::vector<std::string> minTimes;
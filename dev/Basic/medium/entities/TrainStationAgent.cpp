@@ -838,8 +838,9 @@ Entity::UpdateStatus TrainStationAgent::frame_tick(timeslice now)
             const Platform * alightingPlatform = endPoint.platform;
             std::string lineId = platform->getLineId();
             std::string stationNo = platform->getStationNo();
-            std::vector<Platform*> platforms = TrainController<sim_mob::medium::Person_MT>::getInstance()->getPlatforms(lineId,stationNo);
-            std::vector<Platform*>::iterator itr = std::find(platforms.begin(),platforms.end(),alightingPlatform);
+            TrainController<sim_mob::medium::Person_MT>* trainController = TrainController<sim_mob::medium::Person_MT>::getInstance();
+            TrainController<sim_mob::medium::Person_MT>::PlatformRange platforms = trainController->getPlatforms(trainController->getLineHandle(lineId), platform);
+            std::vector<Platform*>::const_iterator itr = std::find(platforms.begin(),platforms.end(),alightingPlatform);
             if(alightingPlatform == platform)
             {
                 it++;
@@ -6,6 +6,8 @@
  */
 
 #include "TravellerStatsManager.hpp"
+
+#include <algorithm>
 #include "conf/ConfigManager.hpp"
 #include "conf/ConfigParams.hpp"
 
@@ -22,7 +24,7 @@ TravellerStatsManager* TravellerStatsManager::getInstance()
     return instance;
 }
 
-TravellerStatsManager::TravellerStatsManager() {
+TravellerStatsManager::TravellerStatsManager() : numTimeIndices(0) {
 
 }
 
@@ -37,26 +39,37 @@ void TravellerStatsManager::loadHistoricalData()
     soci::session dbSession(soci::postgresql, dbStr);
     std::string query = "SELECT waitingnum, time_index, link_id  FROM supply.waitingtaxi_atlink;";
     soci::rowset<soci::row> rs = (dbSession.prepare << query);
+
+    //rows are (waiting number, time index, link slot) until all links and time indices are known
+    std::vector<unsigned int> rows;
+    linkSlots.clear();
+    numTimeIndices = 0;
     for (soci::rowset<soci::row>::const_iterator it = rs.begin(); it != rs.end(); ++it) {
         const soci::row& rowData = *it;
         unsigned int waitingNum = rowData.get<unsigned int>(0);
         unsigned int timeIndex = rowData.get<unsigned int>(1);
         unsigned int linkId = rowData.get<unsigned int>(2);
-        std::pair<unsigned int, unsigned int> index = std::make_pair(timeIndex, linkId);
-        historicalData[index] = waitingNum;
+        unsigned int slot = linkSlots.insert(std::make_pair(linkId, linkSlots.size())).first->second;
+        rows.push_back(waitingNum);
+        rows.push_back(timeIndex);
+        rows.push_back(slot);
+        numTimeIndices = std::max(numTimeIndices, timeIndex + 1);
+    }
+
+    historicalData.assign(numTimeIndices * linkSlots.size(), 0);
+    for (std::size_t i = 0; i < rows.size(); i += 3) {
+        historicalData[rows[i + 1] * linkSlots.size() + rows[i + 2]] = rows[i];
     }
 }
 
 int TravellerStatsManager::getWaitingNumber(unsigned int linkId, unsigned int currentTimeSec)
 {
-    int res = 0;
     unsigned int timeIndex = currentTimeSec / timeIntervalSec;
-    std::pair<unsigned int, unsigned int> index = std::make_pair(timeIndex, linkId);
-    auto it = historicalData.find(index);
-    if (it != historicalData.end()) {
-        res = it->second;
+    boost::unordered_map<unsigned int, unsigned int>::const_iterator it = linkSlots.find(linkId);
+    if (it == linkSlots.end() || timeIndex >= numTimeIndices) {
+        return 0;
     }
-    return res;
+    return historicalData[timeIndex * linkSlots.size() + it->second];
 }
 
 }
@@ -8,6 +8,8 @@
 #ifndef TRAVELLERSTATSMANAGER_HPP_
 #define TRAVELLERSTATSMANAGER_HPP_
 
+#include <vector>
+#include <boost/unordered_map.hpp>
 #include "geospatial/network/Link.hpp"
 
 namespace sim_mob
@@ -38,8 +40,12 @@ private:
     static TravellerStatsManager* instance;
     /**define time interval in seconds*/
     static const unsigned int timeIntervalSec = 600;
-    /**store historical data*/
-    std::map<std::pair<unsigned int, unsigned int>,unsigned int> historicalData;
+    /**link id --> slot of the link in historicalData*/
+    boost::unordered_map<unsigned int, unsigned int> linkSlots;
+    /**number of time intervals in historicalData*/
+    unsigned int numTimeIndices;
+    /**store historical data: [time index * number of links + link slot] --> waiting number*/
+    std::vector<unsigned int> historicalData;
 };
 
 }
@@ -21,6 +21,7 @@
 #include "entities/BusStopAgent.hpp"
 #include "entities/TaxiStandAgent.hpp"
 #include "entities/conflux/SegmentStats.hpp"
+#include "entities/conflux/SupplyStatsOutput.hpp"
 #include "entities/controllers/MobilityServiceControllerManager.hpp"
 #include "entities/Entity.hpp"
 #include "entities/misc/TripChain.hpp"
@@ -94,8 +95,7 @@ boost::mutex Conflux::activeAgentsLock;
 std::unordered_map<const Node *,Conflux *> Conflux::nodeConfluxMap;
 Conflux::Conflux(Node* confluxNode, const MutexStrategy& mtxStrat, int id, bool isLoader) :
         Agent(mtxStrat, id), confluxNode(confluxNode), parentWorkerAssigned(false), currFrame(0, 0), isLoader(isLoader), numUpdatesThisTick(0),
-        tickTimeInS(ConfigManager::GetInstance().FullConfig().baseGranSecond()), evadeVQ_Bounds(false), segStatsOutput(std::string()),
-        lnkStatsOutput(std::string())
+        tickTimeInS(ConfigManager::GetInstance().FullConfig().baseGranSecond()), evadeVQ_Bounds(false), statsOutputInterval(0)
 {
     nodeConfluxMap[confluxNode] = this;
 
@@ -409,7 +409,7 @@ UpdateStatus Conflux::update(timeslice frameNumber)
             resetPersonRemTimes(); //reset the remaining times of persons in lane infinity and VQ if required.
             processAgents(frameNumber); //process all agents in this conflux for this tick
 
-            if(segStatsOutput.length() > 0 || lnkStatsOutput.length() > 0)
+            if(!segStatsOutput.empty() || !lnkStatsOutput.empty())
             {
                 writeOutputs(); //write outputs from previous update interval (if any)
             }
@@ -1056,6 +1056,10 @@ void Conflux::updateAndReportSupplyStats(timeslice frameNumber)
     const ConfigManager& cfg = ConfigManager::GetInstance();
     bool outputEnabled = cfg.CMakeConfig().OutputEnabled();
     bool updateThisTick = ((frameNumber.frame() % updateInterval) == 0);
+    if (updateThisTick && outputEnabled)
+    {
+        statsOutputInterval = frameNumber.frame() / updateInterval;
+    }
     for (UpstreamSegmentStatsMap::iterator upstreamIt = upstreamSegStatsMap.begin(); upstreamIt != upstreamSegStatsMap.end(); upstreamIt++)
     {
         const SegmentStatsList& linkSegments = upstreamIt->second;
@@ -1065,7 +1069,7 @@ void Conflux::updateAndReportSupplyStats(timeslice frameNumber)
             SegmentStats* segStats = (*segIt);
             if (updateThisTick && outputEnabled)
             {
-                segStatsOutput.append(segStats->reportSegmentStats(frameNumber.frame() / updateInterval));
+                segStats->reportSegmentStats(segStatsOutput);
                 lnkTotalVehicleLength = lnkTotalVehicleLength + segStats->getTotalVehicleLength();
                 segStats->resetSegFlow();
             }
@@ -1078,7 +1082,7 @@ void Conflux::updateAndReportSupplyStats(timeslice frameNumber)
         {
             LinkStats& lnkStats = (linkStatsMap.find(upstreamIt->first))->second;
             lnkStats.computeLinkDensity(lnkTotalVehicleLength);
-            lnkStatsOutput.append(lnkStats.writeOutLinkStats(frameNumber.frame() / updateInterval));
+            lnkStats.writeOutLinkStats(lnkStatsOutput);
         }
     }
 
@@ -2097,6 +2101,9 @@ void Conflux::getAllPersonsUsingTopCMerge(std::deque<Person_MT*>& mergedPersonDe
     std::vector<PersonList> allPersonLists;
     int sumCapacity = 0;
 
+    //ties are broken with a stream of this conflux and tick, so the order does not depend on the worker running the conflux
+    RandomStream tieBreaker = RandomStream::forEntity(confluxNode->getNodeId(), currFrame.frame(), RandomStream::TOP_C_MERGE);
+
     //need to calculate the time to intersection for each vehicle.
     //basic test-case shows that this calculation is kind of costly.
     for (UpstreamSegmentStatsMap::iterator upStrmSegMapIt = upstreamSegStatsMap.begin(); upStrmSegMapIt != upstreamSegStatsMap.end(); upStrmSegMapIt++)
@@ -2116,17 +2123,17 @@ void Conflux::getAllPersonsUsingTopCMerge(std::deque<Person_MT*>& mergedPersonDe
             }
             segStats->updateLinkDrivingTimes(totalTimeToSegEnd);
             PersonList tmpAgents;
-            segStats->topCMergeLanesInSegment(tmpAgents);
+            segStats->topCMergeLanesInSegment(tmpAgents, tieBreaker);
             totalTimeToSegEnd += segStats->getLength() / speed;
             oneDeque.insert(oneDeque.end(), tmpAgents.begin(), tmpAgents.end());
         }
         allPersonLists.push_back(oneDeque);
     }
 
-    topCMergeDifferentLinksInConflux(mergedPersonDeque, allPersonLists, sumCapacity);
+    topCMergeDifferentLinksInConflux(mergedPersonDeque, allPersonLists, sumCapacity, tieBreaker);
 }
 
-void Conflux::topCMergeDifferentLinksInConflux(std::deque<Person_MT*>& mergedPersonDeque, std::vector<std::deque<Person_MT*> >& allPersonLists, int capacity)
+void Conflux::topCMergeDifferentLinksInConflux(std::deque<Person_MT*>& mergedPersonDeque, std::vector<std::deque<Person_MT*> >& allPersonLists, int capacity, RandomStream& tieBreaker)
 {
     std::vector<std::deque<Person_MT*>::iterator> iteratorLists;
 
@@ -2176,7 +2183,7 @@ void Conflux::topCMergeDifferentLinksInConflux(std::deque<Person_MT*>& mergedPer
             }
             else
             {
-                int chosenIdx = rand() % numElements;
+                int chosenIdx = tieBreaker.uniformInt(numElements);
                 chosenPair = equiTimeList[chosenIdx];
             }
             iteratorLists.at(chosenPair.first)++;
@@ -2482,16 +2489,21 @@ Conflux* sim_mob::medium::Conflux::getConflux(const RoadSegment* rdSeg)
 
 void sim_mob::medium::Conflux::writeOutputs()
 {
-    if(segStatsOutput.length() > 0)
+    SupplyStatsOutput& output = SupplyStatsOutput::getInstance();
+    if (output.isBinary())
     {
-        Log() << segStatsOutput;
-        segStatsOutput = std::string();
+        output.append(SupplyStatsOutput::SEGMENT_STATS, statsOutputInterval, segStatsOutput);
+        output.append(SupplyStatsOutput::LINK_STATS, statsOutputInterval, lnkStatsOutput);
     }
-    if(lnkStatsOutput.length() > 0)
+    else
     {
-        Log() << lnkStatsOutput;
-        lnkStatsOutput = std::string();
+        std::string text;
+        SupplyStatsOutput::format(SupplyStatsOutput::SEGMENT_STATS, statsOutputInterval, segStatsOutput, text);
+        SupplyStatsOutput::format(SupplyStatsOutput::LINK_STATS, statsOutputInterval, lnkStatsOutput, text);
+        Log() << text;
     }
+    segStatsOutput.clear();
+    lnkStatsOutput.clear();
 }
 
 void Conflux::insertIncident(SegmentStats* segStats, double newFlowRate)
@@ -2580,8 +2592,7 @@ void Conflux::driverStatistics(timeslice now)
     }
 
     std::stringstream logout;
-    std::string filename("driverstats.csv");
-    sim_mob::BasicLogger & movement = sim_mob::Logger::log(filename);
+    static sim_mob::BasicLogger & movement = sim_mob::Logger::log("driverstats.csv");
     std::map<int, int>::iterator it;
     for (it = statSegs.begin(); it != statSegs.end(); it++) {
         if (it->second > 0) {
@@ -205,14 +205,19 @@ static std::unordered_map<const Node *,Conflux *> nodeConfluxMap;
     bool evadeVQ_Bounds;
 
     /**
-     * temporary holder for outputs reported by segmentstats of this conflux at the end of each update interval
+     * temporary holder for records reported by segmentstats of this conflux at the end of each update interval
      */
-    std::string segStatsOutput;
+    std::vector<ColumnValue> segStatsOutput;
 
     /**
-     * temporary holder for outputs reported by linkstats of this conflux at the end of each update interval
+     * temporary holder for records reported by linkstats of this conflux at the end of each update interval
      */
-    std::string lnkStatsOutput;
+    std::vector<ColumnValue> lnkStatsOutput;
+
+    /**
+     * update interval of the records held in segStatsOutput and lnkStatsOutput
+     */
+    uint32_t statsOutputInterval;
 
     /**
      * updates agents in this conflux
@@ -620,9 +625,10 @@ public:
      * @param mergedPersonDeque output list that must contain the merged list of persons
      * @param allPersonLists list of list of persons to merge
      * @param capacity capacity till which the relative ordering of persons is important
+     * @param tieBreaker random stream used to order persons with equal driving times
      */
     void topCMergeDifferentLinksInConflux(std::deque<Person_MT*>& mergedPersonDeque,
-            std::vector< std::deque<Person_MT*> >& allPersonLists, int capacity);
+            std::vector< std::deque<Person_MT*> >& allPersonLists, int capacity, RandomStream& tieBreaker);
 
     /**
      * get number of persons in lane infinities of this conflux
@@ -146,24 +146,20 @@ void LinkStats::removeEntitiy(const Person_MT* person)
     }
 }
 
-std::string LinkStats::writeOutLinkStats(unsigned int updateNumber)
+void LinkStats::writeOutLinkStats(std::vector<ColumnValue>& values)
 {
-    char buf[200];
-    sprintf(buf, "lnk,%u,%u,%.3f,%.3f,%u,%u,%u,%u,%u,%u,%u\n",
-            updateNumber,
-            linkId,
-            linkLengthKm,
-            density,
-            entryCount,
-            exitCount,
-            carCount,
-            taxiCount,
-            motorcycleCount,
-            busCount,
-            otherVehiclesCount
-            );
+    //columns of SupplyStatsOutput::LINK_STATS
+    values.push_back(ColumnValue(linkId));
+    values.push_back(ColumnValue(linkLengthKm));
+    values.push_back(ColumnValue(density));
+    values.push_back(ColumnValue(entryCount));
+    values.push_back(ColumnValue(exitCount));
+    values.push_back(ColumnValue(carCount));
+    values.push_back(ColumnValue(taxiCount));
+    values.push_back(ColumnValue(motorcycleCount));
+    values.push_back(ColumnValue(busCount));
+    values.push_back(ColumnValue(otherVehiclesCount));
     resetStats();
-    return std::string(buf);
 }
 
 void LinkStats::computeLinkDensity(double vehicleLength)
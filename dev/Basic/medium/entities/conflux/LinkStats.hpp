@@ -4,6 +4,7 @@
 #include <set>
 #include <string>
 #include "SegmentStats.hpp"
+#include "util/ColumnarOutput.hpp"
 
 namespace sim_mob
 {
@@ -96,11 +97,11 @@ public:
 	void removeEntitiy(const Person_MT* entity);
 
 	/**
-	 * constructs an output string with all stats collected so far and resets
-	 * @param updateNumber update interval number at which the output was requested
-	 * @return constructed csv string with all stats. csv-format: lnk,interval,lnkId,length,density,entry,exit,car,taxi,motorcycle,bus,other
+	 * appends all stats collected so far as one record of SupplyStatsOutput::LINK_STATS and resets
+	 * @param values output; the columns of the record are appended to it.
+	 *        text format: lnk,interval,lnkId,length,density,entry,exit,car,taxi,motorcycle,bus,other
 	 */
-	std::string writeOutLinkStats(unsigned int updateNumber);
+	void writeOutLinkStats(std::vector<ColumnValue>& values);
 
 	/**
 	 * computes and sets link density
@@ -283,7 +283,7 @@ void SegmentStats::getInfinityPersons(std::deque<Person_MT*>& segAgents)
 	segAgents.insert(segAgents.end(), lnAgents.begin(), lnAgents.end());
 }
 
-void SegmentStats::topCMergeLanesInSegment(PersonList& mergedPersonList)
+void SegmentStats::topCMergeLanesInSegment(PersonList& mergedPersonList, RandomStream& tieBreaker)
 {
 	mergedPersonList.clear();
 	//Bus drivers go in the front of the list, because bus stops are (virtually) located at the end of the segment
@@ -365,7 +365,7 @@ void SegmentStats::topCMergeLanesInSegment(PersonList& mergedPersonList)
 			}
 			else
 			{
-				int chosenIdx = rand() % numElements;
+				int chosenIdx = tieBreaker.uniformInt(numElements);
 				chosenPair = equiDistantList[chosenIdx];
 			}
 			iteratorLists.at(chosenPair.first)++;
@@ -954,84 +954,26 @@ void SegmentStats::updateLaneParams(timeslice frameNumber)
 	}
 }
 
-std::string SegmentStats::reportSegmentStats(uint32_t frameNumber)
+void SegmentStats::reportSegmentStats(std::vector<ColumnValue>& values)
 {
 	if (ConfigManager::GetInstance().CMakeConfig().OutputEnabled())
 	{
-		char segStatBuf[100];
-		sprintf(segStatBuf, "seg,%u,%u,%u,%.2f,%u,%.2f,%u,%.2f,%u,%.2f,%u,%.2f,%d,%.2f\n",
-				frameNumber,
-				roadSegment->getRoadSegmentId(),
-				statsNumberInSegment,
-				speedDensityFunction((getTotalDensity(true)/METERS_IN_KM)),
-				segFlow,
-				getTotalDensity(true),
-				(numPersons - numAgentsInLane(laneInfinity)),
-				getTotalVehicleLength(),
-				numMovingInSegment(true),
-				getMovingLength(),
-				numQueuingInSegment(true),
-				getQueueLength(),
-				numVehicleLanes,
-				length,
-				getEnergy(),
-				getDistanceTraveled(),
-				getEnergyCounts()
-				);
+		//columns of SupplyStatsOutput::SEGMENT_STATS
+		values.push_back(ColumnValue(roadSegment->getRoadSegmentId()));
+		values.push_back(ColumnValue((unsigned int) statsNumberInSegment));
+		values.push_back(ColumnValue(speedDensityFunction((getTotalDensity(true)/METERS_IN_KM))));
+		values.push_back(ColumnValue(segFlow));
+		values.push_back(ColumnValue(getTotalDensity(true)));
+		values.push_back(ColumnValue(numPersons - numAgentsInLane(laneInfinity)));
+		values.push_back(ColumnValue(getTotalVehicleLength()));
+		values.push_back(ColumnValue(numMovingInSegment(true)));
+		values.push_back(ColumnValue(getMovingLength()));
+		values.push_back(ColumnValue(numQueuingInSegment(true)));
+		values.push_back(ColumnValue(getQueueLength()));
+		values.push_back(ColumnValue(numVehicleLanes));
+		values.push_back(ColumnValue(length));
 		resetEnergyStats(); //jo Apr9
-
-		//aa{
-//		if (MT_Config::getInstance().isEnergyModelEnabled() )
-//		{
-//			TripEnergyModel* energyModel = dynamic_cast<TripEnergyModel*> ( MT_Config::getInstance().getEnergyModel() );
-//			TripEnergySO_Model* energyModel = dynamic_cast<TripEnergySO_Model*> ( MT_Config::getInstance().getEnergyModel() );
-//			if (energyModel != nullptr)
-//			{
-				// The energy model in use is TripEnergySO_Model. For that, we print additional output
-//				sprintf(segStatBuf, "%ssegEnergy,%u,%u,%u,%.2f\n",
-//								segStatBuf,
-//								frameNumber,
-//								roadSegment->getRoadSegmentId(),
-//								statsNumberInSegment,
-//								getEnergy() );
-//
-//			}
-//		}
-		//aa}
-		if(getTotalDensity(true)>0)
-		{
-			int debug =1 ;
-		}
-		return std::string(segStatBuf);
-
 	}
-	else
-	{
-		return std::string();
-	}
-
-//	std::stringstream msg("");
-//	if (ConfigManager::GetInstance().CMakeConfig().OutputEnabled())
-//	{
-//		msg << "(\"segmentState\"" << ","
-//				<< frameNumber << ","
-//				<< roadSegment->getRoadSegmentId()
-//				<< ",{" << "\"speed\":\"" << segVehicleSpeed
-//				<< "\",\"flow\":\"" << segFlow
-//				<< "\",\"density\":\"" << getTotalDensity(true)
-//				<< "\",\"total\":\"" << (numPersons - numAgentsInLane(laneInfinity))
-//				<< "\",\"totalL\":\"" << getTotalVehicleLength()
-//				<< "\",\"moving\":\"" << numMovingInSegment(true)
-//				<< "\",\"movingL\":\"" << getMovingLength()
-//				<< "\",\"queue\":\"" << numQueuingInSegment(true)
-//				<< "\",\"queueL\":\"" << getQueueLength()
-//				<< "\",\"numVehicleLanes\":\"" << numVehicleLanes
-//				<< "\",\"segment_length\":\"" << length
-//				<< "\",\"segment_id\":\"" << roadSegment->getRoadSegmentId()
-//				<< "\",\"stats_num\":\"" << statsNumberInSegment << "\"})"
-//				<< "\n";
-//	}
-//	return msg.str();
 }
 
 bool SegmentStats::hasPersons() const
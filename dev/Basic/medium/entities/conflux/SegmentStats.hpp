@@ -13,6 +13,8 @@
 #include "geospatial/network/Link.hpp"
 #include "geospatial/network/PT_Stop.hpp"
 #include "geospatial/network/TaxiStand.hpp"
+#include "util/ColumnarOutput.hpp"
+#include "util/RandomStream.hpp"
 
 namespace sim_mob
 {
@@ -714,8 +716,9 @@ public:
 	 * merges the persons in segment in one list, thus forming the order in which
 	 * those persons need to be updated in this tick
 	 * @param mergedPersonList output list of persons to be populated
+	 * @param tieBreaker random stream used to order persons with equal driving times
 	 */
-	void topCMergeLanesInSegment(PersonList& mergedPersonList);
+	void topCMergeLanesInSegment(PersonList& mergedPersonList, RandomStream& tieBreaker);
 
 	/**
 	 * returns the queuing and moiving persons count in lane
@@ -876,11 +879,10 @@ public:
 	void updateLaneParams(timeslice frameNumber);
 
 	/**
-	 * report the statistics of this segment stats in string format
-	 * @param frameNumber the timeslice of current frame
-	 * @return the statistics of this segment stats in string format
+	 * report the statistics of this segment stats as one record of SupplyStatsOutput::SEGMENT_STATS
+	 * @param values output; the columns of the record are appended to it
 	 */
-	std::string reportSegmentStats(uint32_t frameNumber);
+	void reportSegmentStats(std::vector<ColumnValue>& values);
 
 	/**
 	 * computes the density of the moving part of the segment
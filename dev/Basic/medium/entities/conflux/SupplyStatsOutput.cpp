@@ -0,0 +1,101 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "SupplyStatsOutput.hpp"
+
+#include "config/MT_Config.hpp"
+
+using namespace sim_mob;
+using namespace sim_mob::medium;
+
+namespace
+{
+const std::vector<ColumnarSchema>& getSchemas()
+{
+    static const std::vector<ColumnarSchema> schemas = []()
+    {
+        std::vector<ColumnarSchema> tables(2);
+
+        //columns of SegmentStats::reportSegmentStats
+        tables[SupplyStatsOutput::SEGMENT_STATS].tag = "seg";
+        tables[SupplyStatsOutput::SEGMENT_STATS]
+                .add("segment_id", COLUMN_ID)
+                .add("stats_number", COLUMN_UINT32)
+                .add("speed", COLUMN_DOUBLE, 2)
+                .add("flow", COLUMN_UINT32)
+                .add("density", COLUMN_DOUBLE, 2)
+                .add("num_persons", COLUMN_UINT32)
+                .add("vehicle_length", COLUMN_DOUBLE, 2)
+                .add("num_moving", COLUMN_UINT32)
+                .add("moving_length", COLUMN_DOUBLE, 2)
+                .add("num_queuing", COLUMN_UINT32)
+                .add("queue_length", COLUMN_DOUBLE, 2)
+                .add("num_vehicle_lanes", COLUMN_INT32)
+                .add("length", COLUMN_DOUBLE, 2);
+
+        //columns of LinkStats::writeOutLinkStats
+        tables[SupplyStatsOutput::LINK_STATS].tag = "lnk";
+        tables[SupplyStatsOutput::LINK_STATS]
+                .add("link_id", COLUMN_ID)
+                .add("length_km", COLUMN_DOUBLE, 3)
+                .add("density", COLUMN_DOUBLE, 3)
+                .add("entry_count", COLUMN_UINT32)
+                .add("exit_count", COLUMN_UINT32)
+                .add("car_count", COLUMN_UINT32)
+                .add("taxi_count", COLUMN_UINT32)
+                .add("motorcycle_count", COLUMN_UINT32)
+                .add("bus_count", COLUMN_UINT32)
+                .add("other_vehicles_count", COLUMN_UINT32);
+        return tables;
+    }();
+    return schemas;
+}
+}
+
+SupplyStatsOutput& SupplyStatsOutput::getInstance()
+{
+    static SupplyStatsOutput instance;
+    return instance;
+}
+
+const ColumnarSchema& SupplyStatsOutput::getSchema(Table table)
+{
+    return getSchemas()[table];
+}
+
+SupplyStatsOutput::SupplyStatsOutput()
+{
+    const SupplyStatsParams& params = MT_Config::getInstance().supplyStatsParams;
+    if (params.binaryOutput)
+    {
+        writer.reset(new ColumnarWriter(params.fileName, getSchemas(), params.compress));
+    }
+}
+
+void SupplyStatsOutput::format(Table table, uint32_t interval, const std::vector<ColumnValue>& values, std::string& out)
+{
+    const ColumnarSchema& schema = getSchema(table);
+    for (std::size_t first = 0; first < values.size(); first += schema.columns.size())
+    {
+        formatColumnarRecord(schema, interval, &values[first], out);
+    }
+}
+
+bool SupplyStatsOutput::isBinary() const
+{
+    return (writer.get() != nullptr);
+}
+
+void SupplyStatsOutput::append(Table table, uint32_t interval, const std::vector<ColumnValue>& values)
+{
+    if (writer && !values.empty())
+    {
+        writer->append(table, interval, values);
+    }
+}
+
+void SupplyStatsOutput::close()
+{
+    writer.reset();
+}
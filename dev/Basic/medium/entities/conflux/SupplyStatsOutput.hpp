@@ -0,0 +1,77 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include "util/ColumnarOutput.hpp"
+
+namespace sim_mob
+{
+namespace medium
+{
+
+/**
+ * Destination of the segment ("seg") and link ("lnk") statistics reported by the confluxes at every update interval.
+ *
+ * By default the records are formatted as text lines which the confluxes write to their log, as they always did.
+ * With <supply_stats format="binary"/> in the mid-term config they are appended to a ColumnarWriter instead;
+ * the columnar-to-csv tool converts that file back to the same lines.
+ */
+class SupplyStatsOutput : private boost::noncopyable
+{
+public:
+    enum Table
+    {
+        SEGMENT_STATS = 0,
+        LINK_STATS
+    };
+
+    static SupplyStatsOutput& getInstance();
+
+    /**
+     * @return schema of the records of the given table. Reporters append exactly these columns, in this order.
+     */
+    static const ColumnarSchema& getSchema(Table table);
+
+    /**
+     * formats records as text lines
+     *
+     * @param table kind of records
+     * @param interval update interval of the records
+     * @param values records, one after the other
+     * @param out output; the lines are appended to it
+     */
+    static void format(Table table, uint32_t interval, const std::vector<ColumnValue>& values, std::string& out);
+
+    /**
+     * @return true if the records go to the binary output, false if they must be written as text
+     */
+    bool isBinary() const;
+
+    /**
+     * appends the records reported by one conflux for one update interval to the binary output. Thread-safe.
+     *
+     * @param table kind of records
+     * @param interval update interval of the records
+     * @param values records, one after the other
+     */
+    void append(Table table, uint32_t interval, const std::vector<ColumnValue>& values);
+
+    /**
+     * flushes and closes the binary output, if any. Must be called once the simulation is complete.
+     */
+    void close();
+
+private:
+    SupplyStatsOutput();
+
+    /**binary output; null for text output*/
+    boost::scoped_ptr<ColumnarWriter> writer;
+};
+
+}
+}
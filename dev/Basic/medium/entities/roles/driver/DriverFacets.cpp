@@ -1480,8 +1480,13 @@ void DriverMovement::updateScreenlineCounts(const SegmentStats* prevSegStat, dou
 	}
 	Person_MT *parent = parentDriver->parent;
 	const TripChainItem* tripChain = *(parent->currTripChainItem);
-	const std::string& travelMode = tripChain->getMode();
-	ScreenLineCounter::getInstance()->updateScreenLineCount(prevSegStat->getRoadSegment()->getRoadSegmentId(), segEnterExitTime, travelMode);
+	ScreenLineCounter* counter = ScreenLineCounter::getInstance();
+	if(tripChain != screenLineModeItem)
+	{
+		screenLineModeId = counter->getModeId(tripChain->getMode());
+		screenLineModeItem = tripChain;
+	}
+	counter->updateScreenLineCount(prevSegStat->getRoadSegment()->getRoadSegmentId(), segEnterExitTime, screenLineModeId);
 }
 
 void DriverMovement::updateTrafficSensor(double oldPos, double newPos, double speed, double acceleration)
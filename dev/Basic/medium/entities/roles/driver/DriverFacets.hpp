@@ -151,6 +151,12 @@ public:
 protected:
 	std::deque<double> speedCollector;
 	SegmentStats* prevSegStats = nullptr;
+
+	/** trip chain item whose travel mode is cached in screenLineModeId */
+	const TripChainItem* screenLineModeItem = nullptr;
+
+	/** ScreenLineCounter mode id of the travel mode of screenLineModeItem */
+	unsigned int screenLineModeId = 0;
 //	double totalEnergyUsed;
 	double totalDistanceDriven;
 	double totalTimeDriven;
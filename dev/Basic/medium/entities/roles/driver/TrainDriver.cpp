@@ -649,6 +649,9 @@ int TrainDriver::alightPassenger(std::list<Passenger*>& alightingPassenger,times
     }
 
     std::string lineId= platform->getLineId();
+	//platforms still ahead of the train; passengers heading to any other platform must alight here
+	TrainController<sim_mob::medium::Person_MT>* trainController = TrainController<sim_mob::medium::Person_MT>::getInstance();
+	TrainController<sim_mob::medium::Person_MT>::PlatformRange platforms = trainController->getPlatforms(trainController->getLineHandle(lineId), platform);
 	std::list<Passenger*>::iterator i = passengerList.begin();
 	std::string tm=(DailyTime(now.ms())+DailyTime(ConfigManager::GetInstance().FullConfig().simStartTime())).getStrRepr();
 	//log all the persons alighting
@@ -670,10 +673,8 @@ int TrainDriver::alightPassenger(std::list<Passenger*>& alightingPassenger,times
 			}
 			else
 			{
-				std::string stationNo = platform->getStationNo();
-				std::vector<Platform*> platforms=TrainController<sim_mob::medium::Person_MT>::getInstance()->getPlatforms(lineId,stationNo);
 				//check whether the platform is present from the ahead on the route from where the current platform of train is
-				std::vector<Platform*>::iterator itr=std::find(platforms.begin(),platforms.end(),endPoint.platform);
+				std::vector<Platform*>::const_iterator itr=std::find(platforms.begin(),platforms.end(),endPoint.platform);
 				if(itr == platforms.end())
 				{
 					//check if the platform where the passenger is supposed to alight is already crossed ,may be due to
@@ -288,15 +288,13 @@ void TrainMovement::changeTrip()
 	std::string lineId = parentDriver->getTrainLine();
 	Platform *platform = getNextPlatform();
 	TrainController<sim_mob::medium::Person_MT> *trainController = TrainController<sim_mob::medium::Person_MT>::getInstance();
-	std::string oppLineId = trainController->getOppositeLineId(lineId);
+	TrainController<sim_mob::medium::Person_MT>::LineHandle oppLine = trainController->getOppositeLine(trainController->getLineHandle(lineId));
+	const std::string& oppLineId = trainController->getLineId(oppLine);
 	TrainTrip *trip = dynamic_cast<TrainTrip *>(*(person->currTripChainItem));
 	trip->setLineId(oppLineId);
-	std::vector<Block *> route;
-	std::vector<Platform *> platforms;
-	trainController->getTrainRoute(oppLineId, route);
 	//this sets the blocks of the train
-	trip->setTrainRoute(route);
-	trainController->getTrainPlatforms(oppLineId, platforms);
+	trip->setTrainRoute(trainController->getBlocks(oppLine));
+	const std::vector<Platform *>& platforms = trainController->getTrainPlatforms(oppLine);
 	trip->setTrainPlatform(platforms);
 	trainPlatformMover.setPlatforms(platforms);
 	trainPlatformMover_accpos.setPlatforms(platforms);
@@ -1179,28 +1177,33 @@ bool TrainMovement::isUTurnPlatformOnTheWay()
 	TrainController<sim_mob::medium::Person_MT> *trainController = TrainController<sim_mob::medium::Person_MT>::getInstance();
 	std::map<std::string, std::vector<std::string>> uTurnPlatforms = trainController->getUturnPlatforms();
 	std::vector<std::string> uTurnPlatformList = uTurnPlatforms[line];
+	TrainController<sim_mob::medium::Person_MT>::LineHandle lineHandle = trainController->getLineHandle(line);
 	while (nextplatformPlt != nullptr)
 	{
-		std::string platformNo = nextplatformPlt->getPlatformNo();
-		if (trainController->isTerminalPlatform(platformNo, line))
+		if (trainController->isTerminalPlatform(lineHandle, nextplatformPlt))
 		{
 			return false;
 		}
 
-		TrainPlatform nextTrainplatformPlt = trainController->getNextPlatform(nextplatformPlt->getPlatformNo(), line);
+		Platform *followingPlatform = trainController->getNextPlatform(lineHandle, nextplatformPlt);
+		if (!followingPlatform)
+		{
+			return false;
+		}
+		const std::string& followingPlatformNo = followingPlatform->getPlatformNo();
 		if (std::find(uTurnPlatformList.begin(), uTurnPlatformList.end(),
-		              nextTrainplatformPlt.platformNo) != uTurnPlatformList.end())
+		              followingPlatformNo) != uTurnPlatformList.end())
 		{
 			std::map<std::string, std::vector<std::string>> disruptPlatformsMap = trainController->getInstance()->getDisruptedPlatforms_ServiceController();
 			std::vector<std::string> disruptPlatforms = disruptPlatformsMap[line];
 			std::string firstDisruptPlatform = disruptPlatforms[0];
-			if (boost::iequals(firstDisruptPlatform, nextTrainplatformPlt.platformNo))
+			if (boost::iequals(firstDisruptPlatform, followingPlatformNo))
 			{
 				return false;
 			}
 			else
 			{
-				if (trainController->isPlatformBeforeAnother(firstDisruptPlatform, nextTrainplatformPlt.platformNo,
+				if (trainController->isPlatformBeforeAnother(firstDisruptPlatform, followingPlatformNo,
 				                                             line) == true)
 				{
 					return false;
@@ -1208,7 +1211,7 @@ bool TrainMovement::isUTurnPlatformOnTheWay()
 			}
 			return true;
 		}
-		nextplatformPlt = trainController->getPlatformFromId(nextTrainplatformPlt.platformNo);
+		nextplatformPlt = followingPlatform;
 	}
 	return false;
 }
@@ -1222,23 +1225,20 @@ std::string TrainMovement::getNextUturnPlatform()
 	if (uTurnPlatforms.find(line) != uTurnPlatforms.end())
 	{
 		std::vector<std::string> uTurnPlatformList = uTurnPlatforms[line];
+		TrainController<sim_mob::medium::Person_MT>::LineHandle lineHandle = trainController->getLineHandle(line);
 		while (nextplatformPlt != nullptr)
 		{
-
-			std::string platformNo = nextplatformPlt->getPlatformNo();
 			if (std::find(uTurnPlatformList.begin(), uTurnPlatformList.end(),
 			              nextplatformPlt->getPlatformNo()) != uTurnPlatformList.end())
 			{
 				return nextplatformPlt->getPlatformNo();
 			}
 
-			if (trainController->isTerminalPlatform(platformNo, line))
+			if (trainController->isTerminalPlatform(lineHandle, nextplatformPlt))
 			{
 				return "";
 			}
-			TrainPlatform nextTrainplatformPlt = trainController->getNextPlatform(nextplatformPlt->getPlatformNo(),
-			                                                                      line);
-			nextplatformPlt = trainController->getPlatformFromId(nextTrainplatformPlt.platformNo);
+			nextplatformPlt = trainController->getNextPlatform(lineHandle, nextplatformPlt);
 		}
 	}
 	return "";
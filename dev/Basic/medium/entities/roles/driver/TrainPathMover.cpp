@@ -547,8 +547,8 @@ void TrainPathMover::teleportToOppositeLine(std::string station,std::string line
 
 double TrainPathMover::getDistanceFromStartToPlatform(std::string lineId,Platform *platform) const
 {
-    std::vector<Block*> route;
-    TrainController<sim_mob::medium::Person_MT>::getInstance()->getTrainRoute(lineId,route);
+    TrainController<sim_mob::medium::Person_MT>* trainController = TrainController<sim_mob::medium::Person_MT>::getInstance();
+    const std::vector<Block*>& route = trainController->getBlocks(trainController->getLineHandle(lineId));
     std::vector<Block*>::const_iterator tempIt = route.begin();
     double distance=0;
     double distanceToBlock;
@@ -47,6 +47,7 @@
 #include "entities/roles/driver/TrainDriver.hpp"
 #include "entities/roles/waitTaxiActivity/WaitTaxiActivity.hpp"
 #include "entities/ScreenLineCounter.hpp"
+#include "entities/conflux/SupplyStatsOutput.hpp"
 #include "entities/TaxiStandAgent.hpp"
 #include "geospatial/aimsun/Loader.hpp"
 #include "geospatial/network/RoadNetwork.hpp"
@@ -644,6 +645,9 @@ bool performMainSupply(const std::string& configFileName, std::list<std::string>
         screenLnCtr->exportScreenLineCount();
     }
 
+    //Close the binary segment/link statistics output, if any
+    SupplyStatsOutput::getInstance().close();
+
 	//At this point, it should be possible to delete all Signals and Agents.
     clear_delete_vector(Agent::all_agents);
 	while(!Agent::pending_agents.empty())
@@ -4,6 +4,7 @@
 
 #include "PredayLT_Logsum.hpp"
 
+#include <boost/bind.hpp>
 #include <boost/thread/thread.hpp>
 #include <boost/thread/tss.hpp>
 #include <vector>
@@ -217,12 +218,33 @@ const PredayLT_LogsumManager& sim_mob::PredayLT_LogsumManager::getInstance()
 
 		ltPopulationDao.getIncomeCategories(PersonParams::getIncomeCategoryLowerLimits());
 		ltPopulationDao.getAddresses();
+
+		//zones and costs were (re)loaded; nothing computed before this point is valid
+		logsumManager.logsumCache.invalidate();
 		logsumManager.dataLoadReqd = false;
 	}
 	return logsumManager;
 }
 
+PredayLT_LogsumCache& sim_mob::PredayLT_LogsumManager::getLogsumCache()
+{
+	return logsumManager.logsumCache;
+}
+
 PersonParams sim_mob::PredayLT_LogsumManager::computeLogsum(long individualId, int homeLocation, int workLocation, int vehicleOwnership, PersonParams *personParamsFromLT,const std::string& luaDir) const
+{
+	LT_LogsumKey key(individualId, homeLocation, workLocation, vehicleOwnership, luaDir);
+	if(!PredayLT_LogsumCache::makeKey(individualId, homeLocation, workLocation, vehicleOwnership, personParamsFromLT,
+			PredayLogsumLuaProvider::resolveDirectory(luaDir), key))
+	{
+		return computeLogsumUncached(individualId, homeLocation, workLocation, vehicleOwnership, personParamsFromLT, luaDir);
+	}
+
+	return logsumCache.findOrCompute(key, boost::bind(&PredayLT_LogsumManager::computeLogsumUncached, this, individualId,
+			homeLocation, workLocation, vehicleOwnership, personParamsFromLT, luaDir));
+}
+
+PersonParams sim_mob::PredayLT_LogsumManager::computeLogsumUncached(long individualId, int homeLocation, int workLocation, int vehicleOwnership, PersonParams *personParamsFromLT,const std::string& luaDir) const
 {
 	ensureContext();
 	PersonParams personParams;
@@ -7,6 +7,7 @@
 #include <boost/noncopyable.hpp>
 #include <boost/unordered_map.hpp>
 #include <vector>
+#include "PredayLT_LogsumCache.hpp"
 #include "params/PersonParams.hpp"
 #include "params/ZoneCostParams.hpp"
 
@@ -45,6 +46,11 @@ private:
 
     bool dataLoadReqd;
 
+    /**
+     * memoised results of computeLogsum
+     */
+    mutable PredayLT_LogsumCache logsumCache;
+
     PredayLT_LogsumManager();
 
     /**
@@ -57,6 +63,11 @@ private:
      */
     void loadCosts();
 
+    /**
+     * performs the logsum computation for computeLogsum without consulting the cache
+     */
+    PersonParams computeLogsumUncached(long individualId, int homeLocation, int workLocation, int vehicleOwnership, PersonParams *personParams, const std::string& luaDir) const;
+
 public:
     virtual ~PredayLT_LogsumManager();
 
@@ -71,8 +82,21 @@ public:
      * @param individualId id of individual
      * @param homeLocation TAZ code for home location of individual
      * @param workLocation TAZ code for work location of individual
+     * @param vehicleOwnership vehicle ownership option of the individual's household
+     * @param personParams person params constructed by the long-term model; the LT population db is used if null
+     * @param luaDir lua scripts variant to compute with
      * @return logsum value computed from day pattern binary (dpb.lua) model
+     *
+     * \note results are memoised on (individualId, homeLocation, workLocation, vehicleOwnership, luaDir), with an empty
+     *       luaDir resolved to the scripts loaded in the calling thread. Calls which supply personParams are also keyed on
+     *       the values of the params which the computation reads.
      */
     PersonParams computeLogsum(long individualId, int homeLocation=-1, int workLocation=-1, int vehicleOwnership =-1, PersonParams *personParams = nullptr, const std::string& luaDir = std::string()) const;
+
+    /**
+     * @return the memoisation table for computeLogsum. Invalidate it whenever zone costs or lua scripts change.
+     * \note this does not trigger loading of zones and costs
+     */
+    static PredayLT_LogsumCache& getLogsumCache();
 };
 }
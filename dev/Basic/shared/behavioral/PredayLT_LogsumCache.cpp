@@ -0,0 +1,277 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "PredayLT_LogsumCache.hpp"
+
+#include <algorithm>
+#include <boost/functional/hash.hpp>
+
+using namespace sim_mob;
+
+namespace
+{
+/**
+ * collects the person params read by the logsum computation: by computeLogsum itself, by the mode availability of
+ * the tour params and by the lua scripts. The vehicle ownership category is overwritten by computeLogsum, and the
+ * person id only matters when it is empty.
+ */
+boost::shared_ptr<const std::vector<double> > getPersonInputs(const PersonParams& personParams)
+{
+	std::vector<double>* inputs = new std::vector<double>();
+	inputs->push_back(personParams.getPersonId().empty());
+	inputs->push_back(personParams.getPersonTypeId());
+	inputs->push_back(personParams.getAgeId());
+	inputs->push_back(personParams.getIsUniversityStudent());
+	inputs->push_back(personParams.getIsFemale());
+	inputs->push_back(personParams.isStudent());
+	inputs->push_back(personParams.getIncomeId());
+	inputs->push_back(personParams.getMissingIncome());
+	inputs->push_back(personParams.getWorksAtHome());
+	inputs->push_back(personParams.getHasFixedWorkTiming());
+	inputs->push_back(personParams.getHomeLocation());
+	inputs->push_back(personParams.hasFixedWorkPlace());
+	inputs->push_back(personParams.getFixedWorkLocation());
+	inputs->push_back(personParams.getFixedSchoolLocation());
+	inputs->push_back(personParams.getHH_OnlyAdults());
+	inputs->push_back(personParams.getHH_OnlyWorkers());
+	inputs->push_back(personParams.getHH_NumUnder4());
+	inputs->push_back(personParams.getHH_HasUnder15());
+	inputs->push_back(personParams.hasDrivingLicence());
+	inputs->push_back(personParams.getCarLicense());
+	inputs->push_back(personParams.getMotorLicense());
+	inputs->push_back(personParams.getVanbusLicense());
+	inputs->push_back(personParams.getConstVehicleParams().getDrivetrain());
+	inputs->push_back(personParams.getDptLogsum());
+	inputs->push_back(personParams.getDpsLogsum());
+	inputs->push_back(personParams.getTravelProbability());
+	inputs->push_back(personParams.getTripsExpected());
+
+	//activity types without a logsum model keep the supplied logsum. Sorted, as the map is unordered
+	const std::unordered_map<StopType, double> logsums = personParams.getActivityLogsums();
+	std::vector<std::pair<StopType, double> > activityLogsums(logsums.begin(), logsums.end());
+	std::sort(activityLogsums.begin(), activityLogsums.end());
+	for(std::vector<std::pair<StopType, double> >::const_iterator it = activityLogsums.begin(); it != activityLogsums.end(); ++it)
+	{
+		inputs->push_back(it->first);
+		inputs->push_back(it->second);
+	}
+	return boost::shared_ptr<const std::vector<double> >(inputs);
+}
+}
+
+sim_mob::LT_LogsumKey::LT_LogsumKey(long individualId, int homeTaz, int workTaz, int vehicleOwnership, const std::string& luaScenario) :
+		individualId(individualId), homeTaz(homeTaz), workTaz(workTaz), vehicleOwnership(vehicleOwnership), luaScenario(luaScenario)
+{}
+
+bool sim_mob::LT_LogsumKey::operator==(const LT_LogsumKey& rhs) const
+{
+	if(!(individualId == rhs.individualId && homeTaz == rhs.homeTaz && workTaz == rhs.workTaz
+			&& vehicleOwnership == rhs.vehicleOwnership && luaScenario == rhs.luaScenario))
+	{
+		return false;
+	}
+	if(!personInputs || !rhs.personInputs)
+	{
+		return !personInputs && !rhs.personInputs;
+	}
+	return *personInputs == *rhs.personInputs;
+}
+
+std::size_t sim_mob::hash_value(const LT_LogsumKey& key)
+{
+	std::size_t seed = 0;
+	boost::hash_combine(seed, key.individualId);
+	boost::hash_combine(seed, key.homeTaz);
+	boost::hash_combine(seed, key.workTaz);
+	boost::hash_combine(seed, key.vehicleOwnership);
+	boost::hash_combine(seed, key.luaScenario);
+	if(key.personInputs)
+	{
+		boost::hash_range(seed, key.personInputs->begin(), key.personInputs->end());
+	}
+	return seed;
+}
+
+const std::size_t sim_mob::PredayLT_LogsumCache::DEFAULT_CAPACITY;
+const std::size_t sim_mob::PredayLT_LogsumCache::NUM_SHARDS;
+
+sim_mob::PredayLT_LogsumCache::PredayLT_LogsumCache(std::size_t capacity) :
+		shardCapacity(std::max<std::size_t>(1, capacity / NUM_SHARDS)), enabled(true), hits(0), misses(0), evictions(0), invalidations(0)
+{}
+
+sim_mob::PredayLT_LogsumCache::~PredayLT_LogsumCache()
+{}
+
+bool sim_mob::PredayLT_LogsumCache::makeKey(long individualId, int homeTaz, int workTaz, int vehicleOwnership, const PersonParams* personParams,
+		const std::string& resolvedLuaDir, LT_LogsumKey& key)
+{
+	if(resolvedLuaDir.empty())
+	{
+		return false;
+	}
+	key = LT_LogsumKey(individualId, homeTaz, workTaz, vehicleOwnership, resolvedLuaDir);
+	if(personParams)
+	{
+		key.personInputs = getPersonInputs(*personParams);
+	}
+	return true;
+}
+
+PredayLT_LogsumCache::Shard& sim_mob::PredayLT_LogsumCache::getShard(const LT_LogsumKey& key)
+{
+	//individual ids are dense, so spreading on them alone keeps all variants of one person in one shard
+	return shards[boost::hash<long>()(key.individualId) % NUM_SHARDS];
+}
+
+bool sim_mob::PredayLT_LogsumCache::find(const LT_LogsumKey& key, CachedParams& result)
+{
+	if(!enabled)
+	{
+		return false;
+	}
+
+	Shard& shard = getShard(key);
+	{
+		boost::mutex::scoped_lock lock(shard.mutex);
+		KeyToParams::iterator it = shard.entries.find(key);
+		if(it != shard.entries.end())
+		{
+			//move the key to the back of the usage list
+			shard.usage.splice(shard.usage.end(), shard.usage, it->second.second);
+			result = it->second.first;
+			++hits;
+			return true;
+		}
+	}
+	++misses;
+	return false;
+}
+
+PersonParams sim_mob::PredayLT_LogsumCache::findOrCompute(const LT_LogsumKey& key, const boost::function<PersonParams ()>& compute)
+{
+	CachedParams cached;
+	if(find(key, cached))
+	{
+		return *cached;
+	}
+
+	PersonParams personParams = compute();
+	insert(key, CachedParams(new PersonParams(personParams)));
+	return personParams;
+}
+
+void sim_mob::PredayLT_LogsumCache::insert(const LT_LogsumKey& key, const CachedParams& result)
+{
+	if(!enabled)
+	{
+		return;
+	}
+
+	Shard& shard = getShard(key);
+	boost::mutex::scoped_lock lock(shard.mutex);
+
+	//another thread may have computed the same key concurrently; keep the first result
+	if(shard.entries.find(key) != shard.entries.end())
+	{
+		return;
+	}
+
+	if(shard.entries.size() >= shardCapacity)
+	{
+		shard.entries.erase(shard.usage.front());
+		shard.usage.pop_front();
+		++evictions;
+	}
+
+	KeyTracker::iterator usageIt = shard.usage.insert(shard.usage.end(), key);
+	shard.entries.insert(std::make_pair(key, std::make_pair(result, usageIt)));
+}
+
+void sim_mob::PredayLT_LogsumCache::invalidate()
+{
+	for(std::size_t i = 0; i < NUM_SHARDS; i++)
+	{
+		boost::mutex::scoped_lock lock(shards[i].mutex);
+		shards[i].entries.clear();
+		shards[i].usage.clear();
+	}
+	++invalidations;
+}
+
+void sim_mob::PredayLT_LogsumCache::invalidate(const std::string& luaScenario)
+{
+	for(std::size_t i = 0; i < NUM_SHARDS; i++)
+	{
+		Shard& shard = shards[i];
+		boost::mutex::scoped_lock lock(shard.mutex);
+		for(KeyTracker::iterator it = shard.usage.begin(); it != shard.usage.end(); )
+		{
+			if(it->luaScenario == luaScenario)
+			{
+				shard.entries.erase(*it);
+				it = shard.usage.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+	++invalidations;
+}
+
+void sim_mob::PredayLT_LogsumCache::setEnabled(bool enabled)
+{
+	this->enabled = enabled;
+}
+
+bool sim_mob::PredayLT_LogsumCache::isEnabled() const
+{
+	return enabled;
+}
+
+unsigned long sim_mob::PredayLT_LogsumCache::getHits() const
+{
+	return hits;
+}
+
+unsigned long sim_mob::PredayLT_LogsumCache::getMisses() const
+{
+	return misses;
+}
+
+unsigned long sim_mob::PredayLT_LogsumCache::getEvictions() const
+{
+	return evictions;
+}
+
+unsigned long sim_mob::PredayLT_LogsumCache::getInvalidations() const
+{
+	return invalidations;
+}
+
+double sim_mob::PredayLT_LogsumCache::getHitRate() const
+{
+	unsigned long numHits = hits;
+	unsigned long lookups = numHits + misses;
+	return (lookups == 0) ? 0.0 : (double) numHits / lookups;
+}
+
+std::size_t sim_mob::PredayLT_LogsumCache::size() const
+{
+	std::size_t total = 0;
+	for(std::size_t i = 0; i < NUM_SHARDS; i++)
+	{
+		boost::mutex::scoped_lock lock(shards[i].mutex);
+		total += shards[i].entries.size();
+	}
+	return total;
+}
+
+void sim_mob::PredayLT_LogsumCache::resetStatistics()
+{
+	hits = 0;
+	misses = 0;
+	evictions = 0;
+}
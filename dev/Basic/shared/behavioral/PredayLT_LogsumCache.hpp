@@ -0,0 +1,174 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <string>
+#include <vector>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+#include "params/PersonParams.hpp"
+
+namespace sim_mob
+{
+/**
+ * Key identifying one long-term logsum computation.
+ *
+ * Two calls to PredayLT_LogsumManager::computeLogsum with equal keys run the same lua computation on the same inputs.
+ * When the long-term model supplies the person's parameters, the values the computation reads from them are part of
+ * the key (see makeKey).
+ */
+struct LT_LogsumKey
+{
+    LT_LogsumKey(long individualId, int homeTaz, int workTaz, int vehicleOwnership, const std::string& luaScenario);
+
+    bool operator==(const LT_LogsumKey& rhs) const;
+
+    long individualId;
+    int homeTaz;
+    int workTaz;
+    int vehicleOwnership;
+
+    /**
+     * lua script directory variant (TC, TCZero, TCPlusOne, CTPlusOne) the computation ran with.
+     * never empty: calls which use "the scripts loaded in the calling thread" are keyed on the variant that resolves to
+     */
+    std::string luaScenario;
+
+    /**
+     * values of the caller-supplied person params which the logsum computation reads, in a fixed order.
+     * null if the params are read from the LT population db. Shared between the copies of a key.
+     */
+    boost::shared_ptr<const std::vector<double> > personInputs;
+};
+
+std::size_t hash_value(const LT_LogsumKey& key);
+
+/**
+ * Thread-safe memoisation table for long-term logsums
+ *
+ * Entries are distributed over a fixed number of independently locked shards so that household agents logging
+ * their logsums from different workers rarely contend. Each shard is bounded and evicts its least recently used
+ * entries, because reuse happens almost exclusively among the calls made for one individual.
+ *
+ * The cache does not know when its inputs change. Callers must invalidate it whenever zone/cost data is reloaded
+ * or a lua scenario's scripts change.
+ */
+class PredayLT_LogsumCache : boost::noncopyable
+{
+public:
+    typedef boost::shared_ptr<const PersonParams> CachedParams;
+
+    /**
+     * @param capacity maximum number of logsum results retained across all shards
+     */
+    explicit PredayLT_LogsumCache(std::size_t capacity = DEFAULT_CAPACITY);
+    virtual ~PredayLT_LogsumCache();
+
+    /**
+     * builds the key of a computeLogsum call
+     * @param personParams person params supplied by the caller, or null if they are read from the LT population db
+     * @param resolvedLuaDir lua directory variant the call runs with (see PredayLogsumLuaProvider::resolveDirectory)
+     * @param key output; set if the call can be cached
+     * @return false if the call must not be cached, because the lua directory variant is unknown
+     *
+     * \note the key holds every person param read by computeLogsum and by the preday logsum lua bindings
+     *       (PredayLogsumLuaModel::mapClasses). Both must be kept in step with it.
+     */
+    static bool makeKey(long individualId, int homeTaz, int workTaz, int vehicleOwnership, const PersonParams* personParams,
+            const std::string& resolvedLuaDir, LT_LogsumKey& key);
+
+    /**
+     * looks up a previously computed result
+     * @param key computation key
+     * @param result output; set to the cached person params on a hit
+     * @return true if the key was found
+     */
+    bool find(const LT_LogsumKey& key, CachedParams& result);
+
+    /**
+     * looks up a previously computed result, or computes and records it
+     * @param key computation key
+     * @param compute performs the computation on a miss
+     * @return the cached or computed person params
+     */
+    PersonParams findOrCompute(const LT_LogsumKey& key, const boost::function<PersonParams ()>& compute);
+
+    /**
+     * records the result of a computation
+     * @param key computation key
+     * @param result person params returned by the computation
+     */
+    void insert(const LT_LogsumKey& key, const CachedParams& result);
+
+    /**
+     * drops all cached results. Must be called when zone or cost data change.
+     */
+    void invalidate();
+
+    /**
+     * drops all cached results computed with a given lua scenario. Must be called when that scenario's scripts change.
+     * @param luaScenario lua directory variant
+     */
+    void invalidate(const std::string& luaScenario);
+
+    /**
+     * enables or disables lookups and inserts. Disabling does not drop existing entries.
+     */
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    unsigned long getHits() const;
+    unsigned long getMisses() const;
+    unsigned long getEvictions() const;
+    unsigned long getInvalidations() const;
+
+    /**
+     * @return hits / (hits + misses), or 0 if no lookups were made
+     */
+    double getHitRate() const;
+
+    /**
+     * @return number of results currently cached
+     */
+    std::size_t size() const;
+
+    /**
+     * resets the hit/miss counters
+     */
+    void resetStatistics();
+
+    static const std::size_t DEFAULT_CAPACITY = 1 << 18;
+
+private:
+    static const std::size_t NUM_SHARDS = 32;
+
+    typedef std::list<LT_LogsumKey> KeyTracker;
+    typedef boost::unordered_map<LT_LogsumKey, std::pair<CachedParams, KeyTracker::iterator> > KeyToParams;
+
+    struct Shard
+    {
+        mutable boost::mutex mutex;
+        KeyToParams entries;
+        /**keys ordered from least to most recently used*/
+        KeyTracker usage;
+    };
+
+    Shard& getShard(const LT_LogsumKey& key);
+
+    Shard shards[NUM_SHARDS];
+    std::size_t shardCapacity;
+    std::atomic<bool> enabled;
+
+    std::atomic<unsigned long> hits;
+    std::atomic<unsigned long> misses;
+    std::atomic<unsigned long> evictions;
+    std::atomic<unsigned long> invalidations;
+};
+}
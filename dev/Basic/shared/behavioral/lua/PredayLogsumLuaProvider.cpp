@@ -10,6 +10,8 @@
 #include "PredayLogsumLuaProvider.hpp"
 #include <boost/thread/thread.hpp>
 #include <boost/thread/tss.hpp>
+#include <map>
+#include <stdexcept>
 
 #include "conf/ConfigManager.hpp"
 #include "conf/ConfigParams.hpp"
@@ -26,80 +28,120 @@ struct ModelContext
     PredayLogsumLuaModel predayModel;
 };
 
-boost::thread_specific_ptr<ModelContext> threadContext;
+/**
+ * lua models loaded by a thread, one per script directory variant
+ */
+struct ThreadModelContexts
+{
+    ThreadModelContexts() : current(nullptr)
+    {
+    }
+
+    ~ThreadModelContexts()
+    {
+        for (auto& item : models)
+        {
+            delete item.second;
+        }
+    }
+
+    std::map<std::string, ModelContext*> models;
+
+    /**the model returned for calls which do not name a known directory variant*/
+    ModelContext* current;
+
+    /**the directory variant of the current model*/
+    std::string currentDir;
+};
+
+boost::thread_specific_ptr<ThreadModelContexts> threadContext;
+
+const ModelScriptsMap* getScriptsMap(const std::string &luaDir)
+{
+    const ConfigParams& cfg = ConfigManager::GetInstance().FullConfig();
+    if(luaDir.compare("TC")==0)
+    {
+        return &cfg.luaScriptsMapTC;
+    }
+    else if(luaDir.compare("TCPlusOne")==0)
+    {
+        return &cfg.luaScriptsMapTimeCostPlusOne;
+    }
+    else if(luaDir.compare("CTPlusOne")==0)
+    {
+        return &cfg.luaScriptsMapCostTimePlusOne;
+    }
+    else if(luaDir.compare("TCZero")==0)
+    {
+        return &cfg.luaScriptsMapTCZeroCostConstants;
+    }
+    return nullptr;
+}
 
 void ensureContext(const std::string &luaDir)
 {
-    //note::the threadcontext is commented because now we load the preday model based on the given lua directory for each thread.
-    //if (!threadContext.get())
-    //{
-        try
+    if (!threadContext.get())
+    {
+        threadContext.reset(new ThreadModelContexts());
+    }
+    ThreadModelContexts* contexts = threadContext.get();
+
+    //each directory variant is loaded once per thread and kept for the lifetime of the thread.
+    //calls with an unknown (or empty) variant reuse the most recently requested model.
+    const ModelScriptsMap* extScripts = getScriptsMap(luaDir);
+    if (!extScripts)
+    {
+        if (!contexts->current)
         {
+            throw std::runtime_error("no preday logsum lua scripts loaded for directory '" + luaDir + "'");
+        }
+        return;
+    }
 
-            if(luaDir.compare("TC")==0)
-            {
-                const ModelScriptsMap& extScripts = ConfigManager::GetInstance().FullConfig().luaScriptsMapTC;
-                const std::string& scriptsPath = extScripts.getPath();
-                const std::map<std::string, std::string>& predayScriptsName = extScripts.getScriptsFileNameMap();
-                ModelContext* modelCtx = new ModelContext();
-                for (const auto& item : predayScriptsName)
-                {
-                    modelCtx->predayModel.loadFile(scriptsPath + item.second);
-                }
-                modelCtx->predayModel.initialize();
-                threadContext.reset(modelCtx);
-            }
-            else if(luaDir.compare("TCPlusOne")==0)
-            {
-                const ModelScriptsMap& extScripts = ConfigManager::GetInstance().FullConfig().luaScriptsMapTimeCostPlusOne;
-                const std::string& scriptsPath = extScripts.getPath();
-                const std::map<std::string, std::string>& predayScriptsName = extScripts.getScriptsFileNameMap();
-                ModelContext* modelCtx = new ModelContext();
-                for (const auto& item : predayScriptsName)
-                {
-                    modelCtx->predayModel.loadFile(scriptsPath + item.second);
-                }
-                modelCtx->predayModel.initialize();
-                threadContext.reset(modelCtx);
-            }
-            else if(luaDir.compare("CTPlusOne")==0)
-            {
-                const ModelScriptsMap& extScripts = ConfigManager::GetInstance().FullConfig().luaScriptsMapCostTimePlusOne;
-                const std::string& scriptsPath = extScripts.getPath();
-                const std::map<std::string, std::string>& predayScriptsName = extScripts.getScriptsFileNameMap();
-                ModelContext* modelCtx = new ModelContext();
-                for (const auto& item : predayScriptsName)
-                {
-                    modelCtx->predayModel.loadFile(scriptsPath + item.second);
-                }
-                modelCtx->predayModel.initialize();
-                threadContext.reset(modelCtx);
-            }
-            else if(luaDir.compare("TCZero")==0)
-            {
-                const ModelScriptsMap& extScripts = ConfigManager::GetInstance().FullConfig().luaScriptsMapTCZeroCostConstants;
-                const std::string& scriptsPath = extScripts.getPath();
-                const std::map<std::string, std::string>& predayScriptsName = extScripts.getScriptsFileNameMap();
-                ModelContext* modelCtx = new ModelContext();
-                for (const auto& item : predayScriptsName)
-                {
-                    modelCtx->predayModel.loadFile(scriptsPath + item.second);
-                }
-                modelCtx->predayModel.initialize();
-                threadContext.reset(modelCtx);
-            }
-
-        } 
-        catch (const std::out_of_range& oorx)
+    std::map<std::string, ModelContext*>::const_iterator modelIt = contexts->models.find(luaDir);
+    if (modelIt != contexts->models.end())
+    {
+        contexts->current = modelIt->second;
+        contexts->currentDir = luaDir;
+        return;
+    }
+
+    try
+    {
+        const std::string& scriptsPath = extScripts->getPath();
+        const std::map<std::string, std::string>& predayScriptsName = extScripts->getScriptsFileNameMap();
+        ModelContext* modelCtx = new ModelContext();
+        for (const auto& item : predayScriptsName)
         {
-            throw std::runtime_error("missing or invalid generic property 'external_scripts'");
+            modelCtx->predayModel.loadFile(scriptsPath + item.second);
         }
-    //}
+        modelCtx->predayModel.initialize();
+        contexts->models[luaDir] = modelCtx;
+        contexts->current = modelCtx;
+        contexts->currentDir = luaDir;
+    }
+    catch (const std::out_of_range& oorx)
+    {
+        throw std::runtime_error("missing or invalid generic property 'external_scripts'");
+    }
 }
 }
 
 const PredayLogsumLuaModel& PredayLogsumLuaProvider::getPredayModel(const std::string &luaDir)
 {
     ensureContext(luaDir);
-    return threadContext.get()->predayModel;
+    return threadContext.get()->current->predayModel;
+}
+
+std::string PredayLogsumLuaProvider::resolveDirectory(const std::string &luaDir)
+{
+    if (getScriptsMap(luaDir))
+    {
+        return luaDir;
+    }
+    if (threadContext.get() && threadContext.get()->current)
+    {
+        return threadContext.get()->currentDir;
+    }
+    return std::string();
 }
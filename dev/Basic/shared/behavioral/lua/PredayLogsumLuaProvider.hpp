@@ -1,5 +1,6 @@
 
 #pragma once
+#include <string>
 #include "behavioral/lua/PredayLogsumLuaModel.hpp"
 
 namespace sim_mob
@@ -21,6 +22,14 @@ public:
      * @return Lua preday model reference.
      */
     static const PredayLogsumLuaModel& getPredayModel(const std::string &luaDir);
+
+    /**
+     * Gets the directory variant whose model getPredayModel(luaDir) would return in the calling thread.
+     * Unknown (or empty) variants resolve to the model most recently requested by this thread.
+     *
+     * @return the directory variant, or an empty string if this thread has not loaded any model yet.
+     */
+    static std::string resolveDirectory(const std::string &luaDir);
 };
 }
 
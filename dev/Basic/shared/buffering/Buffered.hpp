@@ -73,6 +73,7 @@ public:
      */
     void set (const T& value) {
         next_ = value;
+        markDirty();
     }
 
 
@@ -5,22 +5,38 @@
 #include "BufferedDataManager.hpp"
 
 #include <cassert>
-#include <algorithm>
+#include <stdexcept>
 
 using namespace sim_mob;
 using std::vector;
 
+namespace {
+//Removes the datum at the given position of a list of data, moving the last one in its place.
+//Returns the moved datum, or null if it was the last one.
+BufferedBase* swapRemove(vector<BufferedBase*>& data, unsigned int slot)
+{
+    BufferedBase* moved = nullptr;
+    if (slot+1 < data.size()) {
+        moved = data.back();
+        data[slot] = moved;
+    }
+    data.pop_back();
+    return moved;
+}
+}
+
+const unsigned int sim_mob::BufferedBase::NO_SLOT;
 
 sim_mob::BufferedBase::~BufferedBase() {
-    assert(refCount==0);   //Error if refCount's not zero.
+    assert(manager==nullptr);   //Error if still managed.
 }
 
 
 sim_mob::BufferedDataManager::~BufferedDataManager()
 {
     //Stop managing all items
-    while (managedData.begin() != managedData.end()) {
-        stopManaging(*managedData.begin());
+    while (!managedData.empty()) {
+        stopManaging(managedData.back());
     }
 }
 
@@ -29,37 +45,55 @@ sim_mob::BufferedDataManager::~BufferedDataManager()
 void sim_mob::BufferedDataManager::beginManaging(BufferedBase* datum)
 {
     //Only add if we're not managing it already.
-    std::set<BufferedBase*>::iterator it = managedData.find(datum);
-    if (it==managedData.end()) {
-        managedData.insert(datum);
-
-        //Helps with debugging.
-        datum->refCount++;
+    if (datum->manager == this) {
+        return;
+    }
+    if (datum->manager) {
+        throw std::runtime_error("Buffered datum is already managed by another BufferedDataManager.");
     }
+
+    datum->manager = this;
+    datum->managedSlot = managedData.size();
+    managedData.push_back(datum);
+
+    //A value may have been set while the datum was not managed.
+    datum->markDirty();
 }
 
 void sim_mob::BufferedDataManager::stopManaging(BufferedBase* datum)
 {
     //Only remove if we are actually managing it.
-    std::set<BufferedBase*>::iterator it = managedData.find(datum);
-    if (it!=managedData.end()) {
-        managedData.erase(it);
+    if (datum->manager != this) {
+        return;
+    }
 
-        //Helps with debugging.
-        datum->refCount--;
+    BufferedBase* moved = swapRemove(managedData, datum->managedSlot);
+    if (moved) {
+        moved->managedSlot = datum->managedSlot;
     }
+
+    //A pending value is flipped by the next manager, if any.
+    if (datum->dirtySlot != BufferedBase::NO_SLOT) {
+        moved = swapRemove(dirtyData, datum->dirtySlot);
+        if (moved) {
+            moved->dirtySlot = datum->dirtySlot;
+        }
+        datum->dirtySlot = BufferedBase::NO_SLOT;
+    }
+
+    datum->manager = nullptr;
 }
 
-void sim_mob::BufferedDataManager::beginManaging(vector<BufferedBase*> data)
+void sim_mob::BufferedDataManager::beginManaging(const vector<BufferedBase*>& data)
 {
-    for (vector<sim_mob::BufferedBase*>::iterator it=data.begin(); it!=data.end(); it++) {
+    for (vector<sim_mob::BufferedBase*>::const_iterator it=data.begin(); it!=data.end(); it++) {
         beginManaging(*it);
     }
 }
 
-void sim_mob::BufferedDataManager::stopManaging(vector<BufferedBase*> data)
+void sim_mob::BufferedDataManager::stopManaging(const vector<BufferedBase*>& data)
 {
-    for (vector<sim_mob::BufferedBase*>::iterator it=data.begin(); it!=data.end(); it++) {
+    for (vector<sim_mob::BufferedBase*>::const_iterator it=data.begin(); it!=data.end(); it++) {
         stopManaging(*it);
     }
 }
@@ -67,9 +101,11 @@ void sim_mob::BufferedDataManager::stopManaging(vector<BufferedBase*> data)
 
 void sim_mob::BufferedDataManager::flip()
 {
-    for (std::set<BufferedBase*>::iterator it=managedData.begin(); it!=managedData.end(); it++) {
+    for (vector<BufferedBase*>::iterator it=dirtyData.begin(); it!=dirtyData.end(); it++) {
         (*it)->flip();
+        (*it)->dirtySlot = BufferedBase::NO_SLOT;
     }
+    dirtyData.clear();
 }
 
 
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <limits>
 #include <set>
 #include <vector>
 #include <boost/noncopyable.hpp>
@@ -26,7 +27,10 @@ class BufferedDataManager;
  * non-templatized pointers and perform "flip" operations on them.
  *
  * A BufferedBase must be associate with a BufferedDataManager; otherwise, its current value will never
- * be updated.
+ * be updated. It can be managed by one BufferedDataManager at a time.
+ *
+ * Sub-classes must call markDirty() whenever they change the next value; only data marked this way
+ * are flipped.
  *
  * \note
  * This class is non-copyable; it is not clear semantically what happens when a Buffered data
@@ -41,7 +45,7 @@ class BufferedDataManager;
 class BufferedBase : private boost::noncopyable
 {
 protected:
-    BufferedBase() : refCount(0) {}
+    BufferedBase() : manager(nullptr), managedSlot(0), dirtySlot(NO_SLOT) {}
     virtual ~BufferedBase();
 
     /**
@@ -51,13 +55,27 @@ protected:
      */
     virtual void flip() = 0;
 
+    /**
+     * Records that the next value was changed, so that the next flip of the managing BufferedDataManager
+     * updates this datum. Cheap when called repeatedly within a time tick.
+     */
+    void markDirty();
+
     //Allow access to protected methods by BufferedDataManager.
     friend class BufferedDataManager;
 
 private:
-    ///Count of BufferedDataManagers accessing this Buffered type.
+    static const unsigned int NO_SLOT = std::numeric_limits<unsigned int>::max();
+
+    ///The BufferedDataManager managing this datum, if any.
     ///Helps catch harder-to-debug errors further down the line.
-    unsigned int refCount;
+    BufferedDataManager* manager;
+
+    ///Position of this datum in its manager's list of data.
+    unsigned int managedSlot;
+
+    ///Position of this datum in its manager's list of data to flip, or NO_SLOT if it was not changed since the last flip.
+    unsigned int dirtySlot;
 };
 
 
@@ -66,6 +84,11 @@ private:
  * updates their current values each time flip() is called. Calling flip() multiple times
  * in a row (without calling each datum's "set()" method in between) has undefined behavior.
  *
+ * Data record themselves in the list of changed data of their manager when set, so a flip only
+ * visits the data which were changed during the time tick. Each Worker is a manager and flips its own
+ * data in parallel with the other Workers; since a datum is only written by the Agent owning it, and that
+ * Agent is on the Worker managing it, the list of changed data is only accessed by that Worker's thread.
+ *
  * \todo
  * It seems sensible to have beginManaging() add the datum to a static array of raw "data", using
  * the "size" of the buffered type. The next_ and current_ values can then be represented by two
@@ -89,17 +112,31 @@ public:
     void stopManaging(BufferedBase* datum);
 
     //For multiple items
-    void beginManaging(std::vector<BufferedBase*> data);
-    void stopManaging(std::vector<BufferedBase*> data);
+    void beginManaging(const std::vector<BufferedBase*>& data);
+    void stopManaging(const std::vector<BufferedBase*>& data);
 
-    ///Flip (update the current value of) all buffered data items under your control.
+    ///Flip (update the current value of) all buffered data items under your control which were changed.
     void flip();
 
 
 protected:
-    std::set<BufferedBase*> managedData;
+    std::vector<BufferedBase*> managedData;
+
+    ///Managed data changed since the last flip.
+    std::vector<BufferedBase*> dirtyData;
+
+    friend class BufferedBase;
 };
 
 
+inline void BufferedBase::markDirty()
+{
+    if (manager && dirtySlot == NO_SLOT) {
+        dirtySlot = manager->dirtyData.size();
+        manager->dirtyData.push_back(this);
+    }
+}
+
+
 }
 
@@ -41,6 +41,7 @@ public:
     void operator++()
     {
         ++next_;
+        markDirty();
     }
 
     /**
@@ -52,6 +53,7 @@ public:
     void operator++(int)
     {
         ++next_;
+        markDirty();
     }
 
     /**
@@ -63,6 +65,7 @@ public:
     void operator--()
     {
         --next_;
+        markDirty();
     }
 
     /**
@@ -74,6 +77,7 @@ public:
     void operator--(int)
     {
         --next_;
+        markDirty();
     }
 
     /**
@@ -85,6 +89,7 @@ public:
     void operator+=(int delta)
     {
         next_ += delta;
+        markDirty();
     }
 
     /**
@@ -96,6 +101,7 @@ public:
     void operator-=(int delta)
     {
         next_ -= delta;
+        markDirty();
     }
 };
 
@@ -113,6 +113,9 @@ public:
             next_ = value;
         }*/
         next_ = value;
+        if (strategy_==MtxStrat_Buffered) {
+            markDirty();
+        }
     }
 
 
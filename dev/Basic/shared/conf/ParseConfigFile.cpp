@@ -43,6 +43,34 @@ WorkGroup::ASSIGNMENT_STRATEGY ParseWrkGrpAssignEnum(const XMLCh *srcX, WorkGrou
 	return defValue;
 }
 
+EntityList::Ordering ParseEntityOrderingEnum(const XMLCh *srcX, EntityList::Ordering defValue)
+{
+	if (srcX)
+	{
+		string src = TranscodeString(srcX);
+
+		if (src == "none")
+		{
+			return EntityList::ORDER_NONE;
+		}
+		else if (src == "id")
+		{
+			return EntityList::ORDER_ID;
+		}
+		else if (src == "type")
+		{
+			return EntityList::ORDER_TYPE;
+		}
+
+		stringstream msg;
+		msg << "Invalid value for \'entity_order\': \"" << src
+		    << "\". Expected: \"none\", \"id\" or \"type\"";
+		throw runtime_error(msg.str());
+	}
+
+	return defValue;
+}
+
 MutexStrategy ParseMutexStrategyEnum(const XMLCh *srcX, MutexStrategy defValue)
 {
 	if (srcX)
@@ -332,6 +360,7 @@ void ParseConfigFile::processLongTermParamsNode(xercesc::DOMElement *node)
 	processDeveloperModelNode(GetSingleElementByName(node, "developerModel"));
 	processHousingModelNode(GetSingleElementByName(node, "housingModel"));
 	processHouseHoldLogsumsNode(GetSingleElementByName(node, "outputHouseholdLogsums"));
+	processLogsumPrecomputationNode(GetSingleElementByName(node, "logsumPrecomputation"));
 	processVehicleOwnershipModelNode(GetSingleElementByName(node, "vehicleOwnershipModel"));
 
 	LongTermParams::TaxiAccessModel taxiAccessModel;
@@ -577,6 +606,31 @@ void ParseConfigFile::processHouseHoldLogsumsNode(xercesc::DOMElement *outHHLogs
 	cfg.ltParams.outputHouseholdLogsums = outputHouseholdLogsums;
 }
 
+void ParseConfigFile::processLogsumPrecomputationNode(xercesc::DOMElement *logsumPrecomputationNode)
+{
+	LongTermParams::LogsumPrecomputation logsumPrecomputation;
+
+	//optional element; keep the defaults (disabled) if absent
+	if (!logsumPrecomputationNode)
+	{
+		cfg.ltParams.logsumPrecomputation = logsumPrecomputation;
+		return;
+	}
+
+	logsumPrecomputation.enabled =
+			ParseBoolean(GetNamedAttributeValue(logsumPrecomputationNode, "enabled"), false);
+
+	logsumPrecomputation.threads =
+			ParseUnsignedInt(GetNamedAttributeValue(GetSingleElementByName(
+					logsumPrecomputationNode, "threads"), "value"), (unsigned int) 0);
+
+	logsumPrecomputation.persistResults =
+			ParseBoolean(GetNamedAttributeValue(GetSingleElementByName(
+					logsumPrecomputationNode, "persistResults"), "value"), false);
+
+	cfg.ltParams.logsumPrecomputation = logsumPrecomputation;
+}
+
 void ParseConfigFile::processHousingModelNode(xercesc::DOMElement *houseModel)
 {
 	LongTermParams::HousingModel housingModel;
@@ -765,6 +819,7 @@ void ParseConfigFile::processSimulationNode(xercesc::DOMElement *node)
 			processInSimulationTTUsage(GetSingleElementByName(node, "in_simulation_travel_time_usage", true));
 
 	processWorkgroupAssignmentNode(GetSingleElementByName(node, "workgroup_assignment"));
+	processEntityOrderNode(GetSingleElementByName(node, "entity_order"));
 	processOperationalCostNode(GetSingleElementByName(node, "operational_cost")) ;
 	processMutexEnforcementNode(GetSingleElementByName(node, "mutex_enforcement"));
 	processClosedLoopPropertiesNode(GetSingleElementByName(node, "closed_loop"));
@@ -826,6 +881,11 @@ void ParseConfigFile::processWorkgroupAssignmentNode(xercesc::DOMElement *node)
 	                                                                  WorkGroup::ASSIGN_SMALLEST);
 }
 
+void ParseConfigFile::processEntityOrderNode(xercesc::DOMElement *node)
+{
+	cfg.simulation.entityOrdering = ParseEntityOrderingEnum(GetNamedAttributeValue(node, "value"), EntityList::ORDER_NONE);
+}
+
 void ParseConfigFile::processOperationalCostNode(xercesc::DOMElement *node)
 {
 	// default value for operational cost: 0.147 dollars/km taken from Siyu's thesis
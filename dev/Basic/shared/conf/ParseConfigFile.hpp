@@ -92,6 +92,12 @@ private:
 	 */
 	void processHouseHoldLogsumsNode(DOMElement *node);
 
+	/**
+	 * Processes the logsumPrecomputation element in the config file
+	 * @param node node corresponding to the logsumPrecomputation element in the xml file
+	 */
+	void processLogsumPrecomputationNode(DOMElement *node);
+
 	/**
 	 * Processes the vehicleOwnershipModel element in the config file
 	 * @param node node corresponding to the vehicleOwnershipModel element in the xml file
@@ -147,6 +153,13 @@ private:
 	 */
 	void processWorkgroupAssignmentNode(xercesc::DOMElement *node);
 
+	/**
+	 * Processes the entity_order element in the config file
+	 *
+	 * @param node node correspoding to the entity_order element in the xml file
+	 */
+	void processEntityOrderNode(xercesc::DOMElement *node);
+
 	/**
 	 * Processes the operational cost in the config file
 	 *
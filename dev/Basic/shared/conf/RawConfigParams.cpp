@@ -12,7 +12,7 @@ sim_mob::RawConfigParams::RawConfigParams() : mergeLogFiles(false), generateBusR
 
 sim_mob::SimulationParams::SimulationParams() :
     baseGranMS(0), baseGranSecond(0), totalRuntimeMS(0), totalWarmupMS(0), inSimulationTTUsage(0),
-    workGroupAssigmentStrategy(WorkGroup::ASSIGN_ROUNDROBIN), startingAutoAgentID(0), operationalCostICE(0), operationalCostHEV(0), operationalCostBEV(0),
+    workGroupAssigmentStrategy(WorkGroup::ASSIGN_ROUNDROBIN), entityOrdering(EntityList::ORDER_NONE), startingAutoAgentID(0), operationalCostICE(0), operationalCostHEV(0), operationalCostBEV(0),
     mutexStategy(MtxStrat_Buffered)
 {}
 
@@ -39,6 +39,8 @@ sim_mob::LongTermParams::HousingModel::HedonicPriceModel::HedonicPriceModel(): a
 
 sim_mob::LongTermParams::OutputHouseholdLogsums::OutputHouseholdLogsums():enabled(false), fixedHomeVariableWork(false), fixedWorkVariableHome(false), vehicleOwnership(false), hitsRun(false), maxcCost(false), maxTime(false){}
 
+sim_mob::LongTermParams::LogsumPrecomputation::LogsumPrecomputation():enabled(false), threads(0), persistResults(false){}
+
 sim_mob::LongTermParams::VehicleOwnershipModel::VehicleOwnershipModel():enabled(false), vehicleBuyingWaitingTimeInDays(0){}
 sim_mob::LongTermParams::TaxiAccessModel::TaxiAccessModel():enabled(false){}
 sim_mob::LongTermParams::SchoolAssignmentModel::SchoolAssignmentModel():enabled(false), schoolChangeWaitingTimeInDays(0){}
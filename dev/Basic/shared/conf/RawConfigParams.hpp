@@ -15,6 +15,7 @@
 #include "conf/Constructs.hpp"
 #include "entities/controllers/MobilityServiceControllerManager.hpp"
 #include "geospatial/network/Point.hpp"
+#include "workers/EntityList.hpp"
 #include "workers/WorkGroup.hpp"
 #include "util/DailyTime.hpp"
 #include "util/Profiler.hpp"
@@ -134,6 +135,14 @@ struct LongTermParams
 		bool maxTime;
 	} outputHouseholdLogsums;
 
+	struct LogsumPrecomputation
+	{
+		LogsumPrecomputation();
+		bool enabled;
+		unsigned int threads; //number of threads computing logsums; 0 uses the number of long-term workers
+		bool persistResults;  //save the computed logsums to disk and reuse them on the next start
+	} logsumPrecomputation;
+
 	struct VehicleOwnershipModel{
 		VehicleOwnershipModel();
 		bool enabled;
@@ -352,6 +361,9 @@ public:
     /// Defautl assignment strategy for Workgroups.
     WorkGroup::ASSIGNMENT_STRATEGY workGroupAssigmentStrategy;
 
+    /// Order in which each Worker updates its entities.
+    EntityList::Ordering entityOrdering;
+
     /// Default starting ID for agents with auto-generated IDs.
     int startingAutoAgentID;
 
@@ -1,26 +1,140 @@
 #include "PG_BulkInserter.hpp"
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <unistd.h>
+#include <boost/bind.hpp>
+#include <boost/functional/hash.hpp>
+
 #include "logging/Log.hpp"
 
 using namespace sim_mob;
 
-PG_BulkInserter::PG_BulkInserter(const int numInsertsPerQuery) : numInsertsPerQuery(numInsertsPerQuery), query("")
+namespace
 {
 
+//Appends a field in the text format of COPY, with ',' as delimiter
+void appendField(std::string& out, const std::string& field)
+{
+    for (std::string::const_iterator it = field.begin(); it != field.end(); ++it)
+    {
+        switch (*it)
+        {
+        case '\\': out.append("\\\\"); break;
+        case ',': out.append("\\,"); break;
+        case '\n': out.append("\\n"); break;
+        case '\r': out.append("\\r"); break;
+        default: out.push_back(*it);
+        }
+    }
 }
 
-PG_BulkInserter::~PG_BulkInserter()
+//The first column of a line in the text format of COPY
+std::string firstColumn(const std::string& line)
 {
-    delete inputFile;
+    std::string::size_type pos = 0;
+    while (pos < line.size() && line[pos] != ',')
+    {
+        //Skip escaped characters
+        pos += (line[pos] == '\\') ? 2 : 1;
+    }
+    return line.substr(0, pos);
 }
 
-bool PG_BulkInserter::connect(const std::string &connectionStr)
+}
+
+PG_CopySink::PG_CopySink() : connection(nullptr), twoPhase(false)
 {
-    bool retVal = true;
+}
+
+PG_CopySink::~PG_CopySink()
+{
+    if (connection)
+    {
+        PQfinish(connection);
+    }
+}
 
+bool PG_CopySink::connect(const std::string& connectionStr, bool twoPhase)
+{
     connection = PQconnectdb(connectionStr.c_str());
 
-    if(PQstatus(connection) != CONNECTION_OK)
+    if (PQstatus(connection) != CONNECTION_OK)
+    {
+        Print() << PQerrorMessage(connection);
+        return false;
+    }
+
+    this->twoPhase = false;
+    if (twoPhase)
+    {
+        PGresult* res = PQexec(connection, "SHOW max_prepared_transactions");
+        this->twoPhase = (PQresultStatus(res) == PGRES_TUPLES_OK && PQntuples(res) == 1 && std::atoi(PQgetvalue(res, 0, 0)) > 0);
+        PQclear(res);
+    }
+    return true;
+}
+
+bool PG_CopySink::exec(const std::string& command, const char* expectedStatus)
+{
+    PGresult* res = PQexec(connection, command.c_str());
+    bool retVal = (PQresultStatus(res) == PGRES_COMMAND_OK);
+
+    //COMMIT and PREPARE TRANSACTION of an aborted transaction succeed, as a ROLLBACK
+    if (retVal && expectedStatus && std::strcmp(PQcmdStatus(res), expectedStatus) != 0)
+    {
+        Print() << "PG_BulkInserter: " << command << " ended as " << PQcmdStatus(res) << "\n";
+        retVal = false;
+    }
+    else if (!retVal)
+    {
+        Print() << "PG_BulkInserter: " << command << " failed: " << PQerrorMessage(connection);
+    }
+    PQclear(res);
+    return retVal;
+}
+
+bool PG_CopySink::begin()
+{
+    return exec("BEGIN");
+}
+
+bool PG_CopySink::copy(const std::string& query, const std::string& rows)
+{
+    bool retVal = true;
+
+    PGresult* res = PQexec(connection, query.c_str());
+
+    if (PQresultStatus(res) != PGRES_COPY_IN)
+    {
+        Print() << "PG_BulkInserter: Copy Failed\n";
+        PQclear(res);
+        return false;
+    }
+    PQclear(res);
+
+    if (PQputCopyData(connection, rows.data(), rows.size()) != 1)
+    {
+        Print() << PQerrorMessage(connection);
+        retVal = false;
+    }
+
+    if (PQputCopyEnd(connection, retVal ? NULL : "PG_BulkInserter: failed to send rows") == 1)
+    {
+        while ((res = PQgetResult(connection)))
+        {
+            if (PQresultStatus(res) != PGRES_COMMAND_OK)
+            {
+                Print() << PQerrorMessage(connection);
+                retVal = false;
+            }
+            PQclear(res);
+        }
+    }
+    else
     {
         Print() << PQerrorMessage(connection);
         retVal = false;
@@ -29,6 +143,157 @@ bool PG_BulkInserter::connect(const std::string &connectionStr)
     return retVal;
 }
 
+bool PG_CopySink::prepare(const std::string& transactionId)
+{
+    if (!twoPhase)
+    {
+        return true;
+    }
+    if (!exec("PREPARE TRANSACTION '" + transactionId + "'", "PREPARE TRANSACTION"))
+    {
+        return false;
+    }
+    preparedId = transactionId;
+    return true;
+}
+
+bool PG_CopySink::commit()
+{
+    if (preparedId.empty())
+    {
+        return exec("COMMIT", "COMMIT");
+    }
+
+    //On failure the transaction stays prepared on the server
+    if (!exec("COMMIT PREPARED '" + preparedId + "'", "COMMIT PREPARED"))
+    {
+        return false;
+    }
+    preparedId.clear();
+    return true;
+}
+
+void PG_CopySink::rollback()
+{
+    if (preparedId.empty())
+    {
+        exec("ROLLBACK");
+    }
+    else if (exec("ROLLBACK PREPARED '" + preparedId + "'"))
+    {
+        preparedId.clear();
+    }
+}
+
+bool PG_CopySink::isTwoPhase() const
+{
+    return twoPhase;
+}
+
+File_CopySink::File_CopySink(const std::string& fileName) : fileName(fileName)
+{
+}
+
+bool File_CopySink::begin()
+{
+    file.open(fileName.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+    return file.is_open();
+}
+
+bool File_CopySink::copy(const std::string& query, const std::string& rows)
+{
+    file.write(rows.data(), rows.size());
+    return file.good();
+}
+
+bool File_CopySink::prepare(const std::string& transactionId)
+{
+    file.close();
+    return !file.fail();
+}
+
+bool File_CopySink::commit()
+{
+    return true;
+}
+
+void File_CopySink::rollback()
+{
+    if (file.is_open())
+    {
+        file.close();
+    }
+    std::remove(fileName.c_str());
+}
+
+bool File_CopySink::isTwoPhase() const
+{
+    return true;
+}
+
+PG_BulkInserter::Partition::~Partition()
+{
+    delete pending;
+    for (std::deque<Batch*>::iterator it = queue.begin(); it != queue.end(); ++it)
+    {
+        delete *it;
+    }
+}
+
+PG_BulkInserter::PG_BulkInserter(const int numInsertsPerQuery, unsigned int numPartitions, std::size_t queueCapacity) :
+        inputFile(nullptr), query(""), numInsertsPerQuery(numInsertsPerQuery), queueCapacity(std::max<std::size_t>(1, queueCapacity)),
+        running(false), numLoads(0)
+{
+    for (unsigned int i = 0; i < std::max(1u, numPartitions); ++i)
+    {
+        partitions.push_back(new Partition());
+    }
+}
+
+PG_BulkInserter::~PG_BulkInserter()
+{
+    if (running)
+    {
+        flush();
+    }
+    for (std::vector<Partition*>::iterator it = partitions.begin(); it != partitions.end(); ++it)
+    {
+        delete *it;
+    }
+    delete inputFile;
+}
+
+bool PG_BulkInserter::connect(const std::string &connectionStr)
+{
+    bool retVal = true;
+    bool twoPhase = partitions.size() > 1;
+
+    for (std::vector<Partition*>::iterator it = partitions.begin(); it != partitions.end(); ++it)
+    {
+        PG_CopySink* sink = new PG_CopySink();
+        (*it)->sink.reset(sink);
+        retVal = sink->connect(connectionStr, twoPhase) && retVal;
+        twoPhase = twoPhase && sink->isTwoPhase();
+    }
+
+    if (retVal && partitions.size() > 1 && !twoPhase)
+    {
+        Warn() << "PG_BulkInserter: prepared transactions are disabled on the server; the " << partitions.size()
+               << " partitions of a table are committed one after another\n";
+    }
+    return retVal;
+}
+
+void PG_BulkInserter::connectToFiles(const std::string& filePrefix)
+{
+    for (std::size_t i = 0; i < partitions.size(); ++i)
+    {
+        std::stringstream fileName;
+        fileName << filePrefix << "." << i;
+        partitions[i]->sink.reset(new File_CopySink(fileName.str()));
+    }
+}
+
 bool PG_BulkInserter::buildQuery(const std::string& tableName, const std::vector<std::string>& columnNames)
 {
     if (tableName.empty() || columnNames.empty())
@@ -50,6 +315,7 @@ bool PG_BulkInserter::buildQuery(const std::string& tableName, const std::vector
 
 bool PG_BulkInserter::setInputFile(const std::string& fileName)
 {
+    delete inputFile;
     inputFile = new std::ifstream(fileName);
 
     return inputFile->is_open();
@@ -57,57 +323,231 @@ bool PG_BulkInserter::setInputFile(const std::string& fileName)
 
 bool PG_BulkInserter::bulkInsert()
 {
-    std::string streamBuf;
+    if (!inputFile)
+    {
+        return false;
+    }
+
+    start();
+
     std::string line;
-    int numLines = 0;
     while(std::getline(*inputFile, line))
     {
-        ++numLines;
-        streamBuf.append(line);
-        streamBuf.append("\n");
-        if(numLines > numInsertsPerQuery)
+        Partition& partition = getPartition(firstColumn(line));
+        partition.pending->lines.push_back(std::string());
+        partition.pending->lines.back().swap(line);
+        if (partition.pending->size() > (std::size_t) numInsertsPerQuery)
         {
-            copyToDB(streamBuf);
-            streamBuf.clear();
-            numLines = 0;
+            submit(partition);
         }
     }
 
-    copyToDB(streamBuf);
+    return flush();
 }
 
-bool PG_BulkInserter::copyToDB(const std::string& buffer)
+void PG_BulkInserter::addRow(const std::vector<std::string>& fields)
 {
-    bool retVal = true;
+    if (fields.empty())
+    {
+        return;
+    }
 
-    PGresult* res = PQexec(connection, query.c_str());
+    start();
 
-    if(PQresultStatus(res) != PGRES_COPY_IN)
+    Partition& partition = getPartition(fields.front());
+    partition.pending->rows.push_back(fields);
+    if (partition.pending->size() > (std::size_t) numInsertsPerQuery)
     {
-        Print() << "PG_BulkInserter: Copy Failed\n";
-        retVal = false;
+        submit(partition);
+    }
+}
+
+PG_BulkInserter::Partition& PG_BulkInserter::getPartition(const std::string& key)
+{
+    if (partitions.size() == 1)
+    {
+        return *partitions.front();
+    }
+    return *partitions[boost::hash<std::string>()(key) % partitions.size()];
+}
+
+void PG_BulkInserter::submit(Partition& partition)
+{
+    if (partition.pending->size() == 0)
+    {
+        return;
+    }
+
+    boost::mutex::scoped_lock lock(partition.mutex);
+    while (partition.queue.size() >= queueCapacity && !partition.failed)
+    {
+        partition.changed.wait(lock);
+    }
+
+    //A failed partition will be rolled back; its rows are dropped.
+    if (partition.failed)
+    {
+        delete partition.pending;
     }
     else
     {
-        if(PQputCopyData(connection, buffer.c_str(), strlen(buffer.c_str())))
+        partition.queue.push_back(partition.pending);
+        partition.changed.notify_all();
+    }
+    partition.pending = new Batch();
+}
+
+void PG_BulkInserter::start()
+{
+    if (running)
+    {
+        return;
+    }
+
+    for (std::size_t i = 0; i < partitions.size(); ++i)
+    {
+        Partition& partition = *partitions[i];
+        partition.closing = false;
+        partition.begun = false;
+        partition.failed = !partition.sink;
+        if (partition.failed)
         {
+            Print() << "PG_BulkInserter: not connected\n";
+        }
 
-            if (PQputCopyEnd(connection, NULL) == 1)
+        std::stringstream transactionId;
+        transactionId << "sim_mob_copy_" << getpid() << "_" << this << "_" << numLoads << "_" << i;
+        partition.transactionId = transactionId.str();
+
+        partition.thread = boost::thread(boost::bind(&PG_BulkInserter::copyPartition, this, boost::ref(partition)));
+    }
+    ++numLoads;
+    running = true;
+}
+
+void PG_BulkInserter::copyPartition(Partition& partition)
+{
+    bool ok = !partition.failed && partition.sink->begin();
+    partition.begun = ok;
+    std::string buffer;
+
+    for (;;)
+    {
+        Batch* batch = nullptr;
+        {
+            boost::mutex::scoped_lock lock(partition.mutex);
+            if (!ok && !partition.failed)
             {
-                PGresult* res = PQgetResult(connection);
-                if (PQresultStatus(res) != PGRES_COMMAND_OK)
+                //Release a producer waiting for room
+                partition.failed = true;
+                partition.changed.notify_all();
+            }
+            while (partition.queue.empty() && !partition.closing)
+            {
+                partition.changed.wait(lock);
+            }
+            if (partition.queue.empty())
+            {
+                break;
+            }
+            batch = partition.queue.front();
+            partition.queue.pop_front();
+            partition.changed.notify_all();
+        }
+
+        if (ok)
+        {
+            buffer.clear();
+            for (std::vector<std::string>::const_iterator it = batch->lines.begin(); it != batch->lines.end(); ++it)
+            {
+                buffer.append(*it);
+                buffer.push_back('\n');
+            }
+            for (std::vector<std::vector<std::string> >::const_iterator row = batch->rows.begin(); row != batch->rows.end(); ++row)
+            {
+                for (std::vector<std::string>::const_iterator field = row->begin(); field != row->end(); ++field)
                 {
-                    Print() << PQerrorMessage(connection);
-                    retVal = false;
+                    if (field != row->begin())
+                    {
+                        buffer.push_back(',');
+                    }
+                    appendField(buffer, *field);
                 }
+                buffer.push_back('\n');
+            }
+            ok = partition.sink->copy(query, buffer);
+        }
+        delete batch;
+    }
+
+    if (ok)
+    {
+        ok = partition.sink->prepare(partition.transactionId);
+    }
+
+    boost::mutex::scoped_lock lock(partition.mutex);
+    partition.failed = !ok;
+}
+
+bool PG_BulkInserter::flush()
+{
+    if (!running)
+    {
+        return true;
+    }
+
+    for (std::vector<Partition*>::iterator it = partitions.begin(); it != partitions.end(); ++it)
+    {
+        Partition& partition = **it;
+        submit(partition);
+        {
+            boost::mutex::scoped_lock lock(partition.mutex);
+            partition.closing = true;
+            partition.changed.notify_all();
+        }
+    }
+
+    bool ok = true;
+    for (std::vector<Partition*>::iterator it = partitions.begin(); it != partitions.end(); ++it)
+    {
+        (*it)->thread.join();
+        ok = ok && !(*it)->failed;
+    }
+    running = false;
+
+    //The table is only complete if every partition is
+    if (!ok)
+    {
+        for (std::vector<Partition*>::iterator it = partitions.begin(); it != partitions.end(); ++it)
+        {
+            if ((*it)->begun)
+            {
+                (*it)->sink->rollback();
             }
-            else
+        }
+        Print() << "PG_BulkInserter: copy into the table failed\n";
+        return false;
+    }
+
+    //All partitions are prepared. Once one is committed, committing the others leaves the table closest to complete
+    std::stringstream uncommitted;
+    for (std::size_t i = 0; i < partitions.size(); ++i)
+    {
+        Partition& partition = *partitions[i];
+        if (!partition.sink->commit())
+        {
+            ok = false;
+            uncommitted << " " << i;
+            if (partition.sink->isTwoPhase())
             {
-                Print() << PQerrorMessage(connection);
-                retVal = false;
+                uncommitted << " (prepared as " << partition.transactionId << ")";
             }
         }
     }
 
-    return retVal;
+    if (!ok)
+    {
+        Print() << "PG_BulkInserter: the table is partially loaded; partitions not committed:" << uncommitted.str() << "\n";
+    }
+    return ok;
 }
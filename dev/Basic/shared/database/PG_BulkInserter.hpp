@@ -1,37 +1,266 @@
 #pragma once
 
+#include <deque>
 #include <fstream>
 #include <string>
 #include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
 #include <libpq-fe.h>
 
+namespace unit_tests
+{
+class PG_BulkInserterUnitTests;
+}
+
 namespace sim_mob
 {
 
-class PG_BulkInserter
+/**
+ * Destination of the COPY stream of one PG_BulkInserter partition.
+ *
+ * All batches of a partition are sent between begin() and prepare(), from the partition's thread. The transaction
+ * is then ended by commit() or rollback(), which are only called if begin() succeeded.
+ */
+class CopySink
+{
+public:
+    virtual ~CopySink() {}
+
+    virtual bool begin() = 0;
+
+    /**
+     * Sends a batch of rows
+     * @param query COPY ... FROM STDIN command
+     * @param rows rows in the text format of COPY, one per line
+     */
+    virtual bool copy(const std::string& query, const std::string& rows) = 0;
+
+    /**
+     * Ends the copy, so that commit() can no longer fail because of the rows sent
+     * @param transactionId name of the transaction, unique among the partitions of all loads
+     */
+    virtual bool prepare(const std::string& transactionId) = 0;
+
+    virtual bool commit() = 0;
+
+    virtual void rollback() = 0;
+
+    /**
+     * @return true if a prepared transaction survives a failure of this process until commit() or rollback(),
+     *         false if prepare() only checks the copy and commit() does all the work
+     */
+    virtual bool isTwoPhase() const = 0;
+};
+
+/**
+ * Copies into PostgreSQL through its own connection, within one transaction.
+ *
+ * With two-phase commit, prepare() is PREPARE TRANSACTION and commit() is COMMIT PREPARED. This needs
+ * max_prepared_transactions on the server to be at least the number of partitions being loaded at the same time.
+ * A transaction left prepared by a failed commit stays on the server until it is committed or rolled back by name.
+ */
+class PG_CopySink : public CopySink
 {
 public:
-    PG_BulkInserter(const int numInsertsPerQuery);
+    PG_CopySink();
+
+    virtual ~PG_CopySink();
+
+    /**
+     * @param twoPhase whether to use two-phase commit; it is not used if the server has prepared transactions disabled
+     */
+    bool connect(const std::string& connectionStr, bool twoPhase);
+
+    virtual bool begin();
+
+    virtual bool copy(const std::string& query, const std::string& rows);
+
+    virtual bool prepare(const std::string& transactionId);
+
+    virtual bool commit();
+
+    virtual void rollback();
+
+    virtual bool isTwoPhase() const;
+
+private:
+    /**
+     * @param expectedStatus command status the command must end with; any status if null
+     */
+    bool exec(const std::string& command, const char* expectedStatus = nullptr);
+
+    PGconn* connection;
+
+    bool twoPhase;
+
+    /**name of the prepared transaction; empty if none is prepared*/
+    std::string preparedId;
+};
+
+/**
+ * Writes the rows to a file instead, e.g. for tests or to load them later with psql's \copy.
+ * The file is removed on rollback.
+ */
+class File_CopySink : public CopySink
+{
+public:
+    explicit File_CopySink(const std::string& fileName);
+
+    virtual bool begin();
+
+    virtual bool copy(const std::string& query, const std::string& rows);
+
+    /**Closes the file*/
+    virtual bool prepare(const std::string& transactionId);
+
+    virtual bool commit();
+
+    virtual void rollback();
+
+    virtual bool isTwoPhase() const;
+
+private:
+    std::string fileName;
+
+    std::ofstream file;
+};
+
+/**
+ * Loads rows into a table with COPY.
+ *
+ * Rows are hashed on their first column into a number of partitions. Each partition has a thread, a CopySink and
+ * a bounded queue of batches: the producer (bulkInsert() or addRow()) only splits the rows and blocks when a queue
+ * is full, while the partition threads encode the rows and stream them in parallel. Rows with the same first
+ * column go to the same partition and keep their order.
+ *
+ * Each partition copies within its own transaction, and prepares it once all its batches are sent. flush() waits for
+ * all partitions, then commits all of them if all of them were prepared, or rolls back all partitions which began a
+ * transaction otherwise. With two-phase commit (the default for more than one partition) a commit can then only fail
+ * if the server becomes unreachable. Without it, e.g. if the server has prepared transactions disabled, the
+ * partitions are committed one after another and a failed commit leaves the earlier partitions committed.
+ * Either way, flush() then commits the remaining partitions, and logs which partitions were not committed.
+ *
+ * Since flush() returns only once the table is loaded, tables loaded one after another by the caller are loaded
+ * in that order.
+ */
+class PG_BulkInserter : private boost::noncopyable
+{
+public:
+    /**
+     * @param numInsertsPerQuery number of rows sent by each COPY command
+     * @param numPartitions number of parallel COPY streams
+     * @param queueCapacity number of batches which may wait in the queue of a partition
+     */
+    PG_BulkInserter(const int numInsertsPerQuery, unsigned int numPartitions = 1, std::size_t queueCapacity = 4);
 
     ~PG_BulkInserter();
 
+    /**
+     * Opens one connection per partition. With more than one partition, the partitions are committed in two phases
+     * if the server allows it; a warning is logged otherwise.
+     */
     bool connect(const std::string& connectionStr);
 
+    /**
+     * Writes partition n to the file <filePrefix>.<n> instead of a database
+     */
+    void connectToFiles(const std::string& filePrefix);
+
     bool buildQuery(const std::string& tableName, const std::vector<std::string>& columnNames);
 
     bool setInputFile(const std::string& inputFile);
 
+    /**
+     * Copies the lines of the input file, which must be in the text format of COPY with ',' as delimiter,
+     * then flushes.
+     * @return true if all lines were copied and committed
+     */
     bool bulkInsert();
+
+    /**
+     * Queues a row; the fields are escaped by the partition threads.
+     * The row is partitioned on its first field.
+     */
+    void addRow(const std::vector<std::string>& fields);
+
+    /**
+     * Copies all queued rows and ends the transactions of all partitions.
+     * @return true if all rows since the last flush were copied and committed
+     */
+    bool flush();
+
 private:
+    /**A batch of rows for one COPY command*/
+    struct Batch
+    {
+        /**rows already in the text format*/
+        std::vector<std::string> lines;
+
+        /**rows to be encoded*/
+        std::vector<std::vector<std::string> > rows;
+
+        std::size_t size() const
+        {
+            return lines.size() + rows.size();
+        }
+    };
+
+    struct Partition
+    {
+        Partition() : pending(new Batch()), closing(false), failed(false), begun(false)
+        {
+        }
+
+        ~Partition();
+
+        boost::scoped_ptr<CopySink> sink;
+
+        /**batch being filled by the producer*/
+        Batch* pending;
+
+        boost::mutex mutex;
+        boost::condition_variable changed;
+        std::deque<Batch*> queue;
+        bool closing;
+        bool failed;
+
+        /**whether the sink began a transaction; set by the partition's thread*/
+        bool begun;
+
+        /**name of the transaction of the current load*/
+        std::string transactionId;
+
+        boost::thread thread;
+    };
+
+    Partition& getPartition(const std::string& key);
+
+    void submit(Partition& partition);
+
+    void start();
+
+    void copyPartition(Partition& partition);
+
     std::ifstream* inputFile;
 
     std::string query;
 
-    PGconn* connection;
-
     int numInsertsPerQuery;
 
-    bool copyToDB(const std::string& buffer);
+    std::size_t queueCapacity;
+
+    std::vector<Partition*> partitions;
+
+    bool running;
+
+    /**number of loads started, to name their transactions*/
+    unsigned int numLoads;
+
+    friend class unit_tests::PG_BulkInserterUnitTests;
 };
 
 }
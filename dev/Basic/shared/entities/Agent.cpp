@@ -13,6 +13,7 @@
 #include "conf/settings/ProfileOptions.h"
 #include "conf/settings/DisableMPI.h"
 #include "conf/settings/StrictAgentErrors.h"
+#include "entities/AgentRegistry.hpp"
 #include "entities/profile/ProfileBuilder.hpp"
 #include "event/SystemEvents.hpp"
 #include "geospatial/network/Node.hpp"
@@ -101,6 +102,8 @@ mutexStrat(mtxStrat), initialized(false), xPos(mtxStrat, 0), yPos(mtxStrat, 0),
 
 sim_mob::Agent::~Agent()
 {
+    //Agents which were never removed by their Worker (e.g., those still pending at the end) must not stay listed.
+    AgentRegistry::getInstance().removeAgent(this);
 }
 
 void sim_mob::Agent::checkFrameTimes(unsigned int agentId, uint32_t now, unsigned int startTime, bool wasFirstFrame, bool wasRemoved)
@@ -0,0 +1,276 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+
+namespace sim_mob
+{
+
+class Agent;
+class RoadSegment;
+
+/**
+ * Dense, typed views of the agents in the simulation, so that hot paths (e.g., the AuraManager rebuilding its tree
+ *   every tick) can enumerate just the agents they care about, instead of scanning Agent::all_agents with dynamic_cast.
+ * Three kinds of view are kept:
+ *   - the spatial agents (agents which have a position);
+ *   - the agents playing each role, by role type (see Role<PERSON>::Type), e.g., all drivers or all pedestrians;
+ *   - the vehicles on each road segment.
+ * Each view is a plain vector; every agent remembers its slot in each view it is listed in, so adding, removing and
+ *   moving an agent between views is O(1) (removal swaps the last agent of the view into the freed slot).
+ * Roles and segments may be reported before the agent is added (e.g., a Person's first role is created while it is
+ *   still pending); they are only listed once the agent is added.
+ *
+ * THREADING: Agents are added and removed by the main thread, while their Workers are waiting. Roles and segments
+ *   change during the tick, on the Workers' threads, so every mutator takes the registry's lock. The views themselves
+ *   are not locked; like Agent::all_agents, they should only be read between ticks.
+ */
+template <class AgentT, class SegmentT>
+class TypedAgentRegistry
+{
+public:
+    typedef std::vector<AgentT *> View;
+
+    ///The role type of an agent that has no role (Role<PERSON>::RL_UNKNOWN).
+    static const int NO_ROLE = 0;
+
+    ///Retrieves the registry. It is never destroyed, since Agents may still be deleted during static destruction.
+    static TypedAgentRegistry &getInstance()
+    {
+        static TypedAgentRegistry *instance = new TypedAgentRegistry();
+        return *instance;
+    }
+
+    /**
+     * Lists an agent in the views. Adding an agent twice has no effect.
+     *
+     * @param agent the agent
+     * @param spatial true if the agent should also be listed in getSpatialAgents()
+     */
+    void addAgent(AgentT *agent, bool spatial)
+    {
+        boost::lock_guard<boost::mutex> lock(registryLOCK);
+        Membership &member = members[agent];
+        if (member.added)
+        {
+            return;
+        }
+
+        member.agent = agent;
+        member.added = true;
+        if (spatial)
+        {
+            insert(spatialAgents, member, &Membership::spatialSlot);
+        }
+        if (member.role != NO_ROLE)
+        {
+            insert(getRoleView(member.role), member, &Membership::roleSlot);
+        }
+        if (member.segment)
+        {
+            insert(segmentViews[member.segment], member, &Membership::segmentSlot);
+        }
+    }
+
+    ///Removes an agent from every view, and forgets its role and segment. Unknown agents are ignored.
+    void removeAgent(AgentT *agent)
+    {
+        boost::lock_guard<boost::mutex> lock(registryLOCK);
+        typename boost::unordered_map<const AgentT *, Membership>::iterator it = members.find(agent);
+        if (it == members.end())
+        {
+            return;
+        }
+
+        Membership &member = it->second;
+        if (member.spatialSlot != NOT_LISTED)
+        {
+            erase(spatialAgents, member, &Membership::spatialSlot);
+        }
+        if (member.roleSlot != NOT_LISTED)
+        {
+            erase(roleViews[member.role], member, &Membership::roleSlot);
+        }
+        if (member.segmentSlot != NOT_LISTED)
+        {
+            erase(segmentViews[member.segment], member, &Membership::segmentSlot);
+        }
+        members.erase(it);
+    }
+
+    /**
+     * Moves an agent to the view of its new role. Changing role also takes the agent off its road segment; the new
+     *   role reports its own segment (if any) once it starts moving.
+     *
+     * @param agent the agent
+     * @param role the type of the new role, or NO_ROLE
+     */
+    void setRole(AgentT *agent, int role)
+    {
+        boost::lock_guard<boost::mutex> lock(registryLOCK);
+        Membership &member = members[agent];
+        member.agent = agent;
+        if (member.role == role)
+        {
+            return;
+        }
+
+        if (member.roleSlot != NOT_LISTED)
+        {
+            erase(roleViews[member.role], member, &Membership::roleSlot);
+        }
+        if (member.segmentSlot != NOT_LISTED)
+        {
+            erase(segmentViews[member.segment], member, &Membership::segmentSlot);
+        }
+        member.segment = NULL;
+        member.role = role;
+        if (member.added && role != NO_ROLE)
+        {
+            insert(getRoleView(role), member, &Membership::roleSlot);
+        }
+    }
+
+    /**
+     * Moves a vehicle to the view of the road segment it is now on.
+     *
+     * @param agent the agent driving the vehicle
+     * @param segment the segment, or NULL if the vehicle is not on a segment (e.g., it is in an intersection)
+     */
+    void setSegment(AgentT *agent, const SegmentT *segment)
+    {
+        boost::lock_guard<boost::mutex> lock(registryLOCK);
+        Membership &member = members[agent];
+        member.agent = agent;
+        if (member.segment == segment)
+        {
+            return;
+        }
+
+        if (member.segmentSlot != NOT_LISTED)
+        {
+            erase(segmentViews[member.segment], member, &Membership::segmentSlot);
+        }
+        member.segment = segment;
+        if (member.added && segment)
+        {
+            insert(segmentViews[segment], member, &Membership::segmentSlot);
+        }
+    }
+
+    ///Retrieves every agent that has been added as spatial.
+    const View &getSpatialAgents() const
+    {
+        return spatialAgents.agents;
+    }
+
+    ///Retrieves the agents currently playing the given role type (e.g., Role<PERSON>::RL_DRIVER).
+    const View &getAgentsWithRole(int role) const
+    {
+        if (role < 0 || static_cast<size_t>(role) >= roleViews.size())
+        {
+            return emptyView;
+        }
+        return roleViews[role].agents;
+    }
+
+    ///Retrieves the vehicles currently on the given road segment.
+    const View &getVehiclesOnSegment(const SegmentT *segment) const
+    {
+        typename boost::unordered_map<const SegmentT *, DenseView>::const_iterator it = segmentViews.find(segment);
+        return (it != segmentViews.end()) ? it->second.agents : emptyView;
+    }
+
+    ///Forgets every agent (e.g., at the end of the simulation, before the agents are deleted).
+    void clear()
+    {
+        boost::lock_guard<boost::mutex> lock(registryLOCK);
+        members.clear();
+        spatialAgents = DenseView();
+        roleViews.clear();
+        segmentViews.clear();
+    }
+
+private:
+    static const size_t NOT_LISTED = static_cast<size_t>(-1);
+
+    ///Helper struct: what the registry knows about one agent, including its slot in each view (or NOT_LISTED).
+    struct Membership
+    {
+        AgentT *agent;
+        bool added;
+        int role;
+        const SegmentT *segment;
+        size_t spatialSlot;
+        size_t roleSlot;
+        size_t segmentSlot;
+
+        Membership() : agent(NULL), added(false), role(NO_ROLE), segment(NULL), spatialSlot(NOT_LISTED),
+            roleSlot(NOT_LISTED), segmentSlot(NOT_LISTED)
+        {
+        }
+    };
+
+    ///Helper struct: a view, along with the membership of each agent in it (so that slots can be fixed up on removal).
+    ///Memberships live in an unordered_map, whose elements never move, so pointers to them stay valid.
+    struct DenseView
+    {
+        View agents;
+        std::vector<Membership *> members;
+    };
+
+    TypedAgentRegistry()
+    {
+    }
+
+    //Called with registryLOCK held.
+    DenseView &getRoleView(int role)
+    {
+        if (static_cast<size_t>(role) >= roleViews.size())
+        {
+            roleViews.resize(role + 1);
+        }
+        return roleViews[role];
+    }
+
+    //Called with registryLOCK held.
+    static void insert(DenseView &view, Membership &member, size_t Membership::*slot)
+    {
+        member.*slot = view.agents.size();
+        view.agents.push_back(member.agent);
+        view.members.push_back(&member);
+    }
+
+    //Called with registryLOCK held.
+    static void erase(DenseView &view, Membership &member, size_t Membership::*slot)
+    {
+        const size_t freed = member.*slot;
+        Membership *last = view.members.back();
+        view.agents[freed] = view.agents.back();
+        view.members[freed] = last;
+        last->*slot = freed;
+        view.agents.pop_back();
+        view.members.pop_back();
+        member.*slot = NOT_LISTED;
+    }
+
+    boost::unordered_map<const AgentT *, Membership> members;
+    DenseView spatialAgents;
+    std::vector<DenseView> roleViews;
+    boost::unordered_map<const SegmentT *, DenseView> segmentViews;
+    const View emptyView;
+    boost::mutex registryLOCK;
+};
+
+///The registry of the simulation's agents.
+typedef TypedAgentRegistry<Agent, RoadSegment> AgentRegistry;
+
+}
@@ -12,6 +12,7 @@
 #include "geospatial/network/Point.hpp"
 #include "geospatial/network/WayPoint.hpp"
 
+#include "spatial_trees/AuraQueryBatch.hpp"
 #include "spatial_trees/TreeImpl.hpp"
 #include "spatial_trees/rstar_tree/RStarAuraManager.hpp"
 #include "spatial_trees/simtree/SimAuraManager.hpp"
@@ -95,6 +96,24 @@ std::vector<Agent const *> AuraManager::nearbyAgents(Point const &position, WayP
     return results;
 }
 
+void AuraManager::agentsInRects(AuraQueryBatch &batch) const
+{
+    if (impl_)
+    {
+        impl_->agentsInRects(batch);
+    }
+    else
+    {
+        //Still mark every query as answered (with no agents).
+        const std::vector<size_t> &order = batch.beginAnswers();
+        for (std::vector<size_t>::const_iterator it = order.begin(); it != order.end(); ++it)
+        {
+            batch.beginAnswer(*it);
+            batch.endAnswer(*it);
+        }
+    }
+}
+
 void AuraManager::registerNewAgent(Agent const *one_agent)
 {
     if (impl_)
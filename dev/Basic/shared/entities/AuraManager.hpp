@@ -17,6 +17,7 @@ class Entity;
 class Agent;
 class Point;
 class TreeImpl;
+class AuraQueryBatch;
 
 struct TreeItem;
 
@@ -114,6 +115,16 @@ public:
     std::vector<Agent const *> nearbyAgents(Point const &position, WayPoint const &wayPoint, double distanceInFront, double distanceBehind,
                                             const Agent *refAgent) const;
 
+    /**
+     * Answer a batch of rectangle queries at once (see AuraQueryBatch).
+     *
+     * The queries are answered in order of spatial locality, and their results are written into the batch's own
+     * buffer, so a caller that keeps its batch across ticks does not allocate once the buffer has grown.
+     *
+     * @param batch The queries; on return, holds the agents found by each of them.
+     */
+    void agentsInRects(AuraQueryBatch &batch) const;
+
     /**
      * Initialise the AuraManager object (to be invoked by the simulator kernel).
      *
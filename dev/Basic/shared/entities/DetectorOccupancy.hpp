@@ -0,0 +1,172 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+
+namespace sim_mob
+{
+
+/**
+ * Keeps track of the vehicles hovering over a sensor from the crossings reported by the vehicles themselves.
+ *
+ * Vehicles call enter() when they move onto the sensor and leave() when they move off it, from whichever thread
+ * updates them. The sensor calls update() once per tick, from its own thread; update() only applies the crossings
+ * which happened before the current tick, so the result does not depend on whether the vehicles or the sensor were
+ * updated first within a tick. The occupancy seen at a tick is thus the one at the end of the previous tick, which
+ * is also what a query of the vehicles' positions would return.
+ *
+ * A vehicle is reported as having entered by the first update() at which it is over the sensor. As a loop detector
+ * counts at most one vehicle per tick, update() reports at most one vehicle; the others over the sensor are reported
+ * by the following updates, in the order in which they entered, if they are still over it. A vehicle which entered
+ * and left between two calls to update() is not reported.
+ *
+ * T is the type of the vehicle handle; only its address is used.
+ */
+template <typename T>
+class DetectorOccupancy : private boost::noncopyable
+{
+public:
+    DetectorOccupancy()
+    {
+    }
+
+    /**
+     * Reports that a vehicle moved onto the sensor. Thread-safe.
+     * @param vehicle the vehicle
+     * @param time the time (in ms) of the tick during which it crossed
+     */
+    void enter(const T* vehicle, unsigned int time)
+    {
+        boost::mutex::scoped_lock lock(crossingsMutex);
+        crossings.push_back(Crossing(vehicle, time, true));
+    }
+
+    /**
+     * Reports that a vehicle moved off the sensor. Thread-safe. Must be called before the vehicle is destroyed.
+     * @param vehicle the vehicle
+     * @param time the time (in ms) of the tick during which it crossed
+     */
+    void leave(const T* vehicle, unsigned int time)
+    {
+        boost::mutex::scoped_lock lock(crossingsMutex);
+        crossings.push_back(Crossing(vehicle, time, false));
+    }
+
+    /**
+     * Applies the crossings which happened before the given time.
+     * @param now the time (in ms) of the current tick
+     * @param entered receives the vehicle which entered first among those over the sensor and not yet reported
+     * @return true if at least one vehicle is over the sensor
+     */
+    bool update(unsigned int now, std::vector<const T*>& entered)
+    {
+        {
+            boost::mutex::scoped_lock lock(crossingsMutex);
+            //Crossings of the current tick stay for the next update; the order of the others is kept
+            typename std::vector<Crossing>::iterator keep = crossings.begin();
+            for (typename std::vector<Crossing>::iterator it = crossings.begin(); it != crossings.end(); ++it)
+            {
+                if (it->time < now)
+                {
+                    ready.push_back(*it);
+                }
+                else
+                {
+                    *keep++ = *it;
+                }
+            }
+            crossings.erase(keep, crossings.end());
+        }
+
+        for (typename std::vector<Crossing>::const_iterator it = ready.begin(); it != ready.end(); ++it)
+        {
+            typename std::vector<Occupant>::iterator occupant = std::find_if(occupants.begin(), occupants.end(),
+                                                                             IsVehicle(it->vehicle));
+            if (it->entering && occupant == occupants.end())
+            {
+                occupants.push_back(Occupant(it->vehicle));
+            }
+            else if (!it->entering && occupant != occupants.end())
+            {
+                occupants.erase(occupant);
+            }
+        }
+        ready.clear();
+
+        for (typename std::vector<Occupant>::iterator it = occupants.begin(); it != occupants.end(); ++it)
+        {
+            if (!it->reported)
+            {
+                it->reported = true;
+                entered.push_back(it->vehicle);
+                break;
+            }
+        }
+
+        return !occupants.empty();
+    }
+
+    /**
+     * @return the number of vehicles over the sensor as of the last update()
+     */
+    std::size_t size() const
+    {
+        return occupants.size();
+    }
+
+private:
+    struct Crossing
+    {
+        Crossing(const T* vehicle, unsigned int time, bool entering) : vehicle(vehicle), time(time), entering(entering)
+        {
+        }
+
+        const T* vehicle;
+        unsigned int time;
+        bool entering;
+    };
+
+    struct Occupant
+    {
+        explicit Occupant(const T* vehicle) : vehicle(vehicle), reported(false)
+        {
+        }
+
+        const T* vehicle;
+
+        /**whether update() already returned this vehicle as entered*/
+        bool reported;
+    };
+
+    struct IsVehicle
+    {
+        explicit IsVehicle(const T* vehicle) : vehicle(vehicle)
+        {
+        }
+
+        bool operator()(const Occupant& occupant) const
+        {
+            return occupant.vehicle == vehicle;
+        }
+
+        const T* vehicle;
+    };
+
+    /**crossings reported by the vehicles and not yet applied*/
+    std::vector<Crossing> crossings;
+    boost::mutex crossingsMutex;
+
+    /**crossings being applied; kept to reuse its storage*/
+    std::vector<Crossing> ready;
+
+    /**vehicles over the sensor, in the order in which they entered; rarely more than one*/
+    std::vector<Occupant> occupants;
+};
+
+}
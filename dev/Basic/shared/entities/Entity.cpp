@@ -6,6 +6,7 @@
 
 #include "buffering/BufferedDataManager.hpp"
 #include "logging/Log.hpp"
+#include "workers/EntityList.hpp"
 
 using std::string;
 using std::vector;
@@ -32,7 +33,7 @@ const UpdateStatus sim_mob::Entity::UpdateStatus::Done(UpdateStatus::RS_DONE);
 
 sim_mob::Entity::Entity(unsigned int id) :
         id(id), startTime(0), currWorkerProvider(nullptr), isFake(false), parentEntity(nullptr), isDuplicateFakeEntity(false), MessageHandler(id),
-        multiUpdate(false)
+        multiUpdate(false), workerSlot(EntityList::NO_SLOT)
 {
 }
 
@@ -26,6 +26,7 @@ class Worker;
 class WorkerProvider;
 class WorkGroup;
 class PartitionManager;
+template <typename T> class BasicEntityList;
 
 /**
  * Base class of all agents and other "decision-making" entities.
@@ -209,6 +210,11 @@ public:
     friend class Worker;
     friend class WorkerGroup;
     friend class PartitionManager;
+    template <typename T> friend class BasicEntityList;
+
+private:
+    /**Position of this entity in the entity list of its current worker.*/
+    unsigned int workerSlot;
 };
 
 
@@ -28,6 +28,8 @@ namespace sim_mob
     template<typename PERSON>
     boost::unordered_map<const Station*, Agent*> TrainController<PERSON>::allStationAgents;
     template<typename PERSON>
+    const typename TrainController<PERSON>::LineHandle TrainController<PERSON>::INVALID_LINE;
+    template<typename PERSON>
     TrainController<PERSON>::TrainController(int id, const MutexStrategy& mtxStrat):Agent(mtxStrat, id),disruptionParam(nullptr)
     {
 
@@ -102,7 +104,9 @@ namespace sim_mob
             const soci::row& r = (*it);
             std::string lineId = r.get<std::string>(0);
             std::string opp_lineId = r.get<std::string>(1);
-            mapOfOppositeLines[lineId]=opp_lineId;
+            LineHandle line = internLine(lineId);
+            LineHandle oppLine = internLine(opp_lineId);
+            lines[line].opposite = oppLine;
         }
     }
 
@@ -387,78 +391,166 @@ namespace sim_mob
     }
 
     template<typename PERSON>
-    std::string TrainController<PERSON>::getOppositeLineId(std::string lineId)
-    {
-        std::map<std::string,std::string>::iterator it = mapOfOppositeLines.find(lineId);
-        if(it != mapOfOppositeLines.end())
-        {
-            return it->second;
-        }
-    }
-    template<typename PERSON>
-    void TrainController<PERSON>::frame_output(timeslice now)
+    std::string TrainController<PERSON>::getOppositeLineId(const std::string& lineId) const
     {
+        return getLineId(getOppositeLine(getLineHandle(lineId)));
     }
+
     template<typename PERSON>
-    bool TrainController<PERSON>::isNonspatial()
+    typename TrainController<PERSON>::LineHandle TrainController<PERSON>::internLine(const std::string& lineId)
     {
-        return true;
+        std::map<std::string, LineHandle>::const_iterator it = mapOfIdvsLineHandles.find(lineId);
+        if(it != mapOfIdvsLineHandles.end())
+        {
+            return it->second;
+        }
+        LineHandle line = lines.size();
+        lines.push_back(LineData());
+        lines.back().lineId = lineId;
+        mapOfIdvsLineHandles[lineId] = line;
+        return line;
     }
+
     template<typename PERSON>
-    bool TrainController<PERSON>::getTrainRoute(const std::string& lineId, std::vector<Block*>& route) const
+    void TrainController<PERSON>::resolveLines()
     {
-        bool res = true;
-        std::map<std::string, std::vector<TrainRoute>>::const_iterator it = mapOfIdvsTrainRoutes.find(lineId);
-        if(it == mapOfIdvsTrainRoutes.end())
-        {
-            res = false;
-        }
-        else
+        for(typename std::vector<LineData>::iterator itLine = lines.begin(); itLine != lines.end(); itLine++)
         {
-            const std::vector<TrainRoute>& trainRoute = it->second;
-            for(std::vector<TrainRoute>::const_iterator i = trainRoute.begin();i!=trainRoute.end();i++)
+            LineData& data = *itLine;
+            data.blocks.clear();
+            data.platforms.clear();
+            data.platformIndex.clear();
+
+            data.routeComplete = !data.trainRoutes.empty();
+            for(std::vector<TrainRoute>::const_iterator i = data.trainRoutes.begin(); i != data.trainRoutes.end(); i++)
             {
                 std::map<unsigned int, Block*>::const_iterator iBlock = mapOfIdvsBlocks.find(i->blockId);
                 if(iBlock == mapOfIdvsBlocks.end())
                 {
-                    res = false;
+                    data.routeComplete = false;
                     break;
                 }
-                else
+                data.blocks.push_back(iBlock->second);
+            }
+
+            data.platformsComplete = !data.trainPlatforms.empty();
+            for(std::vector<TrainPlatform>::const_iterator i = data.trainPlatforms.begin(); i != data.trainPlatforms.end(); i++)
+            {
+                std::map<std::string, Platform*>::const_iterator iPlatform = mapOfIdvsPlatforms.find(i->platformNo);
+                if(iPlatform == mapOfIdvsPlatforms.end())
                 {
-                    route.push_back(iBlock->second);
+                    data.platformsComplete = false;
+                    break;
                 }
+                data.platformIndex[iPlatform->second] = data.platforms.size();
+                data.platforms.push_back(iPlatform->second);
             }
         }
-        return res;
     }
+
     template<typename PERSON>
-    bool TrainController<PERSON>::getTrainPlatforms(const std::string& lineId, std::vector<Platform*>& platforms) const
+    const typename TrainController<PERSON>::LineData& TrainController<PERSON>::getLineData(LineHandle line) const
     {
-        bool res = true;
-        std::map<std::string, std::vector<TrainPlatform>>::const_iterator it = mapOfIdvsTrainPlatforms.find(lineId);
-        if(it == mapOfIdvsTrainPlatforms.end())
+        if(line >= lines.size())
         {
-            res = false;
+            return emptyLine;
         }
-        else
+        return lines[line];
+    }
+
+    template<typename PERSON>
+    typename TrainController<PERSON>::LineHandle TrainController<PERSON>::getLineHandle(const std::string& lineId) const
+    {
+        std::map<std::string, LineHandle>::const_iterator it = mapOfIdvsLineHandles.find(lineId);
+        if(it == mapOfIdvsLineHandles.end())
         {
-            const std::vector<TrainPlatform>& trainPlatform = it->second;
-            for(std::vector<TrainPlatform>::const_iterator i = trainPlatform.begin();i!=trainPlatform.end();i++)
-            {
-                std::map<std::string, Platform*>::const_iterator iPlatform = mapOfIdvsPlatforms.find(i->platformNo);
-                if(iPlatform == mapOfIdvsPlatforms.end())
-                {
-                    res = false;
-                    break;
-                }
-                else
-                {
-                    platforms.push_back(iPlatform->second);
-                }
-            }
+            return INVALID_LINE;
         }
-        return res;
+        return it->second;
+    }
+
+    template<typename PERSON>
+    const std::string& TrainController<PERSON>::getLineId(LineHandle line) const
+    {
+        return getLineData(line).lineId;
+    }
+
+    template<typename PERSON>
+    const std::vector<Block*>& TrainController<PERSON>::getBlocks(LineHandle line) const
+    {
+        return getLineData(line).blocks;
+    }
+
+    template<typename PERSON>
+    const std::vector<Platform*>& TrainController<PERSON>::getTrainPlatforms(LineHandle line) const
+    {
+        return getLineData(line).platforms;
+    }
+
+    template<typename PERSON>
+    const std::vector<TrainSchedule>& TrainController<PERSON>::getSchedules(LineHandle line) const
+    {
+        return getLineData(line).schedules;
+    }
+
+    template<typename PERSON>
+    typename TrainController<PERSON>::PlatformRange TrainController<PERSON>::getPlatforms(LineHandle line, const Platform* startPlatform) const
+    {
+        const LineData& data = getLineData(line);
+        boost::unordered_map<const Platform*, std::size_t>::const_iterator it = data.platformIndex.find(startPlatform);
+        if(it == data.platformIndex.end() || !data.platformsComplete)
+        {
+            return PlatformRange(data.platforms.end(), data.platforms.end());
+        }
+        return PlatformRange(data.platforms.begin() + it->second, data.platforms.end());
+    }
+
+    template<typename PERSON>
+    Platform* TrainController<PERSON>::getNextPlatform(LineHandle line, const Platform* platform) const
+    {
+        const LineData& data = getLineData(line);
+        boost::unordered_map<const Platform*, std::size_t>::const_iterator it = data.platformIndex.find(platform);
+        if(it == data.platformIndex.end() || it->second + 1 >= data.platforms.size())
+        {
+            return nullptr;
+        }
+        return data.platforms[it->second + 1];
+    }
+
+    template<typename PERSON>
+    bool TrainController<PERSON>::isTerminalPlatform(LineHandle line, const Platform* platform) const
+    {
+        const LineData& data = getLineData(line);
+        return data.platformsComplete && data.platforms.back() == platform;
+    }
+
+    template<typename PERSON>
+    typename TrainController<PERSON>::LineHandle TrainController<PERSON>::getOppositeLine(LineHandle line) const
+    {
+        return getLineData(line).opposite;
+    }
+    template<typename PERSON>
+    void TrainController<PERSON>::frame_output(timeslice now)
+    {
+    }
+    template<typename PERSON>
+    bool TrainController<PERSON>::isNonspatial()
+    {
+        return true;
+    }
+    template<typename PERSON>
+    bool TrainController<PERSON>::getTrainRoute(const std::string& lineId, std::vector<Block*>& route) const
+    {
+        const LineData& data = getLineData(getLineHandle(lineId));
+        route.insert(route.end(), data.blocks.begin(), data.blocks.end());
+        return data.routeComplete;
+    }
+    template<typename PERSON>
+    bool TrainController<PERSON>::getTrainPlatforms(const std::string& lineId, std::vector<Platform*>& platforms) const
+    {
+        const LineData& data = getLineData(getLineHandle(lineId));
+        platforms.insert(platforms.end(), data.platforms.begin(), data.platforms.end());
+        return data.platformsComplete;
     }
     template<typename PERSON>
     void TrainController<PERSON>::initTrainController()
@@ -470,6 +562,7 @@ namespace sim_mob
         loadTrainAvailabilities();
         loadTrainRoutes();
         loadTrainPlatform();
+        resolveLines();
         loadTransferedTimes();
         loadBlockPolylines();
         composeBlocksAndPolyline();
@@ -582,7 +675,7 @@ namespace sim_mob
     }
 
     template<typename PERSON>
-    double TrainController<PERSON>::getMinDwellTime(std::string stationNo,std::string lineId) const
+    double TrainController<PERSON>::getMinDwellTime(const std::string& stationNo, const std::string& lineId) const
     {
         const ConfigParams& config = ConfigManager::GetInstance().FullConfig();
         const std::map<const std::string,TrainProperties> &trainLinePropertiesMap = config.trainController.trainLinePropertiesMap;
@@ -593,39 +686,22 @@ namespace sim_mob
             minDwellTime = trainProperties.dwellTimeInfo.dwellTimeAtInterchanges;
         }
 
-        std::map<std::string, std::vector<TrainPlatform>>::const_iterator it = mapOfIdvsTrainPlatforms.find(lineId);
-        const std::vector<TrainPlatform> TrainPlatforms = it->second;
-        std::vector<TrainPlatform>::const_iterator itTrainPlatforms = TrainPlatforms.begin();
-        Platform *platform = mapOfIdvsPlatforms.find((*itTrainPlatforms).platformNo)->second;
-        if(boost::iequals(platform->getStationNo(),stationNo))
+        const std::vector<Platform*>& platforms = getTrainPlatforms(getLineHandle(lineId));
+        if(!platforms.empty() && (boost::iequals(platforms.front()->getStationNo(),stationNo)
+                || boost::iequals(platforms.back()->getStationNo(),stationNo)))
         {
             minDwellTime = trainProperties.dwellTimeInfo.dwellTimeAtTerminalStaions;
         }
-
-        else
-        {
-            std::vector<TrainPlatform>::const_iterator itTrainPlatforms = TrainPlatforms.end()-1;
-            Platform *platform = mapOfIdvsPlatforms.find((*itTrainPlatforms).platformNo)->second;
-            if(boost::iequals(platform->getStationNo(),stationNo))
-            {
-                minDwellTime = trainProperties.dwellTimeInfo.dwellTimeAtTerminalStaions;
-            }
-        }
         return minDwellTime;
     }
 
     template<typename PERSON>
-    bool TrainController<PERSON>::isFirstStation(std::string lineId,Platform *platform) const
+    bool TrainController<PERSON>::isFirstStation(const std::string& lineId, const Platform *platform) const
     {
-        std::map<std::string, std::vector<TrainPlatform>>::const_iterator it = mapOfIdvsTrainPlatforms.find(lineId);
-        if(it != mapOfIdvsTrainPlatforms.end())
+        const std::vector<TrainPlatform>& trainPlatforms = getLineData(getLineHandle(lineId)).trainPlatforms;
+        if(!trainPlatforms.empty() && boost::iequals(trainPlatforms.front().platformNo,platform->getPlatformNo()))
         {
-            const std::vector<TrainPlatform> TrainPlatforms = it->second;
-            std::vector<TrainPlatform>::const_iterator itTrainPlatforms = TrainPlatforms.begin();
-            if(boost::iequals((*itTrainPlatforms).platformNo,platform->getPlatformNo()))
-            {
-                return true;
-            }
+            return true;
         }
         return false;
     }
@@ -653,11 +729,8 @@ namespace sim_mob
             schedule.startTime = r.get<std::string>(2);
             schedule.endTime = r.get<std::string>(3);
             schedule.headwaySec = r.get<int>(4);
-            if(mapOfIdvsSchedules.find(lineId) == mapOfIdvsSchedules.end())
-            {
-                mapOfIdvsSchedules[lineId] = std::vector<TrainSchedule>();
-            }
-            mapOfIdvsSchedules[lineId].push_back(schedule);
+            boost::algorithm::erase_all(lineId, " ");
+            lines[internLine(lineId)].schedules.push_back(schedule);
         }
     }
 
@@ -665,17 +738,16 @@ namespace sim_mob
     void TrainController<PERSON>::composeTrainTrips()
     {
         int tripId = 1;
-        std::map<std::string, std::vector<TrainSchedule>>::const_iterator it;
-        for(it = mapOfIdvsSchedules.begin(); it != mapOfIdvsSchedules.end(); it++)
+        //lines are visited in id order so that trip ids do not depend on the load order
+        std::map<std::string, LineHandle>::const_iterator it;
+        for(it = mapOfIdvsLineHandles.begin(); it != mapOfIdvsLineHandles.end(); it++)
         {
-            std::string lineId = it->first;
-            boost::algorithm::erase_all(lineId, " ");
+            const std::string& lineId = it->first;
+            const LineData& data = lines[it->second];
             std::vector<TrainSchedule>::const_iterator iSchedule;
-            const std::vector<TrainSchedule>& schedules = it->second;
-            std::vector<Block*> route;
-            std::vector<Platform*> platforms;
-            getTrainRoute(lineId, route);
-            getTrainPlatforms(lineId, platforms);
+            const std::vector<TrainSchedule>& schedules = data.schedules;
+            const std::vector<Block*>& route = data.blocks;
+            const std::vector<Platform*>& platforms = data.platforms;
             for(iSchedule=schedules.begin(); iSchedule!=schedules.end(); iSchedule++)
             {
                 DailyTime startTime(iSchedule->startTime);
@@ -707,8 +779,8 @@ namespace sim_mob
     {
         TrainTrip* trainTrip = new TrainTrip();
         trainTrip->SetScheduledStatus(true);
-        std::vector<Block*> route;
-        getTrainRoute(lineId, route);
+        LineHandle line = getLineHandle(lineId);
+        const std::vector<Block*>& route = getBlocks(line);
         trainTrip->setLineId(lineId);
         int tripId = ++maxTripId;
         trainTrip->setTripId(tripId);
@@ -745,49 +817,14 @@ namespace sim_mob
     }
 
     template<typename PERSON>
-    std::vector<Platform*> TrainController<PERSON>::getPlatforms(std::string lineId,std::string startStation)
+    std::vector<Platform*> TrainController<PERSON>::getPlatforms(const std::string& lineId, const std::string& startStation) const
     {
         std::vector<Platform*> platforms;
-        if(mapOfIdvsStations.find(startStation) != mapOfIdvsStations.end())
+        std::map<std::string, Station*>::const_iterator it = mapOfIdvsStations.find(startStation);
+        if(it != mapOfIdvsStations.end() && it->second)
         {
-            Station *station = mapOfIdvsStations[startStation];
-            if(station)
-            {
-                const Platform *platform = station->getPlatform(lineId);
-                if(mapOfIdvsTrainPlatforms.find(lineId) != mapOfIdvsTrainPlatforms.end() )
-                {
-                    std::vector<TrainPlatform>& trainPlatforms = mapOfIdvsTrainPlatforms[lineId];
-                    std::vector<TrainPlatform>::const_iterator it = trainPlatforms.begin();
-                    if(it != trainPlatforms.end())
-                    {
-                        bool foundStartPlatform = false;
-                        while(it != trainPlatforms.end())
-                        {
-                            std::string platformNo=(*it).platformNo;
-                            if(boost::iequals(platformNo,platform->getPlatformNo()))
-                            {
-                                foundStartPlatform = true;
-                            }
-
-                            if(foundStartPlatform)
-                            {
-                                if(mapOfIdvsPlatforms.find(platformNo) != mapOfIdvsPlatforms.end())
-                                {
-                                    Platform *plt = mapOfIdvsPlatforms[platformNo];
-                                    platforms.push_back(plt);
-                                }
-                                else
-                                {
-                                    platforms.erase(platforms.begin(),platforms.end());
-                                    break;
-                                }
-                            }
-
-                            it++;
-                        }
-                    }
-                }
-            }
+            PlatformRange range = getPlatforms(getLineHandle(lineId), it->second->getPlatform(lineId));
+            platforms.assign(range.begin(), range.end());
         }
         return platforms;
     }
@@ -820,9 +857,9 @@ namespace sim_mob
     }
 
     template<typename PERSON>
-    TrainPlatform TrainController<PERSON>::getNextPlatform(std::string platformNo,std::string lineID)
+    TrainPlatform TrainController<PERSON>::getNextPlatform(const std::string& platformNo, const std::string& lineID) const
     {
-        std::vector<TrainPlatform>& trainPlatforms = mapOfIdvsTrainPlatforms[lineID];
+        const std::vector<TrainPlatform>& trainPlatforms = getLineData(getLineHandle(lineID)).trainPlatforms;
         typename std::vector<TrainPlatform>::const_iterator it = trainPlatforms.begin();
         while(it != trainPlatforms.end())
         {
@@ -840,17 +877,18 @@ namespace sim_mob
                 return (*it);
             }
         }
+        return TrainPlatform();
     }
 
     template<typename PERSON>
-    bool TrainController<PERSON>::isTerminalPlatform(std::string platformNo,std::string lineID)
+    bool TrainController<PERSON>::isTerminalPlatform(const std::string& platformNo, const std::string& lineID) const
     {
-        if(mapOfIdvsTrainPlatforms.find(lineID) == mapOfIdvsTrainPlatforms.end())
+        const std::vector<TrainPlatform>& trainPlatforms = getLineData(getLineHandle(lineID)).trainPlatforms;
+        if(trainPlatforms.empty())
         {
             return false;
         }
-        std::vector<TrainPlatform>& trainPlatforms = mapOfIdvsTrainPlatforms[lineID];
-        TrainPlatform endPlt = *(trainPlatforms.end()-1);
+        const TrainPlatform& endPlt = trainPlatforms.back();
         if(boost::iequals(platformNo,endPlt.platformNo) == true)
         {
             return true;
@@ -872,27 +910,9 @@ namespace sim_mob
     }
 
     template<typename PERSON>
-    std::vector<Block*> TrainController<PERSON>::getBlocks(std::string lineId)
+    std::vector<Block*> TrainController<PERSON>::getBlocks(const std::string& lineId) const
     {
-        std::map<std::string, std::vector<TrainRoute>>::const_iterator it = mapOfIdvsTrainRoutes.find(lineId);
-        std::vector<Block*> blockVector;
-
-        if(it==mapOfIdvsTrainRoutes.end())
-        {
-            //res = false;
-        }
-
-        else
-        {
-            const std::vector<TrainRoute>& trainRoute = it->second;
-            for(std::vector<TrainRoute>::const_iterator i = trainRoute.begin(); i != trainRoute.end(); i++)
-            {
-
-                std::map<unsigned int, Block*>::iterator iBlock = mapOfIdvsBlocks.find(i->blockId);
-                blockVector.push_back(iBlock->second);
-            }
-        }
-        return blockVector;
+        return getBlocks(getLineHandle(lineId));
     }
 
     template<typename PERSON>
@@ -904,38 +924,36 @@ namespace sim_mob
 
 
     template<typename PERSON>
-    std::vector<std::string> TrainController<PERSON>::getLinesBetweenTwoStations(std::string src,std::string dest)
+    std::vector<std::string> TrainController<PERSON>::getLinesBetweenTwoStations(const std::string& src, const std::string& dest) const
     {
-        typename std::map<std::string, std::vector<TrainRoute>>::const_iterator it = mapOfIdvsTrainRoutes.begin();
-        std::vector<std::string> lines;
-        while(it != mapOfIdvsTrainRoutes.end())
+        std::map<std::string, LineHandle>::const_iterator it = mapOfIdvsLineHandles.begin();
+        std::vector<std::string> lineIds;
+        while(it != mapOfIdvsLineHandles.end())
         {
-            const std::vector<TrainRoute>& route = it->second;
-            std::vector<TrainRoute> ::const_iterator tritr = route.begin();
+            const std::vector<Block*>& route = lines[it->second].blocks;
+            std::vector<Block*>::const_iterator tritr = route.begin();
             bool originFound=false;
             while(tritr != route.end())
             {
-                int blockId = (*tritr).blockId;
-                typename std::map<unsigned int, Block*>::const_iterator iBlock = mapOfIdvsBlocks.find(blockId);
-                Block *block = (iBlock)->second;
-                Platform *plt = block->getAttachedPlatform();
+                Platform *plt = (*tritr)->getAttachedPlatform();
                 if(plt)
                 {
-                    std::string stationNo = plt->getStationNo();
+                    const std::string& stationNo = plt->getStationNo();
                     if(boost::iequals(stationNo, src))
                     {
                         originFound=true;
                     }
                     else if(boost::iequals(stationNo, dest)&&originFound==true)
                     {
-                        lines.push_back((*tritr).lineId);
+                        lineIds.push_back(it->first);
                         break;
                     }
                 }
+                tritr++;
             }
             it++;
         }
-        return lines;
+        return lineIds;
     }
 
     template<typename PERSON>
@@ -959,11 +977,7 @@ namespace sim_mob
             route.lineId = lineId;
             route.blockId = r.get<int>(1);
             route.sequenceNo = r.get<int>(2);
-            if(mapOfIdvsTrainRoutes.find(lineId) == mapOfIdvsTrainRoutes.end())
-            {
-                mapOfIdvsTrainRoutes[lineId] = std::vector<TrainRoute>();
-            }
-            mapOfIdvsTrainRoutes[lineId].push_back(route);
+            lines[internLine(lineId)].trainRoutes.push_back(route);
             mapOfTrainServiceTerminated[lineId]=false;
             InitializeTrainIds(lineId);
         }
@@ -990,11 +1004,7 @@ namespace sim_mob
             platform.lineId = lineId;
             platform.platformNo = r.get<std::string>(1);
             platform.sequenceNo = r.get<int>(2);
-            if(mapOfIdvsTrainPlatforms.find(lineId)==mapOfIdvsTrainPlatforms.end())
-            {
-                mapOfIdvsTrainPlatforms[lineId] = std::vector<TrainPlatform>();
-            }
-            mapOfIdvsTrainPlatforms[lineId].push_back(platform);
+            lines[internLine(lineId)].trainPlatforms.push_back(platform);
         }
     }
 
@@ -1005,23 +1015,26 @@ namespace sim_mob
     }
 
     template<typename PERSON>
-    std::vector<std::string> TrainController<PERSON>::getPlatformsBetweenStations(std::string lineId,std::string startStation,std::string endStation)
+    std::vector<std::string> TrainController<PERSON>::getPlatformsBetweenStations(const std::string& lineId, const std::string& startStation, const std::string& endStation) const
     {
         std::vector<std::string> platforms;
-        if(mapOfIdvsStations.find(startStation) == mapOfIdvsStations.end() || mapOfIdvsStations.find(endStation) == mapOfIdvsStations.end())
+        std::map<std::string, Station*>::const_iterator itStart = mapOfIdvsStations.find(startStation);
+        std::map<std::string, Station*>::const_iterator itEnd = mapOfIdvsStations.find(endStation);
+        if(itStart == mapOfIdvsStations.end() || itEnd == mapOfIdvsStations.end())
         {
             return platforms;
         }
-        Station *station = mapOfIdvsStations[startStation];
-        Station *eStation = mapOfIdvsStations[endStation];
+        Station *station = itStart->second;
+        Station *eStation = itEnd->second;
 
         if(station&&eStation)
         {
             Platform *platform = station->getPlatform(lineId);
             Platform *endPlatform = eStation->getPlatform(lineId);
-            if(mapOfIdvsTrainPlatforms.find(lineId) != mapOfIdvsTrainPlatforms.end())
+            LineHandle line = getLineHandle(lineId);
+            if(line != INVALID_LINE)
             {
-                std::vector<TrainPlatform> &trainPlatforms = mapOfIdvsTrainPlatforms[lineId];
+                const std::vector<TrainPlatform> &trainPlatforms = lines[line].trainPlatforms;
                 std::vector<TrainPlatform>::const_iterator it = trainPlatforms.begin();
                 if(it != trainPlatforms.end())
                 {
@@ -1210,9 +1223,9 @@ namespace sim_mob
     Platform* TrainController<PERSON>::getPrePlatform(const std::string& lineId, const std::string& curPlatform)
     {
         Platform* platform = nullptr;
-        TrainController<PERSON>* self = TrainController<PERSON>::getInstance();
-        std::vector<Platform*> platforms;
-        if(self->getTrainPlatforms(lineId, platforms))
+        const LineData& data = getInstance()->getLineData(getInstance()->getLineHandle(lineId));
+        const std::vector<Platform*>& platforms = data.platforms;
+        if(data.platformsComplete)
         {
             std::vector<Platform*>::const_iterator it = platforms.begin();
             Platform* prev = nullptr;
@@ -1237,8 +1250,7 @@ namespace sim_mob
     template<typename PERSON>
     bool TrainController<PERSON>::isPlatformBeforeAnother(std::string firstPlatfrom ,std::string secondPlatform,std::string lineId)
     {
-        std::vector<Platform*> platforms;
-        getTrainPlatforms(lineId, platforms);
+        const std::vector<Platform*>& platforms = getTrainPlatforms(getLineHandle(lineId));
         bool foundFirstPlatfrom = false;
         std::vector<Platform*>::const_iterator it = platforms.begin();
         while(it != platforms.end())
@@ -1550,10 +1562,9 @@ namespace sim_mob
                 std::string endStation = (*it).endStation;
                 std::string lineId = (*it).line;
                 double speedLimit = (*it).speedLimit;
-                std::vector<Platform*> platforms;
-                getTrainPlatforms(lineId,platforms);
+                const std::vector<Platform*>& platforms = getTrainPlatforms(getLineHandle(lineId));
                 bool startSeq = false;
-                std::vector<Platform *>::iterator itpl;
+                std::vector<Platform *>::const_iterator itpl;
                 for(itpl = platforms.begin() ; itpl < platforms.end(); itpl++)
                 {
                     if(boost::iequals((*itpl)->getStationNo(), startStation))
@@ -1581,12 +1592,11 @@ namespace sim_mob
 
             else if((*it).endTime <= currentTime.getStrRepr())
             {
-                std::vector<Platform *>::iterator itpl;
+                std::vector<Platform *>::const_iterator itpl;
                 std::string startStation = (*it).startStation;
                 std::string endStation = (*it).endStation;
                 std::string lineId = (*it).line;
-                std::vector<Platform*> platforms;
-                getTrainPlatforms(lineId,platforms);
+                const std::vector<Platform*>& platforms = getTrainPlatforms(getLineHandle(lineId));
                 bool startSeq = false;
                 for(itpl = platforms.begin() ; itpl < platforms.end(); itpl++)
                 {
@@ -1677,10 +1687,9 @@ namespace sim_mob
                 std::string endStation = (*it).endStation;
                 std::string lineId = (*it).line;
                 double accLimit = (*it).accLimit;
-                std::vector<Platform*> platforms;
-                getTrainPlatforms(lineId,platforms);
+                const std::vector<Platform*>& platforms = getTrainPlatforms(getLineHandle(lineId));
                 bool startSeq=false;
-                std::vector<Platform *>::iterator itpl;
+                std::vector<Platform *>::const_iterator itpl;
                 for(itpl=platforms.begin() ; itpl < platforms.end(); itpl++)
                 {
                     if(boost::iequals((*itpl)->getStationNo(), startStation))
@@ -1706,12 +1715,11 @@ namespace sim_mob
 
             else if((*it).endTime<=currentTime.getStrRepr())
             {
-                std::vector<Platform *>::iterator itpl;
+                std::vector<Platform *>::const_iterator itpl;
                 std::string startStation = (*it).startStation;
                 std::string endStation = (*it).endStation;
                 std::string lineId = (*it).line;
-                std::vector<Platform*> platforms;
-                getTrainPlatforms(lineId,platforms);
+                const std::vector<Platform*>& platforms = getTrainPlatforms(getLineHandle(lineId));
                 bool startSeq=false;
                 for(itpl=platforms.begin() ; itpl < platforms.end(); itpl++)
                 {
@@ -6,6 +6,8 @@
 #include <string>
 #include <map>
 #include <type_traits>
+#include <limits>
+#include <boost/range/iterator_range.hpp>
 #include <boost/type_traits/is_base_of.hpp>
 #include <boost/static_assert.hpp>
 #include <boost/unordered_map.hpp>
@@ -174,6 +176,16 @@ public:
     virtual ~TrainController();
     typedef boost::unordered_map<const Station*, Agent*> StationAgentsMap;
 
+    /**
+     * Dense handle of a train line. Handles are assigned while loading the train network
+     * and index the per-line routes, platforms and schedules directly.
+     */
+    typedef unsigned int LineHandle;
+    static const LineHandle INVALID_LINE = std::numeric_limits<unsigned int>::max();
+
+    /** contiguous, read-only view over the platforms of a line */
+    typedef boost::iterator_range<std::vector<Platform*>::const_iterator> PlatformRange;
+
 public:
     /**
      * initialize the train controller
@@ -264,13 +276,75 @@ public:
      */
     bool getTrainPlatforms(const std::string& lineId, std::vector<Platform*>& platforms) const;
 
+    /**
+     * finds the handle of a line. The lookup costs a map search, so callers on hot paths
+     * should fetch the handle once and keep it.
+     * @param lineId is the id of the line
+     * @return the handle of the line, INVALID_LINE if the line is unknown
+     */
+    LineHandle getLineHandle(const std::string& lineId) const;
+
+    /**
+     * @param line is the handle of the line
+     * @return the id of the line, empty for INVALID_LINE
+     */
+    const std::string& getLineId(LineHandle line) const;
+
+    /**
+     * returns the blocks of a line's route. The route stops at the first block missing from the network.
+     * @param line is the handle of the line
+     * @return the blocks in route order, empty if the line is unknown
+     */
+    const std::vector<Block*>& getBlocks(LineHandle line) const;
+
+    /**
+     * returns the platforms of a line. The list stops at the first platform missing from the network.
+     * @param line is the handle of the line
+     * @return the platforms in route order, empty if the line is unknown
+     */
+    const std::vector<Platform*>& getTrainPlatforms(LineHandle line) const;
+
+    /**
+     * @param line is the handle of the line
+     * @return the dispatch schedules of the line
+     */
+    const std::vector<TrainSchedule>& getSchedules(LineHandle line) const;
+
+    /**
+     * returns the platforms of a line from a given platform up to the end of the line
+     * @param line is the handle of the line
+     * @param startPlatform is the first platform of the range
+     * @return the platforms from startPlatform (included), empty if startPlatform is not on the line
+     */
+    PlatformRange getPlatforms(LineHandle line, const Platform* startPlatform) const;
+
+    /**
+     * @param line is the handle of the line
+     * @param platform is a platform on the line
+     * @return the platform following the given one, nullptr at the end of the line
+     */
+    Platform* getNextPlatform(LineHandle line, const Platform* platform) const;
+
+    /**
+     * @param line is the handle of the line
+     * @param platform is a platform on the line
+     * @return true if platform is the last platform of the line
+     */
+    bool isTerminalPlatform(LineHandle line, const Platform* platform) const;
+
+    /**
+     * @param line is the handle of the line
+     * @return the handle of the line running in the opposite direction, INVALID_LINE if there is none
+     */
+    LineHandle getOppositeLine(LineHandle line) const;
+
     /**
      * returns the train lines connecting the two stations directly
      * @param src is the name of the start staion
      * @param dest is the name of end station
      * @return the lines present the stations
      */
-    std::vector<std::string> getLinesBetweenTwoStations(std::string src,std::string dest);
+    std::vector<std::string> getLinesBetweenTwoStations(const std::string& src, const std::string& dest) const;
 
     /**
      * returns the active trains in a particular line
@@ -285,7 +359,7 @@ public:
      * @param platformNo is the name of the platform
      * @return the next platform after the one specified
      */
-    TrainPlatform  getNextPlatform(std::string platformNo,std::string lineId);
+    TrainPlatform getNextPlatform(const std::string& platformNo, const std::string& lineId) const;
 
     /**
      * Returns the platform of a particular station of a particular line
@@ -323,7 +397,7 @@ public:
      * @param lineId is the id of the line
      * @return the vector of blocks
      */
-    std::vector<Block*> getBlocks(std::string lineId);
+    std::vector<Block*> getBlocks(const std::string& lineId) const;
 
     /**
      * get station entity from stationId
@@ -344,7 +418,7 @@ public:
      * @param lineId is the id of the line specified
      * @param the opposite line id required
      */
-    std::string getOppositeLineId(std::string lineId);
+    std::string getOppositeLineId(const std::string& lineId) const;
 
     /**
      * This returns the block from block id
@@ -407,7 +481,7 @@ public:
      * @param lineId is the id of the line
      * @return the minimum dwell time
      */
-    double getMinDwellTime(std::string stationNo,std::string lineId) const;
+    double getMinDwellTime(const std::string& stationNo, const std::string& lineId) const;
 
     /* Returns the maximum dwell time of a train irrespective of type of station
      * For any station it is 120 secs
@@ -421,7 +495,7 @@ public:
      * @param platform is the pointer to the platform of the station
      * @return true if it is the first platform
      */
-    bool isFirstStation(std::string lineId,Platform *platform) const;
+    bool isFirstStation(const std::string& lineId, const Platform *platform) const;
 
     /*
      * This terminated the train service for entire train line
@@ -438,7 +512,7 @@ public:
      * @param startStaion is the name of the station from where the platforms along the line are needed
      * @return the vector of platforms from the start station
      */
-    std::vector<Platform*> getPlatforms(std::string lineId,std::string startStation);
+    std::vector<Platform*> getPlatforms(const std::string& lineId, const std::string& startStation) const;
 
     /**
      * composes unscheduled train trip at a particular time stamp ,for a particular line
@@ -491,7 +565,7 @@ public:
      * @param endStaion is the name of endStation
      * @return the platforms between the two stationss
      */
-    std::vector<std::string> getPlatformsBetweenStations(std::string lineId,std::string startStation,std::string endStation);
+    std::vector<std::string> getPlatformsBetweenStations(const std::string& lineId, const std::string& startStation, const std::string& endStation) const;
 
     /**
      * checks if one platform is another
@@ -580,7 +654,7 @@ public:
      * @param lineId is the id of the line
      * @return bool true if it is the last platform
      */
-    bool isTerminalPlatform(std::string platformNo,std::string lineId);
+    bool isTerminalPlatform(const std::string& platformNo, const std::string& lineId) const;
     
     /**
      * Handles the return of train id after the completion of trip to train controller
@@ -684,6 +758,18 @@ private:
      */
     void loadTrainLineProperties();
 
+    /**
+     * returns the handle of a line, registering the line if it was not seen yet.
+     * Only used while loading the network.
+     * @param lineId is the id of the line
+     */
+    LineHandle internLine(const std::string& lineId);
+
+    /**
+     * resolves the block and platform ids of every line's route into pointers
+     */
+    void resolveLines();
+
     /**
      * the function to load transfered time between platforms from DB
      */
@@ -727,6 +813,35 @@ private:
      */
     int getTrainId(const std::string& lineId);
 
+    /**
+     * per line data, indexed by line handle
+     */
+    struct LineData
+    {
+        LineData() : opposite(INVALID_LINE), routeComplete(false), platformsComplete(false)
+        {
+        }
+        std::string lineId;
+        /**route and platform records as loaded from DB*/
+        std::vector<TrainRoute> trainRoutes;
+        std::vector<TrainPlatform> trainPlatforms;
+        std::vector<TrainSchedule> schedules;
+        /**resolved route and platforms*/
+        std::vector<Block*> blocks;
+        std::vector<Platform*> platforms;
+        /**position of each platform in platforms*/
+        boost::unordered_map<const Platform*, std::size_t> platformIndex;
+        LineHandle opposite;
+        /**false if a block (platform) of the line could not be found*/
+        bool routeComplete;
+        bool platformsComplete;
+    };
+
+    /**
+     * @return the data of a line, or an empty record if the handle is invalid
+     */
+    const LineData& getLineData(LineHandle line) const;
+
 private:
     /**recording disruption information*/
     boost::shared_ptr<DisruptionParams> disruptionParam;
@@ -736,12 +851,12 @@ private:
     std::map<std::string, Platform*> mapOfIdvsPlatforms;
     /**the map from id to the object of block*/
     std::map<unsigned int, Block*> mapOfIdvsBlocks;
-    /**the map from line id to the train route*/
-    std::map<std::string, std::vector<TrainRoute>> mapOfIdvsTrainRoutes;
-    /**the map from line id to the train platform*/
-    std::map<std::string, std::vector<TrainPlatform>> mapOfIdvsTrainPlatforms;
-    /**the map from id to the schedule table*/
-    std::map<std::string, std::vector<TrainSchedule>> mapOfIdvsSchedules;
+    /**the map from line id to line handle*/
+    std::map<std::string, LineHandle> mapOfIdvsLineHandles;
+    /**routes, platforms and schedules of each line, indexed by line handle*/
+    std::vector<LineData> lines;
+    /**returned for unknown lines*/
+    LineData emptyLine;
     /**the map from id to trip*/
     std::map<std::string, TripStartTimePriorityQueue> mapOfIdvsTrip;
     std::map<std::string,std::vector<TrainTrip*>> mapOfIdvsUnsheduledTrips;
@@ -777,8 +892,6 @@ private:
     mutable boost::mutex terminatedTrainServiceLock;
     /** map which holds the ids range for train lines*/
     std::map<std::string,std::list<int>> mapOfTrainMaxMinIds;
-    /** map which holds the opposite pairs of train lines eg "NE_1,NE_2","EW_1,EW_2"*/
-    std::map<std::string,std::string> mapOfOppositeLines;
     /** map which holds the uturn platforms for evry train line */
     std::map<std::string,std::vector<std::string>> mapOfUturnPlatformsLines;
     std::map<const Station*,std::map<const Platform*,std::vector<double>>> mapOfCoefficientsOfNumberOfPersons;
@@ -1,15 +1,21 @@
 #include "TravelTimeManager.hpp"
 #include "path/PathSetManager.hpp"
 #include "path/SOCI_Converters.hpp"
+#include <algorithm>
 #include <boost/filesystem.hpp>
 #include <boost/foreach.hpp>
 #include <map>
+#include <set>
 #include <sstream>
 #include "conf/ConfigManager.hpp"
 #include "conf/ConfigParams.hpp"
+#include "logging/Log.hpp"
 #include "path/PathSetManager.hpp"
 #include "util/LangHelpers.hpp"
+#include "geospatial/network/Link.hpp"
 #include "geospatial/network/Node.hpp"
+#include "geospatial/network/RoadNetwork.hpp"
+#include "geospatial/network/RoadSegment.hpp"
 #include "geospatial/network/TurningGroup.hpp"
 
 using namespace sim_mob;
@@ -46,164 +52,41 @@ unsigned int getTimeInterval(unsigned long time)
     return time / TT_STORAGE_TIME_INTERVAL_WIDTH ;/*milliseconds*/
 }
 
-} //anonymous namespace
-
-sim_mob::TravelTimeManager* sim_mob::TravelTimeManager::instance = nullptr;
-
-sim_mob::LinkTravelTime::LinkTravelTime() : linkId(0), defaultTravelTime(0.0)
-{
-}
+/** number of bits used by the segment slot and the travel mode id in a segment travel time key */
+const unsigned int SEGMENT_SLOT_BITS = 32;
+const unsigned int TRAVEL_MODE_BITS = 6;
 
-sim_mob::LinkTravelTime::~LinkTravelTime()
-{
-}
-
-sim_mob::LinkTravelTime& sim_mob::LinkTravelTime::operator=(const sim_mob::LinkTravelTime& rhs)
-{
-    linkId = rhs.linkId;
-    defaultTravelTime = rhs.defaultTravelTime;
-    return *this;
-}
-
-void sim_mob::LinkTravelTime::addHistoricalTravelTime(const DailyTime& dt, unsigned int downstreamLinkId, double travelTime)
+/**
+ * packs (time interval, travel mode id, segment slot) into one key, so that sorting keys orders segment travel times
+ * by interval, then mode, then segment
+ */
+unsigned long long getSegmentKey(unsigned int interval, unsigned int modeId, unsigned int segmentSlot)
 {
-    TimeInterval timeInterval = getTimeInterval(dt);
-    historicalTT_Map[timeInterval][downstreamLinkId] = travelTime;
+    return ((unsigned long long) interval << (SEGMENT_SLOT_BITS + TRAVEL_MODE_BITS))
+            | ((unsigned long long) modeId << SEGMENT_SLOT_BITS) | segmentSlot;
 }
 
-void sim_mob::LinkTravelTime::addInSimulationTravelTime(const LinkTravelStats& stats)
-{
-    TimeInterval timeInterval = getTimeInterval(stats.entryTime * 1000); //milliseconds
-    if(stats.downstreamLink)
-    {
-        boost::upgrade_lock<boost::shared_mutex> lock(ttMapMutex);
-        boost::upgrade_to_unique_lock<boost::shared_mutex> uniquelock(lock);
-        TimeAndCount& tc = currentSimulationTT_Map[timeInterval][stats.downstreamLink->getLinkId()];
-        tc.totalTravelTime += stats.travelTime; //add to total travel time
-        tc.travelTimeCnt += 1; //increment the total contribution
-    }
-    else
-    {
-        //since the downstream link is not specified, the travel time contribution will have to go to all downstream links of this link
-        const Node* toNode = stats.link->getToNode();
-        const std::map<unsigned int, TurningGroup *>& turnGroupsFromLnk = toNode->getTurningGroups(stats.link->getLinkId());
-
-        {   //new scope for lock
-            boost::upgrade_lock<boost::shared_mutex> lock(ttMapMutex);
-            boost::upgrade_to_unique_lock<boost::shared_mutex> uniquelock(lock);
-            DownStreamLinkSpecificTimeAndCount_Map& tcMap = currentSimulationTT_Map[timeInterval];
-            for(std::map<unsigned int, TurningGroup *>::const_iterator downStrmLnkIt=turnGroupsFromLnk.begin(); downStrmLnkIt!=turnGroupsFromLnk.end(); downStrmLnkIt++)
-            {
-                TimeAndCount& tc = tcMap[downStrmLnkIt->first];
-                tc.totalTravelTime += stats.travelTime;
-                tc.travelTimeCnt += 1; //increment the total contribution
-            }
-        }
-    }
-}
+} //anonymous namespace
 
-double sim_mob::LinkTravelTime::getHistoricalLinkTT(unsigned int downstreamLinkId, const DailyTime& dt) const
-{
-    TimeInterval timeInterval = getTimeInterval(dt.getValue());
-    TravelTimeStore::const_iterator ttMapIt = historicalTT_Map.find(timeInterval);
-    if(ttMapIt == historicalTT_Map.end())
-    {
-        return -1;
-    }
-    const DownStreamLinkSpecificTT_Map& ttInnerMap = ttMapIt->second;
-    DownStreamLinkSpecificTT_Map::const_iterator ttInnerMapIt = ttInnerMap.find(downstreamLinkId);
-    if(ttInnerMapIt == ttInnerMap.end())
-    {
-        return -1;
-    }
-    return ttInnerMapIt->second;
-}
+const unsigned int sim_mob::TravelTimeManager::NO_SLOT;
+const unsigned int sim_mob::TravelTimeManager::MAX_TRAVEL_MODES;
 
-double sim_mob::LinkTravelTime::getHistoricalLinkTT(const DailyTime& dt) const
-{
-    TimeInterval timeInterval = getTimeInterval(dt);
-    TravelTimeStore::const_iterator ttMapIt = historicalTT_Map.find(timeInterval);
-    if(ttMapIt == historicalTT_Map.end())
-    {
-        return -1;
-    }
-    const DownStreamLinkSpecificTT_Map& ttInnerMap = ttMapIt->second;
-    if(ttInnerMap.empty())
-    {
-        return -1;
-    }
-    double totalTT = 0.0;
-    for(DownStreamLinkSpecificTT_Map::const_iterator ttInnerMapIt=ttInnerMap.begin(); ttInnerMapIt!=ttInnerMap.end(); ttInnerMapIt++)
-    {
-        totalTT = totalTT + ttInnerMapIt->second;
-    }
-    return (totalTT/ttInnerMap.size());
-}
+sim_mob::TravelTimeManager* sim_mob::TravelTimeManager::instance = nullptr;
 
-double sim_mob::LinkTravelTime::getInSimulationLinkTT(unsigned int downstreamLinkId, const DailyTime& dt) const
+sim_mob::LinkTravelTime::LinkTravelTime() : linkId(0), defaultTravelTime(0.0)
 {
-    TimeInterval timeInterval = getTimeInterval(dt.getValue());
-    
-    //No in-simulation times present for previous interval
-    if(timeInterval == 0)
-    {
-        return -1;
-    }
-    
-    //We need to look for travel times in the previous interval
-    timeInterval -= 1;
-    
-    TimeAndCountStore::const_iterator tcIt = currentSimulationTT_Map.find(timeInterval);
-    
-    if(tcIt != currentSimulationTT_Map.end())
-    {
-        const DownStreamLinkSpecificTimeAndCount_Map &tcMap = tcIt->second;
-        DownStreamLinkSpecificTimeAndCount_Map::const_iterator tcMapIt = tcMap.find(downstreamLinkId);
-        
-        if(tcMapIt != tcMap.end())
-        {
-            return tcMapIt->second.getTravelTime();
-        }
-        else
-        {
-            return -1;
-        }
-    }
-    else        
-    {
-        return -1;
-    }
-    
-    return -1;
 }
 
-void sim_mob::LinkTravelTime::dumpTravelTimesToFile(const std::string fileName) const
+sim_mob::LinkTravelTime::~LinkTravelTime()
 {
-    //  destination file
-    sim_mob::BasicLogger& ttLogger  = sim_mob::Logger::log(fileName);
-    // config interval(in seconds)
-    int intervalSec = sim_mob::ConfigManager::GetInstance().FullConfig().getPathSetConf().interval;
-    const DailyTime& simStartTime = sim_mob::ConfigManager::GetInstance().FullConfig().simStartTime();
-    for(TimeAndCountStore::const_iterator tcIt=currentSimulationTT_Map.begin(); tcIt!=currentSimulationTT_Map.end(); tcIt++)
-    {
-        const TimeInterval timeInterval = tcIt->first;
-        const DownStreamLinkSpecificTimeAndCount_Map& tcMap = tcIt->second;
-        for(DownStreamLinkSpecificTimeAndCount_Map::const_iterator tcMapIt=tcMap.begin(); tcMapIt!=tcMap.end(); tcMapIt++)
-        {
-            unsigned int downstreamLinkId = tcMapIt->first;
-            const TimeAndCount& tc = tcMapIt->second;
-            DailyTime startTime(simStartTime.getValue() +  (timeInterval* TT_STORAGE_TIME_INTERVAL_WIDTH) );
-            DailyTime endTime(simStartTime.getValue() + ((timeInterval + 1) * TT_STORAGE_TIME_INTERVAL_WIDTH - 1000) );
-            ttLogger << linkId << ";" << downstreamLinkId << ";" << startTime.getStrRepr() << ";" << endTime.getStrRepr() << ";" << tc.getTravelTime() <<  "\n";
-        }
-    }
 }
 
 sim_mob::TravelTimeManager::TravelTimeManager()
     : intervalMS(sim_mob::ConfigManager::GetInstance().FullConfig().getPathSetConf().interval * 1000), //conversion from seconds to milliseconds
       enRouteTT(new sim_mob::TravelTimeManager::EnRouteTT(*this)),
       odIntervalMS(sim_mob::ConfigManager::GetInstance().FullConfig().odTTConfig.intervalMS),
-      segIntervalMS(sim_mob::ConfigManager::GetInstance().FullConfig().rsTTConfig.intervalMS)
+      segIntervalMS(sim_mob::ConfigManager::GetInstance().FullConfig().rsTTConfig.intervalMS),
+      numHistoricalIntervals(0), lastLinkMergeInterval(0), lastSegmentMergeInterval(0), mergeRequested(false), numTravelModes(0)
 {}
 
 sim_mob::TravelTimeManager::~TravelTimeManager()
@@ -227,20 +110,58 @@ void sim_mob::TravelTimeManager::loadLinkDefaultTravelTime(soci::session& sql)
     std::string query = "select link_id, to_char(start_time,'HH24:MI:SS') AS start_time, to_char(end_time,'HH24:MI:SS') AS end_time, travel_time from " + defaultTT_TableName;
     soci::rowset<sim_mob::LinkTravelTime> rs = sql.prepare << query;
 
+    std::map<unsigned int, sim_mob::LinkTravelTime> lnkTravelTimeMap;
     for (soci::rowset<sim_mob::LinkTravelTime>::iterator lttIt = rs.begin(); lttIt != rs.end(); ++lttIt)
     {
         lnkTravelTimeMap[lttIt->getLinkId()] = *lttIt;
     }
+
+    //slots are assigned in the order of link ids
+    linkSlots.clear();
+    linkDefaultTT.clear();
+    linkDefaultTT.reserve(lnkTravelTimeMap.size());
+    for (std::map<unsigned int, sim_mob::LinkTravelTime>::const_iterator lttIt = lnkTravelTimeMap.begin(); lttIt != lnkTravelTimeMap.end(); ++lttIt)
+    {
+        linkSlots[lttIt->first] = linkDefaultTT.size();
+        linkDefaultTT.push_back(lttIt->second);
+    }
 }
 
 void sim_mob::TravelTimeManager::loadLinkHistoricalTravelTime(soci::session& sql)
 {
+    struct HistoricalTT
+    {
+        unsigned int linkSlot;
+        unsigned int downstreamLinkId;
+        unsigned int interval;
+        double travelTime;
+    };
+
     const sim_mob::ConfigParams& cfg = ConfigManager::GetInstance().FullConfig();
-    TT_STORAGE_TIME_INTERVAL_WIDTH = cfg.getPathSetConf().interval * 1000; // initialize to proper interval from config
+    setTimeIntervalWidth(cfg.getPathSetConf().interval * 1000); // initialize to proper interval from config
     historicalTT_TableName = sim_mob::ConfigManager::GetInstance().PathSetConfig().RTTT_Conf;
     std::string query = "select link_id, downstream_link_id, to_char(start_time,'HH24:MI:SS') AS start_time, to_char(end_time,'HH24:MI:SS') AS end_time,"
             "travel_time from " + historicalTT_TableName + " order by link_id, downstream_link_id";
+
+    //downstream links of each link slot: those of the turning groups in the network and those found in the table
+    std::vector< std::set<unsigned int> > downstreamLinks(linkDefaultTT.size());
+    const std::map<unsigned int, Link *>& networkLinks = RoadNetwork::getInstance()->getMapOfIdVsLinks();
+    for (size_t linkSlot = 0; linkSlot < linkDefaultTT.size(); ++linkSlot)
+    {
+        std::map<unsigned int, Link *>::const_iterator lnkIt = networkLinks.find(linkDefaultTT[linkSlot].getLinkId());
+        if (lnkIt != networkLinks.end())
+        {
+            const std::map<unsigned int, TurningGroup *>& turnGroups = lnkIt->second->getToNode()->getTurningGroups(lnkIt->first);
+            for (std::map<unsigned int, TurningGroup *>::const_iterator tgIt = turnGroups.begin(); tgIt != turnGroups.end(); ++tgIt)
+            {
+                downstreamLinks[linkSlot].insert(tgIt->first);
+            }
+        }
+    }
+
     //main loop
+    std::vector<HistoricalTT> records;
+    numHistoricalIntervals = 0;
     soci::rowset<soci::row> rs = (sql.prepare << query);
     for (soci::rowset<soci::row>::const_iterator it = rs.begin(); it != rs.end(); ++it)
     {
@@ -259,28 +180,143 @@ void sim_mob::TravelTimeManager::loadLinkHistoricalTravelTime(soci::session& sql
         }
 
         //store data
-        std::map<unsigned int, sim_mob::LinkTravelTime>::iterator lttIt = lnkTravelTimeMap.find(linkId); // must have an entry for all link ids after loading default travel times
-        if (lttIt == lnkTravelTimeMap.end())
+        unsigned int linkSlot = getLinkSlot(linkId); // must have a slot for all link ids after loading default travel times
+        if (linkSlot == NO_SLOT)
         {
             throw std::runtime_error("linkId specified in historical travel time table does not have a default travel time");
         }
-        LinkTravelTime& lnkTT = lttIt->second;
-        lnkTT.addHistoricalTravelTime(startTime, downstreamLinkId, travelTime);
+        HistoricalTT record = { linkSlot, downstreamLinkId, getTimeInterval(startTime), travelTime };
+        records.push_back(record);
+        downstreamLinks[linkSlot].insert(downstreamLinkId);
+        numHistoricalIntervals = std::max(numHistoricalIntervals, record.interval + 1);
     }
 
+    //turn slots are contiguous for each link and ordered by downstream link id
+    turnOffsets.assign(1, 0);
+    turnDownstreamLinks.clear();
+    for (size_t linkSlot = 0; linkSlot < downstreamLinks.size(); ++linkSlot)
+    {
+        turnDownstreamLinks.insert(turnDownstreamLinks.end(), downstreamLinks[linkSlot].begin(), downstreamLinks[linkSlot].end());
+        turnOffsets.push_back(turnDownstreamLinks.size());
+    }
+
+    const size_t numLinks = linkDefaultTT.size();
+    const size_t numTurns = turnDownstreamLinks.size();
+    historicalTurnTT.assign(numHistoricalIntervals * numTurns, -1);
+    for (std::vector<HistoricalTT>::const_iterator it = records.begin(); it != records.end(); ++it)
+    {
+        historicalTurnTT[it->interval * numTurns + getTurnSlot(it->linkSlot, it->downstreamLinkId)] = it->travelTime;
+    }
+
+    //travel time of each link averaged over the downstream links having a historical travel time
+    historicalLinkTT.assign(numHistoricalIntervals * numLinks, -1);
+    for (unsigned int interval = 0; interval < numHistoricalIntervals; ++interval)
+    {
+        const double* turnTT = &historicalTurnTT[interval * numTurns];
+        for (size_t linkSlot = 0; linkSlot < numLinks; ++linkSlot)
+        {
+            double totalTT = 0.0;
+            unsigned int count = 0;
+            for (unsigned int turnSlot = turnOffsets[linkSlot]; turnSlot < turnOffsets[linkSlot + 1]; ++turnSlot)
+            {
+                if (turnTT[turnSlot] != -1)
+                {
+                    totalTT += turnTT[turnSlot];
+                    ++count;
+                }
+            }
+            if (count > 0)
+            {
+                historicalLinkTT[interval * numLinks + linkSlot] = totalTT / count;
+            }
+        }
+    }
+}
+
+void sim_mob::TravelTimeManager::setTimeIntervalWidth(unsigned int widthMS)
+{
+    TT_STORAGE_TIME_INTERVAL_WIDTH = widthMS;
+}
+
+boost::shared_ptr<const sim_mob::TravelTimeManager::InSimulationTT> sim_mob::TravelTimeManager::getPublishedTT() const
+{
+    return boost::atomic_load(&publishedTT);
+}
+
+unsigned int sim_mob::TravelTimeManager::getLinkSlot(unsigned int linkId) const
+{
+    boost::unordered_map<unsigned int, unsigned int>::const_iterator it = linkSlots.find(linkId);
+    return (it != linkSlots.end()) ? it->second : NO_SLOT;
+}
+
+unsigned int sim_mob::TravelTimeManager::getTurnSlot(unsigned int linkSlot, unsigned int downstreamLinkId) const
+{
+    if (linkSlot + 1 >= turnOffsets.size())
+    {
+        return NO_SLOT;
+    }
+    std::vector<unsigned int>::const_iterator first = turnDownstreamLinks.begin() + turnOffsets[linkSlot];
+    std::vector<unsigned int>::const_iterator last = turnDownstreamLinks.begin() + turnOffsets[linkSlot + 1];
+    std::vector<unsigned int>::const_iterator it = std::lower_bound(first, last, downstreamLinkId);
+    if (it == last || *it != downstreamLinkId)
+    {
+        return NO_SLOT;
+    }
+    return it - turnDownstreamLinks.begin();
+}
+
+double sim_mob::TravelTimeManager::getHistoricalTurnTT(unsigned int turnSlot, const DailyTime& dt) const
+{
+    unsigned int interval = getTimeInterval(dt);
+    if (interval >= numHistoricalIntervals)
+    {
+        return -1;
+    }
+    return historicalTurnTT[interval * turnDownstreamLinks.size() + turnSlot];
+}
+
+double sim_mob::TravelTimeManager::getHistoricalLinkTT(unsigned int linkSlot, const DailyTime& dt) const
+{
+    unsigned int interval = getTimeInterval(dt);
+    if (interval >= numHistoricalIntervals)
+    {
+        return -1;
+    }
+    return historicalLinkTT[interval * linkDefaultTT.size() + linkSlot];
+}
+
+double sim_mob::TravelTimeManager::getInSimulationTurnTT(unsigned int turnSlot, const DailyTime& dt) const
+{
+    unsigned int interval = getTimeInterval(dt);
+
+    //No in-simulation times present for previous interval
+    if (interval == 0)
+    {
+        return -1;
+    }
+
+    //We need to look for travel times in the previous interval
+    interval -= 1;
+
+    boost::shared_ptr<const InSimulationTT> snapshot = getPublishedTT();
+    if (!snapshot || interval >= snapshot->intervals.size() || !snapshot->intervals[interval])
+    {
+        return -1;
+    }
+    double travelTime = (*snapshot->intervals[interval])[turnSlot];
+    return (travelTime > 0.0) ? travelTime : -1;
 }
 
 double sim_mob::TravelTimeManager::getDefaultLinkTT(const Link* lnk) const
 {
-    std::map<unsigned int, sim_mob::LinkTravelTime>::const_iterator it = lnkTravelTimeMap.find(lnk->getLinkId());
-    if (it == lnkTravelTimeMap.end())
+    unsigned int linkSlot = getLinkSlot(lnk->getLinkId());
+    if (linkSlot == NO_SLOT)
     {
         std::stringstream out;
         out << "NO default TT FOR : " << lnk->getLinkId() << "\n";
         throw std::runtime_error(out.str());
     }
-    const LinkTravelTime& lnkTT = it->second;
-    return lnkTT.getDefaultTravelTime();
+    return linkDefaultTT[linkSlot].getDefaultTravelTime();
 }
 
 double sim_mob::TravelTimeManager::getLinkTT(const sim_mob::Link* lnk, const sim_mob::DailyTime& startTime, const sim_mob::Link* downstreamLink, 
@@ -306,50 +342,210 @@ double sim_mob::TravelTimeManager::getLinkTT(const sim_mob::Link* lnk, const sim
         }
     }
 
-    std::map<unsigned int, sim_mob::LinkTravelTime>::const_iterator it = lnkTravelTimeMap.find(lnk->getLinkId());
-    if (it == lnkTravelTimeMap.end())
+    unsigned int linkSlot = getLinkSlot(lnk->getLinkId());
+    if (linkSlot == NO_SLOT)
     {
         std::stringstream out;
         out << "NO TT FOR : " << lnk->getLinkId() << "\n";
         throw std::runtime_error(out.str());
     }
-    const LinkTravelTime& lnkTT = it->second;
     double res = 0;
     if(downstreamLink)
     {
-        if(useInSimulationTT)
-        {
-            res = lnkTT.getInSimulationLinkTT(downstreamLink->getLinkId(), startTime);
-        }       
-        
-        if(res <= 0.0)
+        unsigned int turnSlot = getTurnSlot(linkSlot, downstreamLink->getLinkId());
+        if(turnSlot != NO_SLOT)
         {
-            res = lnkTT.getHistoricalLinkTT(downstreamLink->getLinkId(), startTime);
+            if(useInSimulationTT)
+            {
+                res = getInSimulationTurnTT(turnSlot, startTime);
+            }
+
+            if(res <= 0.0)
+            {
+                res = getHistoricalTurnTT(turnSlot, startTime);
+            }
         }
     }
     else
     {
-        res = lnkTT.getHistoricalLinkTT(startTime);
+        res = getHistoricalLinkTT(linkSlot, startTime);
     }
 
     if (res <= 0.0)
     {
         //check default if travel time is not found
-        res = lnkTT.getDefaultTravelTime();
+        res = linkDefaultTT[linkSlot].getDefaultTravelTime();
     }
     return res;
 }
 
+sim_mob::TravelTimeManager::ThreadAccumulator& sim_mob::TravelTimeManager::getLocalAccumulator()
+{
+    boost::shared_ptr<ThreadAccumulator>* accumulator = localAccumulator.get();
+    if (!accumulator)
+    {
+        //the accumulator outlives the thread in threadAccumulators; only this thread's reference is released on exit
+        accumulator = new boost::shared_ptr<ThreadAccumulator>(new ThreadAccumulator());
+        {
+            boost::mutex::scoped_lock lock(accumulatorsMutex);
+            threadAccumulators.push_back(*accumulator);
+        }
+        localAccumulator.reset(accumulator);
+    }
+    return **accumulator;
+}
+
+void sim_mob::TravelTimeManager::tryMerge(std::atomic<unsigned int>& lastInterval, unsigned int interval)
+{
+    if (interval <= lastInterval.load())
+    {
+        return;
+    }
+
+    //a thread which finds a merge in progress leaves the request to the merging thread. That thread checks for
+    //requests after releasing the lock, so either it merges again or a later try_lock succeeds.
+    mergeRequested.store(true);
+    do
+    {
+        boost::mutex::scoped_try_lock lock(mergeMutex);
+        if (!lock.owns_lock())
+        {
+            return;
+        }
+        while (mergeRequested.exchange(false))
+        {
+            mergeAccumulators();
+        }
+        if (interval > lastInterval.load())
+        {
+            lastInterval.store(interval);
+        }
+    }
+    while (mergeRequested.load());
+}
+
+void sim_mob::TravelTimeManager::mergeAccumulators()
+{
+    std::vector<LinkTT_Record> linkRecords;
+    std::vector<SegmentTT_Record> segmentRecords;
+    {
+        boost::mutex::scoped_lock lock(accumulatorsMutex);
+        for (std::vector< boost::shared_ptr<ThreadAccumulator> >::iterator it = threadAccumulators.begin(); it != threadAccumulators.end(); ++it)
+        {
+            ThreadAccumulator& accumulator = **it;
+            boost::mutex::scoped_lock accumulatorLock(accumulator.mtx);
+            linkRecords.insert(linkRecords.end(), accumulator.linkRecords.begin(), accumulator.linkRecords.end());
+            segmentRecords.insert(segmentRecords.end(), accumulator.segmentRecords.begin(), accumulator.segmentRecords.end());
+            accumulator.linkRecords.clear();
+            accumulator.segmentRecords.clear();
+        }
+    }
+
+    //link travel times
+    const size_t numTurns = turnDownstreamLinks.size();
+    std::set<unsigned int> updatedIntervals;
+    for (std::vector<LinkTT_Record>::const_iterator it = linkRecords.begin(); it != linkRecords.end(); ++it)
+    {
+        if (it->turnSlot == NO_SLOT && it->downstreamLinkId != 0)
+        {
+            std::pair<unsigned int, unsigned int> turn(linkDefaultTT[it->linkSlot].getLinkId(), it->downstreamLinkId);
+            std::map<unsigned int, TimeAndCount>& turnTT = unconnectedTurnTT[turn];
+            if (turnTT.empty())
+            {
+                sim_mob::Warn() << "Travel time recorded from link " << turn.first << " to link " << turn.second
+                                << ", which are not connected in the network or the historical travel times\n";
+            }
+            TimeAndCount& tc = turnTT[it->interval];
+            tc.totalTravelTime += it->travelTime;
+            tc.travelTimeCnt += 1;
+            continue;
+        }
+
+        if (it->interval >= inSimulationTT.size())
+        {
+            inSimulationTT.resize(it->interval + 1);
+        }
+        std::vector<TimeAndCount>& intervalTT = inSimulationTT[it->interval];
+        if (intervalTT.empty())
+        {
+            intervalTT.resize(numTurns);
+        }
+
+        //without a downstream link, the travel time contribution goes to all downstream links of the link
+        unsigned int firstTurn = it->turnSlot;
+        unsigned int lastTurn = it->turnSlot + 1;
+        if (it->turnSlot == NO_SLOT)
+        {
+            firstTurn = turnOffsets[it->linkSlot];
+            lastTurn = turnOffsets[it->linkSlot + 1];
+        }
+        for (unsigned int turnSlot = firstTurn; turnSlot < lastTurn; ++turnSlot)
+        {
+            TimeAndCount& tc = intervalTT[turnSlot];
+            tc.totalTravelTime += it->travelTime; //add to total travel time
+            tc.travelTimeCnt += 1; //increment the total contribution
+        }
+        updatedIntervals.insert(it->interval);
+    }
+
+    if (!updatedIntervals.empty())
+    {
+        //the new snapshot shares the travel times of the intervals which were not updated
+        boost::shared_ptr<InSimulationTT> snapshot(new InSimulationTT());
+        boost::shared_ptr<const InSimulationTT> current = getPublishedTT();
+        if (current)
+        {
+            snapshot->intervals = current->intervals;
+        }
+        snapshot->intervals.resize(inSimulationTT.size());
+        for (std::set<unsigned int>::const_iterator it = updatedIntervals.begin(); it != updatedIntervals.end(); ++it)
+        {
+            const std::vector<TimeAndCount>& intervalTT = inSimulationTT[*it];
+            std::vector<double>* travelTimes = new std::vector<double>(intervalTT.size());
+            for (size_t turnSlot = 0; turnSlot < intervalTT.size(); ++turnSlot)
+            {
+                (*travelTimes)[turnSlot] = intervalTT[turnSlot].getTravelTime();
+            }
+            snapshot->intervals[*it].reset(travelTimes);
+        }
+        boost::atomic_store(&publishedTT, boost::shared_ptr<const InSimulationTT>(snapshot));
+    }
+
+    //segment travel times
+    for (std::vector<SegmentTT_Record>::const_iterator it = segmentRecords.begin(); it != segmentRecords.end(); ++it)
+    {
+        TimeAndCount& timeAndCount = segmentTravelTimes[getSegmentKey(it->interval, it->modeId, it->segmentSlot)];
+        timeAndCount.travelTimeCnt++;
+        timeAndCount.totalTravelTime += it->travelTime;
+    }
+}
+
 void sim_mob::TravelTimeManager::addTravelTime(const LinkTravelStats& stats)
 {
-    std::map<unsigned int, sim_mob::LinkTravelTime>::iterator ttMapIt = lnkTravelTimeMap.find(stats.link->getLinkId());
-    if(ttMapIt == lnkTravelTimeMap.end())
+    unsigned int linkSlot = getLinkSlot(stats.link->getLinkId());
+    if(linkSlot == NO_SLOT)
     {
         std::stringstream errStrm;
-        errStrm << "Link " << stats.link->getLinkId() << " has no entry in lnkTravelTimeMap\n";
+        errStrm << "Link " << stats.link->getLinkId() << " has no default travel time\n";
         throw std::runtime_error(errStrm.str());
     }
-    ttMapIt->second.addInSimulationTravelTime(stats);
+
+    LinkTT_Record record = { getTimeInterval(stats.entryTime * 1000), linkSlot, NO_SLOT, 0, stats.travelTime }; //milliseconds
+    if(stats.downstreamLink)
+    {
+        //turn slots cover all turning groups of the network; records for other downstream links are kept apart
+        record.downstreamLinkId = stats.downstreamLink->getLinkId();
+        record.turnSlot = getTurnSlot(linkSlot, record.downstreamLinkId);
+    }
+
+    ThreadAccumulator& accumulator = getLocalAccumulator();
+    {
+        boost::mutex::scoped_lock lock(accumulator.mtx);
+        accumulator.linkRecords.push_back(record);
+    }
+
+    //the first record finishing in a new interval closes the previous one
+    tryMerge(lastLinkMergeInterval, getTimeInterval((stats.entryTime + stats.travelTime) * 1000));
 }
 
 unsigned int sim_mob::TravelTimeManager::getODInterval(const unsigned int time)
@@ -385,40 +581,84 @@ double sim_mob::TravelTimeManager::getInSimulationLinkTT(const sim_mob::Link *ln
 
 double sim_mob::TravelTimeManager::EnRouteTT::getInSimulationLinkTT(const sim_mob::Link *lnk) const
 {
-    throw std::runtime_error("EnRouteTT::getInSimulationLinkTT not implemented");
-//  boost::shared_lock<boost::shared_mutex> lock(parent.ttMapMutex);
-//  //[time interval][travel mode][road segment][average travel time]
-//  //<-----TI-----><-------------------MRTC----------------------->
-//  //start from the last recorded time interval (before the current time interval) and proceed to find a travel time for the given section.
-//  //if no records found, check the previous time interval and so on.
-//  sim_mob::TravelTime::reverse_iterator itTI = parent.ttMap.rbegin();
-//  //like I said, not the current interval
-//  if(itTI != parent.ttMap.rend() && itTI->first == sim_mob::PathSetManager::curIntervalMS) { itTI++; }
-//  sim_mob::TT::MRTC::iterator itMode;
-//  sim_mob::TT::RSTC::iterator itSeg;
-//  //search backwards. try to find a matching road segment in any of the previous time intervals
-//  while(itTI != parent.ttMap.rend())
-//  {
-//      itMode = itTI->second.find(mode);
-//      if(itMode != itTI->second.end())
-//      {
-//          itSeg = itMode->second.find(lnk);
-//          if(itSeg != itMode->second.end())
-//          {
-//              return itSeg->second.totalTravelTime / itSeg->second.travelTimeCnt;
-//          }
-//      }
-//      ++itTI;
-//  }
-}
-
-void sim_mob::TravelTimeManager::dumpTravelTimesToFile(const std::string fileName) const
-{
-    for(std::map<unsigned int, sim_mob::LinkTravelTime>::const_iterator lnkTravelTimeIt=lnkTravelTimeMap.begin(); lnkTravelTimeIt!=lnkTravelTimeMap.end(); lnkTravelTimeIt++)
-    {
-        lnkTravelTimeIt->second.dumpTravelTimesToFile(fileName);
-    }
-    sim_mob::Logger::log(fileName).flush();
+    unsigned int linkSlot = parent.getLinkSlot(lnk->getLinkId());
+    boost::shared_ptr<const InSimulationTT> snapshot = parent.getPublishedTT();
+    if (linkSlot == NO_SLOT || !snapshot)
+    {
+        return -1;
+    }
+
+    //start from the latest published interval and proceed backwards to find a travel time for the link,
+    //averaged over its downstream links
+    for (size_t interval = snapshot->intervals.size(); interval > 0; --interval)
+    {
+        const boost::shared_ptr< const std::vector<double> >& travelTimes = snapshot->intervals[interval - 1];
+        if (!travelTimes)
+        {
+            continue;
+        }
+        double totalTT = 0.0;
+        unsigned int count = 0;
+        for (unsigned int turnSlot = parent.turnOffsets[linkSlot]; turnSlot < parent.turnOffsets[linkSlot + 1]; ++turnSlot)
+        {
+            if ((*travelTimes)[turnSlot] > 0.0)
+            {
+                totalTT += (*travelTimes)[turnSlot];
+                ++count;
+            }
+        }
+        if (count > 0)
+        {
+            return totalTT / count;
+        }
+    }
+    return -1;
+}
+
+void sim_mob::TravelTimeManager::dumpTravelTimesToFile(const std::string fileName)
+{
+    boost::mutex::scoped_lock lock(mergeMutex);
+    mergeAccumulators();
+
+    //  destination file
+    sim_mob::BasicLogger& ttLogger  = sim_mob::Logger::log(fileName);
+    const DailyTime& simStartTime = sim_mob::ConfigManager::GetInstance().FullConfig().simStartTime();
+    for (size_t linkSlot = 0; linkSlot < linkDefaultTT.size(); ++linkSlot)
+    {
+        const unsigned int linkId = linkDefaultTT[linkSlot].getLinkId();
+        for (unsigned int interval = 0; interval < inSimulationTT.size(); ++interval)
+        {
+            const std::vector<TimeAndCount>& intervalTT = inSimulationTT[interval];
+            if (intervalTT.empty())
+            {
+                continue;
+            }
+            DailyTime startTime(simStartTime.getValue() +  (interval * TT_STORAGE_TIME_INTERVAL_WIDTH) );
+            DailyTime endTime(simStartTime.getValue() + ((interval + 1) * TT_STORAGE_TIME_INTERVAL_WIDTH - 1000) );
+            for (unsigned int turnSlot = turnOffsets[linkSlot]; turnSlot < turnOffsets[linkSlot + 1]; ++turnSlot)
+            {
+                const TimeAndCount& tc = intervalTT[turnSlot];
+                if (tc.travelTimeCnt == 0)
+                {
+                    continue;
+                }
+                ttLogger << linkId << ";" << turnDownstreamLinks[turnSlot] << ";" << startTime.getStrRepr() << ";" << endTime.getStrRepr() << ";" << tc.getTravelTime() <<  "\n";
+            }
+        }
+
+        //downstream links without a turn slot
+        std::map< std::pair<unsigned int, unsigned int>, std::map<unsigned int, TimeAndCount> >::const_iterator turnIt;
+        for (turnIt = unconnectedTurnTT.lower_bound(std::make_pair(linkId, 0u)); turnIt != unconnectedTurnTT.end() && turnIt->first.first == linkId; ++turnIt)
+        {
+            for (std::map<unsigned int, TimeAndCount>::const_iterator intervalIt = turnIt->second.begin(); intervalIt != turnIt->second.end(); ++intervalIt)
+            {
+                DailyTime startTime(simStartTime.getValue() +  (intervalIt->first * TT_STORAGE_TIME_INTERVAL_WIDTH) );
+                DailyTime endTime(simStartTime.getValue() + ((intervalIt->first + 1) * TT_STORAGE_TIME_INTERVAL_WIDTH - 1000) );
+                ttLogger << linkId << ";" << turnIt->first.second << ";" << startTime.getStrRepr() << ";" << endTime.getStrRepr() << ";" << intervalIt->second.getTravelTime() <<  "\n";
+            }
+        }
+    }
+    ttLogger.flush();
 }
 
 bool sim_mob::TravelTimeManager::storeCurrentSimulationTT()
@@ -438,38 +678,118 @@ unsigned int sim_mob::TravelTimeManager::getSegmentInterval(const unsigned int t
     return time/segIntervalMS;
 }
 
+void sim_mob::TravelTimeManager::initSegmentSlots()
+{
+    const std::map<unsigned int, Link *>& links = RoadNetwork::getInstance()->getMapOfIdVsLinks();
+    for (std::map<unsigned int, Link *>::const_iterator lnkIt = links.begin(); lnkIt != links.end(); ++lnkIt)
+    {
+        const std::vector<RoadSegment *>& segments = lnkIt->second->getRoadSegments();
+        for (std::vector<RoadSegment *>::const_iterator segIt = segments.begin(); segIt != segments.end(); ++segIt)
+        {
+            segmentSlots[*segIt] = slotSegments.size();
+            slotSegments.push_back(*segIt);
+        }
+    }
+}
+
 void sim_mob::TravelTimeManager::addSegmentTravelTime(const SegmentTravelStats& segStats)
 {
-    unsigned int interval = getSegmentInterval(segStats.entryTime * 1000);
+    std::call_once(segmentSlotsFlag, &TravelTimeManager::initSegmentSlots, this);
 
-    TimeAndCount& timeAndCount = segmentTravelTimeMap[interval][segStats.travelMode][segStats.roadSegment];
+    boost::unordered_map<const RoadSegment*, unsigned int>::const_iterator slotIt = segmentSlots.find(segStats.roadSegment);
+    if(slotIt == segmentSlots.end())
+    {
+        std::stringstream errStrm;
+        errStrm << "Segment travel stats: road segment " << segStats.roadSegment->getRoadSegmentId() << " is not in the road network\n";
+        throw std::runtime_error(errStrm.str());
+    }
 
-    timeAndCount.travelTimeCnt++;
-    timeAndCount.totalTravelTime += segStats.travelTime;
+    SegmentTT_Record record = { getSegmentInterval(segStats.entryTime * 1000), segStats.travelModeId, slotIt->second, segStats.travelTime };
+    ThreadAccumulator& accumulator = getLocalAccumulator();
+    {
+        boost::mutex::scoped_lock lock(accumulator.mtx);
+        accumulator.segmentRecords.push_back(record);
+    }
+
+    tryMerge(lastSegmentMergeInterval, getSegmentInterval((segStats.entryTime + segStats.travelTime) * 1000));
 }
 
-void sim_mob::TravelTimeManager::dumpSegmentTravelTimeToFile(const std::string& fileName) const
+unsigned int sim_mob::TravelTimeManager::getTravelModeId(const std::string& mode)
 {
-    if(fileName.empty())
+    unsigned int numModes = numTravelModes.load(std::memory_order_acquire);
+    for (unsigned int modeId = 0; modeId < numModes; ++modeId)
     {
-        throw std::runtime_error("Segment Travel Stat: Filename is empty");
+        if (travelModeNames[modeId] == mode)
+        {
+            return modeId;
+        }
     }
-    BasicLogger& rdSegTTLogger = sim_mob::Logger::log(fileName);
-    for(auto rdSegTT : segmentTravelTimeMap)
+
+    if (mode.empty())
     {
-        for(auto modTT : rdSegTT.second)
+        throw std::runtime_error("Segment travel stats: empty travel mode");
+    }
+
+    boost::mutex::scoped_lock lock(travelModesMutex);
+    //the mode may have been registered by another thread in the meantime
+    numModes = numTravelModes.load(std::memory_order_relaxed);
+    for (unsigned int modeId = 0; modeId < numModes; ++modeId)
+    {
+        if (travelModeNames[modeId] == mode)
         {
-            for(auto TT : modTT.second)
-            {
-                rdSegTTLogger << (rdSegTT.first+1)*segIntervalMS
-                        << "," << modTT.first
-                        << "," << TT.first->getRoadSegmentId()
-                        << "," << TT.second.getTravelTime()
-                        << "," << TT.second.travelTimeCnt
-                        << "\n";
-            }
+            return modeId;
         }
     }
+    if (numModes == MAX_TRAVEL_MODES)
+    {
+        throw std::runtime_error("Segment travel stats: too many travel modes");
+    }
+    travelModeNames[numModes] = mode;
+    numTravelModes.store(numModes + 1, std::memory_order_release);
+    return numModes;
+}
+
+const std::string& sim_mob::TravelTimeManager::getTravelModeName(unsigned int modeId) const
+{
+    if (modeId >= numTravelModes.load(std::memory_order_acquire))
+    {
+        throw std::out_of_range("Segment travel stats: unknown travel mode id");
+    }
+    return travelModeNames[modeId];
+}
+
+void sim_mob::TravelTimeManager::dumpSegmentTravelTimeToFile(const std::string& fileName)
+{
+    if(fileName.empty())
+    {
+        throw std::runtime_error("Segment Travel Stat: Filename is empty");
+    }
+
+    boost::mutex::scoped_lock lock(mergeMutex);
+    mergeAccumulators();
+
+    std::vector<unsigned long long> keys;
+    keys.reserve(segmentTravelTimes.size());
+    for (boost::unordered_map<unsigned long long, TimeAndCount>::const_iterator it = segmentTravelTimes.begin(); it != segmentTravelTimes.end(); ++it)
+    {
+        keys.push_back(it->first);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    BasicLogger& rdSegTTLogger = sim_mob::Logger::log(fileName);
+    for (std::vector<unsigned long long>::const_iterator it = keys.begin(); it != keys.end(); ++it)
+    {
+        const unsigned int interval = *it >> (SEGMENT_SLOT_BITS + TRAVEL_MODE_BITS);
+        const unsigned int modeId = (*it >> SEGMENT_SLOT_BITS) & ((1u << TRAVEL_MODE_BITS) - 1);
+        const unsigned int segmentSlot = *it & 0xFFFFFFFFu;
+        const TimeAndCount& tc = segmentTravelTimes.find(*it)->second;
+        rdSegTTLogger << (interval+1)*segIntervalMS
+                << "," << getTravelModeName(modeId)
+                << "," << slotSegments[segmentSlot]->getRoadSegmentId()
+                << "," << tc.getTravelTime()
+                << "," << tc.travelTimeCnt
+                << "\n";
+    }
 }
 
 void TravelTimeManager::addPredictedLinkTT(unsigned int link, unsigned int downstreamLink, double *travelTimes)
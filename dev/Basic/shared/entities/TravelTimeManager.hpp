@@ -1,12 +1,22 @@
 #pragma once
-#include <boost/thread/shared_mutex.hpp>
+#include <atomic>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/unordered_map.hpp>
 #include <map>
+#include <mutex>
 #include <soci/soci.h>
 #include <soci/postgresql/soci-postgresql.h>
 #include <string>
 #include "util/DailyTime.hpp"
 #include "path/Common.hpp"
 
+namespace unit_tests
+{
+class TravelTimeManagerUnitTests;
+}
+
 namespace sim_mob
 {
 
@@ -39,10 +49,6 @@ struct TimeAndCount
     }
 };
 
-typedef std::map<const RoadSegment*, TimeAndCount> RSToTimeCountMap;
-typedef std::map<std::string, RSToTimeCountMap> ModeToRSCountMap;
-typedef std::map<unsigned int, ModeToRSCountMap> SegmentTravelTimeMap;
-
 struct SegmentTravelStats
 {
     const RoadSegment* roadSegment;
@@ -50,10 +56,12 @@ struct SegmentTravelStats
     double travelTime;
     bool started;
     bool finalized;
-    std::string travelMode;
+
+    /** travel mode id, as given by TravelTimeManager::getTravelModeId() */
+    unsigned int travelModeId;
 
     SegmentTravelStats(const RoadSegment* rs = nullptr):
-        roadSegment(rs), entryTime(0.0), travelTime(0.0), started(false), finalized(false), travelMode("")
+        roadSegment(rs), entryTime(0.0), travelTime(0.0), started(false), finalized(false), travelModeId(0)
     {}
 
     /**
@@ -78,9 +86,9 @@ struct SegmentTravelStats
      *
      * @param rdSeg The road segment which the agent has exited
      * @param rdSegExitTime The time of exit on the road segment
-     * @param travelMode_ The mode of travel being used by the agent
+     * @param travelModeId_ The id of the mode of travel being used by the agent
      */
-    void finalize(const RoadSegment* rdSeg, const double rdSegExitTime, const std::string travelMode_)
+    void finalize(const RoadSegment* rdSeg, const double rdSegExitTime, unsigned int travelModeId_)
     {
         //validations
         if (!started)
@@ -95,17 +103,13 @@ struct SegmentTravelStats
         {
             throw std::runtime_error("empty road segment supplied for travel time calculations.");
         }
-        if (travelMode_.empty())
-        {
-            throw std::runtime_error("Finalizing a wrong travel time");
-        }
         if(rdSegExitTime < entryTime)
         {
             throw std::runtime_error("link exit time is before entry time");
         }
 
         travelTime = rdSegExitTime - entryTime;
-        travelMode = travelMode_;
+        travelModeId = travelModeId_;
         finalized = true;
     }
 
@@ -203,53 +207,23 @@ struct PredictedLinkTT
 };
 
 /**
- * Class to hold default, historical and in-simulation travel times for a link
+ * Default travel time of a link, as loaded from the default travel time table
  *
  * \author Harish Loganathan
  */
 class LinkTravelTime
 {
 private:
-    /** time interval */
-    typedef unsigned int TimeInterval;
-
-    /** typedef for downstream link id -> travel time of this link; allows different travel times to be stored for this link for each immediate downstream link */
-    typedef std::map<unsigned int, double> DownStreamLinkSpecificTT_Map;
-
-    /** typedef of downstream link id -> (travel time and count) for this link; this is used for storing in-simulation link travel times*/
-    typedef std::map<unsigned int, TimeAndCount> DownStreamLinkSpecificTimeAndCount_Map;
-
-    /** map of [time interval][downstream Link] --> [average travel time for Link] */
-    typedef std::map<TimeInterval, DownStreamLinkSpecificTT_Map> TravelTimeStore;
-
-    /** map of [time interval][downstream Link] --> [TimeAndCount for link] */
-    typedef std::map<TimeInterval, DownStreamLinkSpecificTimeAndCount_Map> TimeAndCountStore;
-
     /** link id */
     unsigned int linkId;
 
     /** travel time in seconds */
     double defaultTravelTime;
 
-    /** time specific turning based historical TT map */
-    TravelTimeStore historicalTT_Map;
-
-    /** time specific turning based in-simulation TT map */
-    TimeAndCountStore currentSimulationTT_Map;
-
-    /** mutex for adding travel times in currentSimulationTT_Map */
-    boost::shared_mutex ttMapMutex;
-
 public:
     LinkTravelTime();
     virtual ~LinkTravelTime();
 
-    /**
-     * custom assignment operator - becasue implicit assignment operator would not be auto-constructed for this class
-     * this would be used while loading default travel times
-     */
-    LinkTravelTime& operator=(const LinkTravelTime& rhs);
-
     double getDefaultTravelTime() const
     {
         return defaultTravelTime;
@@ -269,52 +243,6 @@ public:
     {
         this->linkId = linkId;
     }
-
-    /**
-     * adds travel time of this link for specific next downstream link
-     * @param dt time of day at which the added travel time is applicable
-     * @param downstreamLinkId id of downstream link
-     * @param travelTime travel time in seconds for this link when next link is downstreamLinkId
-     *
-     * NOTE: this function assumes that the supplied downstream link is connected to current link. It does not check connectivity.
-     */
-    void addHistoricalTravelTime(const DailyTime& dt, unsigned int downstreamLinkId, double travelTime);
-
-    /**
-     * accumulates in-simulation Travel Time data
-     * @param stats travel time record
-     */
-    void addInSimulationTravelTime(const LinkTravelStats& stats);
-
-    /**
-     * fetches tt in seconds for provided downstream link and time interval index
-     * @param downstreamLinkId id of downstream link
-     * @param dt time of day for which travel time is to be fetched
-     * @return tt found from downstreamLinkTT_Map if available; -1 otherwise
-     */
-    double getHistoricalLinkTT(unsigned int downstreamLinkId, const DailyTime& dt) const;
-    
-    /**
-     * fetches tt in seconds for provided downstream link and interval index
-     * @param downstreamLinkId id of the downstream link
-     * @param dt time of day for which travel time is to be fetched
-     * @return tt found from currentSimulationTT_Map if available; -1 otherwise
-     */
-    double getInSimulationLinkTT(unsigned int downstreamLinkId, const DailyTime& dt) const;
-
-    /**
-     * fetches tt in seconds for provided time interval index
-     * this function averages the traveltime for each downstream link and returns the average travel time
-     * @param timeInterval index of time interval for which tt is requested
-     * @return tt found from downstreamLinkTT_Map if available; -1 otherwise
-     */
-    double getHistoricalLinkTT(const DailyTime& dt) const;
-
-    /**
-     * Writes the aggregated data into the file
-     * @param fileName name of file to dump travel times
-     */
-    void dumpTravelTimesToFile(const std::string fileName) const;
 };
 
 /**
@@ -323,6 +251,12 @@ public:
  * the processing task to this class.
  * This class aggregates the data received within different
  * time ranges and writes them to a file.
+ *
+ * Link travel times are stored in flat arrays. Every link with a default travel time owns a dense slot, and each
+ * (link, downstream link) pair owns a turn slot; historical and in-simulation travel times are indexed by time
+ * interval and turn slot. Workers record in-simulation travel times in per-thread buffers, which are merged when the
+ * first record of a new time interval arrives. The merged travel times are then published as an immutable snapshot,
+ * so route choice never waits for a merge.
  */
 class TravelTimeManager
 {
@@ -359,12 +293,24 @@ public:
 
     /**
      * returns the travel time experienced by other drivers in the current simulation
-     * @param mode mode of travel requested
-     * @param rs target road segment
-     * @return the travel time
+     * @param lnk target link
+     * @return the travel time found in the latest published interval having one; -1 if none
      */
     double getInSimulationLinkTT(const sim_mob::Link *lnk) const;
 
+    /**
+     * gets the id of a travel mode, registering the mode if it is seen for the first time
+     * @param mode name of the travel mode
+     * @return small integer id of the mode
+     */
+    unsigned int getTravelModeId(const std::string& mode);
+
+    /**
+     * @param modeId id returned by getTravelModeId
+     * @return name of the travel mode
+     */
+    const std::string& getTravelModeName(unsigned int modeId) const;
+
     /**
      * simulation time interval in milliseconds
      */
@@ -376,7 +322,7 @@ public:
      */
     void addSegmentTravelTime(const SegmentTravelStats& stats);
 
-    void dumpSegmentTravelTimeToFile(const std::string& fileName) const;
+    void dumpSegmentTravelTimeToFile(const std::string& fileName);
 
     /**
      * Adds the predicted link travel times
@@ -405,7 +351,7 @@ public:
      * Writes the aggregated data into the file
      * @param fileName name of file to dump travel times
      */
-    void dumpTravelTimesToFile(const std::string fileName) const;
+    void dumpTravelTimesToFile(const std::string fileName);
 
     /**
      * save Realtime Travel Time into Database
@@ -436,8 +382,7 @@ public:
 
         /**
          * get the desired travel time
-         * @param mode  travel mode
-         * @param rs    the roadsegment for which TT is retrieved
+         * @param lnk the link for which TT is retrieved
          */
         double getInSimulationLinkTT(const sim_mob::Link* lnk) const;
     };
@@ -448,17 +393,65 @@ public:
     EnRouteTT* enRouteTT;
 
 private:
+    /** value of a slot index which refers to no slot */
+    static const unsigned int NO_SLOT = 0xFFFFFFFF;
+
+    /** maximum number of distinct travel modes for segment travel times */
+    static const unsigned int MAX_TRAVEL_MODES = 64;
+
+    /**
+     * in-simulation link travel time contribution.
+     * turnSlot is NO_SLOT if the contribution goes to all downstream links (downstreamLinkId is 0),
+     * or if the downstream link is not connected to the link in the network or in the historical data
+     */
+    struct LinkTT_Record
+    {
+        unsigned int interval;
+        unsigned int linkSlot;
+        unsigned int turnSlot;
+        unsigned int downstreamLinkId;
+        double travelTime;
+    };
+
+    /** segment travel time contribution */
+    struct SegmentTT_Record
+    {
+        unsigned int interval;
+        unsigned int modeId;
+        unsigned int segmentSlot;
+        double travelTime;
+    };
+
+    /** travel time records added by one thread since the last merge */
+    struct ThreadAccumulator
+    {
+        boost::mutex mtx;
+        std::vector<LinkTT_Record> linkRecords;
+        std::vector<SegmentTT_Record> segmentRecords;
+    };
+
+    /**
+     * immutable view of the merged in-simulation link travel times.
+     * [time interval][turn slot] -> average travel time in seconds; 0 if no travel time was recorded.
+     * intervals without any record have a null vector
+     */
+    struct InSimulationTT
+    {
+        std::vector< boost::shared_ptr< const std::vector<double> > > intervals;
+    };
+
     TravelTimeManager();
     ~TravelTimeManager();
 
     /**
-     * loads default travel times for all links from database into lnkTravelTimeMap
+     * loads default travel times for all links from database and assigns link slots
      * @param sql soci::session object for db connection
      */
     void loadLinkDefaultTravelTime(soci::session& sql);
 
     /**
-     * loads historical simulation travel times for all links from database into lnkTravelTimeMap
+     * loads historical simulation travel times for all links from database, assigns turn slots and fills the
+     * historical travel time arrays
      * @param sql soci::session object for db connection
      */
     void loadLinkHistoricalTravelTime(soci::session& sql);
@@ -467,6 +460,70 @@ private:
 
     unsigned int getSegmentInterval(const unsigned int time);
 
+    /**
+     * @param linkId link id
+     * @return slot of the link; NO_SLOT if the link has no default travel time
+     */
+    unsigned int getLinkSlot(unsigned int linkId) const;
+
+    /**
+     * @param linkSlot slot of the link
+     * @param downstreamLinkId id of the downstream link
+     * @return turn slot of the (link, downstream link) pair; NO_SLOT if the links are not connected
+     */
+    unsigned int getTurnSlot(unsigned int linkSlot, unsigned int downstreamLinkId) const;
+
+    /**
+     * @return travel time of a turn at time dt in the historical data; -1 if not available
+     */
+    double getHistoricalTurnTT(unsigned int turnSlot, const DailyTime& dt) const;
+
+    /**
+     * @return travel time of a link at time dt averaged over its downstream links in the historical data; -1 if not available
+     */
+    double getHistoricalLinkTT(unsigned int linkSlot, const DailyTime& dt) const;
+
+    /**
+     * @return travel time of a turn in the published in-simulation data for the interval preceding dt; -1 if not available
+     */
+    double getInSimulationTurnTT(unsigned int turnSlot, const DailyTime& dt) const;
+
+    /**
+     * assigns dense slots to the road segments of the network, on first use
+     */
+    void initSegmentSlots();
+
+    /**
+     * @return the record buffer of the calling thread, creating and registering it on first use
+     */
+    ThreadAccumulator& getLocalAccumulator();
+
+    /**
+     * merges the records of all threads if the given interval is not merged yet.
+     * If another thread is merging, that thread merges again once it is done, so the records added before this call
+     * are merged without waiting for the next interval.
+     * @param lastInterval last merged interval of the kind of record being added
+     * @param interval the interval which has just started
+     */
+    void tryMerge(std::atomic<unsigned int>& lastInterval, unsigned int interval);
+
+    /**
+     * moves all thread records into the merged stores and publishes a new in-simulation snapshot.
+     * mergeMutex must be held by the caller
+     */
+    void mergeAccumulators();
+
+    /**
+     * @return the latest published in-simulation snapshot; null if nothing was published yet
+     */
+    boost::shared_ptr<const InSimulationTT> getPublishedTT() const;
+
+    /**
+     * sets the width of the time intervals of historical and in-simulation link travel times
+     * @param widthMS width in milliseconds
+     */
+    static void setTimeIntervalWidth(unsigned int widthMS);
+
     /**
      * OD Travel Time interval in milliseconds
      */
@@ -477,15 +534,86 @@ private:
      */
     unsigned int segIntervalMS;
 
+    /** link id -> link slot */
+    boost::unordered_map<unsigned int, unsigned int> linkSlots;
+
+    /** link slot -> default link travel time */
+    std::vector<sim_mob::LinkTravelTime> linkDefaultTT;
+
+    /** link slot -> first turn slot of the link; the last element is the total number of turn slots */
+    std::vector<unsigned int> turnOffsets;
+
+    /** turn slot -> downstream link id. The turns of a link are sorted by downstream link id */
+    std::vector<unsigned int> turnDownstreamLinks;
+
+    /** number of time intervals having historical travel times */
+    unsigned int numHistoricalIntervals;
+
+    /** [time interval * number of turn slots + turn slot] -> historical travel time; -1 if not available */
+    std::vector<double> historicalTurnTT;
+
+    /** [time interval * number of links + link slot] -> historical travel time averaged over downstream links; -1 if not available */
+    std::vector<double> historicalLinkTT;
+
+    /** merged in-simulation link travel times: [time interval][turn slot] */
+    std::vector< std::vector<TimeAndCount> > inSimulationTT;
+
     /**
-     * a structure to keep history of average segment travel time records
+     * latest published in-simulation snapshot. Only accessed through boost::atomic_load/atomic_store; readers keep
+     * the snapshot they loaded alive, and a snapshot is released once it is replaced and no reader holds it
      */
-    SegmentTravelTimeMap segmentTravelTimeMap;
+    boost::shared_ptr<const InSimulationTT> publishedTT;
 
     /**
-     * a structure to keep history of average travel time records
+     * merged in-simulation travel times of (link id, downstream link id) pairs which have no turn slot:
+     * [link id, downstream link id][time interval]. They are written to the travel time dump only
      */
-    std::map<unsigned int, sim_mob::LinkTravelTime> lnkTravelTimeMap;
+    std::map< std::pair<unsigned int, unsigned int>, std::map<unsigned int, TimeAndCount> > unconnectedTurnTT;
+
+    /** link travel time interval up to which the thread records were merged */
+    std::atomic<unsigned int> lastLinkMergeInterval;
+
+    /** segment travel time interval up to which the thread records were merged */
+    std::atomic<unsigned int> lastSegmentMergeInterval;
+
+    /** serialises merges */
+    boost::mutex mergeMutex;
+
+    /** set by threads which found a merge in progress; the merging thread merges again when it sees it */
+    std::atomic<bool> mergeRequested;
+
+    /** record buffer of the current thread; shares ownership with threadAccumulators so records outlive the thread */
+    boost::thread_specific_ptr< boost::shared_ptr<ThreadAccumulator> > localAccumulator;
+
+    /** record buffers of all threads, in order of registration */
+    std::vector< boost::shared_ptr<ThreadAccumulator> > threadAccumulators;
+
+    /** protects threadAccumulators */
+    boost::mutex accumulatorsMutex;
+
+    /** road segment -> segment slot */
+    boost::unordered_map<const RoadSegment*, unsigned int> segmentSlots;
+
+    /** segment slot -> road segment */
+    std::vector<const RoadSegment*> slotSegments;
+
+    /** guards the one-time assignment of segment slots */
+    std::once_flag segmentSlotsFlag;
+
+    /**
+     * merged segment travel times keyed by (time interval, mode id, segment slot),
+     * packed by getSegmentKey in the translation unit
+     */
+    boost::unordered_map<unsigned long long, TimeAndCount> segmentTravelTimes;
+
+    /** travel mode id -> name. Entries below numTravelModes are never modified */
+    std::string travelModeNames[MAX_TRAVEL_MODES];
+
+    /** number of registered travel modes */
+    std::atomic<unsigned int> numTravelModes;
+
+    /** protects the registration of travel modes */
+    boost::mutex travelModesMutex;
 
     /**
      * Stores the predicted link travel times received from dynaMIT (for informed agents)
@@ -508,5 +636,7 @@ private:
     std::string defaultTT_TableName;
 
     static sim_mob::TravelTimeManager* instance;
+
+    friend class unit_tests::TravelTimeManagerUnitTests;
 };
 }//namespace
@@ -4,6 +4,9 @@
 
 #include "PolyLine.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 using namespace sim_mob;
 
 PolyLine::PolyLine() :
@@ -52,6 +55,21 @@ const PolyPoint& PolyLine::getLastPoint() const
 
 void PolyLine::addPoint(PolyPoint point)
 {
+    if (!points.empty())
+    {
+        //Computed as DynamicVector::getMagnitude() does, so that movers get the same values as before
+        const PolyPoint& last = points.back();
+        double dx = point.getX() - last.getX();
+        double dy = point.getY() - last.getY();
+        double segmentLength = (dx == 0 && dy == 0) ? 0 : std::sqrt(dx * dx + dy * dy);
+        segmentLengths.push_back(segmentLength);
+        cumulativeLengths.push_back(cumulativeLengths.back() + segmentLength);
+    }
+    else
+    {
+        cumulativeLengths.push_back(0);
+    }
+
     this->points.push_back(point);
 }
 
@@ -59,3 +77,25 @@ std::size_t sim_mob::PolyLine::size() const
 {
     return points.size();
 }
+
+double PolyLine::getSegmentLength(std::size_t index) const
+{
+    return segmentLengths[index];
+}
+
+double PolyLine::getCumulativeLength(std::size_t index) const
+{
+    return cumulativeLengths[index];
+}
+
+std::size_t PolyLine::findSegment(double distance) const
+{
+    if (segmentLengths.empty())
+    {
+        return 0;
+    }
+
+    //The first point after the distance, ignoring the first and the last points so that the result is clamped
+    std::vector<double>::const_iterator it = std::upper_bound(cumulativeLengths.begin() + 1, cumulativeLengths.end() - 1, distance);
+    return (it - cumulativeLengths.begin()) - 1;
+}
@@ -28,6 +28,12 @@ protected:
     /**Defines the points in the poly-line*/
     std::vector<PolyPoint> points;
 
+    /**Length of the segment from each point to the next one (one less than the number of points)*/
+    std::vector<double> segmentLengths;
+
+    /**Distance along the poly-line from the first point to each point*/
+    std::vector<double> cumulativeLengths;
+
 public:
     PolyLine();
     virtual ~PolyLine();
@@ -53,5 +59,25 @@ public:
      * @return the size of the poly-line (i.e. the number of points in the poly-line)
      */
     std::size_t size() const;
+
+    /**
+     * @param index index of a point, other than the last one
+     * @return the distance between the point and the next one
+     */
+    double getSegmentLength(std::size_t index) const;
+
+    /**
+     * @param index index of a point
+     * @return the distance along the poly-line from the first point to the point
+     */
+    double getCumulativeLength(std::size_t index) const;
+
+    /**
+     * Finds the segment containing the given distance along the poly-line, by binary search
+     * @param distance the distance from the first point
+     * @return the index of the point starting the segment. Distances before the first point map to the first
+     * segment, and distances beyond the last point to the last segment
+     */
+    std::size_t findSegment(double distance) const;
 };
 }
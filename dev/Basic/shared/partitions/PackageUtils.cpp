@@ -12,13 +12,19 @@
 
 using namespace sim_mob;
 
+const unsigned int sim_mob::PackageUtils::WIRE_FORMAT_VERSION;
+
 std::string sim_mob::PackageUtils::getPackageData() {
-    return buffer.str().data();
+    //The data is binary; it may contain null characters
+    return buffer.str();
 }
 
-sim_mob::PackageUtils::PackageUtils()
+sim_mob::PackageUtils::PackageUtils() : buffer(std::ios::in | std::ios::out | std::ios::binary)
 {
-    package = new boost::archive::text_oarchive(buffer);
+    package = new boost::archive::binary_oarchive(buffer);
+
+    unsigned int version = WIRE_FORMAT_VERSION;
+    (*package) & version;
 }
 
 sim_mob::PackageUtils::~PackageUtils()
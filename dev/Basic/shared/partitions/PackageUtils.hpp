@@ -12,7 +12,7 @@
 #include <string>
 
 #ifndef SIMMOB_DISABLE_MPI
-#include <boost/archive/text_oarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
 #include <boost/serialization/vector.hpp>
 #include <boost/serialization/string.hpp>
 #include <boost/serialization/list.hpp>
@@ -39,12 +39,20 @@ namespace sim_mob {
  * PackageUtils/UnPackageUtils have matching functions, if you add/edit/remove one function in this class, you need to check class UnPackageUtils
  *
  * \note
+ * Packages are binary archives: every field has the fixed size of its type, so they are only meant for partitions of
+ * the same build on the same kind of machine. Each package starts with WIRE_FORMAT_VERSION, which the receiving side
+ * checks; increment it whenever the pack() functions of the exchanged agents or roles change.
+ *
+ * \note
  * If the flag SIMMOB_DISABLE_MPI is defined, then this class is completely empty. It still exists as a friend class to anything
  * which can be serialized so that we can avoid lots of #idefs elsewhere in the code. ~Seth
  */
 class PackageUtils {
 
 public:
+    /**Version of the layout of the packages exchanged between partitions*/
+    static const unsigned int WIRE_FORMAT_VERSION = 1;
+
     PackageUtils() CHECK_MPI_THROW ;
     ~PackageUtils() CHECK_MPI_THROW ;
 public:
@@ -73,8 +81,7 @@ private:
 //  friend class ShortTermBoundaryProcessor;
 
     std::stringstream buffer;
-    //Should change to binary archive
-    boost::archive::text_oarchive* package;
+    boost::archive::binary_oarchive* package;
 #endif
 
 };
@@ -6,17 +6,30 @@
 
 #ifndef SIMMOB_DISABLE_MPI
 
+#include <stdexcept>
+
 #include "util/GeomHelpers.hpp"
 #include "util/DynamicVector.hpp"
 #include "util/DailyTime.hpp"
 #include "geospatial/network/Point.hpp"
+#include "PackageUtils.hpp"
 
 using namespace sim_mob;
 
-sim_mob::UnPackageUtils::UnPackageUtils(std::string data)
+sim_mob::UnPackageUtils::UnPackageUtils(const std::string& data) : buffer(data, std::ios::in | std::ios::out | std::ios::binary)
 {
-    buffer << data;
-    package = new boost::archive::text_iarchive(buffer);
+    package = new boost::archive::binary_iarchive(buffer);
+
+    unsigned int version = 0;
+    (*package) & version;
+    if (version != PackageUtils::WIRE_FORMAT_VERSION)
+    {
+        safe_delete_item(package);
+        std::stringstream msg;
+        msg << "UnPackageUtils: package has wire format version " << version << ", expected "
+            << PackageUtils::WIRE_FORMAT_VERSION;
+        throw std::runtime_error(msg.str());
+    }
 }
 
 sim_mob::UnPackageUtils::~UnPackageUtils()
@@ -9,7 +9,7 @@
 #include "util/LangHelpers.hpp"
 
 #ifndef SIMMOB_DISABLE_MPI
-#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
 #include <boost/serialization/vector.hpp>
 #include <boost/serialization/string.hpp>
 #include <boost/serialization/list.hpp>
@@ -43,14 +43,18 @@ private:
     std::stringstream buffer;
 
 #ifndef SIMMOB_DISABLE_MPI
-    boost::archive::text_iarchive* package;
+    boost::archive::binary_iarchive* package;
 
 //  friend class BoundaryProcessor;
 //  friend class ShortTermBoundaryProcessor;
 #endif
 
 public:
-    UnPackageUtils(std::string data) CHECK_MPI_THROW ;
+    /**
+     * @param data a package created by PackageUtils
+     * @throws std::runtime_error if the package was created with another WIRE_FORMAT_VERSION
+     */
+    UnPackageUtils(const std::string& data) CHECK_MPI_THROW ;
     ~UnPackageUtils() CHECK_MPI_THROW ;
 
     template<class DATA_TYPE>
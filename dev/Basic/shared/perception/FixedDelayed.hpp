@@ -5,9 +5,11 @@
 #pragma once
 
 #include <stdint.h>
-#include <list>
+#include <iostream>
+#include <sstream>
 #include <utility>
 #include <stdexcept>
+#include <vector>
 
 #include "conf/settings/DisableMPI.h"
 
@@ -44,7 +46,13 @@ class UnPackageUtils;
  *
  * \note
  * If a FixedDelayed<> is constructed with a maximum delay of 0, it will attempt to optimize away
- * most list<> calls and shouldn't be much more inefficient than just storing the value directly.
+ * the history and shouldn't be much more inefficient than just storing the value directly.
+ *
+ * \note
+ * The history is a ring buffer holding at most one value per time step (a value delayed at the same time as
+ * the previous one replaces it, since only the latest could ever be sensed). If the time step is given
+ * to the constructor, the buffer is sized for the maximum delay and nothing is allocated afterwards;
+ * otherwise it starts small and grows as needed.
  */
 template <typename T>
 class FixedDelayed {
@@ -53,8 +61,9 @@ public:
      * Construct a new FixedDelayed item with the given delay in ms.
      * \param maxDelayMS The maximum time to hold on to each sensation value. The default "delay" time is equal to this, but it can be set larger to allow variable reaction times.
      * \param reclaimPtrs If true, any item discarded by this history list is deleted. Does nothing if the template type is not a pointer.
+     * \param tickMS The interval between two calls to update(), used to size the history. 0 if not known.
      */
-    explicit FixedDelayed(uint32_t maxDelayMS=0, bool reclaimPtrs=true);
+    explicit FixedDelayed(uint32_t maxDelayMS=0, bool reclaimPtrs=true, uint32_t tickMS=0);
 
     ~FixedDelayed();
 
@@ -80,7 +89,7 @@ public:
 
     /**
      * Set the current perception delay to the given value. All calls to sense() are affected by this value.
-     * \param currDelayMS The new delay value. Must be less than maxDelayMS
+     * \param currDelayMS The new delay value. Must not be more than maxDelayMS
      */
     void set_delay(uint32_t currDelayMS);
 
@@ -121,13 +130,14 @@ private:
         //      STL has serialize() defined), but it wastes space. We should take care to ensure that
         //      memory-managed items are deleted properly.
         ar & history;
+        ar & histFront;
+        ar & histSize;
         ar & maxDelayMS;
         ar & currDelayMS;
         ar & currTime;
         ar & reclaimPtrs;
 
-        //Iterators don't serialize; fortunately, we can just cheat here.
-        //ar & percFront;
+        //The sensed position is cheap to recompute.
         update_iterator(); //Un-necessary on serialization; necessary on deserialization.
     }
 #endif
@@ -137,7 +147,7 @@ private:
     //Helper function: delete the first item in the history array. Return true if there's more to delete.
     bool del_history_front();
 
-    //Helper function: ensure that our percFront iterator is set to the correct (sense-able) History Item.
+    //Helper function: ensure that percFront is set to the correct (sense-able) History Item.
     void update_iterator();
 
     //Helper function: is there no chance of delay, ever? (I.e., is the max delay zero?)
@@ -168,11 +178,33 @@ private:
     #endif
     };
 
+    //Helper function: the history item at the given position, counting from the oldest.
+    HistItem& hist_at(size_t pos);
+
+    //Helper function: make room for one more item at the back of the history.
+    void grow_history();
+
+    //Helper functions: delete a replaced item, unless it is the one replacing it. Does nothing for value types.
+    template <typename U>
+    static void delete_replaced(U& item, const U& replacement) {}
+    template <typename U>
+    static void delete_replaced(U*& item, U* const& replacement) {
+        if (item != replacement) {
+            safe_delete_item(item);
+        }
+    }
+
 
 
 private:
-    //The list of history items
-    std::list<HistItem> history;
+    //Ring buffer of history items, from the oldest (at histFront) to the newest. Its size is the capacity.
+    std::vector<HistItem> history;
+
+    //Position of the oldest item in history.
+    size_t histFront;
+
+    //Number of items in history.
+    size_t histSize;
 
     //The maximum delay allowed by the system.
     const uint32_t maxDelayMS;
@@ -183,9 +215,9 @@ private:
     //The current clock time
     uint32_t currTime;
 
-    //The current "front" of the history list, used to return the correct value via sense().
-    //If equal to history.end(), we can't sense right now.
-    typename std::list<HistItem>::iterator percFront;
+    //Position (counting from the oldest) of the history item returned by sense().
+    //If equal to histSize, we can't sense right now.
+    size_t percFront;
 
     //Whether or not to reclaim memory once a sensed item is no longer needed.
     bool reclaimPtrs;
@@ -205,16 +237,23 @@ private:
 
 
 
+
+
+
+
 ///////////////////////////////////////////////////////////
 // Template implementation
 ///////////////////////////////////////////////////////////
 
 
 template <typename T>
-sim_mob::FixedDelayed<T>::FixedDelayed(uint32_t maxDelayMS, bool reclaimPtrs)
-    : maxDelayMS(maxDelayMS), currDelayMS(maxDelayMS), currTime(0), reclaimPtrs(reclaimPtrs)
+sim_mob::FixedDelayed<T>::FixedDelayed(uint32_t maxDelayMS, bool reclaimPtrs, uint32_t tickMS)
+    : histFront(0), histSize(0), maxDelayMS(maxDelayMS), currDelayMS(maxDelayMS), currTime(0), percFront(0), reclaimPtrs(reclaimPtrs)
 {
-    percFront = history.end();
+    //Values older than the maximum delay are dropped, except the latest of them.
+    if (!zero_delay()) {
+        history.resize(tickMS>0 ? maxDelayMS/tickMS + 2 : 4);
+    }
     zeroDelayValue.second = false;
 }
 
@@ -233,12 +272,31 @@ bool sim_mob::FixedDelayed<T>::zero_delay() const
     return maxDelayMS==0;
 }
 
+template <typename T>
+typename sim_mob::FixedDelayed<T>::HistItem& sim_mob::FixedDelayed<T>::hist_at(size_t pos)
+{
+    pos += histFront;
+    return history[pos<history.size() ? pos : pos-history.size()];
+}
+
+template <typename T>
+void sim_mob::FixedDelayed<T>::grow_history()
+{
+    //Only happens if updates are more frequent than expected; unroll the ring into a larger buffer.
+    std::vector<HistItem> larger(2*history.size());
+    for (size_t i=0; i<histSize; i++) {
+        larger[i] = hist_at(i);
+    }
+    history.swap(larger);
+    histFront = 0;
+}
+
 template <typename T>
 void sim_mob::FixedDelayed<T>::printHistory()
 {
     std::cout<<std::endl;
-    for (typename std::list<HistItem>::iterator it=history.begin(); it!=history.end(); it++) {
-        std::cout<<"printHistory: "<<it->observedTime<<" "<<it->item<<std::endl;
+    for (size_t i=0; i<histSize; i++) {
+        std::cout<<"printHistory: "<<hist_at(i).observedTime<<" "<<hist_at(i).item<<std::endl;
     }
     std::cout<<std::endl;
 }
@@ -246,23 +304,26 @@ template <typename T>
 bool sim_mob::FixedDelayed<T>::del_history_front()
 {
     //Failsafe; also for "zero-delay".
-    if (history.empty()) { return false; }
+    if (histSize==0) { return false; }
 
-    //Reclaim memory, pop the list
+    //Reclaim memory, pop the front
     if (reclaimPtrs) {
-        safe_delete_item(history.front().item);
+        safe_delete_item(history[histFront].item);
     }
-    history.pop_front();
+    history[histFront].item = T();
+    histFront = (histFront+1 < history.size()) ? histFront+1 : 0;
+    histSize--;
 
-    return !history.empty();
+    return histSize>0;
 }
 
 
 template <typename T>
 void sim_mob::FixedDelayed<T>::clear()
 {
-    //Clear the list and reclaim memory.
+    //Clear the history and reclaim memory.
     while (del_history_front());
+    percFront = histSize;
 }
 
 
@@ -284,39 +345,29 @@ void sim_mob::FixedDelayed<T>::update(uint32_t currTimeMS)
     currTime = currTimeMS;
 
     if (currTime >= maxDelayMS) {
-        //Loop, discard items which are past the maximum sensing window.
+        //Discard items which are past the maximum sensing window. The oldest item is only kept if
+        //there's nothing to replace it.
         uint32_t minTime = currTimeMS - maxDelayMS;
-        while (!history.empty()) {
-            bool found = false;
-            if (history.front().observedTime <= minTime) {
-                //This value only needs to be kept if there's nothing to replace it
-                if (history.size()>1 && (++history.begin())->observedTime <= minTime) {
-                    //Delete it and keep scanning.
-                    del_history_front();
-                    found = true;
-                }
-            }
-            if (!found) {
-                break;
-            }
+        while (histSize>1 && hist_at(1).observedTime <= minTime) {
+            del_history_front();
         }
     }
 
     //Now we need to update our pseudo-"front" pointer
-    set_delay(currDelayMS);
+    update_iterator();
 }
 
 
 template <typename T>
 void sim_mob::FixedDelayed<T>::set_delay(uint32_t currDelayMS)
 {
-    //Check
-//  if (currDelayMS > maxDelayMS) {
-//      std::stringstream msg;
-//      msg <<"FixedDelayed: Can't set delay to (" <<currDelayMS <<") since it is greater than the maximum ("
-//              <<maxDelayMS <<") specified in the constructor.";
-//      throw std::runtime_error(msg.str().c_str());
-//  }
+    //Check; older values are not kept, so they could not be sensed.
+    if (currDelayMS > maxDelayMS) {
+        std::stringstream msg;
+        msg <<"FixedDelayed: Can't set delay to (" <<currDelayMS <<") since it is greater than the maximum ("
+                <<maxDelayMS <<") specified in the constructor.";
+        throw std::runtime_error(msg.str().c_str());
+    }
 
     //We ignore delay updates if the max delay is zero.
     if (zero_delay()) {
@@ -334,13 +385,19 @@ void sim_mob::FixedDelayed<T>::set_delay(uint32_t currDelayMS)
 template <typename T>
 void sim_mob::FixedDelayed<T>::update_iterator()
 {
-    percFront = history.end();
-    for (typename std::list<HistItem>::iterator it=history.begin(); it!=history.end(); it++) {
-        if (!it->canObserve(currTime, currDelayMS)) {
-            break;
+    //Observed times are increasing; find the last item which can be observed.
+    size_t observable = 0;
+    size_t count = histSize;
+    while (count>0) {
+        size_t half = count/2;
+        if (hist_at(observable+half).canObserve(currTime, currDelayMS)) {
+            observable += half+1;
+            count -= half+1;
+        } else {
+            count = half;
         }
-        percFront = it;
     }
+    percFront = (observable>0) ? observable-1 : histSize;
 }
 
 
@@ -350,10 +407,24 @@ void sim_mob::FixedDelayed<T>::delay(const T& value)
     if (zero_delay()) {
         zeroDelayValue.first = value;
         zeroDelayValue.second = true;
+        return;
+    }
+
+    if (histSize>0 && hist_at(histSize-1).observedTime==currTime) {
+        //Replaces the value observed at the same time; it can never be sensed.
+        HistItem& last = hist_at(histSize-1);
+        if (reclaimPtrs) {
+            delete_replaced(last.item, value);
+        }
+        last.item = value;
     } else {
-        history.push_back(HistItem(value, currTime));
-        set_delay(currDelayMS);
+        if (histSize==history.size()) {
+            grow_history();
+        }
+        histSize++;
+        hist_at(histSize-1) = HistItem(value, currTime);
     }
+    update_iterator();
 }
 
 template <typename T>
@@ -368,7 +439,7 @@ const T& sim_mob::FixedDelayed<T>::sense()
     if (zero_delay()) {
         return zeroDelayValue.first;
     } else {
-        return percFront->item;
+        return hist_at(percFront).item;
     }
 }
 
@@ -377,15 +448,6 @@ bool sim_mob::FixedDelayed<T>::can_sense() {
     if (zero_delay()) {
         return zeroDelayValue.second;
     } else {
-        return percFront != history.end();
+        return percFront < histSize;
     }
 }
-
-
-
-
-
-
-
-
-
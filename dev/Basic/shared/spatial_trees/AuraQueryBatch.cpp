@@ -0,0 +1,92 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "AuraQueryBatch.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "geospatial/network/Point.hpp"
+
+using namespace sim_mob;
+
+namespace
+{
+//The centres are scaled to this many bits per axis before their bits are interleaved.
+const unsigned int MORTON_BITS = 16;
+
+//Spreads the low 16 bits of a value out to the even bits.
+boost::uint32_t spreadBits(boost::uint32_t value)
+{
+    value &= 0x0000FFFF;
+    value = (value | (value << 8)) & 0x00FF00FF;
+    value = (value | (value << 4)) & 0x0F0F0F0F;
+    value = (value | (value << 2)) & 0x33333333;
+    value = (value | (value << 1)) & 0x55555555;
+    return value;
+}
+}
+
+size_t AuraQueryBatch::add(const Point &lowerLeft, const Point &upperRight, const Agent *refAgent)
+{
+    Query query;
+    query.minX = lowerLeft.getX();
+    query.minY = lowerLeft.getY();
+    query.maxX = upperRight.getX();
+    query.maxY = upperRight.getY();
+    query.refAgent = refAgent;
+
+    queries.push_back(query);
+    ranges.push_back(std::make_pair(0, 0));
+    return queries.size() - 1;
+}
+
+void AuraQueryBatch::clear()
+{
+    queries.clear();
+    results.clear();
+    ranges.clear();
+}
+
+const std::vector<size_t> &AuraQueryBatch::beginAnswers()
+{
+    results.clear();
+    std::fill(ranges.begin(), ranges.end(), std::pair<size_t, size_t>(0, 0));
+
+    //Scale the centres to the extent of the batch.
+    double minX = std::numeric_limits<double>::max();
+    double minY = std::numeric_limits<double>::max();
+    double maxX = -std::numeric_limits<double>::max();
+    double maxY = -std::numeric_limits<double>::max();
+    for (std::vector<Query>::const_iterator it = queries.begin(); it != queries.end(); ++it)
+    {
+        const double x = (it->minX + it->maxX) / 2;
+        const double y = (it->minY + it->maxY) / 2;
+        minX = std::min(minX, x);
+        minY = std::min(minY, y);
+        maxX = std::max(maxX, x);
+        maxY = std::max(maxY, y);
+    }
+
+    const double maxCell = (1 << MORTON_BITS) - 1;
+    const double scaleX = (maxX > minX) ? maxCell / (maxX - minX) : 0;
+    const double scaleY = (maxY > minY) ? maxCell / (maxY - minY) : 0;
+
+    keys.clear();
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        const Query &query = queries[i];
+        const boost::uint32_t cellX = static_cast<boost::uint32_t>(((query.minX + query.maxX) / 2 - minX) * scaleX);
+        const boost::uint32_t cellY = static_cast<boost::uint32_t>(((query.minY + query.maxY) / 2 - minY) * scaleY);
+        keys.push_back(std::make_pair(spreadBits(cellX) | (spreadBits(cellY) << 1), i));
+    }
+    std::sort(keys.begin(), keys.end());
+
+    answerOrder.clear();
+    for (std::vector< std::pair<boost::uint32_t, size_t> >::const_iterator it = keys.begin(); it != keys.end(); ++it)
+    {
+        answerOrder.push_back(it->second);
+    }
+    return answerOrder;
+}
@@ -0,0 +1,106 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+namespace sim_mob
+{
+
+class Agent;
+class Point;
+
+/**
+ * A batch of rectangle queries, answered together by AuraManager::agentsInRects().
+ *
+ * The queries are answered in the Z-order (Morton code) of their centres, so consecutive queries are close together
+ *   and visit the same branches of the spatial index while those are still in the cache. Results can be retrieved by
+ *   query index, in the order the queries were added.
+ * All the results are kept in one buffer. A caller (e.g., a Worker) should keep its batch from tick to tick: clear()
+ *   keeps the memory, so once the buffers have grown to their working size, answering a batch no longer allocates.
+ */
+class AuraQueryBatch
+{
+public:
+    ///A query: the search rectangle, and the agent performing it (see AuraManager::agentsInRect()).
+    struct Query
+    {
+        double minX;
+        double minY;
+        double maxX;
+        double maxY;
+        const Agent *refAgent;
+    };
+
+    typedef std::vector<const Agent *>::const_iterator ResultIterator;
+
+    /**
+     * Adds a query to the batch.
+     *
+     * @param lowerLeft the lower left corner of the search rectangle
+     * @param upperRight the upper right corner of the search rectangle
+     * @param refAgent the agent performing the query, or null
+     *
+     * @return the index of the query, by which its results are retrieved
+     */
+    size_t add(const Point &lowerLeft, const Point &upperRight, const Agent *refAgent);
+
+    ///Removes every query and its results, but keeps the memory for the next batch.
+    void clear();
+
+    size_t size() const
+    {
+        return queries.size();
+    }
+
+    const Query &getQuery(size_t index) const
+    {
+        return queries[index];
+    }
+
+    ///Retrieves the agents found by a query, as [first, last). Valid until the batch is changed or answered again.
+    std::pair<ResultIterator, ResultIterator> getResults(size_t index) const
+    {
+        return std::make_pair(results.begin() + ranges[index].first, results.begin() + ranges[index].second);
+    }
+
+    /**
+     * For the spatial indexes: the order in which to answer the queries (by the Z-order of their centres).
+     * Also discards the results of any previous answer.
+     *
+     * @return the query indices, in the order to answer them
+     */
+    const std::vector<size_t> &beginAnswers();
+
+    ///For the spatial indexes: retrieves the buffer that the agents found by this query are to be appended to.
+    std::vector<const Agent *> &beginAnswer(size_t index)
+    {
+        ranges[index].first = results.size();
+        return results;
+    }
+
+    ///For the spatial indexes: marks the end of the agents found by this query.
+    void endAnswer(size_t index)
+    {
+        ranges[index].second = results.size();
+    }
+
+private:
+    std::vector<Query> queries;
+
+    ///The results of all the queries; query i found the agents in [ranges[i].first, ranges[i].second).
+    std::vector<const Agent *> results;
+    std::vector< std::pair<size_t, size_t> > ranges;
+
+    ///Scratch space for sorting the queries: <Morton code, query index>.
+    std::vector< std::pair<boost::uint32_t, size_t> > keys;
+    std::vector<size_t> answerOrder;
+};
+
+}
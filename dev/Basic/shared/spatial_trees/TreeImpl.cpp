@@ -0,0 +1,24 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "TreeImpl.hpp"
+
+#include "geospatial/network/Point.hpp"
+#include "spatial_trees/AuraQueryBatch.hpp"
+
+using namespace sim_mob;
+
+void TreeImpl::agentsInRects(AuraQueryBatch &batch) const
+{
+    const std::vector<size_t> &order = batch.beginAnswers();
+    for (std::vector<size_t>::const_iterator it = order.begin(); it != order.end(); ++it)
+    {
+        const AuraQueryBatch::Query &query = batch.getQuery(*it);
+        std::vector<Agent const *> found = agentsInRect(Point(query.minX, query.minY), Point(query.maxX, query.maxY), query.refAgent);
+
+        std::vector<Agent const *> &results = batch.beginAnswer(*it);
+        results.insert(results.end(), found.begin(), found.end());
+        batch.endAnswer(*it);
+    }
+}
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <set>
+#include <vector>
 
 #include "metrics/Length.hpp"
 
@@ -16,6 +17,7 @@ class Entity;
 class Agent;
 class WayPoint;
 class Point;
+class AuraQueryBatch;
 
 struct TreeItem;
 
@@ -50,6 +52,9 @@ public:
     ///Return the Agents within a given rectangle.
     virtual std::vector<Agent const *> agentsInRect(const Point &lowerLeft, const Point &upperRight, const sim_mob::Agent *refAgent) const = 0;
 
+    ///Answer a batch of rectangle queries. By default, they are answered one at a time (in the batch's order) by agentsInRect().
+    virtual void agentsInRects(AuraQueryBatch &batch) const;
+
     ///Return Agents near to a given Position, with offsets (and Lane) taken into account.
     virtual std::vector<Agent const *> nearbyAgents(const Point &position, const WayPoint &wayPoint, double distanceInFront, double distanceBehind,
                                                     const sim_mob::Agent *refAgent) const = 0;
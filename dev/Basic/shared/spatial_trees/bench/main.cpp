@@ -0,0 +1,365 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+/*
+ * Compares the Aura Manager's spatial indexes: how long each takes to catch up with the agents' movements every
+ * tick, and to answer one rectangle query per agent, one at a time and as an AuraQueryBatch.
+ *
+ * Usage: SM_AuraBench [<ticks> [<agents> ...]]
+ *
+ * The agents drive along a grid of roads (one every 200m, alternating horizontal and vertical) in a 20km square;
+ * each queries a 100m x 20m rectangle around itself, roughly what a driver's nearbyAgents() covers.
+ * The R* tree is also rebuilt on its own, by inserting every agent (as before), and by STR bulk loading with and
+ * without a thread pool; the Sim-R tree is updated with and without a thread pool.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "entities/Agent.hpp"
+#include "entities/AgentRegistry.hpp"
+#include "geospatial/network/Point.hpp"
+#include "spatial_trees/AuraQueryBatch.hpp"
+#include "spatial_trees/TreeImpl.hpp"
+#include "spatial_trees/packing_tree/PackingTreeAuraManager.hpp"
+#include "spatial_trees/rdu_tree/RDUAuraManager.hpp"
+#include "spatial_trees/rstar_tree/RStarAuraManager.hpp"
+#include "spatial_trees/rstar_tree/R_tree.hpp"
+#include "spatial_trees/simtree/SimRTree.hpp"
+#include "util/threadpool/Threadpool.hpp"
+
+using namespace sim_mob;
+
+namespace
+{
+
+const int AREA_MIN = 1000;
+const int AREA_SIZE = 20000;
+const int ROAD_SPACING = 200;
+const int MAX_SPEED = 15;
+const int QUERY_AHEAD = 50;
+const int QUERY_SIDE = 10;
+
+//The Sim-R tree starts from this layout (the area, split in two), and is then rebalanced around the agents.
+const char *SIM_TREE_LAYOUT = "aura_bench_simtree.txt";
+
+typedef std::chrono::steady_clock Clock;
+
+double MillisSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+///An agent which only has a position; it drives along its road, and wraps around at the edge of the area.
+class BenchAgent : public Agent
+{
+public:
+    BenchAgent(bool horizontal, int road, int pos, int speed) : Agent(MtxStrat_Buffered), horizontal(horizontal), road(road),
+        pos(pos), speed(speed)
+    {
+        place();
+    }
+
+    void move()
+    {
+        pos = (pos + speed) % AREA_SIZE;
+        place();
+    }
+
+    virtual bool isNonspatial()
+    {
+        return false;
+    }
+
+protected:
+    virtual Entity::UpdateStatus frame_init(timeslice now)
+    {
+        return Entity::UpdateStatus::Continue;
+    }
+
+    virtual Entity::UpdateStatus frame_tick(timeslice now)
+    {
+        return Entity::UpdateStatus::Continue;
+    }
+
+    virtual void frame_output(timeslice now)
+    {
+    }
+
+private:
+    void place()
+    {
+        xPos.force(AREA_MIN + (horizontal ? pos : road));
+        yPos.force(AREA_MIN + (horizontal ? road : pos));
+    }
+
+    bool horizontal;
+    int road;
+    int pos;
+    int speed;
+};
+
+///The Sim-R tree, driven directly: SimAuraManager places new agents at the origin of their trip (which needs Persons),
+///  and sizes itself to the road network.
+class SimTreeIndex : public TreeImpl
+{
+public:
+    explicit SimTreeIndex(batched::ThreadPool *pool) : pool(pool)
+    {
+    }
+
+    virtual void init()
+    {
+        tree.buildTreeStructure(SIM_TREE_LAYOUT);
+        const AgentRegistry::View &agents = AgentRegistry::getInstance().getSpatialAgents();
+        for (AgentRegistry::View::const_iterator it = agents.begin(); it != agents.end(); ++it)
+        {
+            tree.insertAgent(*it, connectorMap);
+        }
+        tree.rebalance(connectorMap);
+    }
+
+    virtual void update(int time_step, const std::set<Entity *> &removedAgentPointers)
+    {
+        tree.updateAllInternalAgents(connectorMap, removedAgentPointers, pool);
+    }
+
+    virtual std::vector<Agent const *> agentsInRect(const Point &lowerLeft, const Point &upperRight, const Agent *refAgent) const
+    {
+        std::vector<Agent const *> result;
+        SimRTree::BoundingBox box = makeBox(lowerLeft.getX(), lowerLeft.getY(), upperRight.getX(), upperRight.getY());
+        tree.rangeQuery(box, connectorMap.find(refAgent)->second, result);
+        return result;
+    }
+
+    virtual void agentsInRects(AuraQueryBatch &batch) const
+    {
+        const std::vector<size_t> &order = batch.beginAnswers();
+        for (std::vector<size_t>::const_iterator it = order.begin(); it != order.end(); ++it)
+        {
+            const AuraQueryBatch::Query &query = batch.getQuery(*it);
+            SimRTree::BoundingBox box = makeBox(query.minX, query.minY, query.maxX, query.maxY);
+            tree.rangeQuery(box, connectorMap.find(query.refAgent)->second, batch.beginAnswer(*it));
+            batch.endAnswer(*it);
+        }
+    }
+
+    virtual std::vector<Agent const *> nearbyAgents(const Point &position, const WayPoint &wayPoint, double distanceInFront,
+                                                    double distanceBehind, const Agent *refAgent) const
+    {
+        return std::vector<Agent const *>();
+    }
+
+private:
+    static SimRTree::BoundingBox makeBox(double minX, double minY, double maxX, double maxY)
+    {
+        SimRTree::BoundingBox box;
+        box.edges[0].first = minX;
+        box.edges[1].first = minY;
+        box.edges[0].second = maxX;
+        box.edges[1].second = maxY;
+        return box;
+    }
+
+    SimRTree tree;
+    std::map<const Agent *, TreeItem *> connectorMap;
+    batched::ThreadPool *pool;
+};
+
+void PrintRow(const std::string &name, double updateMs, double singleMs, double batchMs, size_t found)
+{
+    std::cout << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(14) << updateMs;
+    if (singleMs >= 0)
+    {
+        std::cout << std::setw(14) << singleMs << std::setw(14) << batchMs << std::setw(14) << found;
+    }
+    std::cout << std::endl;
+}
+
+///Times one index: its update, then one query per agent (singly, then as a batch), on every tick.
+void RunIndex(const std::string &name, TreeImpl &index, std::vector<BenchAgent *> &agents, unsigned int numTicks)
+{
+    const std::set<Entity *> removed;
+    AuraQueryBatch batch;
+    double updateMs = 0;
+    double singleMs = 0;
+    double batchMs = 0;
+    size_t found = 0;
+
+    index.init();
+    for (unsigned int tick = 0; tick < numTicks; ++tick)
+    {
+        for (std::vector<BenchAgent *>::iterator it = agents.begin(); it != agents.end(); ++it)
+        {
+            (*it)->move();
+        }
+
+        Clock::time_point start = Clock::now();
+        index.update(tick, removed);
+        updateMs += MillisSince(start);
+
+        start = Clock::now();
+        for (std::vector<BenchAgent *>::const_iterator it = agents.begin(); it != agents.end(); ++it)
+        {
+            const int x = (*it)->xPos.get();
+            const int y = (*it)->yPos.get();
+            found += index.agentsInRect(Point(x - QUERY_AHEAD, y - QUERY_SIDE), Point(x + QUERY_AHEAD, y + QUERY_SIDE), *it).size();
+        }
+        singleMs += MillisSince(start);
+
+        start = Clock::now();
+        batch.clear();
+        for (std::vector<BenchAgent *>::const_iterator it = agents.begin(); it != agents.end(); ++it)
+        {
+            const int x = (*it)->xPos.get();
+            const int y = (*it)->yPos.get();
+            batch.add(Point(x - QUERY_AHEAD, y - QUERY_SIDE), Point(x + QUERY_AHEAD, y + QUERY_SIDE), *it);
+        }
+        index.agentsInRects(batch);
+        batchMs += MillisSince(start);
+    }
+
+    PrintRow(name, updateMs / numTicks, singleMs / numTicks, batchMs / numTicks, found / numTicks);
+}
+
+///Times rebuilding the R* tree from scratch, by one of the loading strategies.
+void RunRStarRebuild(const std::string &name, std::vector<BenchAgent *> &agents, unsigned int numTicks, bool insert,
+                     batched::ThreadPool *pool)
+{
+    R_tree tree;
+    std::vector<Agent const *> toLoad(agents.begin(), agents.end());
+    double updateMs = 0;
+    for (unsigned int tick = 0; tick < numTicks; ++tick)
+    {
+        for (std::vector<BenchAgent *>::iterator it = agents.begin(); it != agents.end(); ++it)
+        {
+            (*it)->move();
+        }
+
+        Clock::time_point start = Clock::now();
+        if (insert)
+        {
+            tree.RemoveAll();
+            for (std::vector<Agent const *>::const_iterator it = toLoad.begin(); it != toLoad.end(); ++it)
+            {
+                tree.insert(*it);
+            }
+        }
+        else
+        {
+            tree.load(toLoad, pool);
+        }
+        updateMs += MillisSince(start);
+    }
+
+    PrintRow(name, updateMs / numTicks, -1, -1, 0);
+}
+
+void Run(size_t numAgents, unsigned int numTicks, batched::ThreadPool &pool)
+{
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> road(0, AREA_SIZE / ROAD_SPACING - 1);
+    std::uniform_int_distribution<int> pos(0, AREA_SIZE - 1);
+    std::uniform_int_distribution<int> speed(0, MAX_SPEED);
+
+    AgentRegistry::getInstance().clear();
+    std::vector<BenchAgent *> agents;
+    agents.reserve(numAgents);
+    for (size_t i = 0; i < numAgents; ++i)
+    {
+        agents.push_back(new BenchAgent(i % 2 == 0, road(rng) * ROAD_SPACING, pos(rng), speed(rng)));
+        AgentRegistry::getInstance().addAgent(agents.back(), true);
+    }
+
+    std::cout << "\n" << numAgents << " agents, " << numTicks << " ticks\n" << std::left << std::setw(16) << "index"
+              << std::right << std::setw(14) << "update ms" << std::setw(14) << "single ms" << std::setw(14) << "batch ms"
+              << std::setw(14) << "found/tick" << std::endl;
+
+    RunRStarRebuild("rstar-insert", agents, numTicks, true, nullptr);
+    RunRStarRebuild("rstar-str", agents, numTicks, false, nullptr);
+    RunRStarRebuild("rstar-str-par", agents, numTicks, false, &pool);
+
+    {
+        RStarAuraManager index;
+        RunIndex("rstar", index, agents, numTicks);
+    }
+    {
+        RDUAuraManager index;
+        RunIndex("rdu", index, agents, numTicks);
+    }
+    {
+        PackingTreeAuraManager index;
+        RunIndex("packing", index, agents, numTicks);
+    }
+    {
+        SimTreeIndex index(nullptr);
+        RunIndex("simtree", index, agents, numTicks);
+    }
+    {
+        SimTreeIndex index(&pool);
+        RunIndex("simtree-par", index, agents, numTicks);
+    }
+
+    for (std::vector<BenchAgent *>::iterator it = agents.begin(); it != agents.end(); ++it)
+    {
+        delete *it;
+    }
+}
+}
+
+int main(int argc, char *argv[])
+{
+    const unsigned int numTicks = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 5;
+    std::vector<size_t> agentCounts;
+    for (int i = 2; i < argc; ++i)
+    {
+        agentCounts.push_back(std::strtoul(argv[i], nullptr, 10));
+    }
+    if (agentCounts.empty())
+    {
+        agentCounts.push_back(10000);
+        agentCounts.push_back(100000);
+        agentCounts.push_back(500000);
+    }
+    if (numTicks == 0)
+    {
+        std::cerr << "Usage: SM_AuraBench [<ticks> [<agents> ...]]" << std::endl;
+        return 1;
+    }
+
+    //Format: parent id, own id, min x, min y, max x, max y, is leaf.
+    {
+        const int minXY = AREA_MIN - ROAD_SPACING;
+        const int maxXY = AREA_MIN + AREA_SIZE + ROAD_SPACING;
+        const int middle = (minXY + maxXY) / 2;
+        std::ofstream layout(SIM_TREE_LAYOUT);
+        layout << "0 1 " << minXY << " " << minXY << " " << maxXY << " " << maxXY << " 0\n"
+               << "1 2 " << minXY << " " << minXY << " " << middle << " " << maxXY << " 1\n"
+               << "1 3 " << middle + 1 << " " << minXY << " " << maxXY << " " << maxXY << " 1\n";
+    }
+
+    const unsigned int numThreads = boost::thread::hardware_concurrency();
+    batched::ThreadPool pool(numThreads > 1 ? numThreads : 2);
+    std::cout << "Thread pool of " << (numThreads > 1 ? numThreads : 2) << " threads" << std::endl;
+    for (std::vector<size_t>::const_iterator it = agentCounts.begin(); it != agentCounts.end(); ++it)
+    {
+        Run(*it, numTicks, pool);
+    }
+    pool.wait();
+    std::remove(SIM_TREE_LAYOUT);
+    return 0;
+}
@@ -3,12 +3,35 @@
 //   license.txt   (http://opensource.org/licenses/MIT)
 
 #include "PackingTreeAuraManager.hpp"
+
+#include <boost/iterator/function_output_iterator.hpp>
+
+#include "spatial_trees/AuraQueryBatch.hpp"
 #include "spatial_trees/shared_funcs.hpp"
+#include "entities/AgentRegistry.hpp"
 
 using namespace std;
 using namespace sim_mob;
 using namespace spatial;
 
+namespace
+{
+///Appends the agent of each value found by the tree to a result buffer.
+struct AppendAgent
+{
+    std::vector<const Agent *> *results;
+
+    explicit AppendAgent(std::vector<const Agent *> &results) : results(&results)
+    {
+    }
+
+    void operator()(const value &item) const
+    {
+        results->push_back(item.second);
+    }
+};
+}
+
 PackingTreeAuraManager::PackingTreeAuraManager()
 {
     tree = new RTree();
@@ -26,16 +49,13 @@ void PackingTreeAuraManager::update(int time_step, const std::set<sim_mob::Entit
         delete tree;
     }   
 
+    const AgentRegistry::View &spatialAgents = AgentRegistry::getInstance().getSpatialAgents();
     std::vector<value> agentsToBeAdded;
+    agentsToBeAdded.reserve(spatialAgents.size());
     
-    for (std::set<Entity *>::iterator itr = Agent::all_agents.begin(); itr != Agent::all_agents.end(); ++itr)
+    for (AgentRegistry::View::const_iterator itr = spatialAgents.begin(); itr != spatialAgents.end(); ++itr)
     {
-        Agent *agent = dynamic_cast<Agent *> (*itr);
-        if ((!agent) || agent->isNonspatial())
-        {
-            continue;
-        }
-
+        Agent *agent = *itr;
         if (removedAgentPointers.find(agent) == removedAgentPointers.end())
         {
             point location(agent->xPos, agent->yPos);
@@ -64,6 +84,19 @@ std::vector<const Agent*> PackingTreeAuraManager::agentsInRect(const Point &lowe
     return agentsInRectangle;
 }
 
+void PackingTreeAuraManager::agentsInRects(AuraQueryBatch &batch) const
+{
+    const std::vector<size_t> &order = batch.beginAnswers();
+    for (std::vector<size_t>::const_iterator it = order.begin(); it != order.end(); ++it)
+    {
+        const AuraQueryBatch::Query &query = batch.getQuery(*it);
+        box queryBox(point(query.minX, query.minY), point(query.maxX, query.maxY));
+
+        tree->query(bgi::intersects(queryBox), boost::make_function_output_iterator(AppendAgent(batch.beginAnswer(*it))));
+        batch.endAnswer(*it);
+    }
+}
+
 std::vector<const Agent*> PackingTreeAuraManager::nearbyAgents(const Point &position, const WayPoint &wayPoint, double distanceInFront, double distanceBehind, 
                                                                const sim_mob::Agent *refAgent) const
 {
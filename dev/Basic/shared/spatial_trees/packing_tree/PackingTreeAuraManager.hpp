@@ -83,6 +83,14 @@ public:
     virtual std::vector<Agent const *> nearbyAgents(const Point &position, const WayPoint &wayPoint, double distanceInFront, double distanceBehind,
                                                     const sim_mob::Agent *refAgent) const;
 
+    /**
+     * Answer a batch of rectangle queries, in the batch's (locality) order. The agents found are written
+     * straight into the batch's buffer, without an intermediate vector per query.
+     *
+     * @param batch the queries; on return, holds the agents found by each of them
+     */
+    virtual void agentsInRects(AuraQueryBatch &batch) const;
+
 };
 
 }
@@ -6,6 +6,7 @@
 
 #include "spatial_trees/shared_funcs.hpp"
 #include "entities/Agent.hpp"
+#include "entities/AgentRegistry.hpp"
 #include "geospatial/network/Lane.hpp"
 #include "geospatial/network/RoadSegment.hpp"
 #include "entities/Person.hpp"
@@ -22,34 +23,32 @@ bool sim_mob::RDUAuraManager::has_one_agent_du(int agent_id)
 
 void sim_mob::RDUAuraManager::update(int time_step, const std::set<sim_mob::Entity *> &removedAgentPointers)
 {
-    for (std::set<Entity *>::iterator itr = Agent::all_agents.begin(); itr != Agent::all_agents.end(); ++itr)
+    //Removed agents are no longer listed in the registry, so they are taken out of the tree separately.
+    for (std::set<Entity *>::const_iterator itr = removedAgentPointers.begin(); itr != removedAgentPointers.end(); ++itr)
     {
-        Agent *an_agent = dynamic_cast<Agent*> (*itr);
-        if ((!an_agent) || an_agent->isNonspatial())
+        Agent *an_agent = dynamic_cast<Agent *> (*itr);
+        if (an_agent && tree_du.has_one_agent(an_agent->getId()))
         {
-            continue;
+            tree_du.remove(an_agent);
         }
+    }
 
-        bool canBeRemoved = (removedAgentPointers.find(an_agent) != removedAgentPointers.end());
-
-        if (tree_du.has_one_agent(an_agent->getId()) && canBeRemoved)
+    const AgentRegistry::View &spatialAgents = AgentRegistry::getInstance().getSpatialAgents();
+    for (AgentRegistry::View::const_iterator itr = spatialAgents.begin(); itr != spatialAgents.end(); ++itr)
+    {
+        Agent *an_agent = *itr;
+        if (removedAgentPointers.find(an_agent) != removedAgentPointers.end())
         {
-            tree_du.remove(an_agent);
+            continue;
         }
-        else if (tree_du.has_one_agent(an_agent->getId()) && !canBeRemoved)
+
+        if (tree_du.has_one_agent(an_agent->getId()))
         {
             tree_du.update(an_agent->getId(), an_agent->xPos, an_agent->yPos);
         }
-        else if (tree_du.has_one_agent(an_agent->getId()) == false && !canBeRemoved)
-        {
-            tree_du.insert(an_agent);
-        }
         else
         {
-            std::cout << "---------------------" << std::endl;
-            std::cout << "error:" << std::endl;
-            std::cout << "an_agent->getId():" << an_agent->getId() << std::endl;
-            std::cout << "an_agent->can_remove_by_RTREE:" << canBeRemoved << std::endl;
+            tree_du.insert(an_agent);
         }
     }
 }
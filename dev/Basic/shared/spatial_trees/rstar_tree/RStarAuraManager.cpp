@@ -10,27 +10,53 @@
 #include "entities/Person.hpp"
 #include "entities/Entity.hpp"
 #include "entities/Agent.hpp"
+#include "entities/AgentRegistry.hpp"
+#include "spatial_trees/AuraQueryBatch.hpp"
+#include "util/threadpool/Threadpool.hpp"
 
 using namespace sim_mob;
 using namespace sim_mob::spatial;
 
-void RStarAuraManager::update(int time_step, const std::set<sim_mob::Entity *> &removedAgentPointers)
+void RStarAuraManager::init()
 {
-    tree_rstar.RemoveAll();
-    assert(tree_rstar.GetSize() == 0);
+    //The tree is rebuilt between ticks, while the Workers wait, so every core is free to help.
+    const unsigned int numThreads = boost::thread::hardware_concurrency();
+    if (numThreads > 1)
+    {
+        pool.reset(new batched::ThreadPool(numThreads));
+    }
+}
 
-    for (std::set<Entity *>::iterator itr = Agent::all_agents.begin(); itr != Agent::all_agents.end(); ++itr)
+void RStarAuraManager::update(int time_step, const std::set<sim_mob::Entity *> &removedAgentPointers)
+{
+    agents.clear();
+    const AgentRegistry::View &spatialAgents = AgentRegistry::getInstance().getSpatialAgents();
+    for (AgentRegistry::View::const_iterator itr = spatialAgents.begin(); itr != spatialAgents.end(); ++itr)
     {
-        Agent *ag = dynamic_cast<Agent *> (*itr);
-        if ((!ag) || ag->isNonspatial())
+        if (removedAgentPointers.find(*itr) == removedAgentPointers.end())
         {
-            continue;
+            agents.push_back(*itr);
         }
+    }
 
-        if (removedAgentPointers.find(ag) == removedAgentPointers.end())
-        {
-            tree_rstar.insert(ag);
-        }
+    tree_rstar.load(agents, pool.get());
+    assert(tree_rstar.GetSize() == agents.size());
+}
+
+void RStarAuraManager::agentsInRects(AuraQueryBatch &batch) const
+{
+    const std::vector<size_t> &order = batch.beginAnswers();
+    for (std::vector<size_t>::const_iterator it = order.begin(); it != order.end(); ++it)
+    {
+        const AuraQueryBatch::Query &query = batch.getQuery(*it);
+        R_tree::BoundingBox box;
+        box.edges[0].first = query.minX;
+        box.edges[1].first = query.minY;
+        box.edges[0].second = query.maxX;
+        box.edges[1].second = query.maxY;
+
+        tree_rstar.query(box, batch.beginAnswer(*it));
+        batch.endAnswer(*it);
     }
 }
 
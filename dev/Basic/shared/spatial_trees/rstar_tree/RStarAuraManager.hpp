@@ -5,6 +5,8 @@
 #pragma once
 
 #include <set>
+#include <vector>
+#include <boost/shared_ptr.hpp>
 
 #include "R_tree.hpp"
 #include "metrics/Length.hpp"
@@ -22,8 +24,11 @@ class WayPoint;
 class RStarAuraManager : public TreeImpl
 {
 public:
+    virtual void init();
+
     //Note: The pointers in removedAgentPointers will be deleted after this time tick; do *not*
     //      save them anywhere.
+    //The tree is rebuilt from scratch with the STR bulk loading algorithm, in parallel when there are enough agents.
     virtual void update(int time_step, const std::set<sim_mob::Entity *> &removedAgentPointers);
 
     virtual std::vector<Agent const *> agentsInRect(const Point &lowerLeft, const Point &upperRight, const sim_mob::Agent *refAgent) const;
@@ -31,8 +36,17 @@ public:
     virtual std::vector<Agent const *> nearbyAgents(const Point &position, const WayPoint &wayPoint, double distanceInFront, double distanceBehind,
                                                     const sim_mob::Agent *refAgent) const;
 
+    //Answers the queries straight into the batch's buffer, in the batch's (locality) order.
+    virtual void agentsInRects(AuraQueryBatch &batch) const;
+
 private:
     sim_mob::R_tree tree_rstar;
 
+    //Packs the tree in parallel (null on a single core)
+    boost::shared_ptr<batched::ThreadPool> pool;
+
+    //The agents to load into the tree on this update; kept to reuse its memory
+    std::vector<Agent const *> agents;
+
 };
 }
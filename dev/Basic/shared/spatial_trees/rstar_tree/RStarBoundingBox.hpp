@@ -127,6 +127,18 @@ struct RStarBoundingBox
         return true;
     }
 
+    // like overlaps(), but boxes which only touch (or have no extent, like a point) also count
+    inline bool intersects(const RStarBoundingBox<dimensions>& bb) const
+    {
+        for (std::size_t axis = 0; axis < dimensions; axis++)
+        {
+            if (bb.edges[axis].second < edges[axis].first || edges[axis].second < bb.edges[axis].first)
+                return false;
+        }
+
+        return true;
+    }
+
     // calculates the total overlapping area of two boxes
     double overlap(const RStarBoundingBox<dimensions>& bb) const
     {
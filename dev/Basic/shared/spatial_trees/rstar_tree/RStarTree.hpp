@@ -31,6 +31,8 @@
 #include <list>
 #include <vector>
 #include <limits>
+#include <cmath>
+#include <utility>
 #include <algorithm>
 #include <cassert>
 #include <functional>
@@ -296,12 +298,190 @@ public:
     }
     
     
+    // an item to bulk load, along with its bounds
+    typedef std::pair<LeafType, BoundingBox> BulkItem;
+
+    /**
+        \brief Replaces the contents of the tree with the given items, packed 
+        bottom-up with the Sort-Tile-Recursive (STR) algorithm.
+        
+        This is much cheaper than inserting the items one at a time, and the nodes
+        come out nearly full and with little overlap. Nodes are filled up to 
+        max_child_items, so the tree is meant to be queried (and rebuilt) rather 
+        than inserted into afterwards.
+        
+        @param items        The items to load. They are re-ordered.
+    */
+    void BulkLoad(std::vector<BulkItem> &items)
+    {
+        SerialPool pool;
+        BulkLoad(items, pool);
+    }
+    
+    /**
+        \brief Like BulkLoad(items), but the vertical slices of the bottom level
+        (which hold nearly all of the work) are sorted and packed on a thread pool.
+        
+        @param pool         Anything with enqueue(functor) and wait(), e.g. 
+        sim_mob::batched::ThreadPool. It must have no other tasks pending.
+    */
+    template <typename Pool>
+    void BulkLoad(std::vector<BulkItem> &items, Pool &pool)
+    {
+        RemoveAll();
+        if (items.empty())
+            return;
+        
+        // STR: sort by centre along x, and cut into S vertical slices of S
+        // nodes each, where S is the square root of the number of nodes.
+        std::sort(items.begin(), items.end(), SortByCentre(0));
+        const std::size_t sliceSize = GetSliceSize(items.size());
+        
+        std::vector<BulkSlice> slices((items.size() + sliceSize - 1) / sliceSize);
+        for (std::size_t i = 0; i < slices.size(); i++)
+        {
+            slices[i].begin = items.begin() + i * sliceSize;
+            slices[i].end = items.begin() + std::min(items.size(), (i + 1) * sliceSize);
+            pool.enqueue(PackSliceTask(this, &slices[i]));
+        }
+        pool.wait();
+        
+        std::vector<Node*> level;
+        AllLeaves.reserve(items.size());
+        for (typename std::vector<BulkSlice>::iterator it = slices.begin(); it != slices.end(); it++)
+        {
+            AllLeaves.insert(AllLeaves.end(), it->leaves.begin(), it->leaves.end());
+            level.insert(level.end(), it->nodes.begin(), it->nodes.end());
+        }
+        AllNodes.insert(AllNodes.end(), level.begin(), level.end());
+        
+        // The upper levels are tiny in comparison; pack them in the same way.
+        while (level.size() > 1)
+        {
+            std::sort(level.begin(), level.end(), SortByCentre(0));
+            const std::size_t upperSliceSize = GetSliceSize(level.size());
+            
+            std::vector<Node*> upper;
+            for (std::size_t start = 0; start < level.size(); start += upperSliceSize)
+            {
+                typename std::vector<Node*>::iterator first = level.begin() + start;
+                typename std::vector<Node*>::iterator last = level.begin() + std::min(level.size(), start + upperSliceSize);
+                std::sort(first, last, SortByCentre(1));
+                PackRun(first, last, false, upper);
+            }
+            AllNodes.insert(AllNodes.end(), upper.begin(), upper.end());
+            level.swap(upper);
+        }
+        
+        m_root = level.front();
+        m_size = items.size();
+    }
+    
     std::size_t GetSize() const { return m_size; }
     std::size_t GetDimensions() const { return dimensions; }
     
     
 protected:
     
+    // bulk loading: one vertical slice of the bottom level, and what was built from it
+    struct BulkSlice
+    {
+        typename std::vector<BulkItem>::iterator begin;
+        typename std::vector<BulkItem>::iterator end;
+        std::vector<Leaf*> leaves;
+        std::vector<Node*> nodes;
+    };
+    
+    struct PackSliceTask
+    {
+        RStarTree * tree;
+        BulkSlice * slice;
+        
+        PackSliceTask(RStarTree * tree, BulkSlice * slice) : tree(tree), slice(slice) {}
+        
+        void operator()() const
+        {
+            tree->PackSlice(*slice);
+        }
+    };
+    
+    // runs bulk loading tasks on the calling thread
+    struct SerialPool
+    {
+        template <typename Task>
+        void enqueue(Task task) { task(); }
+        void wait() {}
+    };
+    
+    // orders items by the centre of their bounds along one axis
+    struct SortByCentre
+    {
+        std::size_t axis;
+        explicit SortByCentre(std::size_t axis) : axis(axis) {}
+        
+        // (twice the centre, which orders the same)
+        double Centre(const BoundingBox &bound) const
+        {
+            return (double) bound.edges[axis].first + (double) bound.edges[axis].second;
+        }
+        
+        bool operator()(const BulkItem &lhs, const BulkItem &rhs) const
+        {
+            return Centre(lhs.second) < Centre(rhs.second);
+        }
+        
+        bool operator()(const BoundedItem * lhs, const BoundedItem * rhs) const
+        {
+            return Centre(lhs->bound) < Centre(rhs->bound);
+        }
+    };
+    
+    // the number of items in each vertical slice when packing this many items
+    static std::size_t GetSliceSize(std::size_t numItems)
+    {
+        const std::size_t numNodes = (numItems + max_child_items - 1) / max_child_items;
+        const std::size_t numSlices = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(numNodes))));
+        return numSlices * max_child_items;
+    }
+    
+    // creates the leaves of one slice, and packs them into nodes (sorted along y)
+    void PackSlice(BulkSlice &slice)
+    {
+        std::sort(slice.begin, slice.end, SortByCentre(1));
+        
+        slice.leaves.reserve(slice.end - slice.begin);
+        for (typename std::vector<BulkItem>::const_iterator it = slice.begin; it != slice.end; it++)
+        {
+            Leaf * newLeaf = new Leaf();
+            newLeaf->bound = it->second;
+            newLeaf->leaf  = it->first;
+            newLeaf->is_a_leaf = true;
+            slice.leaves.push_back(newLeaf);
+        }
+        
+        PackRun(slice.leaves.begin(), slice.leaves.end(), true, slice.nodes);
+    }
+    
+    // packs consecutive items into nodes of max_child_items
+    template <typename Iterator>
+    static void PackRun(Iterator first, Iterator last, bool hasLeaves, std::vector<Node*> &nodes)
+    {
+        while (first != last)
+        {
+            Iterator chunkEnd = first + std::min<std::size_t>(max_child_items, last - first);
+            
+            Node * node = new Node();
+            node->hasLeaves = hasLeaves;
+            node->is_a_leaf = false;
+            node->items.assign(first, chunkEnd);
+            node->bound.reset();
+            std::for_each(node->items.begin(), node->items.end(), StretchBoundingBox<BoundedItem>(&node->bound));
+            nodes.push_back(node);
+            
+            first = chunkEnd;
+        }
+    }
+    
     // choose subtree: only pass this items that do not have leaves
     // I took out the loop portion of this algorithm, so it only
     // picks a subtree at that particular level
@@ -77,9 +77,10 @@ struct RStarAcceptEnclosing
     const typename Node::BoundingBox &m_bound;
     explicit RStarAcceptEnclosing(const typename Node::BoundingBox &bound) : m_bound(bound) {}
     
+    // a node holding only agents on the edge of the bound (or a single agent) must still be visited
     bool operator()(const Node * const node) const 
     { 
-        return m_bound.overlaps(node->bound);
+        return m_bound.intersects(node->bound);
     }
     
     bool operator()(const Leaf * const leaf) const 
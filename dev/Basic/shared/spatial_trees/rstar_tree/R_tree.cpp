@@ -6,9 +6,15 @@
 
 #include "entities/Agent.hpp"
 #include "spatial_trees/rstar_tree/RStarTree.hpp"
+#include "util/threadpool/Threadpool.hpp"
 
 using namespace sim_mob;
 
+namespace {
+// Below this many agents, packing the tree is quicker than handing it out to other threads.
+const std::size_t MIN_AGENTS_FOR_PARALLEL_LOAD = 20000;
+}
+
 // Return the bounding-box that encloses the agent.
 R_tree::BoundingBox bounding_box_r(Agent const * agent) {
     // The agent has no width nor length.  So the lower-left corner equals to the
@@ -25,15 +31,33 @@ void R_tree::insert(Agent const * agent) {
     Insert(agent, bounding_box_r(agent));
 }
 
+void R_tree::load(std::vector<Agent const *> const & agents, batched::ThreadPool * pool) {
+    bulkItems.clear();
+    bulkItems.reserve(agents.size());
+    for (std::vector<Agent const *>::const_iterator it = agents.begin(); it != agents.end(); ++it) {
+        bulkItems.push_back(BulkItem(*it, bounding_box_r(*it)));
+    }
+
+    if (pool && bulkItems.size() >= MIN_AGENTS_FOR_PARALLEL_LOAD) {
+        BulkLoad(bulkItems, *pool);
+    } else {
+        BulkLoad(bulkItems);
+    }
+}
+
 std::vector<Agent const *> R_tree::query(R_tree::BoundingBox const & box) const {
+    std::vector<Agent const *> result;
+    query(box, result);
+    return result;
+}
+
+void R_tree::query(R_tree::BoundingBox const & box, std::vector<Agent const *> & result) const {
     // R_tree::AcceptEnclosing functor will call the visitor if the agent is enclosed
     // in <box>.  When called, the visitor saves the agent in <result>.  Therefore, when
     // Query() returns, <result> should contain agents that are located inside <box>.
-    std::vector<Agent const *> result;
     const_cast<R_tree*>(this)->Query(R_tree::AcceptEnclosing(box), Collecting_visitor(result));
     // Need to remove the constness of <this> because Query() was not implemented as a
     // const method.
-    return result;
 }
 
 void R_tree::display() {
@@ -19,6 +19,11 @@ namespace sim_mob
 //Forward declarations.
 class Agent;
 
+namespace batched
+{
+class ThreadPool;
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 // R*-Tree
@@ -35,6 +40,11 @@ public:
     void
     insert(Agent const * agent);
 
+    // Replace the contents of the tree with these agents, bulk loaded (see RStarTree::BulkLoad()).
+    // If <pool> is non-null and there are enough agents, the tree is packed on the pool's threads.
+    void
+    load(std::vector<Agent const *> const & agents, batched::ThreadPool * pool);
+
     // Return an array of agents that are located inside the search rectangle.
     // box.edges[].first is the lower-left corner and box.edges[].second is the
     // upper-right corner.  box.edges[0] is the x- component and box.edges[1] is the
@@ -42,6 +52,10 @@ public:
     std::vector<Agent const *>
     query(R_tree::BoundingBox const & box) const;
 
+    // Same as above, but the agents are appended to <result>.
+    void
+    query(R_tree::BoundingBox const & box, std::vector<Agent const *> & result) const;
+
     //display the tree structure
     void display();
 
@@ -49,6 +63,9 @@ public:
     void display(Node * node);
 
 private:
+    // The items handed to BulkLoad() by load(); kept to reuse their memory on every tick.
+    std::vector<BulkItem> bulkItems;
+
     // A visitor that simply collects the agent into an array, which was specified in the
     // constructor.
     struct Collecting_visitor
@@ -9,14 +9,16 @@
 #include "entities/Agent.hpp"
 #include "geospatial/network/Point.hpp"
 #include "geospatial/network/Lane.hpp"
+#include "spatial_trees/AuraQueryBatch.hpp"
 #include "spatial_trees/shared_funcs.hpp"
+#include "util/threadpool/Threadpool.hpp"
 
 using namespace sim_mob;
 using namespace sim_mob::spatial;
 
 void sim_mob::SimAuraManager::update(int time_step, const std::set<sim_mob::Entity *> &removedAgentPointers)
 {
-    tree_sim.updateAllInternalAgents(agent_connector_map, removedAgentPointers);
+    tree_sim.updateAllInternalAgents(agent_connector_map, removedAgentPointers, pool.get());
 
     for (std::vector<Agent const*>::iterator it = new_agents.begin(); it != new_agents.end(); ++it)
     {
@@ -45,6 +47,13 @@ void sim_mob::SimAuraManager::init()
 
     tree_sim.buildTreeStructure();
     tree_sim.initRebalanceSettings();
+
+    //The tree is updated between ticks, while the Workers wait, so every core is free to help.
+    const unsigned int numThreads = boost::thread::hardware_concurrency();
+    if (numThreads > 1)
+    {
+        pool.reset(new batched::ThreadPool(numThreads));
+    }
 }
 
 void sim_mob::SimAuraManager::registerNewAgent(Agent const* ag)
@@ -73,6 +82,40 @@ std::vector<Agent const *> sim_mob::SimAuraManager::agentsInRect(Point const & l
     return tree_sim.rangeQuery(box);
 }
 
+void sim_mob::SimAuraManager::agentsInRects(AuraQueryBatch &batch) const
+{
+    const std::vector<size_t> &order = batch.beginAnswers();
+    for (std::vector<size_t>::const_iterator it = order.begin(); it != order.end(); ++it)
+    {
+        const AuraQueryBatch::Query &query = batch.getQuery(*it);
+        SimRTree::BoundingBox box;
+        box.edges[0].first = query.minX;
+        box.edges[1].first = query.minY;
+        box.edges[0].second = query.maxX;
+        box.edges[1].second = query.maxY;
+
+        std::vector<Agent const *> &results = batch.beginAnswer(*it);
+#ifdef SIM_TREE_BOTTOM_UP_QUERY
+        std::map<const sim_mob::Agent*, TreeItem*>::const_iterator connector = agent_connector_map.end();
+        if (query.refAgent)
+        {
+            connector = agent_connector_map.find(query.refAgent);
+        }
+        if (connector != agent_connector_map.end() && connector->second)
+        {
+            tree_sim.rangeQuery(box, connector->second, results);
+        }
+        else
+        {
+            tree_sim.rangeQuery(box, results);
+        }
+#else
+        tree_sim.rangeQuery(box, results);
+#endif
+        batch.endAnswer(*it);
+    }
+}
+
 std::vector<Agent const *> sim_mob::SimAuraManager::nearbyAgents(const Point &position, const WayPoint &wayPoint, double distanceInFront, double distanceBehind,
                                                                  const sim_mob::Agent *refAgent) const
 {
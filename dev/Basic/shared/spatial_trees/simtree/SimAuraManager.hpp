@@ -6,6 +6,7 @@
 
 #include <map>
 #include <set>
+#include <boost/shared_ptr.hpp>
 
 #include "SimRTree.hpp"
 
@@ -79,6 +80,13 @@ public:
     virtual std::vector<Agent const *> nearbyAgents(const Point &position, const WayPoint &wayPoint, double distanceInFront, double distanceBehind,
                                                     const sim_mob::Agent *refAgent) const;
 
+    /**
+     * Answer a batch of rectangle queries, in the batch's (locality) order. Like agentsInRect(), queries by a
+     * known agent use the bottom-up query. The agents found are appended straight to the batch's buffer.
+     *   \param batch The queries; on return, holds the agents found by each of them.
+     */
+    virtual void agentsInRects(AuraQueryBatch &batch) const;
+
     /**
      * Return a collection of agents that are located in the axially-aligned rectangle.
      *   \param lowerLeft The lower left corner of the axially-aligned search rectangle.
@@ -110,6 +118,9 @@ public:
 private:
     sim_mob::SimRTree tree_sim;
 
+    //Scans the tree's leaves in parallel on each update (null on a single core)
+    boost::shared_ptr<batched::ThreadPool> pool;
+
     //Add new agents each time step
     std::vector<Agent const*> new_agents;
 
@@ -4,23 +4,30 @@
 
 #include "SimRTree.hpp"
 
+#include <algorithm>
 #include <string>
 #include <limits>
 #include <cmath>
 #include <iostream>
 #include <fstream>
+#include <boost/bind.hpp>
 
 #include "entities/Agent.hpp"
+#include "entities/AgentRegistry.hpp"
 #include "entities/Person.hpp"
 #include "geospatial/network/RoadNetwork.hpp"
 
 #include "conf/ConfigManager.hpp"
 #include "conf/ConfigParams.hpp"
+#include "util/threadpool/Threadpool.hpp"
 
 using namespace sim_mob;
 
 namespace
 {
+//Leaves are scanned in runs of at least this many, and in at most this many runs.
+const std::size_t MIN_LEAVES_PER_SCAN = 64;
+const std::size_t MAX_LEAF_SCANS = 64;
 
 Point WayPointToLocation(const WayPoint &wp)
 {
@@ -69,13 +76,11 @@ double SimRTree::minimum_Rectanle_Border_Length = 1;
 
 int SimRTree::bigtable[DIVIDE_NETWORK_X_INTO_CELLS][DIVIDE_NETWORK_Y_INTO_CELLS];
 
-struct BigTableUpdate : std::unary_function<const Entity *, void>
+struct BigTableUpdate : std::unary_function<const Agent *, void>
 {
-    void operator()(const Entity *item)
+    void operator()(const Agent *agent)
     {
-        const Agent *agent = dynamic_cast<const Agent *>(item);
-        
-        if (agent && agent->xPos > 0 && agent->yPos > 0)
+        if (agent->xPos > 0 && agent->yPos > 0)
         {
             int x = (agent->xPos - SimRTree::network_minimum_x) / SimRTree::division_x_unit_;
             int y = (agent->yPos - SimRTree::network_minimum_y) / SimRTree::division_y_unit_;
@@ -1063,7 +1068,12 @@ void SimRTree::insertAgentEncloseBox(Agent* agent, SimRTree::BoundingBox & agent
 std::vector<Agent const*> SimRTree::rangeQuery(SimRTree::BoundingBox & box) const
 {
     std::vector<Agent const*> result;
+    rangeQuery(box, result);
+    return result;
+}
 
+void SimRTree::rangeQuery(SimRTree::BoundingBox & box, std::vector<Agent const*>& result) const
+{
     if (m_root)
     {
 #ifdef QUERY_PROFILING
@@ -1090,8 +1100,6 @@ std::vector<Agent const*> SimRTree::rangeQuery(SimRTree::BoundingBox & box) cons
         }
 #endif
     }
-
-    return result;
 }
 
 /**
@@ -1101,7 +1109,12 @@ std::vector<Agent const*> SimRTree::rangeQuery(SimRTree::BoundingBox & box) cons
 std::vector<Agent const*> SimRTree::rangeQuery(SimRTree::BoundingBox & box, TreeItem* item) const
 {
     std::vector<Agent const*> result;
+    rangeQuery(box, item, result);
+    return result;
+}
 
+void SimRTree::rangeQuery(SimRTree::BoundingBox & box, TreeItem* item, std::vector<Agent const*>& result) const
+{
 #ifdef MEAUSURE_COUNTS
     static long rangeQuery_counts = 0;
     rangeQuery_counts++;
@@ -1155,76 +1168,95 @@ std::vector<Agent const*> SimRTree::rangeQuery(SimRTree::BoundingBox & box, Tree
         }
 #endif
     }
-
-    return result;
 }
 
 /**
  *
  */
-void SimRTree::updateAllInternalAgents(std::map<const Agent*, TreeItem*>& connectorMap, const std::set<Entity*>& removedAgentPointers)
+void SimRTree::updateAllInternalAgents(std::map<const Agent*, TreeItem*>& connectorMap, const std::set<Entity*>& removedAgentPointers,
+                                       batched::ThreadPool* pool)
 {
-    TreeLeaf* one_leaf = first_leaf;
+    all_leaves.clear();
+    for (TreeLeaf* one_leaf = first_leaf; one_leaf; one_leaf = one_leaf->next)
+    {
+        all_leaves.push_back(one_leaf);
+    }
 
-    while (one_leaf)
+    //Each scan only touches the buffers of its own leaves, so runs of leaves can be scanned in parallel.
+    std::size_t numScans = 1;
+    if (pool)
     {
-        SimRTree::BoundingBox box = one_leaf->bound;
+        numScans = std::max<std::size_t>(1, std::min(MAX_LEAF_SCANS, all_leaves.size() / MIN_LEAVES_PER_SCAN));
+    }
 
-        unsigned int offset = 0;
-        while (offset < one_leaf->agent_buffer.size())
+    std::vector<LeafScan> scans(numScans);
+    for (std::size_t i = 0; i < numScans; i++)
+    {
+        scans[i].first = all_leaves.begin() + (all_leaves.size() * i) / numScans;
+        scans[i].last = all_leaves.begin() + (all_leaves.size() * (i + 1)) / numScans;
+        scans[i].removedAgentPointers = &removedAgentPointers;
+    }
+
+    if (numScans > 1)
+    {
+        for (std::vector<LeafScan>::iterator it = scans.begin(); it != scans.end(); it++)
         {
-            //Case 1: the agent should be removed from the Sim-R Tree
-            Agent * one_agent = (one_leaf->agent_buffer[offset]);
+            pool->enqueue(boost::bind(&LeafScan::operator(), &(*it)));
+        }
+        pool->wait();
+    }
+    else
+    {
+        scans.front()();
+    }
 
-            if (removedAgentPointers.find(one_agent) != removedAgentPointers.end())
-            {
-                std::map<const Agent*, TreeItem*>::iterator it = connectorMap.find(one_agent);
-                if (it != connectorMap.end())
-                {
-                    connectorMap.erase(it);
-                }
+    //The connector map and the re-insertions are handled here, in leaf order.
+    for (std::vector<LeafScan>::iterator it = scans.begin(); it != scans.end(); it++)
+    {
+        for (std::vector<Agent*>::iterator agIt = it->removed.begin(); agIt != it->removed.end(); agIt++)
+        {
+            connectorMap.erase(*agIt);
+        }
+        for (std::vector<Agent*>::iterator agIt = it->moved.begin(); agIt != it->moved.end(); agIt++)
+        {
+            connectorMap.erase(*agIt);
+            insertAgent(*agIt, connectorMap);
+        }
+    }
+}
 
-                one_leaf->agent_buffer.erase(one_leaf->agent_buffer.begin() + (offset));
-                continue;
-            }
+void SimRTree::LeafScan::operator()()
+{
+    for (std::vector<TreeLeaf*>::const_iterator leafIt = first; leafIt != last; leafIt++)
+    {
+        TreeLeaf* one_leaf = *leafIt;
+        SimRTree::BoundingBox box = one_leaf->bound;
+
+        std::size_t kept = 0;
+        for (std::size_t offset = 0; offset < one_leaf->agent_buffer.size(); offset++)
+        {
+            Agent * one_agent = one_leaf->agent_buffer[offset];
 
-            if (one_agent->xPos.get() <= 0 || one_agent->yPos.get() <= 0)
+            //Case 1: the agent should be removed from the Sim-R Tree
+            if (removedAgentPointers->find(one_agent) != removedAgentPointers->end())
             {
-                offset++;
+                removed.push_back(one_agent);
                 continue;
             }
 
-            SimRTree::BoundingBox agent_box = locationBoundingBox(one_agent);
-
-            //Case 2: the agent should be in the same box
+            //Case 2: the agent should be in the same box (or has no location yet)
             //Case 2: It should be the most happen case.
-            if (box.encloses(agent_box))
+            if (one_agent->xPos.get() <= 0 || one_agent->yPos.get() <= 0 || box.encloses(locationBoundingBox(one_agent)))
             {
-                offset++;
+                one_leaf->agent_buffer[kept++] = one_agent;
                 continue;
             }
 
-                //Case 3: The agent should be moved to a different box
-                //Case 3: If the agent was insert into a box which is not scanned, the agent will be checked again. It will cost some CPU. But, since Case 3 is not much, the cost should be accpatable.
-                //Case 3: If the cost is heavy, need to define another variable in agent to skip re-check.
-            else
-            {
-                Agent * one_agent = one_leaf->agent_buffer[offset];
-
-                //one_agent->connector_to_Sim_Tree = nullptr;
-                std::map<const Agent*, TreeItem*>::iterator it = connectorMap.find(one_agent);
-                if (it != connectorMap.end())
-                {
-                    connectorMap.erase(it);
-                }
-
-                one_leaf->agent_buffer.erase(one_leaf->agent_buffer.begin() + (offset));
-                insertAgent(one_agent, connectorMap);
-            }
-        } // end of inside while
-
-        one_leaf = one_leaf->next;
-    } // end of out while loop
+            //Case 3: The agent should be moved to a different box; it is re-inserted once all the leaves are scanned.
+            moved.push_back(one_agent);
+        }
+        one_leaf->agent_buffer.resize(kept);
+    }
 }
 
 /**
@@ -1362,7 +1394,8 @@ void SimRTree::rebalance(std::map<const Agent*, TreeItem*>& agent_connector_map)
 
     //set the agent location
     //use structure & loop
-    for_each(Agent::all_agents.begin(), Agent::all_agents.end(), BigTableUpdate());
+    const AgentRegistry::View &spatialAgents = AgentRegistry::getInstance().getSpatialAgents();
+    for_each(spatialAgents.begin(), spatialAgents.end(), BigTableUpdate());
 
     //build new tree & set root
     TreeNode* one_node = new TreeNode();
@@ -1386,10 +1419,10 @@ void SimRTree::rebalance(std::map<const Agent*, TreeItem*>& agent_connector_map)
     countLeaf();
 
     //re-insert all agents inside
-    for (std::set<Entity*>::iterator itr = Agent::all_agents.begin(); itr != Agent::all_agents.end(); itr++)
+    for (AgentRegistry::View::const_iterator itr = spatialAgents.begin(); itr != spatialAgents.end(); itr++)
     {
-        Agent* agent = dynamic_cast<Agent*> (*itr);
-        if (agent && (agent)->isToBeRemoved() == false)
+        Agent* agent = *itr;
+        if (agent->isToBeRemoved() == false)
         {
             insertAgent(agent, agent_connector_map);
         }
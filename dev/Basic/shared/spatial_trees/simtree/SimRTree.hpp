@@ -32,6 +32,11 @@ namespace sim_mob
 //Forward declarations.
 class Agent;
 
+namespace batched
+{
+class ThreadPool;
+}
+
 //Forward declare structs used in this class.
 struct TreeItem;
 struct TreeLeaf;
@@ -117,19 +122,32 @@ public:
      */
     std::vector<Agent const *> rangeQuery(BoundingBox & box) const;
 
+    /**
+     * As above, but appends the agents found to "result" (e.g., the buffer of an AuraQueryBatch)
+     */
+    void rangeQuery(BoundingBox & box, std::vector<Agent const *>& result) const;
+
     /**
      * Start Query From Somewhere, not from the root.
      * Bottom_Up Query
      */
     std::vector<Agent const*> rangeQuery(SimRTree::BoundingBox & box, TreeItem* item) const;
 
+    /**
+     * As above, but appends the agents found to "result"
+     */
+    void rangeQuery(SimRTree::BoundingBox & box, TreeItem* item, std::vector<Agent const*>& result) const;
+
     /**
      * Automatically Update Internal Agents' Locations
      * The parameter "connectorMap" is passed in from the parent SimAuraManager. The SimRTree updates this instead of modifying the Agent directly.
      * Note: The pointers in removedAgentPointers will be deleted after this time tick; do *not*
      *       save them anywhere.
+     * If "pool" is non-null, the leaves are scanned on its threads; the agents which have left their leaf are then
+     * re-inserted on the calling thread.
      */
-    void updateAllInternalAgents(std::map<const Agent*, TreeItem*>& connectorMap, const std::set<Entity*>& removedAgentPointers);
+    void updateAllInternalAgents(std::map<const Agent*, TreeItem*>& connectorMap, const std::set<Entity*>& removedAgentPointers,
+                                 batched::ThreadPool* pool = nullptr);
 
     /**
      *DEBUG purpose
@@ -176,7 +194,22 @@ private:
     void connectLeafs(TreeNode * one_node);
 
     //
-    BoundingBox locationBoundingBox(Agent * agent);
+    static BoundingBox locationBoundingBox(Agent * agent);
+
+    //Helper struct: the agents set aside by scanning a run of leaves in updateAllInternalAgents()
+    struct LeafScan
+    {
+        std::vector<TreeLeaf*>::const_iterator first;
+        std::vector<TreeLeaf*>::const_iterator last;
+        const std::set<Entity*>* removedAgentPointers;
+        std::vector<Agent*> removed;
+        std::vector<Agent*> moved;
+
+        void operator()();
+    };
+
+    //The leaves, in list order; filled by updateAllInternalAgents()
+    std::vector<TreeLeaf*> all_leaves;
 
     //
     BoundingBox ODBoundingBox(Agent * agent);
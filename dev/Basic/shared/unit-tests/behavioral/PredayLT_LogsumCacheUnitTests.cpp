@@ -0,0 +1,210 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "PredayLT_LogsumCacheUnitTests.hpp"
+
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+#include "behavioral/PredayLT_LogsumCache.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::PredayLT_LogsumCacheUnitTests);
+
+namespace {
+
+//Cached params, tagged with the home location so that results can be told apart.
+PredayLT_LogsumCache::CachedParams MakeParams(int tag)
+{
+    PersonParams* params = new PersonParams();
+    params->setHomeLocation(tag);
+    return PredayLT_LogsumCache::CachedParams(params);
+}
+
+LT_LogsumKey MakeKey(long individualId, int homeTaz, int workTaz, int vehicleOwnership, const std::string& luaDir,
+                     const PersonParams* personParams = nullptr)
+{
+    LT_LogsumKey key(0, 0, 0, 0, "unset");
+    CPPUNIT_ASSERT(PredayLT_LogsumCache::makeKey(individualId, homeTaz, workTaz, vehicleOwnership, personParams, luaDir, key));
+    return key;
+}
+
+//Person params as the long-term model builds them.
+PersonParams MakePersonParams()
+{
+    PersonParams params;
+    params.setPersonId("7");
+    params.setPersonTypeId(1);
+    params.setIncomeId(5);
+    params.setHasWorkplace(true);
+    params.setHomeLocation(10);
+    params.setFixedWorkLocation(20);
+    return params;
+}
+
+//Stands in for the lua computation, counting how often it runs.
+PersonParams Compute(int& numComputed, double logsum)
+{
+    numComputed++;
+    PersonParams params;
+    params.setDpbLogsum(logsum);
+    return params;
+}
+
+} //End unnamed namespace
+
+void unit_tests::PredayLT_LogsumCacheUnitTests::test_hits_and_misses()
+{
+    PredayLT_LogsumCache cache;
+    PredayLT_LogsumCache::CachedParams found;
+
+    const LT_LogsumKey key = MakeKey(7, 10, 20, 1, "TC");
+    CPPUNIT_ASSERT(!cache.find(key, found));
+    cache.insert(key, MakeParams(10));
+
+    CPPUNIT_ASSERT(cache.find(MakeKey(7, 10, 20, 1, "TC"), found));
+    CPPUNIT_ASSERT_EQUAL(10, found->getHomeLocation());
+
+    //Every field of the key takes part in the lookup.
+    CPPUNIT_ASSERT(!cache.find(MakeKey(8, 10, 20, 1, "TC"), found));
+    CPPUNIT_ASSERT(!cache.find(MakeKey(7, 11, 20, 1, "TC"), found));
+    CPPUNIT_ASSERT(!cache.find(MakeKey(7, 10, 21, 1, "TC"), found));
+    CPPUNIT_ASSERT(!cache.find(MakeKey(7, 10, 20, 2, "TC"), found));
+    CPPUNIT_ASSERT(!cache.find(MakeKey(7, 10, 20, 1, "TCZero"), found));
+
+    CPPUNIT_ASSERT_EQUAL(1ul, cache.getHits());
+    CPPUNIT_ASSERT_EQUAL(6ul, cache.getMisses());
+
+    //The first result stored for a key is kept.
+    cache.insert(key, MakeParams(99));
+    CPPUNIT_ASSERT(cache.find(key, found));
+    CPPUNIT_ASSERT_EQUAL(10, found->getHomeLocation());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), cache.size());
+
+    //A disabled cache neither stores nor finds.
+    cache.setEnabled(false);
+    CPPUNIT_ASSERT(!cache.find(key, found));
+    cache.insert(MakeKey(9, 10, 20, 1, "TC"), MakeParams(9));
+    cache.setEnabled(true);
+    CPPUNIT_ASSERT(!cache.find(MakeKey(9, 10, 20, 1, "TC"), found));
+}
+
+void unit_tests::PredayLT_LogsumCacheUnitTests::test_uncacheable_calls()
+{
+    LT_LogsumKey key(0, 0, 0, 0, "unset");
+    PersonParams params;
+
+    //An unresolved lua directory means different scripts in different threads.
+    CPPUNIT_ASSERT(!PredayLT_LogsumCache::makeKey(7, 10, 20, 1, nullptr, "", key));
+    CPPUNIT_ASSERT(!PredayLT_LogsumCache::makeKey(7, 10, 20, 1, &params, "", key));
+    CPPUNIT_ASSERT_EQUAL(std::string("unset"), key.luaScenario);
+
+    CPPUNIT_ASSERT(PredayLT_LogsumCache::makeKey(7, 10, 20, 1, nullptr, "TCPlusOne", key));
+    CPPUNIT_ASSERT_EQUAL(std::string("TCPlusOne"), key.luaScenario);
+    CPPUNIT_ASSERT_EQUAL(7l, key.individualId);
+}
+
+void unit_tests::PredayLT_LogsumCacheUnitTests::test_supplied_params_keys()
+{
+    const PersonParams params = MakePersonParams();
+    const LT_LogsumKey key = MakeKey(7, 10, 20, 1, "TC", &params);
+
+    //Equal params give equal keys, whichever object holds them.
+    const PersonParams copy = MakePersonParams();
+    CPPUNIT_ASSERT(key == MakeKey(7, 10, 20, 1, "TC", &copy));
+    CPPUNIT_ASSERT_EQUAL(hash_value(key), hash_value(MakeKey(7, 10, 20, 1, "TC", &copy)));
+
+    //The params read from the db are not the supplied ones.
+    CPPUNIT_ASSERT(!(key == MakeKey(7, 10, 20, 1, "TC")));
+
+    //A value read by the computation is part of the key.
+    PersonParams otherIncome = MakePersonParams();
+    otherIncome.setIncomeId(6);
+    CPPUNIT_ASSERT(!(key == MakeKey(7, 10, 20, 1, "TC", &otherIncome)));
+
+    //So is the result of a previous computation fed back in.
+    PersonParams computed = MakePersonParams();
+    computed.setActivityLogsum(3, -1.5);
+    CPPUNIT_ASSERT(!(key == MakeKey(7, 10, 20, 1, "TC", &computed)));
+    PersonParams computedAgain = MakePersonParams();
+    computedAgain.setActivityLogsum(3, -1.5);
+    CPPUNIT_ASSERT(MakeKey(7, 10, 20, 1, "TC", &computed) == MakeKey(7, 10, 20, 1, "TC", &computedAgain));
+
+    //The vehicle ownership category is overwritten by the computation; the argument is keyed instead.
+    PersonParams otherCategory = MakePersonParams();
+    otherCategory.setVehicleOwnershipCategory(3);
+    CPPUNIT_ASSERT(key == MakeKey(7, 10, 20, 1, "TC", &otherCategory));
+}
+
+void unit_tests::PredayLT_LogsumCacheUnitTests::test_repeated_supplied_params_hit()
+{
+    PredayLT_LogsumCache cache;
+    const PersonParams personParams = MakePersonParams();
+    int numComputed = 0;
+
+    //HM_Model::getLogsumOfHouseholdVO computes the TC logsum six times with the same arguments.
+    for (int i = 0; i < 6; i++)
+    {
+        PersonParams result = cache.findOrCompute(MakeKey(7, 10, 20, 0, "TC", &personParams),
+                                                  boost::bind(Compute, boost::ref(numComputed), -2.0));
+        CPPUNIT_ASSERT_EQUAL(-2.0, result.getDpbLogsum());
+    }
+    CPPUNIT_ASSERT_EQUAL(1, numComputed);
+    CPPUNIT_ASSERT_EQUAL(5ul, cache.getHits());
+    CPPUNIT_ASSERT_EQUAL(1ul, cache.getMisses());
+
+    //Then once per vehicle ownership option with another scenario.
+    for (int vehicleOwnership = 0; vehicleOwnership <= 5; vehicleOwnership++)
+    {
+        cache.findOrCompute(MakeKey(7, 10, 20, vehicleOwnership, "TCPlusOne", &personParams),
+                            boost::bind(Compute, boost::ref(numComputed), -3.0));
+    }
+    CPPUNIT_ASSERT_EQUAL(7, numComputed);
+
+    //The next household member has other params.
+    PersonParams nextMember = MakePersonParams();
+    nextMember.setPersonId("8");
+    nextMember.setPersonTypeId(4);
+    cache.findOrCompute(MakeKey(8, 10, 20, 0, "TC", &nextMember), boost::bind(Compute, boost::ref(numComputed), -4.0));
+    CPPUNIT_ASSERT_EQUAL(8, numComputed);
+}
+
+void unit_tests::PredayLT_LogsumCacheUnitTests::test_invalidate_scenario()
+{
+    PredayLT_LogsumCache cache;
+    PredayLT_LogsumCache::CachedParams found;
+
+    for (long id = 0; id < 100; id++)
+    {
+        cache.insert(MakeKey(id, 1, 2, 0, "TC"), MakeParams(1));
+        cache.insert(MakeKey(id, 1, 2, 0, "TCZero"), MakeParams(2));
+    }
+    CPPUNIT_ASSERT_EQUAL(std::size_t(200), cache.size());
+
+    cache.invalidate("TCZero");
+    CPPUNIT_ASSERT_EQUAL(std::size_t(100), cache.size());
+    CPPUNIT_ASSERT(cache.find(MakeKey(5, 1, 2, 0, "TC"), found));
+    CPPUNIT_ASSERT(!cache.find(MakeKey(5, 1, 2, 0, "TCZero"), found));
+
+    cache.invalidate();
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), cache.size());
+    CPPUNIT_ASSERT_EQUAL(2ul, cache.getInvalidations());
+}
+
+void unit_tests::PredayLT_LogsumCacheUnitTests::test_lru_eviction()
+{
+    //One entry per shard; all variants of one person share a shard.
+    PredayLT_LogsumCache cache(1);
+    PredayLT_LogsumCache::CachedParams found;
+
+    const LT_LogsumKey first = MakeKey(3, 1, 2, 0, "TC");
+    const LT_LogsumKey second = MakeKey(3, 1, 2, 1, "TC");
+    cache.insert(first, MakeParams(1));
+    cache.insert(second, MakeParams(2));
+
+    CPPUNIT_ASSERT_EQUAL(1ul, cache.getEvictions());
+    CPPUNIT_ASSERT(!cache.find(first, found));
+    CPPUNIT_ASSERT(cache.find(second, found));
+    CPPUNIT_ASSERT_EQUAL(2, found->getHomeLocation());
+}
@@ -0,0 +1,48 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the cache of long-term logsum computations.
+ */
+class PredayLT_LogsumCacheUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///A repeated key hits and returns the stored params; any differing key field misses.
+    void test_hits_and_misses();
+
+    ///Calls with no resolved lua directory get no key.
+    void test_uncacheable_calls();
+
+    ///Calls with caller-supplied person params are keyed on the values the computation reads.
+    void test_supplied_params_keys();
+
+    ///The repeated calls made with the same long-term params for one household are computed once.
+    void test_repeated_supplied_params_hit();
+
+    ///Invalidating a scenario drops only the results computed with that scenario.
+    void test_invalidate_scenario();
+
+    ///A full shard evicts its least recently used entry.
+    void test_lru_eviction();
+
+private:
+    CPPUNIT_TEST_SUITE(PredayLT_LogsumCacheUnitTests);
+        CPPUNIT_TEST(test_hits_and_misses);
+        CPPUNIT_TEST(test_uncacheable_calls);
+        CPPUNIT_TEST(test_supplied_params_keys);
+        CPPUNIT_TEST(test_repeated_supplied_params_hit);
+        CPPUNIT_TEST(test_invalidate_scenario);
+        CPPUNIT_TEST(test_lru_eviction);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
@@ -162,6 +162,7 @@ namespace
         // No need to define the ctor and dtor.
 
         size_t managed_data_count() const { return managedData.size(); }
+        size_t dirty_data_count() const { return dirtyData.size(); }
     };
 }
 
@@ -475,6 +476,75 @@ void BufferedUnitTests::test_BufferedDataManager_stopManaging()
     CPPUNIT_ASSERT(0 == mgr2.managed_data_count());
 }
 
+void BufferedUnitTests::test_BufferedDataManager_flips_changed_data_only()
+{
+    sim_mob::Buffered_uint32 integer(42);
+    sim_mob::Buffered<float> floater(3.14159f);
+    BufferedColor color(red);
+
+    DataManager mgr;
+    mgr.beginManaging(&integer);
+    mgr.beginManaging(&floater);
+    mgr.beginManaging(&color);
+    mgr.flip();
+    CPPUNIT_ASSERT(0 == mgr.dirty_data_count());
+
+    integer++;
+    integer += 2;
+    color.set(green);
+    color.set(amber);
+    CPPUNIT_ASSERT(2 == mgr.dirty_data_count());
+
+    mgr.flip();
+    CPPUNIT_ASSERT(0 == mgr.dirty_data_count());
+    CPPUNIT_ASSERT(45 == integer);
+    CPPUNIT_ASSERT(3.14159f == floater);
+    CPPUNIT_ASSERT(amber == color);
+
+    // Nothing changed; flipping again leaves everything as it is.
+    mgr.flip();
+    CPPUNIT_ASSERT(45 == integer);
+    CPPUNIT_ASSERT(amber == color);
+
+    mgr.stopManaging(&integer);
+    mgr.stopManaging(&floater);
+    mgr.stopManaging(&color);
+}
+
+void BufferedUnitTests::test_BufferedDataManager_pending_value_follows_datum()
+{
+    sim_mob::Buffered_uint32 integer(42);
+    sim_mob::Buffered<float> floater(3.14159f);
+
+    // Set before being managed; the first flip applies it.
+    integer.set(7);
+    DataManager mgr1;
+    mgr1.beginManaging(&integer);
+    mgr1.beginManaging(&floater);
+    mgr1.flip();
+    CPPUNIT_ASSERT(7 == integer);
+
+    // Set, then moved to another manager before the flip.
+    floater.set(2.71828f);
+    integer++;
+    mgr1.stopManaging(&floater);
+    CPPUNIT_ASSERT(1 == mgr1.dirty_data_count());
+
+    mgr1.flip();
+    CPPUNIT_ASSERT(8 == integer);
+    CPPUNIT_ASSERT(3.14159f == floater);
+
+    DataManager mgr2;
+    mgr2.beginManaging(&floater);
+    mgr2.flip();
+    CPPUNIT_ASSERT(2.71828f == floater);
+
+    mgr1.stopManaging(&integer);
+    mgr2.stopManaging(&floater);
+    CPPUNIT_ASSERT(0 == mgr1.managed_data_count());
+    CPPUNIT_ASSERT(0 == mgr2.managed_data_count());
+}
+
 void BufferedUnitTests::test_the_Vector2D_float_class()
 {
     // This is lazy: the better approach is to have a separate method of the BufferedUnitTests
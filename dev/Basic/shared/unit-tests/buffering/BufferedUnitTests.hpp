@@ -103,7 +103,7 @@ public:
      * Tests the BufferedDataManager flipping all of its managed data.
      *
      * This test confirms that the BufferedDataManager will flip all Buffered<T> objects
-     * that it is managing, even if some of the objects have not changed their values.
+     * that it is managing and whose values were changed, and leave the others as they are.
      */
     void test_BufferedDataManager_with_several_Buffered_T_objects();
 
@@ -154,6 +154,22 @@ public:
      */
     void test_BufferedDataManager_stopManaging();
 
+    /**
+     * Tests that the BufferedDataManager only flips the data changed since the last flip.
+     *
+     * This test confirms that setting a Buffered<T> object several times during a tick
+     * records it once, and that flipping clears the record.
+     */
+    void test_BufferedDataManager_flips_changed_data_only();
+
+    /**
+     * Tests a Buffered<T> object changed while it was not managed, or just before it migrated.
+     *
+     * This test confirms that the pending value is flipped by the next manager, and never by the
+     * previous one.
+     */
+    void test_BufferedDataManager_pending_value_follows_datum();
+
     /**
      * Tests the Vector2D class.
      *
@@ -179,6 +195,8 @@ private:
         CPPUNIT_TEST(test_BufferedDataManager_doubleBeginManage);
         CPPUNIT_TEST(test_BufferedDataManager_doubleStopManaging);
         CPPUNIT_TEST(test_BufferedDataManager_stopManaging);
+        CPPUNIT_TEST(test_BufferedDataManager_flips_changed_data_only);
+        CPPUNIT_TEST(test_BufferedDataManager_pending_value_follows_datum);
         CPPUNIT_TEST(test_the_Vector2D_float_class);
     CPPUNIT_TEST_SUITE_END();
 };
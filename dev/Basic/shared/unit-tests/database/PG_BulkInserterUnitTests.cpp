@@ -0,0 +1,313 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "PG_BulkInserterUnitTests.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <boost/thread/mutex.hpp>
+#include "database/PG_BulkInserter.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::PG_BulkInserterUnitTests);
+
+namespace {
+
+const char* const OUTPUT_PREFIX = "bulk_inserter_unit_test";
+const char* const INPUT_FILE = "bulk_inserter_unit_test.csv";
+
+std::vector<std::string> ReadLines(const std::string& fileName)
+{
+    std::vector<std::string> lines;
+    std::ifstream file(fileName.c_str());
+    std::string line;
+    while (std::getline(file, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+std::string PartitionFile(unsigned int partition)
+{
+    std::stringstream fileName;
+    fileName <<OUTPUT_PREFIX <<"." <<partition;
+    return fileName.str();
+}
+
+void RemoveOutput(unsigned int numPartitions)
+{
+    for (unsigned int i=0; i<numPartitions; i++) {
+        std::remove(PartitionFile(i).c_str());
+    }
+}
+
+std::vector<std::string> Row(const std::string& key, int seq)
+{
+    std::stringstream value;
+    value <<seq;
+    std::vector<std::string> row;
+    row.push_back(key);
+    row.push_back(value.str());
+    return row;
+}
+
+//Calls made on the sinks of all partitions, in order
+struct SinkCalls {
+    boost::mutex mutex;
+    std::vector<std::string> calls;
+
+    void add(const std::string& call) {
+        boost::mutex::scoped_lock lock(mutex);
+        calls.push_back(call);
+    }
+
+    size_t count(const std::string& call) {
+        return std::count(calls.begin(), calls.end(), call);
+    }
+
+    //Position of the first occurrence; the number of calls if there is none
+    size_t first(const std::string& prefix) {
+        for (size_t i=0; i<calls.size(); i++) {
+            if (calls[i].compare(0, prefix.size(), prefix) == 0) {
+                return i;
+            }
+        }
+        return calls.size();
+    }
+};
+
+//Records its calls, and fails the ones it is told to
+class RecordingSink : public CopySink {
+public:
+    enum Failure { NONE, BEGIN, PREPARE, COMMIT };
+
+    RecordingSink(SinkCalls& calls, const std::string& name, Failure failure=NONE)
+        : calls(calls), name(name), failure(failure)
+    {}
+
+    virtual bool begin() {
+        calls.add("begin " + name);
+        return failure != BEGIN;
+    }
+
+    virtual bool copy(const std::string& query, const std::string& rows) {
+        return true;
+    }
+
+    virtual bool prepare(const std::string& transactionId) {
+        calls.add("prepare " + name);
+        return failure != PREPARE;
+    }
+
+    virtual bool commit() {
+        calls.add("commit " + name);
+        return failure != COMMIT;
+    }
+
+    virtual void rollback() {
+        calls.add("rollback " + name);
+    }
+
+    virtual bool isTwoPhase() const {
+        return true;
+    }
+
+private:
+    SinkCalls& calls;
+    std::string name;
+    Failure failure;
+};
+
+} //End anon namespace
+
+void unit_tests::PG_BulkInserterUnitTests::test_rows_partitioned_by_key()
+{
+    const unsigned int numPartitions = 4;
+    const int numKeys = 200;
+    const int rowsPerKey = 5;
+    {
+        PG_BulkInserter inserter(10, numPartitions, 2);
+        inserter.connectToFiles(OUTPUT_PREFIX);
+        CPPUNIT_ASSERT(inserter.buildQuery("test.table", std::vector<std::string>(2, "col")));
+        for (int seq=0; seq<rowsPerKey; seq++) {
+            for (int key=0; key<numKeys; key++) {
+                std::stringstream keyStr;
+                keyStr <<"person-" <<key;
+                inserter.addRow(Row(keyStr.str(), seq));
+            }
+        }
+        CPPUNIT_ASSERT(inserter.flush());
+    }
+
+    //Key -> (partition, last seq seen)
+    std::map<std::string, std::pair<unsigned int, int> > seen;
+    size_t total = 0;
+    unsigned int usedPartitions = 0;
+    for (unsigned int i=0; i<numPartitions; i++) {
+        std::vector<std::string> lines = ReadLines(PartitionFile(i));
+        usedPartitions += lines.empty() ? 0 : 1;
+        total += lines.size();
+        for (std::vector<std::string>::const_iterator it=lines.begin(); it!=lines.end(); it++) {
+            std::string::size_type comma = it->find(',');
+            CPPUNIT_ASSERT(comma != std::string::npos);
+            std::string key = it->substr(0, comma);
+            int seq = atoi(it->substr(comma+1).c_str());
+            if (seen.count(key)) {
+                CPPUNIT_ASSERT_EQUAL(i, seen[key].first);
+                CPPUNIT_ASSERT_EQUAL(seen[key].second+1, seq);
+            } else {
+                CPPUNIT_ASSERT_EQUAL(0, seq);
+            }
+            seen[key] = std::make_pair(i, seq);
+        }
+    }
+    CPPUNIT_ASSERT_EQUAL((size_t) (numKeys*rowsPerKey), total);
+    CPPUNIT_ASSERT_EQUAL((size_t) numKeys, seen.size());
+    CPPUNIT_ASSERT(usedPartitions > 1);
+
+    RemoveOutput(numPartitions);
+}
+
+void unit_tests::PG_BulkInserterUnitTests::test_bulk_insert_input_file()
+{
+    const unsigned int numPartitions = 3;
+    std::vector<std::string> input;
+    {
+        std::ofstream file(INPUT_FILE);
+        for (int i=0; i<1000; i++) {
+            std::stringstream line;
+            line <<(i%37) <<",1," <<i <<",some\\,text";
+            input.push_back(line.str());
+            file <<line.str() <<"\n";
+        }
+    }
+
+    {
+        PG_BulkInserter inserter(50, numPartitions);
+        inserter.connectToFiles(OUTPUT_PREFIX);
+        inserter.buildQuery("test.table", std::vector<std::string>(4, "col"));
+        CPPUNIT_ASSERT(inserter.setInputFile(INPUT_FILE));
+        CPPUNIT_ASSERT(inserter.bulkInsert());
+    }
+
+    std::vector<std::string> output;
+    for (unsigned int i=0; i<numPartitions; i++) {
+        std::vector<std::string> lines = ReadLines(PartitionFile(i));
+        output.insert(output.end(), lines.begin(), lines.end());
+    }
+    std::sort(input.begin(), input.end());
+    std::sort(output.begin(), output.end());
+    CPPUNIT_ASSERT(input == output);
+
+    RemoveOutput(numPartitions);
+    std::remove(INPUT_FILE);
+}
+
+void unit_tests::PG_BulkInserterUnitTests::test_field_escaping()
+{
+    {
+        PG_BulkInserter inserter(10);
+        inserter.connectToFiles(OUTPUT_PREFIX);
+        inserter.buildQuery("test.table", std::vector<std::string>(3, "col"));
+        std::vector<std::string> row;
+        row.push_back("a,b");
+        row.push_back("back\\slash");
+        row.push_back("two\nlines\r");
+        inserter.addRow(row);
+        CPPUNIT_ASSERT(inserter.flush());
+    }
+
+    std::vector<std::string> lines = ReadLines(PartitionFile(0));
+    CPPUNIT_ASSERT_EQUAL((size_t) 1, lines.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("a\\,b,back\\\\slash,two\\nlines\\r"), lines[0]);
+
+    RemoveOutput(1);
+}
+
+void unit_tests::PG_BulkInserterUnitTests::test_failed_sink()
+{
+    PG_BulkInserter inserter(1, 2, 1);
+    inserter.connectToFiles("no_such_directory/bulk_inserter_unit_test");
+    inserter.buildQuery("test.table", std::vector<std::string>(2, "col"));
+    for (int i=0; i<100; i++) {
+        inserter.addRow(Row("key", i));
+    }
+    CPPUNIT_ASSERT(!inserter.flush());
+
+    //Not connected at all
+    PG_BulkInserter unconnected(1);
+    unconnected.addRow(Row("key", 0));
+    CPPUNIT_ASSERT(!unconnected.flush());
+}
+
+void unit_tests::PG_BulkInserterUnitTests::test_prepare_before_commit()
+{
+    {
+        SinkCalls calls;
+        PG_BulkInserter inserter(1, 3);
+        inserter.partitions[0]->sink.reset(new RecordingSink(calls, "0"));
+        inserter.partitions[1]->sink.reset(new RecordingSink(calls, "1"));
+        inserter.partitions[2]->sink.reset(new RecordingSink(calls, "2"));
+        for (int i=0; i<30; i++) {
+            inserter.addRow(Row("key", i));
+        }
+        CPPUNIT_ASSERT(inserter.flush());
+        CPPUNIT_ASSERT_EQUAL((size_t) 3, calls.count("prepare 0") + calls.count("prepare 1") + calls.count("prepare 2"));
+        CPPUNIT_ASSERT_EQUAL((size_t) 3, calls.count("commit 0") + calls.count("commit 1") + calls.count("commit 2"));
+        CPPUNIT_ASSERT(calls.first("commit") > calls.first("prepare 0"));
+        CPPUNIT_ASSERT(calls.first("commit") > calls.first("prepare 1"));
+        CPPUNIT_ASSERT(calls.first("commit") > calls.first("prepare 2"));
+        CPPUNIT_ASSERT_EQUAL((size_t) 0, calls.count("rollback 0") + calls.count("rollback 1") + calls.count("rollback 2"));
+    }
+
+    SinkCalls calls;
+    PG_BulkInserter inserter(1, 3);
+    inserter.partitions[0]->sink.reset(new RecordingSink(calls, "0"));
+    inserter.partitions[1]->sink.reset(new RecordingSink(calls, "1", RecordingSink::PREPARE));
+    inserter.partitions[2]->sink.reset(new RecordingSink(calls, "2"));
+    inserter.addRow(Row("key", 0));
+    CPPUNIT_ASSERT(!inserter.flush());
+    CPPUNIT_ASSERT_EQUAL((size_t) 0, calls.count("commit 0") + calls.count("commit 1") + calls.count("commit 2"));
+    CPPUNIT_ASSERT_EQUAL((size_t) 1, calls.count("rollback 0"));
+    CPPUNIT_ASSERT_EQUAL((size_t) 1, calls.count("rollback 1"));
+    CPPUNIT_ASSERT_EQUAL((size_t) 1, calls.count("rollback 2"));
+}
+
+void unit_tests::PG_BulkInserterUnitTests::test_rollback_only_begun()
+{
+    SinkCalls calls;
+    PG_BulkInserter inserter(1, 3);
+    inserter.partitions[0]->sink.reset(new RecordingSink(calls, "0"));
+    inserter.partitions[1]->sink.reset(new RecordingSink(calls, "1", RecordingSink::BEGIN));
+    inserter.partitions[2]->sink.reset(new RecordingSink(calls, "2"));
+    for (int i=0; i<30; i++) {
+        inserter.addRow(Row("key", i));
+    }
+    CPPUNIT_ASSERT(!inserter.flush());
+    CPPUNIT_ASSERT_EQUAL((size_t) 1, calls.count("rollback 0"));
+    CPPUNIT_ASSERT_EQUAL((size_t) 0, calls.count("rollback 1"));
+    CPPUNIT_ASSERT_EQUAL((size_t) 1, calls.count("rollback 2"));
+    CPPUNIT_ASSERT_EQUAL((size_t) 0, calls.count("prepare 1"));
+}
+
+void unit_tests::PG_BulkInserterUnitTests::test_failed_commit()
+{
+    SinkCalls calls;
+    PG_BulkInserter inserter(1, 3);
+    inserter.partitions[0]->sink.reset(new RecordingSink(calls, "0", RecordingSink::COMMIT));
+    inserter.partitions[1]->sink.reset(new RecordingSink(calls, "1"));
+    inserter.partitions[2]->sink.reset(new RecordingSink(calls, "2"));
+    inserter.addRow(Row("key", 0));
+    CPPUNIT_ASSERT(!inserter.flush());
+    CPPUNIT_ASSERT_EQUAL((size_t) 1, calls.count("commit 0"));
+    CPPUNIT_ASSERT_EQUAL((size_t) 1, calls.count("commit 1"));
+    CPPUNIT_ASSERT_EQUAL((size_t) 1, calls.count("commit 2"));
+    CPPUNIT_ASSERT_EQUAL((size_t) 0, calls.count("rollback 0") + calls.count("rollback 1") + calls.count("rollback 2"));
+}
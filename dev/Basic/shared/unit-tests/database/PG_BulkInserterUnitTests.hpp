@@ -0,0 +1,52 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the partitioned COPY pipeline of PG_BulkInserter, using file sinks instead of a database.
+ */
+class PG_BulkInserterUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///All rows are copied once; rows with the same key go to one partition, in the order they were added.
+    void test_rows_partitioned_by_key();
+
+    ///Lines of an input file are copied unchanged.
+    void test_bulk_insert_input_file();
+
+    ///Fields are escaped for the text format of COPY.
+    void test_field_escaping();
+
+    ///A sink which cannot be opened fails the flush without blocking the producer, and nothing is committed.
+    void test_failed_sink();
+
+    ///All partitions are prepared before any is committed; a failed prepare rolls every partition back.
+    void test_prepare_before_commit();
+
+    ///Only the sinks which began a transaction are rolled back.
+    void test_rollback_only_begun();
+
+    ///A failed commit does not stop the other partitions from being committed, and fails the flush.
+    void test_failed_commit();
+
+private:
+    CPPUNIT_TEST_SUITE(PG_BulkInserterUnitTests);
+        CPPUNIT_TEST(test_rows_partitioned_by_key);
+        CPPUNIT_TEST(test_bulk_insert_input_file);
+        CPPUNIT_TEST(test_field_escaping);
+        CPPUNIT_TEST(test_failed_sink);
+        CPPUNIT_TEST(test_prepare_before_commit);
+        CPPUNIT_TEST(test_rollback_only_begun);
+        CPPUNIT_TEST(test_failed_commit);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
@@ -0,0 +1,195 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "AgentRegistryUnitTests.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+#include "entities/AgentRegistry.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::AgentRegistryUnitTests);
+
+namespace {
+
+//What a full scan of the agents would look at.
+struct TestAgent {
+    TestAgent() : listed(false), spatial(false), role(0), segment(NULL) {}
+
+    bool listed;
+    bool spatial;
+    int role;
+    const int* segment;
+};
+
+typedef TypedAgentRegistry<TestAgent, int> TestRegistry;
+
+const int DRIVER = 1;
+const int PEDESTRIAN = 3;
+
+//The registry is a singleton; each test starts from an empty one.
+TestRegistry& GetEmptyRegistry()
+{
+    TestRegistry& registry = TestRegistry::getInstance();
+    registry.clear();
+    return registry;
+}
+
+bool SameAgents(TestRegistry::View view, TestRegistry::View expected)
+{
+    std::sort(view.begin(), view.end());
+    std::sort(expected.begin(), expected.end());
+    return view == expected;
+}
+
+} //End anon namespace
+
+
+void unit_tests::AgentRegistryUnitTests::test_spatial_view()
+{
+    TestRegistry& registry = GetEmptyRegistry();
+    TestAgent ag1, ag2, ag3, signal;
+
+    registry.addAgent(&ag1, true);
+    registry.addAgent(&ag2, true);
+    registry.addAgent(&signal, false);
+    registry.addAgent(&ag3, true);
+    registry.addAgent(&ag1, true);
+    CPPUNIT_ASSERT_MESSAGE("Spatial view wrong after adding.", registry.getSpatialAgents().size()==3);
+
+    //Removing the first agent moves the last one into its slot.
+    registry.removeAgent(&ag1);
+    registry.removeAgent(&ag1);
+    registry.removeAgent(&signal);
+    CPPUNIT_ASSERT_MESSAGE("Spatial view wrong after removing.", registry.getSpatialAgents().size()==2 && registry.getSpatialAgents().front()==&ag3);
+
+    registry.removeAgent(&ag3);
+    registry.removeAgent(&ag2);
+    CPPUNIT_ASSERT_MESSAGE("Spatial view not empty.", registry.getSpatialAgents().empty());
+}
+
+void unit_tests::AgentRegistryUnitTests::test_role_views()
+{
+    TestRegistry& registry = GetEmptyRegistry();
+    TestAgent ag1, ag2;
+
+    //A pending person already has its first role.
+    registry.setRole(&ag1, DRIVER);
+    CPPUNIT_ASSERT_MESSAGE("Agent listed before it was added.", registry.getAgentsWithRole(DRIVER).empty());
+    registry.addAgent(&ag1, true);
+    registry.addAgent(&ag2, true);
+    registry.setRole(&ag2, DRIVER);
+    CPPUNIT_ASSERT_MESSAGE("Drivers not listed.", registry.getAgentsWithRole(DRIVER).size()==2);
+
+    registry.setRole(&ag1, PEDESTRIAN);
+    CPPUNIT_ASSERT_MESSAGE("Role change not reflected.", registry.getAgentsWithRole(DRIVER).size()==1
+            && registry.getAgentsWithRole(DRIVER).front()==&ag2 && registry.getAgentsWithRole(PEDESTRIAN).size()==1);
+
+    registry.setRole(&ag2, TestRegistry::NO_ROLE);
+    registry.removeAgent(&ag1);
+    CPPUNIT_ASSERT_MESSAGE("Role views not empty.", registry.getAgentsWithRole(DRIVER).empty()
+            && registry.getAgentsWithRole(PEDESTRIAN).empty() && registry.getAgentsWithRole(99).empty());
+    CPPUNIT_ASSERT_MESSAGE("Agent without a role removed from the spatial view.", registry.getSpatialAgents().size()==1);
+}
+
+void unit_tests::AgentRegistryUnitTests::test_segment_views()
+{
+    TestRegistry& registry = GetEmptyRegistry();
+    TestAgent ag1, ag2;
+    int seg1 = 0;
+    int seg2 = 0;
+
+    registry.addAgent(&ag1, true);
+    registry.addAgent(&ag2, true);
+    registry.setRole(&ag1, DRIVER);
+    registry.setRole(&ag2, DRIVER);
+    registry.setSegment(&ag1, &seg1);
+    registry.setSegment(&ag2, &seg1);
+    registry.setSegment(&ag1, &seg2);
+    CPPUNIT_ASSERT_MESSAGE("Segment views wrong.", registry.getVehiclesOnSegment(&seg1).size()==1
+            && registry.getVehiclesOnSegment(&seg1).front()==&ag2 && registry.getVehiclesOnSegment(&seg2).front()==&ag1);
+
+    //In an intersection.
+    registry.setSegment(&ag2, NULL);
+    CPPUNIT_ASSERT_MESSAGE("Vehicle still on its segment.", registry.getVehiclesOnSegment(&seg1).empty());
+
+    //Parked; the new role reports its own segment, if any.
+    registry.setRole(&ag1, PEDESTRIAN);
+    CPPUNIT_ASSERT_MESSAGE("Segment kept after a role change.", registry.getVehiclesOnSegment(&seg2).empty());
+}
+
+void unit_tests::AgentRegistryUnitTests::test_matches_full_scan()
+{
+    srand(42);
+    TestRegistry& registry = GetEmptyRegistry();
+
+    std::vector<TestAgent> agents(300);
+    std::vector<int> segments(20);
+    const int numRoles = 6;
+
+    for (int step=0; step<20000; step++) {
+        TestAgent& ag = agents[rand()%agents.size()];
+        switch (rand()%4) {
+        case 0:
+            if (ag.listed) {
+                registry.removeAgent(&ag);
+                ag = TestAgent();
+            } else {
+                ag.spatial = (rand()%5 != 0);
+                registry.addAgent(&ag, ag.spatial);
+                ag.listed = true;
+            }
+            break;
+        case 1: {
+            int role = rand()%numRoles;
+            registry.setRole(&ag, role);
+            if (role != ag.role) {
+                ag.role = role;
+                ag.segment = NULL;
+            }
+            break;
+        }
+        default:
+            if (ag.role == DRIVER) {
+                ag.segment = (rand()%4 == 0) ? NULL : &segments[rand()%segments.size()];
+                registry.setSegment(&ag, ag.segment);
+            }
+            break;
+        }
+
+        if (step%500 != 0) {
+            continue;
+        }
+
+        //Compare every view with a full scan.
+        TestRegistry::View spatial;
+        std::vector<TestRegistry::View> byRole(numRoles);
+        std::vector<TestRegistry::View> bySegment(segments.size());
+        for (std::vector<TestAgent>::iterator it=agents.begin(); it!=agents.end(); it++) {
+            if (!it->listed) {
+                continue;
+            }
+            if (it->spatial) {
+                spatial.push_back(&*it);
+            }
+            byRole[it->role].push_back(&*it);
+            if (it->segment) {
+                bySegment[it->segment - &segments[0]].push_back(&*it);
+            }
+        }
+
+        std::stringstream msg;
+        msg << "Views differ from a full scan at step " << step;
+        CPPUNIT_ASSERT_MESSAGE(msg.str(), SameAgents(registry.getSpatialAgents(), spatial));
+        for (int role=1; role<numRoles; role++) {
+            CPPUNIT_ASSERT_MESSAGE(msg.str(), SameAgents(registry.getAgentsWithRole(role), byRole[role]));
+        }
+        for (size_t seg=0; seg<segments.size(); seg++) {
+            CPPUNIT_ASSERT_MESSAGE(msg.str(), SameAgents(registry.getVehiclesOnSegment(&segments[seg]), bySegment[seg]));
+        }
+    }
+}
@@ -0,0 +1,40 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the AgentRegistry's typed views.
+ */
+class AgentRegistryUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///Spatial agents are listed until they are removed; non-spatial agents never are.
+    void test_spatial_view();
+
+    ///Roles reported before an agent is added are listed once it is added, and changing role moves it between views.
+    void test_role_views();
+
+    ///Vehicles move between segment views, and leave them when their role changes.
+    void test_segment_views();
+
+    ///After a long random sequence of changes, every view holds exactly the agents a full scan would find.
+    void test_matches_full_scan();
+
+private:
+    CPPUNIT_TEST_SUITE(AgentRegistryUnitTests);
+        CPPUNIT_TEST(test_spatial_view);
+        CPPUNIT_TEST(test_role_views);
+        CPPUNIT_TEST(test_segment_views);
+        CPPUNIT_TEST(test_matches_full_scan);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
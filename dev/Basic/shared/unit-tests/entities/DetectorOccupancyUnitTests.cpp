@@ -0,0 +1,237 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "DetectorOccupancyUnitTests.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+#include "entities/DetectorOccupancy.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::DetectorOccupancyUnitTests);
+
+namespace {
+
+struct TestVehicle {
+    TestVehicle() : id(0), pos(0), over(false), onLane(true) {}
+
+    int id;
+    double pos;
+    bool over;
+    bool onLane;
+};
+
+const double LANE_LENGTH = 200;
+const double DOWNSTREAM_OFFSET = 0.5;
+const double UPSTREAM_OFFSET = 4.5;
+const unsigned int TICK_MS = 100;
+
+bool IsOver(const TestVehicle& veh)
+{
+    double distToEnd = LANE_LENGTH - veh.pos;
+    return veh.onLane && DOWNSTREAM_OFFSET <= distToEnd && distToEnd <= UPSTREAM_OFFSET;
+}
+
+//The counting done by loop detectors which looked up the vehicles in their area at every tick.
+struct PositionSampling {
+    PositionSampling() : count(0), spaceTime(0) {}
+
+    void check(const std::vector<TestVehicle>& vehicles) {
+        for (std::vector<TestVehicle>::const_iterator it=vehicles.begin(); it!=vehicles.end(); it++) {
+            if (!it->onLane) {
+                continue;
+            }
+            std::vector<int>::iterator seen = std::find(seenIds.begin(), seenIds.end(), it->id);
+            if (IsOver(*it)) {
+                if (seen == seenIds.end()) {
+                    seenIds.push_back(it->id);
+                    count++;
+                }
+                return;
+            } else if (seen != seenIds.end()) {
+                seenIds.erase(seen);
+            }
+        }
+        spaceTime += TICK_MS;
+    }
+
+    std::vector<int> seenIds;
+    unsigned int count;
+    unsigned int spaceTime;
+};
+
+//Updates both sensors and compares them.
+void CheckSensors(unsigned int now, bool reset, DetectorOccupancy<TestVehicle>& occupancy, PositionSampling& sampling,
+                  const std::vector<TestVehicle>& snapshot, unsigned int& count, unsigned int& spaceTime)
+{
+    if (reset) {
+        count = spaceTime = 0;
+        sampling.count = sampling.spaceTime = 0;
+        return;
+    }
+
+    std::vector<const TestVehicle*> entered;
+    if (occupancy.update(now, entered)) {
+        count += entered.size();
+    } else {
+        spaceTime += TICK_MS;
+    }
+    sampling.check(snapshot);
+
+    std::stringstream msg;
+    msg << "Event-driven occupancy differs from sampling at " << now << "ms: count " << count << " vs " << sampling.count
+        << ", space-time " << spaceTime << " vs " << sampling.spaceTime;
+    CPPUNIT_ASSERT_MESSAGE(msg.str(), count==sampling.count && spaceTime==sampling.spaceTime);
+}
+
+} //End anon namespace
+
+
+void unit_tests::DetectorOccupancyUnitTests::test_enter_leave()
+{
+    DetectorOccupancy<int> occupancy;
+    int veh = 0;
+    std::vector<const int*> entered;
+
+    occupancy.enter(&veh, 100);
+    CPPUNIT_ASSERT_MESSAGE("Vehicle seen during the tick it entered.", !occupancy.update(100, entered) && entered.empty());
+    CPPUNIT_ASSERT_MESSAGE("Vehicle not seen after it entered.", occupancy.update(200, entered));
+    CPPUNIT_ASSERT_MESSAGE("Entered vehicle not reported.", entered.size()==1 && entered.front()==&veh);
+
+    entered.clear();
+    CPPUNIT_ASSERT_MESSAGE("Vehicle not seen while over the sensor.", occupancy.update(300, entered));
+    CPPUNIT_ASSERT_MESSAGE("Vehicle reported twice.", entered.empty());
+
+    occupancy.leave(&veh, 300);
+    CPPUNIT_ASSERT_MESSAGE("Vehicle not seen during the tick it left.", occupancy.update(300, entered));
+    CPPUNIT_ASSERT_MESSAGE("Vehicle seen after it left.", !occupancy.update(400, entered) && occupancy.size()==0);
+}
+
+void unit_tests::DetectorOccupancyUnitTests::test_transient_not_reported()
+{
+    DetectorOccupancy<int> occupancy;
+    int veh1 = 0;
+    int veh2 = 0;
+    std::vector<const int*> entered;
+
+    //veh1 passes over while no update is done (e.g., the counts were being reset).
+    occupancy.enter(&veh1, 100);
+    occupancy.enter(&veh2, 200);
+    occupancy.leave(&veh1, 200);
+    CPPUNIT_ASSERT_MESSAGE("Occupancy wrong after several crossings.", occupancy.update(300, entered) && occupancy.size()==1);
+    CPPUNIT_ASSERT_MESSAGE("Transient vehicle reported.", entered.size()==1 && entered.front()==&veh2);
+}
+
+void unit_tests::DetectorOccupancyUnitTests::test_one_vehicle_per_update()
+{
+    DetectorOccupancy<int> occupancy;
+    int veh1 = 0;
+    int veh2 = 0;
+    int veh3 = 0;
+    std::vector<const int*> entered;
+
+    occupancy.enter(&veh1, 100);
+    occupancy.enter(&veh2, 100);
+    occupancy.enter(&veh3, 100);
+    CPPUNIT_ASSERT_MESSAGE("Vehicles not seen.", occupancy.update(200, entered) && occupancy.size()==3);
+    CPPUNIT_ASSERT_MESSAGE("More than one vehicle reported in a tick.", entered.size()==1 && entered.front()==&veh1);
+
+    //veh2 leaves before it could be reported.
+    entered.clear();
+    occupancy.leave(&veh2, 200);
+    occupancy.update(300, entered);
+    CPPUNIT_ASSERT_MESSAGE("Waiting vehicle not reported.", entered.size()==1 && entered.front()==&veh3);
+
+    entered.clear();
+    CPPUNIT_ASSERT_MESSAGE("Vehicle reported twice.", occupancy.update(400, entered) && entered.empty());
+}
+
+void unit_tests::DetectorOccupancyUnitTests::test_current_tick_deferred()
+{
+    int veh = 0;
+    std::vector<const int*> before;
+    std::vector<const int*> after;
+
+    //The sensor is updated before the vehicle.
+    DetectorOccupancy<int> first;
+    bool firstOccupied = first.update(100, before);
+    first.enter(&veh, 100);
+
+    //The sensor is updated after the vehicle.
+    DetectorOccupancy<int> second;
+    second.enter(&veh, 100);
+    bool secondOccupied = second.update(100, after);
+
+    CPPUNIT_ASSERT_MESSAGE("Result depends on the update order.", firstOccupied==secondOccupied && before.size()==after.size());
+    CPPUNIT_ASSERT_MESSAGE("Deferred crossing lost.", first.update(200, before) && second.update(200, after));
+    CPPUNIT_ASSERT_MESSAGE("Deferred crossing not reported.", before.size()==1 && after.size()==1);
+}
+
+void unit_tests::DetectorOccupancyUnitTests::test_matches_position_sampling()
+{
+    srand(42);
+
+    DetectorOccupancy<TestVehicle> occupancy;
+    PositionSampling sampling;
+    unsigned int count = 0;
+    unsigned int spaceTime = 0;
+
+    //Vehicles are stored in advance so that their addresses are stable.
+    std::vector<TestVehicle> vehicles(2000);
+    std::vector<TestVehicle> snapshot;
+    size_t numVehicles = 0;
+
+    for (unsigned int now=TICK_MS; now<=400000; now+=TICK_MS) {
+        //The sampling sensor sees the vehicles as they were at the end of the previous tick.
+        snapshot.assign(vehicles.begin(), vehicles.begin()+numVehicles);
+
+        //The counts are sometimes reset; neither sensor looks at the vehicles then.
+        bool reset = (rand()%50 == 0);
+
+        //The sensor may run before or after the vehicles within a tick.
+        bool sensorFirst = (rand()%2 == 0);
+        if (sensorFirst) {
+            CheckSensors(now, reset, occupancy, sampling, snapshot, count, spaceTime);
+        }
+
+        //Move the vehicles, from the front. A vehicle keeps at least 6m behind its leader, so that no two vehicles
+        //are over the sensor at once. Stopped vehicles model a queue at the stop-line.
+        for (size_t i=0; i<numVehicles; i++) {
+            TestVehicle& veh = vehicles[i];
+            if (!veh.onLane) {
+                continue;
+            }
+            double step = (rand()%4 == 0) ? 0 : (rand()%300)/100.0;
+            double limit = (i>0 && vehicles[i-1].onLane) ? vehicles[i-1].pos - 6 : LANE_LENGTH + 10;
+            veh.pos = std::max(veh.pos, std::min(veh.pos + step, limit));
+            if (veh.pos >= LANE_LENGTH) {
+                veh.onLane = false;
+            }
+
+            //The driver reports its crossings.
+            bool over = IsOver(veh);
+            if (over != veh.over) {
+                if (over) {
+                    occupancy.enter(&veh, now);
+                } else {
+                    occupancy.leave(&veh, now);
+                }
+                veh.over = over;
+            }
+        }
+        if (numVehicles < vehicles.size() && rand()%20 == 0 && (numVehicles == 0 || vehicles[numVehicles-1].pos > 10)) {
+            vehicles[numVehicles].id = numVehicles;
+            numVehicles++;
+        }
+
+        if (!sensorFirst) {
+            CheckSensors(now, reset, occupancy, sampling, snapshot, count, spaceTime);
+        }
+    }
+
+    CPPUNIT_ASSERT_MESSAGE("Too few vehicles crossed the sensor.", numVehicles > 100);
+}
@@ -0,0 +1,44 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the DetectorOccupancy used by loop detectors.
+ */
+class DetectorOccupancyUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///A vehicle is seen over the sensor from the tick after it entered until the tick after it left.
+    void test_enter_leave();
+
+    ///A vehicle which enters and leaves between two updates is not reported.
+    void test_transient_not_reported();
+
+    ///At most one vehicle is reported per update; the others are reported later, in order, if still over the sensor.
+    void test_one_vehicle_per_update();
+
+    ///Crossings reported during the current tick wait for the next update, whatever the update order.
+    void test_current_tick_deferred();
+
+    ///Counts and space-time match those of sampling the vehicles' positions at every tick.
+    void test_matches_position_sampling();
+
+private:
+    CPPUNIT_TEST_SUITE(DetectorOccupancyUnitTests);
+        CPPUNIT_TEST(test_enter_leave);
+        CPPUNIT_TEST(test_transient_not_reported);
+        CPPUNIT_TEST(test_one_vehicle_per_update);
+        CPPUNIT_TEST(test_current_tick_deferred);
+        CPPUNIT_TEST(test_matches_position_sampling);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
@@ -0,0 +1,213 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "TravelTimeManagerUnitTests.hpp"
+
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/weak_ptr.hpp>
+#include "entities/TravelTimeManager.hpp"
+#include "geospatial/network/Link.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::TravelTimeManagerUnitTests);
+
+namespace {
+
+//Travel time intervals of one minute.
+const unsigned int INTERVAL_MS = 60000;
+
+struct TestLinks {
+    TestLinks() {
+        link1.setLinkId(1);
+        link2.setLinkId(2);
+        link3.setLinkId(3);
+        link99.setLinkId(99);
+    }
+
+    Link link1;
+    Link link2;
+    Link link3;
+    Link link99;
+};
+
+LinkTravelStats MakeStats(const Link* link, const Link* downstream, double entryTime, double travelTime)
+{
+    LinkTravelStats stats(link);
+    stats.downstreamLink = downstream;
+    stats.entryTime = entryTime;
+    stats.travelTime = travelTime;
+    return stats;
+}
+
+void AddRecords(TravelTimeManager* manager, LinkTravelStats stats, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; i++) {
+        manager->addTravelTime(stats);
+    }
+}
+
+} //End unnamed namespace
+
+TravelTimeManager* unit_tests::TravelTimeManagerUnitTests::makeManager()
+{
+    TravelTimeManager* manager = new TravelTimeManager();
+    TravelTimeManager::setTimeIntervalWidth(INTERVAL_MS);
+
+    for (unsigned int linkId = 1; linkId <= 3; linkId++) {
+        LinkTravelTime defaultTT;
+        defaultTT.setLinkId(linkId);
+        defaultTT.setDefaultTravelTime(100);
+        manager->linkSlots[linkId] = manager->linkDefaultTT.size();
+        manager->linkDefaultTT.push_back(defaultTT);
+    }
+
+    //link 1 -> {2, 3}, link 2 -> {3}, link 3 -> {}
+    manager->turnDownstreamLinks.push_back(2);
+    manager->turnDownstreamLinks.push_back(3);
+    manager->turnDownstreamLinks.push_back(3);
+    manager->turnOffsets.push_back(0);
+    manager->turnOffsets.push_back(2);
+    manager->turnOffsets.push_back(3);
+    manager->turnOffsets.push_back(3);
+    return manager;
+}
+
+void unit_tests::TravelTimeManagerUnitTests::test_merge_on_new_interval()
+{
+    TravelTimeManager* manager = makeManager();
+    TestLinks links;
+
+    //Interval 0; nothing ends in interval 1 yet.
+    manager->addTravelTime(MakeStats(&links.link1, &links.link2, 10, 20));
+    manager->addTravelTime(MakeStats(&links.link1, &links.link2, 15, 40));
+    CPPUNIT_ASSERT(!manager->getPublishedTT());
+    CPPUNIT_ASSERT_EQUAL(-1.0, manager->getInSimulationLinkTT(&links.link1));
+
+    //Ends in interval 1: interval 0 is merged and published.
+    manager->addTravelTime(MakeStats(&links.link1, &links.link3, 50, 30));
+    CPPUNIT_ASSERT(manager->getPublishedTT());
+    CPPUNIT_ASSERT_EQUAL(30.0, manager->getInSimulationTurnTT(manager->getTurnSlot(0, 2), DailyTime(INTERVAL_MS + 1000)));
+    CPPUNIT_ASSERT_EQUAL(30.0, manager->getInSimulationTurnTT(manager->getTurnSlot(0, 3), DailyTime(INTERVAL_MS + 1000)));
+    CPPUNIT_ASSERT_EQUAL(30.0, manager->getInSimulationLinkTT(&links.link1));
+    CPPUNIT_ASSERT_EQUAL(30.0, manager->getLinkTT(&links.link1, DailyTime(INTERVAL_MS + 1000), &links.link2, true));
+
+    //The previous interval has no data when asking at interval 0; link 2 has no data at all.
+    CPPUNIT_ASSERT_EQUAL(-1.0, manager->getInSimulationTurnTT(manager->getTurnSlot(0, 2), DailyTime(1000)));
+    CPPUNIT_ASSERT_EQUAL(-1.0, manager->getInSimulationLinkTT(&links.link2));
+
+    //No downstream link: the record counts for every downstream link of link 1.
+    manager->addTravelTime(MakeStats(&links.link1, nullptr, 70, 10));
+    manager->addTravelTime(MakeStats(&links.link2, &links.link3, 130, 5));
+    CPPUNIT_ASSERT_EQUAL(10.0, manager->getInSimulationTurnTT(manager->getTurnSlot(0, 2), DailyTime(2 * INTERVAL_MS)));
+    CPPUNIT_ASSERT_EQUAL(10.0, manager->getInSimulationTurnTT(manager->getTurnSlot(0, 3), DailyTime(2 * INTERVAL_MS)));
+
+    delete manager;
+}
+
+void unit_tests::TravelTimeManagerUnitTests::test_merge_from_threads()
+{
+    TravelTimeManager* manager = makeManager();
+    TestLinks links;
+
+    const unsigned int NUM_THREADS = 4;
+    const unsigned int RECORDS_PER_THREAD = 250;
+    std::vector<boost::thread*> threads;
+    for (unsigned int i = 0; i < NUM_THREADS; i++) {
+        threads.push_back(new boost::thread(boost::bind(&AddRecords, manager,
+                MakeStats(&links.link1, &links.link2, 10, 10 + i), RECORDS_PER_THREAD)));
+    }
+    for (unsigned int i = 0; i < NUM_THREADS; i++) {
+        threads[i]->join();
+        delete threads[i];
+    }
+
+    //The threads have exited; their records are merged by the next interval.
+    manager->addTravelTime(MakeStats(&links.link2, &links.link3, 100, 10));
+    const TimeAndCount& tc = manager->inSimulationTT[0][manager->getTurnSlot(0, 2)];
+    CPPUNIT_ASSERT_EQUAL(NUM_THREADS * RECORDS_PER_THREAD, tc.travelTimeCnt);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(11.5, tc.getTravelTime(), 1e-9);
+
+    delete manager;
+}
+
+void unit_tests::TravelTimeManagerUnitTests::test_merge_during_merge()
+{
+    TravelTimeManager* manager = makeManager();
+    TestLinks links;
+
+    //Register this thread's accumulator, then the one of a thread which has exited.
+    manager->addTravelTime(MakeStats(&links.link1, &links.link2, 1, 1));
+    boost::thread idle(boost::bind(&AddRecords, manager, MakeStats(&links.link1, &links.link2, 2, 1), 1));
+    idle.join();
+    CPPUNIT_ASSERT_EQUAL((size_t) 2, manager->threadAccumulators.size());
+
+    //The merging thread collects this thread's records, then waits for the idle accumulator while holding the
+    //accumulators. Only the merge holds them for longer than a registration.
+    boost::mutex::scoped_lock idleLock(manager->threadAccumulators[1]->mtx);
+    boost::thread merger(boost::bind(&AddRecords, manager, MakeStats(&links.link1, &links.link3, 100, 30), 1));
+    while (true) {
+        boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+        boost::mutex::scoped_try_lock accumulatorsLock(manager->accumulatorsMutex);
+        if (!accumulatorsLock.owns_lock()) {
+            break;
+        }
+    }
+
+    //Added after the merge collected this thread's records, and ends in the interval being merged.
+    manager->addTravelTime(MakeStats(&links.link2, &links.link3, 70, 60));
+    idleLock.unlock();
+    merger.join();
+
+    CPPUNIT_ASSERT_EQUAL(2u, manager->lastLinkMergeInterval.load());
+    CPPUNIT_ASSERT(manager->threadAccumulators[0]->linkRecords.empty());
+    CPPUNIT_ASSERT_EQUAL(60.0, manager->getInSimulationTurnTT(manager->getTurnSlot(1, 3), DailyTime(2 * INTERVAL_MS)));
+
+    delete manager;
+}
+
+void unit_tests::TravelTimeManagerUnitTests::test_published_snapshot_replaced()
+{
+    TravelTimeManager* manager = makeManager();
+    TestLinks links;
+
+    manager->addTravelTime(MakeStats(&links.link1, &links.link2, 10, 60));
+    boost::shared_ptr<const TravelTimeManager::InSimulationTT> first = manager->getPublishedTT();
+    CPPUNIT_ASSERT(first);
+    boost::weak_ptr<const TravelTimeManager::InSimulationTT> firstWeak = first;
+
+    manager->addTravelTime(MakeStats(&links.link1, &links.link2, 70, 60));
+    boost::shared_ptr<const TravelTimeManager::InSimulationTT> second = manager->getPublishedTT();
+    CPPUNIT_ASSERT(second != first);
+
+    //A reader still holding the first snapshot sees it unchanged, and it is released with the reader.
+    CPPUNIT_ASSERT_EQUAL((size_t) 1, first->intervals.size());
+    CPPUNIT_ASSERT_EQUAL((size_t) 2, second->intervals.size());
+    CPPUNIT_ASSERT(first->intervals[0] == second->intervals[0]);
+    first.reset();
+    CPPUNIT_ASSERT(firstWeak.expired());
+
+    delete manager;
+}
+
+void unit_tests::TravelTimeManagerUnitTests::test_unconnected_turn_kept()
+{
+    TravelTimeManager* manager = makeManager();
+    TestLinks links;
+
+    manager->addTravelTime(MakeStats(&links.link1, &links.link99, 10, 25));
+    manager->addTravelTime(MakeStats(&links.link1, &links.link99, 20, 35));
+    manager->addTravelTime(MakeStats(&links.link1, &links.link2, 30, 10));
+    manager->addTravelTime(MakeStats(&links.link2, &links.link3, 70, 10));
+
+    const TimeAndCount& unconnected = manager->unconnectedTurnTT[std::make_pair(1u, 99u)][0];
+    CPPUNIT_ASSERT_EQUAL(2u, unconnected.travelTimeCnt);
+    CPPUNIT_ASSERT_EQUAL(30.0, unconnected.getTravelTime());
+    CPPUNIT_ASSERT_EQUAL(10.0, manager->getInSimulationTurnTT(manager->getTurnSlot(0, 2), DailyTime(INTERVAL_MS)));
+    CPPUNIT_ASSERT_EQUAL(-1.0, manager->getInSimulationTurnTT(manager->getTurnSlot(0, 3), DailyTime(INTERVAL_MS)));
+
+    delete manager;
+}
@@ -0,0 +1,52 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace sim_mob
+{
+class TravelTimeManager;
+}
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the merging and publishing of in-simulation link travel times.
+ */
+class TravelTimeManagerUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///Records are published once a record ends in a later interval, and are read back per turn and per link.
+    void test_merge_on_new_interval();
+
+    ///Records from several threads are all merged, including those of threads which have exited.
+    void test_merge_from_threads();
+
+    ///A record added while another thread is merging is merged by that thread, not at the next interval.
+    void test_merge_during_merge();
+
+    ///Only the current snapshot is kept; replaced snapshots are released once no reader holds them.
+    void test_published_snapshot_replaced();
+
+    ///Records for downstream links without a turn slot are kept apart, and do not change the turn travel times.
+    void test_unconnected_turn_kept();
+
+private:
+    ///A manager with links 1, 2 and 3; link 1 turns into links 2 and 3, link 2 into link 3.
+    static sim_mob::TravelTimeManager* makeManager();
+
+    CPPUNIT_TEST_SUITE(TravelTimeManagerUnitTests);
+        CPPUNIT_TEST(test_merge_on_new_interval);
+        CPPUNIT_TEST(test_merge_from_threads);
+        CPPUNIT_TEST(test_merge_during_merge);
+        CPPUNIT_TEST(test_published_snapshot_replaced);
+        CPPUNIT_TEST(test_unconnected_turn_kept);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
@@ -0,0 +1,134 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "PolyLineUnitTests.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include "geospatial/network/PolyLine.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::PolyLineUnitTests);
+
+namespace {
+
+void AddPoint(PolyLine& line, double x, double y)
+{
+    line.addPoint(PolyPoint(1, line.size(), x, y, 0));
+}
+
+//The position at a distance along the poly-line, found the way DriverPathMover used to: by moving from point to
+//point and subtracting the length of each segment passed.
+Point WalkTo(const PolyLine& line, double distance)
+{
+    const std::vector<PolyPoint>& points = line.getPoints();
+    std::size_t index = 0;
+    while (index + 2 < points.size())
+    {
+        double dx = points[index + 1].getX() - points[index].getX();
+        double dy = points[index + 1].getY() - points[index].getY();
+        double length = std::sqrt(dx * dx + dy * dy);
+        if (distance < length)
+        {
+            break;
+        }
+        distance -= length;
+        ++index;
+    }
+
+    double dx = points[index + 1].getX() - points[index].getX();
+    double dy = points[index + 1].getY() - points[index].getY();
+    double length = std::sqrt(dx * dx + dy * dy);
+    double factor = (length == 0) ? 0 : distance / length;
+    return Point(points[index].getX() + factor * dx, points[index].getY() + factor * dy);
+}
+
+//The same position, from the arc-length tables.
+Point LookUp(const PolyLine& line, double distance)
+{
+    const std::vector<PolyPoint>& points = line.getPoints();
+    std::size_t index = line.findSegment(distance);
+    double length = line.getSegmentLength(index);
+    double factor = (length == 0) ? 0 : (distance - line.getCumulativeLength(index)) / length;
+    return Point(points[index].getX() + factor * (points[index + 1].getX() - points[index].getX()),
+                 points[index].getY() + factor * (points[index + 1].getY() - points[index].getY()));
+}
+
+} //End un-named namespace
+
+void unit_tests::PolyLineUnitTests::test_cumulative_lengths()
+{
+    PolyLine line;
+    AddPoint(line, 0, 0);
+    CPPUNIT_ASSERT_EQUAL(0.0, line.getCumulativeLength(0));
+
+    AddPoint(line, 3, 4);
+    AddPoint(line, 3, 4);
+    AddPoint(line, 6, 8);
+
+    CPPUNIT_ASSERT_EQUAL(5.0, line.getSegmentLength(0));
+    CPPUNIT_ASSERT_EQUAL(0.0, line.getSegmentLength(1));
+    CPPUNIT_ASSERT_EQUAL(5.0, line.getSegmentLength(2));
+    CPPUNIT_ASSERT_EQUAL(5.0, line.getCumulativeLength(1));
+    CPPUNIT_ASSERT_EQUAL(5.0, line.getCumulativeLength(2));
+    CPPUNIT_ASSERT_EQUAL(10.0, line.getCumulativeLength(3));
+}
+
+void unit_tests::PolyLineUnitTests::test_find_segment()
+{
+    PolyLine line;
+    AddPoint(line, 0, 0);
+    AddPoint(line, 10, 0);
+    AddPoint(line, 10, 0);
+    AddPoint(line, 10, 5);
+    AddPoint(line, 20, 5);
+
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 0, line.findSegment(-1));
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 0, line.findSegment(0));
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 0, line.findSegment(9.5));
+
+    //A point ends one segment and starts the next; the zero-length segment is skipped
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 2, line.findSegment(10));
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 2, line.findSegment(12));
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 3, line.findSegment(15));
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 3, line.findSegment(25));
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 3, line.findSegment(30));
+
+    //A single segment
+    PolyLine shortLine;
+    AddPoint(shortLine, 0, 0);
+    AddPoint(shortLine, 1, 1);
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 0, shortLine.findSegment(0.5));
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 0, shortLine.findSegment(2));
+}
+
+void unit_tests::PolyLineUnitTests::test_matches_point_walk()
+{
+    std::srand(42);
+    for (int lineNo = 0; lineNo < 50; ++lineNo)
+    {
+        //A wiggly line of a few hundred metres, in projected coordinates far from the origin
+        PolyLine line;
+        double x = 370000 + std::rand() % 1000;
+        double y = 140000 + std::rand() % 1000;
+        int numPoints = 2 + std::rand() % 40;
+        for (int i = 0; i < numPoints; ++i)
+        {
+            AddPoint(line, x, y);
+            x += (std::rand() % 2000) / 100.0;
+            y += (std::rand() % 2000 - 1000) / 100.0;
+        }
+
+        double length = line.getCumulativeLength(line.size() - 1);
+        for (int i = 0; i < 200; ++i)
+        {
+            double distance = length * (std::rand() % 10001) / 10000.0;
+            Point walked = WalkTo(line, distance);
+            Point found = LookUp(line, distance);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(walked.getX(), found.getX(), 1e-6);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(walked.getY(), found.getY(), 1e-6);
+        }
+    }
+}
@@ -0,0 +1,36 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the arc-length tables of PolyLine.
+ */
+class PolyLineUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///Segment and cumulative lengths are kept as points are added, including zero-length segments.
+    void test_cumulative_lengths();
+
+    ///Distances map to the segment containing them, and are clamped to the first and last segments.
+    void test_find_segment();
+
+    ///Positions found by binary search stay within a micrometre of those found by walking the points.
+    void test_matches_point_walk();
+
+private:
+    CPPUNIT_TEST_SUITE(PolyLineUnitTests);
+        CPPUNIT_TEST(test_cumulative_lengths);
+        CPPUNIT_TEST(test_find_segment);
+        CPPUNIT_TEST(test_matches_point_walk);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
@@ -12,6 +12,7 @@
 #include <limits>
 #include <string>
 #include <sstream>
+#include <vector>
 
 #include "partitions/PackageUtils.hpp"
 #include "partitions/UnPackageUtils.hpp"
@@ -186,6 +187,47 @@ void unit_tests::PackUnpackUnitTests::test_PackUnpack_dynamic_vector2()
     CPPUNIT_ASSERT_THROW(destVec.getAngle(), std::runtime_error);
 }
 
+void unit_tests::PackUnpackUnitTests::test_PackUnpack_binary_data()
+{
+    int srcCount = 0;
+    std::string srcName("a\0b", 3);
+    std::vector<int> srcIds(3, 7);
+    double srcSpeed = 12.5;
+
+    //Now pack it.
+    PackageUtils p;
+    p << srcCount;
+    p << srcName;
+    p << srcIds;
+    p << srcSpeed;
+
+    //Unpack it
+    UnPackageUtils up(p.getPackageData());
+    int destCount = 1;
+    std::string destName;
+    std::vector<int> destIds;
+    double destSpeed = 0;
+    up >> destCount;
+    up >> destName;
+    up >> destIds;
+    up >> destSpeed;
+
+    CPPUNIT_ASSERT_EQUAL(srcCount, destCount);
+    CPPUNIT_ASSERT(srcName == destName);
+    CPPUNIT_ASSERT(srcIds == destIds);
+    CPPUNIT_ASSERT_EQUAL(srcSpeed, destSpeed);
+}
+
+void unit_tests::PackUnpackUnitTests::test_PackUnpack_version_check()
+{
+    //An empty package ends with its version; change it.
+    PackageUtils p;
+    std::string data = p.getPackageData();
+    data[data.size() - sizeof(unsigned int)] ^= 0x7f;
+
+    CPPUNIT_ASSERT_THROW(UnPackageUtils up(data), std::runtime_error);
+}
+
 
 
 #endif //SIMMOB_DISABLE_MPI
@@ -33,6 +33,12 @@ public:
     void test_PackUnpack_dynamic_vector() CHECK_MPI_THROW ;
     void test_PackUnpack_dynamic_vector2() CHECK_MPI_THROW ;
 
+    //Binary packages, including null characters, survive the round trip through a string.
+    void test_PackUnpack_binary_data() CHECK_MPI_THROW ;
+
+    //Packages of another wire format version are rejected.
+    void test_PackUnpack_version_check() CHECK_MPI_THROW ;
+
 
 
 
@@ -44,6 +50,8 @@ private:
       CPPUNIT_TEST(test_PackUnpack_fixed_delayed_dpoint);
       CPPUNIT_TEST(test_PackUnpack_dynamic_vector);
       CPPUNIT_TEST(test_PackUnpack_dynamic_vector2);
+      CPPUNIT_TEST(test_PackUnpack_binary_data);
+      CPPUNIT_TEST(test_PackUnpack_version_check);
     CPPUNIT_TEST_SUITE_END();
 #endif
 };
@@ -507,5 +507,59 @@ void unit_tests::FixedDelayedUnitTests::test_FixedDelayed_comprehensive_variable
 }
 
 
+void unit_tests::FixedDelayedUnitTests::test_FixedDelayed_same_time_replace()
+{
+    int obj1Refs = 0;
+    int obj2Refs = 0;
+    DelStruct* o1 = new DelStruct(obj1Refs);
+    DelStruct* o2 = new DelStruct(obj2Refs);
+    {
+        FixedDelayed<DelStruct*> z(10, true);
+        z.update(100);
+        z.delay(o1);
+        z.delay(o2);
+        CPPUNIT_ASSERT_MESSAGE("Replaced value not deleted.", obj1Refs==0 && obj2Refs==1);
+
+        //Delaying the same pointer again must not delete it.
+        z.delay(o2);
+        z.update(110);
+        CPPUNIT_ASSERT_MESSAGE("Same-time replace failed (1).", z.can_sense() && z.sense()==o2 && obj2Refs==1);
+    }
+    CPPUNIT_ASSERT_MESSAGE("Same-time replace failed (2).", obj2Refs==0);
 
+    FixedDelayed<int> x(100);
+    x.update(200);
+    x.delay(1);
+    x.delay(2);
+    x.update(300);
+    CPPUNIT_ASSERT_MESSAGE("Same-time replace failed (3).", x.can_sense() && x.sense()==2);
+}
 
+
+void unit_tests::FixedDelayedUnitTests::test_FixedDelayed_tick_sized_history()
+{
+    //A maximum delay which is not a multiple of the time step; one value is delayed on every tick.
+    const uint32_t tickMS = 100;
+    FixedDelayed<int> store(250, true, tickMS);
+    uint32_t delayMS = 250;
+    for (uint32_t tick=0; tick<1000; tick++) {
+        uint32_t now = tick*tickMS;
+        store.update(now);
+        store.delay(tick);
+
+        //Cycle through 50, 150 and 250ms.
+        if (tick%50 == 0) {
+            delayMS = (tick/50)%3 * 100 + 50;
+            store.set_delay(delayMS);
+        }
+
+        //The sensed value is the one delayed on the latest tick at least delayMS ago.
+        if (now < delayMS) {
+            CPPUNIT_ASSERT_MESSAGE("Tick-sized history failed (1).", !store.can_sense());
+        } else if (!store.can_sense() || store.sense() != (int) ((now-delayMS)/tickMS)) {
+            std::stringstream msg;
+            msg <<"Tick-sized history failed (2+" <<tick <<").";
+            CPPUNIT_FAIL(msg.str().c_str());
+        }
+    }
+}
@@ -56,6 +56,12 @@ public:
     ///Perform a comprehensive test of variable reaction time.
     void test_FixedDelayed_comprehensive_variable_reaction();
 
+    ///Delaying twice at the same time keeps the latest value, and deletes the other one.
+    void test_FixedDelayed_same_time_replace();
+
+    ///A history sized from the time step keeps working over a long run of ticks.
+    void test_FixedDelayed_tick_sized_history();
+
 
 
 
@@ -75,6 +81,8 @@ private:
         CPPUNIT_TEST(test_FixedDelayed_diminishing_reaction_time);
         CPPUNIT_TEST(test_FixedDelayed_expanding_reaction_time);
         CPPUNIT_TEST(test_FixedDelayed_comprehensive_variable_reaction);
+        CPPUNIT_TEST(test_FixedDelayed_same_time_replace);
+        CPPUNIT_TEST(test_FixedDelayed_tick_sized_history);
     CPPUNIT_TEST_SUITE_END();
 };
 
@@ -0,0 +1,263 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "SpatialTreeUnitTests.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+#include "geospatial/network/Point.hpp"
+#include "spatial_trees/AuraQueryBatch.hpp"
+#include "spatial_trees/TreeImpl.hpp"
+#include "spatial_trees/rstar_tree/RStarTree.hpp"
+#include "util/threadpool/Threadpool.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::SpatialTreeUnitTests);
+
+namespace {
+
+//A small fan-out, so that even a few hundred items make a tree several levels deep.
+typedef RStarTree<int, 2, 2, 4> TestTree;
+
+//Collects the item of each leaf visited.
+struct CollectItems {
+    const bool ContinueVisiting;
+    std::vector<int>& items;
+
+    explicit CollectItems(std::vector<int>& items) : ContinueVisiting(true), items(items) {}
+
+    bool operator()(const TestTree::Leaf* const leaf) const {
+        items.push_back(leaf->leaf);
+        return true;
+    }
+};
+
+TestTree::BoundingBox MakeBox(int minX, int minY, int maxX, int maxY)
+{
+    TestTree::BoundingBox box;
+    box.edges[0].first = minX;
+    box.edges[0].second = maxX;
+    box.edges[1].first = minY;
+    box.edges[1].second = maxY;
+    return box;
+}
+
+//Random points in [0, extent); item i is at points[i].
+std::vector<TestTree::BulkItem> MakeItems(size_t count, int extent)
+{
+    std::vector<TestTree::BulkItem> items;
+    for (size_t i=0; i<count; i++) {
+        int x = rand()%extent;
+        int y = rand()%extent;
+        items.push_back(TestTree::BulkItem(i, MakeBox(x, y, x, y)));
+    }
+    return items;
+}
+
+std::vector<int> QueryTree(TestTree& tree, const TestTree::BoundingBox& box)
+{
+    std::vector<int> res;
+    tree.Query(TestTree::AcceptEnclosing(box), CollectItems(res));
+    std::sort(res.begin(), res.end());
+    return res;
+}
+
+std::vector<int> QueryBruteForce(const std::vector<TestTree::BulkItem>& items, const TestTree::BoundingBox& box)
+{
+    std::vector<int> res;
+    for (std::vector<TestTree::BulkItem>::const_iterator it=items.begin(); it!=items.end(); it++) {
+        if (box.encloses(it->second)) {
+            res.push_back(it->first);
+        }
+    }
+    std::sort(res.begin(), res.end());
+    return res;
+}
+
+TestTree::BoundingBox RandomQuery(int extent)
+{
+    int x = rand()%extent;
+    int y = rand()%extent;
+    return MakeBox(x, y, x + rand()%(extent/4), y + rand()%(extent/4));
+}
+
+//A tree that answers queries by scanning its agents, to check the batching around it.
+class ScanTree : public TreeImpl {
+public:
+    std::vector<const Agent*> agents;
+    std::vector<Point> positions;
+
+    virtual void update(int time_step, const std::set<Entity*>& removedAgentPointers) {}
+
+    virtual std::vector<const Agent*> agentsInRect(const Point& lowerLeft, const Point& upperRight, const Agent* refAgent) const {
+        std::vector<const Agent*> res;
+        for (size_t i=0; i<agents.size(); i++) {
+            const Point& pos = positions[i];
+            if (pos.getX()>=lowerLeft.getX() && pos.getX()<=upperRight.getX() && pos.getY()>=lowerLeft.getY() && pos.getY()<=upperRight.getY()) {
+                res.push_back(agents[i]);
+            }
+        }
+        return res;
+    }
+
+    virtual std::vector<const Agent*> nearbyAgents(const Point& position, const WayPoint& wayPoint, double distanceInFront, double distanceBehind, const Agent* refAgent) const {
+        return std::vector<const Agent*>();
+    }
+};
+
+} //End anon namespace
+
+
+void unit_tests::SpatialTreeUnitTests::test_bulk_load_matches_brute_force()
+{
+    srand(42);
+    const int extent = 1000;
+    std::vector<TestTree::BulkItem> items = MakeItems(2000, extent);
+
+    TestTree inserted;
+    for (std::vector<TestTree::BulkItem>::const_iterator it=items.begin(); it!=items.end(); it++) {
+        inserted.Insert(it->first, it->second);
+    }
+
+    TestTree loaded;
+    std::vector<TestTree::BulkItem> toLoad = items;
+    loaded.BulkLoad(toLoad);
+    CPPUNIT_ASSERT_MESSAGE("Wrong size after bulk loading.", loaded.GetSize()==items.size() && loaded.AllLeaves.size()==items.size());
+
+    for (int i=0; i<500; i++) {
+        TestTree::BoundingBox box = RandomQuery(extent);
+        std::vector<int> expected = QueryBruteForce(items, box);
+
+        std::stringstream msg;
+        msg << "Query " << i << " differs from a brute-force scan";
+        CPPUNIT_ASSERT_MESSAGE(msg.str(), QueryTree(loaded, box)==expected);
+        CPPUNIT_ASSERT_MESSAGE(msg.str(), QueryTree(inserted, box)==expected);
+    }
+
+    //Items on the very edge of the query are found.
+    const TestTree::BoundingBox& edge = items.front().second;
+    CPPUNIT_ASSERT_MESSAGE("Point query missed its item.", QueryTree(loaded, edge)==QueryBruteForce(items, edge));
+}
+
+void unit_tests::SpatialTreeUnitTests::test_parallel_bulk_load()
+{
+    srand(7);
+    const int extent = 5000;
+    std::vector<TestTree::BulkItem> items = MakeItems(20000, extent);
+
+    TestTree serial;
+    std::vector<TestTree::BulkItem> serialItems = items;
+    serial.BulkLoad(serialItems);
+
+    batched::ThreadPool pool(4);
+    TestTree parallel;
+    std::vector<TestTree::BulkItem> parallelItems = items;
+    parallel.BulkLoad(parallelItems, pool);
+
+    //Reloading reuses the same pool.
+    parallelItems = items;
+    parallel.BulkLoad(parallelItems, pool);
+    pool.wait();
+
+    CPPUNIT_ASSERT_MESSAGE("Wrong size after parallel bulk loading.", parallel.GetSize()==items.size()
+            && parallel.AllLeaves.size()==items.size() && parallel.AllNodes.size()==serial.AllNodes.size());
+
+    std::vector<int> all;
+    for (size_t i=0; i<items.size(); i++) {
+        all.push_back(i);
+    }
+    CPPUNIT_ASSERT_MESSAGE("Items lost by parallel bulk loading.", QueryTree(parallel, MakeBox(0, 0, extent, extent))==all);
+
+    for (int i=0; i<200; i++) {
+        TestTree::BoundingBox box = RandomQuery(extent);
+        CPPUNIT_ASSERT_MESSAGE("Parallel and serial bulk loads differ.", QueryTree(parallel, box)==QueryTree(serial, box));
+    }
+}
+
+void unit_tests::SpatialTreeUnitTests::test_bulk_load_edge_cases()
+{
+    TestTree tree;
+    std::vector<TestTree::BulkItem> items;
+    tree.BulkLoad(items);
+    CPPUNIT_ASSERT_MESSAGE("Empty tree not empty.", tree.GetSize()==0 && QueryTree(tree, MakeBox(0, 0, 10, 10)).empty());
+
+    //One item, then a full node, then one more than a node.
+    for (int count=1; count<=5; count++) {
+        items.clear();
+        for (int i=0; i<count; i++) {
+            items.push_back(TestTree::BulkItem(i, MakeBox(i, i, i, i)));
+        }
+        tree.BulkLoad(items);
+        std::stringstream msg;
+        msg << "Wrong contents after loading " << count << " items.";
+        CPPUNIT_ASSERT_MESSAGE(msg.str(), tree.GetSize()==static_cast<size_t>(count) && QueryTree(tree, MakeBox(0, 0, 10, 10)).size()==static_cast<size_t>(count));
+        CPPUNIT_ASSERT_MESSAGE(msg.str(), QueryTree(tree, MakeBox(0, 0, 0, 0))==std::vector<int>(1, 0));
+    }
+
+    //Everybody in the same place (e.g., a queue at an intersection).
+    items.clear();
+    for (int i=0; i<100; i++) {
+        items.push_back(TestTree::BulkItem(i, MakeBox(50, 50, 50, 50)));
+    }
+    tree.BulkLoad(items);
+    CPPUNIT_ASSERT_MESSAGE("Items at the same position lost.", QueryTree(tree, MakeBox(50, 50, 50, 50)).size()==100);
+    CPPUNIT_ASSERT_MESSAGE("Items found outside the query.", QueryTree(tree, MakeBox(0, 0, 49, 100)).empty());
+}
+
+void unit_tests::SpatialTreeUnitTests::test_query_batch()
+{
+    srand(3);
+
+    //The agents are never dereferenced, so any distinct addresses will do.
+    std::vector<char> ids(300);
+    ScanTree tree;
+    for (size_t i=0; i<ids.size(); i++) {
+        tree.agents.push_back(reinterpret_cast<const Agent*>(&ids[i]));
+        tree.positions.push_back(Point(rand()%1000, rand()%1000));
+    }
+
+    AuraQueryBatch batch;
+    for (int round=0; round<3; round++) {
+        batch.clear();
+        std::vector<Point> lowerLeft;
+        std::vector<Point> upperRight;
+        for (int i=0; i<100; i++) {
+            double x = rand()%1000;
+            double y = rand()%1000;
+            lowerLeft.push_back(Point(x, y));
+            upperRight.push_back(Point(x + rand()%200, y + rand()%200));
+            CPPUNIT_ASSERT_MESSAGE("Query added with the wrong index.", batch.add(lowerLeft.back(), upperRight.back(), nullptr)==static_cast<size_t>(i));
+        }
+
+        //The answer order is a permutation of the queries.
+        std::vector<size_t> order = batch.beginAnswers();
+        std::sort(order.begin(), order.end());
+        for (size_t i=0; i<order.size(); i++) {
+            CPPUNIT_ASSERT_MESSAGE("Answer order is not a permutation.", order[i]==i);
+        }
+
+        //Answered twice, to check that old results are discarded.
+        tree.agentsInRects(batch);
+        tree.agentsInRects(batch);
+        for (size_t i=0; i<batch.size(); i++) {
+            std::vector<const Agent*> expected = tree.agentsInRect(lowerLeft[i], upperRight[i], nullptr);
+            std::pair<AuraQueryBatch::ResultIterator, AuraQueryBatch::ResultIterator> found = batch.getResults(i);
+            std::stringstream msg;
+            msg << "Query " << i << " in round " << round << " has the wrong results.";
+            CPPUNIT_ASSERT_MESSAGE(msg.str(), std::vector<const Agent*>(found.first, found.second)==expected);
+        }
+    }
+
+    //Queries in the same corner are answered next to each other.
+    batch.clear();
+    batch.add(Point(0, 0), Point(1, 1), nullptr);
+    batch.add(Point(999, 999), Point(1000, 1000), nullptr);
+    batch.add(Point(1, 1), Point(2, 2), nullptr);
+    batch.add(Point(998, 998), Point(999, 999), nullptr);
+    const std::vector<size_t>& order = batch.beginAnswers();
+    CPPUNIT_ASSERT_MESSAGE("Queries not grouped by locality.", order[0]==0 && order[1]==2 && order[2]==3 && order[3]==1);
+}
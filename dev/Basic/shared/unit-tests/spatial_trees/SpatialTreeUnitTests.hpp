@@ -0,0 +1,40 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the R* tree's bulk loading, and for batched aura queries.
+ */
+class SpatialTreeUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///A bulk loaded tree finds the same items as a brute-force scan (and as a tree built by inserting).
+    void test_bulk_load_matches_brute_force();
+
+    ///Packing the slices on a thread pool gives the same tree contents as packing them serially.
+    void test_parallel_bulk_load();
+
+    ///Empty and tiny loads, items that all share a position, and reloading over an existing tree.
+    void test_bulk_load_edge_cases();
+
+    ///Each query of a batch gets its own results, whatever order the batch was answered in.
+    void test_query_batch();
+
+private:
+    CPPUNIT_TEST_SUITE(SpatialTreeUnitTests);
+        CPPUNIT_TEST(test_bulk_load_matches_brute_force);
+        CPPUNIT_TEST(test_parallel_bulk_load);
+        CPPUNIT_TEST(test_bulk_load_edge_cases);
+        CPPUNIT_TEST(test_query_batch);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
@@ -0,0 +1,246 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "ColumnarOutputUnitTests.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "util/ColumnarOutput.hpp"
+#include "util/LZ_Codec.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::ColumnarOutputUnitTests);
+
+namespace {
+
+const char* const TEST_FILE = "columnar_output_unit_test.bin";
+
+bool RoundTrip(const std::string& input)
+{
+    std::string compressed;
+    LZ_Codec::compress(input.data(), input.size(), compressed);
+    std::vector<char> output(input.size() + 1);
+    return LZ_Codec::decompress(compressed.data(), compressed.size(), output.data(), input.size())
+            && std::string(output.data(), input.size()) == input;
+}
+
+//The same columns as the mid-term "seg" and "lnk" statistics.
+std::vector<ColumnarSchema> SupplySchemas()
+{
+    std::vector<ColumnarSchema> tables(2);
+    tables[0].tag = "seg";
+    tables[0].add("segment_id", COLUMN_ID).add("stats_number", COLUMN_UINT32).add("speed", COLUMN_DOUBLE, 2)
+            .add("flow", COLUMN_UINT32).add("density", COLUMN_DOUBLE, 2).add("num_persons", COLUMN_UINT32)
+            .add("vehicle_length", COLUMN_DOUBLE, 2).add("num_moving", COLUMN_UINT32).add("moving_length", COLUMN_DOUBLE, 2)
+            .add("num_queuing", COLUMN_UINT32).add("queue_length", COLUMN_DOUBLE, 2).add("num_vehicle_lanes", COLUMN_INT32)
+            .add("length", COLUMN_DOUBLE, 2);
+    tables[1].tag = "lnk";
+    tables[1].add("link_id", COLUMN_ID).add("length_km", COLUMN_DOUBLE, 3).add("density", COLUMN_DOUBLE, 3)
+            .add("entry_count", COLUMN_UINT32).add("exit_count", COLUMN_UINT32).add("car_count", COLUMN_UINT32)
+            .add("taxi_count", COLUMN_UINT32).add("motorcycle_count", COLUMN_UINT32).add("bus_count", COLUMN_UINT32)
+            .add("other_vehicles_count", COLUMN_UINT32);
+    return tables;
+}
+
+void AddSegmentRecord(unsigned int seg, unsigned int interval, std::vector<ColumnValue>& values, std::string& legacy)
+{
+    unsigned int count = (seg * 7 + interval) % 23;
+    double density = (seg % 11) * 3.14159 + interval * 0.001;
+    char buf[200];
+    sprintf(buf, "seg,%u,%u,%u,%.2f,%u,%.2f,%u,%.2f,%u,%.2f,%u,%.2f,%d,%.2f\n", interval, seg, 1u, 45.678 - density / 10,
+            count, density, count / 2, count * 4.5, count / 3, count * 1.125, count - count / 3, count * 3.375, (int) (seg % 4) + 1, 123.456 + seg);
+    legacy.append(buf);
+
+    values.push_back(ColumnValue(seg));
+    values.push_back(ColumnValue(1u));
+    values.push_back(ColumnValue(45.678 - density / 10));
+    values.push_back(ColumnValue(count));
+    values.push_back(ColumnValue(density));
+    values.push_back(ColumnValue(count / 2));
+    values.push_back(ColumnValue(count * 4.5));
+    values.push_back(ColumnValue(count / 3));
+    values.push_back(ColumnValue(count * 1.125));
+    values.push_back(ColumnValue(count - count / 3));
+    values.push_back(ColumnValue(count * 3.375));
+    values.push_back(ColumnValue((int) (seg % 4) + 1));
+    values.push_back(ColumnValue(123.456 + seg));
+}
+
+void AddLinkRecord(unsigned int link, unsigned int interval, std::vector<ColumnValue>& values, std::string& legacy)
+{
+    char buf[200];
+    sprintf(buf, "lnk,%u,%u,%.3f,%.3f,%u,%u,%u,%u,%u,%u,%u\n", interval, link, link * 0.0137, interval / 7.0,
+            link % 5, link % 6, link % 7, 0u, link % 2, interval % 3, 1u);
+    legacy.append(buf);
+
+    values.push_back(ColumnValue(link));
+    values.push_back(ColumnValue(link * 0.0137));
+    values.push_back(ColumnValue(interval / 7.0));
+    values.push_back(ColumnValue(link % 5));
+    values.push_back(ColumnValue(link % 6));
+    values.push_back(ColumnValue(link % 7));
+    values.push_back(ColumnValue(0u));
+    values.push_back(ColumnValue(link % 2));
+    values.push_back(ColumnValue(interval % 3));
+    values.push_back(ColumnValue(1u));
+}
+
+std::string ReadAsCsv(std::size_t& numRecords)
+{
+    ColumnarReader reader(TEST_FILE);
+    std::ostringstream csv;
+    numRecords = reader.writeCsv(csv);
+    return csv.str();
+}
+
+} //End un-named namespace
+
+
+void unit_tests::ColumnarOutputUnitTests::test_codec_round_trip()
+{
+    CPPUNIT_ASSERT(RoundTrip(""));
+    CPPUNIT_ASSERT(RoundTrip("a"));
+    CPPUNIT_ASSERT(RoundTrip("short input"));
+
+    std::string repetitive;
+    for (unsigned int i = 0; i < 10000; i++) {
+        repetitive.append("seg,12,345,1,");
+    }
+    CPPUNIT_ASSERT(RoundTrip(repetitive));
+
+    std::string compressed;
+    LZ_Codec::compress(repetitive.data(), repetitive.size(), compressed);
+    CPPUNIT_ASSERT(compressed.size() < repetitive.size() / 10);
+
+    std::string random;
+    unsigned int state = 12345;
+    for (unsigned int i = 0; i < 100000; i++) {
+        state = state * 1103515245 + 12345;
+        //mix random bytes with short repeated runs
+        random.push_back((state >> 16) % 4 == 0 ? 'x' : (char) (state >> 24));
+    }
+    CPPUNIT_ASSERT(RoundTrip(random));
+}
+
+void unit_tests::ColumnarOutputUnitTests::test_codec_rejects_corrupt_input()
+{
+    std::string input;
+    for (unsigned int i = 0; i < 1000; i++) {
+        input.append("lnk,1,2,3.000,");
+    }
+    std::string compressed;
+    LZ_Codec::compress(input.data(), input.size(), compressed);
+
+    std::vector<char> output(input.size());
+    CPPUNIT_ASSERT(!LZ_Codec::decompress(compressed.data(), compressed.size() / 2, output.data(), input.size()));
+    CPPUNIT_ASSERT(!LZ_Codec::decompress(compressed.data(), compressed.size(), output.data(), input.size() - 1));
+}
+
+void unit_tests::ColumnarOutputUnitTests::test_text_format_matches_legacy()
+{
+    std::vector<ColumnarSchema> tables = SupplySchemas();
+    for (unsigned int interval = 0; interval < 5; interval++) {
+        std::string legacy, text;
+        std::vector<ColumnValue> seg, lnk;
+        for (unsigned int id = 1; id < 200; id += 7) {
+            AddSegmentRecord(id, interval, seg, legacy);
+            AddLinkRecord(id, interval, lnk, legacy);
+            formatColumnarRecord(tables[0], interval, &seg[seg.size() - tables[0].columns.size()], text);
+            formatColumnarRecord(tables[1], interval, &lnk[lnk.size() - tables[1].columns.size()], text);
+        }
+        CPPUNIT_ASSERT_EQUAL(legacy, text);
+    }
+}
+
+void unit_tests::ColumnarOutputUnitTests::test_binary_round_trip()
+{
+    for (unsigned int compress = 0; compress < 2; compress++) {
+        std::string legacy;
+        {
+            ColumnarWriter writer(TEST_FILE, SupplySchemas(), compress);
+            for (unsigned int interval = 0; interval < 4; interval++) {
+                //one conflux writes its segments, then its links, per interval
+                for (unsigned int conflux = 0; conflux < 3; conflux++) {
+                    std::vector<ColumnValue> seg, lnk;
+                    std::string segLegacy, lnkLegacy;
+                    for (unsigned int id = conflux * 1000; id < conflux * 1000 + 300; id++) {
+                        AddSegmentRecord(id, interval, seg, segLegacy);
+                    }
+                    for (unsigned int id = conflux * 1000; id < conflux * 1000 + 100; id++) {
+                        AddLinkRecord(id, interval, lnk, lnkLegacy);
+                    }
+                    writer.append(0, interval, seg);
+                    writer.append(1, interval, lnk);
+                    legacy.append(segLegacy);
+                    legacy.append(lnkLegacy);
+                }
+            }
+        }
+
+        //the file is grouped per table and interval; compare the sorted lines
+        std::size_t numRecords = 0;
+        std::string csv = ReadAsCsv(numRecords);
+        CPPUNIT_ASSERT_EQUAL((std::size_t) 4 * 3 * 400, numRecords);
+
+        std::vector<std::string> expected, actual;
+        std::istringstream expectedLines(legacy), actualLines(csv);
+        std::string line;
+        while (std::getline(expectedLines, line)) {
+            expected.push_back(line);
+        }
+        while (std::getline(actualLines, line)) {
+            actual.push_back(line);
+        }
+        std::sort(expected.begin(), expected.end());
+        std::sort(actual.begin(), actual.end());
+        CPPUNIT_ASSERT(expected == actual);
+    }
+    std::remove(TEST_FILE);
+}
+
+void unit_tests::ColumnarOutputUnitTests::test_dictionary_across_blocks()
+{
+    std::vector<ColumnarSchema> tables(1);
+    tables[0].tag = "id";
+    tables[0].add("id", COLUMN_ID).add("value", COLUMN_INT32);
+
+    std::string expected;
+    {
+        ColumnarWriter writer(TEST_FILE, tables, true);
+        for (unsigned int interval = 0; interval < 3; interval++) {
+            //more records than fit in one block, with ids recurring in every block
+            std::vector<ColumnValue> values;
+            for (unsigned int i = 0; i < ColumnarWriter::MAX_BLOCK_RECORDS + 100; i++) {
+                unsigned int id = 4000000000u - (i % 1000) * 17;
+                values.push_back(ColumnValue(id));
+                values.push_back(ColumnValue((int) i - 50000));
+                formatColumnarRecord(tables[0], interval, &values[values.size() - 2], expected);
+            }
+            writer.append(0, interval, values);
+        }
+    }
+
+    //records of a single table come back in the order they were written
+    std::size_t numRecords = 0;
+    CPPUNIT_ASSERT_EQUAL(expected, ReadAsCsv(numRecords));
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 3 * (ColumnarWriter::MAX_BLOCK_RECORDS + 100), numRecords);
+    std::remove(TEST_FILE);
+}
+
+void unit_tests::ColumnarOutputUnitTests::test_reader_rejects_other_files()
+{
+    {
+        std::ofstream file(TEST_FILE);
+        file << "seg,0,1,1,45.00\n";
+    }
+    CPPUNIT_ASSERT_THROW(ColumnarReader reader(TEST_FILE), std::runtime_error);
+    std::remove(TEST_FILE);
+    CPPUNIT_ASSERT_THROW(ColumnarReader reader(TEST_FILE), std::runtime_error);
+}
@@ -0,0 +1,48 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the columnar statistics output and its LZ codec in Basic/util
+ */
+class ColumnarOutputUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///Compressed data decompresses to the original bytes, for empty, tiny, repetitive and random inputs.
+    void test_codec_round_trip();
+
+    ///Decompression fails cleanly on truncated input or a wrong output size.
+    void test_codec_rejects_corrupt_input();
+
+    ///Text formatting gives exactly the lines of the former sprintf-based seg/lnk output.
+    void test_text_format_matches_legacy();
+
+    ///Records written to a binary file convert back to the same text, with and without compression.
+    void test_binary_round_trip();
+
+    ///Ids repeated over intervals and over full blocks resolve to the right values.
+    void test_dictionary_across_blocks();
+
+    ///Opening a file which is not columnar output throws.
+    void test_reader_rejects_other_files();
+
+private:
+    CPPUNIT_TEST_SUITE(ColumnarOutputUnitTests);
+        CPPUNIT_TEST(test_codec_round_trip);
+        CPPUNIT_TEST(test_codec_rejects_corrupt_input);
+        CPPUNIT_TEST(test_text_format_matches_legacy);
+        CPPUNIT_TEST(test_binary_round_trip);
+        CPPUNIT_TEST(test_dictionary_across_blocks);
+        CPPUNIT_TEST(test_reader_rejects_other_files);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
@@ -0,0 +1,168 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "RandomStreamUnitTests.hpp"
+
+#include <vector>
+#include "entities/Entity.hpp"
+#include "util/RandomStream.hpp"
+#include "workers/WorkGroup.hpp"
+#include "workers/WorkGroupManager.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::RandomStreamUnitTests);
+
+namespace {
+
+std::vector<uint32_t> Draw(RandomStream rng, unsigned int count)
+{
+    std::vector<uint32_t> res;
+    for (unsigned int i=0; i<count; i++) {
+        res.push_back(rng());
+    }
+    return res;
+}
+
+//An Entity which accumulates the numbers drawn from its own stream each time tick.
+class RandomDrawEntity : public Entity {
+public:
+    RandomDrawEntity(unsigned int key) : Entity(key), key(key), sum(0) {}
+
+    virtual Entity::UpdateStatus update(timeslice now) {
+        RandomStream rng(1234, key, now.frame(), RandomStream::GENERIC);
+        //a varying number of draws per entity, so that workers get unbalanced loads
+        for (unsigned int i=0; i<=key%5; i++) {
+            sum = sum*31 + rng.uniformInt(1000);
+        }
+        return Entity::UpdateStatus::Continue;
+    }
+
+    uint64_t getSum() const { return sum; }
+
+protected:
+    virtual std::vector<BufferedBase*> buildSubscriptionList() { return std::vector<BufferedBase*>(); }
+    virtual bool isNonspatial() { return true; }
+
+private:
+    unsigned int key;
+    uint64_t sum;
+};
+
+//Runs a set of RandomDrawEntities on the given number of workers; returns their sums.
+std::vector<uint64_t> RunOnWorkers(unsigned int numWorkers)
+{
+    const unsigned int numEntities = 64;
+    const unsigned int numTicks = 20;
+
+    WorkGroupManager wgm;
+    WorkGroup* mainWG = wgm.newWorkGroup(numWorkers, numTicks);
+    wgm.initAllGroups();
+    mainWG->initWorkers(nullptr);
+
+    std::vector<RandomDrawEntity*> entities;
+    for (unsigned int i=0; i<numEntities; i++) {
+        RandomDrawEntity* ent = new RandomDrawEntity(i);
+        ent->setStartTime(0);
+        mainWG->assignAWorker(ent);
+        entities.push_back(ent);
+    }
+
+    wgm.startAllWorkGroups();
+    for (unsigned int i=0; i<numTicks; i++) {
+        wgm.waitAllGroups();
+    }
+
+    std::vector<uint64_t> res;
+    for (std::vector<RandomDrawEntity*>::const_iterator it=entities.begin(); it!=entities.end(); it++) {
+        res.push_back((*it)->getSum());
+    }
+    return res;
+}
+
+} //End unnamed namespace
+
+void unit_tests::RandomStreamUnitTests::test_Philox_known_answers()
+{
+    //Known-answer vectors of the Random123 distribution.
+    uint32_t output[4];
+
+    const uint32_t zeroCtr[4] = {0, 0, 0, 0};
+    const uint32_t zeroKey[2] = {0, 0};
+    RandomStream::philox4x32(zeroCtr, zeroKey, output);
+    CPPUNIT_ASSERT_EQUAL(0x6627e8d5u, output[0]);
+    CPPUNIT_ASSERT_EQUAL(0xe169c58du, output[1]);
+    CPPUNIT_ASSERT_EQUAL(0xbc57ac4cu, output[2]);
+    CPPUNIT_ASSERT_EQUAL(0x9b00dbd8u, output[3]);
+
+    const uint32_t onesCtr[4] = {0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu};
+    const uint32_t onesKey[2] = {0xffffffffu, 0xffffffffu};
+    RandomStream::philox4x32(onesCtr, onesKey, output);
+    CPPUNIT_ASSERT_EQUAL(0x408f276du, output[0]);
+    CPPUNIT_ASSERT_EQUAL(0x41c83b0eu, output[1]);
+    CPPUNIT_ASSERT_EQUAL(0xa20bc7c6u, output[2]);
+    CPPUNIT_ASSERT_EQUAL(0x6d5451fdu, output[3]);
+
+    const uint32_t piCtr[4] = {0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u};
+    const uint32_t piKey[2] = {0xa4093822u, 0x299f31d0u};
+    RandomStream::philox4x32(piCtr, piKey, output);
+    CPPUNIT_ASSERT_EQUAL(0xd16cfe09u, output[0]);
+    CPPUNIT_ASSERT_EQUAL(0x94fdccebu, output[1]);
+    CPPUNIT_ASSERT_EQUAL(0x5001e420u, output[2]);
+    CPPUNIT_ASSERT_EQUAL(0x24126ea1u, output[3]);
+}
+
+void unit_tests::RandomStreamUnitTests::test_same_key_same_stream()
+{
+    //More than one Philox block, to cover the counter increment.
+    std::vector<uint32_t> first = Draw(RandomStream(101, 42, 7, RandomStream::GENERIC), 10);
+    std::vector<uint32_t> second = Draw(RandomStream(101, 42, 7, RandomStream::GENERIC), 10);
+    CPPUNIT_ASSERT(first == second);
+}
+
+void unit_tests::RandomStreamUnitTests::test_key_parts_change_stream()
+{
+    std::vector<uint32_t> base = Draw(RandomStream(101, 42, 7, RandomStream::GENERIC), 4);
+
+    CPPUNIT_ASSERT(base != Draw(RandomStream(102, 42, 7, RandomStream::GENERIC), 4));
+    CPPUNIT_ASSERT(base != Draw(RandomStream(101, 43, 7, RandomStream::GENERIC), 4));
+    CPPUNIT_ASSERT(base != Draw(RandomStream(101, 42, 8, RandomStream::GENERIC), 4));
+    CPPUNIT_ASSERT(base != Draw(RandomStream(101, 42, 7, RandomStream::TOP_C_MERGE), 4));
+
+    //The upper half of 64-bit entity ids is used too.
+    CPPUNIT_ASSERT(base != Draw(RandomStream(101, 42 + (1ull << 40), 7, RandomStream::GENERIC), 4));
+}
+
+void unit_tests::RandomStreamUnitTests::test_bounded_draws()
+{
+    RandomStream rng(101, 1, 0, RandomStream::GENERIC);
+    std::vector<unsigned int> counts(3, 0);
+    for (int i=0; i<3000; i++) {
+        double u = rng.uniform();
+        CPPUNIT_ASSERT(u >= 0.0 && u < 1.0);
+
+        uint32_t n = rng.uniformInt(3);
+        CPPUNIT_ASSERT(n < 3);
+        counts[n]++;
+    }
+
+    //Every value is reachable.
+    for (size_t i=0; i<counts.size(); i++) {
+        CPPUNIT_ASSERT(counts[i] > 0);
+    }
+    CPPUNIT_ASSERT_EQUAL(0u, rng.uniformInt(1));
+}
+
+void unit_tests::RandomStreamUnitTests::test_independent_of_worker_count()
+{
+    std::vector<uint64_t> oneWorker = RunOnWorkers(1);
+    std::vector<uint64_t> fourWorkers = RunOnWorkers(4);
+    std::vector<uint64_t> sixteenWorkers = RunOnWorkers(16);
+
+    CPPUNIT_ASSERT_MESSAGE("Draws differ between 1 and 4 workers", oneWorker == fourWorkers);
+    CPPUNIT_ASSERT_MESSAGE("Draws differ between 1 and 16 workers", oneWorker == sixteenWorkers);
+
+    //Entities with the same number of draws still get different numbers.
+    CPPUNIT_ASSERT_MESSAGE("Entities share the same stream", oneWorker.at(0) != oneWorker.at(5));
+}
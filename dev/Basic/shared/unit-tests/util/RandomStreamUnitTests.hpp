@@ -0,0 +1,44 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the counter-based RandomStream in Basic/util
+ */
+class RandomStreamUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///Philox4x32-10 matches the published known-answer vectors.
+    void test_Philox_known_answers();
+
+    ///Two streams with the same key produce the same numbers.
+    void test_same_key_same_stream();
+
+    ///Changing any part of the key changes the stream.
+    void test_key_parts_change_stream();
+
+    ///Bounded draws stay within their bounds.
+    void test_bounded_draws();
+
+    ///Entities drawing from their own streams get the same numbers with 1, 4 and 16 workers.
+    void test_independent_of_worker_count();
+
+private:
+    CPPUNIT_TEST_SUITE(RandomStreamUnitTests);
+        CPPUNIT_TEST(test_Philox_known_answers);
+        CPPUNIT_TEST(test_same_key_same_stream);
+        CPPUNIT_TEST(test_key_parts_change_stream);
+        CPPUNIT_TEST(test_bounded_draws);
+        CPPUNIT_TEST(test_independent_of_worker_count);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
@@ -0,0 +1,214 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "EntityListUnitTests.hpp"
+
+#include <vector>
+#include "entities/Entity.hpp"
+#include "util/LangHelpers.hpp"
+#include "workers/EntityList.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::EntityListUnitTests);
+
+namespace {
+
+//An Entity which does nothing.
+class ListedEntity : public Entity {
+public:
+    explicit ListedEntity(unsigned int id) : Entity(id) {}
+
+    virtual Entity::UpdateStatus update(timeslice now) { return Entity::UpdateStatus::Continue; }
+
+protected:
+    virtual std::vector<BufferedBase*> buildSubscriptionList() { return std::vector<BufferedBase*>(); }
+    virtual bool isNonspatial() { return true; }
+};
+
+//Same, of another type.
+class OtherListedEntity : public ListedEntity {
+public:
+    explicit OtherListedEntity(unsigned int id) : ListedEntity(id) {}
+};
+
+std::vector<unsigned int> GetIds(const EntityList& list)
+{
+    std::vector<unsigned int> res;
+    for (EntityList::const_iterator it=list.begin(); it!=list.end(); it++) {
+        res.push_back((*it)->getId());
+    }
+    return res;
+}
+
+std::vector<unsigned int> Range(unsigned int first, unsigned int last)
+{
+    std::vector<unsigned int> res;
+    for (unsigned int i=first; i<=last; i++) {
+        res.push_back(i);
+    }
+    return res;
+}
+
+//Entities with the given ids, in that order.
+std::vector<Entity*> MakeEntities(const std::vector<unsigned int>& ids)
+{
+    std::vector<Entity*> res;
+    for (std::vector<unsigned int>::const_iterator it=ids.begin(); it!=ids.end(); it++) {
+        res.push_back(new ListedEntity(*it));
+    }
+    return res;
+}
+
+} //End anon namespace
+
+void unit_tests::EntityListUnitTests::test_insert_erase()
+{
+    std::vector<Entity*> entities = MakeEntities(Range(0, 9));
+    EntityList list;
+    for (std::vector<Entity*>::iterator it=entities.begin(); it!=entities.end(); it++) {
+        CPPUNIT_ASSERT(list.insert(*it));
+    }
+    CPPUNIT_ASSERT(!list.insert(entities[3]));
+    CPPUNIT_ASSERT_EQUAL(size_t(10), list.size());
+
+    //Remove from the middle, the front and the back.
+    CPPUNIT_ASSERT(list.erase(entities[4]));
+    CPPUNIT_ASSERT(list.erase(entities[0]));
+    CPPUNIT_ASSERT(list.erase(entities[9]));
+    CPPUNIT_ASSERT(!list.erase(entities[4]));
+    CPPUNIT_ASSERT_EQUAL(size_t(7), list.size());
+
+    for (size_t i=0; i<entities.size(); i++) {
+        bool removed = (i==0 || i==4 || i==9);
+        CPPUNIT_ASSERT_EQUAL(!removed, list.contains(entities[i]));
+    }
+
+    //Removing every remaining entity through the back.
+    while (!list.empty()) {
+        CPPUNIT_ASSERT(list.erase(list.back()));
+    }
+    CPPUNIT_ASSERT(list.begin() == list.end());
+
+    clear_delete_vector(entities);
+}
+
+void unit_tests::EntityListUnitTests::test_id_order()
+{
+    unsigned int initialIds[] = {7, 3, 12, 0, 9, 5, 1, 14, 2};
+    std::vector<Entity*> entities = MakeEntities(std::vector<unsigned int>(initialIds, initialIds+9));
+    EntityList list(EntityList::ORDER_ID);
+    for (std::vector<Entity*>::iterator it=entities.begin(); it!=entities.end(); it++) {
+        list.insert(*it);
+    }
+    list.prepare();
+
+    unsigned int sortedIds[] = {0, 1, 2, 3, 5, 7, 9, 12, 14};
+    CPPUNIT_ASSERT(GetIds(list) == std::vector<unsigned int>(sortedIds, sortedIds+9));
+
+    //Remove some entities (leaving holes), add others, then restore the order.
+    list.erase(entities[1]); //3
+    list.erase(entities[5]); //5
+    list.erase(entities[7]); //14 (the last one)
+    unsigned int newIds[] = {13, 4, 8};
+    std::vector<Entity*> added = MakeEntities(std::vector<unsigned int>(newIds, newIds+3));
+    for (std::vector<Entity*>::iterator it=added.begin(); it!=added.end(); it++) {
+        list.insert(*it);
+    }
+    list.erase(added[0]); //13, not ordered yet
+    list.prepare();
+
+    unsigned int expectedIds[] = {0, 1, 2, 4, 7, 8, 9, 12};
+    CPPUNIT_ASSERT(GetIds(list) == std::vector<unsigned int>(expectedIds, expectedIds+8));
+    CPPUNIT_ASSERT_EQUAL(size_t(8), list.size());
+    CPPUNIT_ASSERT(list.contains(added[1]));
+    CPPUNIT_ASSERT(!list.contains(added[0]));
+
+    clear_delete_vector(entities);
+    clear_delete_vector(added);
+}
+
+void unit_tests::EntityListUnitTests::test_type_order()
+{
+    std::vector<Entity*> entities;
+    entities.push_back(new ListedEntity(5));
+    entities.push_back(new OtherListedEntity(1));
+    entities.push_back(new ListedEntity(2));
+    entities.push_back(new OtherListedEntity(4));
+    entities.push_back(new ListedEntity(3));
+
+    EntityList list(EntityList::ORDER_TYPE);
+    for (std::vector<Entity*>::iterator it=entities.begin(); it!=entities.end(); it++) {
+        list.insert(*it);
+    }
+    list.prepare();
+
+    //Entities of one type must form a single run, sorted by id.
+    std::vector<Entity*> ordered(list.begin(), list.end());
+    CPPUNIT_ASSERT_EQUAL(size_t(5), ordered.size());
+    unsigned int typeChanges = 0;
+    for (size_t i=1; i<ordered.size(); i++) {
+        bool sameType = (typeid(*ordered[i]) == typeid(*ordered[i-1]));
+        if (sameType) {
+            CPPUNIT_ASSERT(ordered[i-1]->getId() < ordered[i]->getId());
+        } else {
+            typeChanges++;
+        }
+    }
+    CPPUNIT_ASSERT_EQUAL(1u, typeChanges);
+
+    clear_delete_vector(entities);
+}
+
+void unit_tests::EntityListUnitTests::test_iteration_skips_removed()
+{
+    std::vector<Entity*> entities = MakeEntities(Range(0, 5));
+    EntityList list(EntityList::ORDER_ID);
+    for (std::vector<Entity*>::iterator it=entities.begin(); it!=entities.end(); it++) {
+        list.insert(*it);
+    }
+    list.prepare();
+    list.erase(entities[1]);
+    list.erase(entities[2]);
+
+    unsigned int expectedIds[] = {0, 3, 4, 5};
+    CPPUNIT_ASSERT(GetIds(list) == std::vector<unsigned int>(expectedIds, expectedIds+4));
+    CPPUNIT_ASSERT_EQUAL(size_t(4), list.size());
+
+    //Removing through the back never meets a hole.
+    while (!list.empty()) {
+        Entity* last = list.back();
+        CPPUNIT_ASSERT(last);
+        CPPUNIT_ASSERT(list.erase(last));
+    }
+
+    clear_delete_vector(entities);
+}
+
+void unit_tests::EntityListUnitTests::test_migration()
+{
+    std::vector<Entity*> entities = MakeEntities(Range(0, 3));
+    EntityList first;
+    EntityList second(EntityList::ORDER_ID);
+    for (std::vector<Entity*>::iterator it=entities.begin(); it!=entities.end(); it++) {
+        first.insert(*it);
+    }
+
+    //Move entity 1 over; it must only be found in the second list.
+    first.erase(entities[1]);
+    second.insert(entities[1]);
+    CPPUNIT_ASSERT(!first.contains(entities[1]));
+    CPPUNIT_ASSERT(second.contains(entities[1]));
+    CPPUNIT_ASSERT(!second.contains(entities[0]));
+    CPPUNIT_ASSERT_EQUAL(size_t(3), first.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), second.size());
+
+    //And back again.
+    second.erase(entities[1]);
+    first.insert(entities[1]);
+    CPPUNIT_ASSERT(first.contains(entities[1]));
+    CPPUNIT_ASSERT(second.empty());
+
+    clear_delete_vector(entities);
+}
@@ -0,0 +1,44 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the EntityList used by Workers to hold their entities.
+ */
+class EntityListUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///Inserting and removing keeps the list contiguous and the slots of the remaining entities valid.
+    void test_insert_erase();
+
+    ///With ORDER_ID, entities are iterated by id after prepare(), whatever the order of additions and removals.
+    void test_id_order();
+
+    ///With ORDER_TYPE, entities are grouped by type and ordered by id within a group.
+    void test_type_order();
+
+    ///Removed entities are skipped by iteration even before prepare() is called.
+    void test_iteration_skips_removed();
+
+    ///An entity moves from one list to another, as when it migrates between workers.
+    void test_migration();
+
+private:
+    CPPUNIT_TEST_SUITE(EntityListUnitTests);
+        CPPUNIT_TEST(test_insert_erase);
+        CPPUNIT_TEST(test_id_order);
+        CPPUNIT_TEST(test_type_order);
+        CPPUNIT_TEST(test_iteration_skips_removed);
+        CPPUNIT_TEST(test_migration);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
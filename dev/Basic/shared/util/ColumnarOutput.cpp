@@ -0,0 +1,504 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "ColumnarOutput.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include "util/LZ_Codec.hpp"
+
+using namespace sim_mob;
+
+namespace
+{
+const char MAGIC[8] = { 'S', 'M', 'C', 'O', 'L', 'S', '0', '1' };
+
+const char DICTIONARY_BLOCK = 'D';
+const char RECORD_BLOCK = 'R';
+
+const unsigned char CODEC_NONE = 0;
+const unsigned char CODEC_LZ = 1;
+
+unsigned int getColumnWidth(ColumnType type)
+{
+    return (type == COLUMN_DOUBLE) ? 8 : 4;
+}
+
+//all integers are stored little-endian, whatever the host
+
+void put32(std::string& out, uint32_t value)
+{
+    char bytes[4] = { (char) value, (char) (value >> 8), (char) (value >> 16), (char) (value >> 24) };
+    out.append(bytes, 4);
+}
+
+void putDouble(std::string& out, double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    put32(out, (uint32_t) bits);
+    put32(out, (uint32_t) (bits >> 32));
+}
+
+void putString(std::string& out, const std::string& value)
+{
+    put32(out, value.size());
+    out.append(value);
+}
+
+uint32_t get32(const char* in)
+{
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(in);
+    return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t) bytes[3] << 24);
+}
+
+double getDouble(const char* in)
+{
+    uint64_t bits = get32(in) | ((uint64_t) get32(in + 4) << 32);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void readBytes(std::istream& in, char* buffer, std::size_t size)
+{
+    if (!in.read(buffer, size))
+    {
+        throw std::runtime_error("corrupt columnar file: unexpected end of file");
+    }
+}
+
+uint32_t read32(std::istream& in)
+{
+    char bytes[4];
+    readBytes(in, bytes, 4);
+    return get32(bytes);
+}
+
+unsigned char readByte(std::istream& in)
+{
+    char byte;
+    readBytes(in, &byte, 1);
+    return byte;
+}
+
+std::string readString(std::istream& in)
+{
+    uint32_t size = read32(in);
+    std::string value(size, '\0');
+    if (size > 0)
+    {
+        readBytes(in, &value[0], size);
+    }
+    return value;
+}
+}
+
+const unsigned int sim_mob::ColumnarWriter::MAX_BLOCK_RECORDS;
+
+uint32_t sim_mob::ColumnValue::asUInt32() const
+{
+    switch (type)
+    {
+    case COLUMN_INT32:
+        return (uint32_t) i;
+    case COLUMN_DOUBLE:
+        return (uint32_t) d;
+    default:
+        return u;
+    }
+}
+
+int32_t sim_mob::ColumnValue::asInt32() const
+{
+    switch (type)
+    {
+    case COLUMN_INT32:
+        return i;
+    case COLUMN_DOUBLE:
+        return (int32_t) d;
+    default:
+        return (int32_t) u;
+    }
+}
+
+double sim_mob::ColumnValue::asDouble() const
+{
+    switch (type)
+    {
+    case COLUMN_INT32:
+        return i;
+    case COLUMN_DOUBLE:
+        return d;
+    default:
+        return u;
+    }
+}
+
+void sim_mob::formatColumnarRecord(const ColumnarSchema& schema, uint32_t interval, const ColumnValue* values, std::string& out)
+{
+    char buf[64];
+    out.append(schema.tag);
+    snprintf(buf, sizeof(buf), ",%u", interval);
+    out.append(buf);
+    for (std::size_t c = 0; c < schema.columns.size(); c++)
+    {
+        const ColumnDef& column = schema.columns[c];
+        switch (column.type)
+        {
+        case COLUMN_INT32:
+            snprintf(buf, sizeof(buf), ",%d", values[c].asInt32());
+            break;
+        case COLUMN_DOUBLE:
+            snprintf(buf, sizeof(buf), ",%.*f", (int) column.precision, values[c].asDouble());
+            break;
+        default:
+            snprintf(buf, sizeof(buf), ",%u", values[c].asUInt32());
+            break;
+        }
+        out.append(buf);
+    }
+    out.push_back('\n');
+}
+
+sim_mob::ColumnarWriter::ColumnarWriter(const std::string& fileName, const std::vector<ColumnarSchema>& tables, bool compress) :
+        file(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc), tables(tables), compress(compress),
+        blocks(tables.size()), dictionaries(tables.size()), newDictionaryEntries(tables.size())
+{
+    if (!file.is_open())
+    {
+        throw std::runtime_error("cannot open columnar output file " + fileName);
+    }
+
+    std::string header(MAGIC, sizeof(MAGIC));
+    put32(header, tables.size());
+    for (std::size_t t = 0; t < tables.size(); t++)
+    {
+        const ColumnarSchema& schema = tables[t];
+        putString(header, schema.tag);
+        put32(header, schema.columns.size());
+        for (std::vector<ColumnDef>::const_iterator it = schema.columns.begin(); it != schema.columns.end(); it++)
+        {
+            putString(header, it->name);
+            header.push_back((char) it->type);
+            header.push_back((char) it->precision);
+        }
+        blocks[t].columns.resize(schema.columns.size());
+        dictionaries[t].resize(schema.columns.size());
+        newDictionaryEntries[t].resize(schema.columns.size());
+    }
+    file.write(header.data(), header.size());
+}
+
+sim_mob::ColumnarWriter::~ColumnarWriter()
+{
+    flush();
+    file.close();
+}
+
+void sim_mob::ColumnarWriter::append(unsigned int table, uint32_t interval, const std::vector<ColumnValue>& values)
+{
+    if (table >= tables.size())
+    {
+        throw std::out_of_range("columnar output: invalid table index");
+    }
+    const std::vector<ColumnDef>& columns = tables[table].columns;
+    if (columns.empty() || values.size() % columns.size() != 0)
+    {
+        throw std::runtime_error("columnar output: number of values does not match the columns of table " + tables[table].tag);
+    }
+
+    boost::mutex::scoped_lock lock(mtx);
+    Block& block = blocks[table];
+    if (block.numRecords > 0 && block.interval != interval)
+    {
+        writeBlock(table);
+    }
+    block.interval = interval;
+
+    for (std::size_t first = 0; first < values.size(); first += columns.size())
+    {
+        for (std::size_t c = 0; c < columns.size(); c++)
+        {
+            const ColumnValue& value = values[first + c];
+            std::string& column = block.columns[c];
+            switch (columns[c].type)
+            {
+            case COLUMN_INT32:
+                put32(column, value.asInt32());
+                break;
+            case COLUMN_DOUBLE:
+                putDouble(column, value.asDouble());
+                break;
+            case COLUMN_ID:
+            {
+                boost::unordered_map<uint32_t, uint32_t>& dictionary = dictionaries[table][c];
+                std::pair<boost::unordered_map<uint32_t, uint32_t>::iterator, bool> inserted =
+                        dictionary.insert(std::make_pair(value.asUInt32(), dictionary.size()));
+                if (inserted.second)
+                {
+                    newDictionaryEntries[table][c].push_back(value.asUInt32());
+                }
+                put32(column, inserted.first->second);
+                break;
+            }
+            default:
+                put32(column, value.asUInt32());
+                break;
+            }
+        }
+        if (++block.numRecords == MAX_BLOCK_RECORDS)
+        {
+            writeBlock(table);
+        }
+    }
+}
+
+void sim_mob::ColumnarWriter::flush()
+{
+    boost::mutex::scoped_lock lock(mtx);
+    for (std::size_t t = 0; t < tables.size(); t++)
+    {
+        writeBlock(t);
+    }
+    file.flush();
+}
+
+void sim_mob::ColumnarWriter::writeBlock(unsigned int table)
+{
+    Block& block = blocks[table];
+    if (block.numRecords == 0)
+    {
+        return;
+    }
+
+    std::string out;
+
+    //dictionary entries first, so that a reader knows all ids of the block
+    for (std::size_t c = 0; c < block.columns.size(); c++)
+    {
+        std::vector<uint32_t>& entries = newDictionaryEntries[table][c];
+        if (!entries.empty())
+        {
+            out.push_back(DICTIONARY_BLOCK);
+            put32(out, table);
+            put32(out, c);
+            put32(out, entries.size());
+            for (std::vector<uint32_t>::const_iterator it = entries.begin(); it != entries.end(); it++)
+            {
+                put32(out, *it);
+            }
+            entries.clear();
+        }
+    }
+
+    std::string payload;
+    for (std::size_t c = 0; c < block.columns.size(); c++)
+    {
+        payload.append(block.columns[c]);
+        block.columns[c].clear();
+    }
+
+    unsigned char codec = CODEC_NONE;
+    std::string compressed;
+    if (compress)
+    {
+        LZ_Codec::compress(payload.data(), payload.size(), compressed);
+        if (compressed.size() < payload.size())
+        {
+            codec = CODEC_LZ;
+        }
+    }
+    const std::string& stored = (codec == CODEC_LZ) ? compressed : payload;
+
+    out.push_back(RECORD_BLOCK);
+    put32(out, table);
+    put32(out, block.interval);
+    put32(out, block.numRecords);
+    out.push_back((char) codec);
+    put32(out, payload.size());
+    put32(out, stored.size());
+    file.write(out.data(), out.size());
+    file.write(stored.data(), stored.size());
+
+    block.numRecords = 0;
+}
+
+sim_mob::ColumnarReader::ColumnarReader(const std::string& fileName) :
+        file(fileName.c_str(), std::ios::in | std::ios::binary)
+{
+    if (!file.is_open())
+    {
+        throw std::runtime_error("cannot open columnar file " + fileName);
+    }
+
+    char magic[sizeof(MAGIC)];
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+    {
+        throw std::runtime_error(fileName + " is not a columnar output file");
+    }
+
+    uint32_t numTables = read32(file);
+    tables.resize(numTables);
+    dictionaries.resize(numTables);
+    for (uint32_t t = 0; t < numTables; t++)
+    {
+        ColumnarSchema& schema = tables[t];
+        schema.tag = readString(file);
+        uint32_t numColumns = read32(file);
+        for (uint32_t c = 0; c < numColumns; c++)
+        {
+            std::string name = readString(file);
+            unsigned char type = readByte(file);
+            unsigned char precision = readByte(file);
+            if (type > COLUMN_ID)
+            {
+                throw std::runtime_error("corrupt columnar file: unknown column type");
+            }
+            schema.add(name, (ColumnType) type, precision);
+        }
+        dictionaries[t].resize(numColumns);
+    }
+}
+
+const std::vector<ColumnarSchema>& sim_mob::ColumnarReader::getTables() const
+{
+    return tables;
+}
+
+bool sim_mob::ColumnarReader::readBlock(unsigned int& table, uint32_t& interval, std::vector<ColumnValue>& values)
+{
+    values.clear();
+    while (true)
+    {
+        char kind;
+        if (!file.get(kind))
+        {
+            return false;
+        }
+
+        table = read32(file);
+        if (table >= tables.size())
+        {
+            throw std::runtime_error("corrupt columnar file: invalid table index");
+        }
+
+        if (kind == DICTIONARY_BLOCK)
+        {
+            uint32_t column = read32(file);
+            if (column >= dictionaries[table].size())
+            {
+                throw std::runtime_error("corrupt columnar file: invalid column index");
+            }
+            uint32_t count = read32(file);
+            std::vector<uint32_t>& dictionary = dictionaries[table][column];
+            for (uint32_t i = 0; i < count; i++)
+            {
+                dictionary.push_back(read32(file));
+            }
+            continue;
+        }
+        if (kind != RECORD_BLOCK)
+        {
+            throw std::runtime_error("corrupt columnar file: unknown block type");
+        }
+
+        interval = read32(file);
+        uint32_t numRecords = read32(file);
+        unsigned char codec = readByte(file);
+        uint32_t rawSize = read32(file);
+        uint32_t storedSize = read32(file);
+
+        std::vector<char> stored(storedSize);
+        if (storedSize > 0)
+        {
+            readBytes(file, &stored[0], storedSize);
+        }
+        std::vector<char> payload;
+        if (codec == CODEC_LZ)
+        {
+            payload.resize(rawSize);
+            if (!LZ_Codec::decompress(stored.data(), storedSize, payload.data(), rawSize))
+            {
+                throw std::runtime_error("corrupt columnar file: invalid compressed block");
+            }
+        }
+        else if (codec == CODEC_NONE)
+        {
+            payload.swap(stored);
+        }
+        else
+        {
+            throw std::runtime_error("corrupt columnar file: unknown codec");
+        }
+
+        const std::vector<ColumnDef>& columns = tables[table].columns;
+        std::vector<std::size_t> offsets(columns.size());
+        std::size_t size = 0;
+        for (std::size_t c = 0; c < columns.size(); c++)
+        {
+            offsets[c] = size;
+            size += (std::size_t) getColumnWidth(columns[c].type) * numRecords;
+        }
+        if (size != payload.size())
+        {
+            throw std::runtime_error("corrupt columnar file: block size does not match its records");
+        }
+
+        values.reserve((std::size_t) numRecords * columns.size());
+        for (uint32_t r = 0; r < numRecords; r++)
+        {
+            for (std::size_t c = 0; c < columns.size(); c++)
+            {
+                const char* in = payload.data() + offsets[c] + (std::size_t) r * getColumnWidth(columns[c].type);
+                switch (columns[c].type)
+                {
+                case COLUMN_INT32:
+                    values.push_back(ColumnValue((int) get32(in)));
+                    break;
+                case COLUMN_DOUBLE:
+                    values.push_back(ColumnValue(getDouble(in)));
+                    break;
+                case COLUMN_ID:
+                {
+                    uint32_t index = get32(in);
+                    if (index >= dictionaries[table][c].size())
+                    {
+                        throw std::runtime_error("corrupt columnar file: id not in dictionary");
+                    }
+                    values.push_back(ColumnValue((unsigned int) dictionaries[table][c][index]));
+                    break;
+                }
+                default:
+                    values.push_back(ColumnValue((unsigned int) get32(in)));
+                    break;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+std::size_t sim_mob::ColumnarReader::writeCsv(std::ostream& out)
+{
+    std::size_t numRecords = 0;
+    unsigned int table;
+    uint32_t interval;
+    std::vector<ColumnValue> values;
+    std::string text;
+    while (readBlock(table, interval, values))
+    {
+        const ColumnarSchema& schema = tables[table];
+        text.clear();
+        for (std::size_t first = 0; first < values.size(); first += schema.columns.size())
+        {
+            formatColumnarRecord(schema, interval, &values[first], text);
+            numRecords++;
+        }
+        out << text;
+    }
+    return numRecords;
+}
@@ -0,0 +1,234 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <fstream>
+#include <iosfwd>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+
+namespace sim_mob
+{
+
+/**
+ * Type of a column of a columnar output table
+ */
+enum ColumnType
+{
+    /// unsigned 32 bit integer, printed with %u
+    COLUMN_UINT32 = 0,
+
+    /// signed 32 bit integer, printed with %d
+    COLUMN_INT32,
+
+    /// double, printed with %.<precision>f
+    COLUMN_DOUBLE,
+
+    /// unsigned 32 bit id, stored as an index in a per-column dictionary and printed with %u
+    COLUMN_ID
+};
+
+struct ColumnDef
+{
+    ColumnDef(const std::string& name = std::string(), ColumnType type = COLUMN_UINT32, unsigned int precision = 0) :
+            name(name), type(type), precision(precision)
+    {
+    }
+
+    std::string name;
+    ColumnType type;
+
+    /// number of decimals printed for COLUMN_DOUBLE
+    unsigned int precision;
+};
+
+/**
+ * Layout of one table of a columnar output file.
+ *
+ * A record of the table is printed as "<tag>,<interval>,<column 0>,...,<column n-1>\n", which is the format of the
+ * text statistics outputs. The interval is not a column; it is shared by all records of a block.
+ */
+struct ColumnarSchema
+{
+    ColumnarSchema(const std::string& tag = std::string()) : tag(tag)
+    {
+    }
+
+    ColumnarSchema& add(const std::string& name, ColumnType type, unsigned int precision = 0)
+    {
+        columns.push_back(ColumnDef(name, type, precision));
+        return *this;
+    }
+
+    /// first field of every printed record
+    std::string tag;
+    std::vector<ColumnDef> columns;
+};
+
+/**
+ * A value of a record. Values are converted to the type of their column when they are written
+ */
+class ColumnValue
+{
+public:
+    ColumnValue(unsigned int value) : type(COLUMN_UINT32)
+    {
+        u = value;
+    }
+
+    ColumnValue(int value) : type(COLUMN_INT32)
+    {
+        i = value;
+    }
+
+    ColumnValue(double value) : type(COLUMN_DOUBLE)
+    {
+        d = value;
+    }
+
+    uint32_t asUInt32() const;
+    int32_t asInt32() const;
+    double asDouble() const;
+
+private:
+    ColumnType type;
+    union
+    {
+        uint32_t u;
+        int32_t i;
+        double d;
+    };
+};
+
+/**
+ * Appends the text form of a record ("<tag>,<interval>,<values...>\n") to a string.
+ * This is the text output format, and the format produced by ColumnarReader::writeCsv.
+ * @param schema table of the record
+ * @param interval interval of the record
+ * @param values the values of the record's columns
+ * @param out output
+ */
+void formatColumnarRecord(const ColumnarSchema& schema, uint32_t interval, const ColumnValue* values, std::string& out);
+
+/**
+ * Writes records into a binary columnar file.
+ *
+ * The file starts with the schemas of its tables. Records are grouped in blocks of one table and one interval;
+ * a block stores each column contiguously with fixed-width little-endian values (4 bytes for integers and ids,
+ * 8 bytes for doubles), optionally compressed with LZ_Codec. Values of COLUMN_ID columns are replaced by their index
+ * in a dictionary kept per column; new dictionary entries are written just before the first block using them.
+ *
+ * Records of a block are kept in memory until a record of a different interval arrives for the same table, the block
+ * is full, or the writer is flushed. All methods are thread-safe.
+ */
+class ColumnarWriter : private boost::noncopyable
+{
+public:
+    /**
+     * @param fileName output file; overwritten if it exists
+     * @param tables tables of the file
+     * @param compress whether blocks are compressed
+     */
+    ColumnarWriter(const std::string& fileName, const std::vector<ColumnarSchema>& tables, bool compress);
+
+    /**
+     * flushes and closes the file
+     */
+    virtual ~ColumnarWriter();
+
+    /**
+     * adds records to a table
+     * @param table index of the table
+     * @param interval interval of the records
+     * @param values values of the records, one after the other; the size must be a multiple of the number of columns
+     */
+    void append(unsigned int table, uint32_t interval, const std::vector<ColumnValue>& values);
+
+    /**
+     * writes all buffered records to the file
+     */
+    void flush();
+
+    /// maximum number of records in a block
+    static const unsigned int MAX_BLOCK_RECORDS = 65536;
+
+private:
+    struct Block
+    {
+        Block() : interval(0), numRecords(0)
+        {
+        }
+
+        uint32_t interval;
+        uint32_t numRecords;
+
+        /// one buffer per column, holding the fixed-width values
+        std::vector<std::string> columns;
+    };
+
+    /// writes the open block of a table, if it has records. mtx must be held
+    void writeBlock(unsigned int table);
+
+    std::ofstream file;
+    std::vector<ColumnarSchema> tables;
+    bool compress;
+
+    /// open block of each table
+    std::vector<Block> blocks;
+
+    /// [table][column] -> (id -> dictionary index), for COLUMN_ID columns
+    std::vector< std::vector< boost::unordered_map<uint32_t, uint32_t> > > dictionaries;
+
+    /// [table][column] -> ids added to the dictionary and not yet written
+    std::vector< std::vector< std::vector<uint32_t> > > newDictionaryEntries;
+
+    boost::mutex mtx;
+};
+
+/**
+ * Reads a file written by ColumnarWriter.
+ */
+class ColumnarReader : private boost::noncopyable
+{
+public:
+    /**
+     * opens a file and reads its tables
+     * @param fileName input file
+     * @throws std::runtime_error if the file cannot be opened or is not a columnar file
+     */
+    explicit ColumnarReader(const std::string& fileName);
+
+    const std::vector<ColumnarSchema>& getTables() const;
+
+    /**
+     * reads the next block of records
+     * @param table output; index of the table of the block
+     * @param interval output; interval of the records
+     * @param values output; values of the records, one record after the other, converted to the column types
+     * @return false at the end of the file
+     * @throws std::runtime_error if the file is corrupt
+     */
+    bool readBlock(unsigned int& table, uint32_t& interval, std::vector<ColumnValue>& values);
+
+    /**
+     * converts the remaining blocks of the file to text, in the text statistics output format
+     * @param out output stream
+     * @return number of records written
+     */
+    std::size_t writeCsv(std::ostream& out);
+
+private:
+    std::ifstream file;
+    std::vector<ColumnarSchema> tables;
+
+    /// [table][column] -> dictionary of COLUMN_ID columns
+    std::vector< std::vector< std::vector<uint32_t> > > dictionaries;
+};
+
+}
@@ -0,0 +1,178 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "LZ_Codec.hpp"
+
+#include <cstring>
+#include <stdint.h>
+#include <vector>
+
+using namespace sim_mob;
+
+namespace
+{
+const std::size_t MIN_MATCH = 4;
+
+/// a match must start at least this many bytes before the end of the block
+const std::size_t MF_LIMIT = 12;
+
+/// the last bytes of a block are always literals
+const std::size_t LAST_LITERALS = 5;
+
+const std::size_t MAX_OFFSET = 65535;
+
+const unsigned int HASH_LOG = 16;
+
+inline uint32_t read32(const char* p)
+{
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint32_t hash(uint32_t sequence)
+{
+    return (sequence * 2654435761U) >> (32 - HASH_LOG);
+}
+
+/// writes the remainder of a length which did not fit in its token nibble
+void writeLength(std::size_t length, std::string& dst)
+{
+    while (length >= 255)
+    {
+        dst.push_back((char) 255);
+        length -= 255;
+    }
+    dst.push_back((char) length);
+}
+
+void writeSequence(const char* literals, std::size_t literalLength, std::size_t offset, std::size_t matchLength, std::string& dst)
+{
+    std::size_t matchCode = matchLength - MIN_MATCH;
+    unsigned char token = (unsigned char) (((literalLength < 15 ? literalLength : 15) << 4) | (matchCode < 15 ? matchCode : 15));
+    dst.push_back((char) token);
+    if (literalLength >= 15)
+    {
+        writeLength(literalLength - 15, dst);
+    }
+    dst.append(literals, literalLength);
+    dst.push_back((char) (offset & 0xFF));
+    dst.push_back((char) (offset >> 8));
+    if (matchCode >= 15)
+    {
+        writeLength(matchCode - 15, dst);
+    }
+}
+
+/// reads the remainder of a length; returns false if the block ends first
+bool readLength(const unsigned char*& ip, const unsigned char* end, std::size_t& length)
+{
+    unsigned char byte;
+    do
+    {
+        if (ip >= end)
+        {
+            return false;
+        }
+        byte = *ip++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+}
+
+void sim_mob::LZ_Codec::compress(const char* src, std::size_t srcSize, std::string& dst)
+{
+    std::size_t anchor = 0;
+    if (srcSize > MF_LIMIT)
+    {
+        std::vector<int64_t> table(1 << HASH_LOG, -1);
+        const std::size_t matchLimit = srcSize - LAST_LITERALS;
+        std::size_t ip = 0;
+        while (ip < srcSize - MF_LIMIT)
+        {
+            uint32_t sequence = read32(src + ip);
+            uint32_t h = hash(sequence);
+            int64_t ref = table[h];
+            table[h] = ip;
+            if (ref < 0 || ip - ref > MAX_OFFSET || read32(src + ref) != sequence)
+            {
+                ip++;
+                continue;
+            }
+
+            std::size_t matchLength = MIN_MATCH;
+            while (ip + matchLength < matchLimit && src[ref + matchLength] == src[ip + matchLength])
+            {
+                matchLength++;
+            }
+            writeSequence(src + anchor, ip - anchor, ip - ref, matchLength, dst);
+            ip += matchLength;
+            anchor = ip;
+        }
+    }
+
+    //last literals
+    std::size_t literalLength = srcSize - anchor;
+    dst.push_back((char) ((literalLength < 15 ? literalLength : 15) << 4));
+    if (literalLength >= 15)
+    {
+        writeLength(literalLength - 15, dst);
+    }
+    dst.append(src + anchor, literalLength);
+}
+
+bool sim_mob::LZ_Codec::decompress(const char* src, std::size_t srcSize, char* dst, std::size_t dstSize)
+{
+    const unsigned char* ip = reinterpret_cast<const unsigned char*>(src);
+    const unsigned char* end = ip + srcSize;
+    std::size_t op = 0;
+    while (ip < end)
+    {
+        unsigned char token = *ip++;
+
+        std::size_t literalLength = token >> 4;
+        if (literalLength == 15 && !readLength(ip, end, literalLength))
+        {
+            return false;
+        }
+        if (literalLength > (std::size_t) (end - ip) || literalLength > dstSize - op)
+        {
+            return false;
+        }
+        std::memcpy(dst + op, ip, literalLength);
+        ip += literalLength;
+        op += literalLength;
+
+        //the last sequence has no match
+        if (ip == end)
+        {
+            break;
+        }
+
+        if (end - ip < 2)
+        {
+            return false;
+        }
+        std::size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        std::size_t matchLength = token & 0x0F;
+        if (matchLength == 15 && !readLength(ip, end, matchLength))
+        {
+            return false;
+        }
+        matchLength += MIN_MATCH;
+        if (offset == 0 || offset > op || matchLength > dstSize - op)
+        {
+            return false;
+        }
+
+        //byte by byte, since the match may overlap the bytes being written
+        for (std::size_t i = 0; i < matchLength; i++, op++)
+        {
+            dst[op] = dst[op - offset];
+        }
+    }
+    return op == dstSize;
+}
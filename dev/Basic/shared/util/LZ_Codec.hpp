@@ -0,0 +1,45 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace sim_mob
+{
+
+/**
+ * Small LZ77 block compressor using the LZ4 block format.
+ *
+ * A block is a sequence of (literals, match) pairs: a token byte holding the literal and match lengths,
+ * the literals, and a 2-byte little-endian offset to the match. Lengths of 15 or more continue in extra bytes.
+ * The compressor is a greedy single-pass matcher; it favours speed over ratio and is meant for output files
+ * with many repeated values, such as columnar statistics.
+ *
+ * The uncompressed size is not part of the block and must be stored by the caller.
+ */
+class LZ_Codec
+{
+public:
+    /**
+     * compresses a block
+     * @param src data to compress
+     * @param srcSize number of bytes in src
+     * @param dst output; the compressed block is appended to it
+     */
+    static void compress(const char* src, std::size_t srcSize, std::string& dst);
+
+    /**
+     * decompresses a block
+     * @param src compressed block
+     * @param srcSize number of bytes in src
+     * @param dst output buffer
+     * @param dstSize size of the uncompressed data
+     * @return true if the block was valid and decompressed to exactly dstSize bytes
+     */
+    static bool decompress(const char* src, std::size_t srcSize, char* dst, std::size_t dstSize);
+};
+
+}
@@ -1,8 +1,10 @@
 #include "Profiler.hpp"
 #include "logging/Log.hpp"
 
-#include <boost/lockfree/queue.hpp>
+#include <deque>
 #include <boost/foreach.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/unordered_map.hpp>
 //#include "boost/date_time/posix_time/posix_time.hpp"
 #include <boost/chrono/system_clocks.hpp>
 
@@ -12,10 +14,108 @@ using namespace boost::posix_time;
  *     Basic Logger Implementation
  * **********************************
  */
-boost::shared_mutex sim_mob::Logger::instanceMutex;
-std::map <boost::thread::id, int> sim_mob::BasicLogger::threads= std::map <boost::thread::id, int>();//for debugging only
-int sim_mob::BasicLogger::flushCnt = 0;
-unsigned long int sim_mob::BasicLogger::ii = 0;
+const std::size_t sim_mob::Logger::NUM_SHARDS;
+
+namespace
+{
+/// a thread's buffer is handed over to the writer once it holds this many bytes
+/// by some googling this estimated hard-code value promises less cycles to write to a file
+const std::streamoff BUFFER_FLUSH_SIZE = 512000/*500KB*/;
+
+/// maximum number of bytes waiting for the writer before logging threads are held up
+const std::size_t MAX_PENDING_BYTES = 64 * 1024 * 1024;
+
+/// source of BasicLogger indices
+boost::atomic<unsigned int> nextLoggerIndex(0);
+
+/// logger index -> buffer of the calling thread for that logger
+thread_local std::vector<sim_mob::LogBuffer*> localBuffers;
+
+/// logger key -> logger, for the keys already looked up by the calling thread
+thread_local boost::unordered_map<std::string, sim_mob::BasicLogger*> localLoggers;
+
+/**
+ * Single thread doing all the file writes of the loggers
+ */
+class LogWriter
+{
+public:
+    /// the writer is never destroyed, since loggers are flushed from static destructors
+    static LogWriter& getInstance()
+    {
+        static LogWriter* instance = new LogWriter();
+        return *instance;
+    }
+
+    /// queues data to be written to a file. waits while too much data is pending
+    void write(std::ofstream& file, std::string& data)
+    {
+        boost::unique_lock<boost::mutex> lock(mtx);
+        while (pendingBytes > MAX_PENDING_BYTES)
+        {
+            writtenCondition.wait(lock);
+        }
+        pendingBytes += data.size();
+        queue.push_back(Chunk());
+        queue.back().file = &file;
+        queue.back().data.swap(data);
+        queueCondition.notify_one();
+    }
+
+    /// waits until everything queued so far is written
+    void waitUntilWritten()
+    {
+        boost::unique_lock<boost::mutex> lock(mtx);
+        while (!queue.empty() || writing)
+        {
+            writtenCondition.wait(lock);
+        }
+    }
+
+private:
+    struct Chunk
+    {
+        std::ofstream* file;
+        std::string data;
+    };
+
+    LogWriter() : pendingBytes(0), writing(false), writer(boost::bind(&LogWriter::run, this))
+    {
+    }
+
+    void run()
+    {
+        Chunk chunk;
+        while (true)
+        {
+            {
+                boost::unique_lock<boost::mutex> lock(mtx);
+                writing = false;
+                pendingBytes -= chunk.data.size();
+                writtenCondition.notify_all();
+                while (queue.empty())
+                {
+                    queueCondition.wait(lock);
+                }
+                chunk.file = queue.front().file;
+                chunk.data.swap(queue.front().data);
+                queue.pop_front();
+                writing = true;
+            }
+            *chunk.file << chunk.data;
+            chunk.file->flush();
+        }
+    }
+
+    boost::mutex mtx;
+    boost::condition_variable queueCondition;
+    boost::condition_variable writtenCondition;
+    std::deque<Chunk> queue;
+    std::size_t pendingBytes;
+    bool writing;
+    boost::thread writer;
+};
+}
 
 void printTime(boost::chrono::system_clock::time_point t)
 {
@@ -93,27 +193,41 @@ boost::chrono::system_clock::time_point sim_mob::Profiler::getTime()
 }
 
 
-sim_mob::Sentry::Sentry(BasicLogger & basicLogger_,std::stringstream *out_):out(*out_),basicLogger(basicLogger_),copy(false){};
-sim_mob::Sentry::Sentry(const Sentry& t):basicLogger(t.basicLogger), out(t.out),copy(true){}
+sim_mob::Sentry::Sentry(BasicLogger & basicLogger_,LogBuffer &buffer_):buffer(buffer_),basicLogger(basicLogger_)
+{
+    //the buffer is locked from the first to the last Sentry of a statement so that a flush never splits a line
+    if (buffer.depth++ == 0)
+    {
+        buffer.mtx.lock();
+    }
+}
+
+sim_mob::Sentry::Sentry(const Sentry& t):buffer(t.buffer),basicLogger(t.basicLogger)
+{
+    ++buffer.depth;
+}
 
 sim_mob::Sentry& sim_mob::Sentry::operator<<(StandardEndLine manip)
 {
-    manip(out);
+    manip(buffer.out);
     return *this;
 }
 
 
 sim_mob::Sentry::~Sentry()
 {
-    //if the buffer size has reached its limit, dump it to the file otherwise leave it to accumulate.
-    // by some googling this estimated hard-code value promises less cycles to write to a file
-    if(out.tellp() > 512000/*500KB*/ && copy)
+    if (--buffer.depth == 0)
     {
-        basicLogger.flushLog(out);
+        //if the buffer size has reached its limit, dump it to the file otherwise leave it to accumulate.
+        if(buffer.out.tellp() > BUFFER_FLUSH_SIZE)
+        {
+            basicLogger.flushLog(buffer);
+        }
+        buffer.mtx.unlock();
     }
 }
 
-sim_mob::BasicLogger::BasicLogger(std::string id_){
+sim_mob::BasicLogger::BasicLogger(std::string id_) : index(nextLoggerIndex++), buffers(nullptr){
     id = id_;
     if(!id_.empty()){
         //simple check to see if the id can be used like a file name with a 3 letter extension, else append .txt
@@ -141,33 +255,31 @@ sim_mob::BasicLogger::~BasicLogger(){
     if (logFile.is_open()) {
         logFile.close();
     }
-    for (outIt it(out.begin()); it != out.end();safe_delete_item(it->second), it++);
+    for (LogBuffer* buffer = buffers.load(); buffer; )
+    {
+        LogBuffer* next = buffer->next;
+        safe_delete_item(buffer);
+        buffer = next;
+    }
 }
 
-std::stringstream * sim_mob::BasicLogger::getOut(bool renew){
-    boost::upgrade_lock<boost::shared_mutex> lock(mutexOutput);
-    std::stringstream *res = nullptr;
-    outIt it;
-    boost::thread::id id = boost::this_thread::get_id();
-    if((it = out.find(id)) == out.end()){
-        boost::upgrade_to_unique_lock<boost::shared_mutex> lock2(lock);
-        res = new std::stringstream();
-        out.insert(std::make_pair(id, res));
-        if(this->id == std::string("realtime_travel_time"))
-        {
-            std::cout << "realtime_travel_time buffer new size = " << out.size() << std::endl;
-        }
+sim_mob::LogBuffer& sim_mob::BasicLogger::getBuffer(){
+    if (index < localBuffers.size() && localBuffers[index])
+    {
+        return *localBuffers[index];
     }
-    else
+
+    //first write of this thread to this logger: register a new buffer
+    LogBuffer* buffer = new LogBuffer();
+    buffer->next = buffers.load(boost::memory_order_relaxed);
+    while (!buffers.compare_exchange_weak(buffer->next, buffer, boost::memory_order_release, boost::memory_order_relaxed));
+
+    if (index >= localBuffers.size())
     {
-        boost::upgrade_to_unique_lock<boost::shared_mutex> lock2(lock);
-        res = it->second;
-        if (renew)
-        {
-            res = it->second = new std::stringstream();         
-        }
+        localBuffers.resize(index + 1, nullptr);
     }
-    return res;
+    localBuffers[index] = buffer;
+    return *buffer;
 }
 
 sim_mob::Profiler & sim_mob::BasicLogger::prof(const std::string id, bool timer)
@@ -185,25 +297,18 @@ sim_mob::Profiler & sim_mob::BasicLogger::prof(const std::string id, bool timer)
     return it->second;
 }
 
-//void printTime(struct tm *tm, struct timeval & tv, std::string id){
-//  sim_mob::Print() << "TIMESTAMP:\t  " << tm->tm_hour << std::setw(2) << ":" <<tm->tm_min << ":" << ":" <<  tm->tm_sec << ":" << tv.tv_usec << std::endl;
-//}
-
 void  sim_mob::BasicLogger::initLogFile(const std::string& path)
 {
     logFile.open(path.c_str());
 }
 
-void sim_mob::BasicLogger::flushLog(std::stringstream &out)
+void sim_mob::BasicLogger::flushLog(LogBuffer &buffer)
 {
     if ((logFile.is_open() && logFile.good()))
     {
-        {
-            boost::unique_lock<boost::mutex> lock(flushMutex);
-            logFile << out.str();
-            logFile.flush();
-        }
-            out.str(std::string());
+        std::string data = buffer.out.str();
+        buffer.out.str(std::string());
+        LogWriter::getInstance().write(logFile, data);
     }
     else
     {
@@ -211,66 +316,19 @@ void sim_mob::BasicLogger::flushLog(std::stringstream &out)
     }
 }
 
-/* *****************************
- *     Queued Implementation
- * *****************************
- */
-
-sim_mob::QueuedLogger::QueuedLogger(std::string id_):BasicLogger(id_) ,logQueue(128),logDone(false)
-{
-    flusher.reset(new boost::thread(boost::bind(&QueuedLogger::flushToFile,this)));
-}
-sim_mob::QueuedLogger::~QueuedLogger()
-{
-    logDone = true;
-    if(flusher){
-        flusher->join();
-    }
-}
-
-void sim_mob::QueuedLogger::flushToFile()
-{
-    std::stringstream * buffer;
-    while (!logDone)
-    {
-        while (logQueue.pop(buffer)){
-
-            // std::cout << "poped out  " << buffer << "  to Q" << std::endl;
-            if(buffer){
-                buffer->str();
-                logFile << buffer->str();
-                logFile.flush();
-                safe_delete_item(buffer);
-            }
-        }
-        boost::this_thread::sleep(boost::posix_time::milliseconds{static_cast<long>(500)});
-    }
-    //same thing as above , just to clear the queue after logFileCnt is set to true
-    while (logQueue.pop(buffer)){
-        if(buffer){
-            logFile << buffer->str();
-            logFile.flush();
-            safe_delete_item(buffer);
-        }
-    }
-}
-
-void sim_mob::QueuedLogger::flushLog()
-{
-    std::stringstream *out = getOut(true);
-    logQueue.push(out);
-}
-
-
 void sim_mob::BasicLogger::flush()
 {
     if (logFile.is_open())
     {
-        outIt it = out.begin();
-        for(; it!= out.end(); it++)
+        for (LogBuffer* buffer = buffers.load(boost::memory_order_acquire); buffer; buffer = buffer->next)
         {
-            flushLog(*(it->second));
+            boost::unique_lock<boost::mutex> lock(buffer->mtx);
+            if (buffer->out.tellp() > 0)
+            {
+                flushLog(*buffer);
+            }
         }
+        LogWriter::getInstance().waitUntilWritten();
     }
 }
 
@@ -281,20 +339,39 @@ void sim_mob::BasicLogger::flush()
 sim_mob::Logger::~Logger()
 {
     typedef std::map<std::string, boost::shared_ptr<sim_mob::BasicLogger> >::value_type Pair;
-    BOOST_FOREACH(Pair&item,repo)
+    for (std::size_t i = 0; i < NUM_SHARDS; i++)
     {
-        item.second.reset();
+        BOOST_FOREACH(Pair&item,shards[i].repo)
+        {
+            item.second.reset();
+        }
+        shards[i].repo.clear();
     }
-    repo.clear();
 }
+
 sim_mob::BasicLogger & sim_mob::Logger::operator()(const std::string &key)
 {
-    std::map<std::string, boost::shared_ptr<sim_mob::BasicLogger> >::iterator it = repo.find(key);
-    if(it == repo.end()){
-        boost::shared_ptr<sim_mob::BasicLogger> t(new sim_mob::LogEngine(key));
-        repo.insert(std::make_pair(key,t));
+    Shard& shard = shards[boost::hash<std::string>()(key) % NUM_SHARDS];
+    boost::unique_lock<boost::mutex> lock(shard.mtx);
+    std::map<std::string, boost::shared_ptr<sim_mob::BasicLogger> >::iterator it = shard.repo.find(key);
+    if(it == shard.repo.end()){
+        boost::shared_ptr<sim_mob::BasicLogger> t(new sim_mob::BasicLogger(key));
+        shard.repo.insert(std::make_pair(key,t));
         return *t;
     }
     return *it->second;
 }
 
+sim_mob::BasicLogger & sim_mob::Logger::log(const std::string &key)
+{
+    boost::unordered_map<std::string, sim_mob::BasicLogger*>::const_iterator it = localLoggers.find(key);
+    if (it != localLoggers.end())
+    {
+        return *it->second;
+    }
+
+    static sim_mob::Logger instance;
+    sim_mob::BasicLogger& logger = instance(key);
+    localLoggers[key] = &logger;
+    return logger;
+}
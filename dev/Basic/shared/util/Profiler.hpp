@@ -2,8 +2,9 @@
 #include <stdint.h>
 #include <fstream>
 #include <boost/thread.hpp>
-#include <boost/lockfree/queue.hpp>
 #include <boost/atomic.hpp>
+#include <map>
+#include <sstream>
 namespace sim_mob {
 /**
  * Authore: Vahid
@@ -20,19 +21,11 @@ namespace sim_mob {
     std::stringstream  s;
     sim_mob::Logger::log[prof] << s.str();
 
- * Some implementation Details on the lockfree version
- * this class accepts buffers of data submitted to it via different threads and pushes them into
- * a circular (lock free) queue to be dumped into the destination file.
- * A thread is waiting for the other side of the queue waiting for the buffers to arrive(pop) and dump the
- * buffers into their corresponding file. This way we can achieve:
- * 1- A separate thread doing IO without holding up other threads.
- * 2- Circular queue does not require locking when pushing into the queue.
- * 3- If the need be, there can be multiple threads poping out of the queue. boost::lockfree::queue implementation is multi-producer/multi-consumer version.
- * 4- Needless to mention that the Logger handles one buffer per thread rather than using one buffer, therefore there is no locking(ecxcept for minimal
- * thread management)
- *
- * Note:Alternative approach:
- * Instead of having a queue handling buffers and files, there is an alternative approach to create one file per thread and join the file whenever required.
+ * Some implementation Details
+ * Each thread appends to its own buffer of each logger, so logging statements from different threads do not contend.
+ * Full buffers are passed to a single writer thread which does all the file IO without holding up other threads.
+ * The amount of data waiting for the writer is bounded; if it is exceeded, logging threads wait until the writer catches up.
+ * Callers which log often should keep the BasicLogger reference returned by Logger::log instead of looking it up per line.
  */
 
 /**********************************
@@ -95,16 +88,33 @@ public:
 
 
 class BasicLogger;
+
+/// buffer of one thread writing to a BasicLogger
+struct LogBuffer
+{
+    LogBuffer() : depth(0), next(nullptr) {}
+
+    /// held by the owning thread for the duration of a logging statement, and by flushes
+    boost::mutex mtx;
+
+    /// text logged by the owning thread and not yet handed over to the writer
+    std::stringstream out;
+
+    /// number of live Sentry objects of the owning thread
+    unsigned int depth;
+
+    /// next buffer registered with the same logger
+    LogBuffer* next;
+};
+
 /// Sentry class objects are created at each line and are destryped upon when the statement ends(";")
 /// this will allow grouping of multiple << operators without worrying about multithreading issues.
 class Sentry
 {
-    std::stringstream &out;
+    LogBuffer &buffer;
     BasicLogger &basicLogger;
-    /// is this object created by copy constructor?
-    bool copy;
     public:
-    Sentry(BasicLogger & basicLogger_,std::stringstream *out_);
+    Sentry(BasicLogger & basicLogger_,LogBuffer &buffer_);
     Sentry(const Sentry& t);
 
     //This is the type of std::cout
@@ -119,7 +129,7 @@ class Sentry
     template <typename T>
     Sentry & operator<< (const T& val)
     {
-        out << val;
+        buffer.out << val;
         return *this;
     }
     ~Sentry();
@@ -128,49 +138,41 @@ class Sentry
 /**********************************
  ******* Basic Logging Engine******
  *********************************/
+/**
+ * Each thread logs into its own LogBuffer, found through a thread-local table indexed by the logger's index.
+ * Buffers are registered in a lock-free list on first use. When a buffer grows past a threshold, or when the
+ * logger is flushed, its content is handed over to a single background writer thread which owns all file writes.
+ * The writer accepts a bounded amount of pending data; beyond it, logging threads wait for the writer.
+ */
 class BasicLogger {
 private:
 
-//  ///total time measured by all profilers
-//  uint64_t totalTime;
-
-    /// used for index
-    boost::mutex flushMutex;
-
-    /// used for output stream
-    boost::shared_mutex mutexOutput;
-
     /// the mandatory id given to this BasicLogger
     std::string id;
 
+    /// dense index of this logger in the thread-local buffer tables
+    unsigned int index;
+
     /// profilers container
     std::map<const std::string, Profiler> profilers;
 
-    /// one buffer is assigned to each thread writing to the file
-    std::map<boost::thread::id, std::stringstream*> out;
-
+    /// head of the list of buffers of all threads which wrote to this logger
+    boost::atomic<LogBuffer*> buffers;
 
 protected:
 
-    /// easy reading
-    typedef std::map<boost::thread::id, std::stringstream*>::iterator outIt;
-
     /**
      * return the buffer corresponding to the calling thread.If the buffer doesn't exist, this method will create, register and returns a new buffer.
-     * \param renew should the buffer be replaced with a new one
      */
-    std::stringstream * getOut(bool renew= false);
-
-    /// print time in HH:MM::SS::uS todo:needs improvement
-    static void printTime(struct tm *tm, struct timeval & tv, std::string id);
+    LogBuffer& getBuffer();
 
     void initLogFile(const std::string& path);
 
     ///logger
     std::ofstream logFile;
 
-    /// flush the the given log buffer into the output buffer-Default version
-    virtual void flushLog(std::stringstream &out);
+    /// hand the content of the given log buffer over to the writer. the buffer's mutex must be held by the caller
+    virtual void flushLog(LogBuffer &buffer);
 
 public:
     /**
@@ -181,7 +183,7 @@ public:
     /// copy constructor
     BasicLogger(const sim_mob::BasicLogger& value);
 
-    /// flush all buffers to the corresponding file
+    /// flush all buffers to the corresponding file. returns once the data is written
     virtual void flush();
 
     /// destructor
@@ -210,48 +212,18 @@ public:
 
     /// operator overload for std::endl(just if someone starts as std::endl as the first input to << operator)
     Sentry operator<<(StandardEndLine manip) {
-        std::stringstream *out = getOut();
-        manip(*out);
-        return Sentry(*this,out);
+        return (Sentry(*this, getBuffer()) << manip);
     }
 
     /// operator overload.  write the log items to buffer
     template <typename T>
     Sentry operator<< (const T& val)
     {
-        std::stringstream *out = getOut();
-        //std::cout << "assigning " << val << " to sentry with out=" << out << std::endl ;
-        return (Sentry(*this,out)<< val);
+        return (Sentry(*this, getBuffer()) << val);
     }
-    //for debugging purpose only
-    static std::map <boost::thread::id, int> threads;
-    static unsigned long int ii;
-    static int flushCnt;
-    int dbgOutCnt(){ return out.size();}
     friend class Sentry;
 };
 
-/**********************************
- ******* Queued Logging Engine*****
- **********************************/
-class QueuedLogger :public BasicLogger
-{
-    /// queued buffer
-    typedef boost::lockfree::queue<std::stringstream *> LockFreeQ;
-    LockFreeQ logQueue;
-    /// indicates if all the loggerq objects have died and it is time for the flusher thread to join
-    boost::atomic<bool> logDone;
-    /// logQueue's consumer thread
-    boost::shared_ptr<boost::thread> flusher;
-public:
-    QueuedLogger(std::string id);
-    ~QueuedLogger();
-    /// flush the log streams into the output buffer-Default version
-    void flushLog();
-    /// flush the file into the file from the queue
-    void flushToFile();
-};
-
 
 /**********************************
  ******* Logging Wrapper **********
@@ -259,27 +231,30 @@ public:
 class Logger {
 
 protected:
-    /// repository of profilers. each profiler is distinguished by a file name!
-    std::map<const std::string, boost::shared_ptr<sim_mob::BasicLogger> > repo;
+    /// number of independently locked parts of the repository
+    static const std::size_t NUM_SHARDS = 16;
+
+    struct Shard
+    {
+        boost::mutex mtx;
+
+        /// repository of profilers. each profiler is distinguished by a file name!
+        std::map<const std::string, boost::shared_ptr<sim_mob::BasicLogger> > repo;
+    };
+
+    Shard shards[NUM_SHARDS];
+
+    /// finds or creates the logger of the given key
     virtual sim_mob::BasicLogger & operator()(const std::string &key);
 
-    static boost::shared_mutex instanceMutex;
 public:
-    static sim_mob::BasicLogger &log(const std::string &key){
-        static boost::shared_ptr<sim_mob::Logger> log_;
-        boost::unique_lock<boost::shared_mutex> lock(instanceMutex);
-        if (!log_) {
-            log_.reset(new Logger());
-        }
-        return (*log_)(key);
-    }
+    /**
+     * gets the logger writing to the file named key.
+     * Loggers live until the end of the program, so the returned reference can be resolved once and kept by hot callers.
+     * Repeated calls from the same thread are served from a thread-local cache without locking.
+     */
+    static sim_mob::BasicLogger &log(const std::string &key);
+
     virtual ~Logger();
 };
-/*************************************************************************
- * Change the value of this typedef to enable the selected Logging module
- * Currently available modules are:
- * BasicLogger
- * QueuedLogger
- **************************************************************************/
-typedef BasicLogger LogEngine;
 }//namespace
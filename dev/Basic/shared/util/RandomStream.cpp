@@ -0,0 +1,107 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "RandomStream.hpp"
+
+#include "conf/ConfigManager.hpp"
+#include "conf/ConfigParams.hpp"
+
+using namespace sim_mob;
+
+namespace
+{
+const uint32_t PHILOX_M0 = 0xD2511F53u;
+const uint32_t PHILOX_M1 = 0xCD9E8D57u;
+const uint32_t PHILOX_W0 = 0x9E3779B9u;
+const uint32_t PHILOX_W1 = 0xBB67AE85u;
+const unsigned int PHILOX_ROUNDS = 10;
+
+inline void mulhilo(uint32_t a, uint32_t b, uint32_t& hi, uint32_t& lo)
+{
+	uint64_t product = (uint64_t) a * b;
+	hi = (uint32_t) (product >> 32);
+	lo = (uint32_t) product;
+}
+
+///splitmix64 finaliser, used to spread seed and purpose over the whole key
+inline uint64_t mix64(uint64_t value)
+{
+	value += 0x9E3779B97F4A7C15ull;
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+	return value ^ (value >> 31);
+}
+}
+
+sim_mob::RandomStream::RandomStream(uint64_t seed, uint64_t entityId, uint32_t tick, uint32_t purpose) : blockPos(4)
+{
+	uint64_t streamKey = mix64(seed ^ mix64(purpose));
+	key[0] = (uint32_t) streamKey;
+	key[1] = (uint32_t) (streamKey >> 32);
+
+	counter[0] = 0;
+	counter[1] = tick;
+	counter[2] = (uint32_t) entityId;
+	counter[3] = (uint32_t) (entityId >> 32);
+}
+
+RandomStream sim_mob::RandomStream::forEntity(uint64_t entityId, uint32_t tick, uint32_t purpose)
+{
+	return RandomStream(ConfigManager::GetInstance().FullConfig().simulation.seedValue, entityId, tick, purpose);
+}
+
+void sim_mob::RandomStream::philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t output[4])
+{
+	uint32_t ctr[4] = { counter[0], counter[1], counter[2], counter[3] };
+	uint32_t k0 = key[0];
+	uint32_t k1 = key[1];
+
+	for (unsigned int round = 0; round < PHILOX_ROUNDS; round++)
+	{
+		uint32_t hi0, lo0, hi1, lo1;
+		mulhilo(PHILOX_M0, ctr[0], hi0, lo0);
+		mulhilo(PHILOX_M1, ctr[2], hi1, lo1);
+
+		ctr[0] = hi1 ^ ctr[1] ^ k0;
+		ctr[1] = lo1;
+		ctr[2] = hi0 ^ ctr[3] ^ k1;
+		ctr[3] = lo0;
+
+		k0 += PHILOX_W0;
+		k1 += PHILOX_W1;
+	}
+
+	for (unsigned int i = 0; i < 4; i++)
+	{
+		output[i] = ctr[i];
+	}
+}
+
+RandomStream::result_type sim_mob::RandomStream::operator()()
+{
+	if (blockPos >= 4)
+	{
+		philox4x32(counter, key, block);
+		counter[0]++;
+		blockPos = 0;
+	}
+	return block[blockPos++];
+}
+
+double sim_mob::RandomStream::uniform()
+{
+	return (*this)() * (1.0 / 4294967296.0);
+}
+
+uint32_t sim_mob::RandomStream::uniformInt(uint32_t bound)
+{
+	//reject the lowest (2^32 mod bound) values so that every result is equally likely
+	uint32_t threshold = (0u - bound) % bound;
+	uint32_t value;
+	do
+	{
+		value = (*this)();
+	} while (value < threshold);
+	return value % bound;
+}
@@ -0,0 +1,102 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <stdint.h>
+
+namespace sim_mob
+{
+
+/**
+ * Counter-based random number stream (Philox4x32-10).
+ *
+ * A stream is fully defined by (seed, entity id, tick, purpose): the n-th number
+ * of a stream is a pure function of these values and n. Streams need no shared
+ * state, so draws are reproducible whatever the number of workers or the worker
+ * an entity is assigned to, and different entities never contend on a lock.
+ *
+ * Create a stream on the stack where the random decision is made, e.g.
+ *     RandomStream rng = RandomStream::forEntity(agentId, now.frame(), RandomStream::TOP_C_MERGE);
+ *     size_t idx = rng.uniformInt(candidates.size());
+ *
+ * The class models a uniform random number generator, so it can also be passed to
+ * boost/std distributions.
+ */
+class RandomStream
+{
+public:
+    /**
+     * Decisions drawing from independent streams for the same entity and tick.
+     * Append new values at the end to keep the existing streams unchanged.
+     */
+    enum Purpose
+    {
+        GENERIC = 0,
+        TOP_C_MERGE,
+        HOUSING_CHOICESET
+    };
+
+    typedef uint32_t result_type;
+
+    /**
+     * @param seed global seed of the run
+     * @param entityId id of the agent or subsystem drawing the numbers
+     * @param tick time tick (or day) of the draws
+     * @param purpose decision the numbers are used for
+     */
+    RandomStream(uint64_t seed, uint64_t entityId, uint32_t tick, uint32_t purpose);
+
+    /**
+     * Creates a stream keyed with the seed of the simulation configuration (simulation.seedValue).
+     */
+    static RandomStream forEntity(uint64_t entityId, uint32_t tick, uint32_t purpose);
+
+    /**
+     * @return next 32-bit number of the stream
+     */
+    result_type operator()();
+
+    /**
+     * @return uniform number in [0,1)
+     */
+    double uniform();
+
+    /**
+     * @param bound exclusive upper bound; must be positive
+     * @return uniform integer in [0,bound), without modulo bias
+     */
+    uint32_t uniformInt(uint32_t bound);
+
+    static result_type min()
+    {
+        return 0;
+    }
+
+    static result_type max()
+    {
+        return 0xFFFFFFFFu;
+    }
+
+    /**
+     * Philox4x32 with 10 rounds.
+     * @param counter 128-bit counter
+     * @param key 64-bit key
+     * @param output 128-bit output block
+     */
+    static void philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t output[4]);
+
+private:
+    uint32_t key[2];
+
+    /** counter[0] is the block index within the stream; the other words hold the tick and entity id */
+    uint32_t counter[4];
+
+    uint32_t block[4];
+
+    /** next unused word of block; 4 when the block is exhausted */
+    unsigned int blockPos;
+};
+
+}
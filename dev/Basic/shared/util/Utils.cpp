@@ -45,14 +45,11 @@ float Utils::generateFloat(float min, float max) {
     if (min == max){
         return min;
     }
-//    initRandomProvider(floatProvider);
-    typedef boost::mt19937 RNGType;
-          RNGType rng(time(0));
+    initRandomProvider(floatProvider);
     boost::uniform_real<float> distribution(min, max);
-    boost::variate_generator<boost::mt19937&, boost::uniform_real<float> > 
-        dice(rng,distribution);
-//        gen(*(floatProvider.get()), distribution);
-    return dice();
+    boost::variate_generator<boost::mt19937&, boost::uniform_real<float> >
+        gen(*(floatProvider.get()), distribution);
+    return gen();
 }
 
 int Utils::generateInt(int min, int max) {
@@ -30,6 +30,9 @@ namespace sim_mob {
 
         /**
          * Generates a new float value.
+         * Drawn from a per-thread Mersenne twister seeded with the configured seed value, like generateInt(), so
+         * the values are reproducible for a given seed and assignment of agents to workers. Every thread is seeded
+         * with the same value, so all the threads draw the same sequence.
          * @param min minimum limit.
          * @param max maximum limit.
          * @return the generated value. 
@@ -0,0 +1,268 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <typeinfo>
+#include <vector>
+#include <boost/iterator/filter_iterator.hpp>
+
+namespace sim_mob
+{
+
+class Entity;
+
+/**
+ * Contiguous storage for the entities managed by one Worker.
+ *
+ * Entities are kept in a vector and each entity records its own position (its "slot") in the list which
+ * currently holds it, so membership tests and removals do not search. An entity can belong to one list at a time,
+ * which matches the one-worker-per-entity rule; migrating to another worker simply gives it a new slot.
+ *
+ * Iteration order depends on the ordering:
+ *  - ORDER_NONE: removal swaps the last entity into the freed slot. Insertion and removal are O(1) and the
+ *    iteration order depends on the history of additions and removals.
+ *  - ORDER_ID: entities are iterated by increasing id, making runs reproducible whatever the order in which
+ *    agents were dispatched. Removals leave a hole and insertions are appended; both are folded back into
+ *    order by prepare(), in a single merge pass.
+ *  - ORDER_TYPE: as ORDER_ID, but entities of the same dynamic type are grouped together first,
+ *    so that consecutive updates run the same code.
+ *
+ * T must provide getId() and a "workerSlot" member of type unsigned int accessible to this class.
+ */
+template <typename T>
+class BasicEntityList
+{
+public:
+    enum Ordering
+    {
+        ORDER_NONE,
+        ORDER_ID,
+        ORDER_TYPE
+    };
+
+    /** slot of an entity which is not in any list */
+    static const unsigned int NO_SLOT = std::numeric_limits<unsigned int>::max();
+
+private:
+    struct NotRemoved
+    {
+        bool operator()(const T* entity) const
+        {
+            return entity != nullptr;
+        }
+    };
+
+public:
+    typedef boost::filter_iterator<NotRemoved, typename std::vector<T*>::const_iterator> const_iterator;
+
+    explicit BasicEntityList(Ordering ordering = ORDER_NONE) :
+            ordering(ordering), sortedCount(0), numRemoved(0)
+    {
+    }
+
+    Ordering getOrdering() const
+    {
+        return ordering;
+    }
+
+    /**
+     * Changes the ordering. The new order applies from the next call to prepare().
+     */
+    void setOrdering(Ordering order)
+    {
+        if (numRemoved > 0)
+        {
+            entities.erase(std::remove(entities.begin(), entities.end(), static_cast<T*>(nullptr)), entities.end());
+            numRemoved = 0;
+            updateSlots();
+        }
+        ordering = order;
+        sortedCount = 0;
+    }
+
+    /**
+     * Adds an entity
+     * @return false if the entity was already in the list
+     */
+    bool insert(T* entity)
+    {
+        if (contains(entity))
+        {
+            return false;
+        }
+        entity->workerSlot = entities.size();
+        entities.push_back(entity);
+        return true;
+    }
+
+    /**
+     * Removes an entity
+     * @return false if the entity was not in the list
+     */
+    bool erase(T* entity)
+    {
+        if (!contains(entity))
+        {
+            return false;
+        }
+
+        unsigned int slot = entity->workerSlot;
+        entity->workerSlot = NO_SLOT;
+
+        if (slot + 1 == entities.size())
+        {
+            entities.pop_back();
+            //holes are only left in the ordered part, and the list never ends with one
+            while (!entities.empty() && entities.back() == nullptr)
+            {
+                entities.pop_back();
+                --numRemoved;
+            }
+        }
+        else if (ordering == ORDER_NONE || slot >= sortedCount)
+        {
+            //unordered part of the list; the last entity takes the freed slot
+            T* last = entities.back();
+            entities[slot] = last;
+            last->workerSlot = slot;
+            entities.pop_back();
+        }
+        else
+        {
+            //ordered part; leave a hole so that the order is kept
+            entities[slot] = nullptr;
+            ++numRemoved;
+        }
+
+        if (sortedCount > entities.size())
+        {
+            sortedCount = entities.size();
+        }
+        return true;
+    }
+
+    bool contains(const T* entity) const
+    {
+        return entity->workerSlot < entities.size() && entities[entity->workerSlot] == entity;
+    }
+
+    /**
+     * Restores the configured order, after entities were added or removed. Does nothing for ORDER_NONE.
+     * Must not be called while the list is being iterated.
+     */
+    void prepare()
+    {
+        if (ordering == ORDER_NONE || (numRemoved == 0 && sortedCount == entities.size()))
+        {
+            return;
+        }
+
+        typename std::vector<T*>::iterator sortedEnd = entities.begin() + sortedCount;
+        if (numRemoved > 0)
+        {
+            sortedEnd = std::remove(entities.begin(), sortedEnd, static_cast<T*>(nullptr));
+            sortedEnd = std::copy(entities.begin() + sortedCount, entities.end(), sortedEnd);
+            entities.erase(sortedEnd, entities.end());
+            sortedEnd = entities.begin() + (sortedCount - numRemoved);
+        }
+
+        Compare compare(ordering);
+        std::sort(sortedEnd, entities.end(), compare);
+        std::inplace_merge(entities.begin(), sortedEnd, entities.end(), compare);
+
+        updateSlots();
+        sortedCount = entities.size();
+        numRemoved = 0;
+    }
+
+    std::size_t size() const
+    {
+        return entities.size() - numRemoved;
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /**
+     * @return the entity in the highest slot. Removing it never leaves a hole.
+     */
+    T* back() const
+    {
+        return entities.back();
+    }
+
+    /**
+     * Iteration skips removed entities. The order is the configured one only if prepare() was called after
+     * the last change.
+     */
+    const_iterator begin() const
+    {
+        return const_iterator(entities.begin(), entities.end());
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(entities.end(), entities.end());
+    }
+
+private:
+    void updateSlots()
+    {
+        for (unsigned int i = 0; i < entities.size(); ++i)
+        {
+            entities[i]->workerSlot = i;
+        }
+    }
+
+    struct Compare
+    {
+        explicit Compare(Ordering ordering) : byType(ordering == ORDER_TYPE)
+        {
+        }
+
+        bool operator()(const T* lhs, const T* rhs) const
+        {
+            if (byType)
+            {
+                const char* lhsType = typeid(*lhs).name();
+                const char* rhsType = typeid(*rhs).name();
+                if (lhsType != rhsType)
+                {
+                    int res = std::strcmp(lhsType, rhsType);
+                    if (res != 0)
+                    {
+                        return res < 0;
+                    }
+                }
+            }
+            return lhs->getId() < rhs->getId();
+        }
+
+        bool byType;
+    };
+
+    Ordering ordering;
+
+    /**entities, and holes left by removals from the ordered part*/
+    std::vector<T*> entities;
+
+    /**length of the ordered prefix of entities; entities after it were added since the last prepare()*/
+    std::size_t sortedCount;
+
+    /**number of holes in the ordered prefix*/
+    std::size_t numRemoved;
+};
+
+template <typename T>
+const unsigned int BasicEntityList<T>::NO_SLOT;
+
+typedef BasicEntityList<Entity> EntityList;
+
+}
@@ -14,6 +14,7 @@
 #include "conf/ConfigManager.hpp"
 #include "conf/ConfigParams.hpp"
 #include "entities/Agent.hpp"
+#include "entities/AgentRegistry.hpp"
 #include "entities/AuraManager.hpp"
 #include "entities/misc/BusTrip.hpp"
 #include "entities/misc/TripChain.hpp"
@@ -153,6 +154,8 @@ void sim_mob::WorkGroup::initWorkers(EntityLoadParams* loader)
         std::vector<Entity*>* entBredPerWorker = &entToBeBredPerWorker.at(i);
 
         workers.push_back(new Worker(this, logFile, frame_tick_barr, buff_flip_barr, msg_bus_barr, macro_tick_barr, entWorker, entBredPerWorker, numSimTicks, tickStep,simulationStart));
+        workers.back()->workGroupNum = wgNum;
+        workers.back()->workerIndex = i;
     }
 }
 
@@ -277,11 +280,12 @@ void sim_mob::WorkGroup::collectRemovedEntities(std::set<sim_mob::Entity*>* remo
                 parent->unregisterChild((*it));
             }
 
-            //If this Entity is an Agent, save its memory address.
-            if (removedAgents)
+            //If this Entity is an Agent, take it off the registry's views and save its memory address.
+            Agent* ag = dynamic_cast<Agent*>(*it);
+            if (ag)
             {
-                Agent* ag = dynamic_cast<Agent*>(*it);
-                if (ag)
+                AgentRegistry::getInstance().removeAgent(ag);
+                if (removedAgents)
                 {
                     removedAgents->insert(ag);
                     continue;
@@ -299,11 +303,15 @@ void sim_mob::WorkGroup::collectRemovedEntities(std::set<sim_mob::Entity*>* remo
 
 void sim_mob::WorkGroup::assignAWorker(Entity* ag)
 {
-    if (ConfigManager::GetInstance().FullConfig().RunningShortTerm())
+    //This is the one place where an Entity's type is checked; from here on, it is listed in the registry's views.
+    Agent* an_agent = dynamic_cast<Agent*>(ag);
+    if (an_agent)
     {
+        const bool spatial = !an_agent->isNonspatial();
+        AgentRegistry::getInstance().addAgent(an_agent, spatial);
+
         //Let the AuraManager know about this Entity.
-        Agent* an_agent = dynamic_cast<Agent*>(ag);
-        if (an_agent && !an_agent->isNonspatial())
+        if (spatial && ConfigManager::GetInstance().FullConfig().RunningShortTerm())
         {
             AuraManager::instance().registerNewAgent(an_agent);
         }
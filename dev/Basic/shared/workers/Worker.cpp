@@ -49,6 +49,13 @@ UpdateEventArgs::~UpdateEventArgs(){};
 
 UpdatePublisher  Worker::updatePublisher;
 
+namespace
+{
+//The Worker whose thread_function_loop runs on the current thread. Workers are owned by their WorkGroup.
+void keepWorker(Worker*) {}
+boost::thread_specific_ptr<Worker> currentWorker(keepWorker);
+}
+
 sim_mob::Worker::MgmtParams::MgmtParams() :
     msPerFrame(ConfigManager::GetInstance().FullConfig().baseGranMS()),
     ctrlMgr(ConfigManager::GetInstance().CMakeConfig().InteractiveMode()?ConfigManager::GetInstance().FullConfig().getControlMgr():nullptr),
@@ -68,7 +75,8 @@ sim_mob::Worker::Worker(WorkGroup* parent, std::ostream* logFile,  FlexiBarrier*
                         std::vector<Entity*>* entityRemovalList, std::vector<Entity*>* entityBredList, uint32_t endTick, uint32_t tickStep, uint32_t _simulationStartDay)
                        :logFile(logFile), frame_tick_barr(frame_tick), buff_flip_barr(buff_flip), aura_mgr_barr(aura_mgr), macro_tick_barr(macro_tick),
                         endTick(endTick), tickStep(tickStep), parent(parent), entityRemovalList(entityRemovalList), entityBredList(entityBredList),
-                        profile(nullptr),pathSetMgr(nullptr), simulationStartDay(_simulationStartDay)
+                        profile(nullptr),pathSetMgr(nullptr), simulationStartDay(_simulationStartDay), workGroupNum(0), workerIndex(0),
+                        managedEntities(ConfigManager::GetInstance().FullConfig().simulation.entityOrdering)
 {
     //Initialize our profile builder, if applicable.
     if (ConfigManager::GetInstance().CMakeConfig().ProfileWorkerUpdates()) {
@@ -76,14 +84,13 @@ sim_mob::Worker::Worker(WorkGroup* parent, std::ostream* logFile,  FlexiBarrier*
     }
     //thread_id = auto_matical_thread_id;
     //auto_matical_thread_id++;
-    srand(std::time(0));
 }
 
 sim_mob::Worker::~Worker()
 {
     //Clear all tracked entitites
-    while (managedEntities.begin() != managedEntities.end()) {
-        remEntity(*managedEntities.begin());
+    while (!managedEntities.empty()) {
+        remEntity(managedEntities.back());
     }
     /*while (!managedEntities.empty()) {
         remEntity(managedEntities.front());
@@ -100,12 +107,18 @@ sim_mob::Worker::~Worker()
 }
 
 
+namespace {
+bool lessEntityId(const Entity* lhs, const Entity* rhs)
+{
+    return lhs->getId() < rhs->getId();
+}
+}
+
 void sim_mob::Worker::addEntity(Entity* entity)
 {
-    managedEntities.insert(entity);
-    if(entity->isMultiUpdate())
+    if(managedEntities.insert(entity) && entity->isMultiUpdate())
     {
-        managedMultiUpdateEntities.insert(entity);
+        managedMultiUpdateEntities.insert(std::upper_bound(managedMultiUpdateEntities.begin(), managedMultiUpdateEntities.end(), entity, lessEntityId), entity);
     }
 }
 
@@ -113,14 +126,10 @@ void sim_mob::Worker::addEntity(Entity* entity)
 void sim_mob::Worker::remEntity(Entity* entity)
 {
     //Remove this entity from the data vector.
-    std::set<Entity*>::iterator it = managedEntities.find(entity);
-    if (it != managedEntities.end())
-    {
-        managedEntities.erase(it);
-    }
+    managedEntities.erase(entity);
     if (entity->isMultiUpdate())
     {
-        std::set<Entity*>::iterator it = managedMultiUpdateEntities.find(entity);
+        std::vector<Entity*>::iterator it = std::find(managedMultiUpdateEntities.begin(), managedMultiUpdateEntities.end(), entity);
         if (it != managedMultiUpdateEntities.end())
         {
             managedMultiUpdateEntities.erase(it);
@@ -133,7 +142,7 @@ UpdatePublisher & sim_mob::Worker::GetUpdatePublisher()
     return updatePublisher;
 }
 
-const std::set<Entity*>& sim_mob::Worker::getEntities() const
+const EntityList& sim_mob::Worker::getEntities() const
 {
     return managedEntities;
 }
@@ -332,10 +341,22 @@ void sim_mob::Worker::perform_buff_flip()
 }
 
 
+bool sim_mob::Worker::GetCurrentWorkerId(unsigned int& workGroupNum, unsigned int& workerIndex)
+{
+    const Worker* worker = currentWorker.get();
+    if (!worker) {
+        return false;
+    }
+    workGroupNum = worker->workGroupNum;
+    workerIndex = worker->workerIndex;
+    return true;
+}
+
 void sim_mob::Worker::threaded_function_loop()
 {
     // Register thread on MessageBus.
     messaging::MessageBus::RegisterThread();
+    currentWorker.reset(this);
     
     ///NOTE: Please keep this function simple. In fact, you should not have to add anything to it.
     ///      Instead, add functionality into the sub-functions (perform_frame_tick(), etc.).
@@ -498,7 +519,7 @@ struct ContainerDeleter {
 void sim_mob::Worker::migrateAllOut()
 {
     while (!managedEntities.empty()) {
-        migrateOut(**managedEntities.begin());
+        migrateOut(*managedEntities.back());
     }
 }
 
@@ -554,6 +575,7 @@ void sim_mob::Worker::migrateIn(Entity& ag)
 //      May want to dig into this a bit more. ~Seth
 void sim_mob::Worker::update_entities(timeslice currTime)
 {
+    managedEntities.prepare();
     std::for_each(managedEntities.begin(), managedEntities.end(), EntityUpdater(*this, currTime));
 }
 
@@ -10,6 +10,7 @@
 #include <boost/random.hpp>
 #include <boost/thread.hpp>
 #include "buffering/BufferedDataManager.hpp"
+#include "workers/EntityList.hpp"
 #include "metrics/Frame.hpp"
 #include "event/EventPublisher.hpp"
 #include "event/SystemEvents.hpp"
@@ -68,7 +69,7 @@ public:
 
     virtual void scheduleForBred(Entity* entity) = 0;
 
-    virtual const std::set<Entity*>& getEntities() const = 0;
+    virtual const EntityList& getEntities() const = 0;
 
     virtual ProfileBuilder* getProfileBuilder() const = 0;
 
@@ -125,8 +126,19 @@ private:
 public:
     virtual ~Worker();
     static UpdatePublisher & GetUpdatePublisher();
+
+    /**
+     * Identifies the Worker running the calling thread. The ids do not depend on thread scheduling,
+     * so they can be used to order per-thread output deterministically.
+     *
+     * \param workGroupNum Set to the number of the Worker's WorkGroup.
+     * \param workerIndex Set to the index of the Worker within its WorkGroup.
+     * 
+eturn false if the calling thread is not a Worker thread.
+     */
+    static bool GetCurrentWorkerId(unsigned int& workGroupNum, unsigned int& workerIndex);
     //Removing entities and scheduling them for removal is allowed (but adding is restricted).
-    const std::set<Entity*>& getEntities() const;
+    const EntityList& getEntities() const;
     void remEntity(Entity* entity);
     void scheduleForRemoval(Entity* entity);
     void scheduleForBred(Entity* entity);
@@ -226,14 +238,15 @@ private:
     MgmtParams loop_params;
 
     ///Simple Entities managed by this worker
-    std::set<Entity*> managedEntities;
+    EntityList managedEntities;
 
     ///Some Entities need to be updated multiple times in each time step.
     ///This typically happens when part of the update of an Entity depends on the partial update of other entities.
     ///Confluxes in mid-term are a good example of multi-update entities
-    ///NOTE: The entities in this set also belong to managedEntities set.
-    ///      In other words, managedMultiUpdateEntities is a subset of managedEntities containing only multi-update entities
-    std::set<Entity*> managedMultiUpdateEntities;
+    ///NOTE: The entities in this list also belong to managedEntities.
+    ///      In other words, managedMultiUpdateEntities is a subset of managedEntities containing only multi-update entities.
+    ///      There are few of them, so they are simply kept sorted by id.
+    std::vector<Entity*> managedMultiUpdateEntities;
 
     ///If non-null, used for profiling.
     sim_mob::ProfileBuilder* profile;
@@ -242,6 +255,10 @@ private:
 
     uint32_t simulationStartDay;
 
+    ///Assigned by the parent: the WorkGroup number and the index of this Worker in it.
+    unsigned int workGroupNum;
+    unsigned int workerIndex;
+
 public:
 
     /// each worker has its own path set manager
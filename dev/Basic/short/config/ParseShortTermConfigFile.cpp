@@ -286,6 +286,54 @@ void ParseShortTermConfigFile::processSegmentDensityNode(DOMElement* node)
     }
 }
 
+void ParseShortTermConfigFile::processTrajectoryNode(DOMElement* node)
+{
+    if (node)
+    {
+        TrajectoryOutput &trajectory = stCfg.outputStats.trajectory;
+
+        trajectory.enabled = ParseBoolean(GetNamedAttributeValue(node, "enabled"), false);
+
+        if (trajectory.enabled)
+        {
+            trajectory.fileName = ParseString(GetNamedAttributeValue(node, "file-name"), "trajectory.bin");
+            trajectory.interval = ParseUnsignedInt(GetNamedAttributeValue(node, "interval"), (unsigned int) 0);
+            trajectory.bufferSize = ParseUnsignedInt(GetNamedAttributeValue(node, "buffer-size"), 16384);
+
+            if (trajectory.fileName.empty())
+            {
+                stringstream msg;
+                msg << "Empty value for <trajectory file-name=\""
+                    << "\">. Expected: \"file name\"";
+                throw runtime_error(msg.str());
+            }
+
+            if (trajectory.bufferSize == 0)
+            {
+                stringstream msg;
+                msg << "Invalid value for <trajectory buffer-size=\"" << trajectory.bufferSize
+                    << "\">. Expected: \"non zero value\"";
+                throw runtime_error(msg.str());
+            }
+
+            DOMElement *box = GetSingleElementByName(node, "bounding_box");
+            if (box)
+            {
+                trajectory.useBoundingBox = true;
+                trajectory.minX = ParseFloat(GetNamedAttributeValue(box, "min-x"));
+                trajectory.minY = ParseFloat(GetNamedAttributeValue(box, "min-y"));
+                trajectory.maxX = ParseFloat(GetNamedAttributeValue(box, "max-x"));
+                trajectory.maxY = ParseFloat(GetNamedAttributeValue(box, "max-y"));
+
+                if (trajectory.minX > trajectory.maxX || trajectory.minY > trajectory.maxY)
+                {
+                    throw runtime_error("Invalid <trajectory> bounding_box: min-x/min-y must not exceed max-x/max-y");
+                }
+            }
+        }
+    }
+}
+
 void ParseShortTermConfigFile::processSystemNode(DOMElement *node)
 {
     processNetworkNode(GetSingleElementByName(node, "network", true));
@@ -735,6 +783,7 @@ void ParseShortTermConfigFile::processOutputStatistics(xercesc::DOMElement* node
     processSegmentDensityNode(GetSingleElementByName(node, "segment_density"));
     processLoopDetectorCountNode(GetSingleElementByName(node, "loop-detector_counts"));
     processAssignmentMatrixNode(GetSingleElementByName(node, "assignment_matrix"));
+    processTrajectoryNode(GetSingleElementByName(node, "trajectory"));
 }
 
 void ParseShortTermConfigFile::processPathSetFileName(DOMElement* node)
@@ -64,6 +64,13 @@ private:
      */
     void processSegmentDensityNode(xercesc::DOMElement* node);
 
+    /**
+     * Processes the trajectory element in the config file
+     *
+     * @param node node corresponding to the trajectory element in the xml file
+     */
+    void processTrajectoryNode(xercesc::DOMElement* node);
+
     /**
      * Processes the system element in the config file
      *
@@ -186,6 +186,38 @@ struct SegmentDensityMap
     std::string fileName;
 };
 
+/**
+ * Represents the trajectory section of the configuration file
+ */
+struct TrajectoryOutput
+{
+    TrajectoryOutput() : enabled(false), fileName(""), interval(0), useBoundingBox(false), minX(0), minY(0), maxX(0), maxY(0),
+            bufferSize(16384)
+    {
+    }
+
+    ///Indicates whether the positions of the drivers are recorded in a binary trajectory file instead of the log
+    bool enabled;
+
+    ///Name of the trajectory file
+    std::string fileName;
+
+    ///Interval (in ms) at which positions are recorded. 0 records every tick
+    unsigned int interval;
+
+    ///Indicates whether only positions within the bounding box are recorded
+    bool useBoundingBox;
+
+    ///Bounding box of the recorded positions
+    double minX;
+    double minY;
+    double maxX;
+    double maxY;
+
+    ///Number of positions buffered by each worker before they are handed over to the writer thread
+    unsigned int bufferSize;
+};
+
 struct AssignmentMatrixConfig
 {
     AssignmentMatrixConfig() : enabled(false), fileName("") {}
@@ -208,6 +240,9 @@ struct OutputStatistics
     
     ///Setting for assignment matrix
     AssignmentMatrixConfig assignmentMatrix; 
+
+    ///Settings for the binary trajectory output
+    TrajectoryOutput trajectory;
 };
 
 /**
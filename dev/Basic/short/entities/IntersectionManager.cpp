@@ -3,7 +3,11 @@
 //   license.txt   (http://opensource.org/licenses/MIT)
 
 #include "IntersectionManager.hpp"
+
+#include <algorithm>
 #include "geospatial/network/RoadNetwork.hpp"
+#include "geospatial/network/TurningGroup.hpp"
+#include "geospatial/network/TurningPath.hpp"
 #include "message/MessageBus.hpp"
 
 using namespace sim_mob;
@@ -86,102 +90,143 @@ Entity::UpdateStatus IntersectionManager::frame_init(timeslice now)
     parameterMgr->param(modelName, "tailgate_separation_time", tailgateSeparationTime, 1.0);
     parameterMgr->param(modelName, "conflict_separation_time", conflictSeparationTime, 2.5);
 
+    createConflictIndex();
+
+    return Entity::UpdateStatus::Continue;
+}
+
+void IntersectionManager::createConflictIndex()
+{
     const RoadNetwork *network = RoadNetwork::getInstance();
-    const map<unsigned int, TurningPath *> &turningPaths = network->getMapOfIdvsTurningPaths();
-    map<unsigned int, TurningPath *>::const_iterator itTurnings = turningPaths.begin();
+    const Node *node = network->getById(network->getMapOfIdvsNodes(), intMgrId);
 
-    //Iterate through all the turnings
-    while (itTurnings != turningPaths.end())
+    if (!node)
     {
-        //Add the turning to the map of previous access times with initial value -T1
-        mapOfPrevAccessTimes.insert(make_pair(itTurnings->first, -tailgateSeparationTime));
-        ++itTurnings;
+        return;
     }
 
-    return Entity::UpdateStatus::Continue;
+    //Index the turnings of the intersection. The previous access times start at -T1, so that the first vehicle
+    //on a turning is not delayed
+    vector<const TurningPath *> turningPaths;
+    const map<unsigned int, map<unsigned int, TurningGroup *> > &turningGroups = node->getTurningGroups();
+
+    for (map<unsigned int, map<unsigned int, TurningGroup *> >::const_iterator itFrom = turningGroups.begin(); itFrom != turningGroups.end(); ++itFrom)
+    {
+        for (map<unsigned int, TurningGroup *>::const_iterator itGroup = itFrom->second.begin(); itGroup != itFrom->second.end(); ++itGroup)
+        {
+            const map<unsigned int, map<unsigned int, TurningPath *> > &paths = itGroup->second->getTurningPaths();
+
+            for (map<unsigned int, map<unsigned int, TurningPath *> >::const_iterator itFromLane = paths.begin(); itFromLane != paths.end(); ++itFromLane)
+            {
+                for (map<unsigned int, TurningPath *>::const_iterator itPath = itFromLane->second.begin(); itPath != itFromLane->second.end(); ++itPath)
+                {
+                    turningIndices.insert(make_pair(itPath->second->getTurningPathId(), turningPaths.size()));
+                    turningPaths.push_back(itPath->second);
+                    turnings.push_back(TurningReservations(-tailgateSeparationTime));
+                }
+            }
+        }
+    }
+
+    //List the conflicting turnings of every turning
+    for (size_t i = 0; i < turningPaths.size(); ++i)
+    {
+        const map<const TurningPath *, TurningConflict *> &conflicts = turningPaths[i]->getTurningConflicts();
+
+        for (map<const TurningPath *, TurningConflict *>::const_iterator itConflict = conflicts.begin(); itConflict != conflicts.end(); ++itConflict)
+        {
+            map<unsigned int, unsigned int>::const_iterator itIndex = turningIndices.find(itConflict->first->getTurningPathId());
+
+            if (itIndex != turningIndices.end() && itIndex->second != i)
+            {
+                turnings[i].conflicts.push_back(itIndex->second);
+            }
+        }
+    }
 }
 
-Entity::UpdateStatus IntersectionManager::frame_tick(timeslice now)
+IntersectionManager::TurningReservations& IntersectionManager::getReservations(unsigned int turningId)
 {
-    //Sort the request according to the earliest arrival times
-    CompareArrivalTimes compare;
-    receivedRequests.sort(compare);
+    map<unsigned int, unsigned int>::const_iterator itIndex = turningIndices.find(turningId);
 
-    //Iterate through all the requests (sorted by increasing arrival time)
-    for (list<IntersectionAccessMessage>::iterator itReq = receivedRequests.begin(); itReq != receivedRequests.end(); ++itReq)
+    if (itIndex != turningIndices.end())
     {
-        //Get the id of the turning on which the requesting vehicle will be driving
-        unsigned int turningId = (*itReq).getTurningId();
+        return turnings[itIndex->second];
+    }
 
-        //Get the last access time for the turning, and compute the access time for the vehicle
-        double accessTime = max((*itReq).getArrivalTime(), mapOfPrevAccessTimes[turningId] + tailgateSeparationTime);
+    //A turning of another intersection; it has no conflicts here
+    turningIndices.insert(make_pair(turningId, turnings.size()));
+    turnings.push_back(TurningReservations(-tailgateSeparationTime));
+    return turnings.back();
+}
 
-        //The responses to the requests which are incompatible with the current request
-        list<IntersectionAccessMessage> conflicts;
+double IntersectionManager::findConflictFreeTime(const TurningReservations &turning, double accessTime) const
+{
+    bool isConflictFound = true;
 
-        //Get the vehicles, whose requests have been processed, that conflict with the current requesting vehicle       
-        getConflicts(*itReq, conflicts);
+    while (isConflictFound)
+    {
+        isConflictFound = false;
 
-        //Filter out the incompatible requests which have been allocated access times less than the 
-        //access time for current request
-        filterConflicts(accessTime, conflicts);
+        //The latest access time on a conflicting turning which is closer than T2 to the current access time
+        double latestConflict = 0;
 
-        if (!conflicts.empty())
+        for (vector<unsigned int>::const_iterator itConflict = turning.conflicts.begin(); itConflict != turning.conflicts.end(); ++itConflict)
         {
-            IntersectionAccessMessage &firstConflict = conflicts.front();
-            if (firstConflict.getArrivalTime() < (accessTime + conflictSeparationTime))
-            {
-                //Iterators to point to consecutive elements in the list
-                list<IntersectionAccessMessage>::iterator itConflicts, itConflictsNext;
-
-                //Point the iterators to the beginning of the list and advance one of them to the next element
-                itConflicts = itConflictsNext = conflicts.begin();
-                ++itConflictsNext;
+            const deque<double> &accessTimes = turnings[*itConflict].accessTimes;
 
-                bool isGapFound = false;
-                double gapAccessTime = 0;
+            //The last access time earlier than accessTime + T2
+            deque<double>::const_iterator itTime = lower_bound(accessTimes.begin(), accessTimes.end(), accessTime + conflictSeparationTime);
 
-                //Look for a gap between 2 conflicting requests. The gap should be larger than 2*T2
-                while (itConflictsNext != conflicts.end())
-                {
-                    if ((*itConflictsNext).getArrivalTime() - (*itConflicts).getArrivalTime() >= (2 * conflictSeparationTime))
-                    {
-                        gapAccessTime = (*itConflicts).getArrivalTime() + conflictSeparationTime;
-
-                        //Check if this time is feasible for us (a person in front of us may be accessing the gap)
-                        if (accessTime < gapAccessTime)
-                        {
-                            accessTime = gapAccessTime;
-                            isGapFound = true;
-                            break;
-                        }
-                        else if ((*itConflictsNext).getArrivalTime() - accessTime >= conflictSeparationTime)
-                        {
-                            isGapFound = true;
-                        }
-                    }
-
-                    ++itConflicts;
-                    ++itConflictsNext;
-                }
+            if (itTime != accessTimes.begin())
+            {
+                --itTime;
 
-                if (!isGapFound)
+                if (*itTime + conflictSeparationTime > accessTime && (!isConflictFound || *itTime > latestConflict))
                 {
-                    //Gap was not found, so the access time is arrival time of last conflict request + T2
-                    accessTime = max(accessTime, (conflicts.back()).getArrivalTime() + conflictSeparationTime);
+                    latestConflict = *itTime;
+                    isConflictFound = true;
                 }
             }
         }
 
-        //Update the previous access time for this turning
-        mapOfPrevAccessTimes[turningId] = accessTime;
+        //Any time before latestConflict + T2 conflicts with it, so that is the earliest time we can try next
+        if (isConflictFound)
+        {
+            accessTime = latestConflict + conflictSeparationTime;
+        }
+    }
+
+    return accessTime;
+}
+
+Entity::UpdateStatus IntersectionManager::frame_tick(timeslice now)
+{
+    //Sort the request according to the earliest arrival times
+    CompareArrivalTimes compare;
+    receivedRequests.sort(compare);
+
+    //Iterate through all the requests (sorted by increasing arrival time)
+    for (list<IntersectionAccessMessage>::iterator itReq = receivedRequests.begin(); itReq != receivedRequests.end(); ++itReq)
+    {
+        //Get the id of the turning on which the requesting vehicle will be driving
+        unsigned int turningId = (*itReq).getTurningId();
+        TurningReservations &turning = getReservations(turningId);
+
+        //Get the last access time for the turning, and compute the access time for the vehicle
+        double accessTime = max((*itReq).getArrivalTime(), turning.prevAccessTime + tailgateSeparationTime);
+
+        //Look for the first gap of at least 2*T2 between the vehicles which were granted access on conflicting
+        //turnings, and which is not earlier than the access time
+        accessTime = findConflictFreeTime(turning, accessTime);
+
+        //Update the previous access time for this turning, and reserve the access time
+        turning.prevAccessTime = accessTime;
+        turning.accessTimes.push_back(accessTime);
 
         //Set the computed access time
         IntersectionAccessMessage *response = new IntersectionAccessMessage(accessTime, turningId);
 
-        //Add to the sent responses list
-        sentResponses.push_back(*response);
-
         //Send the response
         MessageBus::PostMessage((*itReq).GetSender(), MSG_RESPONSE_INT_ARR_TIME, MessageBus::MessagePtr(response));
     }
@@ -195,12 +240,12 @@ void IntersectionManager::frame_output(timeslice now)
     //Clear the received requests
     receivedRequests.clear();
 
-    //Clear only the sent requests with access times that have expired
-    for (list<IntersectionAccessMessage>::iterator itResponse = sentResponses.begin(); itResponse != sentResponses.end(); ++itResponse)
+    //Clear only the access times that have expired
+    for (vector<TurningReservations>::iterator itTurning = turnings.begin(); itTurning != turnings.end(); ++itTurning)
     {
-        if ((*itResponse).getArrivalTime() <= (now.ms() / 1000))
+        while (!itTurning->accessTimes.empty() && itTurning->accessTimes.front() <= (now.ms() / 1000))
         {
-            itResponse = sentResponses.erase(itResponse);
+            itTurning->accessTimes.pop_front();
         }
     }
 }
@@ -213,42 +258,3 @@ bool IntersectionManager::isNonspatial()
 void IntersectionManager::load(const std::map<std::string, std::string> &configProps)
 {
 }
-
-void IntersectionManager::getConflicts(IntersectionAccessMessage &request, list<IntersectionAccessMessage> &conflicts)
-{
-    const RoadNetwork *network = RoadNetwork::getInstance();
-    
-    //The turning path of the current requesting vehicle
-    const TurningPath *currTurning = network->getById(network->getMapOfIdvsTurningPaths(), request.getTurningId());
-
-    //Iterate through the processed requests and find the requests that are incompatible with the current request
-    for (list<IntersectionAccessMessage>::const_iterator itResponse = sentResponses.begin(); itResponse != sentResponses.end(); ++itResponse)
-    {
-        //The turning section of the vehicle whose request has been processed
-        const TurningPath *processedTurning = network->getById(network->getMapOfIdvsTurningPaths(), (*itResponse).getTurningId());
-
-        //Check if there is a conflict between the turnings
-        if (currTurning->getTurningConflict(processedTurning))
-        {
-            //Add the request into the vector of conflicts
-            conflicts.push_back(*itResponse);
-        }
-    }
-}
-
-void IntersectionManager::filterConflicts(double accessTime, list<IntersectionAccessMessage> &conflicts)
-{
-    //Iterate through the list of conflicts
-    for (list<IntersectionAccessMessage>::iterator itConflicts = conflicts.begin(); itConflicts != conflicts.end(); ++itConflicts)
-    {
-        //If the access time of the current request is greater than that of the conflicts to which responses have already been 
-        //sent, filter the conflict out
-        if ((*itConflicts).getArrivalTime() + conflictSeparationTime < accessTime)
-        {
-            itConflicts = conflicts.erase(itConflicts);
-        }
-    }
-
-    CompareArrivalTimes compare;
-    conflicts.sort(compare);
-}
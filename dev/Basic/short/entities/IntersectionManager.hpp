@@ -4,9 +4,11 @@
 
 #pragma once
 
+#include <deque>
 #include <list>
 #include <map>
 #include <set>
+#include <vector>
 
 #include "entities/Agent.hpp"
 #include "entities/Person.hpp"
@@ -27,35 +29,73 @@ class IntersectionAccessMessage;
 class IntersectionManager : public Agent
 {
 private:
+    /**The access times granted on a turning path of the intersection*/
+    struct TurningReservations
+    {
+        TurningReservations(double prevAccessTime) : prevAccessTime(prevAccessTime)
+        {
+        }
+
+        /**The most recent access time granted on the turning*/
+        double prevAccessTime;
+
+        /**
+         * The access times granted on the turning which have not yet expired, in increasing order. As an access time is
+         * never earlier than the previous access time on the same turning, new access times are appended.
+         */
+        deque<double> accessTimes;
+
+        /**Indices of the turnings (in turnings) which conflict with this one*/
+        vector<unsigned int> conflicts;
+    };
+
     /**Map holding the pointers to all the intersection manager objects*/
     static map<unsigned int, IntersectionManager *> intManagers;
     
     /**The id of the intersection manager. The id is the same as the node id*/
     unsigned int intMgrId;
 
+    /**The reservations of the turning paths of the intersection*/
+    vector<TurningReservations> turnings;
+
     /**
-     * This map stores the most recent access time granted to a vehicle based on its turning id
-     * Key: Turning id, Value: Previous access time
+     * The index of the turning paths in turnings
+     * Key: Turning id, Value: Index
      */
-    map<unsigned int, double> mapOfPrevAccessTimes;
+    map<unsigned int, unsigned int> turningIndices;
 
     /**Stores the requests to be processed during the upcoming frame tick*/
     list<IntersectionAccessMessage> receivedRequests;
 
-    /**Stores the responses sent in the current frame tick*/
-    list<IntersectionAccessMessage> sentResponses;
-
     /**Separation time between vehicles following one another (also known as T1)*/
     double tailgateSeparationTime;
 
     /**Separation time between vehicles with conflicting trajectories (also known as T2)*/
     double conflictSeparationTime;
 
-    /**Iterates through the processed requests to find the vehicles that are incompatible with the current request*/
-    void getConflicts(IntersectionAccessMessage &request, list<IntersectionAccessMessage> &conflicts);
+    /**
+     * Indexes the turning paths of the intersection, and builds the list of conflicting turnings of each of them from
+     * the turning conflicts of the network
+     */
+    void createConflictIndex();
 
-    /**Filters out the conflicts which have been allocated access times less than the access time for current request*/
-    void filterConflicts(double accessTime, list<IntersectionAccessMessage> &conflicts);
+    /**
+     * @param turningId the id of a turning path
+     *
+     * @return the reservations of the turning path
+     */
+    TurningReservations& getReservations(unsigned int turningId);
+
+    /**
+     * Finds the earliest time, not before the given time, which is separated by at least T2 from all the access
+     * times granted on the conflicting turnings
+     *
+     * @param turning the reservations of the requested turning
+     * @param accessTime the earliest time at which the vehicle can access the intersection
+     *
+     * @return the access time
+     */
+    double findConflictFreeTime(const TurningReservations &turning, double accessTime) const;
 
 protected:
     /**
@@ -145,7 +185,7 @@ public:
 
 struct CompareArrivalTimes
 {
-    bool operator()(IntersectionAccessMessage first, IntersectionAccessMessage second)
+    bool operator()(const IntersectionAccessMessage &first, const IntersectionAccessMessage &second) const
     {
         return ( first.getArrivalTime() < second.getArrivalTime());
     }
@@ -3,6 +3,7 @@
 //   license.txt   (http://opensource.org/licenses/MIT)
 
 #include <algorithm>
+#include <cmath>
 #include <boost/utility.hpp>
 
 #include "LoopDetectorEntity.hpp"
@@ -10,7 +11,6 @@
 #include "conf/ConfigManager.hpp"
 #include "conf/ConfigParams.hpp"
 #include "config/ST_Config.hpp"
-#include "entities/AuraManager.hpp"
 #include "Person_ST.hpp"
 #include "entities/roles/driver/Driver.hpp"
 #include "entities/roles/Role.hpp"
@@ -27,103 +27,44 @@ using namespace sim_mob;
 using std::vector;
 typedef sim_mob::Entity::UpdateStatus UpdateStatus;
 
-namespace
-{
-Point zero(0, 0);
-
-bool isNotInitialized(AABB const & aabb)
-{
-    return (aabb.lowerLeft_.getX() == zero.getX() && aabb.lowerLeft_.getY() == zero.getY()
-            && aabb.upperRight_.getX() == zero.getX() && aabb.upperRight_.getY() == zero.getY());
-}
-
-Box getBox(const Point& p1, const Point& p2, double halfWidth,
-        double length, double offset, int id)
-{
-    Box box;
-
-    Vector2D<double> lastLine = normalize(Vector2D<double>(p2.getX() - p1.getX(), p2.getY() - p1.getY()));
-    Vector2D<double> ldHorizontal = Vector2D<double>(-lastLine.getY(), lastLine.getX());
-
-    Vector2D<double> moveRight = ldHorizontal * (halfWidth);
-    Vector2D<double> moveLeft = ldHorizontal * (-halfWidth);
-
-    Vector2D<double> bottomCenter = lastLine * (-(length + offset));
-    Vector2D<double> topCenter = lastLine * (-offset);
-
-    Point bottom = Point(p2.getX() + bottomCenter.getX(), p2.getY() + bottomCenter.getY());
-    Point top = Point(p2.getX() + topCenter.getX(), p2.getY() + topCenter.getY());
-
-    box.upperLeft_ = Point(top.getX()+moveLeft.getX(), top.getY()+moveLeft.getY());
-    box.upperRight_ = Point(top.getX()+moveRight.getX(), top.getY()+moveRight.getY());
-    box.lowerLeft_ = Point(bottom.getX()+moveLeft.getX(), bottom.getY()+moveLeft.getY());
-    box.lowerRight_ = Point(bottom.getX()+moveRight.getX(), bottom.getY()+moveRight.getY());
-
-    return box;
-}
-}
-
 /** \cond ignoreLoopDetectorEntityInnards -- Start of block to be ignored by doxygen.  */
 
-void AABB::united(AABB const &another)
-{
-    int left;
-    int right;
-    int bottom;
-    int top;
-
-    if (this->lowerLeft_.getX() < another.lowerLeft_.getX())
-        left = this->lowerLeft_.getX();
-    else
-        left = another.lowerLeft_.getX();
-    if (this->lowerLeft_.getY() < another.lowerLeft_.getY())
-        bottom = this->lowerLeft_.getY();
-    else
-        bottom = another.lowerLeft_.getY();
-    if (this->upperRight_.getX() > another.upperRight_.getX())
-        right = this->upperRight_.getX();
-    else
-        right = another.upperRight_.getX();
-    if (this->upperRight_.getY() > another.upperRight_.getY())
-        top = this->upperRight_.getY();
-    else
-        top = another.upperRight_.getY();
-
-    this->lowerLeft_ = Point(left, bottom);
-    this->upperRight_ = Point(right, top);
-}
+std::map<Lane const *, LoopDetector *> LoopDetector::loopDetectors_;
 
 LoopDetector::LoopDetector(Lane const *lane, meter_t length, Shared<Sensor::CountAndTimePair> &pair)
-: width_(lane->getWidth())
+: lane_(lane)
+, halfWidth_(lane->getWidth() / 2.5)
+, downstreamOffset_(0.5)
+, upstreamOffset_(0.5 + length)
 , request_to_reset_(false)
 , countAndTimePair_(pair)
 {
-    const std::vector<PolyPoint> polyline = lane->getPolyLine()->getPoints();
-    size_t count = polyline.size();
-
-    // The last line of the lane's poly-line is from <p1> to <p2>.
-    Point const & p1 = polyline[count - 2];
-    Point const & p2 = polyline[count - 1];
-
-    ld_area = getBox(p1, p2, width_/2.5, length, 0.5, lane->getLaneId());
-
-    leftEdge = Vector2D<double>(ld_area.upperLeft_.getX() - ld_area.lowerLeft_.getX(),
-            ld_area.upperLeft_.getY() - ld_area.lowerLeft_.getY());
-    bottomEdge = Vector2D<double>(ld_area.lowerRight_.getX() - ld_area.lowerLeft_.getX(),
-            ld_area.lowerRight_.getY() - ld_area.lowerLeft_.getY());
+    timeStepInMilliSeconds_ = ST_Config::getInstance().personTimeStepInMilliSeconds();
+    loopDetectors_.insert(std::make_pair(lane, this));
+}
 
-    sqLenOfLeftEdge = ((leftEdge.getX() * leftEdge.getX()) + (leftEdge.getY() * leftEdge.getY()));
-    sqLenOfBottomEdge = ((bottomEdge.getX() * bottomEdge.getX()) + (bottomEdge.getY() * bottomEdge.getY()));
+LoopDetector::~LoopDetector()
+{
+    std::map<Lane const *, LoopDetector *>::iterator iter = loopDetectors_.find(lane_);
+    if (iter != loopDetectors_.end() && iter->second == this)
+    {
+        loopDetectors_.erase(iter);
+    }
+}
 
-    timeStepInMilliSeconds_ = ST_Config::getInstance().personTimeStepInMilliSeconds();
+LoopDetector* LoopDetector::getLoopDetector(Lane const *lane)
+{
+    std::map<Lane const *, LoopDetector *>::const_iterator iter = loopDetectors_.find(lane);
+    return (iter != loopDetectors_.end()) ? iter->second : nullptr;
 }
 
-Box LoopDetector::getLDBox() const
+bool LoopDetector::isOver(double distToEndOfLane, double lateralMovement) const
 {
-    return ld_area;
+    return downstreamOffset_ <= distToEndOfLane && distToEndOfLane <= upstreamOffset_
+            && std::abs(lateralMovement) <= halfWidth_;
 }
 
-bool LoopDetector::check(boost::unordered_set<Vehicle const *> &vehicles, std::vector<Vehicle const *>& vehsInLoopDetector)
+bool LoopDetector::check(timeslice now, std::vector<Person_ST const *> &entered)
 {
     // In the previous version, LoopDetectorEntity::reset() was allowed to modify countAndTimePair_.
     // Therefore, countAndTimePair_ could be modified via 2 execution paths -- reset() and this
@@ -136,6 +77,9 @@ bool LoopDetector::check(boost::unordered_set<Vehicle const *> &vehicles, std::v
     // "requests" for countAndTimePair_ to be reset.  Now there is a race condition on the
     // request_to_reset_ variable, but this race will not cause any issue except that
     // countAndTimePair_ may get reset twice in a row.  That is not serious.
+    //
+    // The moves reported by the drivers are left pending until the next tick, as the vehicles
+    // were not looked at during a reset.
     if (request_to_reset_)
     {
         request_to_reset_ = false;
@@ -143,61 +87,22 @@ bool LoopDetector::check(boost::unordered_set<Vehicle const *> &vehicles, std::v
         return false;
     }
 
-    boost::unordered_set<Vehicle const *>::iterator iter;
-    for (iter = vehicles.begin(); iter != vehicles.end(); ++iter)
-    {
-        Vehicle const *vehicle = *iter;
-        if (check(*vehicle))
-        {
-            if (std::find(vehicles_.begin(), vehicles_.end(), vehicle) == vehicles_.end())
-            {
-                vehicles_.push_back(vehicle);
-                vehsInLoopDetector.push_back(vehicle);
-                incrementVehicleCount();
-            }
-
-            // Remove this vehicle from the <vehicles> list so that the other loop detectors
-            // do not have to bother with this vehicle, which cannot be hovering over them as well.
-            vehicles.erase(iter);
+    size_t numEntered = entered.size();
+    bool occupied = occupancy_.update(now.ms(), entered);
+    numEntered = entered.size() - numEntered;
 
-            // Return immediately even if there is another vehicle over the loop detector.
-            // Eventually one will move away.
-            return true;
-        }
-        else
-        {
-            std::vector<const Vehicle*>::iterator iter = std::find(vehicles_.begin(), vehicles_.end(), vehicle);
-            if(iter != vehicles_.end())
-            {
-                vehicles_.erase(iter);
-            }
-        }
-    }
-
-    // No vehicle (or part of) is hovering over the loop detector.
-    incrementSpaceTime();
-    return false;
-}
-
-bool LoopDetector::check(Vehicle const & vehicle)
-{
-    Point vehPos = vehicle.getCurrPosition();
-
-    // Line connecting the lower left corner of loop detector and vehicle position
-    Vector2D<double> line(vehPos.getX() - ld_area.lowerLeft_.getX(),
-            vehPos.getY() - ld_area.lowerLeft_.getY());
-
-    double projOnLeftEdge = (line * leftEdge);
-    if (0 <= projOnLeftEdge && projOnLeftEdge <= sqLenOfLeftEdge)
+    if (numEntered > 0 || !occupied)
     {
-        double projOnBottomEdge = (line * bottomEdge);
-        if (0 <= projOnBottomEdge && projOnBottomEdge <= sqLenOfBottomEdge)
+        Sensor::CountAndTimePair pair(countAndTimePair_);
+        pair.vehicleCount += numEntered;
+        if (!occupied)
         {
-            return true;
+            pair.spaceTimeInMilliSeconds += timeStepInMilliSeconds_;
         }
+        countAndTimePair_.set(pair);
     }
 
-    return false;
+    return occupied;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -210,7 +115,7 @@ public:
     Impl(Signal const &signal, LoopDetectorEntity &entity);
     ~Impl();
 
-    // Check if any vehicle is hovering over any of the loop detectors or not.
+    // Update the loop detectors with the moves reported by the drivers.
     bool check(timeslice now);
 
     // Called by the Signal object at the end of its cycle to reset all CountAndTimePair.
@@ -226,12 +131,8 @@ private:
     // Collection of loop detectors managed by this entity.
     std::map<Lane const *, LoopDetector *> loopDetectors_;
 
-    // The smallest rectangle that would contain all of <loopDetectors_>.  Since the loop detectors
-    // could be on opposite sides of the intersection, this area would include the intersection.
-    // Alternatively, the LoopDetectorEntity could be implemented as having a collection of
-    // disjoint monitor areas.  In that case, the check() would make calls to the AuraManager for
-    // each of the monitor areas.
-    AABB monitorArea_;
+    // Drivers who moved onto a loop detector during the current tick; kept to reuse its storage.
+    std::vector<Person_ST const *> entered_;
 
     //For reference.
     const LoopDetectorEntity *parent;
@@ -243,8 +144,6 @@ private:
     void
     createLoopDetectors(std::vector<RoadSegment *> const &roads, LoopDetectorEntity &entity);
 
-    void computeMonitorArea();
-
     BasicLogger& assignmentMatrixLogger;
     ST_Config& stCfg;
 };
@@ -299,45 +198,9 @@ void LoopDetectorEntity::Impl::createLoopDetectors(Signal const &signal, LoopDet
 
         ++itNodes;
     }
-    computeMonitorArea();
 }
 
 
-void LoopDetectorEntity::Impl::computeMonitorArea()
-{
-    if(loopDetectors_.empty())
-    {
-        return;
-    }
-
-    // TODO: Currently computing the rectangle which contains all the loop detector
-    //       in a signalized intersection. To improve the performance minimum bounding
-    //       rectangle should be computed
-
-    std::vector<Point> vecPoints;
-    for (auto item : loopDetectors_)
-    {
-        Box box = item.second->getLDBox();
-        vecPoints.push_back(box.lowerLeft_);
-        vecPoints.push_back(box.upperLeft_);
-        vecPoints.push_back(box.upperRight_);
-        vecPoints.push_back(box.lowerRight_);
-    }
-
-    auto xExtremes = std::minmax_element(vecPoints.begin(), vecPoints.end(),
-                    [](const Point& lhs, const Point& rhs) {
-                            return lhs.getX() < rhs.getX();
-                     });
-
-    auto yExtremes = std::minmax_element(vecPoints.begin(), vecPoints.end(),
-                        [](const Point& lhs, const Point& rhs) {
-                                return lhs.getY() < rhs.getY();
-                         });
-
-    monitorArea_.lowerLeft_ = Point((*xExtremes.first).getX(), (*yExtremes.first).getY());
-    monitorArea_.upperRight_ = Point((*xExtremes.second).getX(), (*yExtremes.second).getY());
-}
-
 void LoopDetectorEntity::Impl::createLoopDetectors(std::vector<RoadSegment *> const & roads, LoopDetectorEntity & entity)
 {
     size_t count = roads.size();
@@ -387,53 +250,20 @@ void LoopDetectorEntity::Impl::createLoopDetectors(std::vector<RoadSegment *> co
 
 bool LoopDetectorEntity::Impl::check(timeslice now)
 {
-    // Get all vehicles located within monitorArea_.
-    boost::unordered_set<Vehicle const *> vehicles;
-    boost::unordered_map<Vehicle const *, Person_ST const *> vehicleToPersonMap;
-    std::vector<Agent const *> const agents = AuraManager::instance().agentsInRect(monitorArea_.lowerLeft_, monitorArea_.upperRight_, parent);
-    for (size_t i = 0; i < agents.size(); ++i)
-    {
-        Agent const * agent = agents[i];
-        if (Person_ST const * person = dynamic_cast<Person_ST const *> (agent))
-        {
-            //Extract the current resource used by this Agent.          
-            const Role<Person_ST> *role = person->getRole();
-
-            if(role)
-            {
-                const Driver* driver = dynamic_cast<const Driver*>(role);
-
-                if(!driver || loopDetectors_.find(driver->getCurrLane()) == loopDetectors_.end())
-                {
-                    continue;
-                }
-
-                const Vehicle * vehicle = dynamic_cast<Vehicle *> (role->getResource());
-
-                if (vehicle)
-                {
-                    vehicles.insert(vehicle);
-                    vehicleToPersonMap[vehicle] = person;
-                }
-            }
-        }
-    }
-
-    // Pass the vehicles list to the loop detectors.
     std::map<Lane const *, LoopDetector *>::const_iterator iter;
     for (iter = loopDetectors_.begin(); iter != loopDetectors_.end(); ++iter)
     {
-        std::vector<Vehicle const *> vehsInLoopDetector;
-        iter->second->check(vehicles, vehsInLoopDetector);
+        entered_.clear();
+        iter->second->check(now, entered_);
 
         if(stCfg.outputStats.assignmentMatrix.enabled)
         {
-            for (std::vector<Vehicle const *>::const_iterator vehIter = vehsInLoopDetector.begin();
-                    vehIter != vehsInLoopDetector.end(); vehIter++)
+            for (std::vector<Person_ST const *>::const_iterator personIter = entered_.begin();
+                    personIter != entered_.end(); personIter++)
             {
-                Person_ST const * person = vehicleToPersonMap[(*vehIter)];
+                Person_ST const * person = *personIter;
 
-                if(person->getRole()->roleType != sim_mob::Role<Person_ST>::RL_DRIVER)
+                if(!person->getRole() || person->getRole()->roleType != sim_mob::Role<Person_ST>::RL_DRIVER)
                 {
                     continue;
                 }
@@ -3,47 +3,19 @@
 //   license.txt   (http://opensource.org/licenses/MIT)
 
 #pragma once
-#include <boost/unordered_set.hpp>
-#include <boost/geometry.hpp>
-#include <boost/geometry/geometries/polygon.hpp>
+#include <map>
+#include <vector>
 
-#include "buffering/Vector2D.hpp"
+#include "entities/DetectorOccupancy.hpp"
 #include "entities/Sensor.hpp"
 #include "entities/signal/Signal.hpp"
-#include "entities/vehicle/Vehicle.hpp"
 #include "geospatial/network/Lane.hpp"
 
 
 namespace sim_mob
 {
 
-namespace bg = boost::geometry;
-
-typedef bg::model::point<double, 2, bg::cs::cartesian> point_t;
-typedef bg::model::box<point_t> loop_detector_box;
-
-/**
- * This class models an Axially Aligned Bounding Box.  That is, it is a rectangle that is 
- * parallel to both the X- and Y- axes.  As a bounding box, it is the smallest rectangle that 
- * would contain something.
- */
-struct AABB
-{
-    Point lowerLeft_;
-    Point upperRight_;
-
-    // Expand this AABB to include another AABB.  That is, this = this union <another>.
-    // union is a keyword in C++, so the method name is united.
-    void united(AABB const &another);
-};
-
-struct Box
-{
-    Point lowerLeft_;
-    Point upperLeft_;
-    Point upperRight_;
-    Point lowerRight_;
-};
+class Person_ST;
 
 /**
  * The LoopDetectorEntity is an entity that models all the loop-detectors located just before the
@@ -56,7 +28,9 @@ struct Box
  *
  * For each loop detector, the entity counts the number of vehicles crossing the detector and
  * the total amount of time that no vehicle is hovering over the detector.  The time attribute
- * is known as the total "space-time".
+ * is known as the total "space-time".  The drivers report when they move onto or off a loop
+ * detector (see LoopDetector::getLoopDetector()), so the cost of a tick depends on the traffic
+ * over the detectors only.
  *
  * The LoopDetectorEntity expects its Signal object to reset the vehicle count and space-time
  * attributes periodically via the reset() method.
@@ -113,40 +87,58 @@ protected:
 // LoopDetector
 ////////////////////////////////////////////////////////////////////////////////////////////
 
-// The LoopDetector class actually models a monitoring area surrounding and centered at a loop
-// detector and oriented in the same direction as the loop detector.  The width of the area is that
-// of the lane, and the loop-detector's width is assumed to be a few centimeters narrower than the
-// lane's width.  The length of the monitoring area include an area before and after the loop
-// detector.  This is the outer area, while the inner area matches the area occupied by the loop
-// detector.  See the comment in LoopDetectorEntity::Impl::Impl() below.
+// The LoopDetector class models the area occupied by a loop detector at the end of a lane.  The
+// area starts a short distance before the stop-line and is a few centimeters narrower than the
+// lane.  A vehicle is hovering over the loop detector when its position is inside that area, that
+// is, when it is on the lane, its distance to the end of the lane is between the downstream and
+// upstream offsets of the loop detector, and it has not moved laterally beyond the loop detector's
+// half width.
 //
-// Since most loop detectors are not aligned to the X- and Y- axes, the monitoring area is a 2D
-// Object-oriented Bounding Box (OBB). The corners of OBB is computed based on the last polyline
-// of the lane where it is placed. If the projection of line between the vehicle position and
-// lowerleft corner and leftEdge, bottomEdge is less than the square length of leftEdge,bottomEdge
-// respectively, then the vehicle is inside the monitor area, otherwise not.
+// Each driver checks its own position against the loop detector of its current lane and reports
+// when it moves onto or off it.  The reports are applied by check(), which therefore only costs
+// something when vehicles are actually crossing the loop detector.
 
 class LoopDetector : private boost::noncopyable
 {
 public:
     LoopDetector(Lane const *lane, meter_t length, Shared<Sensor::CountAndTimePair> &pair);
+    ~LoopDetector();
 
-    // Check if any vehicle in the <vehicles> list is hovering over the loop detector.  If there
-    // is no vehicle, then set <vehicle_> to 0 and increment the space-time attribute.  If a
-    // vehicle (or part of) is hovering over the loop detector, set <vehicle_> to it; increment
-    // the vehicle count whenever <vehicle_> changes.
-    bool check(boost::unordered_set<Vehicle const *> &vehicles, std::vector<Vehicle const *>& vehsInLoopDetector);
+    /**
+     * @return the loop detector on the given lane, or null if there is none.  The loop detectors are
+     * created before the simulation starts, so this may be called from any thread.
+     */
+    static LoopDetector* getLoopDetector(Lane const *lane);
+
+    /**
+     * @param distToEndOfLane distance (in metre) from the vehicle's position to the end of the lane
+     * @param lateralMovement lateral movement (in metre) of the vehicle from the centre of the lane
+     * @return true if a vehicle at this position is hovering over the loop detector
+     */
+    bool isOver(double distToEndOfLane, double lateralMovement) const;
 
     /**
-     * @return the AABB that would contain the monitoring area of this object.
+     * Called by a driver when its vehicle moves onto the loop detector, during the tick at \c time (in ms).
      */
-    Box getLDBox() const;
+    void enter(Person_ST const *person, unsigned int time)
+    {
+        occupancy_.enter(person, time);
+    }
 
-    const std::vector<const Vehicle* > vehicle() const
+    /**
+     * Called by a driver when its vehicle moves off the loop detector, during the tick at \c time (in ms).
+     */
+    void leave(Person_ST const *person, unsigned int time)
     {
-        return vehicles_;
+        occupancy_.leave(person, time);
     }
 
+    // Apply the moves onto and off the loop detector reported before <now>.  If no vehicle is
+    // hovering over the loop detector, increment the space-time attribute.  Increment the vehicle
+    // count for every vehicle which has moved onto it, and add the drivers of these vehicles to
+    // <entered>.
+    bool check(timeslice now, std::vector<Person_ST const *> &entered);
+
     /**
      * Called by the Signal object at the end of its cycle to reset the CountAndTimePair
      */
@@ -155,37 +147,18 @@ public:
         request_to_reset_ = true;
     }
 
-    Point center_;
-    meter_t width_;
-
-    Box ld_area;
-
-    Vector2D<double> leftEdge;
-    Vector2D<double> bottomEdge;
-
-    double sqLenOfLeftEdge;
-    double sqLenOfBottomEdge;
 private:
+    Lane const *lane_;
+    meter_t halfWidth_;
+    meter_t downstreamOffset_; // Distance from the end of the lane to the downstream edge.
+    meter_t upstreamOffset_; // Distance from the end of the lane to the upstream edge.
+
     unsigned int timeStepInMilliSeconds_; // The loop detector entity runs at this rate.
     bool request_to_reset_; // See the comment in check().
     Shared<Sensor::CountAndTimePair> & countAndTimePair_;
-    std::vector<const Vehicle*> vehicles_;
-private:
-    // Return true if any part of <vehicle> is hovering over the loop detector.
-    bool check(Vehicle const &vehicle);
+    DetectorOccupancy<Person_ST> occupancy_;
 
-    void incrementSpaceTime()
-    {
-        Sensor::CountAndTimePair pair(countAndTimePair_);
-        pair.spaceTimeInMilliSeconds += timeStepInMilliSeconds_;
-        countAndTimePair_.set(pair);
-    }
-
-    void incrementVehicleCount()
-    {
-        Sensor::CountAndTimePair pair(countAndTimePair_);
-        ++pair.vehicleCount;
-        countAndTimePair_.set(pair);
-    }
+    // The loop detectors, by lane.
+    static std::map<Lane const *, LoopDetector *> loopDetectors_;
 };
 }
@@ -6,7 +6,10 @@
 
 #include "BusStopAgent.hpp"
 #include "config/ST_Config.hpp"
+#include "entities/AgentRegistry.hpp"
 #include "entities/roles/activityRole/ActivityPerformer.hpp"
+#include "entities/roles/driver/DriverFacets.hpp"
+#include "entities/TrajectoryRecorder.hpp"
 #include "event/args/ReRouteEventArgs.hpp"
 #include "message/MessageBus.hpp"
 #include "message/ST_Message.hpp"
@@ -308,6 +311,8 @@ void Person_ST::changeRole()
     prevRole = currRole;
     currRole = nextRole;
     nextRole = nullptr;
+
+    AgentRegistry::getInstance().setRole(this, currRole ? currRole->roleType : Role<Person_ST>::RL_UNKNOWN);
 }
 
 vector<BufferedBase *> Person_ST::buildSubscriptionList()
@@ -523,7 +528,25 @@ void Person_ST::frame_output(timeslice now)
     //Save the output
     if (!isToBeRemoved())
     {
-        LogOut(currRole->Movement()->frame_tick_output());
+        TrajectoryRecorder *recorder = TrajectoryRecorder::getInstance();
+        if (recorder)
+        {
+            //Drivers (including bus drivers) are recorded in binary; other roles have no position output
+            DriverMovement *movement = nullptr;
+            if (recorder->isDue(now.frame()) && (movement = dynamic_cast<DriverMovement *>(currRole->Movement())))
+            {
+                TrajectoryRecord record;
+                if (movement->fillTrajectoryRecord(record))
+                {
+                    record.frame = now.frame();
+                    recorder->record(record);
+                }
+            }
+        }
+        else
+        {
+            LogOut(currRole->Movement()->frame_tick_output());
+        }
     }
 
     setResetParamsRequired(true);
@@ -880,7 +903,7 @@ SegmentTravelStats& Person_ST::startCurrRdSegTravelStat(const RoadSegment* rdSeg
 }
 
 SegmentTravelStats& Person_ST::finalizeCurrRdSegTravelStat(const RoadSegment* rdSeg,
-        double exitTime, const std::string travelMode)
+        double exitTime, unsigned int travelModeId)
 {
     if(rdSeg != rsTravelStats.roadSegment)
     {
@@ -888,7 +911,7 @@ SegmentTravelStats& Person_ST::finalizeCurrRdSegTravelStat(const RoadSegment* rd
         msg << __func__ << ": Road segment mis-match";
         throw std::runtime_error(msg.str());
     }
-    rsTravelStats.finalize(rdSeg,exitTime, travelMode);
+    rsTravelStats.finalize(rdSeg,exitTime, travelModeId);
     return rsTravelStats;
 }
 
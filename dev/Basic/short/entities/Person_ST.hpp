@@ -341,6 +341,6 @@ public:
     SegmentTravelStats& startCurrRdSegTravelStat(const RoadSegment* rdSeg, double entryTime);
 
     SegmentTravelStats& finalizeCurrRdSegTravelStat(const RoadSegment* rdSeg,double exitTime,
-            const std::string travelMode);
+            unsigned int travelModeId);
 };
 }
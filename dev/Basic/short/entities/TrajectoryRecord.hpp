@@ -0,0 +1,68 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <stdint.h>
+
+namespace sim_mob
+{
+
+/**
+ * One agent position, as written by the TrajectoryRecorder.
+ *
+ * The struct is written to the trajectory file as is, so its layout is fixed: 64 bytes without implicit padding,
+ * in the byte order of the simulating host. Do not reorder or resize the fields without changing
+ * TrajectoryRecord::FORMAT_VERSION.
+ */
+struct TrajectoryRecord
+{
+    enum Kind
+    {
+        KIND_DRIVER = 0,
+        KIND_BUS_DRIVER = 1
+    };
+
+    enum Flags
+    {
+        /// the person is an AMOD vehicle; agentId is its person id, not its AMOD trip id
+        FLAG_AMOD = 1,
+
+        /// the driver is on a taxi trip
+        FLAG_TAXI = 2,
+
+        /// the agent is a fake copy of an agent simulated by another MPI process
+        FLAG_FAKE = 4
+    };
+
+    static const uint32_t FORMAT_VERSION = 1;
+
+    /// maximum length of the bus line id, including the terminating null character
+    static const unsigned int BUS_LINE_ID_SIZE = 16;
+
+    uint32_t frame;
+    uint32_t agentId;
+    double xPos;
+    double yPos;
+
+    /// angle in degrees, as shown by the visualiser
+    double angle;
+
+    float length;
+    float width;
+
+    /// id of the segment, or of the turning group within an intersection
+    uint32_t wayPointId;
+
+    uint16_t passengers;
+    uint8_t kind;
+    uint8_t flags;
+
+    /// bus line of a bus driver, null terminated
+    char busLineId[BUS_LINE_ID_SIZE];
+};
+
+static_assert(sizeof(TrajectoryRecord) == 64, "TrajectoryRecord is written to disk and must keep its layout");
+
+}
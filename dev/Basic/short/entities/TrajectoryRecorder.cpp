@@ -0,0 +1,159 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "TrajectoryRecorder.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <boost/bind.hpp>
+#include "config/ST_Config.hpp"
+#include "logging/Log.hpp"
+
+using namespace sim_mob;
+
+TrajectoryRecorder* sim_mob::TrajectoryRecorder::instance = nullptr;
+
+const char sim_mob::TrajectoryRecorder::MAGIC[8] = { 'S', 'M', 'T', 'R', 'A', 'J', '\0', '\0' };
+
+const unsigned int sim_mob::TrajectoryRecorder::MAX_PENDING_BUFFERS;
+
+void sim_mob::TrajectoryRecorder::init(const TrajectoryOutput& config, unsigned int baseGranMS)
+{
+    if (config.enabled && !instance)
+    {
+        instance = new TrajectoryRecorder(config, baseGranMS);
+    }
+}
+
+void sim_mob::TrajectoryRecorder::close()
+{
+    delete instance;
+    instance = nullptr;
+}
+
+sim_mob::TrajectoryRecorder::TrajectoryRecorder(const TrajectoryOutput& config, unsigned int baseGranMS) :
+        config(config), intervalTicks(std::max(1u, config.interval / std::max(1u, baseGranMS))),
+        file(config.fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc), localBuffer(&releaseBuffer),
+        stopping(false), numWritten(0)
+{
+    if (!file.is_open())
+    {
+        throw std::runtime_error("TrajectoryRecorder: cannot open " + config.fileName);
+    }
+
+    const uint32_t header[2] = { TrajectoryRecord::FORMAT_VERSION, sizeof(TrajectoryRecord) };
+    file.write(MAGIC, sizeof(MAGIC));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    writer = boost::thread(boost::bind(&TrajectoryRecorder::writeRecords, this));
+}
+
+sim_mob::TrajectoryRecorder::~TrajectoryRecorder()
+{
+    {
+        boost::mutex::scoped_lock lock(buffersMutex);
+        for (std::vector<Buffer*>::iterator it = buffers.begin(); it != buffers.end(); it++)
+        {
+            if (!(*it)->empty())
+            {
+                submit(**it);
+            }
+            delete *it;
+        }
+        buffers.clear();
+    }
+
+    {
+        boost::mutex::scoped_lock lock(queueMutex);
+        stopping = true;
+        queueChanged.notify_all();
+    }
+    writer.join();
+    file.close();
+
+    Print() << "Trajectory output: " << numWritten << " positions written to " << config.fileName << std::endl;
+}
+
+void sim_mob::TrajectoryRecorder::record(const TrajectoryRecord& record)
+{
+    if (config.useBoundingBox
+            && (record.xPos < config.minX || record.xPos > config.maxX || record.yPos < config.minY || record.yPos > config.maxY))
+    {
+        return;
+    }
+
+    Buffer& buffer = getBuffer();
+    buffer.push_back(record);
+    if (buffer.size() >= config.bufferSize)
+    {
+        submit(buffer);
+    }
+}
+
+TrajectoryRecorder::Buffer& sim_mob::TrajectoryRecorder::getBuffer()
+{
+    Buffer* buffer = localBuffer.get();
+    if (!buffer)
+    {
+        buffer = new Buffer();
+        buffer->reserve(config.bufferSize);
+        localBuffer.reset(buffer);
+
+        boost::mutex::scoped_lock lock(buffersMutex);
+        buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void sim_mob::TrajectoryRecorder::submit(Buffer& records)
+{
+    boost::unique_lock<boost::mutex> lock(queueMutex);
+    while (pending.size() >= MAX_PENDING_BUFFERS)
+    {
+        queueChanged.wait(lock);
+    }
+
+    pending.push_back(Buffer());
+    pending.back().swap(records);
+    if (!freeBuffers.empty())
+    {
+        records.swap(freeBuffers.back());
+        freeBuffers.pop_back();
+    }
+    else
+    {
+        records.reserve(config.bufferSize);
+    }
+    queueChanged.notify_all();
+}
+
+void sim_mob::TrajectoryRecorder::writeRecords()
+{
+    boost::unique_lock<boost::mutex> lock(queueMutex);
+    while (true)
+    {
+        while (pending.empty() && !stopping)
+        {
+            queueChanged.wait(lock);
+        }
+        if (pending.empty())
+        {
+            break;
+        }
+
+        Buffer records;
+        records.swap(pending.front());
+        pending.pop_front();
+        queueChanged.notify_all();
+
+        lock.unlock();
+        file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(TrajectoryRecord));
+        numWritten += records.size();
+        records.clear();
+        lock.lock();
+
+        freeBuffers.push_back(Buffer());
+        freeBuffers.back().swap(records);
+    }
+}
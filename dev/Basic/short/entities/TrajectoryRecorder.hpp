@@ -0,0 +1,124 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <deque>
+#include <fstream>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/tss.hpp>
+#include "entities/TrajectoryRecord.hpp"
+
+namespace sim_mob
+{
+
+struct TrajectoryOutput;
+
+/**
+ * Records the positions of the drivers into a binary file, as a cheaper replacement of the per-tick text output
+ * (frame_tick_output) when the trajectories are only needed offline.
+ *
+ * Each worker thread fills its own preallocated buffer of fixed-size TrajectoryRecords. Full buffers are handed over
+ * to a writer thread, which appends them to the file while the worker continues with an empty buffer. Positions are
+ * only recorded every "interval" ms and, optionally, within a bounding box.
+ *
+ * The file holds a header followed by the records, grouped by worker buffer. The trajectory-convert tool
+ * (dev/tools/trajectory-convert) sorts them by frame and prints them in the visualiser or in a csv format.
+ */
+class TrajectoryRecorder : private boost::noncopyable
+{
+public:
+    /**
+     * creates the recorder, if enabled in the configuration
+     * @param config trajectory output settings
+     * @param baseGranMS duration of a tick
+     */
+    static void init(const TrajectoryOutput& config, unsigned int baseGranMS);
+
+    /**
+     * @return the recorder, or null if the trajectory output is disabled
+     */
+    static TrajectoryRecorder* getInstance()
+    {
+        return instance;
+    }
+
+    /**
+     * writes all buffered records, closes the file and destroys the recorder.
+     * Must be called once the workers are done recording.
+     */
+    static void close();
+
+    /**
+     * @return true if positions are to be recorded in the given frame
+     */
+    bool isDue(uint32_t frame) const
+    {
+        return frame % intervalTicks == 0;
+    }
+
+    /**
+     * records a position, unless it is outside the bounding box. Thread-safe.
+     */
+    void record(const TrajectoryRecord& record);
+
+    /// file header: "SMTRAJ" followed by two null characters, the format version and the record size (32 bit each)
+    static const char MAGIC[8];
+
+private:
+    typedef std::vector<TrajectoryRecord> Buffer;
+
+    TrajectoryRecorder(const TrajectoryOutput& config, unsigned int baseGranMS);
+    ~TrajectoryRecorder();
+
+    /**
+     * @return the buffer of the calling thread
+     */
+    Buffer& getBuffer();
+
+    /**
+     * queues the records of a buffer for writing and replaces them by an empty buffer
+     */
+    void submit(Buffer& records);
+
+    void writeRecords();
+
+    /// buffers are owned by the recorder, not by their thread
+    static void releaseBuffer(Buffer*)
+    {
+    }
+
+    static TrajectoryRecorder* instance;
+
+    /// maximum number of full buffers waiting to be written; workers block beyond that
+    static const unsigned int MAX_PENDING_BUFFERS = 64;
+
+    const TrajectoryOutput& config;
+    unsigned int intervalTicks;
+
+    std::ofstream file;
+
+    boost::thread_specific_ptr<Buffer> localBuffer;
+
+    /// buffers of all threads
+    std::vector<Buffer*> buffers;
+    boost::mutex buffersMutex;
+
+    /// full buffers waiting to be written, and written buffers ready for reuse
+    std::deque<Buffer> pending;
+    std::vector<Buffer> freeBuffers;
+    bool stopping;
+    boost::mutex queueMutex;
+    boost::condition_variable queueChanged;
+    boost::thread writer;
+
+    /// number of records written to the file; only accessed by the writer thread until it is joined
+    unsigned long numWritten;
+};
+
+}
@@ -52,7 +52,7 @@ const unsigned int sim_mob::Broker::EventNewAndroidClient = 95000;
 
 
 sim_mob::Broker::Broker(const MutexStrategy& mtxStrat, int id) :
-        Agent(mtxStrat, id), numAgents(0), connection(*this)
+        Agent(mtxStrat, id), numAgents(0), connection(*this), currTick(0)
 {
     //Various Initializations
     configure();
@@ -160,21 +160,12 @@ void sim_mob::Broker::onMessageReceived(boost::shared_ptr<ConnectionHandler> cnn
     for (int i=0; i<conglom.getCount(); i++) {
         MessageBase mb = conglom.getBaseMessage(i);
         if (mb.msg_type == "ticked_client") {
-            boost::unique_lock<boost::mutex> lock(mutex_clientDone);
-            {
-            boost::unique_lock<boost::mutex> lock(mutex_client_done_chk);
-            std::map<boost::shared_ptr<sim_mob::ConnectionHandler>, ConnClientStatus>::iterator chkIt = clientDoneChecklist.find(cnnHandler);
-            if (chkIt==clientDoneChecklist.end()) {
-                throw std::runtime_error("Unexpected client/connection mapping.");
-            }
-            chkIt->second.done++;
-            } //mutex_client_done_chk unlocks
-
-            if (EnableDebugOutput) {
+            //Only wakes the Broker once the last outstanding client is done.
+            if (!readyClients.acknowledge(cnnHandler)) {
+                Warn() <<"Unexpected \"ticked_client\" from connection [" <<&(*cnnHandler) << "]; it was not sent a \"ticked_simmob\".\n";
+            } else if (EnableDebugOutput) {
                 Print() << "connection [" <<&(*cnnHandler) << "] DONE\n";
             }
-
-            COND_VAR_CLIENT_DONE.notify_one();
         } else if (mb.msg_type == "new_client") {
             //Send out an immediate message query; don't pend the outgoing message.
             WhoAreYouProtocol::QueryAgentAsync(cnnHandler);
@@ -190,6 +181,7 @@ void sim_mob::Broker::onMessageReceived(boost::shared_ptr<ConnectionHandler> cnn
             sim_mob::ClientRegistrationRequest candidate;
             candidate.clientID = msg.id;
             candidate.client_type = msg.type;
+            candidate.updateFrequency = msg.updateFrequency;
             for (size_t i=0; i<msg.services.size(); i++) {
                 candidate.requiredServices.insert(Services::GetServiceType(msg.services[i]));
             }
@@ -310,6 +302,9 @@ void sim_mob::Broker::insertClientList(const std::string& clientID, const std::s
     clientDoneChecklist[clientHandler->connHandle].total++;
     numAgents++;
 
+    //Schedule its updates, starting with the current time tick.
+    readyClients.add(clientHandler, clientHandler->updateFrequency, currTick);
+
     //publish an event to inform- interested parties- of the registration of a new android client
     if (cType==Broker::ClientTypeAndroid) {
         registrationPublisher.publish(Broker::EventNewAndroidClient, ClientRegistrationEventArgs(clientHandler));
@@ -434,6 +429,7 @@ void sim_mob::Broker::unRegisterEntity(sim_mob::Agent* agent)
             //      like we have a "preRegister". ~Seth
             it->second->agent = nullptr;
             it->second->setValidation(false);
+            readyClients.remove(it->second);
 
             //Update the connection count too.
             boost::unique_lock<boost::mutex> lock(mutex_client_done_chk);
@@ -445,6 +441,7 @@ void sim_mob::Broker::unRegisterEntity(sim_mob::Agent* agent)
             numAgents--;
             if (chkIt->second.total==0) {
                 it->second->connHandle->invalidate(); //this is even more important
+                readyClients.cancel(it->second->connHandle);
             }
         }
     }
@@ -649,17 +646,24 @@ void sim_mob::Broker::processPublishers(timeslice now)
     //Create a single Time message.
     //std::string timeMsg = CommsimSerializer::makeTimeData(now.frame(), ConfigManager::GetInstance().FullConfig().baseGranMS());
 
-    //Create a single AllLocations message.
-    std::map<unsigned int, Point> allLocs;
-    for (std::map<const Agent*, AgentInfo>::const_iterator it=registeredAgents.begin(); it!=registeredAgents.end(); it++) {
-        allLocs[it->first->getId()] = Point(it->first->xPos.get(), it->first->yPos.get());
+    //Only clients that are due on this tick are published to; the rest wait for their next update.
+    boost::shared_ptr<sim_mob::ClientHandler> ns3Handler;
+    if (registeredNs3Clients.size() == 1) {
+        ns3Handler = registeredNs3Clients.begin()->second;
     }
-    std::string allLocMsg = CommsimSerializer::makeAllLocations(allLocs);
+    bool ns3Due = false;
+
+    //Process all due clients for messages.
+    const std::vector< boost::shared_ptr<sim_mob::ClientHandler> >& dueClients = readyClients.beginTick(now.frame());
+    for (std::vector< boost::shared_ptr<sim_mob::ClientHandler> >::const_iterator it=dueClients.begin(); it!=dueClients.end(); it++) {
+        //The ns-3 client is handled below.
+        const boost::shared_ptr<sim_mob::ClientHandler>& cHandler = *it;
+        if (cHandler == ns3Handler) {
+            ns3Due = true;
+            continue;
+        }
 
-    //Process all clients for messages.
-    for (ClientList::Type::const_iterator it=registeredAndroidClients.begin(); it!=registeredAndroidClients.end(); it++) {
         //Skip dead Agents.
-        const boost::shared_ptr<sim_mob::ClientHandler>& cHandler = it->second;
         if(!(cHandler && cHandler->agent && cHandler->isValid())) {
             continue;
         }
@@ -673,7 +677,7 @@ void sim_mob::Broker::processPublishers(timeslice now)
                 loc = trans->transform(Point(cHandler->agent->xPos.get(), cHandler->agent->yPos.get()));
             }
 
-            insertSendBuffer(cHandler, CommsimSerializer::makeLocation(cHandler->agent->xPos.get(), cHandler->agent->yPos.get(), loc));
+            insertSendBuffer(cHandler, CommsimSerializer::makeLocation(cHandler->agent->xPos.get(), cHandler->agent->yPos.get(), loc, cHandler->binaryMessages));
         }
         if (cHandler->regisRegionPath) {
             if (cHandler->agent->getRegionSupportStruct().isEnabled()) {
@@ -683,17 +687,21 @@ void sim_mob::Broker::processPublishers(timeslice now)
                 std::vector<sim_mob::RoadRunnerRegion> all_regions = const_cast<Agent*>(cHandler->agent)->getAndClearNewAllRegionsSet();
                 std::vector<sim_mob::RoadRunnerRegion> reg_path = const_cast<Agent*>(cHandler->agent)->getAndClearNewRegionPath();
                 if (!(all_regions.empty() && reg_path.empty())) {
-                    insertSendBuffer(cHandler, CommsimSerializer::makeRegionsAndPath(all_regions, reg_path));
+                    insertSendBuffer(cHandler, CommsimSerializer::makeRegionsAndPath(all_regions, reg_path, cHandler->binaryMessages));
                 }
             }
         }
     }
 
-    //"All locations" only applies to the ns-3 client.
-    if (registeredNs3Clients.size() == 1) {
-        boost::shared_ptr<sim_mob::ClientHandler> ns3Handler = registeredNs3Clients.begin()->second;
+    //"All locations" only applies to the ns-3 client. (New agents are held until its next update.)
+    if (ns3Due) {
         if (ns3Handler->regisAllLocations) {
-            insertSendBuffer(ns3Handler, allLocMsg);
+            //Create a single AllLocations message, in whichever format ns-3 asked for.
+            std::map<unsigned int, Point> allLocs;
+            for (std::map<const Agent*, AgentInfo>::const_iterator it=registeredAgents.begin(); it!=registeredAgents.end(); it++) {
+                allLocs[it->first->getId()] = Point(it->first->xPos.get(), it->first->yPos.get());
+            }
+            insertSendBuffer(ns3Handler, CommsimSerializer::makeAllLocations(allLocs, ns3Handler->binaryMessages));
         }
 
         //Create a single "new agents" message, if appropriate.
@@ -701,7 +709,7 @@ void sim_mob::Broker::processPublishers(timeslice now)
         {
         boost::unique_lock<boost::mutex> lock(mutex_new_agents_message);
         if (!new_agents_message.empty()) {
-            newAgentsMessage = CommsimSerializer::makeNewAgents(new_agents_message, std::vector<unsigned int>());
+            newAgentsMessage = CommsimSerializer::makeNewAgents(new_agents_message, std::vector<unsigned int>(), ns3Handler->binaryMessages);
             new_agents_message.clear();
         }
         }
@@ -718,9 +726,23 @@ void sim_mob::Broker::sendReadyToReceive(timeslice now)
     //NOTE: This is slightly different than how the previous code did it, but it *should* work.
     //It will at least fail predictably: if the simulator freezes in the first time tick for a new agent, this is where to look.
     //TODO: We need a better way of tracking <client,destAgentID> pairs anyway; that fix will likely simplify this function.
+    //Every client due on this tick is sent a "ticked_simmob", even with nothing else to send. Clients that are not due
+    //  only get one if something was queued for them (e.g., an opaque message); both kinds must then respond.
+    const std::vector< boost::shared_ptr<sim_mob::ClientHandler> >& dueClients = readyClients.getReady();
+    for (std::vector< boost::shared_ptr<sim_mob::ClientHandler> >::const_iterator it=dueClients.begin(); it!=dueClients.end(); it++) {
+        const boost::shared_ptr<sim_mob::ClientHandler>& client = *it;
+        if (client && client->connHandle && client->isValid() && client->connHandle->isValid()) {
+            boost::unique_lock<boost::mutex> lock(mutex_send_buffer);
+            if (sendBuffer.find(client)==sendBuffer.end()) {
+                CommsimSerializer::serialize_begin(sendBuffer[client], client->clientId);
+            }
+        }
+    }
+
     std::map<SendBuffer::Key, std::string> pendingMessages;
     for (std::map<SendBuffer::Key, OngoingSerialization>::const_iterator it=sendBuffer.begin(); it!=sendBuffer.end(); it++) {
-        pendingMessages[it->first] = CommsimSerializer::makeTickedSimMob(now.frame(), ConfigManager::GetInstance().FullConfig().baseGranMS());
+        pendingMessages[it->first] = CommsimSerializer::makeTickedSimMob(now.frame(), ConfigManager::GetInstance().FullConfig().baseGranMS(), it->first->binaryMessages);
+        readyClients.expect(it->first->connHandle);
     }
 
     for (std::map<SendBuffer::Key, std::string>::const_iterator it=pendingMessages.begin(); it!=pendingMessages.end(); it++) {
@@ -829,43 +851,15 @@ void sim_mob::Broker::waitForAgentsUpdates()
 }
 
 
-bool sim_mob::Broker::allClientsAreDone()
-{
-    boost::shared_ptr<sim_mob::ClientHandler> clnHandler;
-    boost::unique_lock<boost::mutex> lock(mutex_clientList);
-
-    for (ClientList::Type::const_iterator it=registeredAndroidClients.begin(); it!=registeredAndroidClients.end(); it++) {
-        clnHandler = it->second;
-        //If we have a valid client handler.
-        if (clnHandler && clnHandler->isValid()) {
-            //...and a valid connection handler.
-            if (clnHandler->connHandle && clnHandler->connHandle->isValid()) {
-                //Check if this connection's "done" count equals its "total" known agent count.
-                //TODO: This actually checks the same connection handler multiple times if connections are multiplexed
-                //      (one for each ClientHandler). This is harmless, but inefficient.
-                boost::unique_lock<boost::mutex> lock(mutex_client_done_chk);
-                std::map<boost::shared_ptr<sim_mob::ConnectionHandler>, ConnClientStatus>::iterator chkIt = clientDoneChecklist.find(clnHandler->connHandle);
-                if (chkIt==clientDoneChecklist.end()) {
-                    throw std::runtime_error("Client somehow registered without a valid connection handler.");
-                }
-                if (chkIt->second.done < chkIt->second.total) {
-                    if (EnableDebugOutput) {
-                        Print() << "connection [" <<&(*clnHandler->connHandle) << "] not done yet: " <<chkIt->second.done <<" of " <<chkIt->second.total <<"\n";
-                    }
-                    return false;
-                }
-            }
-        }
-    }
-    return true;
-}
-
 Entity::UpdateStatus sim_mob::Broker::update(timeslice now)
 {
     if (EnableDebugOutput) {
         Print() << "Broker tick:" << now.frame() << std::endl;
     }
 
+    //New clients registered on this tick are first due on this tick.
+    currTick = now.frame();
+
     //step-1 : Create/start the thread if this is the first frame.
     //TODO: transfer this to frame_init
     if (now.frame() == 0) {
@@ -975,21 +969,13 @@ void sim_mob::Broker::setNewClientProps()
 
 void sim_mob::Broker::waitForClientsDone()
 {
-    boost::unique_lock<boost::mutex> lock(mutex_clientDone);
-    while (!allClientsAreDone()) {
-        COND_VAR_CLIENT_DONE.wait(lock);
-    }
+    //Only the connections that were sent a "ticked_simmob" on this tick are waited on.
+    readyClients.waitForAcknowledgements();
 }
 
 void sim_mob::Broker::cleanup()
 {
-    {
-    boost::unique_lock<boost::mutex> lock(mutex_client_done_chk);
-    std::map<boost::shared_ptr<sim_mob::ConnectionHandler>, ConnClientStatus>::iterator chkIt = clientDoneChecklist.begin();
-    for (;chkIt!=clientDoneChecklist.end(); chkIt++) {
-        chkIt->second.done = 0;
-    }
-    }
+    readyClients.endTick();
 
     //Reset any "done" flags on the preRegisteredAgents array --they were done for the "last" time tick.
     {
@@ -13,6 +13,7 @@
 #include "conf/ConfigParams.hpp"
 
 #include "entities/Agent.hpp"
+#include "entities/commsim/broker/ClientReadySet.hpp"
 #include "entities/commsim/client/ClientRegistration.hpp"
 #include "entities/commsim/service/Services.hpp"
 #include "entities/commsim/message/Handlers.hpp"
@@ -160,11 +161,10 @@ protected:
             request(request), existingConn(existingConn) {}
     };
 
-    ///Helper struct for checking if a Connection has received updates from all its Clients.
+    ///Helper struct for tracking how many Clients are multiplexed onto a Connection.
     struct ConnClientStatus {
         int total;
-        int done;
-        ConnClientStatus() : total(0), done(0) {}
+        ConnClientStatus() : total(0) {}
     };
 
     ///A list of cloud connections by ConnectionHandler.
@@ -241,11 +241,17 @@ protected:
     ///Helper class used to handle client registration.
     ClientRegistrationHandler registrationHandler;
 
-    ///This map tracks the number of ClientHandlers connected per ConnectionHandler, as well as the number (per tick)
-    ///  that have already sent the CLIENT_MESSAGES_DONE message. It is locked by its associated mutex.
+    ///This map tracks the number of ClientHandlers connected per ConnectionHandler. It is locked by its associated mutex.
     std::map<boost::shared_ptr<sim_mob::ConnectionHandler>, ConnClientStatus> clientDoneChecklist;
     boost::mutex mutex_client_done_chk;
 
+    ///The clients due to be updated on this time tick (by their update frequency), and the "ticked_client" messages
+    ///  still outstanding from their connections.
+    ClientReadySet< boost::shared_ptr<sim_mob::ClientHandler>, boost::shared_ptr<sim_mob::ConnectionHandler> > readyClients;
+
+    ///The time tick currently being processed; new clients are first due on this tick.
+    uint32_t currTick;
+
     ///New agents to be sent this time tick (we need to multiplex them to avoid overwhelming the message count).
     std::vector<unsigned int> new_agents_message;
     boost::mutex mutex_new_agents_message;
@@ -260,10 +266,8 @@ protected:
 
     //various controlling mutexes and condition variables
     boost::mutex mutex_clientList;
-    boost::mutex mutex_clientDone;
     boost::mutex mutex_agentDone;
     boost::condition_variable COND_VAR_CLIENT_REQUEST;
-    boost::condition_variable COND_VAR_CLIENT_DONE;
 
     //Number of connected Agents (entities which respond with a WHOAMI).
     //TODO: We should probably remove this; doesn't one of our data structures contain this?
@@ -378,11 +382,6 @@ protected:
      */
     void waitForAgentsUpdates();
 
-    /**
-     *  wait for a message from all of the registered the client stating that they are done sending messages for this tick
-     */
-    bool allClientsAreDone();
-
     /**
      * Deactivate an Agent. This will render it "invalid" for the current time tick.
      * This function is called when an EVT_CORE_AGENT_DIED event arrives; that occurs at the
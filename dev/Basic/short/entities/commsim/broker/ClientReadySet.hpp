@@ -0,0 +1,171 @@
+//Copyright (c) 2014 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+
+namespace sim_mob {
+
+/**
+ * Tracks which clients have work on the current time tick, so that the Broker's per-tick cost follows the number
+ *   of active clients rather than the number of registered ones.
+ * Each client is filed under the next tick it is due on (it declares an update frequency of one update every N ticks);
+ *   beginTick() takes the clients filed under the current tick as the ready set and re-files them for their next update.
+ * The ready set also counts the acknowledgements (ticked_client) still outstanding for this tick, per connection,
+ *   so that the Broker can sleep until the last one arrives rather than re-scanning every client on each wake-up.
+ *
+ * THREADING: Acknowledgements arrive on the io_service threads; everything else is called by the Broker. Both halves
+ *   are locked separately, since unRegisterEntity() may also remove clients while the Broker is busy.
+ */
+template <class Client, class Connection>
+class ClientReadySet {
+public:
+    ClientReadySet() : pendingConnections(0) {}
+
+    ///Schedule a client. It is first due on "firstTick", and then once every "updateFrequency" ticks.
+    void add(const Client& client, unsigned int updateFrequency, unsigned int firstTick) {
+        boost::lock_guard<boost::mutex> lock(scheduleLOCK);
+        schedule[firstTick].push_back(std::make_pair(client, updateFrequency>0?updateFrequency:1));
+    }
+
+    ///Stop scheduling a client. It is dropped the next time it comes due (so this is O(1) now).
+    void remove(const Client& client) {
+        boost::lock_guard<boost::mutex> lock(scheduleLOCK);
+        removed.insert(client);
+    }
+
+    ///Start a new time tick: every client due on (or before) this tick becomes ready, and is re-filed for its next update.
+    ///\param tick The current time tick.
+    ///\returns the clients that are due on this tick. Valid until the next call to beginTick().
+    const std::vector<Client>& beginTick(unsigned int tick) {
+        boost::lock_guard<boost::mutex> lock(scheduleLOCK);
+        ready.clear();
+        while (!schedule.empty() && schedule.begin()->first <= tick) {
+            const unsigned int dueTick = schedule.begin()->first;
+            Bucket bucket;
+            bucket.swap(schedule.begin()->second);
+            schedule.erase(schedule.begin());
+
+            for (typename Bucket::const_iterator it=bucket.begin(); it!=bucket.end(); it++) {
+                typename std::set<Client>::iterator remIt = removed.find(it->first);
+                if (remIt!=removed.end()) {
+                    removed.erase(remIt);
+                    continue;
+                }
+
+                //Keep the client's phase, unless it has fallen behind (e.g., it was registered on an earlier tick).
+                unsigned int nextTick = dueTick + it->second;
+                if (nextTick <= tick) {
+                    nextTick = tick + it->second;
+                }
+                ready.push_back(it->first);
+                schedule[nextTick].push_back(*it);
+            }
+        }
+        return ready;
+    }
+
+    ///Retrieve the clients that were due on the current tick (see beginTick()).
+    const std::vector<Client>& getReady() const {
+        return ready;
+    }
+
+    ///Expect one more acknowledgement from this connection on the current tick.
+    void expect(const Connection& conn) {
+        boost::lock_guard<boost::mutex> lock(ackLOCK);
+        AckStatus& status = acks[conn];
+        if (status.done == status.expected) {
+            pendingConnections++;
+        }
+        status.expected++;
+    }
+
+    ///Record an acknowledgement from this connection. Wakes waitForAcknowledgements() only when the last one arrives.
+    ///\returns false if no (further) acknowledgement was expected from this connection on this tick.
+    bool acknowledge(const Connection& conn) {
+        boost::lock_guard<boost::mutex> lock(ackLOCK);
+        typename std::map<Connection, AckStatus>::iterator it = acks.find(conn);
+        if (it==acks.end() || it->second.done >= it->second.expected) {
+            return false;
+        }
+        it->second.done++;
+        if (it->second.done == it->second.expected) {
+            connectionDone();
+        }
+        return true;
+    }
+
+    ///Stop waiting on this connection for the current tick (e.g., the last client using it was removed).
+    void cancel(const Connection& conn) {
+        boost::lock_guard<boost::mutex> lock(ackLOCK);
+        typename std::map<Connection, AckStatus>::iterator it = acks.find(conn);
+        if (it!=acks.end()) {
+            if (it->second.done < it->second.expected) {
+                connectionDone();
+            }
+            acks.erase(it);
+        }
+    }
+
+    ///Sleep until every expected acknowledgement for this tick has arrived (or been cancelled).
+    void waitForAcknowledgements() {
+        boost::unique_lock<boost::mutex> lock(ackLOCK);
+        while (pendingConnections>0) {
+            allAcknowledged.wait(lock);
+        }
+    }
+
+    ///Forget this tick's acknowledgements. Only touches connections that were expected to respond.
+    void endTick() {
+        boost::lock_guard<boost::mutex> lock(ackLOCK);
+        acks.clear();
+        pendingConnections = 0;
+    }
+
+    ///Retrieve the number of connections that still owe an acknowledgement this tick.
+    size_t getPendingConnections() const {
+        boost::lock_guard<boost::mutex> lock(ackLOCK);
+        return pendingConnections;
+    }
+
+private:
+    ///Helper struct: the acknowledgements expected from (and received on) a connection during this tick.
+    struct AckStatus {
+        unsigned int expected;
+        unsigned int done;
+        AckStatus() : expected(0), done(0) {}
+    };
+
+    ///A list of <client, updateFrequency> pairs due on the same tick.
+    typedef std::vector< std::pair<Client, unsigned int> > Bucket;
+
+    //Called with ackLOCK held, when a connection has nothing left outstanding.
+    void connectionDone() {
+        if (--pendingConnections == 0) {
+            allAcknowledged.notify_all();
+        }
+    }
+
+    //Clients, by the next tick they are due on.
+    std::map<unsigned int, Bucket> schedule;
+    std::set<Client> removed;
+    std::vector<Client> ready;
+    boost::mutex scheduleLOCK;
+
+    //Acknowledgements, for connections that were sent a ticked_simmob this tick.
+    std::map<Connection, AckStatus> acks;
+    size_t pendingConnections;
+    mutable boost::mutex ackLOCK;
+    boost::condition_variable allAcknowledged;
+};
+
+}
@@ -49,6 +49,8 @@ public:
     bool regisLocation; ///<Has this Client registered for LOCATION_UPDATE events?
     bool regisRegionPath; ///<Has this Client registered for REGIONS_AND_PATHS events? (typically only RoadRunner)
     bool regisAllLocations; ///<Has this Client registered for ALL_LOCATIONS events? (typically only ns-3)
+    bool binaryMessages; ///<Did this Client ask for binary-formatted messages? (JSON otherwise)
+    unsigned int updateFrequency; ///<This Client is published to (and waited on) once every N ticks.
 };
 
 }
@@ -22,6 +22,7 @@ boost::shared_ptr<ClientHandler> sim_mob::ClientRegistrationHandler::makeClientH
     //Create a ClientHandler pointing to the Broker.
     boost::shared_ptr<ClientHandler> clientEntry(new ClientHandler(broker, connHandle,  freeAgent, request.clientID));
     clientEntry->setRequiredServices(request.requiredServices);
+    clientEntry->updateFrequency = request.updateFrequency;
 
     //Subscribe to relevant services for each required service.
     for (std::set<sim_mob::Services::SIM_MOB_SERVICE>::const_iterator it=request.requiredServices.begin(); it!=request.requiredServices.end(); it++) {
@@ -35,6 +36,9 @@ boost::shared_ptr<ClientHandler> sim_mob::ClientRegistrationHandler::makeClientH
             case sim_mob::Services::SIMMOB_SRV_ALL_LOCATIONS:
                 clientEntry->regisAllLocations = true;
                 break;
+            case sim_mob::Services::SIMMOB_SRV_BINARY_MESSAGES:
+                clientEntry->binaryMessages = true;
+                break;
             default:
                 Warn() <<"Client requested service which could not be provided.\n"; break;
         }
@@ -70,7 +74,7 @@ bool sim_mob::ClientRegistrationHandler::handle(BrokerBase& broker, sim_mob::Cli
     //Serialize a single "id_ack" message.
     OngoingSerialization ongoing;
     CommsimSerializer::serialize_begin(ongoing, boost::lexical_cast<std::string>(clientEntry->clientId));
-    CommsimSerializer::addGeneric(ongoing, CommsimSerializer::makeIdAck());
+    CommsimSerializer::addGeneric(ongoing, CommsimSerializer::makeIdAck(clientEntry->binaryMessages));
     BundleHeader hRes;
     std::string msg;
     CommsimSerializer::serialize_end(ongoing, hRes, msg);
@@ -109,7 +113,7 @@ void sim_mob::ClientRegistrationHandler::sendAgentsInfo(const std::map<const Age
 
     OngoingSerialization ongoing;
     CommsimSerializer::serialize_begin(ongoing, boost::lexical_cast<std::string>(clientEntry->clientId));
-    CommsimSerializer::addGeneric(ongoing, CommsimSerializer::makeNewAgents(keys, std::vector<unsigned int>()));
+    CommsimSerializer::addGeneric(ongoing, CommsimSerializer::makeNewAgents(keys, std::vector<unsigned int>(), clientEntry->binaryMessages));
 
     BundleHeader hRes;
     std::string msg;
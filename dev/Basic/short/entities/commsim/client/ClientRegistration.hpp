@@ -27,6 +27,9 @@ struct ClientRegistrationRequest {
     std::string clientID;
     std::string client_type; ///<ns-3 or android.
     std::set<sim_mob::Services::SIM_MOB_SERVICE> requiredServices;
+    unsigned int updateFrequency; ///<Update this client every N ticks.
+
+    ClientRegistrationRequest() : updateFrequency(1) {}
 };
 
 
@@ -201,7 +201,7 @@ void sim_mob::OpaqueSendHandler::handle(boost::shared_ptr<ConnectionHandler> han
             }
 
             //Serialize the message, send it.
-            std::string msg = CommsimSerializer::makeOpaqueSend(sendMsg.fromId, sendMsg.toIds, sendMsg.format, sendMsg.tech, sendMsg.broadcast, sendMsg.data);
+            std::string msg = CommsimSerializer::makeOpaqueSend(sendMsg.fromId, sendMsg.toIds, sendMsg.format, sendMsg.tech, sendMsg.broadcast, sendMsg.data, ns3Handle->binaryMessages);
             broker->insertSendBuffer(ns3Handle, msg);
         } else {
             //Iterate through all registered clients
@@ -220,7 +220,7 @@ void sim_mob::OpaqueSendHandler::handle(boost::shared_ptr<ConnectionHandler> han
                 //step-4: fabricate a message for each(core  is taken from the original message)
                 //actually, you don't need to modify any field in the original jsoncpp's Json::Value message.
                 //just add the recipients directly request to send
-                std::string msg = CommsimSerializer::makeOpaqueReceive(sendMsg.fromId, agentId, sendMsg.format, sendMsg.tech, sendMsg.data);
+                std::string msg = CommsimSerializer::makeOpaqueReceive(sendMsg.fromId, agentId, sendMsg.format, sendMsg.tech, sendMsg.data, destClientHandlr->binaryMessages);
                 broker->insertSendBuffer(boost::shared_ptr<ClientHandler>(destClientHandlr), msg);
             }
         }
@@ -258,7 +258,7 @@ void sim_mob::OpaqueReceiveHandler::handleDirect(const OpaqueReceiveMessage& rec
 
     //insert into sending buffer
     if (receiveAgentHandle && receiveAgentHandle->connHandle) {
-        broker->insertSendBuffer(receiveAgentHandle, CommsimSerializer::makeOpaqueReceive(recMsg.fromId, recMsg.toId, recMsg.format, recMsg.tech, recMsg.data));
+        broker->insertSendBuffer(receiveAgentHandle, CommsimSerializer::makeOpaqueReceive(recMsg.fromId, recMsg.toId, recMsg.format, recMsg.tech, recMsg.data, receiveAgentHandle->binaryMessages));
     } else {
         Warn() <<"Could not find a receive (cloud) handler for agent with ID: " <<recMsg.toId <<"\n";
     }
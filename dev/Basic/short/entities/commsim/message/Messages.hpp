@@ -45,8 +45,9 @@ struct IdResponseMessage : public sim_mob::MessageBase {
     std::string id;  ///<The id this client is requesting.
     std::string type; ///<The "type" of client (android, ns3).
     std::vector<std::string> services;  ///<List of services required by this client.
+    unsigned int updateFrequency; ///<The client wants an update every N ticks (optional; 1 = every tick).
 
-    IdResponseMessage(const MessageBase& base) : MessageBase(base) {}
+    IdResponseMessage(const MessageBase& base) : MessageBase(base), updateFrequency(1) {}
 };
 
 ///Used to inform ns-3 that agents have been added to or removed from the simulation.
@@ -17,10 +17,38 @@ const bool NEW_BUNDLES = true;
 
 ///Whether to prefer binary messages in v1 bundles (only applies to serialization).
 ///NOTE: Unlike NEW_BUNDLES, this flag will remain relevant after we switch to v1.
-///      There will eventually be more fine-grained control over individual message serialization
-///      (e.g., a way of "registering" serialization protocols), but for now we simply turn it "on" or "off".
+///      This is only the default; clients that list "srv_binary_messages" in their id_response are
+///      sent binary messages regardless, and everyone else gets JSON.
 const bool PREFER_BINARY_MESSAGES = false;
 
+///The first byte of every binary-formatted v1 message (JSON messages always start with '{').
+const unsigned char BINARY_MESSAGE_MARKER = 0xBB;
+
+///Fixed message type codes for binary-formatted v1 messages. This is the byte following BINARY_MESSAGE_MARKER.
+///The remaining fields are packed, in order, as little-endian values:
+///   integers are 4 bytes, doubles are 8 bytes (IEEE 754), booleans are 1 byte,
+///   strings are a 4-byte length followed by the raw characters (no escaping),
+///   and lists are a 4-byte count followed by each item.
+///NOTE: These values are part of the wire format; append new types, and never re-number existing ones.
+enum BINARY_MESSAGE_TYPE {
+    BIN_MSG_ID_REQUEST = 1,       ///<token
+    BIN_MSG_ID_RESPONSE = 2,      ///<token, id, type, services[], update_frequency
+    BIN_MSG_ID_ACK = 3,           ///<(no fields)
+    BIN_MSG_TICKED_SIMMOB = 4,    ///<tick, elapsed
+    BIN_MSG_TICKED_CLIENT = 5,    ///<(no fields)
+    BIN_MSG_NEW_CLIENT = 6,       ///<(no fields)
+    BIN_MSG_LOCATION = 7,         ///<x, y, lat, lng
+    BIN_MSG_REGIONS_AND_PATH = 8, ///<regions[id, vertices[lat, lng]], path[id]
+    BIN_MSG_NEW_AGENTS = 9,       ///<add[], rem[]
+    BIN_MSG_ALL_LOCATIONS = 10,   ///<locations[id, x, y]
+    BIN_MSG_OPAQUE_SEND = 11,     ///<from_id, to_ids[], format, tech, broadcast, data
+    BIN_MSG_OPAQUE_RECEIVE = 12,  ///<from_id, to_id, format, tech, data
+    BIN_MSG_REMOTE_LOG = 13,      ///<log_msg
+    BIN_MSG_REROUTE_REQUEST = 14, ///<blacklisted
+    BIN_MSG_TCP_CONNECT = 15,     ///<host, port
+    BIN_MSG_TCP_DISCONNECT = 16,  ///<host, port
+};
+
 ///The size of a fixed length header.
 ///Fortunately, both v0 and v1 headers are 8 bytes.
 const unsigned int header_length = 8;
@@ -4,7 +4,9 @@
 
 #include "CommsimSerializer.hpp"
 
+#include <cstring>
 #include <sstream>
+#include <boost/cstdint.hpp>
 #include <boost/lexical_cast.hpp>
 
 #include "geospatial/coord/CoordinateTransform.hpp"
@@ -18,6 +20,131 @@ namespace {
 //Copies of nonary messages.
 const std::string IdAckMsg ="{\"msg_type\":\"id_ack\"}";
 
+//The msg_type string for each BINARY_MESSAGE_TYPE, indexed by type code.
+const char* const BinaryMessageNames[] = {
+    "", "id_request", "id_response", "id_ack", "ticked_simmob", "ticked_client", "new_client", "location",
+    "regions_and_path", "new_agents", "all_locations", "opaque_send", "opaque_receive", "remote_log",
+    "reroute_request", "tcp_connect", "tcp_disconnect"
+};
+const size_t BinaryMessageNamesCount = sizeof(BinaryMessageNames)/sizeof(BinaryMessageNames[0]);
+
+
+///Builds a binary message: the marker, the type code, and then each field in little-endian order.
+class BinaryWriter {
+public:
+    explicit BinaryWriter(BINARY_MESSAGE_TYPE type) {
+        res.push_back(static_cast<char>(BINARY_MESSAGE_MARKER));
+        res.push_back(static_cast<char>(type));
+    }
+
+    void addUInt(boost::uint32_t val) {
+        for (int i=0; i<4; i++) {
+            res.push_back(static_cast<char>((val>>(8*i))&0xFF));
+        }
+    }
+
+    void addInt(int val) {
+        addUInt(static_cast<boost::uint32_t>(val));
+    }
+
+    void addDouble(double val) {
+        boost::uint64_t bits;
+        std::memcpy(&bits, &val, sizeof(bits));
+        for (int i=0; i<8; i++) {
+            res.push_back(static_cast<char>((bits>>(8*i))&0xFF));
+        }
+    }
+
+    void addBool(bool val) {
+        res.push_back(val?1:0);
+    }
+
+    void addString(const std::string& val) {
+        addUInt(val.size());
+        res.append(val);
+    }
+
+    const std::string& str() const {
+        return res;
+    }
+
+private:
+    std::string res;
+};
+
+
+///Reads the fields of a binary message back in the order they were written. Throws if the message is too short.
+class BinaryReader {
+public:
+    BinaryReader(const MessageConglomerate& msg, int msgNumber) {
+        int offset = 0;
+        int length = 0;
+        msg.getRawMessage(msgNumber, offset, length);
+        curr = reinterpret_cast<const unsigned char*>(msg.getUnderlyingString().data()) + offset;
+        end = curr + length;
+
+        //The marker and type were already checked when the message was added; skip them.
+        require(2);
+        curr += 2;
+    }
+
+    boost::uint32_t getUInt() {
+        require(4);
+        boost::uint32_t res = 0;
+        for (int i=0; i<4; i++) {
+            res |= static_cast<boost::uint32_t>(curr[i])<<(8*i);
+        }
+        curr += 4;
+        return res;
+    }
+
+    int getInt() {
+        return static_cast<int>(getUInt());
+    }
+
+    double getDouble() {
+        require(8);
+        boost::uint64_t bits = 0;
+        for (int i=0; i<8; i++) {
+            bits |= static_cast<boost::uint64_t>(curr[i])<<(8*i);
+        }
+        curr += 8;
+        double res;
+        std::memcpy(&res, &bits, sizeof(res));
+        return res;
+    }
+
+    bool getBool() {
+        require(1);
+        return *(curr++) != 0;
+    }
+
+    std::string getString() {
+        boost::uint32_t len = getUInt();
+        require(len);
+        std::string res(reinterpret_cast<const char*>(curr), len);
+        curr += len;
+        return res;
+    }
+
+    ///Call once all fields have been read; extra bytes mean the sender and receiver disagree on the layout.
+    void finish() const {
+        if (curr != end) {
+            throw std::runtime_error("Binary message contains unexpected trailing data.");
+        }
+    }
+
+private:
+    void require(size_t count) const {
+        if (static_cast<size_t>(end-curr) < count) {
+            throw std::runtime_error("Binary message is truncated.");
+        }
+    }
+
+    const unsigned char* curr;
+    const unsigned char* end;
+};
+
 } //End un-named namespace
 
 
@@ -58,8 +185,16 @@ void sim_mob::MessageConglomerate::addMessage(int offset, int length, const std:
 
     //Check the first character to determine the type (binary/json).
     const char* raw = messages_v1.c_str();
-    if (static_cast<unsigned char>(raw[offset]) == 0xBB) {
-        throw std::runtime_error("Base (v1) message binary format not yet supported.");
+    if (static_cast<unsigned char>(raw[offset]) == BINARY_MESSAGE_MARKER) {
+        //The type code follows the marker; the JSON value is left null so that parseX() knows to read binary.
+        if (length<2) {
+            throw std::runtime_error("Binary message is missing its type code.");
+        }
+        const unsigned char type = static_cast<unsigned char>(raw[offset+1]);
+        if (type==0 || type>=BinaryMessageNamesCount) {
+            throw std::runtime_error("Unknown binary message type code.");
+        }
+        message_bases.back().msg_type = BinaryMessageNames[type];
     } else if (static_cast<unsigned char>(raw[offset]) == '{') {
         Json::Reader reader;
         if (!reader.parse(&raw[offset], &raw[offset+length], messages_json.back(), false)) {
@@ -302,8 +437,22 @@ sim_mob::IdResponseMessage sim_mob::CommsimSerializer::parseIdResponse(const Mes
         for (unsigned int i=0; i<jsMsg["services"].size(); i++) {
             res.services.push_back(jsMsg["services"][i].asString());
         }
+
+        //Optional props.
+        if (jsMsg.isMember("update_frequency")) {
+            res.updateFrequency = jsMsg["update_frequency"].asUInt();
+        }
     } else {
-        throw std::runtime_error("parse() for binary messages not yet supported.");
+        BinaryReader rd(msg, msgNumber);
+        res.token = rd.getString();
+        res.id = rd.getString();
+        res.type = rd.getString();
+        const boost::uint32_t count = rd.getUInt();
+        for (boost::uint32_t i=0; i<count; i++) {
+            res.services.push_back(rd.getString());
+        }
+        res.updateFrequency = rd.getUInt();
+        rd.finish();
     }
 
     return res;
@@ -324,7 +473,9 @@ sim_mob::RerouteRequestMessage sim_mob::CommsimSerializer::parseRerouteRequest(c
         //Save and return.
         res.blacklistRegion = jsMsg["blacklisted"].asString();
     } else {
-        throw std::runtime_error("parse() for binary messages not yet supported.");
+        BinaryReader rd(msg, msgNumber);
+        res.blacklistRegion = rd.getString();
+        rd.finish();
     }
     return res;
 }
@@ -352,13 +503,23 @@ sim_mob::OpaqueSendMessage sim_mob::CommsimSerializer::parseOpaqueSend(const Mes
         for (unsigned int i=0; i<toIds.size(); i++) {
             res.toIds.push_back(toIds[i].asString());
         }
-
-        //Fail-safe
-        if (res.broadcast && !res.toIds.empty()) {
-            throw std::runtime_error("Cannot call opaque_send with both \"broadcast\" as true and a non-empty toIds list.");
-        }
     } else {
-        throw std::runtime_error("parse() for binary messages not yet supported.");
+        BinaryReader rd(msg, msgNumber);
+        res.fromId = rd.getString();
+        const boost::uint32_t count = rd.getUInt();
+        for (boost::uint32_t i=0; i<count; i++) {
+            res.toIds.push_back(rd.getString());
+        }
+        res.format = rd.getString();
+        res.tech = rd.getString();
+        res.broadcast = rd.getBool();
+        res.data = rd.getString();
+        rd.finish();
+    }
+
+    //Fail-safe
+    if (res.broadcast && !res.toIds.empty()) {
+        throw std::runtime_error("Cannot call opaque_send with both \"broadcast\" as true and a non-empty toIds list.");
     }
     return res;
 }
@@ -382,7 +543,13 @@ sim_mob::OpaqueReceiveMessage sim_mob::CommsimSerializer::parseOpaqueReceive(con
         res.tech = jsMsg["tech"].asString();
         res.data = jsMsg["data"].asString();
     } else {
-        throw std::runtime_error("parse() for binary messages not yet supported.");
+        BinaryReader rd(msg, msgNumber);
+        res.fromId = rd.getString();
+        res.toId = rd.getString();
+        res.format = rd.getString();
+        res.tech = rd.getString();
+        res.data = rd.getString();
+        rd.finish();
     }
     return res;
 }
@@ -402,7 +569,9 @@ sim_mob::RemoteLogMessage sim_mob::CommsimSerializer::parseRemoteLog(const Messa
         //Save and return.
         res.logMessage = jsMsg["log_msg"].asString();
     } else {
-        throw std::runtime_error("parse() for binary messages not yet supported.");
+        BinaryReader rd(msg, msgNumber);
+        res.logMessage = rd.getString();
+        rd.finish();
     }
     return res;
 }
@@ -423,7 +592,10 @@ sim_mob::TcpConnectMessage sim_mob::CommsimSerializer::parseTcpConnect(const Mes
         res.host = jsMsg["host"].asString();
         res.port = jsMsg["port"].asInt();
     } else {
-        throw std::runtime_error("parse() for binary messages not yet supported.");
+        BinaryReader rd(msg, msgNumber);
+        res.host = rd.getString();
+        res.port = rd.getInt();
+        rd.finish();
     }
     return res;
 }
@@ -444,16 +616,21 @@ sim_mob::TcpDisconnectMessage sim_mob::CommsimSerializer::parseTcpDisconnect(con
         res.host = jsMsg["host"].asString();
         res.port = jsMsg["port"].asInt();
     } else {
-        throw std::runtime_error("parse() for binary messages not yet supported.");
+        BinaryReader rd(msg, msgNumber);
+        res.host = rd.getString();
+        res.port = rd.getInt();
+        rd.finish();
     }
     return res;
 }
 
 
-std::string sim_mob::CommsimSerializer::makeIdRequest(const std::string& token)
+std::string sim_mob::CommsimSerializer::makeIdRequest(const std::string& token, bool binary)
 {
-    if (PREFER_BINARY_MESSAGES) {
-        throw std::runtime_error("addX() binary format not yet supported.");
+    if (binary) {
+        BinaryWriter res(BIN_MSG_ID_REQUEST);
+        res.addString(token);
+        return res.str();
     } else {
         std::stringstream res;
         res <<"{\"msg_type\":\"id_request\",\"token\":\"" <<token <<"\"}";
@@ -462,20 +639,23 @@ std::string sim_mob::CommsimSerializer::makeIdRequest(const std::string& token)
 }
 
 
-std::string sim_mob::CommsimSerializer::makeIdAck()
+std::string sim_mob::CommsimSerializer::makeIdAck(bool binary)
 {
-    if (PREFER_BINARY_MESSAGES) {
-        throw std::runtime_error("addX() binary format not yet supported.");
+    if (binary) {
+        return BinaryWriter(BIN_MSG_ID_ACK).str();
     } else {
         return IdAckMsg;
     }
 }
 
 
-std::string sim_mob::CommsimSerializer::makeTickedSimMob(unsigned int tick, unsigned int elapsedMs)
+std::string sim_mob::CommsimSerializer::makeTickedSimMob(unsigned int tick, unsigned int elapsedMs, bool binary)
 {
-    if (PREFER_BINARY_MESSAGES) {
-        throw std::runtime_error("addX() binary format not yet supported.");
+    if (binary) {
+        BinaryWriter res(BIN_MSG_TICKED_SIMMOB);
+        res.addUInt(tick);
+        res.addUInt(elapsedMs);
+        return res.str();
     } else {
         std::stringstream res;
         res <<"{\"msg_type\":\"ticked_simmob\",\"tick\":" <<tick <<",\"elapsed\":" <<elapsedMs <<"}";
@@ -485,10 +665,15 @@ std::string sim_mob::CommsimSerializer::makeTickedSimMob(unsigned int tick, unsi
 
 
 
-std::string sim_mob::CommsimSerializer::makeLocation(int x, int y, const LatLngLocation& projected)
+std::string sim_mob::CommsimSerializer::makeLocation(int x, int y, const LatLngLocation& projected, bool binary)
 {
-    if (PREFER_BINARY_MESSAGES) {
-        throw std::runtime_error("addX() binary format not yet supported.");
+    if (binary) {
+        BinaryWriter res(BIN_MSG_LOCATION);
+        res.addInt(x);
+        res.addInt(y);
+        res.addDouble(projected.latitude);
+        res.addDouble(projected.longitude);
+        return res.str();
     } else {
         std::stringstream res;
         res <<"{\"msg_type\":\"location\",\"x\":" <<x <<",\"y\":" <<y
@@ -499,10 +684,24 @@ std::string sim_mob::CommsimSerializer::makeLocation(int x, int y, const LatLngL
 
 
 
-std::string sim_mob::CommsimSerializer::makeRegionsAndPath(const std::vector<sim_mob::RoadRunnerRegion>& all_regions, const std::vector<sim_mob::RoadRunnerRegion>& region_path)
+std::string sim_mob::CommsimSerializer::makeRegionsAndPath(const std::vector<sim_mob::RoadRunnerRegion>& all_regions, const std::vector<sim_mob::RoadRunnerRegion>& region_path, bool binary)
 {
-    if (PREFER_BINARY_MESSAGES) {
-        throw std::runtime_error("addX() binary format not yet supported.");
+    if (binary) {
+        BinaryWriter res(BIN_MSG_REGIONS_AND_PATH);
+        res.addUInt(all_regions.size());
+        for (std::vector<sim_mob::RoadRunnerRegion>::const_iterator it=all_regions.begin(); it!=all_regions.end(); it++) {
+            res.addInt(it->id);
+            res.addUInt(it->points.size());
+            for (std::vector<sim_mob::LatLngLocation>::const_iterator latlngIt=it->points.begin(); latlngIt!=it->points.end(); latlngIt++) {
+                res.addDouble(latlngIt->latitude);
+                res.addDouble(latlngIt->longitude);
+            }
+        }
+        res.addUInt(region_path.size());
+        for (std::vector<sim_mob::RoadRunnerRegion>::const_iterator it=region_path.begin(); it!=region_path.end(); it++) {
+            res.addInt(it->id);
+        }
+        return res.str();
     } else {
         std::stringstream res;
         res <<"{\"msg_type\":\"regions_and_path\",\"regions\":[";
@@ -532,10 +731,19 @@ std::string sim_mob::CommsimSerializer::makeRegionsAndPath(const std::vector<sim
 }
 
 
-std::string sim_mob::CommsimSerializer::makeNewAgents(const std::vector<unsigned int>& addAgents, const std::vector<unsigned int>& remAgents)
+std::string sim_mob::CommsimSerializer::makeNewAgents(const std::vector<unsigned int>& addAgents, const std::vector<unsigned int>& remAgents, bool binary)
 {
-    if (PREFER_BINARY_MESSAGES) {
-        throw std::runtime_error("addX() binary format not yet supported.");
+    if (binary) {
+        BinaryWriter res(BIN_MSG_NEW_AGENTS);
+        res.addUInt(addAgents.size());
+        for (std::vector<unsigned int>::const_iterator it=addAgents.begin(); it!=addAgents.end(); it++) {
+            res.addUInt(*it);
+        }
+        res.addUInt(remAgents.size());
+        for (std::vector<unsigned int>::const_iterator it=remAgents.begin(); it!=remAgents.end(); it++) {
+            res.addUInt(*it);
+        }
+        return res.str();
     } else {
         std::stringstream res;
         res <<"{\"msg_type\":\"new_agents\",\"add\":[";
@@ -558,10 +766,17 @@ std::string sim_mob::CommsimSerializer::makeNewAgents(const std::vector<unsigned
 
 
 
-std::string sim_mob::CommsimSerializer::makeAllLocations(const std::map<unsigned int, Point>& allLocations)
+std::string sim_mob::CommsimSerializer::makeAllLocations(const std::map<unsigned int, Point>& allLocations, bool binary)
 {
-    if (PREFER_BINARY_MESSAGES) {
-        throw std::runtime_error("addX() binary format not yet supported.");
+    if (binary) {
+        BinaryWriter res(BIN_MSG_ALL_LOCATIONS);
+        res.addUInt(allLocations.size());
+        for (std::map<unsigned int, Point>::const_iterator it=allLocations.begin(); it!=allLocations.end(); it++) {
+            res.addUInt(it->first);
+            res.addDouble(it->second.getX());
+            res.addDouble(it->second.getY());
+        }
+        return res.str();
     } else {
         std::stringstream res;
         res <<"{\"msg_type\":\"all_locations\",\"locations\":[";
@@ -581,14 +796,24 @@ std::string sim_mob::CommsimSerializer::makeAllLocations(const std::map<unsigned
 
 
 
-std::string sim_mob::CommsimSerializer::makeOpaqueSend(const std::string& fromId, const std::vector<std::string>& toIds, const std::string& format, const std::string& tech, bool broadcast, const std::string& data)
+std::string sim_mob::CommsimSerializer::makeOpaqueSend(const std::string& fromId, const std::vector<std::string>& toIds, const std::string& format, const std::string& tech, bool broadcast, const std::string& data, bool binary)
 {
-    if (PREFER_BINARY_MESSAGES) {
-        throw std::runtime_error("addX() binary format not yet supported.");
+    if (binary) {
+        BinaryWriter res(BIN_MSG_OPAQUE_SEND);
+        res.addString(fromId);
+        res.addUInt(toIds.size());
+        for (std::vector<std::string>::const_iterator it=toIds.begin(); it!=toIds.end(); it++) {
+            res.addString(*it);
+        }
+        res.addString(format);
+        res.addString(tech);
+        res.addBool(broadcast);
+        res.addString(data);
+        return res.str();
     } else {
         std::stringstream res;
         res <<"{\"msg_type\":\"opaque_send\",\"from_id\":\"" <<fromId <<"\",\"broadcast\":" <<(broadcast?"true":"false")
-            <<"\",\"format\":\"" <<format <<"\",\"tech\":\"" <<tech <<"\",\"data\":\"" <<data <<"\",\"to_ids\":[";
+            <<",\"format\":\"" <<format <<"\",\"tech\":\"" <<tech <<"\",\"data\":\"" <<data <<"\",\"to_ids\":[";
 
         //Add all "TO_IDS"
         for (std::vector<std::string>::const_iterator it=toIds.begin(); it!=toIds.end(); it++) {
@@ -602,10 +827,16 @@ std::string sim_mob::CommsimSerializer::makeOpaqueSend(const std::string& fromId
 }
 
 
-std::string sim_mob::CommsimSerializer::makeOpaqueReceive(const std::string& fromId, const std::string& toId, const std::string& format, const std::string& tech, const std::string& data)
+std::string sim_mob::CommsimSerializer::makeOpaqueReceive(const std::string& fromId, const std::string& toId, const std::string& format, const std::string& tech, const std::string& data, bool binary)
 {
-    if (PREFER_BINARY_MESSAGES) {
-        throw std::runtime_error("addX() binary format not yet supported.");
+    if (binary) {
+        BinaryWriter res(BIN_MSG_OPAQUE_RECEIVE);
+        res.addString(fromId);
+        res.addString(toId);
+        res.addString(format);
+        res.addString(tech);
+        res.addString(data);
+        return res.str();
     } else {
         std::stringstream res;
         res <<"{\"msg_type\":\"opaque_receive\",\"from_id\":\"" <<fromId <<"\",\"to_id\":\"" <<toId
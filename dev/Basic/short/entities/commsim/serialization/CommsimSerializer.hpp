@@ -196,33 +196,35 @@ public:
 
 
 //Serialization messages.
+//Each of these produces a JSON message by default, or a binary message (see BINARY_MESSAGE_TYPE) if "binary" is true.
+//Use the recipient's ClientHandler::binaryMessages flag; only clients that asked for binary messages can read them.
 public:
     ///Serialize "id_request" to string.
-    static std::string makeIdRequest(const std::string& token);
+    static std::string makeIdRequest(const std::string& token, bool binary=PREFER_BINARY_MESSAGES);
 
     ///Serialize "id_ack" to a string.
-    static std::string makeIdAck();
+    static std::string makeIdAck(bool binary=PREFER_BINARY_MESSAGES);
 
     ///Serialize "ticked_simmob" to a string.
-    static std::string makeTickedSimMob(unsigned int tick, unsigned int elapsedMs);
+    static std::string makeTickedSimMob(unsigned int tick, unsigned int elapsedMs, bool binary=PREFER_BINARY_MESSAGES);
 
     ///Serialize "location" to a string.
-    static std::string makeLocation(int x, int y, const LatLngLocation& projected);
+    static std::string makeLocation(int x, int y, const LatLngLocation& projected, bool binary=PREFER_BINARY_MESSAGES);
 
     ///Serialize "regions_and_path" to a string.
-    static std::string makeRegionsAndPath(const std::vector<sim_mob::RoadRunnerRegion>& all_regions, const std::vector<sim_mob::RoadRunnerRegion>& region_path);
+    static std::string makeRegionsAndPath(const std::vector<sim_mob::RoadRunnerRegion>& all_regions, const std::vector<sim_mob::RoadRunnerRegion>& region_path, bool binary=PREFER_BINARY_MESSAGES);
 
     ///Serialize "new_agents" to a string.
-    static std::string makeNewAgents(const std::vector<unsigned int>& addAgents, const std::vector<unsigned int>& remAgents);
+    static std::string makeNewAgents(const std::vector<unsigned int>& addAgents, const std::vector<unsigned int>& remAgents, bool binary=PREFER_BINARY_MESSAGES);
 
     ///Serialize "all_locations" to a string.
-    static std::string makeAllLocations(const std::map<unsigned int, Point>& allLocations);
+    static std::string makeAllLocations(const std::map<unsigned int, Point>& allLocations, bool binary=PREFER_BINARY_MESSAGES);
 
     ///Serialize "opaque_send" to a string.
-    static std::string makeOpaqueSend(const std::string& fromId, const std::vector<std::string>& toIds, const std::string& format, const std::string& tech, bool broadcast, const std::string& data);
+    static std::string makeOpaqueSend(const std::string& fromId, const std::vector<std::string>& toIds, const std::string& format, const std::string& tech, bool broadcast, const std::string& data, bool binary=PREFER_BINARY_MESSAGES);
 
     ///Serialize "opaque_receive" to a string.
-    static std::string makeOpaqueReceive(const std::string& fromId, const std::string& toId, const std::string& format, const std::string& tech, const std::string& data);
+    static std::string makeOpaqueReceive(const std::string& fromId, const std::string& toId, const std::string& format, const std::string& tech, const std::string& data, bool binary=PREFER_BINARY_MESSAGES);
 
 
 private:
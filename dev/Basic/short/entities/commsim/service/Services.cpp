@@ -17,6 +17,7 @@ std::map<string, sim_mob::Services::SIM_MOB_SERVICE> sim_mob::Services::ServiceM
             ("srv_location", SIMMOB_SRV_LOCATION)
             ("srv_all_locations", SIMMOB_SRV_ALL_LOCATIONS)
             ("srv_regions_and_path", SIMMOB_SRV_REGIONS_AND_PATH)
+            ("srv_binary_messages", SIMMOB_SRV_BINARY_MESSAGES)
             ;
 
 sim_mob::Services::SIM_MOB_SERVICE sim_mob::Services::GetServiceType(std::string type)
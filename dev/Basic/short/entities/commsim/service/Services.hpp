@@ -41,7 +41,12 @@ public:
         //NOTE: There is probably a more efficient way to do this, with the Agent requesting the Region/Path set only
         //      when it needs it. For now, I am trying to do this within the "Services" framework we provide. ~Seth
         //NOTE: This message type will be ignored for non-Android clients.
-        SIMMOB_SRV_REGIONS_AND_PATH
+        SIMMOB_SRV_REGIONS_AND_PATH,
+
+        //Not a publishing service: the client is asking Sim Mobility to send it binary-formatted messages
+        //          (see BINARY_MESSAGE_TYPE) instead of JSON. Clients that do not list it always receive JSON.
+        //NOTE: Sim Mobility reads binary messages from any client; this only controls what we send.
+        SIMMOB_SRV_BINARY_MESSAGES
     };
 
     static std::map<std::string, SIM_MOB_SERVICE> ServiceMap;
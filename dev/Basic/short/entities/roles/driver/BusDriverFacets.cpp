@@ -303,6 +303,39 @@ std::string BusDriverMovement::frame_tick_output()
     }
 }
 
+bool BusDriverMovement::fillTrajectoryRecord(TrajectoryRecord &record)
+{
+    if (this->getParentDriver()->IsVehicleInLoadingQueue() || fwdDriverMovement.isDoneWithEntireRoute())
+    {
+        return false;
+    }
+
+    Vehicle *bus = parentBusDriver->getVehicle();
+    record.agentId = parentBusDriver->getParent()->getId();
+    record.xPos = parentBusDriver->getPositionX();
+    record.yPos = parentBusDriver->getPositionY();
+    record.angle = 360 - (getAngle() * 180 / M_PI);
+    record.length = bus->getLengthInM();
+    record.width = bus->getWidthInM();
+    record.wayPointId = fwdDriverMovement.isInIntersection() ?
+            fwdDriverMovement.getCurrTurning()->getTurningGroupId() : fwdDriverMovement.getCurrSegment()->getRoadSegmentId();
+    record.passengers = parentBusDriver->passengerList.size();
+    record.kind = TrajectoryRecord::KIND_BUS_DRIVER;
+    record.flags = 0;
+
+    //longer bus line ids are truncated
+    const std::string &busLineId = parentBusDriver->getBusLineId();
+    std::size_t length = busLineId.copy(record.busLineId, TrajectoryRecord::BUS_LINE_ID_SIZE - 1);
+    record.busLineId[length] = '\0';
+
+    if (ConfigManager::GetInstance().FullConfig().using_MPI && parentBusDriver->getParent()->isFake)
+    {
+        record.flags |= TrajectoryRecord::FLAG_FAKE;
+    }
+
+    return true;
+}
+
 void BusDriverMovement::checkForStops(DriverUpdateParams& params)
 {
     if(busStopTracker != busStops.end())
@@ -139,6 +139,15 @@ public:
      * This method outputs the parameters that changed at the end of the tick
      */
     virtual std::string frame_tick_output();
+
+    /**
+     * Fills a trajectory record with the position of the bus at the end of the tick
+     *
+     * @param record the record to fill
+     *
+     * @return false if there is no position to record
+     */
+    virtual bool fillTrajectoryRecord(TrajectoryRecord &record);
     
     void setParentBusDriver(BusDriver *parentBusDriver)
     {
@@ -140,19 +140,31 @@ Role<Person_ST>* Driver::clone(Person_ST *parent) const
 void Driver::initReactionTime()
 {
     DriverMovement* movement = dynamic_cast<DriverMovement*> (movementFacet);
-    
+
+    //The perception delay changes with the state of the vehicle, so the histories must cover the longest one
+    unsigned int maxReactionTime = reactionTime;
+
     if (movement)
     {
-        reactionTime = movement->getCarFollowModel()->nextPerceptionSize * 1000;
+        const CarFollowingModel* cfModel = movement->getCarFollowModel();
+        reactionTime = cfModel->nextPerceptionSize * 1000;
+        maxReactionTime = reactionTime;
+
+        for (vector<double>::const_iterator it = cfModel->perceptionSize.begin(); it != cfModel->perceptionSize.end(); ++it)
+        {
+            maxReactionTime = std::max(maxReactionTime, (unsigned int) (*it * 1000));
+        }
     }
 
-    perceivedFwdVel = new FixedDelayed<double>(reactionTime, true);
-    perceivedFwdAcc = new FixedDelayed<double>(reactionTime, true);
-    perceivedVelOfFwdCar = new FixedDelayed<double>(reactionTime, true);
-    perceivedAccOfFwdCar = new FixedDelayed<double>(reactionTime, true);
-    perceivedDistToFwdCar = new FixedDelayed<double>(reactionTime, true);
-    perceivedDistToTrafficSignal = new FixedDelayed<double>(reactionTime, true);
-    perceivedTrafficColor = new FixedDelayed<TrafficColor>(reactionTime, true);
+    const unsigned int tickMS = ConfigManager::GetInstance().FullConfig().baseGranMS();
+    perceivedFwdVel = new FixedDelayed<double>(maxReactionTime, true, tickMS);
+    perceivedFwdAcc = new FixedDelayed<double>(maxReactionTime, true, tickMS);
+    perceivedVelOfFwdCar = new FixedDelayed<double>(maxReactionTime, true, tickMS);
+    perceivedAccOfFwdCar = new FixedDelayed<double>(maxReactionTime, true, tickMS);
+    perceivedDistToFwdCar = new FixedDelayed<double>(maxReactionTime, true, tickMS);
+    perceivedDistToTrafficSignal = new FixedDelayed<double>(maxReactionTime, true, tickMS);
+    perceivedTrafficColor = new FixedDelayed<TrafficColor>(maxReactionTime, true, tickMS);
+    resetReactionTime(reactionTime);
 }
 
 void Driver::make_frame_tick_params(timeslice now)
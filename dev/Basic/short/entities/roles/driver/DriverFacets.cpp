@@ -13,7 +13,9 @@
 #include "conf/ConfigManager.hpp"
 #include "conf/ConfigParams.hpp"
 #include "config/ST_Config.hpp"
+#include "entities/AgentRegistry.hpp"
 #include "entities/AuraManager.hpp"
+#include "entities/LoopDetectorEntity.hpp"
 #include "entities/Person_ST.hpp"
 #include "entities/profile/ProfileBuilder.hpp"
 #include "entities/UpdateParams.hpp"
@@ -57,13 +59,21 @@ map<const RoadSegment *, unsigned long> DriverMovement::rdSegDensityMap;
 boost::mutex DriverMovement::densityUpdateMutex;
 
 DriverMovement::DriverMovement() :
-MovementFacet(), parentDriver(nullptr), trafficSignal(NULL), targetLaneIndex(0), lcModel(nullptr), cfModel(nullptr), intModel(nullptr),
-intModelBkUp(NULL), vehLoadingModel(nullptr), targetSpeed(0.0)
+MovementFacet(), parentDriver(nullptr), trafficSignal(NULL), targetLaneIndex(0), loopDetectorLane(nullptr), loopDetector(nullptr),
+occupiedLoopDetector(nullptr), loopDetectorPerson(nullptr), loopDetectorTime(0), registeredSegment(nullptr), lcModel(nullptr), cfModel(nullptr), intModel(nullptr), intModelBkUp(NULL), vehLoadingModel(nullptr),
+targetSpeed(0.0)
 {
 }
 
 DriverMovement::~DriverMovement()
 {
+    //The loop detector must not keep a reference to the person. At the end of the simulation, the loop detectors
+    //may have been destroyed first; a destroyed loop detector is no longer listed for its lane.
+    if (occupiedLoopDetector && LoopDetector::getLoopDetector(loopDetectorLane) == occupiedLoopDetector)
+    {
+        leaveLoopDetector(loopDetectorTime);
+    }
+
     safe_delete_item(lcModel);
     safe_delete_item(cfModel);
     safe_delete_item(intModel);
@@ -132,6 +142,9 @@ void DriverMovement::frame_tick()
     //Check if we're done with the route
     if (fwdDriverMovement.isDoneWithEntireRoute())
     {
+        leaveLoopDetector(params.now.ms());
+        updateRegisteredSegment(nullptr);
+
         if (parentDriver->getParent()->amodId != "-1")
         {
             parentDriver->getParent()->handleAMODArrival();
@@ -218,6 +231,11 @@ void DriverMovement::frame_tick()
     Point position = getPosition();
     parentDriver->setCurrPosition(position);
     parentDriver->vehicle->setCurrPosition(position);
+    updateLoopDetector(params.now.ms());
+
+    //Vehicles waiting to enter the network, or crossing an intersection, are not on any segment
+    bool isOnSegment = !parentDriver->isVehicleInLoadingQueue && !fwdDriverMovement.isInIntersection();
+    updateRegisteredSegment(isOnSegment ? fwdDriverMovement.getCurrSegment() : nullptr);
 
     setParentBufferedData();
     parentDriver->isVehiclePositionDefined = true;
@@ -226,6 +244,54 @@ void DriverMovement::frame_tick()
     params.conflictVehicles.clear();
 }
 
+void DriverMovement::updateRegisteredSegment(const RoadSegment *segment)
+{
+    if (segment != registeredSegment)
+    {
+        registeredSegment = segment;
+        AgentRegistry::getInstance().setSegment(parentDriver->getParent(), segment);
+    }
+}
+
+void DriverMovement::updateLoopDetector(unsigned int time)
+{
+    //The loop detector is only looked up when the lane changes
+    const Lane *lane = fwdDriverMovement.getCurrLane();
+    if (lane != loopDetectorLane)
+    {
+        loopDetectorLane = lane;
+        loopDetector = lane ? LoopDetector::getLoopDetector(lane) : nullptr;
+    }
+
+    LoopDetector *detector = nullptr;
+    if (loopDetector && loopDetector->isOver(fwdDriverMovement.getDistToEndOfCurrWayPt(), parentDriver->vehicle->getLateralMovement()))
+    {
+        detector = loopDetector;
+    }
+
+    loopDetectorTime = time;
+    if (detector != occupiedLoopDetector)
+    {
+        leaveLoopDetector(time);
+        if (detector)
+        {
+            loopDetectorPerson = parentDriver->getParent();
+            detector->enter(loopDetectorPerson, time);
+        }
+        occupiedLoopDetector = detector;
+    }
+}
+
+void DriverMovement::leaveLoopDetector(unsigned int time)
+{
+    if (occupiedLoopDetector)
+    {
+        occupiedLoopDetector->leave(loopDetectorPerson, time);
+        occupiedLoopDetector = nullptr;
+        loopDetectorPerson = nullptr;
+    }
+}
+
 bool DriverMovement::findEmptySpaceAhead()
 {
     bool isSpaceFound = true;
@@ -410,6 +476,44 @@ std::string DriverMovement::frame_tick_output()
     return output.str();
 }
 
+bool DriverMovement::fillTrajectoryRecord(TrajectoryRecord &record)
+{
+    if (parentDriver->isVehicleInLoadingQueue || fwdDriverMovement.isDoneWithEntireRoute())
+    {
+        return false;
+    }
+
+    Person_ST *person = parentDriver->getParent();
+    record.agentId = person->GetId();
+    record.xPos = parentDriver->getCurrPosition().getX();
+    record.yPos = parentDriver->getCurrPosition().getY();
+    record.angle = 360 - (getAngle() * 180 / M_PI);
+    record.length = parentDriver->vehicle->getLengthInM();
+    record.width = parentDriver->vehicle->getWidthInM();
+    record.wayPointId = fwdDriverMovement.isInIntersection() ?
+            fwdDriverMovement.getCurrTurning()->getTurningGroupId() : fwdDriverMovement.getCurrSegment()->getRoadSegmentId();
+    record.passengers = 0;
+    record.kind = TrajectoryRecord::KIND_DRIVER;
+    record.flags = 0;
+    record.busLineId[0] = '\0';
+
+    if (person->amodId != "-1")
+    {
+        record.flags |= TrajectoryRecord::FLAG_AMOD;
+    }
+    else if ((*(person->currTripChainItem))->travelMode == "Taxi")
+    {
+        record.flags |= TrajectoryRecord::FLAG_TAXI;
+    }
+
+    if (ConfigManager::GetInstance().FullConfig().using_MPI && person->isFake)
+    {
+        record.flags |= TrajectoryRecord::FLAG_FAKE;
+    }
+
+    return true;
+}
+
 void DriverMovement::updateDensityMap()
 {
     const RoadSegment *currSeg = fwdDriverMovement.getCurrSegment();
@@ -2345,9 +2449,9 @@ void sim_mob::DriverMovement::startRdSegStat(const RoadSegment* roadSegment, dou
     parentDriver->parent->startCurrRdSegTravelStat(roadSegment, startTime);
 }
 
-void sim_mob::DriverMovement::finalizeRdSegStat(const RoadSegment* roadSegment, double endTime, const std::string travelMode)
+void sim_mob::DriverMovement::finalizeRdSegStat(const RoadSegment* roadSegment, double endTime, unsigned int travelModeId)
 {
-    SegmentTravelStats &currStats = parentDriver->parent->finalizeCurrRdSegTravelStat(roadSegment, endTime, travelMode);
+    SegmentTravelStats &currStats = parentDriver->parent->finalizeCurrRdSegTravelStat(roadSegment, endTime, travelModeId);
     if (ConfigManager::GetInstance().FullConfig().rsTTConfig.enabled)
     {
         TravelTimeManager::getInstance()->addSegmentTravelTime(currStats);
@@ -2359,7 +2463,7 @@ void DriverMovement::updateRoadSegmentTravelTime(const vector<const RoadSegment*
     if(segmentsPassed.empty() || !ConfigManager::GetInstance().FullConfig().rsTTConfig.enabled)
             return;
 
-    std::string travelMode = (*parentDriver->parent->currTripChainItem)->getMode();
+    unsigned int travelModeId = TravelTimeManager::getInstance()->getTravelModeId((*parentDriver->parent->currTripChainItem)->getMode());
     double actualTime = parentDriver->getParams().elapsedSeconds
                         + (parentDriver->getParams().now.ms() / MILLISECS_CONVERT_UNIT);
 
@@ -2372,7 +2476,7 @@ void DriverMovement::updateRoadSegmentTravelTime(const vector<const RoadSegment*
     {
         if((*rdSegIter) == parentDriver->parent->getCurrRdSegTravelStats().roadSegment)
         {
-            finalizeRdSegStat((*rdSegIter), actualTime, travelMode);
+            finalizeRdSegStat((*rdSegIter), actualTime, travelModeId);
             finalized = true;
         }
         if(rdSegIter+1 != segmentsPassed.end())
@@ -22,6 +22,7 @@
 #include "entities/roles/driver/models/VehicleLoadingModel.hpp"
 #include "entities/roles/Role.hpp"
 #include "entities/roles/RoleFacets.hpp"
+#include "entities/TrajectoryRecord.hpp"
 #include "entities/vehicle/Vehicle.hpp"
 #include "geospatial/Incident.hpp"
 #include "IncidentPerformer.hpp"
@@ -39,9 +40,15 @@ const static int distanceBehind = 50;
 const static int maxVisibleDis = 100;
 }
 
+namespace unit_tests
+{
+class LoopDetectorUnitTests;
+}
+
 namespace sim_mob
 {
 class CarFollowingModel;
+class LoopDetector;
 class VehicleLoadingModel;
 
 class DriverBehavior : public BehaviorFacet
@@ -192,7 +199,7 @@ private:
 
     void startRdSegStat(const RoadSegment* roadSegment, double startTime);
 
-    void finalizeRdSegStat(const RoadSegment* roadSegment,double endTime, const std::string travelMode);
+    void finalizeRdSegStat(const RoadSegment* roadSegment,double endTime, unsigned int travelModeId);
 
     /**
      * This method is used to update the travel times of segments passed by the driver during the current frame tick
@@ -211,7 +218,50 @@ private:
      */
     void updateTrafficSensor(double oldPos, double newPos, double speed, double acceleration);
 
+    /**The lane on which loopDetector was looked up*/
+    const Lane *loopDetectorLane;
+
+    /**The loop detector on loopDetectorLane, if any*/
+    LoopDetector *loopDetector;
+
+    /**The loop detector over which the vehicle is hovering, if any*/
+    LoopDetector *occupiedLoopDetector;
+
+    /**The person reported to occupiedLoopDetector*/
+    const Person_ST *loopDetectorPerson;
+
+    /**The time (in ms) of the tick at which the loop detectors were last updated*/
+    unsigned int loopDetectorTime;
+
+    /**The road segment the vehicle is listed on in the AgentRegistry, if any*/
+    const RoadSegment *registeredSegment;
+
+    /**
+     * Reports to the loop detectors when the vehicle has moved onto or off one of them
+     *
+     * @param time the time (in ms) of the current tick
+     */
+    void updateLoopDetector(unsigned int time);
+
+    /**
+     * Lists the vehicle on the road segment it is now on in the AgentRegistry (only when the segment changes)
+     *
+     * @param segment the current road segment, or null if the vehicle is not on a segment
+     */
+    void updateRegisteredSegment(const RoadSegment *segment);
+
+    friend class unit_tests::LoopDetectorUnitTests;
+
 protected:
+    /**
+     * Reports to the loop detector over which the vehicle is hovering, if any, that the vehicle has moved off it.
+     * Must be called whenever the loop detectors stop being updated: at the end of the route, when the vehicle parks
+     * and when the movement is destroyed
+     *
+     * @param time the time (in ms) of the current tick
+     */
+    void leaveLoopDetector(unsigned int time);
+
     /**Pointer to the lane changing model being used*/
     LaneChangingModel *lcModel;
 
@@ -360,6 +410,16 @@ public:
      */
     virtual std::string frame_tick_output();
 
+    /**
+     * Fills a trajectory record with the position of the driver at the end of the tick, in place of frame_tick_output
+     * when the trajectory output is enabled. The frame is set by the caller.
+     *
+     * @param record the record to fill
+     *
+     * @return false if there is no position to record (e.g. the vehicle is still in the loading queue)
+     */
+    virtual bool fillTrajectoryRecord(TrajectoryRecord &record);
+
     /**
      * Marks the start time and origin
      * 
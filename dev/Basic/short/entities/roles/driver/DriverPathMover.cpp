@@ -454,7 +454,7 @@ double DriverPathMover::advance(double distance)
     double distBetwCurrAndNxtPt = calcDistFromCurrToNextPt();
     
     //Check if we've crossed the next point, if so advance to the next point
-    while(distCoveredFromCurrPtToNextPt >= distBetwCurrAndNxtPt)
+    while(distCoveredFromCurrPtToNextPt >= distBetwCurrAndNxtPt && !isDoneWithEntireRoute())
     {
         distCoveredFromCurrPtToNextPt -= distBetwCurrAndNxtPt;
         overflowAmount = advanceToNextPoint();
@@ -466,8 +466,13 @@ double DriverPathMover::advance(double distance)
 
 double DriverPathMover::calcDistFromCurrToNextPt()
 {
-    DynamicVector vector(*currPolyPoint, *nextPolyPoint);
-    return vector.getMagnitude();
+    if (nextPolyPoint == currPolyLine->getPoints().end())
+    {
+        return 0;
+    }
+
+    //The segment lengths are computed when the network is loaded
+    return currPolyLine->getSegmentLength(currPolyPoint - currPolyLine->getPoints().begin());
 }
 
 double DriverPathMover::advanceToNextPoint()
@@ -588,23 +593,36 @@ void DriverPathMover::updateLateralMovement(const Lane* lane)
 {
     if(lane)
     {
+        //Now, we must map the progress to the current poly-line, so we
+        //place the driver at the same distance on the new poly-line
+        double distance = getDistCoveredOnCurrWayPt();
+
         //Update the current lane, poly-line and points
         currLane = lane;
         currPolyLine = currLane->getPolyLine();
-        currPolyPoint = currPolyLine->getPoints().begin();
-        nextPolyPoint = currPolyPoint + 1;
         
         //Reset next turning, lane
         nextTurning = nullptr;
         nextLane = nullptr;
         
-        //Now, we must map the progress to the current poly-line, so we
-        //advance the same distance on the new poly-line
-        //But, reset the distance covered values, as the advance method will add to them
-        double distance = getDistCoveredOnCurrWayPt();
-        distCoveredFromCurrPtToNextPt = 0;
-        distCoveredOnCurrWayPt = 0;
-        advance(distance);
+        if (distance < currPolyLine->getCumulativeLength(currPolyLine->size() - 1))
+        {
+            //Look up the segment containing the distance instead of walking the poly-line
+            std::size_t index = currPolyLine->findSegment(distance);
+            currPolyPoint = currPolyLine->getPoints().begin() + index;
+            nextPolyPoint = currPolyPoint + 1;
+            distCoveredOnCurrWayPt = currPolyLine->getCumulativeLength(index);
+            distCoveredFromCurrPtToNextPt = std::max(0.0, distance - distCoveredOnCurrWayPt);
+        }
+        else
+        {
+            //The new lane is shorter than the distance covered; advance onto the next way-point
+            currPolyPoint = currPolyLine->getPoints().begin();
+            nextPolyPoint = currPolyPoint + 1;
+            distCoveredFromCurrPtToNextPt = 0;
+            distCoveredOnCurrWayPt = 0;
+            advance(distance);
+        }
     }
     else
     {
@@ -676,9 +694,16 @@ const Point DriverPathMover::getPosition()
     {
         if(!isDoneWithEntireRoute())
         {
-            DynamicVector movementVector(*currPolyPoint, *nextPolyPoint);
-            movementVector.scaleVectTo(distCoveredFromCurrPtToNextPt).translateVect();
-            return Point(movementVector.getX(), movementVector.getY());
+            //Interpolate along the current segment, using its pre-computed length
+            double segmentLength = calcDistFromCurrToNextPt();
+            if (distCoveredFromCurrPtToNextPt == 0 || segmentLength == 0)
+            {
+                return Point(currPolyPoint->getX(), currPolyPoint->getY());
+            }
+
+            double factor = distCoveredFromCurrPtToNextPt / segmentLength;
+            return Point(currPolyPoint->getX() + factor * (nextPolyPoint->getX() - currPolyPoint->getX()),
+                         currPolyPoint->getY() + factor * (nextPolyPoint->getY() - currPolyPoint->getY()));
         }
         else
         {
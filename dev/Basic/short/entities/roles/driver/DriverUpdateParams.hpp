@@ -303,9 +303,6 @@ public:
     /**The lane change decision - used for debugging*/
     std::string lcd;
 
-    /**Debugging information for car-following model*/
-    std::string cfDebugStr;
-
     /**Debugging information for lane-changing model*/
     std::stringstream lcDebugStr;
     
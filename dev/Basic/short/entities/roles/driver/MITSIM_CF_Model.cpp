@@ -256,7 +256,7 @@ void MITSIM_CF_Model::createScaleIndices(string &data, vector<double> &container
 }
 
 void MITSIM_CF_Model::createSpeedIndices(VehicleBase::VehicleType vhType, string &speedScalerStr, string &cstr,
-                                         map<VehicleBase::VehicleType, map<int, double> > &idx, int &upperBound)
+                                         SpeedIndex &idx, int &upperBound)
 {
     //For example
     //speedScalerStr "5 20 20" ft/sec
@@ -311,7 +311,7 @@ void MITSIM_CF_Model::createSpeedIndices(VehicleBase::VehicleType vhType, string
 
     upperBound = round(speedScalerArrayDouble[1] * (speedScalerArrayDouble[0] - 1));
 
-    map<int, double> cIdx;
+    vector<double> cIdx;
 
     for (int speed = 0; speed <= upperBound; ++speed)
     {
@@ -328,9 +328,13 @@ void MITSIM_CF_Model::createSpeedIndices(VehicleBase::VehicleType vhType, string
             maxAcc = cArrayDouble[j];
         }
 
-        cIdx.insert(std::make_pair(speed, maxAcc));
+        cIdx.push_back(maxAcc);
     }
 
+    if (idx.size() <= (size_t) vhType)
+    {
+        idx.resize(vhType + 1);
+    }
     idx[vhType] = cIdx;
 }
 
@@ -348,7 +352,7 @@ double MITSIM_CF_Model::getMaxAcceleration(DriverUpdateParams &params, VehicleBa
         speed = maxAccUpperBound;
     }
 
-    double maxTableAcc = maxAccelerationIndex[vhType][speed];
+    double maxTableAcc = lookupSpeedIndex(maxAccelerationIndex, vhType, speed);
 
     double maxAcc = (maxTableAcc - allGrades * accGradeFactor) * getMaxAccScalar();
 
@@ -369,7 +373,7 @@ double MITSIM_CF_Model::getNormalDeceleration(DriverUpdateParams &params, Vehicl
         speed = normalDecelerationUpperBound;
     }
 
-    double normalDec = normalDecelerationIndex[vhType][speed];
+    double normalDec = lookupSpeedIndex(normalDecelerationIndex, vhType, speed);
 
     double dec = (normalDec - allGrades * accGradeFactor) * getNormalDecScalar();
 
@@ -390,7 +394,7 @@ double MITSIM_CF_Model::getMaxDeceleration(DriverUpdateParams &params, VehicleBa
         speed = maxDecelerationUpperBound;
     }
 
-    double maxDec = maxDecelerationIndex[vhType][speed];
+    double maxDec = lookupSpeedIndex(maxDecelerationIndex, vhType, speed);
 
     double dec = (maxDec - allGrades * accGradeFactor) * getMaxDecScalar();
 
@@ -460,7 +464,6 @@ double MITSIM_CF_Model::getHeadwayBuffer()
 
 double MITSIM_CF_Model::makeAcceleratingDecision(DriverUpdateParams &params)
 {
-    params.cfDebugStr = "";
 
     //Calculate the state based variables for the current state
     calcStateBasedVariables(params);
@@ -606,23 +609,18 @@ double MITSIM_CF_Model::makeAcceleratingDecision(DriverUpdateParams &params)
 double MITSIM_CF_Model::calcCarFollowingAcc(DriverUpdateParams &params, NearestVehicle &nearestVehicle)
 {
     double res = 0;
-    std::stringstream debugStr;
 
     //Unset status
     params.unsetStatus(STATUS_REGIME_EMERGENCY);
     params.gapBetnVehicles = nearestVehicle.distance;
 
-    debugStr << "t" << params.now.frame();
-
     params.headway = 99;
     if (nearestVehicle.distance == DBL_MAX)
     {
         res = calcFreeFlowingAcc(params, params.desiredSpeed);
-        debugStr << "DEF;" << res;
     }
     else
     {
-        debugStr << "ELSE;";
 
         params.velocityLeadVehicle = nearestVehicle.driver->getFwdVelocity();
         params.accLeadVehicle = params.driver->getFwdAcceleration();
@@ -632,12 +630,8 @@ double MITSIM_CF_Model::calcCarFollowingAcc(DriverUpdateParams &params, NearestV
 
         float headway = 2.0 * params.gapBetnVehicles / (auxspeed + params.perceivedFwdVelocity);
 
-        debugStr << "+" << headway << "+" << params.gapBetnVehicles << "+" << auxspeed << "+" << params.perceivedFwdVelocity << ";";
-
         double emergSpace = nearestVehicle.distance;
 
-        debugStr << emergSpace << ";";
-
         //If we have no space left to move, immediately cut off acceleration.
         if (emergSpace <= params.driver->getVehicleLength())
         {
@@ -651,7 +645,6 @@ double MITSIM_CF_Model::calcCarFollowingAcc(DriverUpdateParams &params, NearestV
                 headway = emergHeadway;
             }
 
-            debugStr << "EM;" << emergHeadway << ";";
         }
 
         float v = params.velocityLeadVehicle + params.accLeadVehicle * dt;
@@ -661,7 +654,6 @@ double MITSIM_CF_Model::calcCarFollowingAcc(DriverUpdateParams &params, NearestV
         {
             res = calcEmergencyDeceleration(params);
             params.setStatus(STATUS_REGIME_EMERGENCY);
-            debugStr << "LO;";
         }
 
         hBufferUpper = getH_BufferUpperBound();
@@ -669,20 +661,16 @@ double MITSIM_CF_Model::calcCarFollowingAcc(DriverUpdateParams &params, NearestV
         if (headway > hBufferUpper)
         {
             res = accOfMixOfCFandFF(params, params.desiredSpeed);
-            debugStr << "UP;";
         }
 
         if (headway <= hBufferUpper && headway >= hBufferLower)
         {
             res = calcAccOfCarFollowing(params);
-            debugStr << "LOUP;";
         }
 
         params.headway = headway;
     }
 
-    params.cfDebugStr += debugStr.str();
-
     return res;
 }
 
@@ -1279,8 +1267,6 @@ double MITSIM_CF_Model::calcAdjacentGapRate(DriverUpdateParams& p)
 
 double MITSIM_CF_Model::calcAccForStoppingPoint(DriverUpdateParams &params)
 {
-    std::stringstream debugStr;
-    //debugStr << ";SS-Dist" << params.distanceToStoppingPt << ";" << params.stopPointState << ";" << params.perceivedFwdVelocity;
 
     double acc = params.maxAcceleration;
 
@@ -1289,18 +1275,15 @@ double MITSIM_CF_Model::calcAccForStoppingPoint(DriverUpdateParams &params)
         if (params.stopPointState == DriverUpdateParams::ARRIVING_AT_STOP_POINT)
         {
             acc = calcBrakeToStopAcc(params, params.distToStop);
-    //      debugStr << "SP-Arriving;";
         }
         if (params.stopPointState == DriverUpdateParams::ARRIVED_AT_STOP_POINT || params.stopPointState == DriverUpdateParams::WAITING_AT_STOP_POINT)
         {
-    //      debugStr << "SP-Arrived;";
             acc = params.maxDeceleration;
         }
     }
 
     if (params.stopPointState == DriverUpdateParams::ARRIVED_AT_STOP_POINT && params.perceivedFwdVelocity < 0.1)
     {
-        debugStr << "SP-Arrive0;";
         acc = params.maxDeceleration;
         params.stopPointState = DriverUpdateParams::WAITING_AT_STOP_POINT;
         params.stopTimeTimer = params.now.ms();
@@ -1308,19 +1291,15 @@ double MITSIM_CF_Model::calcAccForStoppingPoint(DriverUpdateParams &params)
 
     if (params.stopPointState == DriverUpdateParams::WAITING_AT_STOP_POINT)
     {
-        debugStr << "SP-Waiting;";
         double currentTime = params.now.ms();
         double waitTime = millisecondToSecond(currentTime - params.stopTimeTimer);
 
-        debugStr << "SP-wt;" << waitTime;
-
         if (waitTime > params.currentStopPoint.dwellTime)
         {
             params.stopPointState = DriverUpdateParams::LEAVING_STOP_POINT;
         }
     }
 
-    params.cfDebugStr += debugStr.str();
     return acc;
 }
 
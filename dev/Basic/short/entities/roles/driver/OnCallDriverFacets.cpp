@@ -192,6 +192,8 @@ void OnCallDriverMovement::frame_tick()
         }
         case PARKED:
         {
+            //The vehicle is not updated while parked
+            leaveLoopDetector(onCallDriver->getParams().now.ms());
             break;
         }
 
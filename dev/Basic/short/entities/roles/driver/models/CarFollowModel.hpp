@@ -192,14 +192,38 @@ private:
     /**The distribution for the headway upperbound*/
     vector<double> hBufferUpperScale;
 
-    /**The maximum acceleration indices. Key: Vehicle type, Value: Map with Key: Speed, Value: Max. Acceleration*/
-    map< VehicleBase::VehicleType, map<int, double> > maxAccelerationIndex;
+    /**
+     * A table of values by speed, for every vehicle type. Indexed by the vehicle type, then by the speed (from 0 to the
+     * upper bound of the table). Vehicle types without a table have an empty one.
+     */
+    typedef vector< vector<double> > SpeedIndex;
+
+    /**The maximum acceleration indices, by vehicle type and speed*/
+    SpeedIndex maxAccelerationIndex;
 
-    /**The normal deceleration indices. Key: Vehicle type, Value: Map with Key: Speed, Value: Normal deceleration*/
-    map< VehicleBase::VehicleType, map<int, double> > normalDecelerationIndex;
+    /**The normal deceleration indices, by vehicle type and speed*/
+    SpeedIndex normalDecelerationIndex;
 
-    /**The maximum deceleration indices. Key: Vehicle type, Value: Map with Key: Speed, Value: Normal deceleration*/
-    map< VehicleBase::VehicleType, map<int, double> > maxDecelerationIndex;
+    /**The maximum deceleration indices, by vehicle type and speed*/
+    SpeedIndex maxDecelerationIndex;
+
+    /**
+     * Looks up a speed index
+     *
+     * @param idx the speed index
+     * @param vhType the vehicle type
+     * @param speed the speed, within the bounds of the index
+     *
+     * @return the value in the index, or 0 if there is none for the vehicle type
+     */
+    static double lookupSpeedIndex(const SpeedIndex &idx, VehicleBase::VehicleType vhType, int speed)
+    {
+        if ((size_t) vhType < idx.size() && (size_t) speed < idx[vhType].size())
+        {
+            return idx[vhType][speed];
+        }
+        return 0;
+    }
 
     /**
      * Reads the car following model parameters from the driver parameters XML file
@@ -225,8 +249,7 @@ private:
      * @param idx the container holding the indices
      * @param upperBound the upper bound of the index
      */
-    void createSpeedIndices(VehicleBase::VehicleType vehicleType, string &speedScalerStr, string &cstr, map< VehicleBase::VehicleType, map<int, double> > &idx,
-                            int &upperBound);
+    void createSpeedIndices(VehicleBase::VehicleType vehicleType, string &speedScalerStr, string &cstr, SpeedIndex &idx, int &upperBound);
 
     /**
      * Creates the scale indices based on the string data
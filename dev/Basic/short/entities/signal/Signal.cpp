@@ -2,6 +2,7 @@
 //Licensed under the terms of the MIT License, as described in the file:
 //   license.txt   (http://opensource.org/licenses/MIT)
 
+#include <algorithm>
 #include <cmath>
 #include <bits/localefwd.h>
 
@@ -219,6 +220,7 @@ void Signal_SCATS::initialise()
     //Initialise the phases
     initialisePhases();
     phaseDensity.resize(phases.size(), 0);
+    createPhaseLanes();
 }
 
 bool Signal_SCATS::updateCurrCycleTimer()
@@ -272,31 +274,16 @@ double Signal_SCATS::computePhaseDS(int phaseId, const timeslice &now)
 
     double totalGreen = phase->computeTotalGreenTime();
     
-    Phase::linksMappingIterator linkIterator = phase->getLinksMapBegin();
-    for (; linkIterator != phase->getLinksMapEnd(); linkIterator++)
+    for (std::size_t i = phaseLaneOffsets[phaseId]; i < phaseLaneOffsets[phaseId + 1]; i++)
     {
-        const RoadNetwork *network = RoadNetwork::getInstance();
-        const Link *link = network->getById(network->getMapOfIdVsLinks(), linkIterator->first);
+        //A lane without loop detector makes getCountAndTimePair() report the error
+        const Sensor::CountAndTimePair &ctPair = phaseCountAndTimePairs[i] ? phaseCountAndTimePairs[i]->get()
+                                                                         : loopDetectorAgent->getCountAndTimePair(*phaseLanes[i]);
+        lane_DS = computeLaneDS(ctPair, totalGreen);
         
-        const std::vector<const Lane *> lanes = link->getRoadSegments().back()->getLanes();
-        
-        for (std::size_t i = 0; i < lanes.size(); i++)
-        { 
-            const Lane *lane = NULL;
-            lane = lanes.at(i);
-            
-            if (lane->isPedestrianLane())
-            {
-                continue;
-            }
-            
-            const Sensor::CountAndTimePair &ctPair = loopDetectorAgent->getCountAndTimePair(*lane);
-            lane_DS = computeLaneDS(ctPair, totalGreen);
-            
-            if (lane_DS > maxPhaseDS)
-            {
-                maxPhaseDS = lane_DS;
-            }
+        if (lane_DS > maxPhaseDS)
+        {
+            maxPhaseDS = lane_DS;
         }
     }
 
@@ -491,6 +478,45 @@ void Signal_SCATS::initialisePhases()
     }
 }
 
+void Signal_SCATS::createPhaseLanes()
+{
+    const RoadNetwork *network = RoadNetwork::getInstance();
+    const std::map<const Lane *, Shared<Sensor::CountAndTimePair> *> &countAndTimePairs = loopDetectorAgent->getCountAndTimePairMap();
+    
+    phaseLanes.clear();
+    phaseCountAndTimePairs.clear();
+    phaseLaneOffsets.clear();
+    
+    for (std::size_t phaseId = 0; phaseId < phases.size(); phaseId++)
+    {
+        phaseLaneOffsets.push_back(phaseLanes.size());
+        
+        Phase *phase = phases[phaseId];
+        Phase::linksMappingIterator linkIterator = phase->getLinksMapBegin();
+        for (; linkIterator != phase->getLinksMapEnd(); linkIterator++)
+        {
+            const Link *link = network->getById(network->getMapOfIdVsLinks(), linkIterator->first);
+            const std::vector<const Lane *> &lanes = link->getRoadSegments().back()->getLanes();
+            
+            for (std::size_t i = 0; i < lanes.size(); i++)
+            {
+                const Lane *lane = lanes[i];
+                
+                if (lane->isPedestrianLane())
+                {
+                    continue;
+                }
+                
+                std::map<const Lane *, Shared<Sensor::CountAndTimePair> *>::const_iterator itPair = countAndTimePairs.find(lane);
+                phaseLanes.push_back(lane);
+                phaseCountAndTimePairs.push_back(itPair != countAndTimePairs.end() ? itPair->second : NULL);
+            }
+        }
+    }
+    
+    phaseLaneOffsets.push_back(phaseLanes.size());
+}
+
 void Signal_SCATS::createTrafficSignals(const MutexStrategy &mtxStrat)
 {
     const std::map<unsigned int, Node *> &nodes = RoadNetwork::getInstance()->getMapOfIdvsNodes();
@@ -544,30 +570,28 @@ void VehicleCounter::initialise(const Signal_SCATS* signal)
 
     for (it = countAndTimePairs.begin(); it != countAndTimePairs.end(); ++it)
     {
-        counter[it->first] = 0;
+        lanes.push_back(it->first);
+        this->countAndTimePairs.push_back(it->second);
     }
+    counts.assign(lanes.size(), 0);
 }
 
 void VehicleCounter::resetCounter()
 {
-    for (std::map<const Lane*, int> ::iterator it = counter.begin(); it != counter.end(); ++it)
-    {
-        it->second = 0;
-    }
+    std::fill(counts.begin(), counts.end(), 0);
 }
 
 void VehicleCounter::serialize(const uint32_t& time)
 {
     if (ST_Config::getInstance().outputStats.loopDetectorCounts.outputEnabled)
     {
-        std::map<const Lane*, int> ::iterator it(counter.begin());
-        for (; it != counter.end(); it++)
+        for (std::size_t i = 0; i < lanes.size(); i++)
         {
             if(signal->getTrafficLightId() != 0)
             {
                 logger << time << "," << signal->getTrafficLightId() \
-                    << "," << it->first->getRoadSegmentId() \
-                    << "," << it->first->getLaneId() << "," << it->second << "\n";
+                    << "," << lanes[i]->getRoadSegmentId() \
+                    << "," << lanes[i]->getLaneId() << "," << counts[i] << "\n";
             }
         }
     }
@@ -575,15 +599,9 @@ void VehicleCounter::serialize(const uint32_t& time)
 
 void VehicleCounter::update()
 {
-    std::map<const Lane*, int> ::iterator it(counter.begin());
-    const Sensor* loopDetector = signal->getLoopDetector();
-
-    for (; it != counter.end(); ++it)
+    for (std::size_t i = 0; i < countAndTimePairs.size(); i++)
     {
-        const Lane* lane = it->first;
-        const Sensor::CountAndTimePair& ctPair = loopDetector->getCountAndTimePair(*lane);
-        int& count = it->second;
-        count = count + ctPair.vehicleCount;
+        counts[i] += countAndTimePairs[i]->get().vehicleCount;
     }
 }
 
@@ -45,8 +45,14 @@ public:
     /**Accumulation Period length in milliseconds seconds: E.g. return total count of vehicle in every "600,000" milliseconds*/
     const unsigned int frequency;
     
-    /**Map of lane vs the number of vehicles detected by the loop detector*/
-    std::map<const Lane *, int> counter;
+    /**The lanes with a loop detector, in the order of the loop detector's map*/
+    std::vector<const Lane *> lanes;
+
+    /**The counts and times of the loop detector on each lane in 'lanes'*/
+    std::vector<const Shared<Sensor::CountAndTimePair> *> countAndTimePairs;
+
+    /**The number of vehicles detected by the loop detector on each lane in 'lanes'*/
+    std::vector<int> counts;
     
     /**Instance of the logger*/
     BasicLogger &logger;
@@ -199,6 +205,18 @@ private:
 
     /**Stores the densities of the phases. Density of phase 'i' is stored at the 'i'th index*/
     std::vector<double> phaseDensity;
+
+    /**
+     * The lanes whose DS determines the DS of each phase, i.e. the non-pedestrian lanes at the end of the links from
+     * which the phase lets vehicles in. The lanes of phase 'i' are at indices [phaseLaneOffsets[i], phaseLaneOffsets[i+1])
+     */
+    std::vector<const Lane *> phaseLanes;
+
+    /**The counts and times of the loop detector on each lane in 'phaseLanes'; NULL if the lane has no loop detector*/
+    std::vector<const Shared<Sensor::CountAndTimePair> *> phaseCountAndTimePairs;
+
+    /**Start of the lanes of each phase in 'phaseLanes', followed by the total number of lanes*/
+    std::vector<std::size_t> phaseLaneOffsets;
     
     /**Indicates whether operations pertaining to a new cycle should be performed*/
     bool isNewCycle;
@@ -271,6 +289,11 @@ private:
      */
     void initialisePhases();
 
+    /**
+     * Collects the lanes and the loop detector data used to compute the DS of each phase
+     */
+    void createPhaseLanes();
+
 protected:
     VehicleCounter curVehicleCounter;
     Sensor *loopDetectorAgent;
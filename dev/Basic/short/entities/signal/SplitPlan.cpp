@@ -24,6 +24,7 @@ cycleLength(cycleLen), offset(offset)
     nextSplitPlanIdx = 0;
     currSplitPlanIdx = 0;
     numOfPlans = 0;
+    oldestVote = 0;
     cycle.setCurrentCycleLen(cycleLen);
 }
 
@@ -68,41 +69,47 @@ void SplitPlan::setParentSignal(Signal_SCATS* parentSignal)
     this->parentSignal = parentSignal;
 }
 
-std::size_t SplitPlan::vote(std::vector<double> maxprojectedDS)
+std::size_t SplitPlan::vote(const std::vector<double> &maxprojectedDS)
 {
-    std::vector<int> vote(numOfPlans, 0);
-    
     //The corresponding split plan's vote is incremented by one(the rests are zero)
-    vote[findIndexOfMinDS(maxprojectedDS)]++; 
-    votes.push_back(vote);
+    std::size_t planIdx = findIndexOfMinDS(maxprojectedDS);
+    voteCounts[planIdx]++;
     
-    if (votes.size() > NUMBER_OF_VOTING_CYCLES)
+    if (voteHistory.size() < NUMBER_OF_VOTING_CYCLES)
+    {
+        voteHistory.push_back(planIdx);
+    }
+    else
     {
-        //Remove the oldest vote (we keep only NUMBER_OF_VOTING_CYCLES records)
-        votes.erase(votes.begin());
+        //Replace the oldest vote (we keep only NUMBER_OF_VOTING_CYCLES records)
+        voteCounts[voteHistory[oldestVote]]--;
+        voteHistory[oldestVote] = planIdx;
+        oldestVote = (oldestVote + 1) % NUMBER_OF_VOTING_CYCLES;
     }
     
     //The split plan with the highest vote in the last certain number of cycles will win the vote
     return getMaxVotedSplitPlan();
 }
 
-void SplitPlan::calcMaxProjectedDS(std::vector<double> &maxproDS, std::vector<double> &DS)
+void SplitPlan::calcMaxProjectedDS(std::vector<double> &maxproDS, const std::vector<double> &DS) const
 {
-    vector<double> proDS(parentSignal->getNumOfPhases(), 0);
+    const vector<double> &currPlan = choiceSet[currSplitPlanIdx];
+    const unsigned int numOfPhases = parentSignal->getNumOfPhases();
     
     //Traversing the columns of Phase::choiceSet matrix
     for (int i = 0; i < numOfPlans; i++)
     {
+        const vector<double> &plan = choiceSet[i];
         double max = 0.0;
-        for (int j = 0; j < parentSignal->getNumOfPhases(); j++)
+        for (int j = 0; j < numOfPhases; j++)
         {
             //Calculate the projected DS for this plan
-            proDS[j] = DS[j] * choiceSet[currSplitPlanIdx][j] / choiceSet[i][j];
+            double proDS = DS[j] * currPlan[j] / plan[j];
             
             //Then find the Maximum Projected DS for each Split plan(used in the next step)
-            if (max < proDS[j])
+            if (max < proDS)
             {
-                max = proDS[j];
+                max = proDS;
             }
         }
         
@@ -110,25 +117,25 @@ void SplitPlan::calcMaxProjectedDS(std::vector<double> &maxproDS, std::vector<do
     }
 }
 
-std::size_t SplitPlan::findNextPlanIndex(std::vector<double> degOfSaturation)
+std::size_t SplitPlan::findNextPlanIndex(const std::vector<double> &degOfSaturation)
 {
     //Max. projected DS of each split plan
-    std::vector<double> maxproDS(numOfPlans, 0);
+    maxProjectedDS.resize(numOfPlans);
 
     //1: Calculate the Max projected DS for each approach (and find the maximum projected DS)
-    calcMaxProjectedDS(maxproDS, degOfSaturation);
+    calcMaxProjectedDS(maxProjectedDS, degOfSaturation);
     
     //2: The split plan with the 'lowest "Maximum Projected DS"' will get a vote
     //3: The split plan with the highest vote in the last certain number of cycles will win the vote
-    nextSplitPlanIdx = vote(maxproDS);
+    nextSplitPlanIdx = vote(maxProjectedDS);
     
     return nextSplitPlanIdx;
 }
 
-double SplitPlan::findIndexOfMinDS(std::vector<double> maxProjectedDS)
+std::size_t SplitPlan::findIndexOfMinDS(const std::vector<double> &maxProjectedDS) const
 {
-    int min = 0;
-    for (int i = 1; i < maxProjectedDS.size(); i++)
+    std::size_t min = 0;
+    for (std::size_t i = 1; i < maxProjectedDS.size(); i++)
     {
         if (maxProjectedDS[i] < maxProjectedDS[min])
         {
@@ -140,7 +147,7 @@ double SplitPlan::findIndexOfMinDS(std::vector<double> maxProjectedDS)
     return min;
 }
 
-std::size_t SplitPlan::getMaxVotedSplitPlan()
+std::size_t SplitPlan::getMaxVotedSplitPlan() const
 {
     int planIdxWithMaxVotes = -1;
     int planIdx;
@@ -148,14 +155,8 @@ std::size_t SplitPlan::getMaxVotedSplitPlan()
 
     for (planIdx = 0; planIdx < numOfPlans; planIdx++)//column iterator(plans)
     {
-        //Calculate sum of votes in each column
-        int vote_sum = 0;
-        
-        //Row iterator(cycles)
-        for (int i = 0; i < votes.size(); i++) 
-        {
-            vote_sum += votes[i][planIdx];
-        }
+        //Sum of votes in each column, kept up to date by vote()
+        int vote_sum = voteCounts[planIdx];
         
         if (maxVotes < vote_sum)
         {
@@ -168,7 +169,7 @@ std::size_t SplitPlan::getMaxVotedSplitPlan()
     return planIdxWithMaxVotes;
 }
 
-double SplitPlan::getMaxDS(std::vector<double> &phaseDensity)
+double SplitPlan::getMaxDS(const std::vector<double> &phaseDensity) const
 {
     double max = phaseDensity[0];
     for (int i = 0; i < phaseDensity.size(); i++)
@@ -181,7 +182,7 @@ double SplitPlan::getMaxDS(std::vector<double> &phaseDensity)
     return max;
 }
 
-void SplitPlan::update(std::vector<double> &phaseDensity)
+void SplitPlan::update(const std::vector<double> &phaseDensity)
 {
     double DS_all = getMaxDS(phaseDensity);
     cycle.update(DS_all);
@@ -261,6 +262,9 @@ void SplitPlan::setDefaultSplitPlan(int approaches)
 
     numOfPlans = 5;
     choiceSet.resize(numOfPlans, vector<double>(approaches));
+    voteCounts.assign(numOfPlans, 0);
+    voteHistory.clear();
+    oldestVote = 0;
 
     switch (approaches)
     {
@@ -60,17 +60,26 @@ private:
     std::vector< std::vector<double> > choiceSet;
 
     /* Keeps track of the votes obtained by each split-plan (i.e. phase - choice set combination)
-     * It can be accessed as: votes[cycle][plan]
-     * Usually a history of the last 5 votes is kept. 
-     * 
-     *          plan1   plan2   plan3   plan4   plan5
-     *  iter1   1       0       0       0       0
-     *  iter2   0       1       0       0       0
-     *  iter3   0       1       0       0       0
-     *  iter5   1       0       0       0       0
-     *  iter5   0       0       0       1       0
+     * Each cycle gives one vote to one plan, so only the index of the plan voted for is kept, for the last
+     * 5 cycles. The history is a circular buffer; oldestVote is the position of the oldest vote once it is full.
+     *
+     *          plan1   plan2   plan3   plan4   plan5       voteHistory
+     *  iter1   1       0       0       0       0           0
+     *  iter2   0       1       0       0       0           1
+     *  iter3   0       1       0       0       0           1
+     *  iter5   1       0       0       0       0           0
+     *  iter5   0       0       0       1       0           3
      */
-    std::vector< std::vector<int> > votes;
+    std::vector<std::size_t> voteHistory;
+
+    /**Position of the oldest vote in voteHistory*/
+    std::size_t oldestVote;
+
+    /**Number of votes in voteHistory for each plan, i.e. the column sums of the table above*/
+    std::vector<int> voteCounts;
+
+    /**Max. projected DS of each split plan; kept to reuse its storage across cycles*/
+    std::vector<double> maxProjectedDS;
     
     /**Updates the current split plan index to the next split plan index*/
     void updatecurrSplitPlan();
@@ -81,14 +90,14 @@ private:
      * @param DS degree of saturation
      * @return index of the next split plan
      */
-    std::size_t findNextPlanIndex(std::vector<double> DS);
+    std::size_t findNextPlanIndex(const std::vector<double> &DS);
     
     /**
      * Updates the votes data structure
      * @param maxprojectedDS maximum projected DS
      * @return index having the highest vote
      */
-    std::size_t vote(std::vector<double> maxprojectedDS);
+    std::size_t vote(const std::vector<double> &maxprojectedDS);
     
     /**
      * Fills the choice set with default ones based on the number of intersection's approaches
@@ -102,21 +111,21 @@ private:
      * @param phaseDensity the vector holding the degree of saturation values
      * @return 
      */
-    double getMaxDS(std::vector<double> &phaseDensity);
+    double getMaxDS(const std::vector<double> &phaseDensity) const;
     
     /**
      * Finds the split plan index which currently has the maximum vote
      * Note: In votes, columns represent split plan vote
      * @return the split plan index with the maximum votes
      */
-    std::size_t getMaxVotedSplitPlan();
+    std::size_t getMaxVotedSplitPlan() const;
     
     /**
      * Finds the index of the minimum DS among the max projected DS
      * @param maxproDS
      * @return 
      */
-    double findIndexOfMinDS(std::vector<double> maxproDS);
+    std::size_t findIndexOfMinDS(const std::vector<double> &maxproDS) const;
     
     /**
      * Calculates the projected DS and max projected DS for each split plan 
@@ -124,7 +133,7 @@ private:
      * @param maxProjectedDS
      * @param DS
      */
-    void calcMaxProjectedDS(std::vector<double> &maxProjectedDS, std::vector<double> &DS);
+    void calcMaxProjectedDS(std::vector<double> &maxProjectedDS, const std::vector<double> &DS) const;
 
 public:
     SplitPlan(double cycleLength_ = Offset::CLmed, double offset_ = 0);
@@ -148,7 +157,7 @@ public:
      * Updates the split plan based on the phase densities
      * @param phaseDensity
      */
-    void update(std::vector<double> &phaseDensity);
+    void update(const std::vector<double> &phaseDensity);
 
     friend class Signal_SCATS;
 } ;
@@ -42,6 +42,7 @@
 #include "entities/roles/activityRole/ActivityPerformer.hpp"
 #include "entities/roles/driver/driverCommunication/DriverComm.hpp"
 #include "entities/roles/pedestrian/Pedestrian.hpp"
+#include "entities/TrajectoryRecorder.hpp"
 #include "entities/fmodController/FMOD_Controller.hpp"
 #include "geospatial/network/NetworkLoader.hpp"
 #include "logging/ControllerLog.hpp"
@@ -306,6 +307,8 @@ bool performMain(const std::string& configFileName, const std::string& shortConf
         ClosedLoopRunManager::initialise(params.guidanceFile, params.tollFile, params.incentivesFile);
     }
 
+    TrajectoryRecorder::init(stCfg.outputStats.trajectory, config.baseGranMS());
+
     Print() << "Simulating...\n";
 
     //Start work groups and all threads.
@@ -389,6 +392,8 @@ bool performMain(const std::string& configFileName, const std::string& shortConf
     Print() << "100%\n\nTime required to execute the simulation: "
             << DailyTime((uint32_t) loop_time).getStrRepr() << std::endl;
 
+    TrajectoryRecorder::close();
+
     //Finalize partition manager
     if (!config.MPI_Disabled() && config.using_MPI) 
     {
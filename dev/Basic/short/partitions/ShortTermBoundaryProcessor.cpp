@@ -151,6 +151,9 @@ string sim_mob::ShortTermBoundaryProcessor::boundaryProcessing(int time_step)
     mpi::request sends[neighbor_size];
     string all_received_package_data[neighbor_size];
 
+    //The packages must outlive the sends
+    string all_sent_package_data[neighbor_size];
+
     //ready to receive
     std::set<int>::iterator itr_upstream = neighbor_ips.begin();
     index = 0;
@@ -166,9 +169,9 @@ string sim_mob::ShortTermBoundaryProcessor::boundaryProcessing(int time_step)
     index = 0;
     for (; itr_neighbor != neighbor_ips.end(); itr_neighbor++)
     {
-        string data = getDataInPackage(sendout_package[index]);
-        sends[index] = world.isend(sendout_package[index].to_id, (time_step) % 99 + 1, data);
-        index = 0;
+        all_sent_package_data[index] = getDataInPackage(sendout_package[index]);
+        sends[index] = world.isend(sendout_package[index].to_id, (time_step) % 99 + 1, all_sent_package_data[index]);
+        index++;
     }
 
     //waiting for the end of sending and recving
@@ -0,0 +1,140 @@
+//Copyright (c) 2014 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "ClientReadySetUnitTests.hpp"
+
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+
+#include "entities/commsim/broker/ClientReadySet.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::ClientReadySetUnitTests);
+
+
+namespace {
+//Stand-ins for the ClientHandler and ConnectionHandler; the ready set only compares their pointers.
+struct MockClient {};
+struct MockConnection {};
+typedef boost::shared_ptr<MockClient> ClientPtr;
+typedef boost::shared_ptr<MockConnection> ConnPtr;
+typedef ClientReadySet<ClientPtr, ConnPtr> ReadySet;
+
+//Build a farm of clients, all with the same update frequency, with their first updates spread over that many ticks.
+std::vector<ClientPtr> addFarm(ReadySet& readySet, size_t count, unsigned int updateFrequency)
+{
+    std::vector<ClientPtr> res;
+    for (size_t i=0; i<count; i++) {
+        res.push_back(ClientPtr(new MockClient()));
+        readySet.add(res.back(), updateFrequency, i%updateFrequency);
+    }
+    return res;
+}
+
+//A client on its own connection: acknowledge "count" ticks.
+void acknowledgeMany(ReadySet* readySet, ConnPtr conn, int count)
+{
+    for (int i=0; i<count; i++) {
+        readySet->acknowledge(conn);
+    }
+}
+} //End un-named namespace
+
+
+void unit_tests::ClientReadySetUnitTests::test_ClientReadySet_frequency()
+{
+    ReadySet readySet;
+    ClientPtr everyTick(new MockClient());
+    ClientPtr everyThird(new MockClient());
+    readySet.add(everyTick, 1, 0);
+    readySet.add(everyThird, 3, 1);
+
+    const size_t expected[] = {1, 2, 1, 1, 2, 1, 1, 2};
+    for (unsigned int tick=0; tick<8; tick++) {
+        CPPUNIT_ASSERT_EQUAL(expected[tick], readySet.beginTick(tick).size());
+        CPPUNIT_ASSERT(readySet.getReady().front()==everyTick || readySet.getReady().front()==everyThird);
+    }
+
+    //A client registered on an earlier tick than the first one processed is still due right away, then keeps its frequency.
+    ReadySet late;
+    ClientPtr client(new MockClient());
+    late.add(client, 4, 0);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), late.beginTick(10).size());
+    CPPUNIT_ASSERT(late.beginTick(11).empty());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), late.beginTick(14).size());
+}
+
+void unit_tests::ClientReadySetUnitTests::test_ClientReadySet_remove()
+{
+    ReadySet readySet;
+    std::vector<ClientPtr> farm = addFarm(readySet, 10, 1);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(10), readySet.beginTick(0).size());
+
+    readySet.remove(farm[3]);
+    readySet.remove(farm[7]);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(8), readySet.beginTick(1).size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(8), readySet.beginTick(2).size());
+}
+
+void unit_tests::ClientReadySetUnitTests::test_ClientReadySet_idle_farm()
+{
+    //The same 100 active clients, with and without 20000 idle ones (which only want an update every 1000 ticks).
+    const unsigned int Ticks = 2000;
+    ReadySet small;
+    ReadySet large;
+    addFarm(small, 100, 1);
+    addFarm(large, 100, 1);
+    addFarm(large, 20000, 1000);
+
+    size_t smallVisits = 0;
+    size_t largeVisits = 0;
+    for (unsigned int tick=0; tick<Ticks; tick++) {
+        const size_t smallReady = small.beginTick(tick).size();
+        const size_t largeReady = large.beginTick(tick).size();
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(100), smallReady);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(100 + 20000/1000), largeReady);
+        smallVisits += smallReady;
+        largeVisits += largeReady;
+    }
+
+    //200x the registered clients costs only 20% more per tick; polling every client would cost 200x.
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(Ticks*100), smallVisits);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(Ticks*120), largeVisits);
+}
+
+void unit_tests::ClientReadySetUnitTests::test_ClientReadySet_acknowledgements()
+{
+    ReadySet readySet;
+    std::vector<ConnPtr> conns;
+    for (int i=0; i<50; i++) {
+        conns.push_back(ConnPtr(new MockConnection()));
+        readySet.expect(conns.back());
+        readySet.expect(conns.back());
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(50), readySet.getPendingConnections());
+
+    //An acknowledgement from a connection that was never sent a tick is rejected.
+    CPPUNIT_ASSERT(!readySet.acknowledge(ConnPtr(new MockConnection())));
+
+    //One connection goes away; the rest acknowledge from their own threads.
+    readySet.cancel(conns.front());
+    boost::thread_group farm;
+    for (size_t i=1; i<conns.size(); i++) {
+        farm.create_thread(boost::bind(&acknowledgeMany, &readySet, conns[i], 2));
+    }
+    readySet.waitForAcknowledgements();
+    farm.join_all();
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), readySet.getPendingConnections());
+
+    //Extra acknowledgements are rejected, and the next tick starts clean.
+    CPPUNIT_ASSERT(!readySet.acknowledge(conns[1]));
+    readySet.endTick();
+    readySet.expect(conns[1]);
+    CPPUNIT_ASSERT(readySet.acknowledge(conns[1]));
+    readySet.waitForAcknowledgements();
+}
@@ -0,0 +1,42 @@
+//Copyright (c) 2014 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the Broker's ready set, using a farm of mock clients.
+ */
+class ClientReadySetUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///Clients are due according to their update frequency.
+    void test_ClientReadySet_frequency();
+
+    ///Removed clients are dropped when they next come due.
+    void test_ClientReadySet_remove();
+
+    ///The clients visited per tick follow the active clients, not the registered ones.
+    void test_ClientReadySet_idle_farm();
+
+    ///Acknowledgements from many connections (on other threads) release the waiting Broker exactly once.
+    void test_ClientReadySet_acknowledgements();
+
+private:
+#ifndef SIMMOB_DISABLE_MPI
+    CPPUNIT_TEST_SUITE(ClientReadySetUnitTests);
+      CPPUNIT_TEST(test_ClientReadySet_frequency);
+      CPPUNIT_TEST(test_ClientReadySet_remove);
+      CPPUNIT_TEST(test_ClientReadySet_idle_farm);
+      CPPUNIT_TEST(test_ClientReadySet_acknowledgements);
+    CPPUNIT_TEST_SUITE_END();
+#endif
+};
+
+}
@@ -0,0 +1,163 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "CommsimSerializerUnitTests.hpp"
+
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "entities/commsim/serialization/CommsimSerializer.hpp"
+#include "geospatial/coord/CoordinateTransform.hpp"
+#include "geospatial/RoadRunnerRegion.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::CommsimSerializerUnitTests);
+
+
+namespace {
+//Bundle the given messages, send the bundle through its (serialized) header, and read it back.
+void roundTrip(const std::vector<std::string>& msgs, MessageConglomerate& res)
+{
+    OngoingSerialization ongoing;
+    CommsimSerializer::serialize_begin(ongoing, "17");
+    for (std::vector<std::string>::const_iterator it=msgs.begin(); it!=msgs.end(); it++) {
+        CommsimSerializer::addGeneric(ongoing, *it);
+    }
+
+    BundleHeader header;
+    std::string data;
+    CommsimSerializer::serialize_end(ongoing, header, data);
+
+    BundleHeader readHeader = BundleParser::read_bundle_header(BundleParser::make_bundle_header(header));
+    CPPUNIT_ASSERT(CommsimSerializer::deserialize(readHeader, data, res));
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(msgs.size()), res.getCount());
+}
+
+//Check an opaque_send/opaque_receive pair produced by makeOpaque(binary).
+void checkOpaque(bool binary)
+{
+    //Includes quotes and a NUL, which only the binary codec carries unescaped.
+    const std::string data = binary ? std::string("a\"b\0c", 5) : std::string("YWJj");
+    std::vector<std::string> toIds;
+    toIds.push_back("3");
+    toIds.push_back("4");
+
+    std::vector<std::string> msgs;
+    msgs.push_back(CommsimSerializer::makeOpaqueSend("2", toIds, "base64", "dsrc", false, data, binary));
+    msgs.push_back(CommsimSerializer::makeOpaqueReceive("2", "4", "base64", "lte", data, binary));
+
+    MessageConglomerate conglom;
+    roundTrip(msgs, conglom);
+    CPPUNIT_ASSERT_EQUAL(std::string("0"), conglom.getSenderId());
+    CPPUNIT_ASSERT_EQUAL(binary, conglom.getJsonMessage(0).isNull());
+
+    OpaqueSendMessage send = CommsimSerializer::parseOpaqueSend(conglom, 0);
+    CPPUNIT_ASSERT_EQUAL(std::string("opaque_send"), send.msg_type);
+    CPPUNIT_ASSERT_EQUAL(std::string("2"), send.fromId);
+    CPPUNIT_ASSERT(send.toIds == toIds);
+    CPPUNIT_ASSERT_EQUAL(std::string("base64"), send.format);
+    CPPUNIT_ASSERT_EQUAL(std::string("dsrc"), send.tech);
+    CPPUNIT_ASSERT(!send.broadcast);
+    CPPUNIT_ASSERT_EQUAL(data, send.data);
+
+    OpaqueReceiveMessage rec = CommsimSerializer::parseOpaqueReceive(conglom, 1);
+    CPPUNIT_ASSERT_EQUAL(std::string("opaque_receive"), rec.msg_type);
+    CPPUNIT_ASSERT_EQUAL(std::string("2"), rec.fromId);
+    CPPUNIT_ASSERT_EQUAL(std::string("4"), rec.toId);
+    CPPUNIT_ASSERT_EQUAL(std::string("lte"), rec.tech);
+    CPPUNIT_ASSERT_EQUAL(data, rec.data);
+}
+} //End un-named namespace
+
+
+void unit_tests::CommsimSerializerUnitTests::test_CommsimSerializer_json_roundtrip()
+{
+    checkOpaque(false);
+}
+
+void unit_tests::CommsimSerializerUnitTests::test_CommsimSerializer_binary_roundtrip()
+{
+    checkOpaque(true);
+}
+
+void unit_tests::CommsimSerializerUnitTests::test_CommsimSerializer_mixed_bundle()
+{
+    std::vector<std::string> msgs;
+    msgs.push_back(CommsimSerializer::makeOpaqueReceive("1", "2", "text", "dsrc", "json", false));
+    msgs.push_back(CommsimSerializer::makeOpaqueReceive("1", "2", "text", "dsrc", "binary", true));
+    msgs.push_back(CommsimSerializer::makeTickedSimMob(5, 100, false));
+
+    MessageConglomerate conglom;
+    roundTrip(msgs, conglom);
+    CPPUNIT_ASSERT_EQUAL(std::string("json"), CommsimSerializer::parseOpaqueReceive(conglom, 0).data);
+    CPPUNIT_ASSERT_EQUAL(std::string("binary"), CommsimSerializer::parseOpaqueReceive(conglom, 1).data);
+    CPPUNIT_ASSERT_EQUAL(std::string("ticked_simmob"), conglom.getBaseMessage(2).msg_type);
+}
+
+void unit_tests::CommsimSerializerUnitTests::test_CommsimSerializer_binary_types()
+{
+    std::vector<unsigned int> agents;
+    agents.push_back(10);
+    std::map<unsigned int, Point> locs;
+    locs[10] = Point(1.5, -2.5);
+    RoadRunnerRegion region;
+    region.id = 9;
+    region.points.push_back(LatLngLocation(1.3, 103.8));
+    std::vector<RoadRunnerRegion> regions(1, region);
+
+    for (int binary=0; binary<2; binary++) {
+        std::vector<std::string> msgs;
+        msgs.push_back(CommsimSerializer::makeIdRequest("tok", binary));
+        msgs.push_back(CommsimSerializer::makeIdAck(binary));
+        msgs.push_back(CommsimSerializer::makeTickedSimMob(1, 100, binary));
+        msgs.push_back(CommsimSerializer::makeLocation(3, 4, LatLngLocation(1.3, 103.8), binary));
+        msgs.push_back(CommsimSerializer::makeRegionsAndPath(regions, regions, binary));
+        msgs.push_back(CommsimSerializer::makeNewAgents(agents, std::vector<unsigned int>(), binary));
+        msgs.push_back(CommsimSerializer::makeAllLocations(locs, binary));
+
+        MessageConglomerate conglom;
+        roundTrip(msgs, conglom);
+        CPPUNIT_ASSERT_EQUAL(std::string("id_request"), conglom.getBaseMessage(0).msg_type);
+        CPPUNIT_ASSERT_EQUAL(std::string("id_ack"), conglom.getBaseMessage(1).msg_type);
+        CPPUNIT_ASSERT_EQUAL(std::string("ticked_simmob"), conglom.getBaseMessage(2).msg_type);
+        CPPUNIT_ASSERT_EQUAL(std::string("location"), conglom.getBaseMessage(3).msg_type);
+        CPPUNIT_ASSERT_EQUAL(std::string("regions_and_path"), conglom.getBaseMessage(4).msg_type);
+        CPPUNIT_ASSERT_EQUAL(std::string("new_agents"), conglom.getBaseMessage(5).msg_type);
+        CPPUNIT_ASSERT_EQUAL(std::string("all_locations"), conglom.getBaseMessage(6).msg_type);
+    }
+}
+
+void unit_tests::CommsimSerializerUnitTests::test_CommsimSerializer_binary_layout()
+{
+    const unsigned char expected[] = {0xBB, BIN_MSG_TICKED_SIMMOB, 0x04, 0x03, 0x02, 0x01, 0x64, 0x00, 0x00, 0x00};
+    CPPUNIT_ASSERT_EQUAL(std::string(reinterpret_cast<const char*>(expected), sizeof(expected)), CommsimSerializer::makeTickedSimMob(0x01020304, 100, true));
+
+    //The binary form should be considerably smaller than the JSON form.
+    std::map<unsigned int, Point> locs;
+    for (unsigned int i=0; i<100; i++) {
+        locs[1000+i] = Point(37215.25+i, 14498.75-i);
+    }
+    const std::string binMsg = CommsimSerializer::makeAllLocations(locs, true);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2 + 4 + 100*(4+8+8)), binMsg.size());
+    CPPUNIT_ASSERT(binMsg.size() < CommsimSerializer::makeAllLocations(locs, false).size());
+}
+
+void unit_tests::CommsimSerializerUnitTests::test_CommsimSerializer_binary_errors()
+{
+    //Truncated message: the type parses, but reading the fields fails.
+    std::string msg = CommsimSerializer::makeOpaqueReceive("1", "2", "text", "dsrc", "payload", true);
+    msg.resize(msg.size()-3);
+    MessageConglomerate truncated;
+    roundTrip(std::vector<std::string>(1, msg), truncated);
+    CPPUNIT_ASSERT_EQUAL(std::string("opaque_receive"), truncated.getBaseMessage(0).msg_type);
+    CPPUNIT_ASSERT_THROW(CommsimSerializer::parseOpaqueReceive(truncated, 0), std::runtime_error);
+
+    //Unknown type code.
+    const char unknown[] = {static_cast<char>(0xBB), static_cast<char>(0xFE)};
+    MessageConglomerate badType;
+    CPPUNIT_ASSERT_THROW(roundTrip(std::vector<std::string>(1, std::string(unknown, 2)), badType), std::runtime_error);
+}
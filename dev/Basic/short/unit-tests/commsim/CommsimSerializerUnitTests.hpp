@@ -0,0 +1,48 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the commsim message codecs (JSON and binary) inside v1 bundles.
+ */
+class CommsimSerializerUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///Round-trip opaque messages through a bundle using each codec.
+    void test_CommsimSerializer_json_roundtrip();
+    void test_CommsimSerializer_binary_roundtrip();
+
+    ///JSON and binary messages can share a bundle.
+    void test_CommsimSerializer_mixed_bundle();
+
+    ///Every binary message reports the same msg_type as its JSON counterpart.
+    void test_CommsimSerializer_binary_types();
+
+    ///Binary fields are packed little-endian after the marker and type code.
+    void test_CommsimSerializer_binary_layout();
+
+    ///Malformed binary messages are rejected.
+    void test_CommsimSerializer_binary_errors();
+
+private:
+#ifndef SIMMOB_DISABLE_MPI
+    CPPUNIT_TEST_SUITE(CommsimSerializerUnitTests);
+      CPPUNIT_TEST(test_CommsimSerializer_json_roundtrip);
+      CPPUNIT_TEST(test_CommsimSerializer_binary_roundtrip);
+      CPPUNIT_TEST(test_CommsimSerializer_mixed_bundle);
+      CPPUNIT_TEST(test_CommsimSerializer_binary_types);
+      CPPUNIT_TEST(test_CommsimSerializer_binary_layout);
+      CPPUNIT_TEST(test_CommsimSerializer_binary_errors);
+    CPPUNIT_TEST_SUITE_END();
+#endif
+};
+
+}
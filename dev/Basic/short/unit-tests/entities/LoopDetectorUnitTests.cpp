@@ -0,0 +1,199 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "LoopDetectorUnitTests.hpp"
+
+#include <vector>
+#include "config/ST_Config.hpp"
+#include "entities/LoopDetectorEntity.hpp"
+#include "entities/Person_ST.hpp"
+#include "entities/roles/driver/Driver.hpp"
+#include "entities/roles/driver/DriverFacets.hpp"
+#include "entities/roles/driver/OnCallDriver.hpp"
+#include "entities/roles/driver/OnCallDriverFacets.hpp"
+#include "entities/vehicle/Vehicle.hpp"
+#include "geospatial/network/Lane.hpp"
+#include "geospatial/network/Link.hpp"
+#include "geospatial/network/Point.hpp"
+#include "geospatial/network/PolyLine.hpp"
+#include "geospatial/network/RoadSegment.hpp"
+#include "geospatial/network/WayPoint.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::LoopDetectorUnitTests);
+
+namespace {
+
+const double LANE_LENGTH = 100;
+
+//Distances to the end of the lane, before, over and past the loop detector ([0.5, 4.5] m)
+const double BEFORE = 10;
+const double OVER = 3;
+const double PAST = 0.2;
+
+//Lets the test flip the counts that the loop detector sets, as the workers would at the end of a tick
+struct FlippableCounts : public Shared<Sensor::CountAndTimePair> {
+    FlippableCounts() : Shared<Sensor::CountAndTimePair>(MtxStrat_Buffered) {}
+    using Shared<Sensor::CountAndTimePair>::flip;
+};
+
+//A link made of one segment with one lane, 100 m long, with a loop detector at its end.
+struct TestLane {
+    TestLane() : lane(new Lane()), segment(new RoadSegment()), detector(nullptr) {
+        PolyLine* polyLine = new PolyLine();
+        polyLine->addPoint(PolyPoint(1, 0, 0, 0, 0));
+        polyLine->addPoint(PolyPoint(2, 1, LANE_LENGTH, 0, 0));
+        polyLine->setLength(LANE_LENGTH);
+        lane->setPolyLine(polyLine);
+        lane->setWidth(3.5);
+        lane->setParentSegment(segment);
+        segment->addLane(lane);
+        segment->setParentLink(&link);
+        link.addRoadSegment(segment);
+        path.push_back(WayPoint(segment));
+        detector = new LoopDetector(lane, 4, countAndTime);
+    }
+
+    ~TestLane() {
+        delete detector;
+    }
+
+    Sensor::CountAndTimePair counts() const {
+        return countAndTime.get();
+    }
+
+    Lane* lane;
+    RoadSegment* segment;
+    Link link;
+    std::vector<WayPoint> path;
+    FlippableCounts countAndTime;
+    LoopDetector* detector;
+};
+
+//A person driving on the test lane; the driver owns the movement.
+struct TestDriver {
+    TestDriver(TestLane& testLane, bool onCall = false)
+        : person("LoopDetectorUnitTests", MtxStrat_Buffered), vehicle(VehicleBase::CAR, 4, 2, "car"),
+          driver(nullptr), onCallDriver(nullptr), movement(nullptr), onCallMovement(nullptr)
+    {
+        if (onCall) {
+            onCallMovement = new OnCallDriverMovement();
+            onCallDriver = new OnCallDriver(&person, MtxStrat_Buffered, nullptr, onCallMovement,
+                                                          "onCallDriver", Role<Person_ST>::RL_ON_CALL_DRIVER);
+            onCallMovement->setOnCallDriver(onCallDriver);
+            driver = onCallDriver;
+            movement = onCallMovement;
+        } else {
+            movement = new DriverMovement();
+            driver = new Driver(&person, MtxStrat_Buffered, nullptr, movement);
+        }
+        movement->setParentDriver(driver);
+        driver->setVehicle(&vehicle);
+        movement->fwdDriverMovement.setPath(testLane.path);
+    }
+
+    ~TestDriver() {
+        //The movement is destroyed with the driver
+        delete driver;
+    }
+
+    Person_ST person;
+    Vehicle vehicle;
+    Driver* driver;
+    OnCallDriver* onCallDriver;
+    DriverMovement* movement;
+    OnCallDriverMovement* onCallMovement;
+};
+
+std::vector<Person_ST const *> entered;
+
+//Runs the loop detector at the given time, and flips its counts at the end of the tick
+bool Check(TestLane& testLane, unsigned int time) {
+    entered.clear();
+    bool occupied = testLane.detector->check(timeslice(time / 100, time), entered);
+    testLane.countAndTime.flip();
+    return occupied;
+}
+
+} //End anon namespace
+
+void unit_tests::LoopDetectorUnitTests::moveTo(DriverMovement& movement, double distToEnd, unsigned int time)
+{
+    movement.fwdDriverMovement.advance(movement.fwdDriverMovement.getDistToEndOfCurrWayPt() - distToEnd);
+    movement.updateLoopDetector(time);
+}
+
+void unit_tests::LoopDetectorUnitTests::test_driver_crossing()
+{
+    TestLane testLane;
+    TestDriver driver(testLane);
+    unsigned int spaceTimeStep = ST_Config::getInstance().personTimeStepInMilliSeconds();
+
+    moveTo(*driver.movement, BEFORE, 100);
+    CPPUNIT_ASSERT(!Check(testLane, 200));
+    moveTo(*driver.movement, OVER + 0.5, 200);
+    CPPUNIT_ASSERT(Check(testLane, 300));
+    CPPUNIT_ASSERT(entered.size() == 1 && entered.front() == &driver.person);
+    moveTo(*driver.movement, OVER, 300);
+    CPPUNIT_ASSERT(Check(testLane, 400));
+    moveTo(*driver.movement, PAST, 400);
+    CPPUNIT_ASSERT(!Check(testLane, 500));
+
+    Sensor::CountAndTimePair counts = testLane.counts();
+    CPPUNIT_ASSERT_EQUAL((size_t) 1, counts.vehicleCount);
+    CPPUNIT_ASSERT_EQUAL(2 * spaceTimeStep, counts.spaceTimeInMilliSeconds);
+}
+
+void unit_tests::LoopDetectorUnitTests::test_destroyed_driver_leaves()
+{
+    TestLane testLane;
+    TestDriver* driver = new TestDriver(testLane);
+
+    moveTo(*driver->movement, OVER, 100);
+    CPPUNIT_ASSERT(Check(testLane, 200));
+
+    //The movement is destroyed with the driver
+    delete driver;
+    CPPUNIT_ASSERT(!Check(testLane, 300));
+    CPPUNIT_ASSERT(entered.empty());
+    CPPUNIT_ASSERT_EQUAL((size_t) 1, testLane.counts().vehicleCount);
+}
+
+void unit_tests::LoopDetectorUnitTests::test_parked_driver_leaves()
+{
+    TestLane testLane;
+    TestDriver driver(testLane, true);
+    OnCallDriver* onCallDriver = driver.onCallDriver;
+
+    moveTo(*driver.movement, OVER, 100);
+    CPPUNIT_ASSERT(Check(testLane, 200));
+
+    //A parked vehicle is not moved, so only the parking reports that it left
+    onCallDriver->setDriverStatus(PARKED);
+    onCallDriver->getParams().now = timeslice(2, 200);
+    driver.onCallMovement->frame_tick();
+    CPPUNIT_ASSERT(Check(testLane, 200));
+    CPPUNIT_ASSERT(!Check(testLane, 300));
+}
+
+void unit_tests::LoopDetectorUnitTests::test_one_count_per_tick()
+{
+    TestLane testLane;
+    TestDriver first(testLane);
+    TestDriver second(testLane);
+
+    moveTo(*first.movement, OVER + 1, 100);
+    moveTo(*second.movement, OVER, 100);
+    CPPUNIT_ASSERT(Check(testLane, 200));
+    CPPUNIT_ASSERT_EQUAL((size_t) 1, entered.size());
+    CPPUNIT_ASSERT_EQUAL((size_t) 1, testLane.counts().vehicleCount);
+
+    //The other driver is counted at the next tick, as it is still over the loop detector
+    CPPUNIT_ASSERT(Check(testLane, 300));
+    CPPUNIT_ASSERT_EQUAL((size_t) 2, testLane.counts().vehicleCount);
+
+    CPPUNIT_ASSERT(Check(testLane, 400));
+    CPPUNIT_ASSERT_EQUAL((size_t) 2, testLane.counts().vehicleCount);
+}
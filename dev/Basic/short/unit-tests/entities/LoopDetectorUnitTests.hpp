@@ -0,0 +1,49 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace sim_mob
+{
+class DriverMovement;
+class LoopDetector;
+}
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the loop detectors, fed by the drivers moving over them.
+ */
+class LoopDetectorUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///A driver moving over the loop detector is counted once, and leaves it when it moves off.
+    void test_driver_crossing();
+
+    ///A driver destroyed while over the loop detector no longer occupies it.
+    void test_destroyed_driver_leaves();
+
+    ///An on-call driver which parks over the loop detector no longer occupies it.
+    void test_parked_driver_leaves();
+
+    ///Two drivers moving onto the loop detector in the same tick are not both counted in that tick.
+    void test_one_count_per_tick();
+
+private:
+    ///Moves the driver to the given distance from the end of the lane, and reports it to the loop detectors.
+    static void moveTo(sim_mob::DriverMovement& movement, double distToEnd, unsigned int time);
+
+    CPPUNIT_TEST_SUITE(LoopDetectorUnitTests);
+        CPPUNIT_TEST(test_driver_crossing);
+        CPPUNIT_TEST(test_destroyed_driver_leaves);
+        CPPUNIT_TEST(test_parked_driver_leaves);
+        CPPUNIT_TEST(test_one_count_per_tick);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
@@ -0,0 +1,51 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+/*
+ * Converts a columnar statistics file (e.g. the mid-term <supply_stats format="binary"/> output)
+ * back to the text lines the simulator writes in text mode.
+ *
+ * Usage: columnar-to-csv <input file> [<output file>]
+ * Without an output file, the lines are written to stdout.
+ */
+
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include "util/ColumnarOutput.hpp"
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || argc > 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <input file> [<output file>]" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        sim_mob::ColumnarReader reader(argv[1]);
+        std::size_t numRecords = 0;
+        if (argc == 3)
+        {
+            std::ofstream out(argv[2]);
+            if (!out.is_open())
+            {
+                throw std::runtime_error(std::string("cannot open output file ") + argv[2]);
+            }
+            numRecords = reader.writeCsv(out);
+        }
+        else
+        {
+            numRecords = reader.writeCsv(std::cout);
+        }
+        std::cerr << numRecords << " records converted" << std::endl;
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,252 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+/*
+ * Compares the JSON and binary commsim message codecs over a local loopback connection.
+ *
+ * Usage: commsim-codec-bench [<agents> [<ticks> [<opaque messages per tick>]]]
+ *
+ * Each tick, the "broker" side serializes a bundle like the one ns-3 receives (all_locations for every agent,
+ * a few opaque_receive messages and ticked_simmob) and writes it to a TCP socket on 127.0.0.1. A stand-in client
+ * thread reads each bundle, deserializes it and decodes every field of every message.
+ * The encode time, wire size and end-to-end throughput are printed for each codec.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "entities/commsim/serialization/CommsimSerializer.hpp"
+
+using namespace sim_mob;
+
+namespace
+{
+
+void writeAll(int fd, const std::string& data)
+{
+    std::size_t sent = 0;
+    while (sent < data.size())
+    {
+        ssize_t res = ::send(fd, data.data() + sent, data.size() - sent, 0);
+        if (res <= 0)
+        {
+            throw std::runtime_error("send() failed.");
+        }
+        sent += res;
+    }
+}
+
+void readAll(int fd, std::string& data, std::size_t len)
+{
+    data.resize(len);
+    std::size_t got = 0;
+    while (got < len)
+    {
+        ssize_t res = ::recv(fd, &data[got], len - got, 0);
+        if (res <= 0)
+        {
+            throw std::runtime_error("recv() failed.");
+        }
+        got += res;
+    }
+}
+
+std::uint32_t readUInt(const unsigned char*& curr)
+{
+    std::uint32_t res = curr[0] | (curr[1] << 8) | (curr[2] << 16) | (static_cast<std::uint32_t>(curr[3]) << 24);
+    curr += 4;
+    return res;
+}
+
+double readDouble(const unsigned char*& curr)
+{
+    std::uint64_t bits = 0;
+    for (int i = 0; i < 8; ++i)
+    {
+        bits |= static_cast<std::uint64_t>(curr[i]) << (8 * i);
+    }
+    curr += 8;
+    double res;
+    std::memcpy(&res, &bits, sizeof(res));
+    return res;
+}
+
+///What the stand-in client saw; the checksum keeps the decoding from being optimized away.
+struct ClientTotals
+{
+    unsigned long messages = 0;
+    unsigned long bytes = 0;
+    double checksum = 0;
+};
+
+///Decodes every field of an all_locations message, in whichever format it arrived.
+void decodeAllLocations(const MessageConglomerate& conglom, int msgNumber, ClientTotals& totals)
+{
+    const Json::Value& json = conglom.getJsonMessage(msgNumber);
+    if (!json.isNull())
+    {
+        const Json::Value& locs = json["locations"];
+        for (unsigned int i = 0; i < locs.size(); ++i)
+        {
+            totals.checksum += std::strtoul(locs[i]["id"].asCString(), nullptr, 10) + locs[i]["x"].asDouble()
+                    + locs[i]["y"].asDouble();
+        }
+        return;
+    }
+
+    int offset = 0;
+    int length = 0;
+    conglom.getRawMessage(msgNumber, offset, length);
+    const unsigned char* curr = reinterpret_cast<const unsigned char*>(conglom.getUnderlyingString().data()) + offset + 2;
+    std::uint32_t count = readUInt(curr);
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        totals.checksum += readUInt(curr);
+        totals.checksum += readDouble(curr);
+        totals.checksum += readDouble(curr);
+    }
+}
+
+///The stand-in client: reads bundles until it has seen the given number of ticks.
+void runClient(int fd, unsigned int numTicks, ClientTotals& totals)
+{
+    std::string header;
+    std::string data;
+    for (unsigned int ticks = 0; ticks < numTicks;)
+    {
+        readAll(fd, header, header_length);
+        BundleHeader bHead = BundleParser::read_bundle_header(header);
+        readAll(fd, data, bHead.remLen);
+        totals.bytes += header_length + bHead.remLen;
+
+        MessageConglomerate conglom;
+        if (!CommsimSerializer::deserialize(bHead, data, conglom))
+        {
+            throw std::runtime_error("Stand-in client couldn't parse bundle.");
+        }
+        for (int i = 0; i < conglom.getCount(); ++i)
+        {
+            const std::string type = conglom.getBaseMessage(i).msg_type;
+            if (type == "all_locations")
+            {
+                decodeAllLocations(conglom, i, totals);
+            }
+            else if (type == "opaque_receive")
+            {
+                totals.checksum += CommsimSerializer::parseOpaqueReceive(conglom, i).data.size();
+            }
+            else if (type == "ticked_simmob")
+            {
+                ++ticks;
+            }
+            ++totals.messages;
+        }
+    }
+}
+
+void run(const char* name, bool binary, std::size_t numAgents, unsigned int numTicks, unsigned int numOpaque)
+{
+    //Listen on an ephemeral loopback port and connect the stand-in client to it.
+    int listenFd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addrLen = sizeof(addr);
+    if (::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(listenFd, 1) != 0
+            || ::getsockname(listenFd, reinterpret_cast<sockaddr*>(&addr), &addrLen) != 0)
+    {
+        throw std::runtime_error("Couldn't listen on the loopback interface.");
+    }
+    int clientFd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (::connect(clientFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+    {
+        throw std::runtime_error("Couldn't connect to the loopback interface.");
+    }
+    int serverFd = ::accept(listenFd, nullptr, nullptr);
+    int noDelay = 1;
+    ::setsockopt(serverFd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+    ClientTotals totals;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::thread client(runClient, clientFd, numTicks, std::ref(totals));
+
+    //Agents drift a little each tick, so every bundle is different.
+    std::map<unsigned int, Point> allLocs;
+    const std::string payload(64, 'A');
+    double encodeTime = 0;
+    for (unsigned int tick = 0; tick < numTicks; ++tick)
+    {
+        std::chrono::steady_clock::time_point encStart = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < numAgents; ++i)
+        {
+            allLocs[1000 + i] = Point(37215.25 + i + 0.5 * tick, 14498.75 - i + 0.25 * tick);
+        }
+        OngoingSerialization ongoing;
+        CommsimSerializer::serialize_begin(ongoing, "1");
+        CommsimSerializer::addGeneric(ongoing, CommsimSerializer::makeAllLocations(allLocs, binary));
+        for (unsigned int i = 0; i < numOpaque; ++i)
+        {
+            CommsimSerializer::addGeneric(ongoing, CommsimSerializer::makeOpaqueReceive("1000", "1001", "base64", "dsrc", payload, binary));
+        }
+        CommsimSerializer::addGeneric(ongoing, CommsimSerializer::makeTickedSimMob(tick, 100, binary));
+        BundleHeader header;
+        std::string message;
+        CommsimSerializer::serialize_end(ongoing, header, message);
+        std::string bundle = BundleParser::make_bundle_header(header) + message;
+        encodeTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - encStart).count();
+
+        writeAll(serverFd, bundle);
+    }
+    client.join();
+    double totalTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    ::close(serverFd);
+    ::close(clientFd);
+    ::close(listenFd);
+
+    std::cout << std::left << std::setw(8) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(14) << 1e3 * encodeTime / numTicks << std::setw(14) << totals.bytes / numTicks
+              << std::setw(14) << 1e3 * totalTime / numTicks << std::setw(14) << std::setprecision(0)
+              << totals.messages / totalTime << std::setw(12) << std::setprecision(1)
+              << totals.bytes / totalTime / (1024 * 1024) << "   (checksum " << std::setprecision(0)
+              << totals.checksum << ")" << std::endl;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t numAgents = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 500;
+    unsigned int numTicks = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 2000;
+    unsigned int numOpaque = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : 20;
+    if (numAgents == 0 || numTicks == 0 || numOpaque + 2 > 255)
+    {
+        std::cerr << "Usage: commsim-codec-bench [<agents> [<ticks> [<opaque messages per tick (max 253)>]]]"
+                  << std::endl;
+        return 1;
+    }
+
+    std::cout << numAgents << " agents, " << numTicks << " ticks, " << numOpaque << " opaque messages per tick\n"
+              << std::left << std::setw(8) << "codec" << std::right << std::setw(14) << "encode ms" << std::setw(14)
+              << "bytes/tick" << std::setw(14) << "ms/tick" << std::setw(14) << "msgs/s" << std::setw(12) << "MB/s"
+              << std::endl;
+    run("json", false, numAgents, numTicks, numOpaque);
+    run("binary", true, numAgents, numTicks, numOpaque);
+    return 0;
+}
@@ -0,0 +1,229 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+/*
+ * Compares the storage used by Workers for their entities: the std::set used before, and the EntityList
+ * in each of its orderings.
+ *
+ * Usage: entity-list-bench [<entities> [<ticks> [<churn per tick>]]]
+ *
+ * Each tick removes and adds <churn per tick> entities (as agents finishing and starting their trips do),
+ * prepares the list and then calls a virtual update on every entity, like Worker::update_entities.
+ * The time per tick and per entity update is printed for each storage.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <set>
+#include <vector>
+#include "workers/EntityList.hpp"
+
+namespace
+{
+
+class BenchEntity
+{
+public:
+    explicit BenchEntity(unsigned int id) :
+            workerSlot(sim_mob::BasicEntityList<BenchEntity>::NO_SLOT), id(id), position(0), speed(1 + id % 7)
+    {
+    }
+
+    virtual ~BenchEntity()
+    {
+    }
+
+    unsigned int getId() const
+    {
+        return id;
+    }
+
+    virtual void update()
+    {
+        position += speed;
+    }
+
+    double getPosition() const
+    {
+        return position;
+    }
+
+private:
+    template <typename T> friend class sim_mob::BasicEntityList;
+    unsigned int workerSlot;
+    unsigned int id;
+    double position;
+    double speed;
+};
+
+//A second type, so that ORDER_TYPE has something to group.
+class OtherBenchEntity : public BenchEntity
+{
+public:
+    explicit OtherBenchEntity(unsigned int id) : BenchEntity(id)
+    {
+    }
+
+    virtual void update()
+    {
+        BenchEntity::update();
+        BenchEntity::update();
+    }
+};
+
+typedef sim_mob::BasicEntityList<BenchEntity> List;
+
+//The previous Worker storage.
+struct SetStorage
+{
+    std::set<BenchEntity*> entities;
+
+    void insert(BenchEntity* entity)
+    {
+        entities.insert(entity);
+    }
+
+    void erase(BenchEntity* entity)
+    {
+        entities.erase(entity);
+    }
+
+    void prepare()
+    {
+    }
+
+    void update()
+    {
+        for (std::set<BenchEntity*>::iterator it = entities.begin(); it != entities.end(); ++it)
+        {
+            (*it)->update();
+        }
+    }
+};
+
+struct ListStorage
+{
+    explicit ListStorage(List::Ordering ordering) : entities(ordering)
+    {
+    }
+
+    void insert(BenchEntity* entity)
+    {
+        entities.insert(entity);
+    }
+
+    void erase(BenchEntity* entity)
+    {
+        entities.erase(entity);
+    }
+
+    void prepare()
+    {
+        entities.prepare();
+    }
+
+    void update()
+    {
+        for (List::const_iterator it = entities.begin(); it != entities.end(); ++it)
+        {
+            (*it)->update();
+        }
+    }
+
+    List entities;
+};
+
+template <typename Storage>
+void run(const char* name, Storage& storage, std::vector<BenchEntity*>& pool, std::size_t numEntities,
+         unsigned int numTicks, std::size_t churn)
+{
+    //the same sequence of removals and additions for every storage
+    std::mt19937 rng(42);
+    std::vector<BenchEntity*> active(pool.begin(), pool.begin() + numEntities);
+    std::vector<BenchEntity*> idle(pool.begin() + numEntities, pool.end());
+    for (std::vector<BenchEntity*>::iterator it = active.begin(); it != active.end(); ++it)
+    {
+        storage.insert(*it);
+    }
+
+    double churnTime = 0;
+    double updateTime = 0;
+    for (unsigned int tick = 0; tick < numTicks; ++tick)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < churn && !active.empty() && !idle.empty(); ++i)
+        {
+            std::size_t out = rng() % active.size();
+            std::size_t in = rng() % idle.size();
+            storage.erase(active[out]);
+            storage.insert(idle[in]);
+            std::swap(active[out], idle[in]);
+        }
+        storage.prepare();
+        std::chrono::steady_clock::time_point mid = std::chrono::steady_clock::now();
+        storage.update();
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+        churnTime += std::chrono::duration<double>(mid - start).count();
+        updateTime += std::chrono::duration<double>(end - mid).count();
+    }
+
+    std::cout << std::left << std::setw(12) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(12) << 1e3 * churnTime / numTicks << std::setw(12) << 1e3 * updateTime / numTicks
+              << std::setw(14) << 1e9 * updateTime / (numTicks * (double) numEntities) << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t numEntities = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    unsigned int numTicks = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 100;
+    std::size_t churn = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : numEntities / 100;
+    if (numEntities == 0 || numTicks == 0)
+    {
+        std::cerr << "Usage: entity-list-bench [<entities> [<ticks> [<churn per tick>]]]" << std::endl;
+        return 1;
+    }
+
+    //allocate twice as many entities as are active, interleaving types, in shuffled order as agents loaded
+    //from the population would be
+    std::vector<BenchEntity*> pool;
+    for (unsigned int id = 0; id < 2 * numEntities; ++id)
+    {
+        pool.push_back((id % 3 == 0) ? new OtherBenchEntity(id) : new BenchEntity(id));
+    }
+    std::shuffle(pool.begin(), pool.end(), std::mt19937(7));
+
+    std::cout << numEntities << " entities, " << numTicks << " ticks, " << churn << " removed and added per tick\n"
+              << std::left << std::setw(12) << "storage" << std::right << std::setw(12) << "churn ms" << std::setw(12)
+              << "update ms" << std::setw(14) << "ns/entity" << std::endl;
+
+    {
+        SetStorage storage;
+        run("std::set", storage, pool, numEntities, numTicks, churn);
+    }
+    {
+        ListStorage storage(List::ORDER_NONE);
+        run("list none", storage, pool, numEntities, numTicks, churn);
+    }
+    {
+        ListStorage storage(List::ORDER_ID);
+        run("list id", storage, pool, numEntities, numTicks, churn);
+    }
+    {
+        ListStorage storage(List::ORDER_TYPE);
+        run("list type", storage, pool, numEntities, numTicks, churn);
+    }
+
+    for (std::vector<BenchEntity*>::iterator it = pool.begin(); it != pool.end(); ++it)
+    {
+        delete *it;
+    }
+    return 0;
+}
@@ -0,0 +1,176 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+/*
+ * Converts a short-term trajectory file (<trajectory enabled="true"/> in the short-term config) to text.
+ *
+ * Usage: trajectory-convert [--csv] <input file> [<output file>]
+ *
+ * By default the positions are printed in the format of the simulator's per-tick output, which the visualiser reads.
+ * The "info" field only holds the <AMOD>/<Taxi> markers, and AMOD vehicles are identified by their person id.
+ * With --csv, one line per position is printed with the header below.
+ * Records are sorted by frame; the whole file is loaded in memory.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "entities/TrajectoryRecord.hpp"
+
+using namespace sim_mob;
+
+namespace
+{
+const char MAGIC[8] = { 'S', 'M', 'T', 'R', 'A', 'J', '\0', '\0' };
+
+bool compareFrames(const TrajectoryRecord& lhs, const TrajectoryRecord& rhs)
+{
+    return lhs.frame < rhs.frame;
+}
+
+void readRecords(const char* fileName, std::vector<TrajectoryRecord>& records)
+{
+    std::ifstream in(fileName, std::ios::in | std::ios::binary);
+    if (!in.is_open())
+    {
+        throw std::runtime_error(std::string("cannot open ") + fileName);
+    }
+
+    char magic[sizeof(MAGIC)];
+    uint32_t header[2];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0
+            || !in.read(reinterpret_cast<char*>(header), sizeof(header)))
+    {
+        throw std::runtime_error(std::string(fileName) + " is not a trajectory file");
+    }
+    if (header[0] != TrajectoryRecord::FORMAT_VERSION || header[1] != sizeof(TrajectoryRecord))
+    {
+        throw std::runtime_error(std::string(fileName) + " was written with another trajectory format version");
+    }
+
+    in.seekg(0, std::ios::end);
+    std::streamoff size = in.tellg() - static_cast<std::streamoff>(sizeof(MAGIC) + sizeof(header));
+    in.seekg(sizeof(MAGIC) + sizeof(header), std::ios::beg);
+    if (size % sizeof(TrajectoryRecord) != 0)
+    {
+        std::cerr << "Warning: " << fileName << " is truncated; the incomplete record is ignored" << std::endl;
+    }
+
+    records.resize(size / sizeof(TrajectoryRecord));
+    if (!records.empty() && !in.read(reinterpret_cast<char*>(records.data()), records.size() * sizeof(TrajectoryRecord)))
+    {
+        throw std::runtime_error(std::string("cannot read ") + fileName);
+    }
+}
+
+void writeVisualiserLine(const TrajectoryRecord& record, std::ostream& out)
+{
+    const char* fake = (record.flags & TrajectoryRecord::FLAG_FAKE) ? "true" : "false";
+    bool withFake = (record.flags & TrajectoryRecord::FLAG_FAKE) != 0;
+
+    if (record.kind == TrajectoryRecord::KIND_BUS_DRIVER)
+    {
+        out << "(\"BusDriver\"" << "," << record.frame << "," << record.agentId
+                << ",{" << "\"xPos\":\"" << record.xPos
+                << "\",\"yPos\":\"" << record.yPos
+                << "\",\"angle\":\"" << record.angle
+                << "\",\"length\":\"" << record.length
+                << "\",\"width\":\"" << record.width
+                << "\",\"passengers\":\"" << record.passengers
+                << "\",\"buslineID\":\"" << record.busLineId;
+        if (withFake)
+        {
+            out << "\",\"fake\":\"" << fake;
+        }
+        out << "\",\"info\":\"" << "\"})" << "\n";
+    }
+    else
+    {
+        const char* info = (record.flags & TrajectoryRecord::FLAG_AMOD) ? "<AMOD>"
+                : ((record.flags & TrajectoryRecord::FLAG_TAXI) ? "<Taxi>" : "");
+        out << "(\"Driver\"" << "," << record.frame << "," << record.agentId
+                << ",{" << "\"xPos\":\"" << record.xPos
+                << "\",\"yPos\":\"" << record.yPos
+                << "\",\"angle\":\"" << record.angle
+                << "\",\"length\":\"" << static_cast<int> (record.length)
+                << "\",\"width\":\"" << static_cast<int> (record.width)
+                << "\",\"curr-waypoint\":\"" << record.wayPointId
+                << "\",\"info\":\"" << info;
+        if (withFake)
+        {
+            out << "\",\"fake\":\"" << fake;
+        }
+        out << "\"})" << "\n";
+    }
+}
+
+void writeCsvLine(const TrajectoryRecord& record, std::ostream& out)
+{
+    out << (record.kind == TrajectoryRecord::KIND_BUS_DRIVER ? "BusDriver" : "Driver") << "," << record.frame << ","
+            << record.agentId << "," << record.xPos << "," << record.yPos << "," << record.angle << "," << record.length << ","
+            << record.width << "," << record.wayPointId << "," << record.passengers << "," << record.busLineId << ","
+            << ((record.flags & TrajectoryRecord::FLAG_AMOD) != 0) << "," << ((record.flags & TrajectoryRecord::FLAG_TAXI) != 0)
+            << "," << ((record.flags & TrajectoryRecord::FLAG_FAKE) != 0) << "\n";
+}
+}
+
+int main(int argc, char* argv[])
+{
+    bool csv = (argc > 1 && std::string(argv[1]) == "--csv");
+    int firstFile = csv ? 2 : 1;
+    if (argc - firstFile < 1 || argc - firstFile > 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " [--csv] <input file> [<output file>]" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        std::vector<TrajectoryRecord> records;
+        readRecords(argv[firstFile], records);
+
+        //each worker's records are in frame order, but workers' buffers are interleaved in the file
+        std::stable_sort(records.begin(), records.end(), compareFrames);
+
+        std::ofstream file;
+        if (argc - firstFile == 2)
+        {
+            file.open(argv[firstFile + 1]);
+            if (!file.is_open())
+            {
+                throw std::runtime_error(std::string("cannot open output file ") + argv[firstFile + 1]);
+            }
+        }
+        std::ostream& out = file.is_open() ? file : std::cout;
+        out << std::setprecision(8);
+
+        if (csv)
+        {
+            out << "role,frame,agent_id,x,y,angle,length,width,waypoint,passengers,bus_line,amod,taxi,fake\n";
+        }
+        for (std::vector<TrajectoryRecord>::const_iterator it = records.begin(); it != records.end(); it++)
+        {
+            if (csv)
+            {
+                writeCsvLine(*it, out);
+            }
+            else
+            {
+                writeVisualiserLine(*it, out);
+            }
+        }
+        std::cerr << records.size() << " positions converted" << std::endl;
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}